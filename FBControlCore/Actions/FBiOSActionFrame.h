@@ -0,0 +1,93 @@
+/**
+ * Copyright (c) 2015-present, Facebook, Inc.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree. An additional grant
+ * of patent rights can be found in the PATENTS file in the same directory.
+ */
+
+#import <Foundation/Foundation.h>
+
+#import <FBControlCore/FBDataConsumer.h>
+
+NS_ASSUME_NONNULL_BEGIN
+
+/**
+ The Types of Frame in the binary framing of the Action Reader.
+ */
+typedef NS_ENUM(uint8_t, FBiOSActionFrameType) {
+  FBiOSActionFrameTypeAction = 1, // A JSON Action. An Upload Header action opens an upload on the frame's stream.
+  FBiOSActionFrameTypeData = 2, // Bulk data for the upload open on the frame's stream.
+  FBiOSActionFrameTypeResponse = 3, // A response from the reader, for the action on the frame's stream.
+  FBiOSActionFrameTypeOutput = 4, // Binary output from the action on the frame's stream.
+};
+
+/**
+ The length of a Frame Header.
+ A Frame Header is the type (1 byte), the stream identifier (4 bytes, big-endian) and the payload length (4 bytes, big-endian).
+ This is a macro rather than a constant, so that header buffers are fixed-size arrays.
+ */
+#define FBiOSActionFrameHeaderLength 9
+
+/**
+ The line that a client sends in the JSON mode to switch a connection to binary framing.
+ The reader acknowledges with the same line, after which all input and output is framed.
+ */
+extern NSString *const FBiOSActionFrameNegotiationLine;
+
+/**
+ Encoding and Decoding of Frames.
+ */
+@interface FBiOSActionFrame : NSObject
+
+/**
+ Encodes a Frame.
+ The payload is not copied, the header is prepended to it.
+
+ @param type the frame type.
+ @param streamIdentifier the stream the frame belongs to.
+ @param payload the payload of the frame.
+ @return the frame data.
+ */
++ (dispatch_data_t)frameWithType:(FBiOSActionFrameType)type streamIdentifier:(uint32_t)streamIdentifier payload:(dispatch_data_t)payload;
+
+/**
+ Wraps NSData in dispatch_data, without copying immutable data.
+ Mutable data is copied, so it may be mutated afterwards.
+
+ @param data the data to wrap.
+ @return dispatch data backed by the NSData.
+ */
++ (dispatch_data_t)dispatchDataWithData:(NSData *)data;
+
+/**
+ A Consumer that wraps all data it is given in Output frames on the given stream.
+
+ @param streamIdentifier the stream to write to.
+ @param consumer the consumer to write the frames to.
+ @return a new consumer.
+ */
++ (id<FBDataConsumer>)outputConsumerForStreamIdentifier:(uint32_t)streamIdentifier consumer:(id<FBDataConsumer>)consumer;
+
+@end
+
+/**
+ Decodes Frames from a byte stream.
+ The payload of each Frame is delivered as a sub-range of the consumed data, without copying.
+ */
+@interface FBiOSActionFrameDecoder : NSObject <FBDispatchDataConsumer>
+
+/**
+ The Designated Initializer.
+
+ @param maximumPayloadLength frames with a larger payload are treated as a protocol error.
+ @param handler the handler to call for each complete frame.
+ @param errorHandler called once if the stream is malformed. No further frames are decoded.
+ @return a new decoder.
+ */
++ (instancetype)decoderWithMaximumPayloadLength:(size_t)maximumPayloadLength handler:(void (^)(FBiOSActionFrameType type, uint32_t streamIdentifier, dispatch_data_t payload))handler errorHandler:(void (^)(NSError *error))errorHandler;
+
+@end
+
+NS_ASSUME_NONNULL_END
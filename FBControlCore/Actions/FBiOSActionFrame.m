@@ -0,0 +1,192 @@
+/**
+ * Copyright (c) 2015-present, Facebook, Inc.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree. An additional grant
+ * of patent rights can be found in the PATENTS file in the same directory.
+ */
+
+#import "FBiOSActionFrame.h"
+
+#import <libkern/OSByteOrder.h>
+
+#import "FBControlCoreError.h"
+
+NSString *const FBiOSActionFrameNegotiationLine = @"{\"framing\":\"binary\"}\n";
+
+static void CopyPrefix(dispatch_data_t data, uint8_t *out, size_t length)
+{
+  __block size_t copied = 0;
+  dispatch_data_apply(data, ^ bool (dispatch_data_t region, size_t offset, const void *buffer, size_t size) {
+    size_t toCopy = MIN(size, length - copied);
+    memcpy(out + copied, buffer, toCopy);
+    copied += toCopy;
+    return copied < length;
+  });
+}
+
+@interface FBiOSActionFrame_OutputConsumer : NSObject <FBDataConsumer>
+
+@property (nonatomic, assign, readonly) uint32_t streamIdentifier;
+@property (nonatomic, strong, readonly) id<FBDataConsumer> consumer;
+
+@end
+
+@implementation FBiOSActionFrame_OutputConsumer
+
+- (instancetype)initWithStreamIdentifier:(uint32_t)streamIdentifier consumer:(id<FBDataConsumer>)consumer
+{
+  self = [super init];
+  if (!self) {
+    return nil;
+  }
+
+  _streamIdentifier = streamIdentifier;
+  _consumer = consumer;
+
+  return self;
+}
+
+#pragma mark FBDataConsumer
+
+- (void)consumeData:(NSData *)data
+{
+  dispatch_data_t frame = [FBiOSActionFrame frameWithType:FBiOSActionFrameTypeOutput streamIdentifier:self.streamIdentifier payload:[FBiOSActionFrame dispatchDataWithData:data]];
+  // Frames from concurrent streams must not interleave, so writes are serialized on the shared consumer.
+  @synchronized (self.consumer) {
+    [self.consumer consumeData:[FBDataConsumerAdaptor adaptDispatchData:frame]];
+  }
+}
+
+- (void)consumeEndOfFile
+{
+  // The underlying connection outlives a single action, so is not closed.
+}
+
+@end
+
+@implementation FBiOSActionFrame
+
+#pragma mark Public
+
++ (dispatch_data_t)frameWithType:(FBiOSActionFrameType)type streamIdentifier:(uint32_t)streamIdentifier payload:(dispatch_data_t)payload
+{
+  size_t length = dispatch_data_get_size(payload);
+  NSAssert(length <= UINT32_MAX, @"Payload of %zu bytes is too large for a frame", length);
+  uint8_t header[FBiOSActionFrameHeaderLength];
+  header[0] = type;
+  OSWriteBigInt32(header, 1, streamIdentifier);
+  OSWriteBigInt32(header, 5, (uint32_t) length);
+  dispatch_data_t headerData = dispatch_data_create(header, sizeof(header), NULL, DISPATCH_DATA_DESTRUCTOR_DEFAULT);
+  return dispatch_data_create_concat(headerData, payload);
+}
+
++ (dispatch_data_t)dispatchDataWithData:(NSData *)data
+{
+  // The destructor retains the NSData for the lifetime of the dispatch_data, so the bytes are shared rather than copied.
+  // Copying is free for immutable data, but means that mutable data cannot be changed underneath the dispatch_data.
+  NSData *immutable = [data copy];
+  return dispatch_data_create(immutable.bytes, immutable.length, NULL, ^{
+    (void) immutable;
+  });
+}
+
++ (id<FBDataConsumer>)outputConsumerForStreamIdentifier:(uint32_t)streamIdentifier consumer:(id<FBDataConsumer>)consumer
+{
+  return [[FBiOSActionFrame_OutputConsumer alloc] initWithStreamIdentifier:streamIdentifier consumer:consumer];
+}
+
+@end
+
+@interface FBiOSActionFrameDecoder ()
+
+@property (nonatomic, assign, readonly) size_t maximumPayloadLength;
+@property (nonatomic, copy, nullable, readwrite) void (^handler)(FBiOSActionFrameType, uint32_t, dispatch_data_t);
+@property (nonatomic, copy, nullable, readwrite) void (^errorHandler)(NSError *);
+@property (nonatomic, strong, readwrite) dispatch_data_t buffer;
+
+@end
+
+@implementation FBiOSActionFrameDecoder
+
+#pragma mark Initializers
+
++ (instancetype)decoderWithMaximumPayloadLength:(size_t)maximumPayloadLength handler:(void (^)(FBiOSActionFrameType, uint32_t, dispatch_data_t))handler errorHandler:(void (^)(NSError *))errorHandler
+{
+  return [[self alloc] initWithMaximumPayloadLength:maximumPayloadLength handler:handler errorHandler:errorHandler];
+}
+
+- (instancetype)initWithMaximumPayloadLength:(size_t)maximumPayloadLength handler:(void (^)(FBiOSActionFrameType, uint32_t, dispatch_data_t))handler errorHandler:(void (^)(NSError *))errorHandler
+{
+  self = [super init];
+  if (!self) {
+    return nil;
+  }
+
+  _maximumPayloadLength = maximumPayloadLength;
+  _handler = handler;
+  _errorHandler = errorHandler;
+  _buffer = dispatch_data_empty;
+
+  return self;
+}
+
+#pragma mark FBDispatchDataConsumer
+
+- (void)consumeData:(dispatch_data_t)data
+{
+  if (!self.handler) {
+    return;
+  }
+  self.buffer = dispatch_data_create_concat(self.buffer, data);
+  while (self.handler) {
+    size_t available = dispatch_data_get_size(self.buffer);
+    if (available < FBiOSActionFrameHeaderLength) {
+      return;
+    }
+    uint8_t header[FBiOSActionFrameHeaderLength];
+    CopyPrefix(self.buffer, header, sizeof(header));
+    FBiOSActionFrameType type = header[0];
+    uint32_t streamIdentifier = OSReadBigInt32(header, 1);
+    size_t length = OSReadBigInt32(header, 5);
+    if (length > self.maximumPayloadLength) {
+      [self failWithError:[[FBControlCoreError
+        describeFormat:@"Frame payload of %zu bytes exceeds the maximum of %zu bytes", length, self.maximumPayloadLength]
+        build]];
+      return;
+    }
+    if (available < FBiOSActionFrameHeaderLength + length) {
+      return;
+    }
+    dispatch_data_t payload = dispatch_data_create_subrange(self.buffer, FBiOSActionFrameHeaderLength, length);
+    size_t consumed = FBiOSActionFrameHeaderLength + length;
+    self.buffer = dispatch_data_create_subrange(self.buffer, consumed, available - consumed);
+    self.handler(type, streamIdentifier, payload);
+  }
+}
+
+- (void)consumeEndOfFile
+{
+  if (self.handler && dispatch_data_get_size(self.buffer) > 0) {
+    [self failWithError:[[FBControlCoreError
+      describeFormat:@"Stream ended with a partial frame of %zu bytes", dispatch_data_get_size(self.buffer)]
+      build]];
+  }
+  self.handler = nil;
+}
+
+#pragma mark Private
+
+- (void)failWithError:(NSError *)error
+{
+  void (^errorHandler)(NSError *) = self.errorHandler;
+  self.handler = nil;
+  self.errorHandler = nil;
+  self.buffer = dispatch_data_empty;
+  if (errorHandler) {
+    errorHandler(error);
+  }
+}
+
+@end
@@ -58,6 +58,20 @@ extern FBiOSTargetFutureType const FBiOSTargetFutureTypeActionReader;
  */
 + (instancetype)socketReaderForRouter:(FBiOSActionRouter *)router delegate:(id<FBiOSActionReaderDelegate>)delegate port:(in_port_t)port;
 
+/**
+ Initializes a pipelined Action Reader for a router, on a socket.
+ Actions are performed off the read path, with up to the given number of non-conflicting actions running at once on the target.
+ If a line contains a "request_id", JSON responses to the action will contain the same "request_id", as responses may arrive out-of-order.
+ The output of an action is written in whole lines, with JSON lines also containing the "request_id", as the output of concurrent actions is interleaved.
+
+ @param router the router to use.
+ @param delegate the delegate to notify.
+ @param port the port to bind on.
+ @param maximumConcurrentActions the maximum number of actions that may run at once, across all connections.
+ @return a Socket Reader.
+ */
++ (instancetype)socketReaderForRouter:(FBiOSActionRouter *)router delegate:(id<FBiOSActionReaderDelegate>)delegate port:(in_port_t)port maximumConcurrentActions:(NSUInteger)maximumConcurrentActions;
+
 /**
  Initializes an Action Reader for a router, between file handles.
  The default routing of the target will be used.
@@ -81,6 +95,21 @@ extern FBiOSTargetFutureType const FBiOSTargetFutureTypeActionReader;
  */
 + (instancetype)fileReaderForRouter:(FBiOSActionRouter *)router delegate:(id<FBiOSActionReaderDelegate>)delegate readHandle:(NSFileHandle *)readHandle writeHandle:(NSFileHandle *)writeHandle;
 
+/**
+ Initializes a pipelined Action Reader for a router, between file handles.
+ Actions are performed off the read path, with up to the given number of non-conflicting actions running at once on the target.
+ If a line contains a "request_id", JSON responses to the action will contain the same "request_id", as responses may arrive out-of-order.
+ The output of an action is written in whole lines, with JSON lines also containing the "request_id", as the output of concurrent actions is interleaved.
+
+ @param router the router to use.
+ @param delegate the delegate to notify.
+ @param readHandle the handle to read.
+ @param writeHandle the handle to write to.
+ @param maximumConcurrentActions the maximum number of actions that may run at once.
+ @return a Socket Reader.
+ */
++ (instancetype)fileReaderForRouter:(FBiOSActionRouter *)router delegate:(id<FBiOSActionReaderDelegate>)delegate readHandle:(NSFileHandle *)readHandle writeHandle:(NSFileHandle *)writeHandle maximumConcurrentActions:(NSUInteger)maximumConcurrentActions;
+
 #pragma mark Public Methods
 
 /**
@@ -10,8 +10,10 @@
 #import "FBiOSActionReader.h"
 
 #import "FBControlCoreError.h"
+#import "FBEventJSONWriter.h"
 #import "FBFileReader.h"
 #import "FBFileWriter.h"
+#import "FBiOSActionFrame.h"
 #import "FBiOSActionRouter.h"
 #import "FBiOSTarget.h"
 #import "FBiOSTargetFuture.h"
@@ -21,10 +23,256 @@
 
 FBiOSTargetFutureType const FBiOSTargetFutureTypeActionReader = @"action_reader";
 
+static NSString *const KeyRequestIdentifier = @"request_id";
+static NSString *const KeyFraming = @"framing";
+static NSString *const ValueFramingBinary = @"binary";
+static size_t const FBiOSActionMaximumFramePayloadLength = 16 * 1024 * 1024;
+
+static BOOL LineIsBlank(NSData *line)
+{
+  const uint8_t *bytes = line.bytes;
+  for (NSUInteger index = 0; index < line.length; index++) {
+    if (bytes[index] != ' ' && bytes[index] != '\t' && bytes[index] != '\r') {
+      return NO;
+    }
+  }
+  return YES;
+}
+
+static NSData *ResponseDataTaggedWithRequestIdentifier(NSData *data, id requestIdentifier)
+{
+  // A JSON response is an object, so the identifier is written as its first key, rather than the response being parsed and serialized again.
+  const char *bytes = data.bytes;
+  NSUInteger open = 0;
+  while (open < data.length && isspace(bytes[open])) {
+    open++;
+  }
+  if (open == data.length || bytes[open] != '{') {
+    return data;
+  }
+  NSMutableData *tagged = [NSMutableData dataWithCapacity:data.length + 64];
+  [tagged appendBytes:bytes length:open + 1];
+  FBEventJSONWriter *writer = [FBEventJSONWriter writerWithBuffer:tagged];
+  [writer appendString:KeyRequestIdentifier];
+  [tagged appendBytes:":" length:1];
+  if (![writer appendJSONObject:requestIdentifier]) {
+    return data;
+  }
+  NSUInteger next = open + 1;
+  while (next < data.length && isspace(bytes[next])) {
+    next++;
+  }
+  if (next < data.length && bytes[next] != '}') {
+    [tagged appendBytes:"," length:1];
+  }
+  [tagged appendBytes:bytes + open + 1 length:data.length - open - 1];
+  return tagged;
+}
+
+static BOOL ActionsConflict(id<FBiOSTargetFuture> left, id<FBiOSTargetFuture> right)
+{
+  if (![left respondsToSelector:@selector(conflictsWithAction:)] || ![right respondsToSelector:@selector(conflictsWithAction:)]) {
+    return YES;
+  }
+  return [left conflictsWithAction:right] || [right conflictsWithAction:left];
+}
+
+@interface FBiOSActionSchedulerEntry : NSObject
+
+@property (nonatomic, strong, readonly) id<FBiOSTargetFuture> action;
+@property (nonatomic, strong, readonly) dispatch_queue_t queue;
+@property (nonatomic, copy, readonly) FBFuture<NSNull *> *(^start)(void);
+
+@end
+
+@implementation FBiOSActionSchedulerEntry
+
+- (instancetype)initWithAction:(id<FBiOSTargetFuture>)action queue:(dispatch_queue_t)queue start:(FBFuture<NSNull *> *(^)(void))start
+{
+  self = [super init];
+  if (!self) {
+    return nil;
+  }
+
+  _action = action;
+  _queue = queue;
+  _start = start;
+
+  return self;
+}
+
+@end
+
+/**
+ Runs actions for a target, up to a concurrency limit.
+ Actions are started in the order they are scheduled, except that an action may overtake an earlier one that it does not conflict with.
+ */
+@interface FBiOSActionScheduler : NSObject
+
+@property (nonatomic, assign, readonly) NSUInteger maximumConcurrentActions;
+@property (nonatomic, strong, readonly) dispatch_queue_t queue;
+@property (nonatomic, strong, readonly) NSMutableArray<FBiOSActionSchedulerEntry *> *pending;
+@property (nonatomic, strong, readonly) NSMutableArray<id<FBiOSTargetFuture>> *running;
+
+@end
+
+@implementation FBiOSActionScheduler
+
+- (instancetype)initWithMaximumConcurrentActions:(NSUInteger)maximumConcurrentActions
+{
+  self = [super init];
+  if (!self) {
+    return nil;
+  }
+
+  _maximumConcurrentActions = MAX(maximumConcurrentActions, 1u);
+  _queue = dispatch_queue_create("com.facebook.fbcontrolcore.action_scheduler", DISPATCH_QUEUE_SERIAL);
+  _pending = [NSMutableArray array];
+  _running = [NSMutableArray array];
+
+  return self;
+}
+
+- (void)scheduleAction:(id<FBiOSTargetFuture>)action onQueue:(dispatch_queue_t)queue start:(FBFuture<NSNull *> *(^)(void))start
+{
+  FBiOSActionSchedulerEntry *entry = [[FBiOSActionSchedulerEntry alloc] initWithAction:action queue:queue start:start];
+  dispatch_async(self.queue, ^{
+    [self.pending addObject:entry];
+    [self startRunnableActions];
+  });
+}
+
+- (void)startRunnableActions
+{
+  // An action that is blocked by a conflict also blocks later actions that conflict with it, so that conflicting actions run in order.
+  NSMutableArray<id<FBiOSTargetFuture>> *blocking = [self.running mutableCopy];
+  for (FBiOSActionSchedulerEntry *entry in [self.pending copy]) {
+    if (self.running.count >= self.maximumConcurrentActions) {
+      return;
+    }
+    if ([self action:entry.action conflictsWithAnyOf:blocking]) {
+      [blocking addObject:entry.action];
+      continue;
+    }
+    [self.pending removeObjectIdenticalTo:entry];
+    [self.running addObject:entry.action];
+    [blocking addObject:entry.action];
+    dispatch_async(entry.queue, ^{
+      [entry.start() onQueue:self.queue notifyOfCompletion:^(FBFuture *_) {
+        [self.running removeObjectIdenticalTo:entry.action];
+        [self startRunnableActions];
+      }];
+    });
+  }
+}
+
+- (BOOL)action:(id<FBiOSTargetFuture>)action conflictsWithAnyOf:(NSArray<id<FBiOSTargetFuture>> *)actions
+{
+  for (id<FBiOSTargetFuture> other in actions) {
+    if (ActionsConflict(action, other)) {
+      return YES;
+    }
+  }
+  return NO;
+}
+
+@end
+
 #pragma clang diagnostic push
 #pragma clang diagnostic ignored "-Wprotocol"
 #pragma clang diagnostic ignored "-Wincomplete-implementation"
 
+@interface FBiOSActionFramedUpload : NSObject
+
+@property (nonatomic, copy, readonly) FBUploadHeader *header;
+@property (nonatomic, copy, readonly) NSString *filePath;
+@property (nonatomic, strong, readonly) id<FBDispatchDataConsumer> writer;
+@property (nonatomic, strong, readonly, nullable) id<FBDataConsumer> extraction;
+@property (nonatomic, assign, readwrite) size_t position;
+
+@end
+
+@implementation FBiOSActionFramedUpload
+
+- (instancetype)initWithHeader:(FBUploadHeader *)header filePath:(NSString *)filePath writer:(id<FBDispatchDataConsumer>)writer extraction:(nullable id<FBDataConsumer>)extraction
+{
+  self = [super init];
+  if (!self) {
+    return nil;
+  }
+
+  _header = header;
+  _filePath = filePath;
+  _writer = writer;
+  _extraction = extraction;
+  _position = 0;
+
+  return self;
+}
+
+@end
+
+@interface FBiOSActionPipelinedOutputConsumer : NSObject <FBDataConsumer>
+
+@property (nonatomic, strong, readonly) id<FBDataConsumer> consumer;
+@property (nonatomic, strong, readonly, nullable) id requestIdentifier;
+@property (nonatomic, strong, readonly) id<FBConsumableBuffer> lineBuffer;
+
+@end
+
+@implementation FBiOSActionPipelinedOutputConsumer
+
+- (instancetype)initWithConsumer:(id<FBDataConsumer>)consumer requestIdentifier:(nullable id)requestIdentifier
+{
+  self = [super init];
+  if (!self) {
+    return nil;
+  }
+
+  _consumer = consumer;
+  _requestIdentifier = requestIdentifier;
+  _lineBuffer = FBLineBuffer.cursorConsumableBuffer;
+
+  return self;
+}
+
+#pragma mark FBDataConsumer
+
+- (void)consumeData:(NSData *)data
+{
+  @synchronized (self.lineBuffer) {
+    [self.lineBuffer consumeData:data];
+    for (NSData *line = self.lineBuffer.consumeLineData; line; line = self.lineBuffer.consumeLineData) {
+      [self writeLine:line];
+    }
+  }
+}
+
+- (void)consumeEndOfFile
+{
+  // The underlying connection outlives a single action, so is not closed.
+  @synchronized (self.lineBuffer) {
+    NSData *remainder = self.lineBuffer.consumeCurrentData;
+    if (remainder.length > 0) {
+      [self writeLine:remainder];
+    }
+  }
+}
+
+#pragma mark Private
+
+- (void)writeLine:(NSData *)line
+{
+  NSMutableData *data = [(self.requestIdentifier ? ResponseDataTaggedWithRequestIdentifier(line, self.requestIdentifier) : line) mutableCopy];
+  [data appendBytes:"\n" length:1];
+  // Output of concurrent actions must not interleave within a line, so writes are serialized on the shared consumer.
+  @synchronized (self.consumer) {
+    [self.consumer consumeData:data];
+  }
+}
+
+@end
+
 @interface FBiOSActionReaderMediator : NSObject <FBSocketConsumer, FBiOSActionReaderDelegate>
 
 @property (nonatomic, strong, readonly) FBiOSActionReader *reader;
@@ -33,12 +281,15 @@ FBiOSTargetFutureType const FBiOSTargetFutureTypeActionReader = @"action_reader"
 @property (nonatomic, strong, readonly) id<FBDataConsumer> writeBack;
 @property (nonatomic, strong, readonly) id<FBConsumableBuffer> lineBuffer;
 @property (nonatomic, strong, readwrite, nullable) FBUploadBuffer *uploadBuffer;
+@property (nonatomic, strong, readonly, nullable) FBiOSActionScheduler *scheduler;
+@property (nonatomic, strong, readwrite, nullable) FBiOSActionFrameDecoder *frameDecoder;
+@property (nonatomic, strong, readonly) NSMutableDictionary<NSNumber *, FBiOSActionFramedUpload *> *framedUploads;
 
 @end
 
 @implementation FBiOSActionReaderMediator
 
-- (instancetype)initWithReader:(FBiOSActionReader *)reader router:(FBiOSActionRouter *)router delegate:(id<FBiOSActionReaderDelegate>)delegate writeBack:(id<FBDataConsumer>)writeBack
+- (instancetype)initWithReader:(FBiOSActionReader *)reader router:(FBiOSActionRouter *)router delegate:(id<FBiOSActionReaderDelegate>)delegate writeBack:(id<FBDataConsumer>)writeBack scheduler:(nullable FBiOSActionScheduler *)scheduler
 {
   self = [super init];
   if (!self) {
@@ -49,8 +300,10 @@ FBiOSTargetFutureType const FBiOSTargetFutureTypeActionReader = @"action_reader"
   _router = router;
   _delegate = delegate;
   _writeBack = writeBack;
-  _lineBuffer = [FBLineBuffer consumableBuffer];
+  _lineBuffer = FBLineBuffer.cursorConsumableBuffer;
   _uploadBuffer = nil;
+  _scheduler = scheduler;
+  _framedUploads = [NSMutableDictionary dictionary];
 
   return self;
 }
@@ -66,6 +319,10 @@ FBiOSTargetFutureType const FBiOSTargetFutureTypeActionReader = @"action_reader"
 
 - (void)consumeData:(NSData *)data
 {
+  if (self.frameDecoder) {
+    [self.frameDecoder consumeData:[FBiOSActionFrame dispatchDataWithData:data]];
+    return;
+  }
   if (self.uploadBuffer) {
     NSData *remainder = nil;
     FBUploadedDestination *destination = [self.uploadBuffer writeData:data remainderOut:&remainder];
@@ -83,6 +340,18 @@ FBiOSTargetFutureType const FBiOSTargetFutureTypeActionReader = @"action_reader"
 
 - (void)consumeEndOfFile
 {
+  [self.frameDecoder consumeEndOfFile];
+  // The last line of the input does not need to be terminated by a newline.
+  if (!self.frameDecoder && !self.uploadBuffer) {
+    NSData *remainder = [self.lineBuffer consumeCurrentData];
+    if (remainder.length > 0) {
+      [self dispatchLine:remainder];
+    }
+  }
+  // Uploads that are incomplete will never be completed, so their files are removed.
+  for (NSNumber *streamIdentifier in self.framedUploads.allKeys) {
+    [self abandonFramedUploadOnStream:streamIdentifier];
+  }
   _writeBack = FBFileWriter.nullWriter;
 }
 
@@ -98,55 +367,104 @@ FBiOSTargetFutureType const FBiOSTargetFutureTypeActionReader = @"action_reader"
   NSData *lineData = self.lineBuffer.consumeLineData;
   while (lineData) {
     [self dispatchLine:lineData];
+    // The remainder of the buffer will have been passed to the frame decoder, if framing has been negotiated.
+    if (self.frameDecoder) {
+      return;
+    }
     lineData = self.lineBuffer.consumeLineData;
   }
 }
 
 - (void)dispatchLine:(NSData *)line
+{
+  // Blank lines separate actions, including the carriage return of CRLF line endings, so are not bad input.
+  if (LineIsBlank(line)) {
+    return;
+  }
+  [self dispatchJSONData:line streamIdentifier:nil];
+}
+
+- (void)dispatchJSONData:(NSData *)data streamIdentifier:(nullable NSNumber *)streamIdentifier
 {
   NSError *error = nil;
-  id json = [NSJSONSerialization JSONObjectWithData:line options:0 error:&error];
+  id json = [NSJSONSerialization JSONObjectWithData:data options:0 error:&error];
   if (!json) {
-    [self dispatchParseError:line error:error];
+    [self dispatchParseError:data error:error streamIdentifier:streamIdentifier];
+    return;
+  }
+  if (!streamIdentifier && [json isKindOfClass:NSDictionary.class] && [json[KeyFraming] isEqual:ValueFramingBinary]) {
+    [self dispatchFramingNegotiated];
     return;
   }
 
   id<FBiOSTargetFuture> action = [self.router actionFromJSON:json error:&error];
   if (!action) {
-    [self dispatchParseError:line error:error];
+    [self dispatchParseError:data error:error streamIdentifier:streamIdentifier];
+    return;
+  }
+  if ([action isKindOfClass:FBUploadHeader.class] && streamIdentifier) {
+    [self dispatchFramedUploadStarted:(FBUploadHeader *)action streamIdentifier:streamIdentifier];
     return;
   }
   if ([action isKindOfClass:FBUploadHeader.class]) {
     [self dispatchUploadStarted:(FBUploadHeader *)action];
     return;
   }
-  [self dispatchAction:action];
+  id requestIdentifier = [json isKindOfClass:NSDictionary.class] ? json[KeyRequestIdentifier] : nil;
+  if (self.scheduler) {
+    [self scheduleAction:action requestIdentifier:requestIdentifier streamIdentifier:streamIdentifier];
+    return;
+  }
+  [self dispatchAction:action requestIdentifier:requestIdentifier streamIdentifier:streamIdentifier];
+}
+
+- (void)scheduleAction:(id<FBiOSTargetFuture>)action requestIdentifier:(nullable id)requestIdentifier streamIdentifier:(nullable NSNumber *)streamIdentifier
+{
+  FBiOSActionReader *reader = self.reader;
+  id<FBiOSTarget> target = self.router.target;
+  dispatch_queue_t queue = self.actionQueue;
+
+  [self.scheduler scheduleAction:action onQueue:queue start:^ FBFuture<NSNull *> * {
+    NSString *response = [self.delegate reader:reader willStartPerformingAction:action onTarget:target];
+    [self reportString:response requestIdentifier:requestIdentifier streamIdentifier:streamIdentifier];
+
+    return [[action
+      runWithTarget:target consumer:[self outputConsumerForStreamIdentifier:streamIdentifier requestIdentifier:requestIdentifier] reporter:self.reporter]
+      onQueue:queue chain:^(FBFuture *future) {
+        NSString *completion = future.result
+          ? [self.delegate reader:reader didProcessAction:action onTarget:target]
+          : [self.delegate reader:reader didFailToProcessAction:action onTarget:target error:(future.error ?: [[FBControlCoreError describeFormat:@"%@ was cancelled", action] build])];
+        [self reportString:completion requestIdentifier:requestIdentifier streamIdentifier:streamIdentifier];
+        return [FBFuture futureWithResult:NSNull.null];
+      }];
+  }];
 }
 
-- (void)dispatchAction:(id<FBiOSTargetFuture>)action
+- (void)dispatchAction:(id<FBiOSTargetFuture>)action requestIdentifier:(nullable id)requestIdentifier streamIdentifier:(nullable NSNumber *)streamIdentifier
 {
   FBiOSActionReader *reader = self.reader;
   id<FBiOSTarget> target = self.router.target;
+  id<FBDataConsumer> consumer = [self outputConsumerForStreamIdentifier:streamIdentifier requestIdentifier:requestIdentifier];
 
   // Notify Delegate of the start of the Action.
   __block NSString *response = nil;
   dispatch_sync(self.actionQueue, ^{
     response = [self.delegate reader:reader willStartPerformingAction:action onTarget:target];
   });
-  [self reportString:response];
+  [self reportString:response requestIdentifier:requestIdentifier streamIdentifier:streamIdentifier];
 
   // Run the action, on the main queue
   __block NSError *error = nil;
   __block BOOL success = NO;
   dispatch_sync(self.actionQueue, ^{
-    success = [[action runWithTarget:target consumer:self.writeBack reporter:self.reporter] await:&error] != nil;
+    success = [[action runWithTarget:target consumer:consumer reporter:self.reporter] await:&error] != nil;
   });
 
   // Notify the delegate that the reader has finished, report the resultant string.
   response = success
     ? [self.delegate reader:reader didProcessAction:action onTarget:target]
     : [self.delegate reader:reader didFailToProcessAction:action onTarget:target error:error];
-  [self reportString:response];
+  [self reportString:response requestIdentifier:requestIdentifier streamIdentifier:streamIdentifier];
 }
 
 - (void)dispatchUploadStarted:(FBUploadHeader *)header
@@ -170,14 +488,19 @@ FBiOSTargetFutureType const FBiOSTargetFutureTypeActionReader = @"action_reader"
   NSParameterAssert(self.uploadBuffer != nil);
 
   self.uploadBuffer = nil;
+  [self dispatchUploadCompleted:destination streamIdentifier:nil];
+}
+
+- (void)dispatchUploadCompleted:(FBUploadedDestination *)destination streamIdentifier:(nullable NSNumber *)streamIdentifier
+{
   __block NSString *response = nil;
   dispatch_sync(self.actionQueue, ^{
     response = [self.delegate reader:self.reader didFinishUpload:destination];
   });
-  [self reportString:response];
+  [self reportString:response requestIdentifier:nil streamIdentifier:streamIdentifier];
 }
 
-- (void)dispatchParseError:(NSData *)lineData error:(NSError *)error
+- (void)dispatchParseError:(NSData *)lineData error:(NSError *)error streamIdentifier:(nullable NSNumber *)streamIdentifier
 {
   NSString *line = [[NSString alloc] initWithData:lineData encoding:NSUTF8StringEncoding];
   __block NSString *response = nil;
@@ -187,16 +510,159 @@ FBiOSTargetFutureType const FBiOSTargetFutureTypeActionReader = @"action_reader"
   if (!response) {
     return;
   }
-  [self reportString:response];
+  [self reportString:response requestIdentifier:nil streamIdentifier:streamIdentifier];
+}
+
+#pragma mark Binary Framing
+
+- (void)dispatchFramingNegotiated
+{
+  // The acknowledgement is the last unframed output.
+  [self reportString:FBiOSActionFrameNegotiationLine];
+
+  __weak typeof(self) weakSelf = self;
+  self.frameDecoder = [FBiOSActionFrameDecoder
+    decoderWithMaximumPayloadLength:FBiOSActionMaximumFramePayloadLength
+    handler:^(FBiOSActionFrameType type, uint32_t streamIdentifier, dispatch_data_t payload) {
+      [weakSelf dispatchFrameOfType:type streamIdentifier:@(streamIdentifier) payload:payload];
+    }
+    errorHandler:^(NSError *error) {
+      [weakSelf dispatchParseError:NSData.data error:error streamIdentifier:@0];
+    }];
+
+  // Anything after the negotiation line is framed.
+  NSData *remainder = [self.lineBuffer consumeCurrentData];
+  if (remainder.length > 0) {
+    [self.frameDecoder consumeData:[FBiOSActionFrame dispatchDataWithData:remainder]];
+  }
+}
+
+- (void)dispatchFrameOfType:(FBiOSActionFrameType)type streamIdentifier:(NSNumber *)streamIdentifier payload:(dispatch_data_t)payload
+{
+  switch (type) {
+    case FBiOSActionFrameTypeAction:
+      [self dispatchJSONData:[FBDataConsumerAdaptor adaptDispatchData:payload] streamIdentifier:streamIdentifier];
+      return;
+    case FBiOSActionFrameTypeData:
+      [self dispatchFramedUploadData:payload streamIdentifier:streamIdentifier];
+      return;
+    default:
+      [self dispatchParseError:NSData.data error:[[FBControlCoreError describeFormat:@"Frame type %d is not accepted from a client", type] build] streamIdentifier:streamIdentifier];
+      return;
+  }
 }
 
+- (void)dispatchFramedUploadStarted:(FBUploadHeader *)header streamIdentifier:(NSNumber *)streamIdentifier
+{
+  if (self.framedUploads[streamIdentifier]) {
+    [self dispatchParseError:NSData.data error:[[FBControlCoreError describeFormat:@"An upload is already in progress on stream %@", streamIdentifier] build] streamIdentifier:streamIdentifier];
+    return;
+  }
+  NSString *filePath = [[self.router.target.auxillaryDirectory stringByAppendingPathComponent:NSUUID.UUID.UUIDString] stringByAppendingPathExtension:header.extension];
+  NSError *error = nil;
+  id<FBDataConsumer> writer = [FBFileWriter syncWriterForFilePath:filePath error:&error];
+  if (!writer) {
+    [self dispatchParseError:NSData.data error:error streamIdentifier:streamIdentifier];
+    return;
+  }
+  // The writer is unwrapped to the dispatch_data writer, so that payloads are written to disk without being flattened or copied.
+  FBiOSActionFramedUpload *upload = [[FBiOSActionFramedUpload alloc]
+    initWithHeader:header
+    filePath:filePath
+    writer:[FBDataConsumerAdaptor dispatchDataConsumerForDataConsumer:writer]
+    extraction:[FBUploadBuffer extractionConsumerForHeader:header filePath:filePath]];
+  self.framedUploads[streamIdentifier] = upload;
+
+  __block NSString *response = nil;
+  dispatch_sync(self.actionQueue, ^{
+    response = [self.delegate reader:self.reader willStartReadingUpload:header];
+  });
+  [self reportString:response requestIdentifier:nil streamIdentifier:streamIdentifier];
+
+  if (header.size == 0) {
+    [self dispatchFramedUploadData:dispatch_data_empty streamIdentifier:streamIdentifier];
+  }
+}
+
+- (void)dispatchFramedUploadData:(dispatch_data_t)payload streamIdentifier:(NSNumber *)streamIdentifier
+{
+  FBiOSActionFramedUpload *upload = self.framedUploads[streamIdentifier];
+  if (!upload) {
+    [self dispatchParseError:NSData.data error:[[FBControlCoreError describeFormat:@"There is no upload in progress on stream %@", streamIdentifier] build] streamIdentifier:streamIdentifier];
+    return;
+  }
+  size_t size = dispatch_data_get_size(payload);
+  if (upload.position + size > upload.header.size) {
+    [self abandonFramedUploadOnStream:streamIdentifier];
+    [self dispatchParseError:NSData.data error:[[FBControlCoreError describeFormat:@"Upload on stream %@ exceeds the size of %zu bytes in the header", streamIdentifier, upload.header.size] build] streamIdentifier:streamIdentifier];
+    return;
+  }
+  [upload.writer consumeData:payload];
+  // Each region of the payload is contiguous, so it is adapted without a copy; flattening the whole payload would copy it.
+  id<FBDataConsumer> extraction = upload.extraction;
+  if (extraction) {
+    dispatch_data_apply(payload, ^ bool (dispatch_data_t region, size_t offset, const void *buffer, size_t regionSize) {
+      [extraction consumeData:[FBDataConsumerAdaptor adaptDispatchData:region]];
+      return true;
+    });
+  }
+  upload.position += size;
+  if (upload.position < upload.header.size) {
+    return;
+  }
+  [upload.writer consumeEndOfFile];
+  [upload.extraction consumeEndOfFile];
+  [self.framedUploads removeObjectForKey:streamIdentifier];
+  [self dispatchUploadCompleted:[FBUploadedDestination destinationWithHeader:upload.header path:upload.filePath] streamIdentifier:streamIdentifier];
+}
+
+- (void)abandonFramedUploadOnStream:(NSNumber *)streamIdentifier
+{
+  FBiOSActionFramedUpload *upload = self.framedUploads[streamIdentifier];
+  [self.framedUploads removeObjectForKey:streamIdentifier];
+  // The extraction is released without being ended, which removes anything it has extracted.
+  [upload.writer consumeEndOfFile];
+  [NSFileManager.defaultManager removeItemAtPath:upload.filePath error:nil];
+}
+
+- (id<FBDataConsumer>)outputConsumerForStreamIdentifier:(nullable NSNumber *)streamIdentifier requestIdentifier:(nullable id)requestIdentifier
+{
+  if (self.frameDecoder) {
+    return [FBiOSActionFrame outputConsumerForStreamIdentifier:streamIdentifier.unsignedIntValue consumer:self.writeBack];
+  }
+  // Pipelined actions write their output concurrently, so it is written in whole lines that identify the request.
+  if (self.scheduler) {
+    return [[FBiOSActionPipelinedOutputConsumer alloc] initWithConsumer:self.writeBack requestIdentifier:requestIdentifier];
+  }
+  return self.writeBack;
+}
+
+#pragma mark Reporting
+
 - (void)reportString:(nullable NSString *)string
+{
+  [self reportString:string requestIdentifier:nil streamIdentifier:nil];
+}
+
+- (void)reportString:(nullable NSString *)string requestIdentifier:(nullable id)requestIdentifier streamIdentifier:(nullable NSNumber *)streamIdentifier
 {
   if (!string) {
     return;
   }
   NSData *data = [string dataUsingEncoding:NSUTF8StringEncoding];
-  [self.writeBack consumeData:data];
+  if (requestIdentifier) {
+    data = ResponseDataTaggedWithRequestIdentifier(data, requestIdentifier);
+  }
+  if (self.frameDecoder) {
+    dispatch_data_t frame = [FBiOSActionFrame frameWithType:FBiOSActionFrameTypeResponse streamIdentifier:streamIdentifier.unsignedIntValue payload:[FBiOSActionFrame dispatchDataWithData:data]];
+    data = [FBDataConsumerAdaptor adaptDispatchData:frame];
+  }
+  // Pipelined actions report from the target's queue, rather than the read path.
+  // The lock is shared with the framed output consumers, which write to the same connection.
+  id<FBDataConsumer> writeBack = self.writeBack;
+  @synchronized (writeBack) {
+    [writeBack consumeData:data];
+  }
 }
 
 - (id<FBEventReporter>)reporter
@@ -232,7 +698,7 @@ FBiOSTargetFutureType const FBiOSTargetFutureTypeActionReader = @"action_reader"
 
 @property (nonatomic, strong, nullable, readwrite) FBSocketConnectionManager *reader;
 
-- (instancetype)initWithDelegate:(id<FBiOSActionReaderDelegate>)delegate router:(FBiOSActionRouter *)router port:(in_port_t)port;
+- (instancetype)initWithDelegate:(id<FBiOSActionReaderDelegate>)delegate router:(FBiOSActionRouter *)router port:(in_port_t)port maximumConcurrentActions:(NSUInteger)maximumConcurrentActions;
 
 @end
 
@@ -242,7 +708,7 @@ FBiOSTargetFutureType const FBiOSTargetFutureTypeActionReader = @"action_reader"
 @property (nonatomic, strong, nullable, readwrite) FBFileReader *reader;
 @property (nonatomic, strong, nullable, readwrite) id<FBDataConsumer> writer;
 
-- (instancetype)initWithDelegate:(id<FBiOSActionReaderDelegate>)delegate router:(FBiOSActionRouter *)router readHandle:(NSFileHandle *)readHandle writeHandle:(NSFileHandle *)writeHandle;
+- (instancetype)initWithDelegate:(id<FBiOSActionReaderDelegate>)delegate router:(FBiOSActionRouter *)router readHandle:(NSFileHandle *)readHandle writeHandle:(NSFileHandle *)writeHandle maximumConcurrentActions:(NSUInteger)maximumConcurrentActions;
 
 @end
 
@@ -251,8 +717,9 @@ FBiOSTargetFutureType const FBiOSTargetFutureTypeActionReader = @"action_reader"
 @property (nonatomic, strong, nullable, readwrite) id<FBiOSActionReaderDelegate> delegate;
 @property (nonatomic, strong, readonly) FBiOSActionRouter *router;
 @property (nonatomic, strong, readonly) FBMutableFuture<NSNull *> *completedFuture;
+@property (nonatomic, strong, nullable, readonly) FBiOSActionScheduler *scheduler;
 
-- (instancetype)initWithDelegate:(id<FBiOSActionReaderDelegate>)delegate router:(FBiOSActionRouter *)router;
+- (instancetype)initWithDelegate:(id<FBiOSActionReaderDelegate>)delegate router:(FBiOSActionRouter *)router maximumConcurrentActions:(NSUInteger)maximumConcurrentActions;
 
 @end
 
@@ -268,7 +735,12 @@ FBiOSTargetFutureType const FBiOSTargetFutureTypeActionReader = @"action_reader"
 
 + (instancetype)socketReaderForRouter:(FBiOSActionRouter *)router delegate:(id<FBiOSActionReaderDelegate>)delegate port:(in_port_t)port
 {
-  return [[FBiOSActionSocket alloc] initWithDelegate:delegate router:router port:port];
+  return [[FBiOSActionSocket alloc] initWithDelegate:delegate router:router port:port maximumConcurrentActions:0];
+}
+
++ (instancetype)socketReaderForRouter:(FBiOSActionRouter *)router delegate:(id<FBiOSActionReaderDelegate>)delegate port:(in_port_t)port maximumConcurrentActions:(NSUInteger)maximumConcurrentActions
+{
+  return [[FBiOSActionSocket alloc] initWithDelegate:delegate router:router port:port maximumConcurrentActions:maximumConcurrentActions];
 }
 
 + (instancetype)fileReaderForTarget:(id<FBiOSTarget>)target delegate:(id<FBiOSActionReaderDelegate>)delegate readHandle:(NSFileHandle *)readHandle writeHandle:(NSFileHandle *)writeHandle
@@ -279,10 +751,15 @@ FBiOSTargetFutureType const FBiOSTargetFutureTypeActionReader = @"action_reader"
 
 + (instancetype)fileReaderForRouter:(FBiOSActionRouter *)router delegate:(id<FBiOSActionReaderDelegate>)delegate readHandle:(NSFileHandle *)readHandle writeHandle:(NSFileHandle *)writeHandle
 {
-  return [[FBiOSActionFileHandle alloc] initWithDelegate:delegate router:router readHandle:readHandle writeHandle:writeHandle];
+  return [[FBiOSActionFileHandle alloc] initWithDelegate:delegate router:router readHandle:readHandle writeHandle:writeHandle maximumConcurrentActions:0];
+}
+
++ (instancetype)fileReaderForRouter:(FBiOSActionRouter *)router delegate:(id<FBiOSActionReaderDelegate>)delegate readHandle:(NSFileHandle *)readHandle writeHandle:(NSFileHandle *)writeHandle maximumConcurrentActions:(NSUInteger)maximumConcurrentActions
+{
+  return [[FBiOSActionFileHandle alloc] initWithDelegate:delegate router:router readHandle:readHandle writeHandle:writeHandle maximumConcurrentActions:maximumConcurrentActions];
 }
 
-- (instancetype)initWithDelegate:(id<FBiOSActionReaderDelegate>)delegate router:(FBiOSActionRouter *)router
+- (instancetype)initWithDelegate:(id<FBiOSActionReaderDelegate>)delegate router:(FBiOSActionRouter *)router maximumConcurrentActions:(NSUInteger)maximumConcurrentActions
 {
   self = [super init];
   if (!self) {
@@ -292,6 +769,8 @@ FBiOSTargetFutureType const FBiOSTargetFutureTypeActionReader = @"action_reader"
   _delegate = delegate;
   _router = router;
   _completedFuture = FBMutableFuture.future;
+  // A zero limit means that actions are performed synchronously on the read path, one at a time.
+  _scheduler = maximumConcurrentActions > 0 ? [[FBiOSActionScheduler alloc] initWithMaximumConcurrentActions:maximumConcurrentActions] : nil;
 
   return self;
 }
@@ -333,9 +812,9 @@ FBiOSTargetFutureType const FBiOSTargetFutureTypeActionReader = @"action_reader"
 
 #pragma mark Initializerss
 
-- (instancetype)initWithDelegate:(id<FBiOSActionReaderDelegate>)delegate router:(FBiOSActionRouter *)router port:(in_port_t)port
+- (instancetype)initWithDelegate:(id<FBiOSActionReaderDelegate>)delegate router:(FBiOSActionRouter *)router port:(in_port_t)port maximumConcurrentActions:(NSUInteger)maximumConcurrentActions
 {
-  self = [super initWithDelegate:delegate router:router];
+  self = [super initWithDelegate:delegate router:router maximumConcurrentActions:maximumConcurrentActions];
   if (!self) {
     return nil;
   }
@@ -373,7 +852,7 @@ FBiOSTargetFutureType const FBiOSTargetFutureTypeActionReader = @"action_reader"
 
 - (id<FBSocketConsumer>)consumerWithClientAddress:(struct in6_addr)clientAddress
 {
-  return [[FBiOSActionReaderMediator alloc] initWithReader:self router:self.router delegate:self.delegate writeBack:FBFileWriter.nullWriter];
+  return [[FBiOSActionReaderMediator alloc] initWithReader:self router:self.router delegate:self.delegate writeBack:FBFileWriter.nullWriter scheduler:self.scheduler];
 }
 
 @end
@@ -382,16 +861,16 @@ FBiOSTargetFutureType const FBiOSTargetFutureTypeActionReader = @"action_reader"
 
 #pragma mark Initializerss
 
-- (instancetype)initWithDelegate:(id<FBiOSActionReaderDelegate>)delegate router:(FBiOSActionRouter *)router readHandle:(NSFileHandle *)readHandle writeHandle:(NSFileHandle *)writeHandle
+- (instancetype)initWithDelegate:(id<FBiOSActionReaderDelegate>)delegate router:(FBiOSActionRouter *)router readHandle:(NSFileHandle *)readHandle writeHandle:(NSFileHandle *)writeHandle maximumConcurrentActions:(NSUInteger)maximumConcurrentActions
 {
-  self = [super initWithDelegate:delegate router:router];
+  self = [super initWithDelegate:delegate router:router maximumConcurrentActions:maximumConcurrentActions];
   if (!self) {
     return nil;
   }
 
   _reader = [FBFileReader readerWithFileHandle:readHandle consumer:self logger:nil];
   _writer = [FBFileWriter syncWriterWithFileHandle:writeHandle];
-  _mediator = [[FBiOSActionReaderMediator alloc] initWithReader:self router:self.router delegate:self.delegate writeBack:self.writer];
+  _mediator = [[FBiOSActionReaderMediator alloc] initWithReader:self router:self.router delegate:self.delegate writeBack:self.writer scheduler:self.scheduler];
 
   return self;
 }
@@ -108,6 +108,17 @@ extern id<FBiOSTargetContinuation> FBiOSTargetContinuationDone(FBiOSTargetFuture
  */
 - (FBFuture<FBiOSTargetFutureType> *)runWithTarget:(id<FBiOSTarget>)target consumer:(id<FBDataConsumer>)consumer reporter:(id<FBEventReporter>)reporter;
 
+@optional
+
+/**
+ Whether the reciever must not run at the same time as another action on the same target.
+ Actions that do not implement this are treated as conflicting with all other actions.
+
+ @param action the action to compare against.
+ @return YES if the actions conflict, NO otherwise.
+ */
+- (BOOL)conflictsWithAction:(id<FBiOSTargetFuture>)action;
+
 @end
 
 /**
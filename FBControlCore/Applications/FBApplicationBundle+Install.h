@@ -52,7 +52,8 @@ typedef enum {
 
 /**
  Obtains an extracted version of an Application based on a file path.
- When the context is torn down, any extracted path will be deleted.
+ IPAs are extracted by the shared FBArchiveExtractionCache, so concurrent installs of the same IPA extract it once.
+ The extracted Application is shared, so it must not be modified. When the context is torn down, the reference to the extraction is released.
 
  @param queue the queue to extract on.
  @param path the path of the .app or .ipa
@@ -61,6 +62,17 @@ typedef enum {
  */
 + (FBFutureContext<FBExtractedApplication *> *)onQueue:(dispatch_queue_t)queue findOrExtractApplicationAtPath:(NSString *)path logger:(nullable id<FBControlCoreLogger>)logger;
 
+/**
+ Obtains an extracted version of an Application based on a file path, that may be modified.
+ IPAs are extracted into a directory that is private to the context. When the context is torn down, any extracted path will be deleted.
+
+ @param queue the queue to extract on.
+ @param path the path of the .app or .ipa
+ @param logger the (optional) logger to log to.
+ @return a future wrapping the extracted application.
+ */
++ (FBFutureContext<FBExtractedApplication *> *)onQueue:(dispatch_queue_t)queue findOrExtractModifiableApplicationAtPath:(NSString *)path logger:(nullable id<FBControlCoreLogger>)logger;
+
 /**
  Copy additional framework to Application path.
 
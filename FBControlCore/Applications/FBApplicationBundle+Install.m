@@ -9,6 +9,7 @@
 
 #import "FBApplicationBundle+Install.h"
 
+#import "FBArchiveExtractionCache.h"
 #import "FBBinaryDescriptor.h"
 #import "FBBinaryParser.h"
 #import "FBCollectionInformation.h"
@@ -16,8 +17,7 @@
 #import "FBControlCoreError.h"
 #import "FBControlCoreGlobalConfiguration.h"
 #import "FBControlCoreLogger.h"
-#import "FBTask.h"
-#import "FBTaskBuilder.h"
+#import "FBZipArchive.h"
 
 @implementation FBExtractedApplication
 
@@ -36,32 +36,18 @@
 
 @end
 
-static BOOL deleteDirectory(NSURL *path)
-{
-  if (path == nil) {
-    return YES;
-  }
-  return [[NSFileManager defaultManager] removeItemAtURL:path error:nil];
-}
-
 @implementation FBApplicationBundle (Install)
 
 #pragma mark Public
 
 + (FBFutureContext<FBExtractedApplication *> *)onQueue:(dispatch_queue_t)queue findOrExtractApplicationAtPath:(NSString *)path logger:(id<FBControlCoreLogger>)logger;
 {
-  NSURL *extractPath = [NSURL fileURLWithPath:[NSTemporaryDirectory() stringByAppendingPathComponent:NSProcessInfo.processInfo.globallyUniqueString] isDirectory:YES];
-  return [[FBApplicationBundle
-    findOrExtractApplicationAtPath:path extractPath:extractPath queue:queue logger:logger]
-    onQueue:queue pend:^(NSString *appPath) {
-      NSError *error = nil;
-      FBApplicationBundle *bundle = [FBApplicationBundle applicationWithPath:appPath error:&error];
-      if (!bundle) {
-        return [FBFuture futureWithError:error];
-      }
-      FBExtractedApplication *application = [[FBExtractedApplication alloc] initWithBundle:bundle extractedPath:extractPath];
-      return [FBFuture futureWithResult:application];
-  }];
+  return [FBApplicationBundle onQueue:queue findOrExtractApplicationAtPath:path shared:YES logger:logger];
+}
+
++ (FBFutureContext<FBExtractedApplication *> *)onQueue:(dispatch_queue_t)queue findOrExtractModifiableApplicationAtPath:(NSString *)path logger:(id<FBControlCoreLogger>)logger
+{
+  return [FBApplicationBundle onQueue:queue findOrExtractApplicationAtPath:path shared:NO logger:logger];
 }
 
 + (NSString *)copyFrameworkToApplicationAtPath:(NSString *)appPath frameworkPath:(NSString *)frameworkPath
@@ -151,11 +137,12 @@ static unsigned short const TarFileMagicHeader = 0x8b1f;
   return magic == ZipFileMagicHeader;
 }
 
-+ (FBFutureContext<NSString *> *)findOrExtractApplicationAtPath:(NSString *)path extractPath:(NSURL *)extractPath queue:(dispatch_queue_t)queue logger:(id<FBControlCoreLogger>)logger
++ (FBFutureContext<FBExtractedApplication *> *)onQueue:(dispatch_queue_t)queue findOrExtractApplicationAtPath:(NSString *)path shared:(BOOL)shared logger:(id<FBControlCoreLogger>)logger
 {
   // If it's an App, we don't need to do anything, just return early.
   if ([FBApplicationBundle isApplicationAtPath:path]) {
-    return [FBFutureContext futureContextWithResult:path];
+    NSURL *extractPath = [NSURL fileURLWithPath:[NSTemporaryDirectory() stringByAppendingPathComponent:NSProcessInfo.processInfo.globallyUniqueString] isDirectory:YES];
+    return [FBFutureContext futureContextWithFuture:[FBApplicationBundle extractedApplicationAtPath:path extractPath:extractPath]];
   }
   // The other case is that this is an IPA, check it is before extacting.
   NSError *error = nil;
@@ -165,21 +152,37 @@ static unsigned short const TarFileMagicHeader = 0x8b1f;
       causedBy:error]
       failFutureContext];
   }
-  // Create the path to extract into, if it doesn't exist yet.
-  if (![NSFileManager.defaultManager createDirectoryAtURL:extractPath withIntermediateDirectories:YES attributes:nil error:&error]) {
-    return [[[FBControlCoreError
-      describeFormat:@"Could not create temporary directory for IPA extraction %@", extractPath]
-      causedBy:error]
-      failFutureContext];
-  }
-  // Run the unzip command.
-  return [[[[[[[[FBTaskBuilder
-    withLaunchPath:@"/usr/bin/unzip"]
-    withArguments:@[@"-o", @"-d", extractPath.path, path]]
-    withAcceptableTerminationStatusCodes:[NSSet setWithObject:@0]]
-    withStdErrToLogger:logger.debug]
-    withStdOutToLogger:logger.debug]
-    runUntilCompletion]
+  // A shared extraction is re-used by every install of an IPA with the same contents, a private one can be modified.
+  FBFutureContext<NSURL *> *extraction = shared
+    ? [FBArchiveExtractionCache.sharedCache onQueue:queue extractArchiveAtPath:path]
+    : [FBApplicationBundle onQueue:queue extractArchiveAtPath:path logger:logger];
+  return [extraction
+    onQueue:queue pend:^(NSURL *extractPath) {
+      return [[FBApplicationBundle
+        findAppPathFromDirectory:extractPath]
+        onQueue:queue fmap:^(NSString *appPath) {
+          return [FBApplicationBundle extractedApplicationAtPath:appPath extractPath:extractPath];
+        }];
+    }];
+}
+
++ (FBFutureContext<NSURL *> *)onQueue:(dispatch_queue_t)queue extractArchiveAtPath:(NSString *)path logger:(id<FBControlCoreLogger>)logger
+{
+  NSURL *extractPath = [NSURL fileURLWithPath:[NSTemporaryDirectory() stringByAppendingPathComponent:NSProcessInfo.processInfo.globallyUniqueString] isDirectory:YES];
+  return [[FBFuture
+    onQueue:queue resolve:^ FBFuture<NSURL *> * {
+      // The archive is read in-process, rather than by spawning unzip.
+      NSError *error = nil;
+      FBZipArchive *archive = [FBZipArchive archiveAtPath:path error:&error];
+      if (!archive || ![archive extractToDirectory:extractPath.path error:&error]) {
+        [NSFileManager.defaultManager removeItemAtURL:extractPath error:nil];
+        return [[[FBControlCoreError
+          describeFormat:@"Could not extract IPA %@ to %@", path, extractPath]
+          causedBy:error]
+          failFuture];
+      }
+      return [FBFuture futureWithResult:extractPath];
+    }]
     onQueue:queue contextualTeardown:^(id _, FBFutureState __) {
       [logger logFormat:@"Removing extracted directory %@", extractPath];
       NSError *innerError = nil;
@@ -188,12 +191,20 @@ static unsigned short const TarFileMagicHeader = 0x8b1f;
       } else {
         [logger logFormat:@"Failed to remove extracted directory %@ with error %@", extractPath, innerError];
       }
-    }]
-    onQueue:queue pend:^(FBTask *task) {
-      return [FBApplicationBundle findAppPathFromDirectory:extractPath];
     }];
 }
 
++ (FBFuture<FBExtractedApplication *> *)extractedApplicationAtPath:(NSString *)appPath extractPath:(NSURL *)extractPath
+{
+  NSError *error = nil;
+  FBApplicationBundle *bundle = [FBApplicationBundle applicationWithPath:appPath error:&error];
+  if (!bundle) {
+    return [FBFuture futureWithError:error];
+  }
+  FBExtractedApplication *application = [[FBExtractedApplication alloc] initWithBundle:bundle extractedPath:extractPath];
+  return [FBFuture futureWithResult:application];
+}
+
 + (FBFuture<NSString *> *)findAppPathFromDirectory:(NSURL *)directory
 {
   NSDirectoryEnumerator *directoryEnumerator = [NSFileManager.defaultManager
@@ -209,7 +220,6 @@ static unsigned short const TarFileMagicHeader = 0x8b1f;
     }
   }
   if (applicationURLs.count != 1) {
-    deleteDirectory(directory);
     return [[FBControlCoreError
       describeFormat:@"Expected only one Application in IPA, found %lu", applicationURLs.count]
       failFuture];
@@ -109,8 +109,11 @@ static NSString *const KeyCodesign = @"codesign";
 
 - (FBFuture<id<FBiOSTargetContinuation>> *)runWithTarget:(id<FBiOSTarget>)target consumer:(id<FBDataConsumer>)consumer reporter:(id<FBEventReporter>)reporter
 {
-  return [[[[FBApplicationBundle
-    onQueue:target.asyncQueue findOrExtractApplicationAtPath:self.applicationPath logger:target.logger]
+  // Signing modifies the Application, so it cannot use an extraction that is shared with other installs.
+  FBFutureContext<FBExtractedApplication *> *extraction = self.codesign
+    ? [FBApplicationBundle onQueue:target.asyncQueue findOrExtractModifiableApplicationAtPath:self.applicationPath logger:target.logger]
+    : [FBApplicationBundle onQueue:target.asyncQueue findOrExtractApplicationAtPath:self.applicationPath logger:target.logger];
+  return [[extraction
     onQueue:target.workQueue pop:^FBFuture *(FBExtractedApplication *extractedApplication) {
       if (self.codesign) {
         return [[FBCodesignProvider.codeSignCommandWithAdHocIdentity
@@ -121,11 +124,6 @@ static NSString *const KeyCodesign = @"codesign";
         installApplicationWithPath:extractedApplication.bundle.path]
         mapReplace:extractedApplication];
     }]
-    onQueue:target.workQueue notifyOfCompletion:^(FBFuture<FBExtractedApplication *> *future) {
-      if (future.result) {
-        [NSFileManager.defaultManager removeItemAtURL:future.result.extractedPath error:nil];
-      }
-    }]
     mapReplace:FBiOSTargetContinuationDone(self.class.futureType)];
 }
 
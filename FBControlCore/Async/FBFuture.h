@@ -145,6 +145,19 @@ typedef NS_ENUM(NSUInteger, FBFutureState) {
  */
 - (instancetype)onQueue:(dispatch_queue_t)queue notifyOfCompletion:(void (^)(FBFuture *))handler;
 
+/**
+ Notifies of the resolution of the Future, running the handler inline where possible.
+ If the Future is resolved from a handler that is already running on the same queue, the handler is run immediately, rather than being dispatched to the queue again.
+ Code that is not itself a handler is not on the same queue. A handler that has called dispatch_sync to another queue still holds its own queue, so it is on the same queue.
+ Otherwise this behaves the same as -[FBFuture onQueue:notifyOfCompletion:].
+ The handler must therefore not assume that it runs after the resolving code has returned.
+
+ @param queue the queue to notify on.
+ @param handler the block to invoke.
+ @return the Reciever, for chaining.
+ */
+- (instancetype)onQueue:(dispatch_queue_t)queue notifyOfCompletionInline:(void (^)(FBFuture *))handler;
+
 /**
  Notifies of the successful resolution of the Future.
  The handler will resolve before the chained Future.
@@ -179,6 +192,17 @@ typedef NS_ENUM(NSUInteger, FBFutureState) {
  */
 - (FBFuture *)onQueue:(dispatch_queue_t)queue chain:(FBFuture * (^)(FBFuture *future))chain;
 
+/**
+ Chain Futures based on any non-cancellation resolution of the reciever, running the chain inline where possible.
+ Behaves the same as -[FBFuture onQueue:chain:], except that the handlers are registered with -[FBFuture onQueue:notifyOfCompletionInline:].
+ The chain may therefore run within the call that resolves the reciever, so it must not be used where the resolving code holds a lock that the chain takes.
+
+ @param queue the queue to chain on.
+ @param chain the chaining handler, called on all completion events.
+ @return a chained future
+ */
+- (FBFuture *)onQueue:(dispatch_queue_t)queue chainInline:(FBFuture * (^)(FBFuture *future))chain;
+
 /**
  FlatMap a successful resolution of the reciever to a new Future.
 
@@ -188,6 +212,17 @@ typedef NS_ENUM(NSUInteger, FBFutureState) {
  */
 - (FBFuture *)onQueue:(dispatch_queue_t)queue fmap:(FBFuture * (^)(T result))fmap;
 
+/**
+ FlatMap a successful resolution of the reciever to a new Future, running the fmap inline where possible.
+ Behaves the same as -[FBFuture onQueue:fmap:], except that the handlers are registered with -[FBFuture onQueue:notifyOfCompletionInline:].
+ The fmap may therefore run within the call that resolves the reciever, so it must not be used where the resolving code holds a lock that the fmap takes.
+
+ @param queue the queue to chain on.
+ @param fmap the function to re-map the result to a new future, only called on success.
+ @return a flatmapped future
+ */
+- (FBFuture *)onQueue:(dispatch_queue_t)queue fmapInline:(FBFuture * (^)(T result))fmap;
+
 /**
  Map a future's result to a new value, based on a successful resolution of the reciever.
 
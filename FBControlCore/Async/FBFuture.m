@@ -11,6 +11,7 @@
 
 #import "FBCollectionOperations.h"
 #import "FBControlCore.h"
+#import "FBFutureTracer.h"
 
 /**
  A String Mirror of the State.
@@ -64,16 +65,35 @@ static void final_resolveUntil(FBMutableFuture *final, dispatch_queue_t queue, F
     }];
 }
 
+static NSTimeInterval const FBFutureResolveWhenMinimumInterval = 0.001;
+static NSTimeInterval const FBFutureResolveWhenMaximumInterval = 0.1;
+
+static void final_resolveWhen(FBMutableFuture *final, dispatch_queue_t queue, BOOL (^resolveWhen)(void), NSTimeInterval interval) {
+    if (final.state != FBFutureStateRunning) {
+      return;
+    }
+    if (resolveWhen()) {
+      [final resolveWithResult:@YES];
+      return;
+    }
+    // The condition is checked immediately, then with an increasing interval. Conditions that become true quickly resolve quickly, without busy polling for slower ones.
+    NSTimeInterval nextInterval = MIN(interval * 2, FBFutureResolveWhenMaximumInterval);
+    dispatch_after(FBFutureCreateDispatchTime(interval), queue, ^{
+      final_resolveWhen(final, queue, resolveWhen, nextInterval);
+    });
+}
+
 @interface FBFuture_Handler : NSObject
 
 @property (nonatomic, strong, readonly) dispatch_queue_t queue;
 @property (nonatomic, strong, readonly) void (^handler)(FBFuture *);
+@property (nonatomic, assign, readonly) BOOL runsInline;
 
 @end
 
 @implementation FBFuture_Handler
 
-- (instancetype)initWithQueue:(dispatch_queue_t)queue handler:(void (^)(FBFuture *))handler
+- (instancetype)initWithQueue:(dispatch_queue_t)queue handler:(void (^)(FBFuture *))handler runsInline:(BOOL)runsInline
 {
   self = [super init];
   if (!self) {
@@ -82,6 +102,121 @@ static void final_resolveUntil(FBMutableFuture *final, dispatch_queue_t queue, F
 
   _queue = queue;
   _handler = handler;
+  _runsInline = runsInline;
+
+  return self;
+}
+
+@end
+
+/**
+ The queue of the handler that is running on the current thread, if any.
+ Used to determine whether an inline handler can be run without a hop to the queue.
+ This is kept by FBFuture, rather than as a specific on the queue, as the queue belongs to the caller.
+ A handler that calls dispatch_sync to another queue still holds its own queue, so it remains the current handler.
+ */
+static __thread void *FBFutureCurrentHandlerQueue = NULL;
+static __thread NSUInteger FBFutureInlineDepth = 0;
+
+// Bounds the recursion of inline handlers, so that long pipelines cannot exhaust the stack.
+static NSUInteger const FBFutureMaximumInlineDepth = 32;
+
+static void FBFutureRunHandler(FBFuture_Handler *handler, FBFuture *future, FBFutureTracer *tracer, FBFutureTraceIdentifier traceIdentifier, uint64_t scheduled)
+{
+  void *previousQueue = FBFutureCurrentHandlerQueue;
+  FBFutureCurrentHandlerQueue = (__bridge void *) handler.queue;
+  uint64_t started = tracer ? FBFutureTracer.timestamp : 0;
+  handler.handler(future);
+  if (tracer) {
+    [tracer recordHandler:traceIdentifier queue:handler.queue scheduled:scheduled started:started finished:FBFutureTracer.timestamp];
+  }
+  FBFutureCurrentHandlerQueue = previousQueue;
+}
+
+static void FBFutureScheduleHandler(FBFuture_Handler *handler, FBFuture *future, FBFutureTracer *tracer, FBFutureTraceIdentifier traceIdentifier)
+{
+  uint64_t scheduled = tracer ? FBFutureTracer.timestamp : 0;
+  void *queue = (__bridge void *) handler.queue;
+  if (handler.runsInline && FBFutureCurrentHandlerQueue == queue && FBFutureInlineDepth < FBFutureMaximumInlineDepth) {
+    FBFutureInlineDepth++;
+    FBFutureRunHandler(handler, future, tracer, traceIdentifier, scheduled);
+    FBFutureInlineDepth--;
+    return;
+  }
+  dispatch_async(handler.queue, ^{
+    FBFutureRunHandler(handler, future, tracer, traceIdentifier, scheduled);
+  });
+}
+
+/**
+ A lock-free list of objects, which can be sealed exactly once.
+ Objects are pushed with compare-and-swap, sealing swaps in a sentinel and takes all of the objects pushed before it.
+ Pushing to a sealed list fails, so the caller knows that the list has already been consumed.
+ */
+typedef struct FBFutureListNode {
+  struct FBFutureListNode *next;
+  const void *object;
+} FBFutureListNode;
+
+#define FBFutureListSealed ((FBFutureListNode *) (uintptr_t) 1)
+
+static BOOL FBFutureListPush(FBFutureListNode **head, id object)
+{
+  FBFutureListNode *node = malloc(sizeof(FBFutureListNode));
+  node->object = CFBridgingRetain(object);
+  FBFutureListNode *current = __atomic_load_n(head, __ATOMIC_ACQUIRE);
+  do {
+    if (current == FBFutureListSealed) {
+      CFRelease(node->object);
+      free(node);
+      return NO;
+    }
+    node->next = current;
+  } while (!__atomic_compare_exchange_n(head, &current, node, YES, __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE));
+  return YES;
+}
+
+static NSArray *FBFutureListSeal(FBFutureListNode **head)
+{
+  FBFutureListNode *node = __atomic_exchange_n(head, FBFutureListSealed, __ATOMIC_ACQ_REL);
+  if (node == FBFutureListSealed) {
+    return nil;
+  }
+  NSMutableArray *objects = [NSMutableArray array];
+  while (node) {
+    FBFutureListNode *next = node->next;
+    [objects addObject:CFBridgingRelease(node->object)];
+    free(node);
+    node = next;
+  }
+  // The list is a stack, reverse it so that objects are in the order that they were pushed.
+  return [[objects reverseObjectEnumerator] allObjects];
+}
+
+/**
+ The outcome of a Future.
+ The state, result and error are published together with a single compare-and-swap, so they are never observed separately.
+ */
+@interface FBFuture_Resolution : NSObject
+
+@property (nonatomic, assign, readonly) FBFutureState state;
+@property (nonatomic, strong, nullable, readonly) id result;
+@property (nonatomic, strong, nullable, readonly) NSError *error;
+
+@end
+
+@implementation FBFuture_Resolution
+
+- (instancetype)initWithState:(FBFutureState)state result:(id)result error:(NSError *)error
+{
+  self = [super init];
+  if (!self) {
+    return nil;
+  }
+
+  _state = state;
+  _result = result;
+  _error = error;
 
   return self;
 }
@@ -246,15 +381,23 @@ static void final_resolveUntil(FBMutableFuture *final, dispatch_queue_t queue, F
 @interface FBFuture ()
 
 @property (atomic, copy, nullable, readwrite) NSString *name;
-@property (nonatomic, strong, readonly) NSMutableArray<FBFuture_Handler *> *handlers;
-@property (nonatomic, strong, nullable, readwrite) NSMutableArray<FBFuture_Cancellation *> *cancelResponders;
 @property (nonatomic, strong, nullable, readwrite) FBFuture<NSNull *> *resolvedCancellation;
+@property (nonatomic, strong, readonly, class) dispatch_queue_t combinatorQueue;
+
+- (instancetype)tracedFromParent:(FBFuture *)parent;
 
 @end
 
 @implementation FBFuture
-
-@synthesize error = _error, result = _result, state = _state;
+{
+  // The FBFuture_Resolution, retained once it has been published with compare-and-swap.
+  const void *_resolution;
+  FBFutureListNode *_handlers;
+  FBFutureListNode *_cancelResponders;
+  // Only set if a tracer was active when the Future was created.
+  FBFutureTracer *_tracer;
+  FBFutureTraceIdentifier _traceIdentifier;
+}
 
 #pragma mark Initializers
 
@@ -322,24 +465,9 @@ static void final_resolveUntil(FBMutableFuture *final, dispatch_queue_t queue, F
 + (FBFuture<NSNumber *> *)onQueue:(dispatch_queue_t)queue resolveWhen:(BOOL (^)(void))resolveWhen
 {
   FBMutableFuture *future = FBMutableFuture.future;
-
   dispatch_async(queue, ^{
-    const NSTimeInterval interval = 0.1;
-    const dispatch_source_t timer = dispatch_source_create(DISPATCH_SOURCE_TYPE_TIMER, 0, 0, queue);
-
-    dispatch_source_set_timer(timer, FBFutureCreateDispatchTime(interval), (uint64_t)(interval * NSEC_PER_SEC), (uint64_t)(interval * NSEC_PER_SEC / 10));
-    dispatch_source_set_event_handler(timer, ^{
-      if (future.state != FBFutureStateRunning) {
-        dispatch_cancel(timer);
-      } else if (resolveWhen()) {
-        dispatch_cancel(timer);
-        [future resolveWithResult:@YES];
-      }
-    });
-
-    dispatch_resume(timer);
+    final_resolveWhen(future, queue, resolveWhen, FBFutureResolveWhenMinimumInterval);
   });
-
   return future;
 }
 
@@ -377,7 +505,7 @@ static void final_resolveUntil(FBMutableFuture *final, dispatch_queue_t queue, F
 
   FBMutableFuture *compositeFuture = FBMutableFuture.future;
   NSMutableArray *results = [[FBCollectionOperations arrayWithObject:NSNull.null count:futures.count] mutableCopy];
-  dispatch_queue_t queue = dispatch_queue_create("com.facebook.fbcontrolcore.future.composite", DISPATCH_QUEUE_SERIAL);
+  dispatch_queue_t queue = FBFuture.combinatorQueue;
   __block NSUInteger remaining = futures.count;
 
   void (^futureCompleted)(FBFuture *, NSUInteger) = ^(FBFuture *future, NSUInteger index) {
@@ -408,6 +536,7 @@ static void final_resolveUntil(FBMutableFuture *final, dispatch_queue_t queue, F
 
   for (NSUInteger index = 0; index < futures.count; index++) {
     FBFuture *future = futures[index];
+    [compositeFuture tracedFromParent:future];
     if (future.hasCompleted) {
       futureCompleted(future, index);
     } else {
@@ -424,7 +553,7 @@ static void final_resolveUntil(FBMutableFuture *final, dispatch_queue_t queue, F
   NSParameterAssert(futures.count > 0);
 
   FBMutableFuture *compositeFuture = FBMutableFuture.future;
-  dispatch_queue_t queue = dispatch_queue_create("com.facebook.fbcontrolcore.future.race", DISPATCH_QUEUE_SERIAL);
+  dispatch_queue_t queue = FBFuture.combinatorQueue;
   __block NSUInteger remainingCounter = futures.count;
 
   void (^cancelAllFutures)(void) = ^{
@@ -451,6 +580,7 @@ static void final_resolveUntil(FBMutableFuture *final, dispatch_queue_t queue, F
   };
 
   for (FBFuture *future in futures) {
+    [compositeFuture tracedFromParent:future];
     if (future.hasCompleted) {
       futureCompleted(future);
     } else {
@@ -472,15 +602,26 @@ static void final_resolveUntil(FBMutableFuture *final, dispatch_queue_t queue, F
     return nil;
   }
 
-  _state = FBFutureStateRunning;
-  _handlers = [NSMutableArray array];
-  _cancelResponders = [NSMutableArray array];
-
   _name = name;
 
+  FBFutureTracer *tracer = FBFutureTracer.activeTracer;
+  if (tracer) {
+    _tracer = tracer;
+    _traceIdentifier = [tracer recordCreation];
+  }
+
   return self;
 }
 
+- (void)dealloc
+{
+  FBFutureListSeal(&_handlers);
+  FBFutureListSeal(&_cancelResponders);
+  if (_resolution) {
+    CFRelease(_resolution);
+  }
+}
+
 #pragma mark NSObject
 
 - (NSString *)description
@@ -514,20 +655,12 @@ static void final_resolveUntil(FBMutableFuture *final, dispatch_queue_t queue, F
 
 - (instancetype)onQueue:(dispatch_queue_t)queue notifyOfCompletion:(void (^)(FBFuture *))handler
 {
-  NSParameterAssert(queue);
-  NSParameterAssert(handler);
+  return [self onQueue:queue notifyOfCompletion:handler runsInline:NO];
+}
 
-  @synchronized (self) {
-    if (self.state == FBFutureStateRunning) {
-      FBFuture_Handler *wrapper = [[FBFuture_Handler alloc] initWithQueue:queue handler:handler];
-      [self.handlers addObject:wrapper];
-    } else {
-      dispatch_async(queue, ^{
-        handler(self);
-      });
-    }
-  }
-  return self;
+- (instancetype)onQueue:(dispatch_queue_t)queue notifyOfCompletionInline:(void (^)(FBFuture *))handler
+{
+  return [self onQueue:queue notifyOfCompletion:handler runsInline:YES];
 }
 
 - (instancetype)onQueue:(dispatch_queue_t)queue doOnResolved:(void (^)(id))handler
@@ -544,79 +677,29 @@ static void final_resolveUntil(FBMutableFuture *final, dispatch_queue_t queue, F
   NSParameterAssert(queue);
   NSParameterAssert(handler);
 
-  @synchronized(self) {
-    [self.cancelResponders addObject:[[FBFuture_Cancellation alloc] initWithQueue:queue handler:handler]];
-    return self;
-  }
+  // Once resolved, the cancellation responders have been discarded, so the push failing is expected.
+  FBFutureListPush(&_cancelResponders, [[FBFuture_Cancellation alloc] initWithQueue:queue handler:handler]);
+  return self;
 }
 
 - (FBFuture *)onQueue:(dispatch_queue_t)queue chain:(FBFuture *(^)(FBFuture *))chain
 {
-  FBMutableFuture *chained = FBMutableFuture.future;
-  [self onQueue:queue notifyOfCompletion:^(FBFuture *future) {
-    if (future.state == FBFutureStateCancelled) {
-      [chained cancel];
-      return;
-    }
-    FBFuture *next = chain(future);
-    NSCAssert([next isKindOfClass:FBFuture.class], @"chained value is not a Future, got %@", next);
-    [next onQueue:queue notifyOfCompletion:^(FBFuture *final) {
-      FBFutureState state = final.state;
-      switch (state) {
-        case FBFutureStateFailed:
-          [chained resolveWithError:final.error];
-          break;
-        case FBFutureStateDone:
-          [chained resolveWithResult:final.result];
-          break;
-        case FBFutureStateCancelled:
-          [chained cancel];
-          break;
-        default:
-          NSCAssert(NO, @"Invalid State %lu", (unsigned long)state);
-      }
-    }];
-  }];
-  // Chaining: 'self' References 'chained'
-  // Cancellation: 'chained' references 'self'
-  // Break the cycle, if weakSelf is nullified, this is fine as completion has been processed already.
-  __weak typeof(self) weakSelf = self;
-  return [chained onQueue:FBFuture.internalQueue respondToCancellation:^{
-    [weakSelf cancel];
-    return [FBFuture futureWithResult:NSNull.null];
-  }];
+  return [self onQueue:queue chain:chain runsInline:NO];
+}
+
+- (FBFuture *)onQueue:(dispatch_queue_t)queue chainInline:(FBFuture *(^)(FBFuture *))chain
+{
+  return [self onQueue:queue chain:chain runsInline:YES];
 }
 
 - (FBFuture *)onQueue:(dispatch_queue_t)queue fmap:(FBFuture * (^)(id result))fmap
 {
-  FBMutableFuture *chained = FBMutableFuture.future;
-  [self onQueue:queue notifyOfCompletion:^(FBFuture *future) {
-    if (future.error) {
-      [chained resolveWithError:future.error];
-      return;
-    }
-    if (future.state == FBFutureStateCancelled) {
-      [chained cancel];
-      return;
-    }
-    FBFuture *fmapped = fmap(future.result);
-    NSCAssert([fmapped isKindOfClass:FBFuture.class], @"fmap'ped value is not a Future, got %@", fmapped);
-    [fmapped onQueue:queue notifyOfCompletion:^(FBFuture *next) {
-      if (next.error) {
-        [chained resolveWithError:next.error];
-        return;
-      }
-      [chained resolveWithResult:next.result];
-    }];
-  }];
-  // Chaining: 'self' References 'chained'
-  // Cancellation: 'chained' references 'self'
-  // Break the cycle, if weakSelf is nullified, this is fine as completion has been processed already.
-  __weak typeof(self) weakSelf = self;
-  return [chained onQueue:FBFuture.internalQueue respondToCancellation:^{
-    [weakSelf cancel];
-    return [FBFuture futureWithResult:NSNull.null];
-  }];
+  return [self onQueue:queue fmap:fmap runsInline:NO];
+}
+
+- (FBFuture *)onQueue:(dispatch_queue_t)queue fmapInline:(FBFuture * (^)(id result))fmap
+{
+  return [self onQueue:queue fmap:fmap runsInline:YES];
 }
 
 - (FBFuture *)onQueue:(dispatch_queue_t)queue map:(id (^)(id result))map
@@ -713,6 +796,9 @@ static void final_resolveUntil(FBMutableFuture *final, dispatch_queue_t queue, F
 - (FBFuture *)named:(NSString *)name
 {
   self.name = name;
+  if (_tracer) {
+    [_tracer recordName:_traceIdentifier name:name];
+  }
   return self;
 }
 
@@ -736,65 +822,36 @@ static void final_resolveUntil(FBMutableFuture *final, dispatch_queue_t queue, F
 
 - (NSError *)error
 {
-  @synchronized (self) {
-    return self->_error;
-  }
+  return self.resolution.error;
 }
 
 - (id)result
 {
-  @synchronized (self) {
-    return self->_result;
-  }
+  return self.resolution.result;
 }
 
 - (FBFutureState)state
 {
-  @synchronized (self) {
-    return _state;
-  }
-}
-
-- (void)setError:(NSError *)error
-{
-  _error = error;
-}
-
-- (void)setState:(FBFutureState)state
-{
-  _state = state;
-}
-
-- (void)setResult:(id)result
-{
-  _result = result;
+  FBFuture_Resolution *resolution = self.resolution;
+  return resolution ? resolution.state : FBFutureStateRunning;
 }
 
 #pragma mark FBMutableFuture Implementation
 
 - (instancetype)resolveWithResult:(id)result
 {
-  @synchronized (self) {
-    if (self.state == FBFutureStateRunning) {
-      self.result = result;
-      self.state = FBFutureStateDone;
-      [self fireAllHandlers];
-      self.cancelResponders = nil;
-    }
+  if ([self publishResolution:[[FBFuture_Resolution alloc] initWithState:FBFutureStateDone result:result error:nil]]) {
+    [self fireAllHandlers];
+    FBFutureListSeal(&_cancelResponders);
   }
-
   return self;
 }
 
 - (instancetype)resolveWithError:(NSError *)error
 {
-  @synchronized (self) {
-    if (self.state == FBFutureStateRunning) {
-      self.error = error;
-      self.state = FBFutureStateFailed;
-      [self fireAllHandlers];
-      self.cancelResponders = nil;
-    }
+  if ([self publishResolution:[[FBFuture_Resolution alloc] initWithState:FBFutureStateFailed result:nil error:error]]) {
+    [self fireAllHandlers];
+    FBFutureListSeal(&_cancelResponders);
   }
   return self;
 }
@@ -827,27 +884,139 @@ static void final_resolveUntil(FBMutableFuture *final, dispatch_queue_t queue, F
 
 #pragma mark Private
 
-- (NSArray<FBFuture_Cancellation *> *)resolveAsCancelled
+- (instancetype)tracedFromParent:(FBFuture *)parent
 {
-  @synchronized (self) {
-    if (self.state == FBFutureStateRunning) {
-      self.state = FBFutureStateCancelled;
-      [self fireAllHandlers];
+  if (_tracer && parent->_tracer == _tracer) {
+    [_tracer recordEdgeFromParent:parent->_traceIdentifier toChild:_traceIdentifier];
+  }
+  return self;
+}
+
+- (FBFuture *)onQueue:(dispatch_queue_t)queue chain:(FBFuture *(^)(FBFuture *))chain runsInline:(BOOL)runsInline
+{
+  FBMutableFuture *chained = [FBMutableFuture.future tracedFromParent:self];
+  [self onQueue:queue notifyOfCompletion:^(FBFuture *future) {
+    if (future.state == FBFutureStateCancelled) {
+      [chained cancel];
+      return;
+    }
+    FBFuture *next = chain(future);
+    NSCAssert([next isKindOfClass:FBFuture.class], @"chained value is not a Future, got %@", next);
+    [chained tracedFromParent:next];
+    [next onQueue:queue notifyOfCompletion:^(FBFuture *final) {
+      FBFutureState state = final.state;
+      switch (state) {
+        case FBFutureStateFailed:
+          [chained resolveWithError:final.error];
+          break;
+        case FBFutureStateDone:
+          [chained resolveWithResult:final.result];
+          break;
+        case FBFutureStateCancelled:
+          [chained cancel];
+          break;
+        default:
+          NSCAssert(NO, @"Invalid State %lu", (unsigned long)state);
+      }
+    } runsInline:runsInline];
+  } runsInline:runsInline];
+  // Chaining: 'self' References 'chained'
+  // Cancellation: 'chained' references 'self'
+  // Break the cycle, if weakSelf is nullified, this is fine as completion has been processed already.
+  __weak typeof(self) weakSelf = self;
+  return [chained onQueue:FBFuture.internalQueue respondToCancellation:^{
+    [weakSelf cancel];
+    return [FBFuture futureWithResult:NSNull.null];
+  }];
+}
+
+- (FBFuture *)onQueue:(dispatch_queue_t)queue fmap:(FBFuture * (^)(id result))fmap runsInline:(BOOL)runsInline
+{
+  FBMutableFuture *chained = [FBMutableFuture.future tracedFromParent:self];
+  [self onQueue:queue notifyOfCompletion:^(FBFuture *future) {
+    if (future.error) {
+      [chained resolveWithError:future.error];
+      return;
+    }
+    if (future.state == FBFutureStateCancelled) {
+      [chained cancel];
+      return;
     }
-    NSArray<FBFuture_Cancellation *> *cancelResponders = self.cancelResponders;
-    self.cancelResponders = nil;
-    return cancelResponders;
+    FBFuture *fmapped = fmap(future.result);
+    NSCAssert([fmapped isKindOfClass:FBFuture.class], @"fmap'ped value is not a Future, got %@", fmapped);
+    [chained tracedFromParent:fmapped];
+    [fmapped onQueue:queue notifyOfCompletion:^(FBFuture *next) {
+      if (next.error) {
+        [chained resolveWithError:next.error];
+        return;
+      }
+      [chained resolveWithResult:next.result];
+    } runsInline:runsInline];
+  } runsInline:runsInline];
+  // Chaining: 'self' References 'chained'
+  // Cancellation: 'chained' references 'self'
+  // Break the cycle, if weakSelf is nullified, this is fine as completion has been processed already.
+  __weak typeof(self) weakSelf = self;
+  return [chained onQueue:FBFuture.internalQueue respondToCancellation:^{
+    [weakSelf cancel];
+    return [FBFuture futureWithResult:NSNull.null];
+  }];
+}
+
+- (FBFuture_Resolution *)resolution
+{
+  return (__bridge FBFuture_Resolution *) __atomic_load_n(&_resolution, __ATOMIC_ACQUIRE);
+}
+
+- (BOOL)publishResolution:(FBFuture_Resolution *)resolution
+{
+  // The whole resolution is published at once, so a resolution that loses the race returns with the winner's state already visible, without waiting on it.
+  const void *expected = NULL;
+  const void *desired = CFBridgingRetain(resolution);
+  if (!__atomic_compare_exchange_n(&_resolution, &expected, desired, NO, __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE)) {
+    CFRelease(desired);
+    return NO;
+  }
+  // There is no setter for the resolved values, so observers are notified once they have been published.
+  NSString *valueKey = resolution.error ? NSStringFromSelector(@selector(error)) : NSStringFromSelector(@selector(result));
+  NSString *stateKey = NSStringFromSelector(@selector(state));
+  [self willChangeValueForKey:valueKey];
+  [self willChangeValueForKey:stateKey];
+  [self didChangeValueForKey:stateKey];
+  [self didChangeValueForKey:valueKey];
+  return YES;
+}
+
+- (instancetype)onQueue:(dispatch_queue_t)queue notifyOfCompletion:(void (^)(FBFuture *))handler runsInline:(BOOL)runsInline
+{
+  NSParameterAssert(queue);
+  NSParameterAssert(handler);
+
+  // If the handlers have already been fired, the handler is scheduled immediately.
+  FBFuture_Handler *wrapper = [[FBFuture_Handler alloc] initWithQueue:queue handler:handler runsInline:runsInline];
+  if (!FBFutureListPush(&_handlers, wrapper)) {
+    FBFutureScheduleHandler(wrapper, self, _tracer, _traceIdentifier);
+  }
+  return self;
+}
+
+- (NSArray<FBFuture_Cancellation *> *)resolveAsCancelled
+{
+  if (![self publishResolution:[[FBFuture_Resolution alloc] initWithState:FBFutureStateCancelled result:nil error:nil]]) {
+    return nil;
   }
+  [self fireAllHandlers];
+  return FBFutureListSeal(&_cancelResponders);
 }
 
 - (void)fireAllHandlers
 {
-  for (FBFuture_Handler *handler in self.handlers) {
-    dispatch_async(handler.queue, ^{
-      handler.handler(self);
-    });
+  if (_tracer) {
+    [_tracer recordResolution:_traceIdentifier state:self.state];
+  }
+  for (FBFuture_Handler *handler in FBFutureListSeal(&_handlers)) {
+    FBFutureScheduleHandler(handler, self, _tracer, _traceIdentifier);
   }
-  [self.handlers removeAllObjects];
 }
 
 + (FBFuture<NSNull *> *)resolveCancellationResponders:(NSArray<FBFuture_Cancellation *> *)cancelResponders forOriginalName:(NSString *)originalName
@@ -872,6 +1041,24 @@ static void final_resolveUntil(FBMutableFuture *final, dispatch_queue_t queue, F
   return dispatch_get_global_queue(DISPATCH_QUEUE_PRIORITY_HIGH, 0);
 }
 
++ (dispatch_queue_t)combinatorQueue
+{
+  // Combinators only need their callbacks to be serialized, so share a small pool of serial queues rather than creating a queue each time.
+  static NSUInteger const QueueCount = 8;
+  static dispatch_once_t onceToken;
+  static NSArray<dispatch_queue_t> *queues;
+  static NSUInteger counter = 0;
+  dispatch_once(&onceToken, ^{
+    NSMutableArray<dispatch_queue_t> *created = [NSMutableArray array];
+    for (NSUInteger index = 0; index < QueueCount; index++) {
+      [created addObject:dispatch_queue_create("com.facebook.fbcontrolcore.future.combinator", DISPATCH_QUEUE_SERIAL)];
+    }
+    queues = [created copy];
+  });
+  NSUInteger index = __atomic_fetch_add(&counter, 1, __ATOMIC_RELAXED);
+  return queues[index % QueueCount];
+}
+
 #pragma mark KVO
 
 + (NSSet<NSString *> *)keyPathsForValuesAffectingHasCompleted
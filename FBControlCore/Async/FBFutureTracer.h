@@ -0,0 +1,153 @@
+/**
+ * Copyright (c) 2015-present, Facebook, Inc.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree. An additional grant
+ * of patent rights can be found in the PATENTS file in the same directory.
+ */
+
+#import <Foundation/Foundation.h>
+
+#import <FBControlCore/FBFuture.h>
+
+NS_ASSUME_NONNULL_BEGIN
+
+/**
+ An identifier for a Future within a trace.
+ Futures that are created whilst no tracer is active have an identifier of 0.
+ */
+typedef uint64_t FBFutureTraceIdentifier;
+
+/**
+ Records the lifecycle of Futures, for export in the Chrome Trace Event Format.
+ This can be loaded into chrome://tracing or any other viewer of the format, to see where time is spent in a pipeline of Futures.
+
+ Whilst a tracer is active, the following are recorded:
+ - The creation and resolution of each Future, along with its name and final state.
+ - The edges from a Future to the Futures that are derived from it, in chain:, fmap: and the combinators built upon them.
+ - The execution of each completion handler, along with the delay between the handler being scheduled and it running.
+
+ Only one tracer may be active at a time. When no tracer is active, a Future only pays for a check of the active tracer upon creation.
+ The number of recorded Futures and handlers is bounded, so that a long-running trace does not grow without limit. Once the bound is reached, the oldest records are dropped.
+ */
+@interface FBFutureTracer : NSObject
+
+#pragma mark Initializers
+
+/**
+ A new tracer, that is not yet active.
+ Retains up to 100,000 Futures and 100,000 handlers.
+
+ @return a new Future Tracer.
+ */
++ (instancetype)tracer;
+
+/**
+ A new tracer, that is not yet active.
+
+ @param maximumRecordCount the maximum number of Futures, and separately of handlers, to retain.
+ @return a new Future Tracer.
+ */
++ (instancetype)tracerWithMaximumRecordCount:(NSUInteger)maximumRecordCount;
+
+#pragma mark Properties
+
+/**
+ The tracer that is currently recording, if any.
+ */
+@property (nonatomic, strong, nullable, readonly, class) FBFutureTracer *activeTracer;
+
+#pragma mark Public Methods
+
+/**
+ Makes the reciever the active tracer, replacing any tracer that is already active.
+ */
+- (void)start;
+
+/**
+ Stops the reciever recording, if it is the active tracer.
+ Recorded events are retained, so they can be exported after stopping.
+ */
+- (void)stop;
+
+/**
+ The recorded events, in the Chrome Trace Event Format.
+ Futures that have not resolved are ended at the time this is called.
+
+ @return an array of trace event dictionaries.
+ */
+- (NSArray<NSDictionary<NSString *, id> *> *)traceEvents;
+
+/**
+ Serializes the recorded events as a Chrome Trace Event JSON Object.
+
+ @param error an error out for any error that occurs.
+ @return the JSON data if successful, nil otherwise.
+ */
+- (nullable NSData *)chromeTraceData:(NSError **)error;
+
+/**
+ Writes the recorded events as a Chrome Trace Event JSON Object to a file.
+
+ @param path the path to write to.
+ @param error an error out for any error that occurs.
+ @return YES if successful, NO otherwise.
+ */
+- (BOOL)writeChromeTraceToPath:(NSString *)path error:(NSError **)error;
+
+#pragma mark Recording
+
+/**
+ The current time, in the timebase of the tracer.
+ Called by Futures to timestamp handler scheduling.
+
+ @return the current time.
+ */
++ (uint64_t)timestamp;
+
+/**
+ Records the creation of a Future.
+
+ @return the identifier of the created Future.
+ */
+- (FBFutureTraceIdentifier)recordCreation;
+
+/**
+ Records an edge between a Future and one that is derived from it.
+
+ @param parent the identifier of the parent Future.
+ @param child the identifier of the child Future.
+ */
+- (void)recordEdgeFromParent:(FBFutureTraceIdentifier)parent toChild:(FBFutureTraceIdentifier)child;
+
+/**
+ Records the naming of a Future.
+
+ @param identifier the identifier of the Future.
+ @param name the name of the Future.
+ */
+- (void)recordName:(FBFutureTraceIdentifier)identifier name:(NSString *)name;
+
+/**
+ Records the resolution of a Future.
+
+ @param identifier the identifier of the Future.
+ @param state the state that the Future has resolved to.
+ */
+- (void)recordResolution:(FBFutureTraceIdentifier)identifier state:(FBFutureState)state;
+
+/**
+ Records the execution of a completion handler of a Future.
+
+ @param identifier the identifier of the Future.
+ @param queue the queue the handler ran on.
+ @param scheduled the timestamp at which the handler was scheduled.
+ @param started the timestamp at which the handler started.
+ @param finished the timestamp at which the handler finished.
+ */
+- (void)recordHandler:(FBFutureTraceIdentifier)identifier queue:(dispatch_queue_t)queue scheduled:(uint64_t)scheduled started:(uint64_t)started finished:(uint64_t)finished;
+
+@end
+
+NS_ASSUME_NONNULL_END
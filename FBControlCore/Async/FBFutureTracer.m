@@ -0,0 +1,341 @@
+/**
+ * Copyright (c) 2015-present, Facebook, Inc.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree. An additional grant
+ * of patent rights can be found in the PATENTS file in the same directory.
+ */
+
+#import "FBFutureTracer.h"
+
+#import <mach/mach_time.h>
+#import <pthread.h>
+
+#import "FBControlCoreError.h"
+
+// Read on every Future creation, so the flag is checked before taking the lock that guards the active tracer.
+static FBFutureTracer *FBFutureTracerActive = nil;
+static BOOL FBFutureTracerIsActive = NO;
+
+static NSUInteger const FBFutureTracerDefaultMaximumRecordCount = 100000;
+
+static NSString *FBFutureTracerStateName(FBFutureState state)
+{
+  switch (state) {
+    case FBFutureStateRunning:
+      return @"running";
+    case FBFutureStateDone:
+      return @"done";
+    case FBFutureStateFailed:
+      return @"failed";
+    case FBFutureStateCancelled:
+      return @"cancelled";
+    default:
+      return @"unknown";
+  }
+}
+
+static NSString *FBFutureTracerIdentifierString(FBFutureTraceIdentifier identifier)
+{
+  return [NSString stringWithFormat:@"0x%llx", identifier];
+}
+
+@interface FBFutureTracer_Future : NSObject
+
+@property (nonatomic, assign, readonly) FBFutureTraceIdentifier identifier;
+@property (nonatomic, assign, readonly) uint64_t created;
+@property (nonatomic, assign, readwrite) uint64_t resolved;
+@property (nonatomic, assign, readwrite) FBFutureState state;
+@property (nonatomic, copy, nullable, readwrite) NSString *name;
+@property (nonatomic, strong, readonly) NSMutableArray<NSNumber *> *parents;
+
+@end
+
+@implementation FBFutureTracer_Future
+
+- (instancetype)initWithIdentifier:(FBFutureTraceIdentifier)identifier created:(uint64_t)created
+{
+  self = [super init];
+  if (!self) {
+    return nil;
+  }
+
+  _identifier = identifier;
+  _created = created;
+  _state = FBFutureStateRunning;
+  _parents = [NSMutableArray array];
+
+  return self;
+}
+
+@end
+
+@interface FBFutureTracer_Handler : NSObject
+
+@property (nonatomic, assign, readonly) FBFutureTraceIdentifier identifier;
+@property (nonatomic, copy, readonly) NSString *queueLabel;
+@property (nonatomic, assign, readonly) uint64_t threadIdentifier;
+@property (nonatomic, assign, readonly) uint64_t scheduled;
+@property (nonatomic, assign, readonly) uint64_t started;
+@property (nonatomic, assign, readonly) uint64_t finished;
+
+@end
+
+@implementation FBFutureTracer_Handler
+
+- (instancetype)initWithIdentifier:(FBFutureTraceIdentifier)identifier queueLabel:(NSString *)queueLabel threadIdentifier:(uint64_t)threadIdentifier scheduled:(uint64_t)scheduled started:(uint64_t)started finished:(uint64_t)finished
+{
+  self = [super init];
+  if (!self) {
+    return nil;
+  }
+
+  _identifier = identifier;
+  _queueLabel = queueLabel;
+  _threadIdentifier = threadIdentifier;
+  _scheduled = scheduled;
+  _started = started;
+  _finished = finished;
+
+  return self;
+}
+
+@end
+
+@interface FBFutureTracer ()
+
+@property (nonatomic, assign, readonly) uint64_t origin;
+@property (nonatomic, assign, readonly) NSUInteger maximumRecordCount;
+@property (nonatomic, strong, readonly) NSMutableDictionary<NSNumber *, FBFutureTracer_Future *> *futures;
+@property (nonatomic, strong, readonly) NSMutableArray<FBFutureTracer_Handler *> *handlers;
+
+@end
+
+@implementation FBFutureTracer
+{
+  FBFutureTraceIdentifier _nextIdentifier;
+  FBFutureTraceIdentifier _oldestIdentifier;
+}
+
+#pragma mark Initializers
+
++ (instancetype)tracer
+{
+  return [self tracerWithMaximumRecordCount:FBFutureTracerDefaultMaximumRecordCount];
+}
+
++ (instancetype)tracerWithMaximumRecordCount:(NSUInteger)maximumRecordCount
+{
+  return [[self alloc] initWithMaximumRecordCount:maximumRecordCount];
+}
+
+- (instancetype)initWithMaximumRecordCount:(NSUInteger)maximumRecordCount
+{
+  self = [super init];
+  if (!self) {
+    return nil;
+  }
+
+  _origin = FBFutureTracer.timestamp;
+  _maximumRecordCount = MAX(maximumRecordCount, 1u);
+  _futures = [NSMutableDictionary dictionary];
+  _handlers = [NSMutableArray array];
+  _nextIdentifier = 0;
+  _oldestIdentifier = 1;
+
+  return self;
+}
+
+#pragma mark Properties
+
++ (FBFutureTracer *)activeTracer
+{
+  if (!__atomic_load_n(&FBFutureTracerIsActive, __ATOMIC_ACQUIRE)) {
+    return nil;
+  }
+  // The tracer is retained before the lock is released, so that it cannot be deallocated by a concurrent start or stop.
+  @synchronized (FBFutureTracer.class) {
+    return FBFutureTracerActive;
+  }
+}
+
+#pragma mark Public Methods
+
+- (void)start
+{
+  @synchronized (FBFutureTracer.class) {
+    FBFutureTracerActive = self;
+    __atomic_store_n(&FBFutureTracerIsActive, YES, __ATOMIC_RELEASE);
+  }
+}
+
+- (void)stop
+{
+  @synchronized (FBFutureTracer.class) {
+    if (FBFutureTracerActive != self) {
+      return;
+    }
+    FBFutureTracerActive = nil;
+    __atomic_store_n(&FBFutureTracerIsActive, NO, __ATOMIC_RELEASE);
+  }
+}
+
+- (NSArray<NSDictionary<NSString *, id> *> *)traceEvents
+{
+  NSNumber *processIdentifier = @(NSProcessInfo.processInfo.processIdentifier);
+  uint64_t now = FBFutureTracer.timestamp;
+  NSMutableArray<NSDictionary<NSString *, id> *> *events = [NSMutableArray array];
+
+  @synchronized (self) {
+    NSArray<NSNumber *> *identifiers = [self.futures.allKeys sortedArrayUsingSelector:@selector(compare:)];
+    for (NSNumber *identifier in identifiers) {
+      FBFutureTracer_Future *future = self.futures[identifier];
+      NSString *name = future.name ?: @"FBFuture";
+      NSString *identifierString = FBFutureTracerIdentifierString(future.identifier);
+      NSMutableArray<NSString *> *parents = [NSMutableArray array];
+      for (NSNumber *parent in future.parents) {
+        [parents addObject:FBFutureTracerIdentifierString(parent.unsignedLongLongValue)];
+      }
+      uint64_t resolved = future.state == FBFutureStateRunning ? now : future.resolved;
+      [events addObject:@{
+        @"name": name,
+        @"cat": @"future",
+        @"ph": @"b",
+        @"id": identifierString,
+        @"pid": processIdentifier,
+        @"tid": @0,
+        @"ts": @([self microsecondsSinceOrigin:future.created]),
+        @"args": @{@"parents": parents},
+      }];
+      [events addObject:@{
+        @"name": name,
+        @"cat": @"future",
+        @"ph": @"e",
+        @"id": identifierString,
+        @"pid": processIdentifier,
+        @"tid": @0,
+        @"ts": @([self microsecondsSinceOrigin:resolved]),
+        @"args": @{@"state": FBFutureTracerStateName(future.state)},
+      }];
+    }
+    for (FBFutureTracer_Handler *handler in self.handlers) {
+      double started = [self microsecondsSinceOrigin:handler.started];
+      [events addObject:@{
+        @"name": handler.queueLabel,
+        @"cat": @"handler",
+        @"ph": @"X",
+        @"pid": processIdentifier,
+        @"tid": @(handler.threadIdentifier),
+        @"ts": @(started),
+        @"dur": @([self microsecondsSinceOrigin:handler.finished] - started),
+        @"args": @{
+          @"future": FBFutureTracerIdentifierString(handler.identifier),
+          @"scheduling_latency_us": @(started - [self microsecondsSinceOrigin:handler.scheduled]),
+        },
+      }];
+    }
+  }
+  return [events copy];
+}
+
+- (NSData *)chromeTraceData:(NSError **)error
+{
+  NSDictionary<NSString *, id> *trace = @{
+    @"traceEvents": self.traceEvents,
+    @"displayTimeUnit": @"ms",
+  };
+  return [NSJSONSerialization dataWithJSONObject:trace options:0 error:error];
+}
+
+- (BOOL)writeChromeTraceToPath:(NSString *)path error:(NSError **)error
+{
+  NSData *data = [self chromeTraceData:error];
+  if (!data) {
+    return NO;
+  }
+  NSError *innerError = nil;
+  if (![data writeToFile:path options:NSDataWritingAtomic error:&innerError]) {
+    return [[[FBControlCoreError
+      describeFormat:@"Failed to write Future trace to %@", path]
+      causedBy:innerError]
+      failBool:error];
+  }
+  return YES;
+}
+
+#pragma mark Recording
+
++ (uint64_t)timestamp
+{
+  return mach_absolute_time();
+}
+
+- (FBFutureTraceIdentifier)recordCreation
+{
+  uint64_t created = FBFutureTracer.timestamp;
+  FBFutureTraceIdentifier identifier = __atomic_add_fetch(&_nextIdentifier, 1, __ATOMIC_RELAXED);
+  FBFutureTracer_Future *future = [[FBFutureTracer_Future alloc] initWithIdentifier:identifier created:created];
+  @synchronized (self) {
+    self.futures[@(identifier)] = future;
+    // Identifiers are allocated in order, so the oldest Futures are dropped first.
+    while (self.futures.count > self.maximumRecordCount && _oldestIdentifier < identifier) {
+      [self.futures removeObjectForKey:@(_oldestIdentifier)];
+      _oldestIdentifier++;
+    }
+  }
+  return identifier;
+}
+
+- (void)recordEdgeFromParent:(FBFutureTraceIdentifier)parent toChild:(FBFutureTraceIdentifier)child
+{
+  @synchronized (self) {
+    [self.futures[@(child)].parents addObject:@(parent)];
+  }
+}
+
+- (void)recordName:(FBFutureTraceIdentifier)identifier name:(NSString *)name
+{
+  @synchronized (self) {
+    self.futures[@(identifier)].name = name;
+  }
+}
+
+- (void)recordResolution:(FBFutureTraceIdentifier)identifier state:(FBFutureState)state
+{
+  uint64_t resolved = FBFutureTracer.timestamp;
+  @synchronized (self) {
+    FBFutureTracer_Future *future = self.futures[@(identifier)];
+    future.resolved = resolved;
+    future.state = state;
+  }
+}
+
+- (void)recordHandler:(FBFutureTraceIdentifier)identifier queue:(dispatch_queue_t)queue scheduled:(uint64_t)scheduled started:(uint64_t)started finished:(uint64_t)finished
+{
+  uint64_t threadIdentifier = 0;
+  pthread_threadid_np(NULL, &threadIdentifier);
+  NSString *queueLabel = [NSString stringWithUTF8String:dispatch_queue_get_label(queue)] ?: @"unlabelled";
+  FBFutureTracer_Handler *handler = [[FBFutureTracer_Handler alloc] initWithIdentifier:identifier queueLabel:queueLabel threadIdentifier:threadIdentifier scheduled:scheduled started:started finished:finished];
+  @synchronized (self) {
+    [self.handlers addObject:handler];
+    if (self.handlers.count > self.maximumRecordCount) {
+      [self.handlers removeObjectAtIndex:0];
+    }
+  }
+}
+
+#pragma mark Private
+
+- (double)microsecondsSinceOrigin:(uint64_t)timestamp
+{
+  static mach_timebase_info_data_t timebase;
+  static dispatch_once_t onceToken;
+  dispatch_once(&onceToken, ^{
+    mach_timebase_info(&timebase);
+  });
+  uint64_t elapsed = timestamp > self.origin ? timestamp - self.origin : 0;
+  return ((double) elapsed * timebase.numer / timebase.denom) / 1000.0;
+}
+
+@end
@@ -20,6 +20,7 @@ NS_ASSUME_NONNULL_BEGIN
 
 /**
  Spins the Run Loop until `untilTrue` returns YES or a timeout is reached.
+ The condition is checked immediately, then with an interval that increases from 1ms to 100ms.
 
  @oaram timeout the Timeout in Seconds.
  @param untilTrue the condition to meet.
@@ -45,6 +46,16 @@ NS_ASSUME_NONNULL_BEGIN
  */
 - (BOOL)spinRunLoopWithTimeout:(NSTimeInterval)timeout notifiedBy:(dispatch_group_t)group onQueue:(dispatch_queue_t)queue;
 
+/**
+ Spins the Run Loop until a signal is called, or a timeout is reached.
+ Rather than waking periodically to check a condition, the Run Loop sleeps until the signal wakes it.
+
+ @param timeout the Timeout in Seconds.
+ @param registration a block that is called once, with the signal to call when the awaited event occurs. The signal may be called from any thread.
+ @return YES if the signal was called before the timeout, NO otherwise.
+ */
+- (BOOL)spinRunLoopWithTimeout:(NSTimeInterval)timeout untilSignalled:(void (^)(dispatch_block_t signal))registration;
+
 @end
 
 /**
@@ -33,16 +33,24 @@ static NSString *const KeyIsAwaiting = @"FBCONTROLCORE_IS_AWAITING";
   threadLocals[KeyIsAwaiting] = @(spinning);
 }
 
+static NSTimeInterval const FBRunLoopSpinMinimumInterval = 0.001;
+static NSTimeInterval const FBRunLoopSpinMaximumInterval = 0.1;
+
 - (BOOL)spinRunLoopWithTimeout:(NSTimeInterval)timeout untilTrue:( BOOL (^)(void) )untilTrue
 {
+  // An arbitrary condition cannot signal the run loop, so it is checked with an increasing interval.
+  // Conditions that become true quickly are noticed quickly, without busy polling for slower ones.
   NSDate *date = [NSDate dateWithTimeIntervalSinceNow:timeout];
+  NSTimeInterval interval = FBRunLoopSpinMinimumInterval;
   while (!untilTrue()) {
     @autoreleasepool {
-      if (timeout > 0 && [date timeIntervalSinceNow] < 0) {
+      NSTimeInterval remaining = [date timeIntervalSinceNow];
+      if (timeout > 0 && remaining < 0) {
         return NO;
       }
-      // Wait for 100ms
-      [self runUntilDate:[NSDate dateWithTimeIntervalSinceNow:0.1]];
+      NSTimeInterval slice = timeout > 0 ? MIN(interval, remaining) : interval;
+      [self runUntilDate:[NSDate dateWithTimeIntervalSinceNow:slice]];
+      interval = MIN(interval * 2, FBRunLoopSpinMaximumInterval);
     }
   }
   return YES;
@@ -63,21 +71,58 @@ static NSString *const KeyIsAwaiting = @"FBCONTROLCORE_IS_AWAITING";
 
 - (BOOL)spinRunLoopWithTimeout:(NSTimeInterval)timeout notifiedBy:(dispatch_group_t)group onQueue:(dispatch_queue_t)queue
 {
-  __block volatile uint32_t didFinish = 0;
-  dispatch_group_notify(group, queue, ^{
-    OSAtomicOr32Barrier(1, &didFinish);
+  return [self spinRunLoopWithTimeout:timeout untilSignalled:^(dispatch_block_t signal) {
+    dispatch_group_notify(group, queue, signal);
+  }];
+}
+
+static void FBRunLoopSignalSourcePerform(void *info)
+{
+  // The source only exists to wake the run loop, the waiter checks for completion itself.
+}
+
+- (BOOL)spinRunLoopWithTimeout:(NSTimeInterval)timeout untilSignalled:(void (^)(dispatch_block_t signal))registration
+{
+  // A custom source is added to the run loop, so that the run loop sleeps until the signal fires, instead of waking to poll.
+  // The source and run loop are retained by the signal, as it may be called after the timeout has elapsed.
+  CFRunLoopSourceContext context = {
+    .version = 0,
+    .perform = FBRunLoopSignalSourcePerform,
+  };
+  id source = CFBridgingRelease(CFRunLoopSourceCreate(kCFAllocatorDefault, 0, &context));
+  id runLoop = (__bridge id) self.getCFRunLoop;
+  CFRunLoopAddSource((__bridge CFRunLoopRef) runLoop, (__bridge CFRunLoopSourceRef) source, kCFRunLoopDefaultMode);
+
+  __block volatile uint32_t signalled = 0;
+  registration(^{
+    OSAtomicOr32Barrier(1, &signalled);
+    CFRunLoopSourceSignal((__bridge CFRunLoopSourceRef) source);
+    CFRunLoopWakeUp((__bridge CFRunLoopRef) runLoop);
   });
 
-  return [self spinRunLoopWithTimeout:timeout untilTrue:^ BOOL {
-    return didFinish == 1;
-  }];
+  NSDate *date = [NSDate dateWithTimeIntervalSinceNow:timeout];
+  while (signalled == 0) {
+    @autoreleasepool {
+      NSTimeInterval remaining = timeout > 0 ? [date timeIntervalSinceNow] : DBL_MAX;
+      if (remaining < 0) {
+        break;
+      }
+      CFRunLoopRunInMode(kCFRunLoopDefaultMode, remaining, true);
+    }
+  }
+
+  CFRunLoopRemoveSource((__bridge CFRunLoopRef) runLoop, (__bridge CFRunLoopSourceRef) source, kCFRunLoopDefaultMode);
+  CFRunLoopSourceInvalidate((__bridge CFRunLoopSourceRef) source);
+  return signalled == 1;
 }
 
 - (nullable id)awaitCompletionOfFuture:(FBFuture *)future timeout:(NSTimeInterval)timeout error:(NSError **)error
 {
   [NSRunLoop updateRunLoopIsAwaiting:YES];
-  BOOL completed = [self spinRunLoopWithTimeout:timeout untilTrue:^BOOL{
-    return future.hasCompleted;
+  BOOL completed = future.hasCompleted || [self spinRunLoopWithTimeout:timeout untilSignalled:^(dispatch_block_t signal) {
+    [future onQueue:dispatch_get_global_queue(QOS_CLASS_USER_INTERACTIVE, 0) notifyOfCompletion:^(FBFuture *_) {
+      signal();
+    }];
   }];
   [NSRunLoop updateRunLoopIsAwaiting:NO];
   if (!completed) {
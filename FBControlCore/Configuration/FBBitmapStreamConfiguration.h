@@ -19,6 +19,7 @@ NS_ASSUME_NONNULL_BEGIN
 typedef NSString *FBBitmapStreamEncoding NS_STRING_ENUM;
 extern FBBitmapStreamEncoding const FBBitmapStreamEncodingH264;
 extern FBBitmapStreamEncoding const FBBitmapStreamEncodingBGRA;
+extern FBBitmapStreamEncoding const FBBitmapStreamEncodingBGRADelta;
 
 /**
  A Configuration Object for a Bitmap Stream
@@ -15,6 +15,7 @@
 
 FBBitmapStreamEncoding const FBBitmapStreamEncodingH264 = @"h264";
 FBBitmapStreamEncoding const FBBitmapStreamEncodingBGRA = @"bgra";
+FBBitmapStreamEncoding const FBBitmapStreamEncodingBGRADelta = @"bgra-delta";
 
 @implementation FBBitmapStreamConfiguration
 
@@ -42,4 +42,10 @@ FBiOSTargetFutureType const FBiOSTargetFutureTypeListApplications = @"list_apps"
     }];
 }
 
+- (BOOL)conflictsWithAction:(id<FBiOSTargetFuture>)action
+{
+  // Listing applications only reads from the target.
+  return NO;
+}
+
 @end
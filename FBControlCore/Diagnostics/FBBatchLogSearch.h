@@ -22,6 +22,7 @@ NS_ASSUME_NONNULL_BEGIN
 extern FBiOSTargetFutureType const FBiOSTargetFutureTypeSearch;
 
 @class FBDiagnostic;
+@class FBDiagnosticTail;
 @class FBLogSearchPredicate;
 
 @protocol FBiOSTarget;
@@ -89,6 +90,16 @@ typedef NS_OPTIONS(NSUInteger, FBBatchLogSearchOptions) {
  */
 - (FBBatchLogSearchResult *)searchDiagnostics:(NSArray<FBDiagnostic *> *)diagnostics;
 
+/**
+ Runs the Reciever over the content of Diagnostics that has not been read by the tail.
+ Repeated searches of growing logs through the same tail only search the content appended since the previous search.
+
+ @param diagnostics an NSArray of FBDiagnostics to search.
+ @param tail the tail to read the diagnostics through.
+ @return a search result
+ */
+- (FBBatchLogSearchResult *)searchUnreadContentOfDiagnostics:(NSArray<FBDiagnostic *> *)diagnostics tail:(FBDiagnosticTail *)tail;
+
 /**
  Runs the Reciever over an iOS Target.
 
@@ -15,6 +15,7 @@
 #import "FBiOSTargetConfiguration.h"
 #import "FBControlCoreError.h"
 #import "FBDiagnostic.h"
+#import "FBDiagnosticTail.h"
 #import "FBEventReporter.h"
 #import "FBLogCommands.h"
 #import "FBLogSearch.h"
@@ -254,52 +255,53 @@ static NSString *const KeySince = @"since";
   // Construct an NSDictionary<FBDiagnosticName, FBDiagnostic> of diagnostics.
   NSDictionary *namesToDiagnostics = [NSDictionary dictionaryWithObjects:diagnostics forKeys:[diagnostics valueForKey:@"shortName"]];
 
-  // Construct and NSArray<FBLogSearch> instances
-  NSMutableArray *searchers = [NSMutableArray array];
-  for (NSString *diagnosticName in self.mapping.allKeys) {
-    NSArray *predicates = self.mapping[diagnosticName];
-
-    if ([diagnosticName isEqualToString:@""]) {
-      for (FBDiagnostic *diagnostic in diagnostics) {
-        for (FBLogSearchPredicate *predicate in predicates) {
-          [searchers addObject:[FBDiagnosticLogSearch withDiagnostic:diagnostic predicate:predicate]];
-        }
+  // Collect the predicates for each diagnostic, so that each diagnostic is only read once.
+  NSMutableArray<NSArray *> *searches = [NSMutableArray array];
+  NSMutableDictionary<NSArray<FBLogSearchPredicate *> *, FBCompiledLogSearch *> *compiled = [NSMutableDictionary dictionary];
+  for (FBDiagnostic *diagnostic in diagnostics) {
+    NSMutableArray<FBLogSearchPredicate *> *predicates = [NSMutableArray array];
+    for (NSString *diagnosticName in self.mapping.allKeys) {
+      if ([diagnosticName isEqualToString:@""] || namesToDiagnostics[diagnosticName] == diagnostic) {
+        [predicates addObjectsFromArray:self.mapping[diagnosticName]];
       }
     }
-    FBDiagnostic *diagnostic = namesToDiagnostics[diagnosticName];
-    if (!diagnostic) {
+    if (predicates.count == 0) {
       continue;
     }
-    for (FBLogSearchPredicate *predicate in predicates) {
-      [searchers addObject:[FBDiagnosticLogSearch withDiagnostic:diagnostic predicate:predicate]];
+    FBCompiledLogSearch *search = compiled[predicates];
+    if (!search) {
+      search = [FBCompiledLogSearch searchWithPredicates:predicates];
+      compiled[[predicates copy]] = search;
     }
+    [searches addObject:@[diagnostic, search]];
   }
 
-  // Perform the search, concurrently
-  FBBatchLogSearchOptions options = self.options;
-  NSArray<NSArray *> *results = [FBConcurrentCollectionOperations
-    mapFilter:[searchers copy]
-    map:^ NSArray * (FBDiagnosticLogSearch *search) {
-      NSArray<NSString *> *matches = [FBBatchLogSearch search:search withOptions:options];
+  // Perform the search concurrently, rebuilding the output dictionary in the order of the diagnostics.
+  BOOL lines = self.options & FBBatchLogSearchOptionsFullLines;
+  BOOL first = self.options & FBBatchLogSearchOptionsFirstMatch;
+  NSMutableDictionary *output = [FBConcurrentCollectionOperations
+    mapReduce:[searches copy]
+    map:^ NSArray * (NSArray *pair) {
+      FBDiagnostic *diagnostic = pair[0];
+      FBCompiledLogSearch *search = pair[1];
+      NSArray<NSString *> *matches = [[search matchesInDiagnostic:diagnostic lines:lines first:first] valueForKeyPath:@"@unionOfArrays.self"];
       if (matches.count == 0) {
        return nil;
       }
-      return @[search.diagnostic.shortName, matches];
+      return @[diagnostic.shortName, matches];
     }
-    predicate:NSPredicate.notNullPredicate];
-
-  // Rebuild the output dictionary
-  NSMutableDictionary *output = [NSMutableDictionary dictionary];
-  for (NSArray *result in results) {
-    NSString *key = result[0];
-    NSArray<NSString *> *values = result[1];
-    NSMutableArray<NSString *> *matches = output[key];
-    if (!matches) {
-      matches = [NSMutableArray array];
-      output[key] = matches;
-    }
-    [matches addObjectsFromArray:values];
-  }
+    initial:[NSMutableDictionary dictionary]
+    reduce:^ NSMutableDictionary * (NSMutableDictionary *accumulator, NSArray *result) {
+      NSString *key = result[0];
+      NSArray<NSString *> *values = result[1];
+      NSMutableArray<NSString *> *matches = accumulator[key];
+      if (!matches) {
+        matches = [NSMutableArray array];
+        accumulator[key] = matches;
+      }
+      [matches addObjectsFromArray:values];
+      return accumulator;
+    }];
 
   // The JSON Inflation will check the format, so is a sanity chek on the data structure.
   FBBatchLogSearchResult *result = [FBBatchLogSearchResult inflateFromJSON:[output copy] error:nil];
@@ -307,6 +309,11 @@ static NSString *const KeySince = @"since";
   return result;
 }
 
+- (FBBatchLogSearchResult *)searchUnreadContentOfDiagnostics:(NSArray<FBDiagnostic *> *)diagnostics tail:(FBDiagnosticTail *)tail
+{
+  return [self searchDiagnostics:[tail unreadContentOfDiagnostics:diagnostics]];
+}
+
 - (FBFuture<FBBatchLogSearchResult *> *)searchOnTarget:(id<FBiOSTarget>)target
 {
   // Only use the specialized logging on iOS.
@@ -367,6 +374,12 @@ static NSString *const KeySince = @"since";
     }];
 }
 
+- (BOOL)conflictsWithAction:(id<FBiOSTargetFuture>)action
+{
+  // Searching logs only reads from the target.
+  return NO;
+}
+
 #pragma mark Private
 
 + (NSDateFormatter *)logCommandDateFormatter
@@ -380,18 +393,6 @@ static NSString *const KeySince = @"since";
   return dateFormatter;
 }
 
-+ (NSArray<NSString *> *)search:(FBDiagnosticLogSearch *)search withOptions:(FBBatchLogSearchOptions)options
-{
-  BOOL lines = options & FBBatchLogSearchOptionsFullLines;
-  BOOL first = options & FBBatchLogSearchOptionsFirstMatch;
-  if (first) {
-    NSString *line = lines ? search.firstMatchingLine : search.firstMatch;
-    return line ? @[line] : @[];
-  } else {
-    return lines ? search.matchingLines : search.allMatches;
-  }
-}
-
 + (NSArray<NSString *> *)argumentsForLogCommand:(NSArray<FBLogSearchPredicate *> *)predicates since:(nullable NSDate *)since error:(NSError **)error
 {
   NSString *compiled = [FBLogSearchPredicate logAgumentsFromPredicates:predicates error:error];
@@ -0,0 +1,72 @@
+/**
+ * Copyright (c) 2015-present, Facebook, Inc.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree. An additional grant
+ * of patent rights can be found in the PATENTS file in the same directory.
+ */
+
+#import <Foundation/Foundation.h>
+
+@class FBCrashLogInfo;
+
+NS_ASSUME_NONNULL_BEGIN
+
+/**
+ An Index of the Crash Logs in directories, keyed by path, modification date and size.
+ A Crash Log is only parsed when it is first seen, or when it has changed since it was indexed.
+ The Index can be persisted to a file, so that the Crash Logs that have been parsed in a previous process are not parsed again.
+ Changes are written before a query returns, so that they are not lost when a short-lived process exits. Directories that no longer exist are pruned.
+ */
+@interface FBCrashLogIndex : NSObject
+
+#pragma mark Initializers
+
+/**
+ An Index that is persisted to the provided path.
+ An existing Index at the path is loaded the first time it is used.
+
+ @param path the path of the file to persist the index to. If nil, the index is not persisted.
+ @return a new Crash Log Index.
+ */
++ (instancetype)indexWithPath:(nullable NSString *)path;
+
+/**
+ The Index shared within the process, persisted in the user's Caches directory.
+ The path can be overridden with the 'FBCONTROLCORE_CRASH_LOG_INDEX_PATH' Environment Variable.
+ */
+@property (nonatomic, class, strong, readonly) FBCrashLogIndex *defaultIndex;
+
+#pragma mark Properties
+
+/**
+ The path that the Index is persisted to, if any.
+ */
+@property (nonatomic, copy, nullable, readonly) NSString *path;
+
+#pragma mark Public Methods
+
+/**
+ Obtains the Crash Logs in a directory, parsing those that have not been indexed.
+ Files that have been removed from the directory are removed from the index.
+ If the index has changed, it is written to its path before returning.
+
+ @param directory the directory to search.
+ @param extension the path extension of the files to consider. If nil, all files are considered.
+ @param date if provided, only files that have been modified on or after this date are considered.
+ @return the Crash Logs for the files that could be parsed.
+ */
+- (NSArray<FBCrashLogInfo *> *)crashLogsInDirectory:(NSString *)directory extension:(nullable NSString *)extension modifiedAfter:(nullable NSDate *)date;
+
+/**
+ Writes the Index to its path, if there are changes that have not been written.
+
+ @param error an error out for any error that occurs.
+ @return YES if successful, NO otherwise.
+ */
+- (BOOL)persist:(NSError **)error;
+
+@end
+
+NS_ASSUME_NONNULL_END
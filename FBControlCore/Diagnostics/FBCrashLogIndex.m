@@ -0,0 +1,327 @@
+/**
+ * Copyright (c) 2015-present, Facebook, Inc.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree. An additional grant
+ * of patent rights can be found in the PATENTS file in the same directory.
+ */
+
+#import "FBCrashLogIndex.h"
+
+#include <limits.h>
+#include <math.h>
+
+#import "FBCollectionInformation.h"
+#import "FBConcurrentCollectionOperations.h"
+#import "FBControlCoreError.h"
+#import "FBControlCoreGlobalConfiguration.h"
+#import "FBControlCoreLogger.h"
+#import "FBCrashLogInfo.h"
+
+static NSString *const KeyVersion = @"version";
+static NSString *const KeyDirectories = @"directories";
+static NSString *const KeyModificationTime = @"mtime";
+static NSString *const KeySize = @"size";
+static NSString *const KeyCrashLog = @"crash_log";
+
+static NSInteger const FBCrashLogIndexVersion = 1;
+
+/**
+ Modification times are stored as integral microseconds, so that they compare exactly after being persisted.
+ */
+static long long FBCrashLogIndexTime(NSDate *date)
+{
+  return date ? llround(date.timeIntervalSince1970 * 1e6) : LLONG_MIN;
+}
+
+/**
+ An indexed file. Files that could not be parsed have no Crash Log, so that they are not parsed again.
+ */
+@interface FBCrashLogIndexEntry : NSObject
+
+@property (nonatomic, assign, readonly) long long modificationTime;
+@property (nonatomic, assign, readonly) unsigned long long size;
+@property (nonatomic, strong, nullable, readwrite) FBCrashLogInfo *crashLog;
+
+@end
+
+@implementation FBCrashLogIndexEntry
+
+- (instancetype)initWithModificationTime:(long long)modificationTime size:(unsigned long long)size crashLog:(nullable FBCrashLogInfo *)crashLog
+{
+  self = [super init];
+  if (!self) {
+    return nil;
+  }
+
+  _modificationTime = modificationTime;
+  _size = size;
+  _crashLog = crashLog;
+
+  return self;
+}
+
+@end
+
+@interface FBCrashLogIndex ()
+
+@property (nonatomic, strong, readonly) NSMutableDictionary<NSString *, NSMutableDictionary<NSString *, FBCrashLogIndexEntry *> *> *directories;
+@property (nonatomic, assign, readwrite) BOOL loaded;
+@property (nonatomic, assign, readwrite) BOOL dirty;
+@property (nonatomic, strong, readonly) NSObject *writeLock;
+
+@end
+
+@implementation FBCrashLogIndex
+
+#pragma mark Initializers
+
++ (instancetype)indexWithPath:(nullable NSString *)path
+{
+  return [[self alloc] initWithPath:path];
+}
+
++ (FBCrashLogIndex *)defaultIndex
+{
+  static dispatch_once_t onceToken;
+  static FBCrashLogIndex *index;
+  dispatch_once(&onceToken, ^{
+    index = [self indexWithPath:FBControlCoreGlobalConfiguration.crashLogIndexPath];
+  });
+  return index;
+}
+
+- (instancetype)initWithPath:(nullable NSString *)path
+{
+  self = [super init];
+  if (!self) {
+    return nil;
+  }
+
+  _path = path;
+  _directories = [NSMutableDictionary dictionary];
+  _writeLock = [NSObject new];
+
+  return self;
+}
+
+#pragma mark Public Methods
+
+- (NSArray<FBCrashLogInfo *> *)crashLogsInDirectory:(NSString *)directory extension:(nullable NSString *)extension modifiedAfter:(nullable NSDate *)date
+{
+  NSArray<FBCrashLogInfo *> *crashLogs = [self indexedCrashLogsInDirectory:directory extension:extension modifiedAfter:date];
+  // The Index is written before returning, so that it is not lost if the process exits shortly after.
+  // Concurrent queries are coalesced, as a query that finds the Index has been written by another does not write it again.
+  NSError *error = nil;
+  if (![self persist:&error]) {
+    [FBControlCoreGlobalConfiguration.defaultLogger.debug logFormat:@"Failed to persist the Crash Log Index: %@", error];
+  }
+  return crashLogs;
+}
+
+- (BOOL)persist:(NSError **)error
+{
+  // Writes are serialized so that an older snapshot never replaces a newer one, without holding the Index lock whilst writing.
+  @synchronized (self.writeLock) {
+    NSDictionary<NSString *, NSDictionary<NSString *, FBCrashLogIndexEntry *> *> *snapshot = nil;
+    @synchronized (self) {
+      if (!self.path || !self.dirty) {
+        return YES;
+      }
+      [self pruneRemovedDirectories];
+      NSMutableDictionary<NSString *, NSDictionary<NSString *, FBCrashLogIndexEntry *> *> *copied = [NSMutableDictionary dictionaryWithCapacity:self.directories.count];
+      for (NSString *directory in self.directories) {
+        copied[directory] = [self.directories[directory] copy];
+      }
+      snapshot = [copied copy];
+      self.dirty = NO;
+    }
+    if ([self writeSnapshot:snapshot error:error]) {
+      return YES;
+    }
+    @synchronized (self) {
+      self.dirty = YES;
+    }
+    return NO;
+  }
+}
+
+#pragma mark Private
+
+- (NSArray<FBCrashLogInfo *> *)indexedCrashLogsInDirectory:(NSString *)directory extension:(nullable NSString *)extension modifiedAfter:(nullable NSDate *)date
+{
+  @synchronized (self) {
+    [self loadIfNeeded];
+
+    NSMutableDictionary<NSString *, FBCrashLogIndexEntry *> *previous = self.directories[directory];
+    NSMutableDictionary<NSString *, FBCrashLogIndexEntry *> *current = [self
+      updateEntries:previous
+      directory:directory
+      extension:extension
+      date:date];
+    if (!previous || ![previous isEqualToDictionary:current]) {
+      self.dirty = YES;
+    }
+    self.directories[directory] = current;
+
+    long long since = FBCrashLogIndexTime(date);
+    NSMutableArray<FBCrashLogInfo *> *crashLogs = [NSMutableArray array];
+    for (NSString *name in current) {
+      FBCrashLogIndexEntry *entry = current[name];
+      if (!entry.crashLog || entry.modificationTime < since) {
+        continue;
+      }
+      if (extension && ![name.pathExtension isEqualToString:extension]) {
+        continue;
+      }
+      [crashLogs addObject:entry.crashLog];
+    }
+    return [crashLogs copy];
+  }
+}
+
+- (void)pruneRemovedDirectories
+{
+  // Directories that no longer exist, such as those of temporary stores, are not retained.
+  for (NSString *directory in self.directories.allKeys) {
+    BOOL isDirectory = NO;
+    if (![NSFileManager.defaultManager fileExistsAtPath:directory isDirectory:&isDirectory] || !isDirectory) {
+      [self.directories removeObjectForKey:directory];
+      self.dirty = YES;
+    }
+  }
+}
+
+- (BOOL)writeSnapshot:(NSDictionary<NSString *, NSDictionary<NSString *, FBCrashLogIndexEntry *> *> *)snapshot error:(NSError **)error
+{
+  NSMutableDictionary<NSString *, id> *directories = [NSMutableDictionary dictionaryWithCapacity:snapshot.count];
+  for (NSString *directory in snapshot) {
+    NSDictionary<NSString *, FBCrashLogIndexEntry *> *entries = snapshot[directory];
+    NSMutableDictionary<NSString *, id> *serialized = [NSMutableDictionary dictionaryWithCapacity:entries.count];
+    for (NSString *name in entries) {
+      FBCrashLogIndexEntry *entry = entries[name];
+      NSMutableDictionary<NSString *, id> *json = [NSMutableDictionary dictionaryWithDictionary:@{
+        KeyModificationTime: @(entry.modificationTime),
+        KeySize: @(entry.size),
+      }];
+      json[KeyCrashLog] = entry.crashLog.jsonSerializableRepresentation;
+      serialized[name] = json;
+    }
+    directories[directory] = serialized;
+  }
+
+  NSError *innerError = nil;
+  NSData *data = [NSJSONSerialization dataWithJSONObject:@{KeyVersion: @(FBCrashLogIndexVersion), KeyDirectories: directories} options:0 error:&innerError];
+  if (!data) {
+    return [[[FBControlCoreError
+      describe:@"Could not serialize the Crash Log Index"]
+      causedBy:innerError]
+      failBool:error];
+  }
+  if (![NSFileManager.defaultManager createDirectoryAtPath:self.path.stringByDeletingLastPathComponent withIntermediateDirectories:YES attributes:nil error:&innerError]) {
+    return [[[FBControlCoreError
+      describeFormat:@"Could not create the directory for the Crash Log Index at %@", self.path]
+      causedBy:innerError]
+      failBool:error];
+  }
+  if (![data writeToFile:self.path options:NSDataWritingAtomic error:&innerError]) {
+    return [[[FBControlCoreError
+      describeFormat:@"Could not write the Crash Log Index to %@", self.path]
+      causedBy:innerError]
+      failBool:error];
+  }
+  return YES;
+}
+
+- (NSMutableDictionary<NSString *, FBCrashLogIndexEntry *> *)updateEntries:(nullable NSDictionary<NSString *, FBCrashLogIndexEntry *> *)previous directory:(NSString *)directory extension:(nullable NSString *)extension date:(nullable NSDate *)date
+{
+  // The modification date and size are fetched in bulk with the directory listing.
+  NSArray<NSURLResourceKey> *keys = @[NSURLContentModificationDateKey, NSURLFileSizeKey, NSURLIsRegularFileKey];
+  NSArray<NSURL *> *contents = [NSFileManager.defaultManager contentsOfDirectoryAtURL:[NSURL fileURLWithPath:directory] includingPropertiesForKeys:keys options:0 error:nil];
+  long long since = FBCrashLogIndexTime(date);
+
+  NSMutableDictionary<NSString *, FBCrashLogIndexEntry *> *current = [NSMutableDictionary dictionaryWithCapacity:contents.count];
+  NSMutableArray<NSString *> *unparsedPaths = [NSMutableArray array];
+  NSMutableArray<FBCrashLogIndexEntry *> *unparsedEntries = [NSMutableArray array];
+  for (NSURL *url in contents) {
+    NSDictionary<NSURLResourceKey, id> *values = [url resourceValuesForKeys:keys error:nil];
+    if (![values[NSURLIsRegularFileKey] boolValue]) {
+      continue;
+    }
+    NSString *name = url.lastPathComponent;
+    long long modificationTime = FBCrashLogIndexTime(values[NSURLContentModificationDateKey]);
+    unsigned long long size = [values[NSURLFileSizeKey] unsignedLongLongValue];
+
+    FBCrashLogIndexEntry *entry = previous[name];
+    if (entry && entry.modificationTime == modificationTime && entry.size == size) {
+      current[name] = entry;
+      continue;
+    }
+    // Files that are not being queried for are not parsed, they will be indexed when they are.
+    if ((extension && ![name.pathExtension isEqualToString:extension]) || modificationTime < since) {
+      continue;
+    }
+    entry = [[FBCrashLogIndexEntry alloc] initWithModificationTime:modificationTime size:size crashLog:nil];
+    current[name] = entry;
+    [unparsedPaths addObject:[directory stringByAppendingPathComponent:name]];
+    [unparsedEntries addObject:entry];
+  }
+
+  NSArray *parsed = [FBConcurrentCollectionOperations map:unparsedPaths withBlock:^ id (NSString *path) {
+    return [FBCrashLogInfo fromCrashLogAtPath:path];
+  }];
+  for (NSUInteger index = 0; index < parsed.count; index++) {
+    FBCrashLogInfo *crashLog = parsed[index];
+    unparsedEntries[index].crashLog = [crashLog isKindOfClass:FBCrashLogInfo.class] ? crashLog : nil;
+  }
+  return current;
+}
+
+- (void)loadIfNeeded
+{
+  if (self.loaded) {
+    return;
+  }
+  self.loaded = YES;
+  if (!self.path) {
+    return;
+  }
+  NSData *data = [NSData dataWithContentsOfFile:self.path];
+  if (!data) {
+    return;
+  }
+  // An index that cannot be read is discarded and rebuilt.
+  NSDictionary<NSString *, id> *json = [NSJSONSerialization JSONObjectWithData:data options:0 error:nil];
+  if (![json isKindOfClass:NSDictionary.class] || ![json[KeyVersion] isEqual:@(FBCrashLogIndexVersion)]) {
+    return;
+  }
+  NSDictionary<NSString *, NSDictionary<NSString *, NSDictionary<NSString *, id> *> *> *directories = json[KeyDirectories];
+  if (![FBCollectionInformation isDictionaryHeterogeneous:directories keyClass:NSString.class valueClass:NSDictionary.class]) {
+    return;
+  }
+  for (NSString *directory in directories) {
+    NSMutableDictionary<NSString *, FBCrashLogIndexEntry *> *entries = [NSMutableDictionary dictionary];
+    for (NSString *name in directories[directory]) {
+      NSDictionary<NSString *, id> *entry = directories[directory][name];
+      if (![entry isKindOfClass:NSDictionary.class] || ![entry[KeyModificationTime] isKindOfClass:NSNumber.class] || ![entry[KeySize] isKindOfClass:NSNumber.class]) {
+        continue;
+      }
+      FBCrashLogInfo *crashLog = nil;
+      if (entry[KeyCrashLog]) {
+        crashLog = [FBCrashLogInfo inflateFromJSON:entry[KeyCrashLog] error:nil];
+        if (!crashLog) {
+          continue;
+        }
+      }
+      entries[name] = [[FBCrashLogIndexEntry alloc]
+        initWithModificationTime:[entry[KeyModificationTime] longLongValue]
+        size:[entry[KeySize] unsignedLongLongValue]
+        crashLog:crashLog];
+    }
+    self.directories[directory] = entries;
+  }
+  [self pruneRemovedDirectories];
+}
+
+@end
@@ -9,6 +9,8 @@
 
 #import <Foundation/Foundation.h>
 
+#import <FBControlCore/FBJSONConversion.h>
+
 @class FBDiagnostic;
 @class FBDiagnosticBuilder;
 
@@ -26,7 +28,7 @@ typedef NS_OPTIONS(NSUInteger, FBCrashLogInfoProcessType) {
 /**
  Information about Crash Logs.
  */
-@interface FBCrashLogInfo : NSObject <NSCopying>
+@interface FBCrashLogInfo : NSObject <NSCopying, FBJSONSerializable, FBJSONDeserializable>
 
 #pragma mark Properties
 
@@ -9,12 +9,22 @@
 
 #import "FBCrashLogInfo.h"
 
-#import <stdio.h>
-
+#include <fcntl.h>
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#import "FBCollectionInformation.h"
+#import "FBControlCoreError.h"
 #import "FBControlCoreGlobalConfiguration.h"
 #import "FBDiagnostic.h"
-#import "FBConcurrentCollectionOperations.h"
-#import "NSPredicate+FBControlCore.h"
+#import "FBCrashLogIndex.h"
+
+/**
+ The header block is at the start of the file, this is enough to contain it.
+ */
+static size_t const FBCrashLogInfoHeaderLength = 16384;
 
 @implementation FBCrashLogInfo
 
@@ -25,8 +35,15 @@
   if (!crashPath) {
     return nil;
   }
-  FILE *file = fopen(crashPath.UTF8String, "r");
-  if (!file) {
+  int fileDescriptor = open(crashPath.UTF8String, O_RDONLY);
+  if (fileDescriptor == -1) {
+    return nil;
+  }
+  // Only the header block is read, the rest of the file is never touched.
+  char header[FBCrashLogInfoHeaderLength];
+  ssize_t length = read(fileDescriptor, header, sizeof(header));
+  close(fileDescriptor);
+  if (length <= 0) {
     return nil;
   }
 
@@ -38,14 +55,10 @@
   pid_t processIdentifier = -1;
   pid_t parentProcessIdentifier = -1;
 
-  if (![self extractFromFile:file executablePathOut:&executablePath identifierOut:&identifier processNameOut:&processName parentProcessNameOut:&parentProcessName processIdentifierOut:&processIdentifier parentProcessIdentifierOut:&parentProcessIdentifier dateOut:&date]) {
-    fclose(file);
+  if (![self extractFromHeader:header length:(size_t) length executablePathOut:&executablePath identifierOut:&identifier processNameOut:&processName parentProcessNameOut:&parentProcessName processIdentifierOut:&processIdentifier parentProcessIdentifierOut:&parentProcessIdentifier dateOut:&date]) {
     return nil;
   }
 
-  FBCrashLogInfoProcessType processType = [self processTypeForExecutablePath:executablePath];
-  fclose(file);
-
   return [[FBCrashLogInfo alloc]
     initWithCrashPath:crashPath
     executablePath:executablePath
@@ -55,7 +68,7 @@
     parentProcessName:parentProcessName
     parentProcessIdentifier:parentProcessIdentifier
     date:date
-    processType:processType];
+    processType:[self processTypeForExecutablePath:executablePath]];
 }
 
 - (instancetype)initWithCrashPath:(NSString *)crashPath executablePath:(NSString *)executablePath identifier:(NSString *)identifier processName:(NSString *)processName processIdentifier:(pid_t)processIdentifer parentProcessName:(NSString *)parentProcessName parentProcessIdentifier:(pid_t)parentProcessIdentifier date:(NSDate *)date processType:(FBCrashLogInfoProcessType)processType
@@ -90,21 +103,7 @@
 
 + (BOOL)isParsableCrashLog:(NSData *)data
 {
-#if defined(__apple_build_version__)
-  if (@available(macOS 10.13, *)) {
-    FILE *file = fmemopen((void *)data.bytes, data.length, "r");
-    if (!file) {
-      return NO;
-    }
-    BOOL parsable = [self extractFromFile:file executablePathOut:nil identifierOut:nil processNameOut:nil parentProcessNameOut:nil processIdentifierOut:nil parentProcessIdentifierOut:nil dateOut:nil];
-    fclose(file);
-    return parsable;
-  } else {
-    return NO;
-  }
-#else
-  return NO;
-#endif
+  return [self extractFromHeader:data.bytes length:MIN(data.length, FBCrashLogInfoHeaderLength) executablePathOut:nil identifierOut:nil processNameOut:nil parentProcessNameOut:nil processIdentifierOut:nil parentProcessIdentifierOut:nil dateOut:nil];
 }
 
 #pragma mark NSObject
@@ -132,6 +131,65 @@
   return self;
 }
 
+#pragma mark JSON
+
+static NSString *const KeyCrashPath = @"crash_path";
+static NSString *const KeyExecutablePath = @"executable_path";
+static NSString *const KeyIdentifier = @"identifier";
+static NSString *const KeyProcessName = @"process_name";
+static NSString *const KeyProcessIdentifier = @"pid";
+static NSString *const KeyParentProcessName = @"parent_process_name";
+static NSString *const KeyParentProcessIdentifier = @"ppid";
+static NSString *const KeyDate = @"date";
+
++ (nullable instancetype)inflateFromJSON:(NSDictionary<NSString *, id> *)json error:(NSError **)error
+{
+  if (![FBCollectionInformation isDictionaryHeterogeneous:json keyClass:NSString.class valueClass:NSObject.class]) {
+    return [[FBControlCoreError
+      describeFormat:@"%@ is not a Dictionary<String, Any>", json]
+      fail:error];
+  }
+  for (NSString *key in @[KeyCrashPath, KeyExecutablePath, KeyIdentifier, KeyProcessName, KeyParentProcessName]) {
+    if (![json[key] isKindOfClass:NSString.class]) {
+      return [[FBControlCoreError
+        describeFormat:@"%@ is not a String for %@", json[key], key]
+        fail:error];
+    }
+  }
+  for (NSString *key in @[KeyProcessIdentifier, KeyParentProcessIdentifier, KeyDate]) {
+    if (![json[key] isKindOfClass:NSNumber.class]) {
+      return [[FBControlCoreError
+        describeFormat:@"%@ is not a Number for %@", json[key], key]
+        fail:error];
+    }
+  }
+  NSString *executablePath = json[KeyExecutablePath];
+  return [[FBCrashLogInfo alloc]
+    initWithCrashPath:json[KeyCrashPath]
+    executablePath:executablePath
+    identifier:json[KeyIdentifier]
+    processName:json[KeyProcessName]
+    processIdentifier:[json[KeyProcessIdentifier] intValue]
+    parentProcessName:json[KeyParentProcessName]
+    parentProcessIdentifier:[json[KeyParentProcessIdentifier] intValue]
+    date:[NSDate dateWithTimeIntervalSince1970:[json[KeyDate] doubleValue]]
+    processType:[self processTypeForExecutablePath:executablePath]];
+}
+
+- (id)jsonSerializableRepresentation
+{
+  return @{
+    KeyCrashPath: self.crashPath,
+    KeyExecutablePath: self.executablePath,
+    KeyIdentifier: self.identifier,
+    KeyProcessName: self.processName,
+    KeyProcessIdentifier: @(self.processIdentifier),
+    KeyParentProcessName: self.parentProcessName,
+    KeyParentProcessIdentifier: @(self.parentProcessIdentifier),
+    KeyDate: @(self.date.timeIntervalSince1970),
+  };
+}
+
 #pragma mark Properties
 
 - (NSString *)name
@@ -145,16 +203,9 @@
 {
   NSMutableArray<FBCrashLogInfo *> *allCrashInfos = NSMutableArray.new;
 
+  // The index only parses the crash logs that have appeared or changed since the last query.
   for (NSString *basePath in self.diagnosticReportsPaths) {
-    NSArray<FBCrashLogInfo *> *crashInfos = [[FBConcurrentCollectionOperations
-      filterMap:[NSFileManager.defaultManager contentsOfDirectoryAtPath:basePath error:nil]
-      predicate:[FBCrashLogInfo predicateForFilesWithBasePath:basePath afterDate:date withExtension:@"crash"]
-      map:^ FBCrashLogInfo * (NSString *fileName) {
-        NSString *path = [basePath stringByAppendingPathComponent:fileName];
-        return [FBCrashLogInfo fromCrashLogAtPath:path];
-      }]
-      filteredArrayUsingPredicate:NSPredicate.notNullPredicate];
-
+    NSArray<FBCrashLogInfo *> *crashInfos = [FBCrashLogIndex.defaultIndex crashLogsInDirectory:basePath extension:@"crash" modifiedAfter:date];
     [allCrashInfos addObjectsFromArray:crashInfos];
   }
 
@@ -217,13 +268,74 @@
 
 static NSUInteger MaxLineSearch = 20;
 
-+ (BOOL)extractFromFile:(FILE *)file executablePathOut:(NSString **)executablePathOut identifierOut:(NSString **)identifierOut processNameOut:(NSString **)processNameOut parentProcessNameOut:(NSString **)parentProcessNameOut processIdentifierOut:(pid_t *)processIdentifierOut parentProcessIdentifierOut:(pid_t *)parentProcessIdentifierOut dateOut:(NSDate **)dateOut
+static NSString *FBCrashLogInfoString(const char *bytes, size_t length)
 {
-  // Buffers for the sscanf
-  size_t lineSize = sizeof(char) * 4098;
-  char *line = malloc(lineSize);
-  char value[lineSize];
+  return [[NSString alloc] initWithBytes:bytes length:length encoding:NSUTF8StringEncoding];
+}
 
+static BOOL FBCrashLogInfoKeyEquals(const char *key, size_t keyLength, const char *expected)
+{
+  return keyLength == strlen(expected) && memcmp(key, expected, keyLength) == 0;
+}
+
+static BOOL FBCrashLogInfoParseProcess(const char *value, size_t length, NSString **nameOut, pid_t *processIdentifierOut)
+{
+  // In the form of 'name [pid]', where the name may contain spaces.
+  const char *open = NULL;
+  for (size_t index = length; index > 0; index--) {
+    if (value[index - 1] == '[') {
+      open = value + index - 1;
+      break;
+    }
+  }
+  if (!open) {
+    return NO;
+  }
+  size_t nameLength = (size_t) (open - value);
+  while (nameLength > 0 && value[nameLength - 1] == ' ') {
+    nameLength--;
+  }
+  pid_t processIdentifier = 0;
+  const char *position = open + 1;
+  const char *end = value + length;
+  if (position >= end || *position < '0' || *position > '9') {
+    return NO;
+  }
+  while (position < end && *position >= '0' && *position <= '9') {
+    processIdentifier = processIdentifier * 10 + (*position - '0');
+    position++;
+  }
+  *nameOut = FBCrashLogInfoString(value, nameLength);
+  *processIdentifierOut = processIdentifier;
+  return *nameOut != nil;
+}
+
++ (nullable NSDate *)dateFromBytes:(const char *)value length:(size_t)length
+{
+  // The format is fixed, so it is scanned directly rather than with a Date Formatter.
+  char string[64] = {0};
+  memcpy(string, value, MIN(length, sizeof(string) - 1));
+  struct tm time = {0};
+  int milliseconds = 0;
+  char sign = '+';
+  int offsetHours = 0;
+  int offsetMinutes = 0;
+  int matched = sscanf(string, "%4d-%2d-%2d %2d:%2d:%2d.%3d %c%2d%2d", &time.tm_year, &time.tm_mon, &time.tm_mday, &time.tm_hour, &time.tm_min, &time.tm_sec, &milliseconds, &sign, &offsetHours, &offsetMinutes);
+  if (matched != 10 || (sign != '+' && sign != '-')) {
+    return [self.dateFormatter dateFromString:FBCrashLogInfoString(value, length)];
+  }
+  time.tm_year -= 1900;
+  time.tm_mon -= 1;
+  time_t seconds = timegm(&time);
+  if (seconds == -1) {
+    return nil;
+  }
+  long offset = (offsetHours * 3600 + offsetMinutes * 60) * (sign == '-' ? -1 : 1);
+  return [NSDate dateWithTimeIntervalSince1970:(NSTimeInterval) (seconds - offset) + milliseconds / 1000.0];
+}
+
++ (BOOL)extractFromHeader:(const char *)header length:(size_t)length executablePathOut:(NSString **)executablePathOut identifierOut:(NSString **)identifierOut processNameOut:(NSString **)processNameOut parentProcessNameOut:(NSString **)parentProcessNameOut processIdentifierOut:(pid_t *)processIdentifierOut parentProcessIdentifierOut:(pid_t *)parentProcessIdentifierOut dateOut:(NSDate **)dateOut
+{
   // Values that should exist after scanning
   NSDate *date = nil;
   NSString *executablePath = nil;
@@ -233,32 +345,51 @@ static NSUInteger MaxLineSearch = 20;
   pid_t processIdentifier = -1;
   pid_t parentProcessIdentifier = -1;
 
+  // Each line is tokenized once into 'Key: Value', stopping as soon as all of the values have been found.
+  const char *position = header;
+  const char *end = header + length;
   NSUInteger lineNumber = 0;
-  while (lineNumber++ < MaxLineSearch && getline(&line, &lineSize, file) > 0) {
-    if (sscanf(line, "Process: %s [%d]", value, &processIdentifier) > 0) {
-      processName = [[NSString alloc] initWithCString:value encoding:NSUTF8StringEncoding];
+  while (position < end && lineNumber++ < MaxLineSearch) {
+    const char *lineEnd = memchr(position, '\n', (size_t) (end - position)) ?: end;
+    const char *line = position;
+    position = lineEnd + 1;
+
+    const char *separator = memchr(line, ':', (size_t) (lineEnd - line));
+    if (!separator) {
       continue;
     }
-    if (sscanf(line, "Identifier: %s", value) > 0) {
-      identifier = [[NSString alloc] initWithCString:value encoding:NSUTF8StringEncoding];
-      continue;
+    size_t keyLength = (size_t) (separator - line);
+    const char *value = separator + 1;
+    while (value < lineEnd && (*value == ' ' || *value == '\t')) {
+      value++;
     }
-    if (sscanf(line, "Parent Process: %s [%d]", value, &parentProcessIdentifier) > 0) {
-      parentProcessName = [[NSString alloc] initWithCString:value encoding:NSUTF8StringEncoding];
-      continue;
+    const char *valueEnd = lineEnd;
+    while (valueEnd > value && (valueEnd[-1] == ' ' || valueEnd[-1] == '\r' || valueEnd[-1] == '\t')) {
+      valueEnd--;
     }
-    if (sscanf(line, "Path: %s", value) > 0) {
-      executablePath = [[NSString alloc] initWithCString:value encoding:NSUTF8StringEncoding];
+    size_t valueLength = (size_t) (valueEnd - value);
+    if (valueLength == 0) {
       continue;
     }
-    if (sscanf(line, "Date/Time: %[^\n]", value) > 0) {
-      NSString *dateString = [[NSString alloc] initWithCString:value encoding:NSUTF8StringEncoding];
-      date = [self.dateFormatter dateFromString:dateString];
+
+    if (!processName && FBCrashLogInfoKeyEquals(line, keyLength, "Process")) {
+      FBCrashLogInfoParseProcess(value, valueLength, &processName, &processIdentifier);
+    } else if (!identifier && FBCrashLogInfoKeyEquals(line, keyLength, "Identifier")) {
+      identifier = FBCrashLogInfoString(value, valueLength);
+    } else if (!parentProcessName && FBCrashLogInfoKeyEquals(line, keyLength, "Parent Process")) {
+      FBCrashLogInfoParseProcess(value, valueLength, &parentProcessName, &parentProcessIdentifier);
+    } else if (!executablePath && FBCrashLogInfoKeyEquals(line, keyLength, "Path")) {
+      executablePath = FBCrashLogInfoString(value, valueLength);
+    } else if (!date && FBCrashLogInfoKeyEquals(line, keyLength, "Date/Time")) {
+      date = [self dateFromBytes:value length:valueLength];
+    } else {
       continue;
     }
+    if (processName && identifier && parentProcessName && executablePath && date) {
+      break;
+    }
   }
 
-  free(line);
   if (processName == nil || identifier == nil || parentProcessName == nil || executablePath == nil || processIdentifier == -1 || parentProcessIdentifier == -1 || date == nil) {
     return NO;
   }
@@ -297,23 +428,6 @@ static NSUInteger MaxLineSearch = 20;
   return FBCrashLogInfoProcessTypeCustomAgent;
 }
 
-+ (NSPredicate *)predicateForFilesWithBasePath:(NSString *)basePath afterDate:(NSDate *)date withExtension:(NSString *)extension
-{
-  NSFileManager *fileManager = NSFileManager.defaultManager;
-  NSPredicate *datePredicate = [NSPredicate predicateWithValue:YES];
-  if (date) {
-    datePredicate = [NSPredicate predicateWithBlock:^ BOOL (NSString *fileName, NSDictionary *_) {
-      NSString *path = [basePath stringByAppendingPathComponent:fileName];
-      NSDictionary *attributes = [fileManager attributesOfItemAtPath:path error:nil];
-      return [attributes.fileModificationDate compare:date] != NSOrderedAscending;
-    }];
-  }
-  return [NSCompoundPredicate andPredicateWithSubpredicates:@[
-    [NSPredicate predicateWithFormat:@"pathExtension == %@", extension],
-    datePredicate
-  ]];
-}
-
 + (NSDateFormatter *)dateFormatter
 {
   static dispatch_once_t onceToken;
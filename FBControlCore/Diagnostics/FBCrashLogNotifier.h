@@ -9,18 +9,33 @@
 
 #import <Foundation/Foundation.h>
 
+#import <FBControlCore/FBDirectoryWatcher.h>
 #import <FBControlCore/FBFuture.h>
 
 NS_ASSUME_NONNULL_BEGIN
 
 @class FBCrashLogInfo;
 @class FBCrashLogStore;
+@protocol FBControlCoreLogger;
 
 /**
  An interface for being notified of crash logs for a given process identifier.
  */
 @interface FBCrashLogNotifier : NSObject
 
+#pragma mark Initializers
+
+/**
+ Creates a Notifier that ingests the crash logs written to the provided directories.
+
+ @param directories the directories to observe for crash logs.
+ @param backend the mechanism used to observe the directories.
+ @param logger the logger to use.
+ @param error an error out for when the backend is not available on this host.
+ @return a new Crash Log Notifier, or nil if the backend is not available.
+ */
++ (nullable instancetype)notifierForDirectories:(NSArray<NSString *> *)directories backend:(FBDirectoryWatcherBackend)backend logger:(id<FBControlCoreLogger>)logger error:(NSError **)error;
+
 #pragma mark Properties
 
 /**
@@ -51,6 +66,15 @@ NS_ASSUME_NONNULL_BEGIN
  */
 - (FBFuture<FBCrashLogInfo *> *)nextCrashLogForPredicate:(NSPredicate *)predicate;
 
+/**
+ Obtains a crash log that has already been ingested for a given predicate, otherwise the next one.
+ This does not wait when the crash log has been written before this is called.
+
+ @param predicate the predicate to wait for.
+ @return a Future that resolves with a crash log matching the predicate.
+ */
+- (FBFuture<FBCrashLogInfo *> *)crashLogForPredicate:(NSPredicate *)predicate;
+
 @end
 
 NS_ASSUME_NONNULL_END
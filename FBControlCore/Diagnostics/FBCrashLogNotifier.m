@@ -13,151 +13,54 @@
 #import "FBCrashLogStore.h"
 #import "FBControlCoreGlobalConfiguration.h"
 #import "FBControlCoreLogger.h"
-#import "FBControlCoreError.h"
 
-#if defined(__apple_build_version__)
-
-#import <CoreServices/CoreServices.h>
-#include <sys/stat.h>
-
-@interface FBCrashLogNotifier_FSEvents : NSObject
+@interface FBCrashLogNotifier ()
 
-@property (nonatomic, copy, readonly) NSArray<NSString *> *directories;
-@property (nonatomic, strong, readonly) FBCrashLogStore *store;
-@property (nonatomic, strong, readonly) id<FBControlCoreLogger> logger;
+@property (nonatomic, strong, readwrite) FBDirectoryWatcher *watcher;
 @property (nonatomic, strong, readonly) dispatch_queue_t queue;
-@property (nonatomic, assign, readwrite) FSEventStreamRef eventStream;
+@property (nonatomic, copy, readonly) FBDirectoryWatcherHandler handler;
+@property (nonatomic, strong, readonly) id<FBControlCoreLogger> logger;
 
 @end
 
-typedef NS_ENUM(NSUInteger, FBCrashLogNotifierFileEvent) {
-  FBCrashLogNotifierFileEventUnknown = 0,
-  FBCrashLogNotifierFileEventAdded = 1,
-  FBCrashLogNotifierFileEventRemoved = 2,
-};
-
-static FBCrashLogNotifierFileEvent GetEventType(FSEventStreamEventFlags flag, NSString *filePath) {
-  if (flag & kFSEventStreamEventFlagItemRemoved) {
-    return FBCrashLogNotifierFileEventRemoved;
-  } else if (flag & kFSEventStreamEventFlagItemCreated) {
-    return FBCrashLogNotifierFileEventAdded;
-  } else if (flag & kFSEventStreamEventFlagItemRenamed) {
-    struct stat buffer;
-    int value = stat(filePath.UTF8String, &buffer);
-    return value == 0 ? FBCrashLogNotifierFileEventAdded : FBCrashLogNotifierFileEventRemoved;
-  }
-  return FBCrashLogNotifierFileEventUnknown;
-}
-
-static void EventStreamCallback(
-  ConstFSEventStreamRef streamRef,
-  FBCrashLogNotifier_FSEvents *notifier,
-  size_t numEvents,
-  NSArray<NSString *> *eventPaths,
-  const FSEventStreamEventFlags *eventFlags,
-  const FSEventStreamEventId *eventIds
-){
-  for (size_t index = 0; index < numEvents; index++) {
-    NSString *path = eventPaths[index];
-    FSEventStreamEventFlags flag = eventFlags[index];
-    switch (GetEventType(flag, path)) {
-      case FBCrashLogNotifierFileEventAdded:
-        [notifier.store ingestCrashLogAtPath:path];
-        continue;
-      case FBCrashLogNotifierFileEventRemoved:
-        [notifier.store removeCrashLogAtPath:path];
-        continue;
-      default:
-        continue;
-    }
-  }
-}
-
-@implementation FBCrashLogNotifier_FSEvents
-
-- (instancetype)initWithDirectories:(NSArray<NSString *> *)directories store:(FBCrashLogStore *)store logger:(id<FBControlCoreLogger>)logger
-{
-  self = [super init];
-  if (!self) {
-    return nil;
-  }
-
-  _directories = directories;
-  _store = store;
-  _logger = logger;
-  _queue = dispatch_queue_create("com.facebook.fbcontrolcore.crash_logs.fsevents", DISPATCH_QUEUE_SERIAL);
+@implementation FBCrashLogNotifier
 
-  return self;
-}
+#pragma mark Initializers
 
-- (void)startListening:(BOOL)onlyNew
++ (nullable instancetype)notifierForDirectories:(NSArray<NSString *> *)directories backend:(FBDirectoryWatcherBackend)backend logger:(id<FBControlCoreLogger>)logger error:(NSError **)error
 {
-  if (self.eventStream) {
-    return;
-  }
-
-  FSEventStreamContext context = {
-    .version = 0,
-    .info = (void *) CFBridgingRetain(self),
-    .retain = CFRetain,
-    .release = CFRelease,
-    .copyDescription = NULL,
-  };
-
-  NSMutableArray<NSString *> *pathsToWatch = NSMutableArray.array;
-  for (NSString *reportPath in self.directories) {
-    if ([[NSFileManager defaultManager] fileExistsAtPath:reportPath]) {
-      [pathsToWatch addObject:reportPath];
+  FBCrashLogStore *store = [FBCrashLogStore storeForDirectories:directories logger:logger];
+  dispatch_queue_t queue = dispatch_queue_create("com.facebook.fbcontrolcore.crash_logs.watcher", DISPATCH_QUEUE_SERIAL);
+  // Crash logs are ingested as soon as the watcher sees them, so that waiting for one resolves without polling.
+  FBDirectoryWatcherHandler handler = ^(NSString *path, FBDirectoryWatcherEvent event) {
+    switch (event) {
+      case FBDirectoryWatcherEventAdded:
+        [store ingestCrashLogAtPath:path];
+        return;
+      case FBDirectoryWatcherEventRemoved:
+        [store removeCrashLogAtPath:path];
+        return;
     }
+  };
+  FBDirectoryWatcher *watcher = [FBDirectoryWatcher watcherForDirectories:directories backend:backend queue:queue handler:handler error:error];
+  if (!watcher) {
+    return nil;
   }
-
-  FSEventStreamRef eventStream = FSEventStreamCreate(
-    NULL, // Allocator
-    (FSEventStreamCallback) EventStreamCallback, // Callback
-    &context,  // Context
-    CFBridgingRetain(pathsToWatch), // Paths to watch
-    onlyNew ? kFSEventStreamEventIdSinceNow : 0,  // Since When
-    0,  // Latency
-    kFSEventStreamCreateFlagUseCFTypes | kFSEventStreamCreateFlagFileEvents | kFSEventStreamCreateFlagNoDefer
-  );
-  FSEventStreamSetDispatchQueue(eventStream, self.queue);
-  Boolean started = FSEventStreamStart(eventStream);
-  NSAssert(started, @"Event Stream could not be started");
-  self.eventStream = eventStream;
+  return [[self alloc] initWithStore:store watcher:watcher queue:queue handler:handler logger:logger];
 }
 
-@end
-
-#endif
-
-@interface FBCrashLogNotifier ()
-
-#if defined(__apple_build_version__)
-@property (nonatomic, strong, readonly) FBCrashLogNotifier_FSEvents *fsEvents;
-#else
-@property (nonatomic, copy, readwrite) NSDate *sinceDate;
-#endif
-
-@end
-
-@implementation FBCrashLogNotifier
-
-#pragma mark Initializers
-
-- (instancetype)initWithLogger:(id<FBControlCoreLogger>)logger
+- (instancetype)initWithStore:(FBCrashLogStore *)store watcher:(FBDirectoryWatcher *)watcher queue:(dispatch_queue_t)queue handler:(FBDirectoryWatcherHandler)handler logger:(id<FBControlCoreLogger>)logger
 {
   self = [super init];
   if (!self) {
     return nil;
   }
 
-  _store = [FBCrashLogStore storeForDirectories:FBCrashLogInfo.diagnosticReportsPaths logger:logger];
-
-#if defined(__apple_build_version__)
-  _fsEvents = [[FBCrashLogNotifier_FSEvents alloc] initWithDirectories:FBCrashLogInfo.diagnosticReportsPaths store:_store logger:logger];
-#else
-  _sinceDate = NSDate.date;
-#endif
+  _store = store;
+  _watcher = watcher;
+  _queue = queue;
+  _handler = handler;
+  _logger = logger;
 
   return self;
 }
@@ -167,7 +70,7 @@ static void EventStreamCallback(
   static dispatch_once_t onceToken;
   static FBCrashLogNotifier *notifier;
   dispatch_once(&onceToken, ^{
-    notifier = [[FBCrashLogNotifier alloc] initWithLogger:FBControlCoreGlobalConfiguration.defaultLogger];
+    notifier = [FBCrashLogNotifier notifierForDirectories:FBCrashLogInfo.diagnosticReportsPaths backend:FBDirectoryWatcherBackendDefault logger:FBControlCoreGlobalConfiguration.defaultLogger error:nil];
   });
   return notifier;
 }
@@ -176,37 +79,35 @@ static void EventStreamCallback(
 
 - (instancetype)startListening:(BOOL)onlyNew
 {
-#if defined(__apple_build_version__)
-  [self.fsEvents startListening:onlyNew];
-#else
-  self.sinceDate = NSDate.date;
-#endif
-  return self;
+  @synchronized (self) {
+    NSError *error = nil;
+    if ([self.watcher startWatching:onlyNew error:&error]) {
+      return self;
+    }
+    if (self.watcher.backend == FBDirectoryWatcherBackendPolling) {
+      [self.logger logFormat:@"Could not start listening for crash logs %@", error];
+      return self;
+    }
+    // Kernel notifications can fail when they are started, polling is available everywhere.
+    [self.logger logFormat:@"Could not start listening for crash logs with %@, falling back to polling %@", self.watcher, error];
+    self.watcher = [FBDirectoryWatcher watcherForDirectories:self.watcher.directories backend:FBDirectoryWatcherBackendPolling queue:self.queue handler:self.handler error:nil];
+    if (![self.watcher startWatching:onlyNew error:&error]) {
+      [self.logger logFormat:@"Could not start listening for crash logs %@", error];
+    }
+    return self;
+  }
 }
 
 - (FBFuture<FBCrashLogInfo *> *)nextCrashLogForPredicate:(NSPredicate *)predicate
 {
   [self startListening:YES];
+  return [self.store nextCrashLogForMatchingPredicate:predicate];
+}
 
-#if defined(__apple_build_version__)
-  return [FBCrashLogNotifier.sharedInstance.fsEvents.store nextCrashLogForMatchingPredicate:predicate];
-#else
-  dispatch_queue_t queue = dispatch_queue_create("com.facebook.fbcontrolcore.crashlogfetch", DISPATCH_QUEUE_SERIAL);
-  return [FBFuture
-   onQueue:queue resolveUntil:^{
-     FBCrashLogInfo *crashInfo = [[[FBCrashLogInfo
-       crashInfoAfterDate:FBCrashLogNotifier.sharedInstance.sinceDate]
-       filteredArrayUsingPredicate:predicate]
-       firstObject];
-     if (!crashInfo) {
-       return [[[FBControlCoreError
-         describeFormat:@"Crash Log Info for %@ could not be obtained", predicate]
-         noLogging]
-         failFuture];
-     }
-     return [FBFuture futureWithResult:crashInfo];
-   }];
-#endif
+- (FBFuture<FBCrashLogInfo *> *)crashLogForPredicate:(NSPredicate *)predicate
+{
+  [self startListening:YES];
+  return [self.store crashLogForMatchingPredicate:predicate];
 }
 
 @end
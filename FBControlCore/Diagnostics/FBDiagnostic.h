@@ -67,6 +67,12 @@ typedef NSString *FBDiagnosticName NS_EXTENSIBLE_STRING_ENUM;
  */
 @property (nullable, nonatomic, readonly, copy) NSString *asPath;
 
+/**
+ The path of the file that the log is backed by, nil if the log is not backed by a file.
+ Unlike `asPath`, this will not write the log out to a file.
+ */
+@property (nullable, nonatomic, readonly, copy) NSString *filePath;
+
 /**
  The content of the log, if representable as a JSON Object in Native Containers.
  */
@@ -82,6 +88,36 @@ typedef NSString *FBDiagnosticName NS_EXTENSIBLE_STRING_ENUM;
  */
 @property (nonatomic, readonly, assign) BOOL isSearchableAsText;
 
+/**
+ The textual content of the log as UTF-8 Data, nil if the log is not searchable as text.
+ File backed logs are read as Data rather than decoded into a String, and are only memory-mapped if the file cannot be written to.
+ */
+@property (nullable, nonatomic, readonly, copy) NSData *asSearchableData;
+
+/**
+ The number of lines in the textual content of the log, 0 if the log is not searchable as text.
+ Lines are delimited in the same way as -[NSString componentsSeparatedByCharactersInSet:] with the newline character set.
+ */
+@property (nonatomic, readonly, assign) NSUInteger lineCount;
+
+/**
+ Returns a slice of the lines in the textual content of the log.
+ Large file backed logs index line offsets lazily, reading the file in chunks, so only the bytes up to the end of the range are read.
+
+ @param range the range of lines to return. The range is clamped to the lines that exist.
+ @return the lines in the range.
+ */
+- (NSArray<NSString *> *)linesInRange:(NSRange)range;
+
+/**
+ Returns the last lines in the textual content of the log.
+ Large file backed logs are read backwards from the end in chunks, so only the bytes of the returned lines are read.
+
+ @param count the maximum number of lines to return.
+ @return the last lines of the log, in order.
+ */
+- (NSArray<NSString *> *)lastLines:(NSUInteger)count;
+
 /**
  Writes the FBDiagnostic out to a file path.
  This call is optimised for backing store of the reciever.
@@ -193,6 +229,7 @@ typedef NSString *FBDiagnosticName NS_EXTENSIBLE_STRING_ENUM;
  Will replace any data or string associated with the log.
 
  Since the Diagnostic associated with a Path can change, any coercions will happen lazily.
+ Files above a size threshold keep their contents and line index until the file changes.
 
  @param path the File Path to update with.
  @return the reciever, for chaining.
@@ -11,9 +11,330 @@
 
 #import <objc/runtime.h>
 
+#include <errno.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
 #import "FBCollectionInformation.h"
 #import "FBControlCoreError.h"
 
+static NSUInteger const FBDiagnosticSearchableDataPrefixLength = 4096;
+static unsigned long long const FBDiagnosticIndexedFileSizeThreshold = 1024 * 1024;
+static size_t const FBDiagnosticReadChunkSize = 64 * 1024;
+
+/**
+ Reads the contents of a file.
+ A file is only memory-mapped if it is known to be immutable, as accessing the mapping of a file that has since been truncated faults with SIGBUS.
+ Files that may be written to, such as live logs, are read instead.
+ The file is checked through the same descriptor that it is read from, so it cannot be replaced in between.
+ */
+static NSData *FBDiagnosticReadFile(NSString *path)
+{
+  int fileDescriptor = open(path.fileSystemRepresentation, O_RDONLY | O_CLOEXEC);
+  if (fileDescriptor < 0) {
+    return nil;
+  }
+  struct stat info;
+  if (fstat(fileDescriptor, &info) != 0 || !S_ISREG(info.st_mode)) {
+    close(fileDescriptor);
+    return nil;
+  }
+  BOOL immutable = (info.st_flags & (UF_IMMUTABLE | SF_IMMUTABLE)) != 0 || (info.st_mode & (S_IWUSR | S_IWGRP | S_IWOTH)) == 0;
+  if (immutable && info.st_size > 0) {
+    size_t length = (size_t) info.st_size;
+    void *mapping = mmap(NULL, length, PROT_READ, MAP_PRIVATE, fileDescriptor, 0);
+    if (mapping != MAP_FAILED) {
+      close(fileDescriptor);
+      return [[NSData alloc] initWithBytesNoCopy:mapping length:length deallocator:^(void *bytes, NSUInteger mappedLength) {
+        munmap(bytes, mappedLength);
+      }];
+    }
+  }
+  // The size is only a hint, as a live file may grow or shrink whilst it is read.
+  NSMutableData *data = [NSMutableData dataWithLength:(NSUInteger) MAX(info.st_size, (off_t) 0) + FBDiagnosticReadChunkSize];
+  NSUInteger length = 0;
+  while (YES) {
+    if (length == data.length) {
+      data.length += FBDiagnosticReadChunkSize;
+    }
+    ssize_t count = read(fileDescriptor, (uint8_t *) data.mutableBytes + length, data.length - length);
+    if (count < 0 && errno == EINTR) {
+      continue;
+    }
+    if (count < 0) {
+      close(fileDescriptor);
+      return nil;
+    }
+    if (count == 0) {
+      break;
+    }
+    length += (NSUInteger) count;
+  }
+  close(fileDescriptor);
+  data.length = length;
+  return data;
+}
+
+/**
+ Returns the length of the line terminator ending at the index, or 0 if there is no terminator there.
+ The terminators are those of -[NSCharacterSet newlineCharacterSet], in UTF-8.
+ */
+static inline NSUInteger FBDiagnosticLineTerminatorLength(const uint8_t *bytes, NSUInteger index)
+{
+  uint8_t byte = bytes[index];
+  if (byte >= '\n' && byte <= '\r') {
+    return 1;
+  }
+  if (byte == 0x85 && index >= 1 && bytes[index - 1] == 0xC2) {
+    return 2;
+  }
+  if ((byte == 0xA8 || byte == 0xA9) && index >= 2 && bytes[index - 1] == 0x80 && bytes[index - 2] == 0xE2) {
+    return 3;
+  }
+  return 0;
+}
+
+/**
+ Decodes a line of text.
+ */
+static NSString *FBDiagnosticLineString(const uint8_t *bytes, NSUInteger length)
+{
+  // Lines that are not valid UTF-8 are still returned, so that line numbers remain stable.
+  return [[NSString alloc] initWithBytes:bytes length:length encoding:NSUTF8StringEncoding]
+      ?: [[NSString alloc] initWithBytes:bytes length:length encoding:NSISOLatin1StringEncoding];
+}
+
+/**
+ Reads up to the length of bytes at the offset of the file, without moving the file offset.
+ Fewer bytes are returned if the file ends before the range does, nil is returned on a read error.
+ */
+static NSData *FBDiagnosticReadRange(int fileDescriptor, NSUInteger offset, NSUInteger length)
+{
+  NSMutableData *data = [NSMutableData dataWithLength:length];
+  NSUInteger read = 0;
+  while (read < length) {
+    ssize_t count = pread(fileDescriptor, (uint8_t *) data.mutableBytes + read, length - read, (off_t) (offset + read));
+    if (count < 0 && errno == EINTR) {
+      continue;
+    }
+    if (count < 0) {
+      return nil;
+    }
+    if (count == 0) {
+      break;
+    }
+    read += (NSUInteger) count;
+  }
+  data.length = read;
+  return data;
+}
+
+/**
+ An index of the offsets of lines in UTF-8 text.
+ The index is extended lazily, only as far as the lines that have been requested.
+ Text in a file is read in chunks with pread(2), so that only the bytes of the requested lines, and the lines before them, are read.
+ */
+@interface FBDiagnosticLineIndex : NSObject
+
+- (instancetype)initWithData:(NSData *)data modificationDate:(nullable NSDate *)modificationDate;
+- (instancetype)initWithFileDescriptor:(int)fileDescriptor length:(NSUInteger)length modificationDate:(NSDate *)modificationDate;
+
+- (NSUInteger)lineCount;
+- (nullable NSArray<NSString *> *)linesInRange:(NSRange)range;
+- (nullable NSArray<NSString *> *)lastLines:(NSUInteger)count;
+
+@property (nonatomic, assign, readonly) NSUInteger length;
+@property (nonatomic, copy, nullable, readonly) NSDate *modificationDate;
+
+@end
+
+@implementation FBDiagnosticLineIndex
+{
+  NSData *_data;
+  int _fileDescriptor;
+  NSRange *_lines;
+  NSUInteger _count;
+  NSUInteger _capacity;
+  NSUInteger _scanOffset;
+  NSUInteger _scanCursor;
+  BOOL _complete;
+}
+
+- (instancetype)initWithData:(NSData *)data modificationDate:(nullable NSDate *)modificationDate
+{
+  self = [super init];
+  if (!self) {
+    return nil;
+  }
+
+  _data = data;
+  _fileDescriptor = -1;
+  _length = data.length;
+  _modificationDate = modificationDate;
+
+  return self;
+}
+
+- (instancetype)initWithFileDescriptor:(int)fileDescriptor length:(NSUInteger)length modificationDate:(NSDate *)modificationDate
+{
+  self = [super init];
+  if (!self) {
+    return nil;
+  }
+
+  _fileDescriptor = fileDescriptor;
+  _length = length;
+  _modificationDate = modificationDate;
+
+  return self;
+}
+
+- (void)dealloc
+{
+  if (_fileDescriptor >= 0) {
+    close(_fileDescriptor);
+  }
+  free(_lines);
+}
+
+#pragma mark Public
+
+- (NSUInteger)lineCount
+{
+  @synchronized (self) {
+    [self extendToLineCount:NSUIntegerMax];
+    return _count;
+  }
+}
+
+- (nullable NSArray<NSString *> *)linesInRange:(NSRange)range
+{
+  @synchronized (self) {
+    NSUInteger end = range.length > NSUIntegerMax - range.location ? NSUIntegerMax : NSMaxRange(range);
+    [self extendToLineCount:end];
+    if (range.location >= MIN(end, _count)) {
+      return @[];
+    }
+    // The lines are contiguous, so their bytes are read at once.
+    NSUInteger first = range.location;
+    NSUInteger last = MIN(end, _count) - 1;
+    NSUInteger bytesStart = _lines[first].location;
+    NSUInteger bytesLength = NSMaxRange(_lines[last]) - bytesStart;
+    NSData *data = [self dataInRange:NSMakeRange(bytesStart, bytesLength)];
+    // The file may have been truncated since it was indexed.
+    if (data.length != bytesLength) {
+      return nil;
+    }
+    const uint8_t *bytes = data.bytes;
+    NSMutableArray<NSString *> *lines = [NSMutableArray array];
+    for (NSUInteger index = first; index <= last; index++) {
+      NSRange line = _lines[index];
+      [lines addObject:FBDiagnosticLineString(bytes + line.location - bytesStart, line.length)];
+    }
+    return [lines copy];
+  }
+}
+
+- (nullable NSArray<NSString *> *)lastLines:(NSUInteger)count
+{
+  @synchronized (self) {
+    if (_complete) {
+      NSUInteger start = _count > count ? _count - count : 0;
+      return [self linesInRange:NSMakeRange(start, _count - start)];
+    }
+
+    // Read backwards from the end, so that only the tail of the text is read.
+    // The size of each read doubles, so that the tail is copied a constant number of times overall.
+    NSMutableData *tail = [NSMutableData data];
+    NSUInteger tailStart = _length;
+    NSMutableArray<NSString *> *lines = [NSMutableArray array];
+    NSUInteger lineEnd = _length;
+    NSUInteger index = _length;
+    while (lines.count < count && index > 0) {
+      index--;
+      // A multi-byte terminator needs the two bytes before the index.
+      if (tailStart > 0 && index < tailStart + 2) {
+        NSUInteger readLength = MIN(tailStart, MAX(FBDiagnosticReadChunkSize, tail.length));
+        NSData *chunk = [self dataInRange:NSMakeRange(tailStart - readLength, readLength)];
+        if (chunk.length != readLength) {
+          return nil;
+        }
+        [tail replaceBytesInRange:NSMakeRange(0, 0) withBytes:chunk.bytes length:chunk.length];
+        tailStart -= readLength;
+      }
+      const uint8_t *bytes = tail.bytes;
+      NSUInteger terminatorLength = FBDiagnosticLineTerminatorLength(bytes, index - tailStart);
+      if (terminatorLength == 0) {
+        continue;
+      }
+      [lines addObject:FBDiagnosticLineString(bytes + index + 1 - tailStart, lineEnd - index - 1)];
+      lineEnd = index + 1 - terminatorLength;
+      index = lineEnd;
+    }
+    if (lines.count < count && index == 0) {
+      [lines addObject:FBDiagnosticLineString(tail.bytes, lineEnd)];
+    }
+    return [[lines reverseObjectEnumerator] allObjects];
+  }
+}
+
+#pragma mark Private
+
+- (nullable NSData *)dataInRange:(NSRange)range
+{
+  if (_data) {
+    return [_data subdataWithRange:range];
+  }
+  return FBDiagnosticReadRange(_fileDescriptor, range.location, range.length);
+}
+
+- (void)extendToLineCount:(NSUInteger)lineCount
+{
+  while (!_complete && _count < lineCount) {
+    if (_scanCursor >= _length) {
+      [self appendLine:NSMakeRange(_scanOffset, _length - _scanOffset)];
+      _complete = YES;
+      break;
+    }
+    // The chunk starts with the two bytes before the cursor, so that a multi-byte terminator split across chunks is found.
+    NSUInteger lookbehind = MIN(_scanCursor, 2u);
+    NSUInteger chunkStart = _scanCursor - lookbehind;
+    NSData *chunk = [self dataInRange:NSMakeRange(chunkStart, MIN(_length - chunkStart, FBDiagnosticReadChunkSize))];
+    if (chunk.length <= lookbehind) {
+      // The file has been truncated since the index was created, so the text ends here.
+      _length = MIN(_length, chunkStart + chunk.length);
+      _scanCursor = _length;
+      continue;
+    }
+    const uint8_t *bytes = chunk.bytes;
+    NSUInteger index = lookbehind;
+    while (index < chunk.length && _count < lineCount) {
+      NSUInteger terminatorLength = FBDiagnosticLineTerminatorLength(bytes, index);
+      index++;
+      if (terminatorLength == 0) {
+        continue;
+      }
+      NSUInteger lineEnd = chunkStart + index - terminatorLength;
+      [self appendLine:NSMakeRange(_scanOffset, lineEnd - _scanOffset)];
+      _scanOffset = chunkStart + index;
+    }
+    _scanCursor = chunkStart + index;
+  }
+}
+
+- (void)appendLine:(NSRange)range
+{
+  if (_count == _capacity) {
+    _capacity = MAX(_capacity * 2, 1024u);
+    _lines = reallocf(_lines, _capacity * sizeof(NSRange));
+  }
+  _lines[_count++] = range;
+}
+
+@end
+
 @interface FBDiagnostic ()
 
 @property (nonatomic, copy, readwrite) FBDiagnosticName shortName;
@@ -26,6 +347,9 @@
 @property (nonatomic, copy, readwrite) NSString *backingString;
 @property (nonatomic, copy, readwrite) NSString *backingFilePath;
 @property (nonatomic, copy, readwrite) id backingJSON;
+@property (nonatomic, strong, readwrite) FBDiagnosticLineIndex *backingLineIndex;
+
+- (FBDiagnosticLineIndex *)lineIndex;
 
 @end
 
@@ -56,6 +380,14 @@
 
 @end
 
+/**
+ A representation of a Diagnostic, backed by a large File Path.
+ The line index is kept until the file changes. Lines are read from the file as they are requested, rather than reading the whole file.
+ */
+@interface FBDiagnostic_IndexedPath : FBDiagnostic_Path
+
+@end
+
 /**
  A representation of a Diagnostic, backed by JSON.
  */
@@ -123,6 +455,11 @@
   return self.backingJSON;
 }
 
+- (NSString *)filePath
+{
+  return nil;
+}
+
 - (BOOL)hasLogContent
 {
   return NO;
@@ -133,6 +470,26 @@
   return self.asString != nil;
 }
 
+- (NSData *)asSearchableData
+{
+  return [self.asString dataUsingEncoding:NSUTF8StringEncoding];
+}
+
+- (NSUInteger)lineCount
+{
+  return self.lineIndex.lineCount;
+}
+
+- (NSArray<NSString *> *)linesInRange:(NSRange)range
+{
+  return [self.lineIndex linesInRange:range] ?: @[];
+}
+
+- (NSArray<NSString *> *)lastLines:(NSUInteger)count
+{
+  return [self.lineIndex lastLines:count] ?: @[];
+}
+
 - (BOOL)writeOutToFilePath:(NSString *)path error:(NSError **)error
 {
   return NO;
@@ -157,6 +514,15 @@
 
 #pragma mark Private
 
+- (FBDiagnosticLineIndex *)lineIndex
+{
+  NSData *data = self.asSearchableData;
+  if (!data) {
+    return nil;
+  }
+  return [[FBDiagnosticLineIndex alloc] initWithData:data modificationDate:nil];
+}
+
 + (NSString *)defaultStorageDirectory
 {
   return [NSTemporaryDirectory() stringByAppendingPathComponent:NSUUID.UUID.UUIDString];
@@ -300,6 +666,11 @@
   return self.backingString;
 }
 
+- (NSData *)asSearchableData
+{
+  return self.asString ? self.backingData : nil;
+}
+
 - (NSString *)asPath
 {
   if (!self.backingFilePath) {
@@ -415,6 +786,11 @@
   return self.backingData;
 }
 
+- (NSData *)asSearchableData
+{
+  return self.asData;
+}
+
 - (NSString *)asPath
 {
   if (!self.backingFilePath) {
@@ -534,6 +910,25 @@
   return [[NSString alloc] initWithContentsOfFile:self.backingFilePath usedEncoding:nil error:nil];
 }
 
+- (NSString *)filePath
+{
+  return self.backingFilePath;
+}
+
+- (NSData *)asSearchableData
+{
+  NSData *data = FBDiagnosticReadFile(self.backingFilePath);
+  if (!data) {
+    return nil;
+  }
+  // A NUL near the start means that the file is binary, or in a wide encoding. Decoding it as a String preserves the existing behaviour for these.
+  NSUInteger prefixLength = MIN(data.length, FBDiagnosticSearchableDataPrefixLength);
+  if (memchr(data.bytes, 0, prefixLength) != NULL) {
+    return [self.asString dataUsingEncoding:NSUTF8StringEncoding];
+  }
+  return data;
+}
+
 - (id)asJSON
 {
   NSInputStream *inputStream = [NSInputStream inputStreamWithFileAtPath:self.backingFilePath];
@@ -613,6 +1008,61 @@
 
 @end
 
+@implementation FBDiagnostic_IndexedPath
+
+#pragma mark Public API
+
+- (NSData *)asData
+{
+  return FBDiagnosticReadFile(self.backingFilePath);
+}
+
+#pragma mark Private
+
+- (FBDiagnosticLineIndex *)lineIndex
+{
+  @synchronized (self) {
+    NSDictionary<NSFileAttributeKey, id> *attributes = [NSFileManager.defaultManager attributesOfItemAtPath:self.backingFilePath error:nil];
+    if (!attributes) {
+      self.backingLineIndex = nil;
+      return nil;
+    }
+    // Only re-index the file if it has changed since the index was created.
+    FBDiagnosticLineIndex *lineIndex = self.backingLineIndex;
+    NSDate *modificationDate = attributes[NSFileModificationDate];
+    if (lineIndex && lineIndex.length == [attributes[NSFileSize] unsignedLongLongValue] && [lineIndex.modificationDate isEqualToDate:modificationDate]) {
+      return lineIndex;
+    }
+    lineIndex = [self createLineIndexWithModificationDate:modificationDate];
+    self.backingLineIndex = lineIndex;
+    return lineIndex;
+  }
+}
+
+- (nullable FBDiagnosticLineIndex *)createLineIndexWithModificationDate:(NSDate *)modificationDate
+{
+  int fileDescriptor = open(self.backingFilePath.fileSystemRepresentation, O_RDONLY | O_CLOEXEC);
+  if (fileDescriptor < 0) {
+    return nil;
+  }
+  struct stat info;
+  if (fstat(fileDescriptor, &info) != 0 || !S_ISREG(info.st_mode)) {
+    close(fileDescriptor);
+    return nil;
+  }
+  // Binary or wide encoded files are decoded in the same way as -[FBDiagnostic_Path asSearchableData], which requires the whole file.
+  NSData *prefix = FBDiagnosticReadRange(fileDescriptor, 0, FBDiagnosticSearchableDataPrefixLength);
+  if (!prefix || memchr(prefix.bytes, 0, prefix.length) != NULL) {
+    close(fileDescriptor);
+    NSData *data = [super asSearchableData];
+    return data ? [[FBDiagnosticLineIndex alloc] initWithData:data modificationDate:modificationDate] : nil;
+  }
+  // The index owns the descriptor, so reads continue from the same file even if the path is replaced.
+  return [[FBDiagnosticLineIndex alloc] initWithFileDescriptor:fileDescriptor length:(NSUInteger) info.st_size modificationDate:modificationDate];
+}
+
+@end
+
 @implementation FBDiagnostic_JSON
 
 #pragma mark NSCopying
@@ -735,6 +1185,11 @@
   return nil;
 }
 
+- (NSData *)asSearchableData
+{
+  return nil;
+}
+
 - (NSString *)asString
 {
   return nil;
@@ -863,7 +1318,9 @@
   if (![NSFileManager.defaultManager fileExistsAtPath:path]) {
     return self;
   }
-  object_setClass(self.diagnostic, FBDiagnostic_Path.class);
+  NSDictionary<NSFileAttributeKey, id> *attributes = [NSFileManager.defaultManager attributesOfItemAtPath:path error:nil];
+  BOOL indexed = [attributes[NSFileSize] unsignedLongLongValue] >= FBDiagnosticIndexedFileSizeThreshold;
+  object_setClass(self.diagnostic, indexed ? FBDiagnostic_IndexedPath.class : FBDiagnostic_Path.class);
   self.diagnostic.backingFilePath = path;
   if (!self.diagnostic.shortName) {
     self.diagnostic.shortName = [[path lastPathComponent] stringByDeletingPathExtension];
@@ -952,6 +1409,7 @@
   self.diagnostic.backingString = nil;
   self.diagnostic.backingFilePath = nil;
   self.diagnostic.backingJSON = nil;
+  self.diagnostic.backingLineIndex = nil;
   object_setClass(self.diagnostic, FBDiagnostic_Empty.class);
 }
 
@@ -91,6 +91,15 @@ extern FBDiagnosticQueryFormat FBDiagnosticQueryFormatContent;
  */
 - (FBFuture<NSArray<FBDiagnostic *> *> *)run:(id<FBiOSTarget>)target;
 
+/**
+ Run the query against a target, returning only the content that has not been read by a previous run.
+ File backed diagnostics are read incrementally through the target's `FBDiagnosticTail`.
+
+ @param target the target to run against.
+ @return a future returning the unread content of the diagnostics that were fetched.
+ */
+- (FBFuture<NSArray<FBDiagnostic *> *> *)runUnread:(id<FBiOSTarget>)target;
+
 @end
 
 NS_ASSUME_NONNULL_END
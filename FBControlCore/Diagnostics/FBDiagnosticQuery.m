@@ -13,6 +13,7 @@
 #import "FBControlCoreError.h"
 #import "FBControlCoreError.h"
 #import "FBDiagnostic.h"
+#import "FBDiagnosticTail.h"
 #import "FBEventReporter.h"
 #import "FBiOSTargetDiagnostics.h"
 #import "FBEventReporterSubject.h"
@@ -497,6 +498,18 @@ static NSString *KeyType = @"type";
   return nil;
 }
 
+#pragma mark Public Methods
+
+- (FBFuture<NSArray<FBDiagnostic *> *> *)runUnread:(id<FBiOSTarget>)target
+{
+  FBDiagnosticTail *tail = target.diagnostics.tail;
+  return [[self
+    run:target]
+    onQueue:target.asyncQueue map:^(NSArray<FBDiagnostic *> *diagnostics) {
+      return [tail unreadContentOfDiagnostics:diagnostics];
+    }];
+}
+
 #pragma mark FBiOSTargetFuture
 
 + (FBiOSTargetFutureType)futureType
@@ -522,6 +535,12 @@ static NSString *KeyType = @"type";
     }];
 }
 
+- (BOOL)conflictsWithAction:(id<FBiOSTargetFuture>)action
+{
+  // Querying diagnostics only reads from the target.
+  return NO;
+}
+
 + (id<FBEventReporterSubject>)resolveDiagnostics:(NSArray<FBDiagnostic *> *)diagnostics format:(FBDiagnosticQueryFormat)format
 {
   NSMutableArray<id<FBEventReporterSubject>> *subjects = [NSMutableArray array];
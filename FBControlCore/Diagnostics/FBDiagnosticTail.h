@@ -0,0 +1,61 @@
+/**
+ * Copyright (c) 2015-present, Facebook, Inc.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree. An additional grant
+ * of patent rights can be found in the PATENTS file in the same directory.
+ */
+
+#import <Foundation/Foundation.h>
+
+NS_ASSUME_NONNULL_BEGIN
+
+@class FBDiagnostic;
+
+/**
+ Incrementally reads file backed diagnostics, remembering how far each file has been read.
+ Repeatedly searching a growing log through a tail only reads the data that has been appended since the previous read.
+
+ The position in a file is keyed by the path of the file, along with the device and inode of the file at that path.
+ If the file is replaced, for instance when a log is rotated, or is truncated, it is read again from the start.
+ Only complete lines are returned, so a line that is still being written is returned once it has been terminated.
+ */
+@interface FBDiagnosticTail : NSObject
+
+#pragma mark Initializers
+
+/**
+ A new tail, with no files read.
+
+ @return a new Diagnostic Tail.
+ */
++ (instancetype)tail;
+
+#pragma mark Public Methods
+
+/**
+ Returns the content of the diagnostic that has not yet been read by the reciever.
+ Diagnostics that are not backed by a file have no position to remember, so are returned unchanged.
+
+ @param diagnostic the diagnostic to read.
+ @return a diagnostic with the same metadata, containing only the unread content.
+ */
+- (FBDiagnostic *)unreadContentOfDiagnostic:(FBDiagnostic *)diagnostic;
+
+/**
+ Returns the unread content of many diagnostics.
+
+ @param diagnostics the diagnostics to read.
+ @return diagnostics containing only the unread content, in the same order.
+ */
+- (NSArray<FBDiagnostic *> *)unreadContentOfDiagnostics:(NSArray<FBDiagnostic *> *)diagnostics;
+
+/**
+ Forgets the positions of all files, so that they will be read from the start.
+ */
+- (void)reset;
+
+@end
+
+NS_ASSUME_NONNULL_END
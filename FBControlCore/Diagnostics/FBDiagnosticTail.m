@@ -0,0 +1,156 @@
+/**
+ * Copyright (c) 2015-present, Facebook, Inc.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree. An additional grant
+ * of patent rights can be found in the PATENTS file in the same directory.
+ */
+
+#import "FBDiagnosticTail.h"
+
+#include <errno.h>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#import "FBDiagnostic.h"
+
+static size_t const FBDiagnosticTailReadLength = 1024 * 1024;
+
+@interface FBDiagnosticTailPosition : NSObject
+
+@property (nonatomic, assign, readonly) dev_t device;
+@property (nonatomic, assign, readonly) ino_t inode;
+@property (nonatomic, assign, readonly) off_t offset;
+
+@end
+
+@implementation FBDiagnosticTailPosition
+
+- (instancetype)initWithDevice:(dev_t)device inode:(ino_t)inode offset:(off_t)offset
+{
+  self = [super init];
+  if (!self) {
+    return nil;
+  }
+
+  _device = device;
+  _inode = inode;
+  _offset = offset;
+
+  return self;
+}
+
+@end
+
+@interface FBDiagnosticTail ()
+
+@property (nonatomic, strong, readonly) NSMutableDictionary<NSString *, FBDiagnosticTailPosition *> *positions;
+
+@end
+
+@implementation FBDiagnosticTail
+
+#pragma mark Initializers
+
++ (instancetype)tail
+{
+  return [[self alloc] init];
+}
+
+- (instancetype)init
+{
+  self = [super init];
+  if (!self) {
+    return nil;
+  }
+
+  _positions = [NSMutableDictionary dictionary];
+
+  return self;
+}
+
+#pragma mark Public Methods
+
+- (FBDiagnostic *)unreadContentOfDiagnostic:(FBDiagnostic *)diagnostic
+{
+  NSString *path = diagnostic.filePath;
+  if (!path) {
+    return diagnostic;
+  }
+  NSData *data = [self readUnreadDataAtPath:path];
+  return [[[FBDiagnosticBuilder
+    builderWithDiagnostic:diagnostic]
+    updateData:data ?: NSData.data]
+    build];
+}
+
+- (NSArray<FBDiagnostic *> *)unreadContentOfDiagnostics:(NSArray<FBDiagnostic *> *)diagnostics
+{
+  NSMutableArray<FBDiagnostic *> *unread = [NSMutableArray array];
+  for (FBDiagnostic *diagnostic in diagnostics) {
+    [unread addObject:[self unreadContentOfDiagnostic:diagnostic]];
+  }
+  return [unread copy];
+}
+
+- (void)reset
+{
+  @synchronized (self) {
+    [self.positions removeAllObjects];
+  }
+}
+
+#pragma mark Private
+
+- (nullable NSData *)readUnreadDataAtPath:(NSString *)path
+{
+  // Open first and then stat the descriptor, so that the identity of the file is the identity of what is read.
+  int fileDescriptor = open(path.fileSystemRepresentation, O_RDONLY | O_CLOEXEC);
+  if (fileDescriptor == -1) {
+    return nil;
+  }
+  struct stat status;
+  if (fstat(fileDescriptor, &status) != 0) {
+    close(fileDescriptor);
+    return nil;
+  }
+
+  off_t offset = 0;
+  @synchronized (self) {
+    FBDiagnosticTailPosition *position = self.positions[path];
+    // If a different file has been rotated in at the path, or the file has been truncated, read from the start.
+    if (position && position.device == status.st_dev && position.inode == status.st_ino && position.offset <= status.st_size) {
+      offset = position.offset;
+    }
+  }
+
+  NSMutableData *data = [NSMutableData dataWithLength:(NSUInteger) (status.st_size - offset)];
+  NSUInteger length = 0;
+  while (length < data.length) {
+    ssize_t result = pread(fileDescriptor, (uint8_t *) data.mutableBytes + length, MIN(data.length - length, FBDiagnosticTailReadLength), offset + (off_t) length);
+    if (result < 0 && errno == EINTR) {
+      continue;
+    }
+    if (result <= 0) {
+      break;
+    }
+    length += (NSUInteger) result;
+  }
+  close(fileDescriptor);
+
+  // Only consume up to the last newline, leaving any partial line to be read once it is complete.
+  const uint8_t *bytes = data.bytes;
+  while (length > 0 && bytes[length - 1] != '\n') {
+    length--;
+  }
+  data.length = length;
+
+  @synchronized (self) {
+    self.positions[path] = [[FBDiagnosticTailPosition alloc] initWithDevice:status.st_dev inode:status.st_ino offset:offset + (off_t) length];
+  }
+  return data;
+}
+
+@end
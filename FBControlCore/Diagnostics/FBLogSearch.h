@@ -132,4 +132,48 @@ NS_ASSUME_NONNULL_BEGIN
 
 @end
 
+/**
+ Searches for many predicates in a single pass over UTF-8 text.
+ Substrings from all predicates are compiled into one multi-pattern automaton, so each byte of the text is visited once regardless of the number of predicates.
+ Regex predicates are only evaluated on lines containing a literal that the regex requires, where one can be determined.
+ Large inputs are split into chunks on line boundaries and searched concurrently.
+ */
+@interface FBCompiledLogSearch : NSObject
+
+/**
+ Compiles a search for the given predicates.
+
+ @param predicates the predicates to search with.
+ @return a Compiled Log Search.
+ */
++ (instancetype)searchWithPredicates:(NSArray<FBLogSearchPredicate *> *)predicates;
+
+/**
+ Searches UTF-8 text for all of the predicates.
+
+ @param data the UTF-8 text to search.
+ @param lines YES to return the matching lines, NO to return the matching substrings.
+ @param first YES to return at most one match per predicate.
+ @return an array of matches for each predicate, in the order of the predicates.
+ */
+- (NSArray<NSArray<NSString *> *> *)matchesInData:(NSData *)data lines:(BOOL)lines first:(BOOL)first;
+
+/**
+ Searches a Diagnostic for all of the predicates.
+ If the Diagnostic is not searchable as text, there will be no matches.
+
+ @param diagnostic the diagnostic to search.
+ @param lines YES to return the matching lines, NO to return the matching substrings.
+ @param first YES to return at most one match per predicate.
+ @return an array of matches for each predicate, in the order of the predicates.
+ */
+- (NSArray<NSArray<NSString *> *> *)matchesInDiagnostic:(FBDiagnostic *)diagnostic lines:(BOOL)lines first:(BOOL)first;
+
+/**
+ The Predicates to Search with.
+ */
+@property (nonatomic, copy, readonly) NSArray<FBLogSearchPredicate *> *predicates;
+
+@end
+
 NS_ASSUME_NONNULL_END
@@ -375,9 +375,544 @@ static NSString *const KeyRegex = @"regex";
 
 - (NSArray<NSString *> *)lines
 {
-  return self.diagnostic.isSearchableAsText
-    ? [self.diagnostic.asString componentsSeparatedByCharactersInSet:NSCharacterSet.newlineCharacterSet]
-    : @[];
+  return [self.diagnostic linesInRange:NSMakeRange(0, NSUIntegerMax)];
+}
+
+- (NSArray<NSString *> *)matchesWithLines:(BOOL)lines
+{
+  return [[[FBCompiledLogSearch searchWithPredicates:@[self.predicate]] matchesInDiagnostic:self.diagnostic lines:lines first:NO] firstObject];
+}
+
+- (NSString *)firstMatch
+{
+  return [[[[FBCompiledLogSearch searchWithPredicates:@[self.predicate]] matchesInDiagnostic:self.diagnostic lines:NO first:YES] firstObject] firstObject];
+}
+
+- (NSString *)firstMatchingLine
+{
+  return [[[[FBCompiledLogSearch searchWithPredicates:@[self.predicate]] matchesInDiagnostic:self.diagnostic lines:YES first:YES] firstObject] firstObject];
+}
+
+@end
+
+#pragma mark - FBCompiledLogSearch
+
+// Chunks smaller than this are not worth the cost of dispatching to another core.
+static NSUInteger const FBCompiledLogSearchMinimumChunkLength = 256 * 1024;
+
+static int32_t const FBCompiledLogSearchNoPattern = -1;
+
+typedef struct {
+  uint32_t predicate;
+  uint32_t needle;
+} FBCompiledLogSearchOwner;
+
+/**
+ An Aho-Corasick automaton over the bytes of all patterns, compiled to a DFA.
+ Bytes are mapped to equivalence classes first, so that the transition table is sized by the distinct bytes in the patterns rather than 256.
+ */
+typedef struct {
+  uint8_t byteClass[256];
+  uint32_t classCount;
+  uint32_t stateCount;
+  uint32_t *transitions;
+  int32_t *statePattern;
+  uint32_t *outputLink;
+  uint32_t *ownerOffsets;
+  FBCompiledLogSearchOwner *owners;
+} FBCompiledLogSearchAutomaton;
+
+static void FBCompiledLogSearchAutomatonFree(FBCompiledLogSearchAutomaton *automaton)
+{
+  free(automaton->transitions);
+  free(automaton->statePattern);
+  free(automaton->outputLink);
+  free(automaton->ownerOffsets);
+  free(automaton->owners);
+  memset(automaton, 0, sizeof(FBCompiledLogSearchAutomaton));
+}
+
+static void FBCompiledLogSearchAutomatonBuild(FBCompiledLogSearchAutomaton *automaton, NSArray<NSData *> *patterns, NSArray<NSArray<NSValue *> *> *patternOwners)
+{
+  memset(automaton, 0, sizeof(FBCompiledLogSearchAutomaton));
+
+  // Assign classes to the bytes that appear in any pattern. Everything else shares class 0.
+  uint32_t classCount = 1;
+  size_t maximumStates = 1;
+  for (NSData *pattern in patterns) {
+    const uint8_t *bytes = pattern.bytes;
+    for (NSUInteger index = 0; index < pattern.length; index++) {
+      if (automaton->byteClass[bytes[index]] == 0) {
+        automaton->byteClass[bytes[index]] = (uint8_t) classCount++;
+      }
+    }
+    maximumStates += pattern.length;
+  }
+  automaton->classCount = classCount;
+
+  // Build the trie. State 0 is the root, so 0 doubles as 'no transition' as nothing transitions back to the root in a trie.
+  uint32_t *transitions = calloc(maximumStates * classCount, sizeof(uint32_t));
+  int32_t *statePattern = malloc(maximumStates * sizeof(int32_t));
+  uint32_t *outputLink = calloc(maximumStates, sizeof(uint32_t));
+  uint32_t *failure = calloc(maximumStates, sizeof(uint32_t));
+  for (size_t index = 0; index < maximumStates; index++) {
+    statePattern[index] = FBCompiledLogSearchNoPattern;
+  }
+  uint32_t stateCount = 1;
+  for (NSUInteger patternIndex = 0; patternIndex < patterns.count; patternIndex++) {
+    NSData *pattern = patterns[patternIndex];
+    const uint8_t *bytes = pattern.bytes;
+    uint32_t state = 0;
+    for (NSUInteger index = 0; index < pattern.length; index++) {
+      uint32_t *transition = &transitions[(state * classCount) + automaton->byteClass[bytes[index]]];
+      if (*transition == 0) {
+        *transition = stateCount++;
+      }
+      state = *transition;
+    }
+    statePattern[state] = (int32_t) patternIndex;
+  }
+
+  // Breadth-first, compute failure links and fill in the missing transitions, converting the trie into a DFA.
+  // Shallower states are complete before deeper ones, so following a failure link is a single lookup.
+  uint32_t *queue = malloc(stateCount * sizeof(uint32_t));
+  size_t queueHead = 0;
+  size_t queueTail = 0;
+  queue[queueTail++] = 0;
+  while (queueHead < queueTail) {
+    uint32_t state = queue[queueHead++];
+    for (uint32_t byteClass = 0; byteClass < classCount; byteClass++) {
+      uint32_t *transition = &transitions[(state * classCount) + byteClass];
+      if (*transition == 0) {
+        *transition = state == 0 ? 0 : transitions[(failure[state] * classCount) + byteClass];
+        continue;
+      }
+      uint32_t child = *transition;
+      uint32_t childFailure = state == 0 ? 0 : transitions[(failure[state] * classCount) + byteClass];
+      failure[child] = childFailure;
+      outputLink[child] = statePattern[childFailure] != FBCompiledLogSearchNoPattern ? childFailure : outputLink[childFailure];
+      queue[queueTail++] = child;
+    }
+  }
+  free(queue);
+  free(failure);
+
+  // Flatten the owners of each pattern.
+  uint32_t *ownerOffsets = calloc(patterns.count + 1, sizeof(uint32_t));
+  NSUInteger ownerCount = 0;
+  for (NSArray<NSValue *> *owners in patternOwners) {
+    ownerCount += owners.count;
+  }
+  FBCompiledLogSearchOwner *owners = calloc(MAX(ownerCount, 1u), sizeof(FBCompiledLogSearchOwner));
+  uint32_t ownerIndex = 0;
+  for (NSUInteger patternIndex = 0; patternIndex < patternOwners.count; patternIndex++) {
+    ownerOffsets[patternIndex] = ownerIndex;
+    for (NSValue *value in patternOwners[patternIndex]) {
+      [value getValue:&owners[ownerIndex++]];
+    }
+  }
+  ownerOffsets[patternOwners.count] = ownerIndex;
+
+  automaton->stateCount = stateCount;
+  automaton->transitions = transitions;
+  automaton->statePattern = statePattern;
+  automaton->outputLink = outputLink;
+  automaton->ownerOffsets = ownerOffsets;
+  automaton->owners = owners;
+}
+
+/**
+ Returns a literal that must appear in any line matched by the regex, or nil if one cannot be determined.
+ This is conservative: alternation, groups and classes all end the current literal, and anything inside a group is ignored.
+ Escapes that take arguments, such as \x41 or \u0041, and nested classes are not interpreted, so no literal is required for them.
+ */
+static NSString *FBCompiledLogSearchRequiredLiteral(NSString *pattern)
+{
+  if ([pattern rangeOfString:@"|"].location != NSNotFound || [pattern rangeOfString:@"(?"].location != NSNotFound) {
+    return nil;
+  }
+  NSMutableString *best = [NSMutableString string];
+  NSMutableString *current = [NSMutableString string];
+  NSUInteger depth = 0;
+  NSUInteger length = pattern.length;
+  void (^finishCurrent)(void) = ^{
+    if (current.length > best.length) {
+      [best setString:current];
+    }
+    [current setString:@""];
+  };
+  for (NSUInteger index = 0; index < length; index++) {
+    unichar character = [pattern characterAtIndex:index];
+    unichar next = index + 1 < length ? [pattern characterAtIndex:index + 1] : 0;
+    // A quantifier that allows zero repetitions makes the preceding character optional.
+    BOOL optional = next == '*' || next == '?' || next == '{';
+    BOOL repeated = next == '+';
+    unichar literal = 0;
+    if (character == '\\') {
+      if (next == 0 || next > 0x7f) {
+        return nil;
+      }
+      if (next == 'p' || next == 'P') {
+        // A property class such as \p{L} is skipped in full.
+        finishCurrent();
+        NSUInteger close = [pattern rangeOfString:@"}" options:0 range:NSMakeRange(index, length - index)].location;
+        if (index + 2 >= length || [pattern characterAtIndex:index + 2] != '{' || close == NSNotFound) {
+          return nil;
+        }
+        index = close;
+        continue;
+      }
+      if (isalnum(next)) {
+        // Only the single character classes and word boundaries are skipped, other escapes consume arguments that would otherwise be treated as literals.
+        if (strchr("dDwWsSbB", next) == NULL) {
+          return nil;
+        }
+        finishCurrent();
+        index++;
+        continue;
+      }
+      literal = next;
+      index++;
+      next = index + 1 < length ? [pattern characterAtIndex:index + 1] : 0;
+      optional = next == '*' || next == '?' || next == '{';
+      repeated = next == '+';
+    } else if (character == '(') {
+      finishCurrent();
+      depth++;
+      continue;
+    } else if (character == ')') {
+      finishCurrent();
+      depth = depth > 0 ? depth - 1 : 0;
+      continue;
+    } else if (character == '[') {
+      finishCurrent();
+      // Skip the class, including an escaped or leading ']'.
+      index++;
+      if (index < length && [pattern characterAtIndex:index] == '^') {
+        index++;
+      }
+      if (index < length && [pattern characterAtIndex:index] == ']') {
+        index++;
+      }
+      while (index < length && [pattern characterAtIndex:index] != ']') {
+        if ([pattern characterAtIndex:index] == '[') {
+          return nil;
+        }
+        if ([pattern characterAtIndex:index] == '\\') {
+          index++;
+        }
+        index++;
+      }
+      continue;
+    } else if (character == '{') {
+      // Skip the bounds of the quantifier.
+      finishCurrent();
+      while (index < length && [pattern characterAtIndex:index] != '}') {
+        index++;
+      }
+      continue;
+    } else if (strchr(".^$*+?}", character) != NULL || character > 0x7f) {
+      finishCurrent();
+      continue;
+    } else {
+      literal = character;
+    }
+    if (depth > 0) {
+      continue;
+    }
+    if (optional) {
+      finishCurrent();
+      continue;
+    }
+    [current appendFormat:@"%C", literal];
+    if (repeated) {
+      finishCurrent();
+    }
+  }
+  finishCurrent();
+  return best.length > 0 ? [best copy] : nil;
+}
+
+@interface FBCompiledLogSearch ()
+
+@property (nonatomic, assign, readonly) FBCompiledLogSearchAutomaton automaton;
+@property (nonatomic, copy, readonly) NSArray<NSArray<NSString *> *> *needles;
+@property (nonatomic, copy, readonly) NSIndexSet *regexPredicates;
+@property (nonatomic, copy, readonly) NSIndexSet *unfilteredPredicates;
+
+@end
+
+@implementation FBCompiledLogSearch
+
+#pragma mark Initializers
+
++ (instancetype)searchWithPredicates:(NSArray<FBLogSearchPredicate *> *)predicates
+{
+  return [[self alloc] initWithPredicates:predicates];
+}
+
+- (instancetype)initWithPredicates:(NSArray<FBLogSearchPredicate *> *)predicates
+{
+  self = [super init];
+  if (!self) {
+    return nil;
+  }
+
+  _predicates = [predicates copy];
+
+  // Identical patterns share a state in the automaton, so are de-duplicated, each recording all the predicates that own it.
+  NSMutableArray<NSData *> *patterns = [NSMutableArray array];
+  NSMutableArray<NSMutableArray<NSValue *> *> *patternOwners = [NSMutableArray array];
+  NSMutableDictionary<NSData *, NSNumber *> *patternIndices = [NSMutableDictionary dictionary];
+  NSMutableArray<NSArray<NSString *> *> *needles = [NSMutableArray array];
+  NSMutableIndexSet *regexPredicates = [NSMutableIndexSet indexSet];
+  NSMutableIndexSet *unfilteredPredicates = [NSMutableIndexSet indexSet];
+  void (^addPattern)(NSString *, uint32_t, uint32_t) = ^(NSString *string, uint32_t predicateIndex, uint32_t needleIndex) {
+    NSData *pattern = [string dataUsingEncoding:NSUTF8StringEncoding];
+    if (pattern.length == 0) {
+      return;
+    }
+    NSNumber *patternIndex = patternIndices[pattern];
+    if (!patternIndex) {
+      patternIndex = @(patterns.count);
+      patternIndices[pattern] = patternIndex;
+      [patterns addObject:pattern];
+      [patternOwners addObject:[NSMutableArray array]];
+    }
+    FBCompiledLogSearchOwner owner = {.predicate = predicateIndex, .needle = needleIndex};
+    [patternOwners[patternIndex.unsignedIntegerValue] addObject:[NSValue valueWithBytes:&owner objCType:@encode(FBCompiledLogSearchOwner)]];
+  };
+
+  for (NSUInteger predicateIndex = 0; predicateIndex < predicates.count; predicateIndex++) {
+    FBLogSearchPredicate *predicate = predicates[predicateIndex];
+    if ([predicate isKindOfClass:FBLogSearchPredicate_Substrings.class]) {
+      NSArray<NSString *> *substrings = [(FBLogSearchPredicate_Substrings *) predicate substrings];
+      [needles addObject:substrings];
+      for (NSUInteger needleIndex = 0; needleIndex < substrings.count; needleIndex++) {
+        addPattern(substrings[needleIndex], (uint32_t) predicateIndex, (uint32_t) needleIndex);
+      }
+      continue;
+    }
+    [needles addObject:@[]];
+    [regexPredicates addIndex:predicateIndex];
+    NSString *literal = FBCompiledLogSearchRequiredLiteral([(FBLogSearchPredicate_Regex *) predicate regularExpression].pattern);
+    if (literal) {
+      addPattern(literal, (uint32_t) predicateIndex, 0);
+    } else {
+      [unfilteredPredicates addIndex:predicateIndex];
+    }
+  }
+  _needles = [needles copy];
+  _regexPredicates = [regexPredicates copy];
+  _unfilteredPredicates = [unfilteredPredicates copy];
+  FBCompiledLogSearchAutomatonBuild(&_automaton, patterns, patternOwners);
+
+  return self;
+}
+
+- (void)dealloc
+{
+  FBCompiledLogSearchAutomatonFree(&_automaton);
+}
+
+#pragma mark Public API
+
+- (NSArray<NSArray<NSString *> *> *)matchesInData:(NSData *)data lines:(BOOL)lines first:(BOOL)first
+{
+  NSUInteger predicateCount = self.predicates.count;
+  if (predicateCount == 0) {
+    return @[];
+  }
+
+  // Split into chunks at line boundaries, so that each chunk can be searched independently.
+  const uint8_t *bytes = data.bytes;
+  NSUInteger length = data.length;
+  NSUInteger chunkCount = MAX(1u, MIN(NSProcessInfo.processInfo.activeProcessorCount * 4, length / FBCompiledLogSearchMinimumChunkLength));
+  NSMutableArray<NSValue *> *chunks = [NSMutableArray array];
+  NSUInteger chunkStart = 0;
+  for (NSUInteger index = 1; index <= chunkCount && chunkStart < length; index++) {
+    NSUInteger chunkEnd = index == chunkCount ? length : (length / chunkCount) * index;
+    if (chunkEnd < chunkStart) {
+      continue;
+    }
+    const uint8_t *newline = chunkEnd < length ? memchr(bytes + chunkEnd, '\n', length - chunkEnd) : NULL;
+    chunkEnd = newline ? (NSUInteger) (newline - bytes) + 1 : length;
+    [chunks addObject:[NSValue valueWithRange:NSMakeRange(chunkStart, chunkEnd - chunkStart)]];
+    chunkStart = chunkEnd;
+  }
+
+  NSMutableArray<NSArray<NSArray<NSString *> *> *> *chunkResults = [NSMutableArray array];
+  for (NSUInteger index = 0; index < chunks.count; index++) {
+    [chunkResults addObject:@[]];
+  }
+  dispatch_apply(chunks.count, DISPATCH_APPLY_AUTO, ^(size_t index) {
+    NSArray<NSArray<NSString *> *> *result = [self matchesInBytes:bytes range:chunks[index].rangeValue lines:lines first:first];
+    @synchronized (chunkResults) {
+      chunkResults[index] = result;
+    }
+  });
+
+  // Concatenate the chunks, preserving the order of lines.
+  NSMutableArray<NSArray<NSString *> *> *results = [NSMutableArray array];
+  for (NSUInteger predicateIndex = 0; predicateIndex < predicateCount; predicateIndex++) {
+    NSMutableArray<NSString *> *matches = [NSMutableArray array];
+    for (NSArray<NSArray<NSString *> *> *chunkResult in chunkResults) {
+      [matches addObjectsFromArray:chunkResult[predicateIndex]];
+      if (first && matches.count > 0) {
+        break;
+      }
+    }
+    [results addObject:[matches copy]];
+  }
+  return [results copy];
+}
+
+- (NSArray<NSArray<NSString *> *> *)matchesInDiagnostic:(FBDiagnostic *)diagnostic lines:(BOOL)lines first:(BOOL)first
+{
+  NSData *data = diagnostic.asSearchableData;
+  if (!data) {
+    NSMutableArray<NSArray<NSString *> *> *results = [NSMutableArray array];
+    for (NSUInteger index = 0; index < self.predicates.count; index++) {
+      [results addObject:@[]];
+    }
+    return [results copy];
+  }
+  return [self matchesInData:data lines:lines first:first];
+}
+
+#pragma mark Private
+
+static inline NSString *FBCompiledLogSearchLine(const uint8_t *bytes, NSUInteger start, NSUInteger end)
+{
+  // A line that is not valid UTF-8 is decoded as Latin-1, which accepts any bytes, so that it is not dropped from the results.
+  return [[NSString alloc] initWithBytes:bytes + start length:end - start encoding:NSUTF8StringEncoding]
+    ?: [[NSString alloc] initWithBytes:bytes + start length:end - start encoding:NSISOLatin1StringEncoding];
+}
+
+- (NSArray<NSArray<NSString *> *> *)matchesInBytes:(const uint8_t *)bytes range:(NSRange)range lines:(BOOL)outputLines first:(BOOL)first
+{
+  NSUInteger predicateCount = self.predicates.count;
+  NSArray<FBLogSearchPredicate *> *predicates = self.predicates;
+  NSArray<NSArray<NSString *> *> *needles = self.needles;
+  NSIndexSet *regexPredicates = self.regexPredicates;
+  NSIndexSet *unfilteredPredicates = self.unfilteredPredicates;
+  const FBCompiledLogSearchAutomaton automaton = self.automaton;
+
+  NSMutableArray<NSMutableArray<NSString *> *> *results = [NSMutableArray array];
+  for (NSUInteger index = 0; index < predicateCount; index++) {
+    [results addObject:[NSMutableArray array]];
+  }
+
+  // Per-line state. The best needle is the lowest index, as the first substring in a predicate takes precedence.
+  uint32_t *bestNeedle = malloc(predicateCount * sizeof(uint32_t));
+  uint32_t *touched = malloc(predicateCount * sizeof(uint32_t));
+  BOOL *finished = calloc(predicateCount, sizeof(BOOL));
+  NSUInteger touchedCount = 0;
+  NSUInteger finishedCount = 0;
+  for (NSUInteger index = 0; index < predicateCount; index++) {
+    bestNeedle[index] = UINT32_MAX;
+  }
+
+  void (^record)(NSUInteger, NSString *) = ^(NSUInteger predicateIndex, NSString *match) {
+    [results[predicateIndex] addObject:match];
+  };
+
+  uint32_t state = 0;
+  NSUInteger lineStart = range.location;
+  NSUInteger end = NSMaxRange(range);
+  for (NSUInteger index = range.location; index <= end; index++) {
+    // Line terminators are those of -[NSCharacterSet newlineCharacterSet]: \n, \v, \f, \r, NEL, LS and PS.
+    NSUInteger lineEnd = NSNotFound;
+    if (index == end) {
+      lineEnd = end;
+    } else {
+      uint8_t byte = bytes[index];
+      if (byte >= '\n' && byte <= '\r') {
+        lineEnd = index;
+      } else if (byte == 0x85 && index >= lineStart + 1 && bytes[index - 1] == 0xC2) {
+        lineEnd = index - 1;
+      } else if ((byte == 0xA8 || byte == 0xA9) && index >= lineStart + 2 && bytes[index - 1] == 0x80 && bytes[index - 2] == 0xE2) {
+        lineEnd = index - 2;
+      } else {
+        state = automaton.transitions[(state * automaton.classCount) + automaton.byteClass[byte]];
+        uint32_t output = automaton.statePattern[state] != FBCompiledLogSearchNoPattern ? state : automaton.outputLink[state];
+        while (output != 0) {
+          uint32_t pattern = (uint32_t) automaton.statePattern[output];
+          for (uint32_t ownerIndex = automaton.ownerOffsets[pattern]; ownerIndex < automaton.ownerOffsets[pattern + 1]; ownerIndex++) {
+            FBCompiledLogSearchOwner owner = automaton.owners[ownerIndex];
+            if (bestNeedle[owner.predicate] == UINT32_MAX) {
+              touched[touchedCount++] = owner.predicate;
+            }
+            bestNeedle[owner.predicate] = MIN(bestNeedle[owner.predicate], owner.needle);
+          }
+          output = automaton.outputLink[output];
+        }
+        continue;
+      }
+    }
+
+    // At the end of a line, resolve the predicates that the automaton flagged, and any regexes that could not be prefiltered.
+    if (lineEnd > lineStart) {
+      NSString *line = nil;
+      for (NSUInteger touchedIndex = 0; touchedIndex < touchedCount; touchedIndex++) {
+        uint32_t predicateIndex = touched[touchedIndex];
+        if (finished[predicateIndex]) {
+          continue;
+        }
+        NSString *match = nil;
+        if ([regexPredicates containsIndex:predicateIndex]) {
+          line = line ?: FBCompiledLogSearchLine(bytes, lineStart, lineEnd);
+          match = line ? [predicates[predicateIndex] match:line] : nil;
+        } else {
+          match = needles[predicateIndex][bestNeedle[predicateIndex]];
+        }
+        if (!match) {
+          continue;
+        }
+        if (outputLines) {
+          line = line ?: FBCompiledLogSearchLine(bytes, lineStart, lineEnd);
+          match = line;
+        }
+        if (!match) {
+          continue;
+        }
+        record(predicateIndex, match);
+        if (first) {
+          finished[predicateIndex] = YES;
+          finishedCount++;
+        }
+      }
+      for (NSUInteger predicateIndex = unfilteredPredicates.firstIndex; predicateIndex != NSNotFound; predicateIndex = [unfilteredPredicates indexGreaterThanIndex:predicateIndex]) {
+        if (finished[predicateIndex]) {
+          continue;
+        }
+        line = line ?: FBCompiledLogSearchLine(bytes, lineStart, lineEnd);
+        NSString *match = line ? [predicates[predicateIndex] match:line] : nil;
+        if (!match) {
+          continue;
+        }
+        record(predicateIndex, outputLines ? line : match);
+        if (first) {
+          finished[predicateIndex] = YES;
+          finishedCount++;
+        }
+      }
+    }
+    for (NSUInteger touchedIndex = 0; touchedIndex < touchedCount; touchedIndex++) {
+      bestNeedle[touched[touchedIndex]] = UINT32_MAX;
+    }
+    touchedCount = 0;
+    state = 0;
+    lineStart = index + 1;
+    if (first && finishedCount == predicateCount) {
+      break;
+    }
+  }
+
+  free(bestNeedle);
+  free(touched);
+  free(finished);
+  return [results copy];
 }
 
 @end
@@ -15,6 +15,7 @@ NS_ASSUME_NONNULL_BEGIN
 
 @class FBDiagnostic;
 @class FBDiagnosticBuilder;
+@class FBDiagnosticTail;
 
 /**
  The Name of the Video Log
@@ -50,6 +51,12 @@ extern FBDiagnosticName const FBDiagnosticNameScreenshot;
  */
 @property (nonatomic, copy, readonly) NSString *storageDirectory;
 
+/**
+ Remembers how far the file backed diagnostics of the target have been read.
+ Polling a growing log through the tail only reads the content appended since the last poll.
+ */
+@property (nonatomic, strong, readonly) FBDiagnosticTail *tail;
+
 /**
  The FBDiagnostic Instance from which all other diagnostics are derived.
  */
@@ -11,6 +11,7 @@
 
 #import "FBDiagnostic.h"
 #import "FBDiagnosticQuery.h"
+#import "FBDiagnosticTail.h"
 
 FBDiagnosticName const FBDiagnosticNameVideo = @"video";
 FBDiagnosticName const FBDiagnosticNameSyslog = @"system_log";
@@ -34,6 +35,7 @@ FBDiagnosticName const FBDiagnosticNameScreenshot = @"screenshot";
   }
 
   _storageDirectory = storageDirectory;
+  _tail = [FBDiagnosticTail tail];
   return self;
 }
 
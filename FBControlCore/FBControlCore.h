@@ -16,6 +16,7 @@
 #import <FBControlCore/FBApplicationInstallConfiguration.h>
 #import <FBControlCore/FBApplicationLaunchConfiguration.h>
 #import <FBControlCore/FBArchitecture.h>
+#import <FBControlCore/FBArchiveExtractionCache.h>
 #import <FBControlCore/FBASLParser.h>
 #import <FBControlCore/FBBatchLogSearch.h>
 #import <FBControlCore/FBBinaryDescriptor.h>
@@ -33,6 +34,7 @@
 #import <FBControlCore/FBControlCoreGlobalConfiguration.h>
 #import <FBControlCore/FBControlCoreLogger.h>
 #import <FBControlCore/FBCrashLogCommands.h>
+#import <FBControlCore/FBCrashLogIndex.h>
 #import <FBControlCore/FBCrashLogInfo.h>
 #import <FBControlCore/FBCrashLogNotifier.h>
 #import <FBControlCore/FBCrashLogStore.h>
@@ -41,9 +43,12 @@
 #import <FBControlCore/FBDebuggerCommands.h>
 #import <FBControlCore/FBDiagnostic.h>
 #import <FBControlCore/FBDiagnosticQuery.h>
+#import <FBControlCore/FBDiagnosticTail.h>
+#import <FBControlCore/FBDirectoryWatcher.h>
 #import <FBControlCore/FBDispatchSourceNotifier.h>
 #import <FBControlCore/FBEventConstants.h>
 #import <FBControlCore/FBEventInterpreter.h>
+#import <FBControlCore/FBEventJSONWriter.h>
 #import <FBControlCore/FBEventReporter.h>
 #import <FBControlCore/FBEventReporterSubject.h>
 #import <FBControlCore/FBFileFinder.h>
@@ -52,7 +57,9 @@
 #import <FBControlCore/FBFileWriter.h>
 #import <FBControlCore/FBFuture.h>
 #import <FBControlCore/FBFutureContextManager.h>
+#import <FBControlCore/FBFutureTracer.h>
 #import <FBControlCore/FBInstalledApplication.h>
+#import <FBControlCore/FBiOSActionFrame.h>
 #import <FBControlCore/FBiOSActionReader.h>
 #import <FBControlCore/FBiOSActionRouter.h>
 #import <FBControlCore/FBiOSTarget.h>
@@ -66,6 +73,7 @@
 #import <FBControlCore/FBiOSTargetSet.h>
 #import <FBControlCore/FBiOSTargetStateUpdate.h>
 #import <FBControlCore/FBJSONConversion.h>
+#import <FBControlCore/FBLaunchCtlServiceTable.h>
 #import <FBControlCore/FBLaunchedProcess.h>
 #import <FBControlCore/FBListApplicationsConfiguration.h>
 #import <FBControlCore/FBLocalizationOverride.h>
@@ -78,6 +86,7 @@
 #import <FBControlCore/FBProcessLaunchConfiguration.h>
 #import <FBControlCore/FBProcessOutputConfiguration.h>
 #import <FBControlCore/FBProcessStream.h>
+#import <FBControlCore/FBProcessTable.h>
 #import <FBControlCore/FBProcessTerminationStrategy.h>
 #import <FBControlCore/FBReportingiOSActionReaderDelegate.h>
 #import <FBControlCore/FBScale.h>
@@ -98,5 +107,6 @@
 #import <FBControlCore/FBXcodeConfiguration.h>
 #import <FBControlCore/FBXcodeDirectory.h>
 #import <FBControlCore/FBXCTestCommands.h>
+#import <FBControlCore/FBZipArchive.h>
 #import <FBControlCore/NSPredicate+FBControlCore.h>
 #import <FBControlCore/NSRunLoop+FBControlCore.h>
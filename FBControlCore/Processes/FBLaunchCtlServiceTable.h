@@ -0,0 +1,69 @@
+/**
+ * Copyright (c) 2015-present, Facebook, Inc.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree. An additional grant
+ * of patent rights can be found in the PATENTS file in the same directory.
+ */
+
+#import <Foundation/Foundation.h>
+
+NS_ASSUME_NONNULL_BEGIN
+
+/**
+ An immutable snapshot of the services known to launchd, parsed from the output of `launchctl list`.
+ The output is tokenized once, then Services can be looked up by name or by Process Identifier without parsing it again.
+ */
+@interface FBLaunchCtlServiceTable : NSObject
+
+#pragma mark Initializers
+
+/**
+ Parses the output of `launchctl list`.
+ Each line is of the form 'PID Status Label', where the PID and Status of a service that is not running are '-'.
+ A header line is ignored, as are empty lines.
+
+ @param output the output of `launchctl list`.
+ @param error an error out for a line that cannot be parsed.
+ @return a Service Table if the output could be parsed, nil otherwise.
+ */
++ (nullable instancetype)tableFromListOutput:(NSString *)output error:(NSError **)error;
+
+#pragma mark Properties
+
+/**
+ A Mapping of Service Name to Process Identifier.
+ NSNull is used to represent services that do not have a Process Identifier.
+ */
+@property (nonatomic, copy, readonly) NSDictionary<NSString *, id> *services;
+
+#pragma mark Queries
+
+/**
+ The Service Name of a running process.
+
+ @param processIdentifier the Process Identifier of the service.
+ @return the Service Name if there is a service with the Process Identifier, nil otherwise.
+ */
+- (nullable NSString *)serviceNameForProcessIdentifier:(pid_t)processIdentifier;
+
+/**
+ The Process Identifier of a service.
+
+ @param serviceName the name of the service.
+ @return the Process Identifier if the service is running, nil otherwise.
+ */
+- (nullable NSNumber *)processIdentifierForServiceName:(NSString *)serviceName;
+
+/**
+ The Services that contain a substring in their name.
+
+ @param substring the substring to search for.
+ @return a Mapping of Service Name to Process Identifier, where the Process Identifier is -1 for services that are not running.
+ */
+- (NSDictionary<NSString *, NSNumber *> *)serviceNamesAndProcessIdentifiersForSubstring:(NSString *)substring;
+
+@end
+
+NS_ASSUME_NONNULL_END
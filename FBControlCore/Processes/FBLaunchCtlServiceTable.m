@@ -0,0 +1,173 @@
+/**
+ * Copyright (c) 2015-present, Facebook, Inc.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree. An additional grant
+ * of patent rights can be found in the PATENTS file in the same directory.
+ */
+
+#import "FBLaunchCtlServiceTable.h"
+
+#include <string.h>
+
+#import "FBCollectionInformation.h"
+#import "FBControlCoreError.h"
+
+static BOOL FBLaunchCtlIsSpace(char character)
+{
+  return character == ' ' || character == '\t' || character == '\r';
+}
+
+/**
+ Reads a field that is either '-', for a value that is absent, or a decimal number.
+ The field must be followed by whitespace, the cursor is advanced to the start of the next field.
+ */
+static BOOL FBLaunchCtlReadNumericField(const char **cursor, const char *end, BOOL *isPresentOut, long long *valueOut)
+{
+  const char *position = *cursor;
+  BOOL isPresent = NO;
+  long long value = 0;
+  if (position < end && *position == '-' && (position + 1 == end || FBLaunchCtlIsSpace(position[1]))) {
+    position++;
+  } else {
+    BOOL isNegative = position < end && *position == '-';
+    if (isNegative) {
+      position++;
+    }
+    const char *digits = position;
+    while (position < end && *position >= '0' && *position <= '9' && position - digits < 18) {
+      value = (value * 10) + (*position - '0');
+      position++;
+    }
+    if (position == digits) {
+      return NO;
+    }
+    value = isNegative ? -value : value;
+    isPresent = YES;
+  }
+  if (position == end || !FBLaunchCtlIsSpace(*position)) {
+    return NO;
+  }
+  while (position < end && FBLaunchCtlIsSpace(*position)) {
+    position++;
+  }
+  *cursor = position;
+  *isPresentOut = isPresent;
+  *valueOut = value;
+  return YES;
+}
+
+@interface FBLaunchCtlServiceTable ()
+
+@property (nonatomic, copy, readonly) NSDictionary<NSNumber *, NSString *> *serviceNames;
+
+@end
+
+@implementation FBLaunchCtlServiceTable
+
+#pragma mark Initializers
+
++ (nullable instancetype)tableFromListOutput:(NSString *)output error:(NSError **)error
+{
+  NSData *data = [output dataUsingEncoding:NSUTF8StringEncoding];
+  const char *bytes = data.bytes;
+  const char *end = bytes + data.length;
+  NSMutableDictionary<NSString *, id> *services = [NSMutableDictionary dictionary];
+  NSMutableDictionary<NSNumber *, NSString *> *serviceNames = [NSMutableDictionary dictionary];
+
+  NSUInteger lineNumber = 0;
+  for (const char *line = bytes; line < end; ) {
+    const char *lineEnd = (const char *) memchr(line, '\n', (size_t) (end - line)) ?: end;
+    const char *cursor = line;
+    lineNumber++;
+    while (cursor < lineEnd && FBLaunchCtlIsSpace(*cursor)) {
+      cursor++;
+    }
+    // Empty lines and the 'PID Status Label' header are skipped.
+    if (cursor == lineEnd || (lineEnd - cursor >= 3 && memcmp(cursor, "PID", 3) == 0)) {
+      line = lineEnd + 1;
+      continue;
+    }
+
+    BOOL isRunning = NO;
+    BOOL hasStatus = NO;
+    long long processIdentifier = 0;
+    long long status = 0;
+    BOOL parsed = FBLaunchCtlReadNumericField(&cursor, lineEnd, &isRunning, &processIdentifier)
+      && FBLaunchCtlReadNumericField(&cursor, lineEnd, &hasStatus, &status);
+    // The Label is the remainder of the line.
+    const char *labelEnd = lineEnd;
+    while (labelEnd > cursor && FBLaunchCtlIsSpace(labelEnd[-1])) {
+      labelEnd--;
+    }
+    NSString *serviceName = (parsed && labelEnd > cursor)
+      ? [[NSString alloc] initWithBytes:cursor length:(NSUInteger) (labelEnd - cursor) encoding:NSUTF8StringEncoding]
+      : nil;
+    if (!serviceName || (isRunning && (processIdentifier < 1 || processIdentifier > INT_MAX))) {
+      NSString *text = [[NSString alloc] initWithBytes:line length:(NSUInteger) (lineEnd - line) encoding:NSUTF8StringEncoding];
+      return [[FBControlCoreError
+        describeFormat:@"Line %lu of launchctl output is not of the form 'PID Status Label': '%@'", (unsigned long) lineNumber, text]
+        fail:error];
+    }
+    if (isRunning) {
+      services[serviceName] = @((pid_t) processIdentifier);
+      serviceNames[@((pid_t) processIdentifier)] = serviceName;
+    } else {
+      services[serviceName] = NSNull.null;
+    }
+    line = lineEnd + 1;
+  }
+  return [[self alloc] initWithServices:services serviceNames:serviceNames];
+}
+
+- (instancetype)initWithServices:(NSDictionary<NSString *, id> *)services serviceNames:(NSDictionary<NSNumber *, NSString *> *)serviceNames
+{
+  self = [super init];
+  if (!self) {
+    return nil;
+  }
+
+  _services = [services copy];
+  _serviceNames = [serviceNames copy];
+
+  return self;
+}
+
+#pragma mark Queries
+
+- (nullable NSString *)serviceNameForProcessIdentifier:(pid_t)processIdentifier
+{
+  return self.serviceNames[@(processIdentifier)];
+}
+
+- (nullable NSNumber *)processIdentifierForServiceName:(NSString *)serviceName
+{
+  id processIdentifier = self.services[serviceName];
+  return [processIdentifier isKindOfClass:NSNumber.class] ? processIdentifier : nil;
+}
+
+- (NSDictionary<NSString *, NSNumber *> *)serviceNamesAndProcessIdentifiersForSubstring:(NSString *)substring
+{
+  NSMutableDictionary<NSString *, NSNumber *> *mapping = [NSMutableDictionary dictionary];
+  for (NSString *serviceName in self.services) {
+    if ([serviceName rangeOfString:substring].location == NSNotFound) {
+      continue;
+    }
+    mapping[serviceName] = [self processIdentifierForServiceName:serviceName] ?: @(-1);
+  }
+  return [mapping copy];
+}
+
+#pragma mark NSObject
+
+- (NSString *)description
+{
+  return [NSString stringWithFormat:
+    @"Services %lu | Running %@",
+    (unsigned long) self.services.count,
+    [FBCollectionInformation oneLineDescriptionFromArray:self.serviceNames.allValues]
+  ];
+}
+
+@end
@@ -10,6 +10,7 @@
 #import <Foundation/Foundation.h>
 
 @class FBProcessInfo;
+@class FBProcessTable;
 
 NS_ASSUME_NONNULL_BEGIN
 
@@ -38,6 +39,14 @@ NS_ASSUME_NONNULL_BEGIN
  */
 - (NSArray<FBProcessInfo *> *)subprocessesOf:(pid_t)parent;
 
+/**
+ Obtain the Process Identifiers of child processes, without fetching the info for each of them.
+
+ @param parent the Process Identifier to obtain the subprocesses of
+ @return an NSSet<NSNumber> of the Process Identifiers of the parent's child processes.
+ */
+- (NSSet<NSNumber *> *)subprocessIdentifiersOf:(pid_t)parent;
+
 /**
  A Query for returning processes with a given subtring in their launch path.
 
@@ -83,6 +92,25 @@ NS_ASSUME_NONNULL_BEGIN
  */
 - (pid_t)processWithOpenFileTo:(const char *)filePath;
 
+/**
+ Captures a snapshot of all of the Processes on the Host.
+ Each process is fetched once, so this is cheaper than making several of the other queries in succession.
+ The snapshot is retained, so that it can be re-used with `processTableWithMaximumAge:`.
+
+ @return a new Process Table.
+ */
+- (FBProcessTable *)processTable;
+
+/**
+ Returns the most recently captured Process Table, if it is no older than the maximum age.
+ Otherwise a new Process Table is captured.
+ This allows a number of queries that are made for the same update to share a single snapshot.
+
+ @param maximumAge the maximum age, in seconds, of a previously captured Process Table.
+ @return a Process Table.
+ */
+- (FBProcessTable *)processTableWithMaximumAge:(NSTimeInterval)maximumAge;
+
 @end
 
 NS_ASSUME_NONNULL_END
@@ -15,6 +15,7 @@
 #include <sys/sysctl.h>
 
 #import "FBProcessInfo.h"
+#import "FBProcessTable.h"
 
 #define PID_MAX 99999
 
@@ -68,7 +69,6 @@ static void IterateOpenFiles(pid_t *pidBuffer, size_t pidBufferSize, const char
 
 static inline FBProcessInfo *ProcessInfoForProcessIdentifier(pid_t processIdentifier, char *buffer, size_t bufferSize)
 {
-  // Much of the layout information here comes from libtop.c in Apple's top(1) Open Source implementation.
   int name[3] = {CTL_KERN, KERN_PROCARGS2, processIdentifier};
 
   size_t actualSize = bufferSize;
@@ -78,62 +78,7 @@ static inline FBProcessInfo *ProcessInfoForProcessIdentifier(pid_t processIdenti
   if (actualSize == 0) {
     return nil;
   }
-
-  // First Position is argc.
-  const char *startPosition = buffer;
-  const int argc = *startPosition;
-
-  // If argc isn't 1 or more, something is wrong
-  if (argc < 1) {
-    return nil;
-  }
-
-  // launch path starts above argc
-  char *currentPosition = (char *) startPosition + sizeof(int);
-  NSString *launchPath = [[NSString alloc] initWithCString:currentPosition encoding:NSASCIIStringEncoding];
-  currentPosition += strlen(currentPosition);
-  currentPosition += 1;
-
-  // Move through the padding to get to the the argv
-  while (*currentPosition == '\0') {
-    currentPosition++;
-  }
-
-  // Enumerate up to the value of argc
-  NSMutableArray *arguments = [NSMutableArray array];
-  for (int index = 0; index < argc; index++) {
-    // Create Objective-C String from current position.
-    NSString *argument = [[NSString alloc] initWithCString:currentPosition encoding:NSASCIIStringEncoding];
-    [arguments addObject:argument];
-
-    // Move the current string position passed the null-character.
-    currentPosition += strlen(currentPosition);
-    currentPosition += 1;
-  }
-
-  // Now the environment is here
-  NSMutableDictionary *environment = [NSMutableDictionary dictionary];
-  while (currentPosition != '\0') {
-    NSString *string = [[NSString alloc] initWithCString:currentPosition encoding:NSASCIIStringEncoding];
-    NSArray *tokens = [string componentsSeparatedByString:@"="];
-    // If we don't get 2 tokens, something is malformed.
-    if (tokens.count != 2) {
-      break;
-    }
-    environment[tokens[0]] = tokens[1];
-
-    // Move the current string position passed the null-character.
-    currentPosition += strlen(currentPosition);
-    currentPosition += 1;
-  }
-
-  FBProcessInfo *process = [[FBProcessInfo alloc]
-    initWithProcessIdentifier:processIdentifier
-    launchPath:launchPath
-    arguments:arguments
-    environment:environment];
-
-  return process;
+  return [FBProcessTable processInfoWithProcessIdentifier:processIdentifier procArgs:buffer length:actualSize];
 }
 
 static inline BOOL ProcInfoForProcessIdentifier(pid_t processIdentifier, struct kinfo_proc* procOut)
@@ -160,6 +105,9 @@ static BOOL ProcessNameForProcessIdentifier(pid_t processIdentifier, char *buffe
 @property (nonatomic, assign, readonly) size_t pidBufferSize;
 @property (nonatomic, assign, readonly) pid_t *pidBuffer;
 
+@property (nonatomic, strong, nullable, readwrite) FBProcessTable *lastProcessTable;
+@property (nonatomic, assign, readwrite) CFAbsoluteTime lastProcessTableTime;
+
 @end
 
 @implementation FBProcessFetcher
@@ -214,6 +162,18 @@ static BOOL ProcessNameForProcessIdentifier(pid_t processIdentifier, char *buffe
   return [subprocesses copy];
 }
 
+- (NSSet<NSNumber *> *)subprocessIdentifiersOf:(pid_t)parent
+{
+  NSMutableSet<NSNumber *> *processIdentifiers = [NSMutableSet set];
+
+  IterateSubprocessesOf(self.pidBuffer, self.pidBufferSize, parent, ^ BOOL (pid_t pid) {
+    [processIdentifiers addObject:@(pid)];
+    return YES;
+  });
+
+  return [processIdentifiers copy];
+}
+
 - (NSArray<FBProcessInfo *> *)processesWithLaunchPathSubstring:(NSString *)substring
 {
   NSMutableArray *subprocesses = [NSMutableArray array];
@@ -299,4 +259,50 @@ static BOOL ProcessNameForProcessIdentifier(pid_t processIdentifier, char *buffe
   return proc.kp_eproc.e_ppid;
 }
 
+#pragma mark Process Table
+
+- (FBProcessTable *)processTable
+{
+  NSMutableArray<FBProcessInfo *> *processes = [NSMutableArray array];
+  NSMutableDictionary<NSNumber *, NSNumber *> *parents = [NSMutableDictionary dictionary];
+  NSMutableDictionary<NSNumber *, NSString *> *names = [NSMutableDictionary dictionary];
+
+  IterateAllProcesses(self.pidBuffer, self.pidBufferSize, ^ BOOL (pid_t pid) {
+    FBProcessInfo *info = [self processInfoFor:pid];
+    if (!info) {
+      return YES;
+    }
+    [processes addObject:info];
+    // The parent and the name are obtained in the same call, which is far cheaper than fetching the arguments.
+    struct proc_bsdinfo bsdInfo;
+    if (proc_pidinfo(pid, PROC_PIDTBSDINFO, 0, &bsdInfo, PROC_PIDTBSDINFO_SIZE) != PROC_PIDTBSDINFO_SIZE) {
+      return YES;
+    }
+    NSNumber *processIdentifier = @(pid);
+    parents[processIdentifier] = @(bsdInfo.pbi_ppid);
+    const char *name = strlen(bsdInfo.pbi_name) > 0 ? bsdInfo.pbi_name : bsdInfo.pbi_comm;
+    names[processIdentifier] = [NSString stringWithUTF8String:name] ?: info.processName;
+    return YES;
+  });
+
+  FBProcessTable *table = [FBProcessTable tableWithProcesses:processes parents:parents names:names];
+  // The table and the time it was created are read together, so they are updated together.
+  @synchronized (self) {
+    self.lastProcessTable = table;
+    self.lastProcessTableTime = CFAbsoluteTimeGetCurrent();
+  }
+  return table;
+}
+
+- (FBProcessTable *)processTableWithMaximumAge:(NSTimeInterval)maximumAge
+{
+  @synchronized (self) {
+    FBProcessTable *table = self.lastProcessTable;
+    if (table && CFAbsoluteTimeGetCurrent() - self.lastProcessTableTime <= maximumAge) {
+      return table;
+    }
+  }
+  return [self processTable];
+}
+
 @end
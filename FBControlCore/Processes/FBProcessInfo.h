@@ -31,6 +31,18 @@ NS_ASSUME_NONNULL_BEGIN
  */
 - (instancetype)initWithProcessIdentifier:(pid_t)processIdentifier launchPath:(NSString *)launchPath arguments:(NSArray<NSString *> *)arguments environment:(NSDictionary<NSString *, NSString *> *)environment;
 
+/**
+ Constructs Process Info from the raw NUL-terminated strings of a process.
+ The arguments and environment are decoded when they are first accessed, rather than upfront.
+
+ @param processIdentifier the process identifer.
+ @param launchPath the path of the binary that the process was launched with.
+ @param strings a buffer of NUL-terminated strings.
+ @param argumentRange the range of the buffer containing the arguments.
+ @param environmentRange the range of the buffer containing the 'KEY=VALUE' environment strings.
+ */
+- (instancetype)initWithProcessIdentifier:(pid_t)processIdentifier launchPath:(NSString *)launchPath strings:(NSData *)strings argumentRange:(NSRange)argumentRange environmentRange:(NSRange)environmentRange;
+
 /**
  The Process Identifier for the running process
  */
@@ -56,6 +68,15 @@ NS_ASSUME_NONNULL_BEGIN
  */
 @property (nonatomic, copy, readonly) NSDictionary<NSString *, NSString *> *environment;
 
+/**
+ The value of a single environment variable of the process.
+ This does not decode the rest of the environment, so is cheaper than looking up a key in `environment`.
+
+ @param key the environment variable.
+ @return the value of the environment variable, nil if it is not present.
+ */
+- (nullable NSString *)environmentValueForKey:(NSString *)key;
+
 @end
 
 NS_ASSUME_NONNULL_END
@@ -9,6 +9,38 @@
 
 #import "FBProcessInfo.h"
 
+#include <string.h>
+
+static NSString *FBProcessInfoDecodeString(const char *bytes, size_t length)
+{
+  NSString *string = [[NSString alloc] initWithBytes:bytes length:length encoding:NSUTF8StringEncoding];
+  return string ?: [[NSString alloc] initWithBytes:bytes length:length encoding:NSISOLatin1StringEncoding];
+}
+
+static NSArray<NSString *> *FBProcessInfoDecodeStrings(const char *position, const char *end, BOOL stopAtEmpty)
+{
+  // A trailing string without a terminator runs to the end.
+  NSMutableArray<NSString *> *strings = [NSMutableArray array];
+  while (position < end) {
+    const char *terminator = memchr(position, '\0', (size_t) (end - position)) ?: end;
+    size_t length = (size_t) (terminator - position);
+    if (length == 0 && stopAtEmpty) {
+      break;
+    }
+    [strings addObject:FBProcessInfoDecodeString(position, length)];
+    position = terminator + 1;
+  }
+  return [strings copy];
+}
+
+@interface FBProcessInfo ()
+
+@property (nonatomic, copy, readonly) NSData *strings;
+@property (nonatomic, assign, readonly) NSRange argumentRange;
+@property (nonatomic, assign, readonly) NSRange environmentRange;
+
+@end
+
 @implementation FBProcessInfo
 
 @synthesize launchPath = _launchPath;
@@ -36,9 +68,30 @@
   return self;
 }
 
+- (instancetype)initWithProcessIdentifier:(pid_t)processIdentifier launchPath:(NSString *)launchPath strings:(NSData *)strings argumentRange:(NSRange)argumentRange environmentRange:(NSRange)environmentRange
+{
+  NSParameterAssert(launchPath);
+  NSParameterAssert(strings);
+  NSParameterAssert(NSMaxRange(argumentRange) <= strings.length);
+  NSParameterAssert(NSMaxRange(environmentRange) <= strings.length);
+
+  self = [super init];
+  if (!self) {
+    return nil;
+  }
+
+  _processIdentifier = processIdentifier;
+  _launchPath = launchPath;
+  _strings = strings;
+  _argumentRange = argumentRange;
+  _environmentRange = environmentRange;
+  return self;
+}
+
 - (NSUInteger)hash
 {
-  return ((unsigned long) self.processIdentifier) ^ self.launchPath.hash ^ self.arguments.hash;
+  // The arguments are not hashed, so that hashing does not require them to be decoded.
+  return ((unsigned long) self.processIdentifier) ^ self.launchPath.hash;
 }
 
 - (BOOL)isEqual:(FBProcessInfo *)object
@@ -46,13 +99,82 @@
   if (![object isKindOfClass:self.class]) {
     return NO;
   }
-  return self.processIdentifier == object.processIdentifier &&
-         [self.launchPath isEqual:object.launchPath] &&
-         [self.arguments isEqual:object.arguments];
+  if (self.processIdentifier != object.processIdentifier || ![self.launchPath isEqual:object.launchPath]) {
+    return NO;
+  }
+  // When both are undecoded, the raw arguments can be compared instead.
+  NSData *strings = self.strings;
+  NSData *otherStrings = object.strings;
+  if (strings && otherStrings) {
+    NSRange range = self.argumentRange;
+    NSRange otherRange = object.argumentRange;
+    return range.length == otherRange.length && memcmp((const char *) strings.bytes + range.location, (const char *) otherStrings.bytes + otherRange.location, range.length) == 0;
+  }
+  return [self.arguments isEqual:object.arguments];
 }
 
 #pragma mark Accessors
 
+- (NSArray<NSString *> *)arguments
+{
+  @synchronized (self) {
+    if (!_arguments) {
+      const char *bytes = (const char *) self.strings.bytes;
+      NSRange range = self.argumentRange;
+      _arguments = FBProcessInfoDecodeStrings(bytes + range.location, bytes + NSMaxRange(range), NO);
+    }
+    return _arguments;
+  }
+}
+
+- (NSDictionary<NSString *, NSString *> *)environment
+{
+  @synchronized (self) {
+    if (!_environment) {
+      const char *bytes = (const char *) self.strings.bytes;
+      NSRange range = self.environmentRange;
+      NSArray<NSString *> *strings = FBProcessInfoDecodeStrings(bytes + range.location, bytes + NSMaxRange(range), YES);
+      NSMutableDictionary<NSString *, NSString *> *environment = [NSMutableDictionary dictionaryWithCapacity:strings.count];
+      for (NSString *string in strings) {
+        // Values may contain '=', so only the first one separates the key from the value.
+        NSRange separator = [string rangeOfString:@"="];
+        if (separator.location == NSNotFound || separator.location == 0) {
+          continue;
+        }
+        environment[[string substringToIndex:separator.location]] = [string substringFromIndex:NSMaxRange(separator)];
+      }
+      _environment = [environment copy];
+    }
+    return _environment;
+  }
+}
+
+- (nullable NSString *)environmentValueForKey:(NSString *)key
+{
+  NSData *strings = self.strings;
+  if (!strings) {
+    return self.environment[key];
+  }
+
+  // Find the 'KEY=' prefix in the raw strings, decoding only the value.
+  const char *needle = key.UTF8String;
+  size_t needleLength = strlen(needle);
+  const char *position = (const char *) strings.bytes + self.environmentRange.location;
+  const char *end = (const char *) strings.bytes + NSMaxRange(self.environmentRange);
+  while (position < end) {
+    const char *terminator = memchr(position, '\0', (size_t) (end - position)) ?: end;
+    size_t length = (size_t) (terminator - position);
+    if (length == 0) {
+      break;
+    }
+    if (length > needleLength && position[needleLength] == '=' && memcmp(position, needle, needleLength) == 0) {
+      return FBProcessInfoDecodeString(position + needleLength + 1, length - needleLength - 1);
+    }
+    position = terminator + 1;
+  }
+  return nil;
+}
+
 - (NSString *)processName
 {
   // This should be fetched from sysctl/libproc instead.
@@ -90,7 +212,8 @@
 
 - (instancetype)copyWithZone:(NSZone *)zone
 {
-  return [[self.class alloc] initWithProcessIdentifier:self.processIdentifier launchPath:self.launchPath arguments:self.arguments environment:self.environment];
+  // Process Info is immutable.
+  return self;
 }
 
 #pragma mark FBJSONSerializable
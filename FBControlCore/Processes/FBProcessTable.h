@@ -0,0 +1,151 @@
+/**
+ * Copyright (c) 2015-present, Facebook, Inc.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree. An additional grant
+ * of patent rights can be found in the PATENTS file in the same directory.
+ */
+
+#import <Foundation/Foundation.h>
+
+@class FBProcessInfo;
+
+NS_ASSUME_NONNULL_BEGIN
+
+/**
+ The Processes that have started and exited between two Process Tables.
+ */
+@interface FBProcessTableChanges : NSObject
+
+/**
+ The Processes that are present in the newer table, but not the older one.
+ */
+@property (nonatomic, copy, readonly) NSArray<FBProcessInfo *> *started;
+
+/**
+ The Processes that are present in the older table, but not the newer one.
+ A Process Identifier that has been re-used by a different process is reported as both exited and started.
+ */
+@property (nonatomic, copy, readonly) NSArray<FBProcessInfo *> *exited;
+
+@end
+
+/**
+ An immutable snapshot of the Processes running on the Host.
+ The Process Table is captured once, then any number of queries can be made against it without further syscalls.
+ */
+@interface FBProcessTable : NSObject
+
+#pragma mark Initializers
+
+/**
+ Constructs a Process Table from Process Info.
+
+ @param processes the processes in the table.
+ @param parents a mapping of Process Identifier to Parent Process Identifier.
+ @param names a mapping of Process Identifier to the name of the process, as known to the kernel. Processes without a name use -[FBProcessInfo processName].
+ @return a new Process Table.
+ */
++ (instancetype)tableWithProcesses:(NSArray<FBProcessInfo *> *)processes parents:(NSDictionary<NSNumber *, NSNumber *> *)parents names:(NSDictionary<NSNumber *, NSString *> *)names;
+
+/**
+ Captures a Process Table from a procfs(5) mount.
+ Processes without a command line, such as kernel threads and zombies, are not included.
+ The environment of processes that cannot be read, such as those belonging to other users, is empty.
+
+ @param path the path of the proc filesystem, normally '/proc'.
+ @param error an error out for any error that occurs.
+ @return a new Process Table, nil if the proc filesystem could not be read.
+ */
++ (nullable instancetype)tableFromProcFilesystemAtPath:(NSString *)path error:(NSError **)error;
+
+#pragma mark Parsing
+
+/**
+ Parses the KERN_PROCARGS2 layout of a process: argc, then the launch path, argv and the environment as NUL-terminated strings.
+ Parsing is bounded by the length of the buffer, so truncated input does not read beyond it.
+
+ @param processIdentifier the process identifier of the process.
+ @param buffer the buffer to parse.
+ @param length the length of the buffer.
+ @return the Process Info if the buffer could be parsed, nil otherwise.
+ */
++ (nullable FBProcessInfo *)processInfoWithProcessIdentifier:(pid_t)processIdentifier procArgs:(const char *)buffer length:(size_t)length;
+
+#pragma mark Properties
+
+/**
+ All of the processes in the table, ordered by Process Identifier.
+ */
+@property (nonatomic, copy, readonly) NSArray<FBProcessInfo *> *processes;
+
+#pragma mark Queries
+
+/**
+ The Process Info for a given Process Identifier.
+
+ @param processIdentifier the Process Identifier to obtain process info for.
+ @return an FBProcessInfo object if a process with the given identifier is in the table, nil otherwise.
+ */
+- (nullable FBProcessInfo *)processInfoFor:(pid_t)processIdentifier;
+
+/**
+ The Processes with a given name.
+
+ @param processName the name of the processes.
+ @return an NSArray<FBProcessInfo> of the found processes.
+ */
+- (NSArray<FBProcessInfo *> *)processesWithProcessName:(NSString *)processName;
+
+/**
+ The Processes with a given launch path.
+
+ @param launchPath the launch path of the processes.
+ @return an NSArray<FBProcessInfo> of the found processes.
+ */
+- (NSArray<FBProcessInfo *> *)processesWithLaunchPath:(NSString *)launchPath;
+
+/**
+ The Processes with a given substring in their launch path.
+
+ @param substring the substring that must exist in the launch path.
+ @return an NSArray<FBProcessInfo> of the found processes.
+ */
+- (NSArray<FBProcessInfo *> *)processesWithLaunchPathSubstring:(NSString *)substring;
+
+/**
+ The Processes that have a given key in their environment.
+
+ @param key the environment key.
+ @return an NSArray<FBProcessInfo> of the found processes.
+ */
+- (NSArray<FBProcessInfo *> *)processesWithEnvironmentKey:(NSString *)key;
+
+/**
+ The child processes of a given process.
+
+ @param parent the Process Identifier of the parent.
+ @return an NSArray<FBProcessInfo> of the parent's child processes.
+ */
+- (NSArray<FBProcessInfo *> *)subprocessesOf:(pid_t)parent;
+
+/**
+ The parent of a given process.
+
+ @param child the Process Identifier of the child process.
+ @return a Process Identifier of the parent process if the child is in the table, -1 otherwise.
+ */
+- (pid_t)parentOf:(pid_t)child;
+
+/**
+ The Processes that have started and exited since a previous Process Table.
+
+ @param previous the older Process Table.
+ @return the changes between the tables.
+ */
+- (FBProcessTableChanges *)changesSince:(FBProcessTable *)previous;
+
+@end
+
+NS_ASSUME_NONNULL_END
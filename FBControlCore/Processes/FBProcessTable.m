@@ -0,0 +1,362 @@
+/**
+ * Copyright (c) 2015-present, Facebook, Inc.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree. An additional grant
+ * of patent rights can be found in the PATENTS file in the same directory.
+ */
+
+#import "FBProcessTable.h"
+
+#include <stdio.h>
+#include <string.h>
+
+#import "FBControlCoreError.h"
+#import "FBProcessInfo.h"
+
+#pragma mark Parsing
+
+static NSString *FBProcessTableDecodeString(const char *bytes, size_t length)
+{
+  NSString *string = [[NSString alloc] initWithBytes:bytes length:length encoding:NSUTF8StringEncoding];
+  return string ?: [[NSString alloc] initWithBytes:bytes length:length encoding:NSISOLatin1StringEncoding];
+}
+
+static const char *FBProcessTableSkipStrings(const char *position, const char *end, NSUInteger limit, BOOL stopAtEmpty, NSUInteger *countOut)
+{
+  // Skips NUL-terminated strings until the limit or the end of the buffer, without decoding them.
+  NSUInteger count = 0;
+  while (position < end && count < limit) {
+    const char *terminator = memchr(position, '\0', (size_t) (end - position)) ?: end;
+    if (terminator == position && stopAtEmpty) {
+      break;
+    }
+    count++;
+    position = terminator < end ? terminator + 1 : end;
+  }
+  if (countOut) {
+    *countOut = count;
+  }
+  return position;
+}
+
+static NSData *FBProcessTableReadFile(NSString *path)
+{
+  // Files in procfs report a size of zero, so they are read until EOF rather than mapped.
+  return [NSData dataWithContentsOfFile:path options:NSDataReadingUncached error:nil];
+}
+
+static BOOL FBProcessTableParseStat(NSData *data, pid_t *parentOut, NSString **nameOut)
+{
+  // The name is in parentheses and may itself contain spaces and parentheses, so the last ')' terminates it.
+  const char *bytes = data.bytes;
+  const char *end = bytes + data.length;
+  const char *open = memchr(bytes, '(', data.length);
+  const char *close = NULL;
+  for (const char *position = end; position > bytes; position--) {
+    if (position[-1] == ')') {
+      close = position - 1;
+      break;
+    }
+  }
+  if (!open || !close || close < open) {
+    return NO;
+  }
+  char remainder[64] = {0};
+  memcpy(remainder, close + 1, MIN((size_t) (end - close - 1), sizeof(remainder) - 1));
+  char state = 0;
+  int parent = 0;
+  if (sscanf(remainder, " %c %d", &state, &parent) != 2) {
+    return NO;
+  }
+  *parentOut = parent;
+  *nameOut = FBProcessTableDecodeString(open + 1, (size_t) (close - open - 1));
+  return YES;
+}
+
+@implementation FBProcessTableChanges
+
+- (instancetype)initWithStarted:(NSArray<FBProcessInfo *> *)started exited:(NSArray<FBProcessInfo *> *)exited
+{
+  self = [super init];
+  if (!self) {
+    return nil;
+  }
+
+  _started = started;
+  _exited = exited;
+
+  return self;
+}
+
+- (NSString *)description
+{
+  return [NSString stringWithFormat:@"Started %@ | Exited %@", self.started, self.exited];
+}
+
+@end
+
+@interface FBProcessTable ()
+
+@property (nonatomic, copy, readonly) NSDictionary<NSNumber *, FBProcessInfo *> *processesByIdentifier;
+@property (nonatomic, copy, readonly) NSDictionary<NSNumber *, NSNumber *> *parents;
+@property (nonatomic, copy, readonly) NSDictionary<NSString *, NSArray<FBProcessInfo *> *> *processesByName;
+@property (nonatomic, copy, readonly) NSDictionary<NSString *, NSArray<FBProcessInfo *> *> *processesByLaunchPath;
+@property (nonatomic, strong, readonly) NSMutableDictionary<NSString *, NSArray<FBProcessInfo *> *> *processesByEnvironmentKey;
+@property (nonatomic, copy, readonly) NSDictionary<NSNumber *, NSArray<FBProcessInfo *> *> *processesByParent;
+
+@end
+
+@implementation FBProcessTable
+
+#pragma mark Initializers
+
++ (instancetype)tableWithProcesses:(NSArray<FBProcessInfo *> *)processes parents:(NSDictionary<NSNumber *, NSNumber *> *)parents names:(NSDictionary<NSNumber *, NSString *> *)names
+{
+  return [[self alloc] initWithProcesses:processes parents:parents names:names];
+}
+
++ (nullable instancetype)tableFromProcFilesystemAtPath:(NSString *)path error:(NSError **)error
+{
+  NSError *innerError = nil;
+  NSArray<NSString *> *entries = [NSFileManager.defaultManager contentsOfDirectoryAtPath:path error:&innerError];
+  if (!entries) {
+    return [[[FBControlCoreError
+      describeFormat:@"Could not list the proc filesystem at %@", path]
+      causedBy:innerError]
+      fail:error];
+  }
+
+  NSCharacterSet *nonDigits = NSCharacterSet.decimalDigitCharacterSet.invertedSet;
+  NSMutableArray<FBProcessInfo *> *processes = [NSMutableArray arrayWithCapacity:entries.count];
+  NSMutableDictionary<NSNumber *, NSNumber *> *parents = [NSMutableDictionary dictionaryWithCapacity:entries.count];
+  NSMutableDictionary<NSNumber *, NSString *> *names = [NSMutableDictionary dictionaryWithCapacity:entries.count];
+  for (NSString *entry in entries) {
+    if ([entry rangeOfCharacterFromSet:nonDigits].location != NSNotFound) {
+      continue;
+    }
+    pid_t processIdentifier = (pid_t) entry.intValue;
+    NSString *directory = [path stringByAppendingPathComponent:entry];
+
+    // The process may exit whilst it is being read, in which case it is not included.
+    pid_t parent = 0;
+    NSString *name = nil;
+    NSData *stat = FBProcessTableReadFile([directory stringByAppendingPathComponent:@"stat"]);
+    if (!stat || !FBProcessTableParseStat(stat, &parent, &name)) {
+      continue;
+    }
+    NSData *commandLine = FBProcessTableReadFile([directory stringByAppendingPathComponent:@"cmdline"]);
+    if (commandLine.length == 0) {
+      continue;
+    }
+    NSData *environment = FBProcessTableReadFile([directory stringByAppendingPathComponent:@"environ"]);
+    NSMutableData *strings = [commandLine mutableCopy];
+    if (((const char *) commandLine.bytes)[commandLine.length - 1] != '\0') {
+      [strings appendBytes:"\0" length:1];
+    }
+    NSRange argumentRange = NSMakeRange(0, strings.length);
+    [strings appendData:environment ?: NSData.data];
+    NSRange environmentRange = NSMakeRange(argumentRange.length, strings.length - argumentRange.length);
+
+    NSString *launchPath = [NSFileManager.defaultManager destinationOfSymbolicLinkAtPath:[directory stringByAppendingPathComponent:@"exe"] error:nil];
+    if (!launchPath) {
+      launchPath = FBProcessTableDecodeString(strings.bytes, strlen(strings.bytes));
+    }
+
+    [processes addObject:[[FBProcessInfo alloc]
+      initWithProcessIdentifier:processIdentifier
+      launchPath:launchPath
+      strings:strings
+      argumentRange:argumentRange
+      environmentRange:environmentRange]];
+    parents[@(processIdentifier)] = @(parent);
+    names[@(processIdentifier)] = name;
+  }
+  return [self tableWithProcesses:processes parents:parents names:names];
+}
+
+- (instancetype)initWithProcesses:(NSArray<FBProcessInfo *> *)processes parents:(NSDictionary<NSNumber *, NSNumber *> *)parents names:(NSDictionary<NSNumber *, NSString *> *)names
+{
+  self = [super init];
+  if (!self) {
+    return nil;
+  }
+
+  _processes = [processes sortedArrayUsingComparator:^ NSComparisonResult (FBProcessInfo *left, FBProcessInfo *right) {
+    return left.processIdentifier < right.processIdentifier ? NSOrderedAscending : (left.processIdentifier > right.processIdentifier ? NSOrderedDescending : NSOrderedSame);
+  }];
+  _parents = [parents copy];
+
+  // The indexes are built in a single pass, the queries are then lookups.
+  NSMutableDictionary<NSNumber *, FBProcessInfo *> *processesByIdentifier = [NSMutableDictionary dictionaryWithCapacity:processes.count];
+  NSMutableDictionary<NSString *, NSMutableArray<FBProcessInfo *> *> *processesByName = [NSMutableDictionary dictionary];
+  NSMutableDictionary<NSString *, NSMutableArray<FBProcessInfo *> *> *processesByLaunchPath = [NSMutableDictionary dictionary];
+  NSMutableDictionary<NSNumber *, NSMutableArray<FBProcessInfo *> *> *processesByParent = [NSMutableDictionary dictionary];
+  for (FBProcessInfo *process in _processes) {
+    NSNumber *processIdentifier = @(process.processIdentifier);
+    processesByIdentifier[processIdentifier] = process;
+    [FBProcessTable index:processesByName key:names[processIdentifier] ?: process.processName process:process];
+    [FBProcessTable index:processesByLaunchPath key:process.launchPath process:process];
+    NSNumber *parent = parents[processIdentifier];
+    if (parent) {
+      [FBProcessTable index:processesByParent key:parent process:process];
+    }
+  }
+  _processesByIdentifier = [processesByIdentifier copy];
+  _processesByName = [processesByName copy];
+  _processesByLaunchPath = [processesByLaunchPath copy];
+  // The environment is only indexed for the keys that are queried, so that environments are not decoded upfront.
+  _processesByEnvironmentKey = [NSMutableDictionary dictionary];
+  _processesByParent = [processesByParent copy];
+
+  return self;
+}
+
+#pragma mark Parsing
+
++ (nullable FBProcessInfo *)processInfoWithProcessIdentifier:(pid_t)processIdentifier procArgs:(const char *)buffer length:(size_t)length
+{
+  // Much of the layout information here comes from libtop.c in Apple's top(1) Open Source implementation.
+  if (length < sizeof(int)) {
+    return nil;
+  }
+  int argc = 0;
+  memcpy(&argc, buffer, sizeof(int));
+  // If argc isn't 1 or more, something is wrong
+  if (argc < 1) {
+    return nil;
+  }
+  const char *position = buffer + sizeof(int);
+  const char *end = buffer + length;
+
+  // The launch path comes first, followed by padding to get to argv.
+  const char *launchPathEnd = memchr(position, '\0', (size_t) (end - position));
+  if (!launchPathEnd) {
+    return nil;
+  }
+  NSString *launchPath = FBProcessTableDecodeString(position, (size_t) (launchPathEnd - position));
+  position = launchPathEnd + 1;
+  while (position < end && *position == '\0') {
+    position++;
+  }
+
+  // Only the bounds of the arguments and environment are found, they are decoded by FBProcessInfo when used.
+  const char *argumentStart = position;
+  NSUInteger count = 0;
+  position = FBProcessTableSkipStrings(position, end, (NSUInteger) argc, NO, &count);
+  if (count != (NSUInteger) argc) {
+    return nil;
+  }
+  // The environment is terminated by an empty string.
+  const char *environmentStart = position;
+  const char *environmentEnd = FBProcessTableSkipStrings(position, end, NSUIntegerMax, YES, NULL);
+
+  NSData *strings = [NSData dataWithBytes:argumentStart length:(NSUInteger) (environmentEnd - argumentStart)];
+  return [[FBProcessInfo alloc]
+    initWithProcessIdentifier:processIdentifier
+    launchPath:launchPath
+    strings:strings
+    argumentRange:NSMakeRange(0, (NSUInteger) (environmentStart - argumentStart))
+    environmentRange:NSMakeRange((NSUInteger) (environmentStart - argumentStart), (NSUInteger) (environmentEnd - environmentStart))];
+}
+
+#pragma mark Queries
+
+- (nullable FBProcessInfo *)processInfoFor:(pid_t)processIdentifier
+{
+  return self.processesByIdentifier[@(processIdentifier)];
+}
+
+- (NSArray<FBProcessInfo *> *)processesWithProcessName:(NSString *)processName
+{
+  return self.processesByName[processName] ?: @[];
+}
+
+- (NSArray<FBProcessInfo *> *)processesWithLaunchPath:(NSString *)launchPath
+{
+  return self.processesByLaunchPath[launchPath] ?: @[];
+}
+
+- (NSArray<FBProcessInfo *> *)processesWithLaunchPathSubstring:(NSString *)substring
+{
+  NSMutableArray<FBProcessInfo *> *processes = [NSMutableArray array];
+  for (NSString *launchPath in self.processesByLaunchPath) {
+    if ([launchPath rangeOfString:substring].location == NSNotFound) {
+      continue;
+    }
+    [processes addObjectsFromArray:self.processesByLaunchPath[launchPath]];
+  }
+  return [processes sortedArrayUsingComparator:^ NSComparisonResult (FBProcessInfo *left, FBProcessInfo *right) {
+    return left.processIdentifier < right.processIdentifier ? NSOrderedAscending : (left.processIdentifier > right.processIdentifier ? NSOrderedDescending : NSOrderedSame);
+  }];
+}
+
+- (NSArray<FBProcessInfo *> *)processesWithEnvironmentKey:(NSString *)key
+{
+  @synchronized (self.processesByEnvironmentKey) {
+    NSArray<FBProcessInfo *> *processes = self.processesByEnvironmentKey[key];
+    if (processes) {
+      return processes;
+    }
+    NSMutableArray<FBProcessInfo *> *found = [NSMutableArray array];
+    for (FBProcessInfo *process in self.processes) {
+      if ([process environmentValueForKey:key]) {
+        [found addObject:process];
+      }
+    }
+    processes = [found copy];
+    self.processesByEnvironmentKey[key] = processes;
+    return processes;
+  }
+}
+
+- (NSArray<FBProcessInfo *> *)subprocessesOf:(pid_t)parent
+{
+  return self.processesByParent[@(parent)] ?: @[];
+}
+
+- (pid_t)parentOf:(pid_t)child
+{
+  NSNumber *parent = self.parents[@(child)];
+  return parent ? parent.intValue : -1;
+}
+
+- (FBProcessTableChanges *)changesSince:(FBProcessTable *)previous
+{
+  // Processes are compared by value, so that a re-used Process Identifier is seen as a different process.
+  NSMutableArray<FBProcessInfo *> *started = [NSMutableArray array];
+  for (FBProcessInfo *process in self.processes) {
+    if (![[previous processInfoFor:process.processIdentifier] isEqual:process]) {
+      [started addObject:process];
+    }
+  }
+  NSMutableArray<FBProcessInfo *> *exited = [NSMutableArray array];
+  for (FBProcessInfo *process in previous.processes) {
+    if (![[self processInfoFor:process.processIdentifier] isEqual:process]) {
+      [exited addObject:process];
+    }
+  }
+  return [[FBProcessTableChanges alloc] initWithStarted:[started copy] exited:[exited copy]];
+}
+
+#pragma mark NSObject
+
+- (NSString *)description
+{
+  return [NSString stringWithFormat:@"Process Table | %lu Processes", (unsigned long) self.processes.count];
+}
+
+#pragma mark Private
+
++ (void)index:(NSMutableDictionary<id, NSMutableArray<FBProcessInfo *> *> *)index key:(id<NSCopying>)key process:(FBProcessInfo *)process
+{
+  NSMutableArray<FBProcessInfo *> *processes = index[key];
+  if (!processes) {
+    processes = [NSMutableArray array];
+    index[key] = processes;
+  }
+  [processes addObject:process];
+}
+
+@end
@@ -36,6 +36,19 @@ NS_ASSUME_NONNULL_BEGIN
  */
 - (NSArray<NSString *> *)interpretLines:(id<FBEventReporterSubject>)subject;
 
+@optional
+
+/**
+ Interpret the Subject, appending the UTF-8 representation directly to a buffer.
+ The appended bytes are identical to the UTF-8 encoding of -[FBEventInterpreter interpret:].
+ Interpreters that implement this avoid the intermediate objects for each interpreted Subject.
+
+ @param subject the subject to interpret.
+ @param buffer the buffer to append to.
+ @return YES if the subject was appended, NO if the subject must be interpreted with -[FBEventInterpreter interpret:] instead.
+ */
+- (BOOL)appendInterpretation:(id<FBEventReporterSubject>)subject toBuffer:(NSMutableData *)buffer;
+
 @end
 
 /**
@@ -12,6 +12,7 @@
 #import "FBCollectionInformation.h"
 #import "FBEventReporterSubject.h"
 #import "FBEventConstants.h"
+#import "FBEventJSONWriter.h"
 
 @interface FBJSONEventInterpreter : FBEventInterpreter
 
@@ -117,6 +118,43 @@
   return serialized;
 }
 
+- (BOOL)appendInterpretation:(id<FBEventReporterSubject>)eventReporterSubject toBuffer:(NSMutableData *)buffer
+{
+  // Pretty printing is left to NSJSONSerialization.
+  if (self.pretty) {
+    return NO;
+  }
+  NSUInteger length = buffer.length;
+  NSArray<id<FBEventReporterSubject>> *subjects = eventReporterSubject.subSubjects;
+  if (subjects.count == 0) {
+    [buffer appendBytes:"\n" length:1];
+    return YES;
+  }
+  FBEventJSONWriter *writer = [FBEventJSONWriter writerWithBuffer:buffer];
+  for (id<FBEventReporterSubject> subject in subjects) {
+    if (![self appendEventSubject:subject toWriter:writer]) {
+      buffer.length = length;
+      return NO;
+    }
+    [buffer appendBytes:"\n" length:1];
+  }
+  return YES;
+}
+
+- (BOOL)appendEventSubject:(id<FBEventReporterSubject>)subject toWriter:(FBEventJSONWriter *)writer
+{
+  // Subjects that are not events fail the same checks as -renderSubjectLine:, so they are left to the string path.
+  if ([subject conformsToProtocol:@protocol(FBEventJSONWritable)]) {
+    id<FBEventJSONWritable> writable = (id<FBEventJSONWritable>) subject;
+    return writable.writesEvent && [writable appendJSONToWriter:writer];
+  }
+  NSDictionary<NSString *, id> *representation = [subject jsonSerializableRepresentation];
+  if (![representation isKindOfClass:NSDictionary.class] || !representation[FBJSONKeyEventName] || !representation[FBJSONKeyEventType]) {
+    return NO;
+  }
+  return [writer appendJSONObject:representation];
+}
+
 @end
 
 @implementation FBHumanReadableEventInterpreter
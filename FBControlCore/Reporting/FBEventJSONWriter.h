@@ -0,0 +1,132 @@
+/**
+ * Copyright (c) 2015-present, Facebook, Inc.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree. An additional grant
+ * of patent rights can be found in the PATENTS file in the same directory.
+ */
+
+#import <Foundation/Foundation.h>
+
+NS_ASSUME_NONNULL_BEGIN
+
+@class FBEventJSONWriter;
+
+@protocol FBEventReporterSubject;
+
+/**
+ The order in which the keys of a Dictionary are serialized.
+ NSJSONSerialization writes keys in the enumeration order of the Dictionary, rather than the order in which they were declared.
+ This order is determined once by constructing a Dictionary in the same way as a Dictionary literal, so that directly written objects match NSJSONSerialization byte-for-byte.
+ */
+@interface FBEventJSONKeyOrder : NSObject
+
+/**
+ The Key Order of a Dictionary literal with the provided keys.
+
+ @param keys the keys, in the order they are declared in the literal.
+ @return a new Key Order.
+ */
++ (instancetype)orderWithKeys:(NSArray<NSString *> *)keys;
+
+@end
+
+/**
+ Subjects that can write themselves to a JSON Writer, without building an intermediate JSON Serializable representation.
+ */
+@protocol FBEventJSONWritable <NSObject>
+
+/**
+ Appends the JSON representation of the reciever.
+ The output must be identical to serializing -[FBJSONSerializable jsonSerializableRepresentation].
+
+ @param writer the writer to append to.
+ @return YES if successful, NO if the reciever could not be written.
+ */
+- (BOOL)appendJSONToWriter:(FBEventJSONWriter *)writer;
+
+/**
+ YES if the reciever is written as an event, with an event name and event type.
+ */
+@property (nonatomic, assign, readonly) BOOL writesEvent;
+
+@end
+
+/**
+ Writes JSON directly to a mutable buffer.
+ The output is identical to NSJSONSerialization without pretty printing, without the intermediate NSData and NSString for each serialized object.
+ */
+@interface FBEventJSONWriter : NSObject
+
+#pragma mark Initializers
+
+/**
+ A Writer that appends to the provided buffer.
+
+ @param buffer the buffer to append to.
+ @return a new JSON Writer.
+ */
++ (instancetype)writerWithBuffer:(NSMutableData *)buffer;
+
+#pragma mark Properties
+
+/**
+ The buffer that is appended to.
+ */
+@property (nonatomic, strong, readonly) NSMutableData *buffer;
+
+#pragma mark Public Methods
+
+/**
+ Appends a Subject.
+ Subjects that conform to FBEventJSONWritable are written directly, otherwise their JSON Serializable representation is written.
+
+ @param subject the subject to write.
+ @return YES if successful, NO if the subject could not be written.
+ */
+- (BOOL)appendSubject:(id<FBEventReporterSubject>)subject;
+
+/**
+ Appends a JSON Serializable object, consisting of Dictionaries, Arrays, Strings, Numbers and Nulls.
+
+ @param object the object to write.
+ @return YES if successful, NO if the object is not JSON Serializable.
+ */
+- (BOOL)appendJSONObject:(id)object;
+
+/**
+ Appends a String.
+
+ @param string the string to write.
+ */
+- (void)appendString:(NSString *)string;
+
+/**
+ Appends an Integer.
+
+ @param integer the integer to write.
+ */
+- (void)appendInteger:(long long)integer;
+
+/**
+ Appends a Dictionary, writing each of the values in the order of the keys.
+
+ @param order the order of the keys.
+ @param values a block that writes the value for the key at the provided index of the declared keys.
+ @return YES if successful, NO if any value could not be written.
+ */
+- (BOOL)appendDictionaryWithKeyOrder:(FBEventJSONKeyOrder *)order values:(BOOL (^)(NSUInteger index))values;
+
+/**
+ Appends an Array.
+
+ @param count the number of elements.
+ @param values a block that writes the element at the provided index.
+ @return YES if successful, NO if any element could not be written.
+ */
+- (BOOL)appendArrayWithCount:(NSUInteger)count values:(BOOL (^)(NSUInteger index))values;
+
+@end
+
+NS_ASSUME_NONNULL_END
@@ -0,0 +1,294 @@
+/**
+ * Copyright (c) 2015-present, Facebook, Inc.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree. An additional grant
+ * of patent rights can be found in the PATENTS file in the same directory.
+ */
+
+#import "FBEventJSONWriter.h"
+
+#import "FBEventReporterSubject.h"
+
+static char const FBEventJSONHexDigits[] = "0123456789abcdef";
+
+@interface FBEventJSONKeyOrder ()
+
+@property (nonatomic, copy, readonly) NSArray<NSString *> *keys;
+@property (nonatomic, copy, readonly) NSArray<NSNumber *> *indices;
+
+@end
+
+@implementation FBEventJSONKeyOrder
+
++ (instancetype)orderWithKeys:(NSArray<NSString *> *)keys
+{
+  // Construct the Dictionary in the same way as a literal, so that the enumeration order is the same.
+  NSUInteger count = keys.count;
+  NSMutableArray<NSNumber *> *declared = [NSMutableArray arrayWithCapacity:count];
+  for (NSUInteger index = 0; index < count; index++) {
+    [declared addObject:@(index)];
+  }
+  __unsafe_unretained id *objects = (__unsafe_unretained id *) calloc(count, sizeof(id));
+  __unsafe_unretained id *orderedKeys = (__unsafe_unretained id *) calloc(count, sizeof(id));
+  [declared getObjects:objects range:NSMakeRange(0, count)];
+  [keys getObjects:orderedKeys range:NSMakeRange(0, count)];
+  NSDictionary<NSString *, NSNumber *> *dictionary = [NSDictionary dictionaryWithObjects:objects forKeys:orderedKeys count:count];
+  free(objects);
+  free(orderedKeys);
+  NSMutableArray<NSNumber *> *indices = [NSMutableArray arrayWithCapacity:count];
+  for (NSString *key in dictionary) {
+    [indices addObject:dictionary[key]];
+  }
+  return [[self alloc] initWithKeys:keys indices:indices];
+}
+
+- (instancetype)initWithKeys:(NSArray<NSString *> *)keys indices:(NSArray<NSNumber *> *)indices
+{
+  self = [super init];
+  if (!self) {
+    return nil;
+  }
+
+  _keys = [keys copy];
+  _indices = [indices copy];
+
+  return self;
+}
+
+@end
+
+@implementation FBEventJSONWriter
+
+#pragma mark Initializers
+
++ (instancetype)writerWithBuffer:(NSMutableData *)buffer
+{
+  return [[self alloc] initWithBuffer:buffer];
+}
+
+- (instancetype)initWithBuffer:(NSMutableData *)buffer
+{
+  self = [super init];
+  if (!self) {
+    return nil;
+  }
+
+  _buffer = buffer;
+
+  return self;
+}
+
+#pragma mark Public Methods
+
+- (BOOL)appendSubject:(id<FBEventReporterSubject>)subject
+{
+  if ([subject conformsToProtocol:@protocol(FBEventJSONWritable)]) {
+    return [(id<FBEventJSONWritable>) subject appendJSONToWriter:self];
+  }
+  return [self appendJSONObject:subject.jsonSerializableRepresentation];
+}
+
+- (BOOL)appendJSONObject:(id)object
+{
+  if ([object isKindOfClass:NSString.class]) {
+    [self appendString:object];
+    return YES;
+  }
+  if ([object isKindOfClass:NSNumber.class]) {
+    return [self appendNumber:object];
+  }
+  if ([object isKindOfClass:NSDictionary.class]) {
+    return [self appendDictionary:object];
+  }
+  if ([object isKindOfClass:NSArray.class]) {
+    NSArray<id> *array = object;
+    return [self appendArrayWithCount:array.count values:^(NSUInteger index) {
+      return [self appendJSONObject:array[index]];
+    }];
+  }
+  if ([object isKindOfClass:NSNull.class]) {
+    [self appendBytes:"null" length:4];
+    return YES;
+  }
+  return NO;
+}
+
+- (void)appendString:(NSString *)string
+{
+  [self appendBytes:"\"" length:1];
+
+  // Transcode in chunks, escaping each chunk as it is appended.
+  uint8_t chunk[1024];
+  NSRange remaining = NSMakeRange(0, string.length);
+  while (remaining.length > 0) {
+    NSUInteger used = 0;
+    NSRange next = NSMakeRange(0, 0);
+    if (![string getBytes:chunk maxLength:sizeof(chunk) usedLength:&used encoding:NSUTF8StringEncoding options:0 range:remaining remainingRange:&next]) {
+      break;
+    }
+    [self appendEscapedBytes:chunk length:used];
+    remaining = next;
+  }
+
+  [self appendBytes:"\"" length:1];
+}
+
+- (void)appendInteger:(long long)integer
+{
+  char digits[24];
+  int length = snprintf(digits, sizeof(digits), "%lld", integer);
+  [self appendBytes:digits length:(NSUInteger) length];
+}
+
+- (BOOL)appendDictionaryWithKeyOrder:(FBEventJSONKeyOrder *)order values:(BOOL (^)(NSUInteger index))values
+{
+  [self appendBytes:"{" length:1];
+  BOOL first = YES;
+  for (NSNumber *indexNumber in order.indices) {
+    NSUInteger index = indexNumber.unsignedIntegerValue;
+    if (!first) {
+      [self appendBytes:"," length:1];
+    }
+    first = NO;
+    [self appendString:order.keys[index]];
+    [self appendBytes:":" length:1];
+    if (!values(index)) {
+      return NO;
+    }
+  }
+  [self appendBytes:"}" length:1];
+  return YES;
+}
+
+- (BOOL)appendArrayWithCount:(NSUInteger)count values:(BOOL (^)(NSUInteger index))values
+{
+  [self appendBytes:"[" length:1];
+  for (NSUInteger index = 0; index < count; index++) {
+    if (index > 0) {
+      [self appendBytes:"," length:1];
+    }
+    if (!values(index)) {
+      return NO;
+    }
+  }
+  [self appendBytes:"]" length:1];
+  return YES;
+}
+
+#pragma mark Private
+
+- (BOOL)appendDictionary:(NSDictionary<id, id> *)dictionary
+{
+  [self appendBytes:"{" length:1];
+  BOOL first = YES;
+  for (id key in dictionary) {
+    if (![key isKindOfClass:NSString.class]) {
+      return NO;
+    }
+    if (!first) {
+      [self appendBytes:"," length:1];
+    }
+    first = NO;
+    [self appendString:key];
+    [self appendBytes:":" length:1];
+    if (![self appendJSONObject:dictionary[key]]) {
+      return NO;
+    }
+  }
+  [self appendBytes:"}" length:1];
+  return YES;
+}
+
+- (BOOL)appendNumber:(NSNumber *)number
+{
+  CFNumberRef numberRef = (__bridge CFNumberRef) number;
+  if (numberRef == (CFNumberRef) kCFBooleanTrue) {
+    [self appendBytes:"true" length:4];
+    return YES;
+  }
+  if (numberRef == (CFNumberRef) kCFBooleanFalse) {
+    [self appendBytes:"false" length:5];
+    return YES;
+  }
+  if (CFNumberIsFloatType(numberRef)) {
+    // The formatting of floating point numbers is left to NSJSONSerialization, so that it is identical.
+    NSData *data = [NSJSONSerialization dataWithJSONObject:@[number] options:0 error:nil];
+    if (data.length < 2) {
+      return NO;
+    }
+    [self appendBytes:(const char *) data.bytes + 1 length:data.length - 2];
+    return YES;
+  }
+  switch (number.objCType[0]) {
+    case 'C':
+    case 'S':
+    case 'I':
+    case 'L':
+    case 'Q': {
+      char digits[24];
+      int length = snprintf(digits, sizeof(digits), "%llu", number.unsignedLongLongValue);
+      [self appendBytes:digits length:(NSUInteger) length];
+      return YES;
+    }
+    default:
+      [self appendInteger:number.longLongValue];
+      return YES;
+  }
+}
+
+- (void)appendEscapedBytes:(const uint8_t *)bytes length:(NSUInteger)length
+{
+  NSUInteger start = 0;
+  for (NSUInteger index = 0; index < length; index++) {
+    uint8_t byte = bytes[index];
+    if (byte >= 0x20 && byte != '"' && byte != '\\' && byte != '/') {
+      continue;
+    }
+    [self appendBytes:(const char *) bytes + start length:index - start];
+    start = index + 1;
+    switch (byte) {
+      case '"':
+        [self appendBytes:"\\\"" length:2];
+        break;
+      case '\\':
+        [self appendBytes:"\\\\" length:2];
+        break;
+      case '/':
+        [self appendBytes:"\\/" length:2];
+        break;
+      case '\b':
+        [self appendBytes:"\\b" length:2];
+        break;
+      case '\f':
+        [self appendBytes:"\\f" length:2];
+        break;
+      case '\n':
+        [self appendBytes:"\\n" length:2];
+        break;
+      case '\r':
+        [self appendBytes:"\\r" length:2];
+        break;
+      case '\t':
+        [self appendBytes:"\\t" length:2];
+        break;
+      default: {
+        char escape[6] = {'\\', 'u', '0', '0', FBEventJSONHexDigits[byte >> 4], FBEventJSONHexDigits[byte & 0xF]};
+        [self appendBytes:escape length:sizeof(escape)];
+        break;
+      }
+    }
+  }
+  [self appendBytes:(const char *) bytes + start length:length - start];
+}
+
+- (void)appendBytes:(const char *)bytes length:(NSUInteger)length
+{
+  if (length == 0) {
+    return;
+  }
+  [self.buffer appendBytes:bytes length:length];
+}
+
+@end
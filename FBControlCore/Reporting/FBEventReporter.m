@@ -13,6 +13,13 @@
 #import "FBEventInterpreter.h"
 #import "FBDataConsumer.h"
 
+@interface FBEventReporter ()
+
+@property (nonatomic, strong, readonly) NSMutableData *pending;
+@property (nonatomic, assign, readwrite) BOOL flushing;
+
+@end
+
 @implementation FBEventReporter
 
 @synthesize interpreter = _interpreter;
@@ -34,6 +41,7 @@
 
   _interpreter = interpreter;
   _consumer = consumer;
+  _pending = [NSMutableData data];
 
   return self;
 }
@@ -42,9 +50,40 @@
 
 - (void)report:(id<FBEventReporterSubject>)subject
 {
-  NSString *output = [self.interpreter interpret:subject];
-  NSData *data = [output dataUsingEncoding:NSUTF8StringEncoding];
-  [self.consumer consumeData:data];
+  // Subjects are interpreted into a buffer that is reused between reports.
+  // The first reporter to find nothing being flushed becomes responsible for flushing.
+  // Reports made by other threads whilst it is consuming are written in the same batch.
+  id<FBEventInterpreter> interpreter = self.interpreter;
+  @synchronized (self) {
+    if (![interpreter respondsToSelector:@selector(appendInterpretation:toBuffer:)] || ![interpreter appendInterpretation:subject toBuffer:self.pending]) {
+      NSString *output = [interpreter interpret:subject];
+      [self.pending appendData:[output dataUsingEncoding:NSUTF8StringEncoding]];
+    }
+    if (self.flushing) {
+      return;
+    }
+    self.flushing = YES;
+  }
+  [self flushPending];
+}
+
+#pragma mark Private
+
+- (void)flushPending
+{
+  while (YES) {
+    NSData *batch = nil;
+    @synchronized (self) {
+      if (self.pending.length == 0) {
+        self.flushing = NO;
+        return;
+      }
+      // The consumer may retain the data, so the buffer itself cannot be passed along.
+      batch = [NSData dataWithBytes:self.pending.bytes length:self.pending.length];
+      self.pending.length = 0;
+    }
+    [self.consumer consumeData:batch];
+  }
 }
 
 @end
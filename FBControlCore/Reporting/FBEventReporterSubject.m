@@ -10,18 +10,19 @@
 #import "FBEventReporterSubject.h"
 
 #import "FBCollectionInformation.h"
+#import "FBEventJSONWriter.h"
 
 @interface FBSingleItemSubject : FBEventReporterSubject
 
 @end
 
-@interface FBSimpleSubject : FBSingleItemSubject
+@interface FBSimpleSubject : FBSingleItemSubject <FBEventJSONWritable>
 
 - (instancetype)initWithName:(FBEventName)name type:(FBEventType)type subject:(FBEventReporterSubject *)subject;
 
 @end
 
-@interface FBControlCoreSubject : FBSingleItemSubject
+@interface FBControlCoreSubject : FBSingleItemSubject <FBEventJSONWritable>
 
 - (instancetype)initWithValue:(id<FBJSONSerializable>)controlCoreValue;
 
@@ -33,31 +34,31 @@
 
 @end
 
-@interface FBiOSTargetWithSubject : FBSingleItemSubject
+@interface FBiOSTargetWithSubject : FBSingleItemSubject <FBEventJSONWritable>
 
 - (instancetype)initWithTargetSubject:(FBiOSTargetSubject *)targetSubject eventName:(FBEventName)eventName eventType:(FBEventType)eventType subject:(id<FBEventReporterSubject>)subject;
 
 @end
 
-@interface FBStringSubject : FBSingleItemSubject
+@interface FBStringSubject : FBSingleItemSubject <FBEventJSONWritable>
 
 - (instancetype)initWithString:(NSString *)string;
 
 @end
 
-@interface FBStringsSubject : FBSingleItemSubject
+@interface FBStringsSubject : FBSingleItemSubject <FBEventJSONWritable>
 
 - (instancetype)initWithStrings:(NSArray<NSString *> *)strings;
 
 @end
 
-@interface FBLogSubject : FBSingleItemSubject
+@interface FBLogSubject : FBSingleItemSubject <FBEventJSONWritable>
 
 - (instancetype)initWithLogString:(NSString *)string level:(int)level;
 
 @end
 
-@interface FBCompositeSubject : FBEventReporterSubject
+@interface FBCompositeSubject : FBEventReporterSubject <FBEventJSONWritable>
 
 - (instancetype)initWithArray:(NSArray<id<FBEventReporterSubject>> *)eventReporterSubject;
 
@@ -200,6 +201,35 @@
   };
 }
 
+- (BOOL)writesEvent
+{
+  return self.eventName != nil && self.eventType != nil;
+}
+
+- (BOOL)appendJSONToWriter:(FBEventJSONWriter *)writer
+{
+  static FBEventJSONKeyOrder *order;
+  static dispatch_once_t onceToken;
+  dispatch_once(&onceToken, ^{
+    order = [FBEventJSONKeyOrder orderWithKeys:@[FBJSONKeyEventType, FBJSONKeyTimestamp, FBJSONKeySubject, FBJSONKeyEventName]];
+  });
+  return [writer appendDictionaryWithKeyOrder:order values:^(NSUInteger index) {
+    switch (index) {
+      case 0:
+        [writer appendString:self.eventType];
+        return YES;
+      case 1:
+        [writer appendInteger:(int)[[NSDate date] timeIntervalSince1970]];
+        return YES;
+      case 2:
+        return [writer appendSubject:self.subject];
+      default:
+        [writer appendString:self.eventName];
+        return YES;
+    }
+  }];
+}
+
 - (NSString *)shortDescription
 {
   if ([self.eventType isEqualToString:FBEventTypeDiscrete]) {
@@ -241,6 +271,16 @@
   return self.value.jsonSerializableRepresentation;
 }
 
+- (BOOL)writesEvent
+{
+  return NO;
+}
+
+- (BOOL)appendJSONToWriter:(FBEventJSONWriter *)writer
+{
+  return [writer appendJSONObject:self.value.jsonSerializableRepresentation];
+}
+
 - (NSString *)description
 {
   return [NSString stringWithFormat:@"%@", self.value];
@@ -326,6 +366,37 @@
   };
 }
 
+- (BOOL)writesEvent
+{
+  return self.eventName != nil && self.eventType != nil;
+}
+
+- (BOOL)appendJSONToWriter:(FBEventJSONWriter *)writer
+{
+  static FBEventJSONKeyOrder *order;
+  static dispatch_once_t onceToken;
+  dispatch_once(&onceToken, ^{
+    order = [FBEventJSONKeyOrder orderWithKeys:@[FBJSONKeyEventName, FBJSONKeyEventType, FBJSONKeyTarget, FBJSONKeySubject, FBJSONKeyTimestamp]];
+  });
+  return [writer appendDictionaryWithKeyOrder:order values:^(NSUInteger index) {
+    switch (index) {
+      case 0:
+        [writer appendString:self.eventName];
+        return YES;
+      case 1:
+        [writer appendString:self.eventType];
+        return YES;
+      case 2:
+        return [writer appendJSONObject:[self.targetSubject jsonSerializableRepresentation]];
+      case 3:
+        return [writer appendSubject:self.subject];
+      default:
+        [writer appendInteger:(int)[self.timestamp timeIntervalSince1970]];
+        return YES;
+    }
+  }];
+}
+
 - (NSString *)description
 {
   if ([self.eventType isEqualToString:FBEventTypeDiscrete]) {
@@ -370,6 +441,39 @@
   };
 }
 
+- (BOOL)writesEvent
+{
+  return YES;
+}
+
+- (BOOL)appendJSONToWriter:(FBEventJSONWriter *)writer
+{
+  static FBEventJSONKeyOrder *order;
+  static dispatch_once_t onceToken;
+  dispatch_once(&onceToken, ^{
+    order = [FBEventJSONKeyOrder orderWithKeys:@[FBJSONKeyEventType, FBJSONKeyTimestamp, FBJSONKeyLevel, FBJSONKeySubject, FBJSONKeyEventName]];
+  });
+  return [writer appendDictionaryWithKeyOrder:order values:^(NSUInteger index) {
+    switch (index) {
+      case 0:
+        [writer appendString:FBEventTypeDiscrete];
+        return YES;
+      case 1:
+        [writer appendInteger:(int)[[NSDate date] timeIntervalSince1970]];
+        return YES;
+      case 2:
+        [writer appendString:self.levelString];
+        return YES;
+      case 3:
+        [writer appendString:self.logString];
+        return YES;
+      default:
+        [writer appendString:FBEventNameLog];
+        return YES;
+    }
+  }];
+}
+
 - (NSString *)description
 {
   return self.logString;
@@ -422,6 +526,19 @@
   return output;
 }
 
+- (BOOL)writesEvent
+{
+  return NO;
+}
+
+- (BOOL)appendJSONToWriter:(FBEventJSONWriter *)writer
+{
+  NSArray<id<FBEventReporterSubject>> *subjects = self.subjects;
+  return [writer appendArrayWithCount:subjects.count values:^(NSUInteger index) {
+    return [writer appendSubject:subjects[index]];
+  }];
+}
+
 - (NSArray<FBEventReporterSubject *> *)subSubjects
 {
   return self.subjects;
@@ -459,6 +576,17 @@
   return self.string;
 }
 
+- (BOOL)writesEvent
+{
+  return NO;
+}
+
+- (BOOL)appendJSONToWriter:(FBEventJSONWriter *)writer
+{
+  [writer appendString:self.string];
+  return YES;
+}
+
 - (NSString *)description
 {
   return self.string;
@@ -491,6 +619,16 @@
   return self.strings;
 }
 
+- (BOOL)writesEvent
+{
+  return NO;
+}
+
+- (BOOL)appendJSONToWriter:(FBEventJSONWriter *)writer
+{
+  return [writer appendJSONObject:self.strings];
+}
+
 - (NSString *)description
 {
   return [FBCollectionInformation oneLineDescriptionFromArray:self.strings];
@@ -0,0 +1,77 @@
+/**
+ * Copyright (c) 2015-present, Facebook, Inc.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree. An additional grant
+ * of patent rights can be found in the PATENTS file in the same directory.
+ */
+
+#import <Foundation/Foundation.h>
+
+#import <FBControlCore/FBFuture.h>
+
+NS_ASSUME_NONNULL_BEGIN
+
+@protocol FBControlCoreLogger;
+@protocol FBDataConsumer;
+
+/**
+ A Cache of extracted Zip Archives, keyed by the hash of the contents of the archive.
+ Concurrent and repeated extractions of the same archive share a single extracted directory, which is reference counted by the contexts that use it.
+ The extracted directory is shared, so it must be treated as read-only by the users of it.
+ */
+@interface FBArchiveExtractionCache : NSObject
+
+#pragma mark Initializers
+
+/**
+ Creates a Cache that extracts into the provided directory.
+
+ @param directory the directory to extract into. Each archive is extracted into a subdirectory named with the hash of its contents.
+ @param retainedUnusedCount the number of extracted directories that are kept after they are no longer used, so that a sequential re-use does not extract again.
+ @param logger the logger to log to.
+ @return a new Extraction Cache.
+ */
++ (instancetype)cacheWithDirectory:(NSString *)directory retainedUnusedCount:(NSUInteger)retainedUnusedCount logger:(nullable id<FBControlCoreLogger>)logger;
+
+/**
+ The Cache shared within the process, extracting into a temporary directory that is removed when the process exits.
+ The most recently used extractions are retained once they are unused, so that installing the same archive again does not extract it again.
+ */
+@property (nonatomic, class, strong, readonly) FBArchiveExtractionCache *sharedCache;
+
+#pragma mark Properties
+
+/**
+ The directory that archives are extracted into.
+ */
+@property (nonatomic, copy, readonly) NSString *directory;
+
+#pragma mark Public Methods
+
+/**
+ Obtains the extracted contents of a Zip Archive, extracting it if there is no extraction of an archive with the same contents.
+ When the context is torn down the reference to the extracted directory is released. Directories beyond the retained count are deleted once they are unused.
+
+ @param queue the queue to perform work on.
+ @param path the path of the archive.
+ @return a context wrapping the extracted directory.
+ */
+- (FBFutureContext<NSURL *> *)onQueue:(dispatch_queue_t)queue extractArchiveAtPath:(NSString *)path;
+
+/**
+ Extracts an archive as it is being written to a path, so that the extraction overlaps with the transfer of the archive.
+ The consumer must be given the bytes that are written to the path, and must only be given an end-of-file once the file at the path is complete.
+ A later extraction of the archive at the path uses the streamed extraction, or extracts from the file if the archive could not be extracted as a stream.
+ The most recent streamed extractions are retained until they are used, older ones are removed once the stream completes.
+
+ @param path the path that the archive is being written to.
+ @param length the length of the archive, which bounds the bytes that may be extracted whilst it is written.
+ @return a consumer of the bytes of the archive.
+ */
+- (id<FBDataConsumer>)extractionConsumerForArchiveAtPath:(NSString *)path length:(unsigned long long)length;
+
+@end
+
+NS_ASSUME_NONNULL_END
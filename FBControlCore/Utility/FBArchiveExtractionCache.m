@@ -0,0 +1,428 @@
+/**
+ * Copyright (c) 2015-present, Facebook, Inc.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree. An additional grant
+ * of patent rights can be found in the PATENTS file in the same directory.
+ */
+
+#import "FBArchiveExtractionCache.h"
+
+#include <CommonCrypto/CommonDigest.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <signal.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#import "FBControlCoreError.h"
+#import "FBControlCoreLogger.h"
+#import "FBDataConsumer.h"
+#import "FBZipArchive.h"
+
+static size_t const FBArchiveExtractionCacheHashBufferSize = 1024 * 1024;
+static NSString *const FBArchiveExtractionCacheSharedDirectoryPrefix = @"FBArchiveExtractionCache_";
+
+// Streamed extractions that have not yet been used are retained up to this count, so that an upload can be installed after it is received without growing the cache without bound.
+static NSUInteger const FBArchiveExtractionCacheRetainedStreamedCount = 2;
+
+// Unused extractions in the shared cache are retained up to this count, so that sequential installs of the same archive extract it once.
+// A process typically alternates between an application and its test host, so a few extractions cover it whilst bounding the disk used by large applications.
+static NSUInteger const FBArchiveExtractionCacheSharedRetainedUnusedCount = 4;
+
+// A streamed extraction may expand the archive by up to this ratio, beyond which the archive is extracted from the file once it is complete.
+static unsigned long long const FBArchiveExtractionCacheMaximumStreamedExpansion = 64;
+
+static NSString *FBArchiveExtractionCacheSharedDirectory = nil;
+
+static void FBArchiveExtractionCacheRemoveSharedDirectory(void)
+{
+  [NSFileManager.defaultManager removeItemAtPath:FBArchiveExtractionCacheSharedDirectory error:nil];
+}
+
+static NSString *FBArchiveExtractionCacheFileIdentity(const struct stat *info)
+{
+  return [NSString stringWithFormat:@"%llu:%llu:%lld:%ld.%ld", (unsigned long long) info->st_dev, (unsigned long long) info->st_ino, (long long) info->st_size, (long) info->st_mtimespec.tv_sec, (long) info->st_mtimespec.tv_nsec];
+}
+
+static NSString *FBArchiveExtractionCacheFinalizeHash(CC_SHA256_CTX *context)
+{
+  unsigned char digest[CC_SHA256_DIGEST_LENGTH];
+  CC_SHA256_Final(digest, context);
+  NSMutableString *hash = [NSMutableString stringWithCapacity:CC_SHA256_DIGEST_LENGTH * 2];
+  for (size_t index = 0; index < CC_SHA256_DIGEST_LENGTH; index++) {
+    [hash appendFormat:@"%02x", digest[index]];
+  }
+  return [hash copy];
+}
+
+@interface FBArchiveExtractionCacheEntry : NSObject
+
+@property (nonatomic, copy, readonly) NSString *key;
+@property (nonatomic, strong, readonly) FBMutableFuture<NSURL *> *extraction;
+@property (nonatomic, assign, readwrite) NSUInteger referenceCount;
+@property (nonatomic, assign, readwrite) NSUInteger lastUse;
+@property (nonatomic, assign, readwrite) BOOL acquired;
+
+@end
+
+@implementation FBArchiveExtractionCacheEntry
+
+- (instancetype)initWithKey:(NSString *)key
+{
+  self = [super init];
+  if (!self) {
+    return nil;
+  }
+
+  _key = key;
+  _extraction = FBMutableFuture.future;
+
+  return self;
+}
+
+@end
+
+@interface FBArchiveExtractionCache ()
+
+@property (nonatomic, assign, readonly) NSUInteger retainedUnusedCount;
+@property (nonatomic, strong, nullable, readonly) id<FBControlCoreLogger> logger;
+@property (nonatomic, strong, readonly) dispatch_queue_t extractionQueue;
+@property (nonatomic, strong, readonly) NSMutableDictionary<NSString *, FBArchiveExtractionCacheEntry *> *entries;
+@property (nonatomic, strong, readonly) NSMutableDictionary<NSString *, NSString *> *hashes;
+@property (nonatomic, assign, readwrite) NSUInteger useCount;
+
+- (void)adoptStreamedExtraction:(FBFuture<NSString *> *)extraction contentHash:(NSString *)key archivePath:(NSString *)path;
+
+@end
+
+@interface FBArchiveExtractionCache_StreamingConsumer : NSObject <FBDataConsumer>
+{
+  CC_SHA256_CTX _context;
+}
+
+@property (nonatomic, strong, readonly) FBArchiveExtractionCache *cache;
+@property (nonatomic, copy, readonly) NSString *path;
+@property (nonatomic, strong, readonly) FBZipStreamExtractor *extractor;
+
+@end
+
+@implementation FBArchiveExtractionCache_StreamingConsumer
+
+- (instancetype)initWithCache:(FBArchiveExtractionCache *)cache path:(NSString *)path extractor:(FBZipStreamExtractor *)extractor
+{
+  self = [super init];
+  if (!self) {
+    return nil;
+  }
+
+  _cache = cache;
+  _path = path;
+  _extractor = extractor;
+  CC_SHA256_Init(&_context);
+
+  return self;
+}
+
+- (void)consumeData:(NSData *)data
+{
+  // The contents are hashed as they arrive, so the extraction is keyed without reading the archive again.
+  CC_SHA256_Update(&_context, data.bytes, (CC_LONG) data.length);
+  [self.extractor consumeData:data];
+}
+
+- (void)consumeEndOfFile
+{
+  NSString *key = FBArchiveExtractionCacheFinalizeHash(&_context);
+  [self.extractor consumeEndOfFile];
+  [self.cache adoptStreamedExtraction:self.extractor.completed contentHash:key archivePath:self.path];
+}
+
+@end
+
+@implementation FBArchiveExtractionCache
+
+#pragma mark Initializers
+
++ (instancetype)cacheWithDirectory:(NSString *)directory retainedUnusedCount:(NSUInteger)retainedUnusedCount logger:(nullable id<FBControlCoreLogger>)logger
+{
+  return [[self alloc] initWithDirectory:directory retainedUnusedCount:retainedUnusedCount logger:logger];
+}
+
++ (FBArchiveExtractionCache *)sharedCache
+{
+  static dispatch_once_t onceToken;
+  static FBArchiveExtractionCache *cache;
+  dispatch_once(&onceToken, ^{
+    // The directory belongs to this process and is removed when it exits, so retained extractions do not outlive it.
+    // Directories of processes that did not exit cleanly are removed here instead.
+    [self removeSharedDirectoriesOfExitedProcesses];
+    FBArchiveExtractionCacheSharedDirectory = [NSTemporaryDirectory() stringByAppendingPathComponent:[NSString stringWithFormat:@"%@%d", FBArchiveExtractionCacheSharedDirectoryPrefix, NSProcessInfo.processInfo.processIdentifier]];
+    atexit(FBArchiveExtractionCacheRemoveSharedDirectory);
+    cache = [self cacheWithDirectory:FBArchiveExtractionCacheSharedDirectory retainedUnusedCount:FBArchiveExtractionCacheSharedRetainedUnusedCount logger:nil];
+  });
+  return cache;
+}
+
+- (instancetype)initWithDirectory:(NSString *)directory retainedUnusedCount:(NSUInteger)retainedUnusedCount logger:(nullable id<FBControlCoreLogger>)logger
+{
+  self = [super init];
+  if (!self) {
+    return nil;
+  }
+
+  _directory = directory;
+  _retainedUnusedCount = retainedUnusedCount;
+  _logger = logger;
+  _extractionQueue = dispatch_queue_create("com.facebook.fbcontrolcore.extraction_cache", DISPATCH_QUEUE_CONCURRENT);
+  _entries = [NSMutableDictionary dictionary];
+  _hashes = [NSMutableDictionary dictionary];
+
+  return self;
+}
+
+#pragma mark Public Methods
+
+- (FBFutureContext<NSURL *> *)onQueue:(dispatch_queue_t)queue extractArchiveAtPath:(NSString *)path
+{
+  return [[FBFuture
+    onQueue:queue resolve:^ FBFuture<NSURL *> * {
+      NSError *error = nil;
+      NSString *key = [self contentHashOfFileAtPath:path error:&error];
+      if (!key) {
+        return [FBFuture futureWithError:error];
+      }
+      return [self acquireExtractionWithKey:key archivePath:path];
+    }]
+    onQueue:queue contextualTeardown:^(NSURL *extractedPath, FBFutureState __) {
+      [self relinquishExtractionWithKey:extractedPath.lastPathComponent];
+    }];
+}
+
+- (id<FBDataConsumer>)extractionConsumerForArchiveAtPath:(NSString *)path length:(unsigned long long)length
+{
+  NSString *directory = [self.directory stringByAppendingPathComponent:[@"streaming" stringByAppendingPathExtension:NSProcessInfo.processInfo.globallyUniqueString]];
+  FBZipStreamExtractor *extractor = [FBZipStreamExtractor extractorForArchiveAtPath:path toDirectory:directory maximumExtractedSize:length * FBArchiveExtractionCacheMaximumStreamedExpansion];
+  return [[FBArchiveExtractionCache_StreamingConsumer alloc] initWithCache:self path:path extractor:extractor];
+}
+
+#pragma mark Private
+
+- (void)adoptStreamedExtraction:(FBFuture<NSString *> *)extraction contentHash:(NSString *)key archivePath:(NSString *)path
+{
+  // The hash of the completed file is known, so a later extraction of the path does not read it again.
+  struct stat info;
+  if (stat(path.fileSystemRepresentation, &info) == 0) {
+    @synchronized (self.hashes) {
+      self.hashes[FBArchiveExtractionCacheFileIdentity(&info)] = key;
+    }
+  }
+  FBArchiveExtractionCacheEntry *entry = nil;
+  @synchronized (self) {
+    if (!self.entries[key]) {
+      entry = [[FBArchiveExtractionCacheEntry alloc] initWithKey:key];
+      entry.lastUse = ++self.useCount;
+      self.entries[key] = entry;
+    }
+  }
+  [extraction onQueue:self.extractionQueue notifyOfCompletion:^(FBFuture<NSString *> *future) {
+    NSString *streamed = future.result;
+    if (!entry) {
+      // An archive with the same contents has already been extracted.
+      if (streamed) {
+        [NSFileManager.defaultManager removeItemAtPath:streamed error:nil];
+      }
+      return;
+    }
+    NSString *destination = [self.directory stringByAppendingPathComponent:key];
+    NSError *error = future.error;
+    if (streamed) {
+      [NSFileManager.defaultManager removeItemAtPath:destination error:nil];
+      if ([NSFileManager.defaultManager moveItemAtPath:streamed toPath:destination error:&error]) {
+        [self.logger logFormat:@"Extracted %@ whilst it was written", path];
+        [entry.extraction resolveWithResult:[NSURL fileURLWithPath:destination isDirectory:YES]];
+        [self evictUnusedExtractions];
+        return;
+      }
+      [NSFileManager.defaultManager removeItemAtPath:streamed error:nil];
+    }
+    [self.logger logFormat:@"Could not extract %@ whilst it was written, extracting from the file: %@", path, error];
+    [self extractArchiveAtPath:path intoEntry:entry];
+  }];
+}
+
+- (FBFuture<NSURL *> *)acquireExtractionWithKey:(NSString *)key archivePath:(NSString *)path
+{
+  @synchronized (self) {
+    FBArchiveExtractionCacheEntry *entry = self.entries[key];
+    if (entry) {
+      [self.logger logFormat:@"Re-using extraction of %@ with contents %@", path, key];
+    } else {
+      entry = [[FBArchiveExtractionCacheEntry alloc] initWithKey:key];
+      self.entries[key] = entry;
+      [self extractArchiveAtPath:path intoEntry:entry];
+    }
+    entry.referenceCount++;
+    entry.lastUse = ++self.useCount;
+    entry.acquired = YES;
+    return entry.extraction;
+  }
+}
+
+- (void)extractArchiveAtPath:(NSString *)path intoEntry:(FBArchiveExtractionCacheEntry *)entry
+{
+  NSString *destination = [self.directory stringByAppendingPathComponent:entry.key];
+  dispatch_async(self.extractionQueue, ^{
+    [self.logger logFormat:@"Extracting %@ to %@", path, destination];
+    // The archive is extracted beside the destination and then moved, so a partial extraction is never shared.
+    NSString *partial = [destination stringByAppendingPathExtension:NSProcessInfo.processInfo.globallyUniqueString];
+    NSError *error = nil;
+    FBZipArchive *archive = [FBZipArchive archiveAtPath:path error:&error];
+    BOOL success = archive && [archive extractToDirectory:partial error:&error];
+    if (success) {
+      [NSFileManager.defaultManager removeItemAtPath:destination error:nil];
+      success = [NSFileManager.defaultManager moveItemAtPath:partial toPath:destination error:&error];
+    }
+    if (success) {
+      [entry.extraction resolveWithResult:[NSURL fileURLWithPath:destination isDirectory:YES]];
+      [self evictUnusedExtractions];
+      return;
+    }
+    [NSFileManager.defaultManager removeItemAtPath:partial error:nil];
+    // A failed extraction is not cached, so that it is attempted again.
+    @synchronized (self) {
+      if (self.entries[entry.key] == entry) {
+        [self.entries removeObjectForKey:entry.key];
+      }
+    }
+    [entry.extraction resolveWithError:[[[FBControlCoreError
+      describeFormat:@"Failed to extract %@", path]
+      causedBy:error]
+      build]];
+  });
+}
+
+- (void)relinquishExtractionWithKey:(NSString *)key
+{
+  @synchronized (self) {
+    FBArchiveExtractionCacheEntry *entry = self.entries[key];
+    if (!entry || entry.referenceCount == 0) {
+      return;
+    }
+    entry.referenceCount--;
+  }
+  [self evictUnusedExtractions];
+}
+
+- (void)evictUnusedExtractions
+{
+  NSMutableArray<NSString *> *evicted = [NSMutableArray array];
+  @synchronized (self) {
+    // The least recently used extractions beyond the retained counts are removed once nothing references them.
+    // Streamed extractions that have never been used are bounded separately, so that they are not evicted before they are installed.
+    NSMutableArray<FBArchiveExtractionCacheEntry *> *unused = [NSMutableArray array];
+    NSMutableArray<FBArchiveExtractionCacheEntry *> *unusedStreamed = [NSMutableArray array];
+    for (FBArchiveExtractionCacheEntry *candidate in self.entries.allValues) {
+      if (candidate.referenceCount == 0 && candidate.extraction.state == FBFutureStateDone) {
+        [(candidate.acquired ? unused : unusedStreamed) addObject:candidate];
+      }
+    }
+    [self evictLeastRecentlyUsed:unused retaining:self.retainedUnusedCount into:evicted];
+    [self evictLeastRecentlyUsed:unusedStreamed retaining:FBArchiveExtractionCacheRetainedStreamedCount into:evicted];
+  }
+  for (NSString *path in evicted) {
+    [self.logger logFormat:@"Removing unused extraction %@", path];
+    [NSFileManager.defaultManager removeItemAtPath:path error:nil];
+  }
+}
+
+- (void)evictLeastRecentlyUsed:(NSMutableArray<FBArchiveExtractionCacheEntry *> *)unused retaining:(NSUInteger)retainedCount into:(NSMutableArray<NSString *> *)evicted
+{
+  [unused sortUsingComparator:^ NSComparisonResult (FBArchiveExtractionCacheEntry *left, FBArchiveExtractionCacheEntry *right) {
+    return left.lastUse < right.lastUse ? NSOrderedAscending : (left.lastUse > right.lastUse ? NSOrderedDescending : NSOrderedSame);
+  }];
+  while (unused.count > retainedCount) {
+    FBArchiveExtractionCacheEntry *candidate = unused.firstObject;
+    [unused removeObjectAtIndex:0];
+    [self.entries removeObjectForKey:candidate.key];
+    // The directory is moved aside whilst locked, so that it cannot be confused with a new extraction of the same archive.
+    NSString *path = [self.directory stringByAppendingPathComponent:candidate.key];
+    NSString *removed = [path stringByAppendingPathExtension:NSProcessInfo.processInfo.globallyUniqueString];
+    if ([NSFileManager.defaultManager moveItemAtPath:path toPath:removed error:nil]) {
+      [evicted addObject:removed];
+    }
+  }
+}
+
++ (void)removeSharedDirectoriesOfExitedProcesses
+{
+  NSString *temporaryDirectory = NSTemporaryDirectory();
+  for (NSString *name in [NSFileManager.defaultManager contentsOfDirectoryAtPath:temporaryDirectory error:nil]) {
+    if (![name hasPrefix:FBArchiveExtractionCacheSharedDirectoryPrefix]) {
+      continue;
+    }
+    pid_t processIdentifier = (pid_t) [name substringFromIndex:FBArchiveExtractionCacheSharedDirectoryPrefix.length].intValue;
+    if (processIdentifier <= 0 || kill(processIdentifier, 0) == 0 || errno != ESRCH) {
+      continue;
+    }
+    [NSFileManager.defaultManager removeItemAtPath:[temporaryDirectory stringByAppendingPathComponent:name] error:nil];
+  }
+}
+
+- (nullable NSString *)contentHashOfFileAtPath:(NSString *)path error:(NSError **)error
+{
+  int fileDescriptor = open(path.fileSystemRepresentation, O_RDONLY | O_CLOEXEC);
+  if (fileDescriptor < 0) {
+    return [[FBControlCoreError
+      describeFormat:@"Could not open %@ for hashing: %s", path, strerror(errno)]
+      fail:error];
+  }
+  // The hash of a file that has not changed since it was last hashed is re-used, so a fan-out of installs reads the archive once.
+  struct stat info;
+  if (fstat(fileDescriptor, &info) != 0) {
+    close(fileDescriptor);
+    return [[FBControlCoreError
+      describeFormat:@"Could not stat %@ for hashing: %s", path, strerror(errno)]
+      fail:error];
+  }
+  NSString *identity = FBArchiveExtractionCacheFileIdentity(&info);
+  @synchronized (self.hashes) {
+    NSString *hash = self.hashes[identity];
+    if (hash) {
+      close(fileDescriptor);
+      return hash;
+    }
+  }
+
+  CC_SHA256_CTX context;
+  CC_SHA256_Init(&context);
+  uint8_t *buffer = malloc(FBArchiveExtractionCacheHashBufferSize);
+  ssize_t length = 0;
+  while ((length = read(fileDescriptor, buffer, FBArchiveExtractionCacheHashBufferSize)) != 0) {
+    if (length < 0 && errno == EINTR) {
+      continue;
+    }
+    if (length < 0) {
+      int code = errno;
+      free(buffer);
+      close(fileDescriptor);
+      return [[FBControlCoreError
+        describeFormat:@"Could not read %@ for hashing: %s", path, strerror(code)]
+        fail:error];
+    }
+    CC_SHA256_Update(&context, buffer, (CC_LONG) length);
+  }
+  free(buffer);
+  close(fileDescriptor);
+
+  NSString *hash = FBArchiveExtractionCacheFinalizeHash(&context);
+  @synchronized (self.hashes) {
+    self.hashes[identity] = hash;
+  }
+  return hash;
+}
+
+@end
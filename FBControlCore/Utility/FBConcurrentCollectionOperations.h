@@ -14,6 +14,10 @@ NS_ASSUME_NONNULL_BEGIN
 /**
  Conveniences for concurent collection operations.
  The Predicates and Blocks Passed to these functions must work in a thread-safe manner, inspecting immutable values is the way to go.
+
+ Work is claimed by each worker in contiguous ranges, that shrink as the remaining work decreases.
+ This keeps the overhead low for cheap blocks, whilst balancing expensive blocks between workers at the end.
+ Results are written to distinct slots of a buffer, so no lock is taken for each element.
  */
 @interface FBConcurrentCollectionOperations : NSObject
 
@@ -64,6 +68,19 @@ NS_ASSUME_NONNULL_BEGIN
  */
 + (NSArray *)filterMap:(NSArray *)array predicate:(NSPredicate *)predicate map:(id (^)(id))block;
 
+/**
+ Map an array of objects concurrently, then reduce the mapped objects in the order of the array.
+ Mapped objects that are nil are not passed to the reducer.
+ The reducer is called serially, on the calling thread, so it may mutate the accumulator.
+
+ @param array the array to map/reduce.
+ @param block the block to map objects with.
+ @param initial the initial value of the accumulator.
+ @param reduce the block to reduce mapped objects with, returning the next value of the accumulator.
+ @return the final value of the accumulator.
+ */
++ (id)mapReduce:(NSArray *)array map:(id (^)(id))block initial:(id)initial reduce:(id (^)(id accumulator, id object))reduce;
+
 @end
 
 NS_ASSUME_NONNULL_END
@@ -9,25 +9,72 @@
 
 #import "FBConcurrentCollectionOperations.h"
 
-@interface FBConcurrentCollectionOperations_FilterTerminal : NSObject
+typedef void (^FBConcurrentRangeBlock)(NSUInteger start, NSUInteger end);
 
-+ (instancetype)terminal;
+static dispatch_queue_t FBConcurrentQueue(void)
+{
+  return dispatch_get_global_queue(DISPATCH_QUEUE_PRIORITY_HIGH, 0);
+}
 
-@end
+static void FBConcurrentApply(NSUInteger count, FBConcurrentRangeBlock block)
+{
+  if (count == 0) {
+    return;
+  }
+  NSUInteger workers = MIN(NSProcessInfo.processInfo.activeProcessorCount, count);
+  if (workers <= 1) {
+    block(0, count);
+    return;
+  }
 
-@implementation FBConcurrentCollectionOperations_FilterTerminal
+  // Each worker claims a range from the cursor until none remain.
+  // A range is a fraction of the remaining work, so grains are large to begin with and shrink to single elements at the end.
+  // An idle worker takes work that would otherwise have been claimed by a busy one.
+  __block NSUInteger cursor = 0;
+  NSUInteger divisor = workers * 2;
+  dispatch_apply(workers, FBConcurrentQueue(), ^(size_t _) {
+    NSUInteger start = __atomic_load_n(&cursor, __ATOMIC_RELAXED);
+    while (start < count) {
+      NSUInteger grain = MAX((count - start) / divisor, 1u);
+      NSUInteger end = MIN(start + grain, count);
+      if (!__atomic_compare_exchange_n(&cursor, &start, end, YES, __ATOMIC_RELAXED, __ATOMIC_RELAXED)) {
+        continue;
+      }
+      block(start, end);
+      start = __atomic_load_n(&cursor, __ATOMIC_RELAXED);
+    }
+  });
+}
 
-+ (instancetype)terminal
+static __strong id *FBConcurrentBufferCreate(NSUInteger count)
 {
-  static dispatch_once_t onceToken;
-  static FBConcurrentCollectionOperations_FilterTerminal *terminal;
-  dispatch_once(&onceToken, ^{
-    terminal = [FBConcurrentCollectionOperations_FilterTerminal new];
-  });
-  return terminal;
+  return (__strong id *) calloc(MAX(count, 1u), sizeof(id));
 }
 
-@end
+static void FBConcurrentBufferFree(__strong id *buffer, NSUInteger count)
+{
+  for (NSUInteger index = 0; index < count; index++) {
+    buffer[index] = nil;
+  }
+  free(buffer);
+}
+
+static NSArray *FBConcurrentBufferCompact(__strong id *buffer, NSUInteger count)
+{
+  // Move the elements that are present to the front, preserving their order.
+  NSUInteger kept = 0;
+  for (NSUInteger index = 0; index < count; index++) {
+    if (!buffer[index]) {
+      continue;
+    }
+    if (kept != index) {
+      buffer[kept] = buffer[index];
+      buffer[index] = nil;
+    }
+    kept++;
+  }
+  return [NSArray arrayWithObjects:buffer count:kept];
+}
 
 @implementation FBConcurrentCollectionOperations
 
@@ -35,28 +82,24 @@
 
 + (NSArray *)generate:(NSUInteger)count withBlock:( id(^)(NSUInteger index) )block
 {
-  NSMutableArray *array = [NSMutableArray array];
-  for (NSUInteger index = 0; index < count; index++) {
-    [array addObject:NSNull.null];
-  }
-
-  dispatch_apply((size_t) count, dispatch_get_global_queue(DISPATCH_QUEUE_PRIORITY_HIGH, 0), ^ (size_t iteration) {
-    id object = block(iteration);
-    if (object) {
-      @synchronized(array) {
-        array[iteration] = object;
-      }
+  __strong id *buffer = FBConcurrentBufferCreate(count);
+  FBConcurrentApply(count, ^(NSUInteger start, NSUInteger end) {
+    for (NSUInteger index = start; index < end; index++) {
+      buffer[index] = block(index) ?: NSNull.null;
     }
   });
-  return [array copy];
+  NSArray *array = [NSArray arrayWithObjects:buffer count:count];
+  FBConcurrentBufferFree(buffer, count);
+  return array;
 }
 
 + (NSArray *)map:(NSArray *)array withBlock:( id(^)(id object) )block
 {
+  NSArray *input = [array copy];
   return [self
-    generate:array.count
+    generate:input.count
     withBlock:^ id (NSUInteger index) {
-      return block(array[index]);
+      return block(input[index]);
     }];
 }
 
@@ -69,58 +112,62 @@
 
 + (NSArray *)mapFilter:(NSArray *)array map:(id (^)(id))block predicate:(NSPredicate *)predicate
 {
-  NSMutableArray *output = [NSMutableArray array];
-  for (NSUInteger index = 0; index < array.count; index++) {
-    [output addObject:NSNull.null];
-  }
-
-  dispatch_apply(array.count, dispatch_get_global_queue(DISPATCH_QUEUE_PRIORITY_HIGH, 0), ^ (size_t iteration) {
-    id object = block(array[iteration]);
-    BOOL pass = [predicate evaluateWithObject:object];
-    if (!pass) {
-      object = FBConcurrentCollectionOperations_FilterTerminal.terminal;
-    }
-    else if (!object) {
-      object = NSNull.null;
-    }
-    @synchronized(output) {
-      output[iteration] = object;
+  NSArray *input = [array copy];
+  NSUInteger count = input.count;
+  __strong id *buffer = FBConcurrentBufferCreate(count);
+  FBConcurrentApply(count, ^(NSUInteger start, NSUInteger end) {
+    for (NSUInteger index = start; index < end; index++) {
+      id object = block(input[index]);
+      if (![predicate evaluateWithObject:object]) {
+        continue;
+      }
+      buffer[index] = object ?: NSNull.null;
     }
   });
-
-  return [output filteredArrayUsingPredicate:self.nonTerminalPredicate];
+  NSArray *output = FBConcurrentBufferCompact(buffer, count);
+  FBConcurrentBufferFree(buffer, count);
+  return output;
 }
 
 + (NSArray *)filterMap:(NSArray *)array predicate:(NSPredicate *)predicate map:(id (^)(id))block
 {
-  return [[self
-    map:array
-    withBlock:^ id (id object) {
-      BOOL pass = [predicate evaluateWithObject:object];
-      if (!pass) {
-        return FBConcurrentCollectionOperations_FilterTerminal.terminal;
-      }
-      object = block(object);
-      if (!object) {
-        return NSNull.null;
+  NSArray *input = [array copy];
+  NSUInteger count = input.count;
+  __strong id *buffer = FBConcurrentBufferCreate(count);
+  FBConcurrentApply(count, ^(NSUInteger start, NSUInteger end) {
+    for (NSUInteger index = start; index < end; index++) {
+      id object = input[index];
+      if (![predicate evaluateWithObject:object]) {
+        continue;
       }
-      return object;
-    }]
-    filteredArrayUsingPredicate:self.nonTerminalPredicate];
+      buffer[index] = block(object) ?: NSNull.null;
+    }
+  });
+  NSArray *output = FBConcurrentBufferCompact(buffer, count);
+  FBConcurrentBufferFree(buffer, count);
+  return output;
 }
 
-#pragma mark Private
-
-+ (NSPredicate *)nonTerminalPredicate
++ (id)mapReduce:(NSArray *)array map:(id (^)(id))block initial:(id)initial reduce:(id (^)(id accumulator, id object))reduce
 {
-  static dispatch_once_t onceToken;
-  static NSPredicate *predicate;
-  dispatch_once(&onceToken, ^{
-    predicate = [NSPredicate predicateWithBlock:^ BOOL (id evaluatedObject, NSDictionary *_) {
-      return evaluatedObject != FBConcurrentCollectionOperations_FilterTerminal.terminal;
-    }];
+  NSArray *input = [array copy];
+  NSUInteger count = input.count;
+  __strong id *buffer = FBConcurrentBufferCreate(count);
+  FBConcurrentApply(count, ^(NSUInteger start, NSUInteger end) {
+    for (NSUInteger index = start; index < end; index++) {
+      buffer[index] = block(input[index]);
+    }
   });
-  return predicate;
+  id accumulator = initial;
+  for (NSUInteger index = 0; index < count; index++) {
+    id object = buffer[index];
+    if (!object) {
+      continue;
+    }
+    accumulator = reduce(accumulator, object);
+  }
+  FBConcurrentBufferFree(buffer, count);
+  return accumulator;
 }
 
 @end
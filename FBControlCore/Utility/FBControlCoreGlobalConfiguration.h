@@ -25,6 +25,16 @@ extern NSString *const FBControlCoreStderrLogging;
  */
 extern NSString *const FBControlCoreDebugLogging;
 
+/**
+ An Environment Variable: 'FBCONTROLCORE_FUTURE_TRACE_PATH' to record a trace of Futures, written to the given path as Chrome Trace Event JSON.
+ */
+extern NSString *const FBControlCoreFutureTracePath;
+
+/**
+ An Environment Variable: 'FBCONTROLCORE_CRASH_LOG_INDEX_PATH' to persist the default Crash Log Index to the given path, instead of the user's Caches directory.
+ */
+extern NSString *const FBControlCoreCrashLogIndexPath;
+
 /**
  Environment Globals & other derived constants.
  These values can be accessed before the Private Frameworks are loaded.
@@ -61,6 +71,16 @@ extern NSString *const FBControlCoreDebugLogging;
  */
 @property (nonatomic, assign, readonly, class) BOOL confirmCodesignaturesAreValid;
 
+/**
+ The path to write a trace of Futures to, if tracing has been requested.
+ */
+@property (nonatomic, copy, nullable, readonly, class) NSString *futureTracePath;
+
+/**
+ The path to persist the default Crash Log Index to.
+ */
+@property (nonatomic, copy, nullable, readonly, class) NSString *crashLogIndexPath;
+
 @end
 
 NS_ASSUME_NONNULL_END
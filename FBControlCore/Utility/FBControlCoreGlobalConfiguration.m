@@ -15,6 +15,8 @@
 
 NSString *const FBControlCoreStderrLogging = @"FBCONTROLCORE_LOGGING";
 NSString *const FBControlCoreDebugLogging = @"FBCONTROLCORE_DEBUG_LOGGING";
+NSString *const FBControlCoreFutureTracePath = @"FBCONTROLCORE_FUTURE_TRACE_PATH";
+NSString *const FBControlCoreCrashLogIndexPath = @"FBCONTROLCORE_CRASH_LOG_INDEX_PATH";
 NSString *const ConfirmShimsAreSignedEnv = @"FBCONTROLCORE_CONFIRM_SIGNED_SHIMS";
 
 static id<FBControlCoreLogger> logger;
@@ -58,6 +60,22 @@ static id<FBControlCoreLogger> logger;
   return NSProcessInfo.processInfo.environment[ConfirmShimsAreSignedEnv].boolValue;
 }
 
++ (NSString *)futureTracePath
+{
+  NSString *path = NSProcessInfo.processInfo.environment[FBControlCoreFutureTracePath];
+  return path.length > 0 ? path : nil;
+}
+
++ (NSString *)crashLogIndexPath
+{
+  NSString *path = NSProcessInfo.processInfo.environment[FBControlCoreCrashLogIndexPath];
+  if (path.length > 0) {
+    return path;
+  }
+  NSString *caches = NSSearchPathForDirectoriesInDomains(NSCachesDirectory, NSUserDomainMask, YES).firstObject;
+  return caches ? [caches stringByAppendingPathComponent:@"com.facebook.FBControlCore/crash_log_index.json"] : nil;
+}
+
 + (NSString *)description
 {
   return [NSString stringWithFormat:@"Default Logger %@", logger];
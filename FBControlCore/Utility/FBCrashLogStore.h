@@ -91,6 +91,14 @@ NS_ASSUME_NONNULL_BEGIN
  */
 - (FBFuture<FBCrashLogInfo *> *)nextCrashLogForMatchingPredicate:(NSPredicate *)predicate;
 
+/**
+ A future that resolves with an ingested crash log that matches the given predicate, or the next one to become available.
+
+ @param predicate the predicate to use.
+ @return a Future that resolves with the first crash log matching the predicate.
+ */
+- (FBFuture<FBCrashLogInfo *> *)crashLogForMatchingPredicate:(NSPredicate *)predicate;
+
 /**
  Obtains all of the ingested logs that match the given predicate.
 
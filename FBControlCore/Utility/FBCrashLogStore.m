@@ -9,6 +9,7 @@
 
 #import "FBCrashLogStore.h"
 
+#import "FBCrashLogIndex.h"
 #import "FBCrashLogInfo.h"
 #import "FBControlCoreLogger.h"
 
@@ -106,7 +107,9 @@ FBCrashLogNotificationName const FBCrashLogAppeared = @"FBCrashLogAppeared";
   if (!crashLog) {
     return nil;
   }
-  [self.ingestedCrashLogs removeObjectForKey:key];
+  @synchronized (self.ingestedCrashLogs) {
+    [self.ingestedCrashLogs removeObjectForKey:key];
+  }
   return crashLog;
 }
 
@@ -114,39 +117,53 @@ FBCrashLogNotificationName const FBCrashLogAppeared = @"FBCrashLogAppeared";
 
 - (FBCrashLogInfo *)ingestedCrashLogWithName:(NSString *)name
 {
-  return self.ingestedCrashLogs[name];
+  @synchronized (self.ingestedCrashLogs) {
+    return self.ingestedCrashLogs[name];
+  }
 }
 
 - (NSArray<FBCrashLogInfo *> *)allIngestedCrashLogs
 {
-  return self.ingestedCrashLogs.allValues;
+  @synchronized (self.ingestedCrashLogs) {
+    return self.ingestedCrashLogs.allValues;
+  }
 }
 
 - (FBFuture<FBCrashLogInfo *> *)nextCrashLogForMatchingPredicate:(NSPredicate *)predicate
 {
   return [FBFuture
     onQueue:self.queue resolve:^ FBFuture<FBCrashLogInfo *> * {
-      return [FBCrashLogStore oneshotCrashLogNotificationForPredicate:predicate queue:self.queue];
+      return [self oneshotCrashLogNotificationForPredicate:predicate includeIngested:NO];
+    }];
+}
+
+- (FBFuture<FBCrashLogInfo *> *)crashLogForMatchingPredicate:(NSPredicate *)predicate
+{
+  return [FBFuture
+    onQueue:self.queue resolve:^ FBFuture<FBCrashLogInfo *> * {
+      return [self oneshotCrashLogNotificationForPredicate:predicate includeIngested:YES];
     }];
 }
 
 - (NSArray<FBCrashLogInfo *> *)ingestedCrashLogsMatchingPredicate:(NSPredicate *)predicate
 {
-  return [self.ingestedCrashLogs.allValues filteredArrayUsingPredicate:predicate];
+  return [self.allIngestedCrashLogs filteredArrayUsingPredicate:predicate];
 }
 
 - (NSArray<FBCrashLogInfo *> *)pruneCrashLogsMatchingPredicate:(NSPredicate *)predicate
 {
   NSMutableArray<NSString *> *keys = NSMutableArray.array;
   NSMutableArray<FBCrashLogInfo *> *crashLogs = NSMutableArray.array;
-  for (FBCrashLogInfo *crashLog in self.ingestedCrashLogs.allValues) {
+  for (FBCrashLogInfo *crashLog in self.allIngestedCrashLogs) {
     if (![predicate evaluateWithObject:crashLog]) {
       continue;
     }
     [keys addObject:crashLog.name];
     [crashLogs addObject:crashLog];
   }
-  [self.ingestedCrashLogs removeObjectsForKeys:keys];
+  @synchronized (self.ingestedCrashLogs) {
+    [self.ingestedCrashLogs removeObjectsForKeys:keys];
+  }
   return crashLogs;
 }
 
@@ -154,26 +171,29 @@ FBCrashLogNotificationName const FBCrashLogAppeared = @"FBCrashLogAppeared";
 
 - (BOOL)hasIngestedCrashLogWithName:(NSString *)key
 {
-  return self.ingestedCrashLogs[key] != nil;
+  return [self ingestedCrashLogWithName:key] != nil;
 }
 
 - (FBCrashLogInfo *)ingestCrashLog:(FBCrashLogInfo *)crashLog
 {
   [self.logger logFormat:@"Ingesting Crash Log %@", crashLog];
-  self.ingestedCrashLogs[crashLog.name] = crashLog;
+  @synchronized (self.ingestedCrashLogs) {
+    self.ingestedCrashLogs[crashLog.name] = crashLog;
+  }
   [NSNotificationCenter.defaultCenter postNotificationName:FBCrashLogAppeared object:crashLog];
   return crashLog;
 }
 
-+ (FBFuture<FBCrashLogInfo *> *)oneshotCrashLogNotificationForPredicate:(NSPredicate *)predicate queue:(dispatch_queue_t)queue
+- (FBFuture<FBCrashLogInfo *> *)oneshotCrashLogNotificationForPredicate:(NSPredicate *)predicate includeIngested:(BOOL)includeIngested
 {
   __weak NSNotificationCenter *notificationCenter = [NSNotificationCenter defaultCenter];
   FBMutableFuture<FBCrashLogInfo *> *future = [FBMutableFuture future];
 
+  // The notification is handled on the posting thread, rather than hopping to the main queue which may be busy.
   id __block observer = [notificationCenter
     addObserverForName:FBCrashLogAppeared
     object:nil
-    queue:NSOperationQueue.mainQueue
+    queue:nil
     usingBlock:^(NSNotification *notification) {
       FBCrashLogInfo *crashLog = notification.object;
       if (![predicate evaluateWithObject:crashLog]) {
@@ -183,7 +203,14 @@ FBCrashLogNotificationName const FBCrashLogAppeared = @"FBCrashLogAppeared";
       [notificationCenter removeObserver:observer];
     }];
 
-  return [future onQueue:queue respondToCancellation:^{
+  // The ingested crash logs are checked after observing, so a crash log that is ingested in between is not missed.
+  FBCrashLogInfo *ingested = includeIngested ? [self ingestedCrashLogsMatchingPredicate:predicate].firstObject : nil;
+  if (ingested) {
+    [future resolveWithResult:ingested];
+    [notificationCenter removeObserver:observer];
+  }
+
+  return [future onQueue:self.queue respondToCancellation:^{
     [notificationCenter removeObserver:observer];
     return [FBFuture futureWithResult:NSNull.null];
   }];
@@ -191,18 +218,13 @@ FBCrashLogNotificationName const FBCrashLogAppeared = @"FBCrashLogAppeared";
 
 - (NSArray<FBCrashLogInfo *> *)ingestCrashLogInDirectory:(NSString *)directory
 {
-  NSArray<NSString *> *contents = [NSFileManager.defaultManager contentsOfDirectoryAtPath:directory error:nil];
-  if (!contents) {
-    return @[];
-  }
-
+  // Crash logs that have been parsed before, including by a previous process, are obtained from the index.
   NSMutableArray<FBCrashLogInfo *> *ingested = NSMutableArray.array;
-  for (NSString *path in contents) {
-    FBCrashLogInfo *crash = [self ingestCrashLogAtPath:[directory stringByAppendingPathComponent:path]];
-    if (!crash) {
+  for (FBCrashLogInfo *crash in [FBCrashLogIndex.defaultIndex crashLogsInDirectory:directory extension:nil modifiedAfter:nil]) {
+    if ([self hasIngestedCrashLogWithName:crash.name]) {
       continue;
     }
-    [ingested addObject:crash];
+    [ingested addObject:[self ingestCrashLog:crash]];
   }
   return [ingested copy];
 }
@@ -64,6 +64,30 @@ NS_ASSUME_NONNULL_BEGIN
 
 @end
 
+/**
+ Allows a producer to observe whether a consumer has room for more data.
+ Producers that honour this can pause, rather than allowing data to accumulate in memory.
+ */
+@protocol FBDataConsumerBackpressure <NSObject>
+
+/**
+ The number of pending bytes, above which the consumer is considered saturated.
+ */
+@property (nonatomic, assign, readonly) size_t highWaterMark;
+
+/**
+ The number of bytes that have been consumed, but not yet delivered.
+ */
+@property (atomic, assign, readonly) size_t pendingBytes;
+
+/**
+ A Future that resolves when the pending bytes are below the high water mark.
+ If the consumer is not currently saturated, the future will be resolved immediately.
+ */
+- (FBFuture<NSNull *> *)hasCapacity;
+
+@end
+
 /**
  The non-mutating methods of a buffer.
  */
@@ -143,6 +167,7 @@ NS_ASSUME_NONNULL_BEGIN
 
 /**
  Adapts a NSData consumer to a dispatch_data consumer.
+ If the consumer was itself adapted from a dispatch_data consumer, the original consumer is returned so that data is not flattened.
 
  @param consumer the consumer to adapt.
  @return a dispatch_data consumer.
@@ -196,6 +221,14 @@ NS_ASSUME_NONNULL_BEGIN
  */
 + (id<FBConsumableBuffer>)consumableBuffer;
 
+/**
+ A line buffer that is appended to by consuming data and can be drained.
+ Consumed data is tracked with a read cursor and reclaimed in bulk, so draining n lines is linear in the size of the buffer.
+
+ @return a FBConsumableBuffer implementation.
+ */
++ (id<FBConsumableBuffer>)cursorConsumableBuffer;
+
 @end
 
 /**
@@ -243,6 +276,33 @@ NS_ASSUME_NONNULL_BEGIN
 
 @end
 
+/**
+ A Reader of dispatch_data, calling the callback when a full line is available.
+ Lines are delivered as sub-ranges of the consumed data, so are not copied or flattened.
+ */
+@interface FBLineDispatchDataConsumer : NSObject <FBDispatchDataConsumer, FBDataConsumerLifecycle>
+
+/**
+ Creates a Consumer of lines from a block.
+ Lines will be delivered synchronously.
+
+ @param consumer the block to call when a line has been consumed.
+ @return a new Line Reader.
+ */
++ (instancetype)synchronousReaderWithConsumer:(void (^)(dispatch_data_t))consumer;
+
+/**
+ Creates a Consumer of lines from a block.
+ Lines will be delivered asynchronously to the given queue.
+
+ @param queue the queue to call the consumer from.
+ @param consumer the block to call when a line has been consumed.
+ @return a new Line Reader.
+ */
++ (instancetype)asynchronousReaderWithQueue:(dispatch_queue_t)queue consumer:(void (^)(dispatch_data_t))consumer;
+
+@end
+
 @protocol FBControlCoreLogger;
 
 /**
@@ -277,6 +337,63 @@ NS_ASSUME_NONNULL_BEGIN
 
 @end
 
+/**
+ A Composite Consumer of dispatch_data.
+ The same immutable dispatch_data is passed to each of the consumers.
+ */
+@interface FBCompositeDispatchDataConsumer : NSObject <FBDispatchDataConsumer, FBDataConsumerLifecycle>
+
+/**
+ A Consumer of Consumers.
+
+ @param consumers the consumers to compose.
+ @return a new consumer.
+ */
++ (instancetype)consumerWithConsumers:(NSArray<id<FBDispatchDataConsumer>> *)consumers;
+
+@end
+
+/**
+ The behaviour of a bounded consumer, when the high water mark would be exceeded.
+ */
+typedef NS_ENUM(NSUInteger, FBDataConsumerOverflowPolicy) {
+  FBDataConsumerOverflowPolicyBlock = 0, // The producer is blocked until there is capacity.
+  FBDataConsumerOverflowPolicyDropOldest = 1, // The oldest pending chunks are dropped, then the oldest bytes of the incoming chunk if data being delivered still exceeds the high water mark.
+  FBDataConsumerOverflowPolicyDropNewest = 2, // The incoming chunk is dropped, unless nothing is pending.
+  FBDataConsumerOverflowPolicyCoalesce = 3, // Pending chunks are merged into one, retaining the most recent bytes up to the high water mark.
+};
+
+/**
+ A Consumer that bounds the amount of data that is pending delivery to a wrapped consumer.
+ Data is delivered to the wrapped consumer asynchronously on a serial queue.
+ Once the pending data exceeds the high water mark, the overflow policy is applied.
+ */
+@interface FBBoundedDataConsumer : NSObject <FBDataConsumer, FBDataConsumerLifecycle, FBDataConsumerBackpressure>
+
+/**
+ Creates a bounded consumer.
+ When using FBDataConsumerOverflowPolicyBlock, the producer must not call the consumer from the delivery queue.
+
+ @param consumer the consumer to deliver to.
+ @param queue the serial queue to deliver on.
+ @param highWaterMark the number of pending bytes, above which the overflow policy applies.
+ @param policy the overflow policy.
+ @return a new consumer.
+ */
++ (instancetype)consumerWithConsumer:(id<FBDataConsumer>)consumer queue:(dispatch_queue_t)queue highWaterMark:(size_t)highWaterMark policy:(FBDataConsumerOverflowPolicy)policy;
+
+/**
+ The overflow policy.
+ */
+@property (nonatomic, assign, readonly) FBDataConsumerOverflowPolicy policy;
+
+/**
+ The number of bytes that have been dropped by the overflow policy.
+ */
+@property (atomic, assign, readonly) size_t droppedBytes;
+
+@end
+
 /**
  A consumer that does nothing with the data.
  */
@@ -97,11 +97,17 @@
 
 + (id<FBDispatchDataConsumer>)dispatchDataConsumerForDataConsumer:(id<FBDataConsumer>)consumer;
 {
+  if ([consumer isKindOfClass:FBDataConsumerAdaptor_ToDispatchData.class]) {
+    return [(FBDataConsumerAdaptor_ToDispatchData *) consumer consumer];
+  }
   return [[FBDataConsumerAdaptor_ToNSData alloc] initWithConsumer:consumer];
 }
 
 + (id<FBDataConsumer, FBDataConsumerLifecycle>)dataConsumerForDispatchDataConsumer:(id<FBDispatchDataConsumer, FBDataConsumerLifecycle>)consumer;
 {
+  if ([consumer isKindOfClass:FBDataConsumerAdaptor_ToNSData.class] && [[(FBDataConsumerAdaptor_ToNSData *) consumer consumer] conformsToProtocol:@protocol(FBDataConsumerLifecycle)]) {
+    return (id<FBDataConsumer, FBDataConsumerLifecycle>) [(FBDataConsumerAdaptor_ToNSData *) consumer consumer];
+  }
   return [[FBDataConsumerAdaptor_ToDispatchData alloc] initWithConsumer:consumer];
 }
 
@@ -155,6 +161,14 @@
 
 @end
 
+@interface FBLineBuffer_CursorConsumable : FBLineBuffer_Consumable
+
+@property (nonatomic, assign, readwrite) NSUInteger readOffset;
+@property (nonatomic, copy, nullable, readwrite) NSData *scannedTerminal;
+@property (nonatomic, assign, readwrite) NSUInteger scannedOffset;
+
+@end
+
 @implementation FBLineBuffer_Accumilating
 
 #pragma mark Initializers
@@ -333,6 +347,116 @@
 
 @end
 
+/**
+ Finds the first occurrence of the terminal in the bytes between start and end.
+ memchr is used to skip to candidate positions, as it is vectorized by libc.
+ */
+static NSUInteger FBLocateTerminal(const uint8_t *bytes, NSUInteger start, NSUInteger end, const uint8_t *terminal, NSUInteger terminalLength)
+{
+  if (terminalLength == 0 || end < start + terminalLength) {
+    return NSNotFound;
+  }
+  const uint8_t *cursor = bytes + start;
+  const uint8_t *limit = bytes + end - terminalLength + 1;
+  while (cursor < limit) {
+    const uint8_t *candidate = memchr(cursor, terminal[0], (size_t) (limit - cursor));
+    if (!candidate) {
+      return NSNotFound;
+    }
+    if (memcmp(candidate, terminal, terminalLength) == 0) {
+      return (NSUInteger) (candidate - bytes);
+    }
+    cursor = candidate + 1;
+  }
+  return NSNotFound;
+}
+
+// Consumed bytes at the front of the buffer are only reclaimed once they are at least this large and make up half the buffer.
+// This makes the cost of reclaiming consumed bytes amortized O(1) per byte, rather than O(n) per consumed line.
+static NSUInteger const FBLineBufferCompactionThreshold = 4096;
+
+@implementation FBLineBuffer_CursorConsumable
+
+#pragma mark NSObject
+
+- (NSString *)description
+{
+  @synchronized (self) {
+    return [NSString stringWithFormat:@"Cursor Consumable Buffer %lu Bytes", self.buffer.length - self.readOffset];
+  }
+}
+
+#pragma mark FBAccumilatingLineBuffer
+
+- (NSData *)data
+{
+  @synchronized (self) {
+    return [self.buffer subdataWithRange:NSMakeRange(self.readOffset, self.buffer.length - self.readOffset)];
+  }
+}
+
+#pragma mark FBConsumableBuffer
+
+- (nullable NSData *)consumeCurrentData
+{
+  @synchronized (self) {
+    NSData *data = self.data;
+    self.buffer.length = 0;
+    self.readOffset = 0;
+    self.scannedTerminal = nil;
+    self.scannedOffset = 0;
+    return data;
+  }
+}
+
+- (nullable NSData *)consumeUntil:(NSData *)terminal
+{
+  @synchronized (self) {
+    NSUInteger length = self.buffer.length;
+    if (length == self.readOffset) {
+      return nil;
+    }
+    // Bytes that have already been scanned for the same terminal do not need to be scanned again.
+    // The overlap of the terminal length is preserved, so that a terminal split across two writes is found.
+    NSUInteger start = self.readOffset;
+    if ([terminal isEqualToData:self.scannedTerminal] && self.scannedOffset + 1 > start + terminal.length) {
+      start = self.scannedOffset + 1 - terminal.length;
+    }
+    const uint8_t *bytes = self.buffer.bytes;
+    NSUInteger location = FBLocateTerminal(bytes, start, length, terminal.bytes, terminal.length);
+    if (location == NSNotFound) {
+      self.scannedTerminal = terminal;
+      self.scannedOffset = length;
+      return nil;
+    }
+    NSData *lineData = [NSData dataWithBytes:bytes + self.readOffset length:location - self.readOffset];
+    self.readOffset = location + terminal.length;
+    self.scannedTerminal = nil;
+    self.scannedOffset = 0;
+    [self compactIfNeeded];
+    return lineData;
+  }
+}
+
+#pragma mark Private
+
+- (void)compactIfNeeded
+{
+  NSUInteger length = self.buffer.length;
+  if (self.readOffset == length) {
+    self.buffer.length = 0;
+    self.readOffset = 0;
+    return;
+  }
+  if (self.readOffset < FBLineBufferCompactionThreshold || self.readOffset < length / 2) {
+    return;
+  }
+  [self.buffer replaceBytesInRange:NSMakeRange(0, self.readOffset) withBytes:NULL length:0];
+  self.readOffset = 0;
+}
+
+@end
+
 @implementation FBLineBuffer
 
 #pragma mark Initializers
@@ -352,6 +476,11 @@
   return [FBLineBuffer_Consumable new];
 }
 
++ (id<FBConsumableBuffer>)cursorConsumableBuffer
+{
+  return [FBLineBuffer_CursorConsumable new];
+}
+
 @end
 
 @interface FBLineDataConsumer ()
@@ -405,7 +534,7 @@ static inline dataBlock FBDataConsumerBlock (void(^consumer)(NSString *)) {
 
   _queue = queue;
   _consumer = consumer;
-  _buffer = FBLineBuffer.consumableBuffer;
+  _buffer = FBLineBuffer.cursorConsumableBuffer;
   _eofHasBeenReceivedFuture = FBMutableFuture.future;
 
   return self;
@@ -469,6 +598,133 @@ static inline dataBlock FBDataConsumerBlock (void(^consumer)(NSString *)) {
 
 @end
 
+@interface FBLineDispatchDataConsumer ()
+
+@property (nonatomic, strong, nullable, readwrite) dispatch_queue_t queue;
+@property (nonatomic, copy, nullable, readwrite) void (^consumer)(dispatch_data_t);
+@property (nonatomic, strong, nullable, readwrite) dispatch_data_t buffer;
+@property (nonatomic, assign, readwrite) size_t scannedOffset;
+@property (nonatomic, strong, readonly) FBMutableFuture<NSNull *> *eofHasBeenReceivedFuture;
+
+@end
+
+@implementation FBLineDispatchDataConsumer
+
+#pragma mark Initializers
+
++ (instancetype)synchronousReaderWithConsumer:(void (^)(dispatch_data_t))consumer
+{
+  return [[self alloc] initWithQueue:nil consumer:consumer];
+}
+
++ (instancetype)asynchronousReaderWithQueue:(dispatch_queue_t)queue consumer:(void (^)(dispatch_data_t))consumer
+{
+  return [[self alloc] initWithQueue:queue consumer:consumer];
+}
+
+- (instancetype)initWithQueue:(dispatch_queue_t)queue consumer:(void (^)(dispatch_data_t))consumer
+{
+  self = [super init];
+  if (!self) {
+    return nil;
+  }
+
+  _queue = queue;
+  _consumer = consumer;
+  _buffer = dispatch_data_empty;
+  _eofHasBeenReceivedFuture = FBMutableFuture.future;
+
+  return self;
+}
+
+#pragma mark FBDispatchDataConsumer
+
+- (void)consumeData:(dispatch_data_t)data
+{
+  @synchronized (self) {
+    // Concatenation retains the regions of both, rather than copying them.
+    self.buffer = dispatch_data_create_concat(self.buffer, data);
+    [self dispatchAvailableLines];
+  }
+}
+
+- (void)consumeEndOfFile
+{
+  @synchronized (self) {
+    [self dispatchAvailableLines];
+    if (self.queue) {
+      dispatch_async(self.queue, ^{
+        [self tearDown];
+      });
+    } else {
+      [self tearDown];
+    }
+  }
+}
+
+#pragma mark FBDataConsumerLifecycle
+
+- (FBFuture<NSNull *> *)eofHasBeenReceived
+{
+  return self.eofHasBeenReceivedFuture;
+}
+
+#pragma mark Private
+
+- (void)dispatchAvailableLines
+{
+  dispatch_data_t buffer = self.buffer;
+  if (!buffer) {
+    return;
+  }
+  size_t scannedOffset = self.scannedOffset;
+  __block size_t lineStart = 0;
+  // Only the regions that have not previously been scanned are searched for a newline.
+  dispatch_data_apply(buffer, ^ bool (dispatch_data_t region, size_t offset, const void *bytes, size_t size) {
+    if (offset + size <= scannedOffset) {
+      return true;
+    }
+    const char *start = bytes;
+    const char *end = start + size;
+    const char *cursor = start + (scannedOffset > offset ? scannedOffset - offset : 0);
+    const char *newline = NULL;
+    while ((newline = memchr(cursor, '\n', (size_t) (end - cursor)))) {
+      size_t lineEnd = offset + (size_t) (newline - start);
+      [self dispatchLine:dispatch_data_create_subrange(buffer, lineStart, lineEnd - lineStart)];
+      lineStart = lineEnd + 1;
+      cursor = newline + 1;
+    }
+    return true;
+  });
+  size_t size = dispatch_data_get_size(buffer);
+  if (lineStart > 0) {
+    self.buffer = dispatch_data_create_subrange(buffer, lineStart, size - lineStart);
+  }
+  self.scannedOffset = size - lineStart;
+}
+
+- (void)dispatchLine:(dispatch_data_t)line
+{
+  void (^consumer)(dispatch_data_t) = self.consumer;
+  if (self.queue) {
+    dispatch_async(self.queue, ^{
+      consumer(line);
+    });
+  } else {
+    consumer(line);
+  }
+}
+
+- (void)tearDown
+{
+  self.consumer = nil;
+  self.queue = nil;
+  self.buffer = nil;
+  [self.eofHasBeenReceivedFuture resolveWithResult:NSNull.null];
+}
+
+@end
+
 @implementation FBLoggingDataConsumer
 
 #pragma mark Initializers
@@ -574,6 +830,276 @@ static inline dataBlock FBDataConsumerBlock (void(^consumer)(NSString *)) {
 
 @end
 
+@interface FBBoundedDataConsumer ()
+
+@property (nonatomic, strong, readonly) id<FBDataConsumer> consumer;
+@property (nonatomic, strong, readonly) dispatch_queue_t queue;
+@property (nonatomic, strong, readonly) NSCondition *condition;
+@property (nonatomic, strong, readonly) NSMutableArray<NSData *> *pending;
+@property (nonatomic, strong, readonly) FBMutableFuture<NSNull *> *eofHasBeenReceivedFuture;
+@property (nonatomic, strong, nullable, readwrite) FBMutableFuture<NSNull *> *capacityFuture;
+@property (nonatomic, assign, readwrite) BOOL draining;
+@property (nonatomic, assign, readwrite) BOOL eofPending;
+
+@property (atomic, assign, readwrite) size_t pendingBytes;
+@property (atomic, assign, readwrite) size_t droppedBytes;
+
+@end
+
+@implementation FBBoundedDataConsumer
+
+@synthesize highWaterMark = _highWaterMark;
+
+#pragma mark Initializers
+
++ (instancetype)consumerWithConsumer:(id<FBDataConsumer>)consumer queue:(dispatch_queue_t)queue highWaterMark:(size_t)highWaterMark policy:(FBDataConsumerOverflowPolicy)policy
+{
+  return [[self alloc] initWithConsumer:consumer queue:queue highWaterMark:highWaterMark policy:policy];
+}
+
+- (instancetype)initWithConsumer:(id<FBDataConsumer>)consumer queue:(dispatch_queue_t)queue highWaterMark:(size_t)highWaterMark policy:(FBDataConsumerOverflowPolicy)policy
+{
+  self = [super init];
+  if (!self) {
+    return nil;
+  }
+
+  _consumer = consumer;
+  _queue = queue;
+  _highWaterMark = highWaterMark;
+  _policy = policy;
+  _condition = [NSCondition new];
+  _pending = [NSMutableArray array];
+  _eofHasBeenReceivedFuture = FBMutableFuture.future;
+
+  return self;
+}
+
+#pragma mark NSObject
+
+- (NSString *)description
+{
+  return [NSString stringWithFormat:@"Bounded Consumer %lu/%lu Bytes Pending, %lu Dropped, of %@", self.pendingBytes, self.highWaterMark, self.droppedBytes, self.consumer];
+}
+
+#pragma mark FBDataConsumer
+
+- (void)consumeData:(NSData *)data
+{
+  [self.condition lock];
+  NSAssert(self.eofPending == NO && self.eofHasBeenReceived.hasCompleted == NO, @"Cannot consume data after eof recieved");
+  if (self.pendingBytes + data.length > self.highWaterMark) {
+    switch (self.policy) {
+      case FBDataConsumerOverflowPolicyBlock:
+        // A single chunk that is larger than the high water mark is permitted when nothing else is pending, otherwise it could never be delivered.
+        while (self.pendingBytes > 0 && self.pendingBytes + data.length > self.highWaterMark) {
+          [self.condition wait];
+        }
+        break;
+      case FBDataConsumerOverflowPolicyDropOldest:
+        while (self.pending.count > 0 && self.pendingBytes + data.length > self.highWaterMark) {
+          NSData *oldest = self.pending.firstObject;
+          [self.pending removeObjectAtIndex:0];
+          self.pendingBytes -= oldest.length;
+          self.droppedBytes += oldest.length;
+        }
+        // Bytes that are being delivered cannot be dropped, so the oldest bytes of the incoming chunk are dropped to stay within the high water mark.
+        if (self.pendingBytes + data.length > self.highWaterMark) {
+          size_t limit = self.highWaterMark > self.pendingBytes ? self.highWaterMark - self.pendingBytes : 0;
+          self.droppedBytes += data.length - limit;
+          if (limit == 0) {
+            [self.condition unlock];
+            return;
+          }
+          data = [data subdataWithRange:NSMakeRange(data.length - limit, limit)];
+        }
+        break;
+      case FBDataConsumerOverflowPolicyDropNewest:
+        // As with blocking, a chunk larger than the high water mark is delivered when nothing else is pending.
+        if (self.pendingBytes > 0) {
+          self.droppedBytes += data.length;
+          [self.condition unlock];
+          return;
+        }
+        break;
+      case FBDataConsumerOverflowPolicyCoalesce:
+        data = [self coalescePendingWithData:data];
+        break;
+    }
+  }
+  [self.pending addObject:data];
+  self.pendingBytes += data.length;
+  [self scheduleDrain];
+  [self.condition unlock];
+}
+
+- (void)consumeEndOfFile
+{
+  [self.condition lock];
+  NSAssert(self.eofPending == NO && self.eofHasBeenReceived.hasCompleted == NO, @"Cannot consume eof after eof recieved");
+  self.eofPending = YES;
+  [self scheduleDrain];
+  [self.condition unlock];
+}
+
+#pragma mark FBDataConsumerLifecycle
+
+- (FBFuture<NSNull *> *)eofHasBeenReceived
+{
+  return self.eofHasBeenReceivedFuture;
+}
+
+#pragma mark FBDataConsumerBackpressure
+
+- (FBFuture<NSNull *> *)hasCapacity
+{
+  [self.condition lock];
+  FBFuture<NSNull *> *future = nil;
+  if (self.pendingBytes < self.highWaterMark) {
+    future = [FBFuture futureWithResult:NSNull.null];
+  } else {
+    if (!self.capacityFuture) {
+      self.capacityFuture = [FBMutableFuture futureWithName:@"Bounded Consumer Capacity"];
+    }
+    future = self.capacityFuture;
+  }
+  [self.condition unlock];
+  return future;
+}
+
+#pragma mark Private
+
+- (NSData *)coalescePendingWithData:(NSData *)data
+{
+  // Called with the condition lock held.
+  // Bytes that are currently being delivered are not in the pending array, so are not part of the coalesced chunk.
+  size_t inflightBytes = self.pendingBytes;
+  NSMutableData *coalesced = [NSMutableData data];
+  for (NSData *chunk in self.pending) {
+    [coalesced appendData:chunk];
+    inflightBytes -= chunk.length;
+  }
+  [coalesced appendData:data];
+  [self.pending removeAllObjects];
+  self.pendingBytes = inflightBytes;
+
+  size_t limit = self.highWaterMark > inflightBytes ? self.highWaterMark - inflightBytes : 0;
+  if (coalesced.length <= limit) {
+    return coalesced;
+  }
+  size_t dropped = coalesced.length - limit;
+  self.droppedBytes += dropped;
+  return [coalesced subdataWithRange:NSMakeRange(dropped, limit)];
+}
+
+- (void)scheduleDrain
+{
+  // Called with the condition lock held.
+  if (self.draining) {
+    return;
+  }
+  self.draining = YES;
+  dispatch_async(self.queue, ^{
+    [self drain];
+  });
+}
+
+- (void)drain
+{
+  while (YES) {
+    [self.condition lock];
+    NSData *data = self.pending.firstObject;
+    if (!data) {
+      BOOL deliverEndOfFile = self.eofPending;
+      self.eofPending = NO;
+      self.draining = NO;
+      [self.condition unlock];
+      if (deliverEndOfFile) {
+        [self.consumer consumeEndOfFile];
+        [self.eofHasBeenReceivedFuture resolveWithResult:NSNull.null];
+      }
+      return;
+    }
+    [self.pending removeObjectAtIndex:0];
+    [self.condition unlock];
+
+    [self.consumer consumeData:data];
+
+    [self.condition lock];
+    self.pendingBytes -= data.length;
+    if (self.pendingBytes < self.highWaterMark && self.capacityFuture) {
+      [self.capacityFuture resolveWithResult:NSNull.null];
+      self.capacityFuture = nil;
+    }
+    [self.condition broadcast];
+    [self.condition unlock];
+  }
+}
+
+@end
+
+@interface FBCompositeDispatchDataConsumer ()
+
+@property (nonatomic, copy, readonly) NSArray<id<FBDispatchDataConsumer>> *consumers;
+@property (nonatomic, strong, readonly) FBMutableFuture<NSNull *> *eofHasBeenReceivedFuture;
+
+@end
+
+@implementation FBCompositeDispatchDataConsumer
+
+#pragma mark Initializers
+
++ (instancetype)consumerWithConsumers:(NSArray<id<FBDispatchDataConsumer>> *)consumers
+{
+  return [[self alloc] initWithConsumers:consumers];
+}
+
+- (instancetype)initWithConsumers:(NSArray<id<FBDispatchDataConsumer>> *)consumers
+{
+  self = [super init];
+  if (!self) {
+    return nil;
+  }
+
+  _consumers = consumers;
+  _eofHasBeenReceivedFuture = FBMutableFuture.future;
+
+  return self;
+}
+
+#pragma mark NSObject
+
+- (NSString *)description
+{
+  return [NSString stringWithFormat:@"Composite Dispatch Data Consumer %@", [FBCollectionInformation oneLineDescriptionFromArray:self.consumers]];
+}
+
+#pragma mark FBDispatchDataConsumer
+
+- (void)consumeData:(dispatch_data_t)data
+{
+  for (id<FBDispatchDataConsumer> consumer in self.consumers) {
+    [consumer consumeData:data];
+  }
+}
+
+- (void)consumeEndOfFile
+{
+  for (id<FBDispatchDataConsumer> consumer in self.consumers) {
+    [consumer consumeEndOfFile];
+  }
+  [self.eofHasBeenReceivedFuture resolveWithResult:NSNull.null];
+}
+
+#pragma mark FBDataConsumerLifecycle
+
+- (FBFuture<NSNull *> *)eofHasBeenReceived
+{
+  return self.eofHasBeenReceivedFuture;
+}
+
+@end
+
 @implementation FBNullDataConsumer
 
 #pragma mark FBDataConsumer
@@ -0,0 +1,104 @@
+/**
+ * Copyright (c) 2015-present, Facebook, Inc.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree. An additional grant
+ * of patent rights can be found in the PATENTS file in the same directory.
+ */
+
+#import <Foundation/Foundation.h>
+
+NS_ASSUME_NONNULL_BEGIN
+
+/**
+ The mechanism used to observe directories.
+ */
+typedef NS_ENUM(NSUInteger, FBDirectoryWatcherBackend) {
+  FBDirectoryWatcherBackendDefault = 0, /** Kernel notifications if they are available on the host, otherwise polling. */
+  FBDirectoryWatcherBackendFSEvents = 1, /** FSEvents, available on macOS. */
+  FBDirectoryWatcherBackendInotify = 2, /** inotify, available on Linux. */
+  FBDirectoryWatcherBackendPolling = 3, /** Periodically listing the directories, available everywhere. */
+};
+
+/**
+ The kind of change that has been observed for a file.
+ */
+typedef NS_ENUM(NSUInteger, FBDirectoryWatcherEvent) {
+  FBDirectoryWatcherEventAdded = 1, /** The file has been created, moved into the directory or has finished being written to. */
+  FBDirectoryWatcherEventRemoved = 2, /** The file has been removed or moved out of the directory. */
+};
+
+/**
+ The handler that is called for each observed change.
+ */
+typedef void (^FBDirectoryWatcherHandler)(NSString *path, FBDirectoryWatcherEvent event);
+
+/**
+ Observes the files that are directly within a set of directories.
+ The same file may be reported as added more than once, for example when it is written to again.
+ */
+@interface FBDirectoryWatcher : NSObject
+
+#pragma mark Initializers
+
+/**
+ Creates a Watcher for the provided directories.
+ Directories that do not exist when the Watcher is started are not observed.
+
+ @param directories the directories to observe.
+ @param backend the mechanism to use for observing the directories.
+ @param queue the queue to call the handler on.
+ @param handler the handler to call for each change.
+ @param error an error out for when the backend is not available on this host.
+ @return a new Directory Watcher, or nil if the backend is not available.
+ */
++ (nullable instancetype)watcherForDirectories:(NSArray<NSString *> *)directories backend:(FBDirectoryWatcherBackend)backend queue:(dispatch_queue_t)queue handler:(FBDirectoryWatcherHandler)handler error:(NSError **)error;
+
+/**
+ Creates a Watcher that lists the directories on an interval.
+
+ @param directories the directories to observe.
+ @param interval the interval between listings of the directories.
+ @param queue the queue to call the handler on.
+ @param handler the handler to call for each change.
+ @return a new Directory Watcher.
+ */
++ (instancetype)pollingWatcherForDirectories:(NSArray<NSString *> *)directories interval:(NSTimeInterval)interval queue:(dispatch_queue_t)queue handler:(FBDirectoryWatcherHandler)handler;
+
+#pragma mark Properties
+
+/**
+ The observed directories.
+ */
+@property (nonatomic, copy, readonly) NSArray<NSString *> *directories;
+
+/**
+ The mechanism used to observe the directories.
+ */
+@property (nonatomic, assign, readonly) FBDirectoryWatcherBackend backend;
+
+/**
+ YES if the Watcher has been started and not stopped.
+ */
+@property (nonatomic, assign, readonly) BOOL watching;
+
+#pragma mark Public Methods
+
+/**
+ Starts observing the directories. Calling this on a started Watcher has no effect.
+
+ @param onlyNew YES to only report changes from now, NO to first report the files that already exist as added.
+ @param error an error out for any error that occurs.
+ @return YES if successful, NO otherwise.
+ */
+- (BOOL)startWatching:(BOOL)onlyNew error:(NSError **)error;
+
+/**
+ Stops observing the directories. Changes that have not yet been delivered to the handler are dropped.
+ */
+- (void)stopWatching;
+
+@end
+
+NS_ASSUME_NONNULL_END
@@ -0,0 +1,474 @@
+/**
+ * Copyright (c) 2015-present, Facebook, Inc.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree. An additional grant
+ * of patent rights can be found in the PATENTS file in the same directory.
+ */
+
+#import "FBDirectoryWatcher.h"
+
+#include <errno.h>
+#include <limits.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#if defined(__apple_build_version__)
+#import <CoreServices/CoreServices.h>
+#endif
+
+#if defined(__linux__)
+#include <sys/inotify.h>
+#endif
+
+#import "FBCollectionInformation.h"
+#import "FBControlCoreError.h"
+
+static NSTimeInterval const FBDirectoryWatcherDefaultPollingInterval = 1;
+
+@interface FBDirectoryWatcher ()
+
+@property (nonatomic, strong, readonly) dispatch_queue_t queue;
+@property (nonatomic, copy, readonly) FBDirectoryWatcherHandler handler;
+@property (nonatomic, assign, readwrite) BOOL watching;
+
+- (BOOL)startBackendForDirectories:(NSArray<NSString *> *)directories onlyNew:(BOOL)onlyNew error:(NSError **)error;
+- (void)stopBackend;
+- (void)reportPath:(NSString *)path event:(FBDirectoryWatcherEvent)event;
+- (void)reportExistingFilesInDirectories:(NSArray<NSString *> *)directories;
+
+@end
+
+@interface FBDirectoryWatcher_Polling : FBDirectoryWatcher
+
+@property (nonatomic, assign, readonly) NSTimeInterval interval;
+@property (nonatomic, copy, readwrite) NSDictionary<NSString *, NSDictionary<NSURLResourceKey, id> *> *snapshot;
+@property (nonatomic, strong, nullable, readwrite) dispatch_source_t timer;
+
+@end
+
+#if defined(__apple_build_version__)
+@interface FBDirectoryWatcher_FSEvents : FBDirectoryWatcher
+
+@property (nonatomic, copy, readwrite) NSSet<NSString *> *realDirectories;
+@property (nonatomic, assign, readwrite) FSEventStreamRef eventStream;
+
+@end
+#endif
+
+#if defined(__linux__)
+@interface FBDirectoryWatcher_Inotify : FBDirectoryWatcher
+
+@property (nonatomic, copy, readwrite) NSDictionary<NSNumber *, NSString *> *watchDescriptors;
+@property (nonatomic, strong, nullable, readwrite) dispatch_source_t source;
+
+@end
+#endif
+
+@implementation FBDirectoryWatcher
+
+#pragma mark Initializers
+
++ (nullable instancetype)watcherForDirectories:(NSArray<NSString *> *)directories backend:(FBDirectoryWatcherBackend)backend queue:(dispatch_queue_t)queue handler:(FBDirectoryWatcherHandler)handler error:(NSError **)error
+{
+  if (backend == FBDirectoryWatcherBackendDefault) {
+#if defined(__apple_build_version__)
+    backend = FBDirectoryWatcherBackendFSEvents;
+#elif defined(__linux__)
+    backend = FBDirectoryWatcherBackendInotify;
+#else
+    backend = FBDirectoryWatcherBackendPolling;
+#endif
+  }
+  switch (backend) {
+#if defined(__apple_build_version__)
+    case FBDirectoryWatcherBackendFSEvents:
+      return [[FBDirectoryWatcher_FSEvents alloc] initWithDirectories:directories backend:backend queue:queue handler:handler];
+#endif
+#if defined(__linux__)
+    case FBDirectoryWatcherBackendInotify:
+      return [[FBDirectoryWatcher_Inotify alloc] initWithDirectories:directories backend:backend queue:queue handler:handler];
+#endif
+    case FBDirectoryWatcherBackendPolling:
+      return [self pollingWatcherForDirectories:directories interval:FBDirectoryWatcherDefaultPollingInterval queue:queue handler:handler];
+    default:
+      return [[FBControlCoreError
+        describeFormat:@"Directory Watcher backend %lu is not available on this host", (unsigned long) backend]
+        fail:error];
+  }
+}
+
++ (instancetype)pollingWatcherForDirectories:(NSArray<NSString *> *)directories interval:(NSTimeInterval)interval queue:(dispatch_queue_t)queue handler:(FBDirectoryWatcherHandler)handler
+{
+  return [[FBDirectoryWatcher_Polling alloc] initWithDirectories:directories interval:interval queue:queue handler:handler];
+}
+
+- (instancetype)initWithDirectories:(NSArray<NSString *> *)directories backend:(FBDirectoryWatcherBackend)backend queue:(dispatch_queue_t)queue handler:(FBDirectoryWatcherHandler)handler
+{
+  self = [super init];
+  if (!self) {
+    return nil;
+  }
+
+  _directories = [directories copy];
+  _backend = backend;
+  _queue = queue;
+  _handler = [handler copy];
+
+  return self;
+}
+
+#pragma mark Public Methods
+
+- (BOOL)startWatching:(BOOL)onlyNew error:(NSError **)error
+{
+  @synchronized (self) {
+    if (self.watching) {
+      return YES;
+    }
+    NSMutableArray<NSString *> *directories = [NSMutableArray array];
+    for (NSString *directory in self.directories) {
+      BOOL isDirectory = NO;
+      if ([NSFileManager.defaultManager fileExistsAtPath:directory isDirectory:&isDirectory] && isDirectory) {
+        [directories addObject:directory];
+      }
+    }
+    // The backend may report changes as soon as it has started.
+    self.watching = YES;
+    if (![self startBackendForDirectories:directories onlyNew:onlyNew error:error]) {
+      self.watching = NO;
+      return NO;
+    }
+    return YES;
+  }
+}
+
+- (void)stopWatching
+{
+  @synchronized (self) {
+    if (!self.watching) {
+      return;
+    }
+    self.watching = NO;
+    [self stopBackend];
+  }
+}
+
+#pragma mark NSObject
+
+- (NSString *)description
+{
+  return [NSString stringWithFormat:@"Directory Watcher %@ | Backend %lu | Watching %d", [FBCollectionInformation oneLineDescriptionFromArray:self.directories], (unsigned long) self.backend, self.watching];
+}
+
+#pragma mark Backends
+
+- (BOOL)startBackendForDirectories:(NSArray<NSString *> *)directories onlyNew:(BOOL)onlyNew error:(NSError **)error
+{
+  NSAssert(NO, @"-[%@ %@] is abstract and should be overridden", NSStringFromClass(self.class), NSStringFromSelector(_cmd));
+  return NO;
+}
+
+- (void)stopBackend
+{
+  NSAssert(NO, @"-[%@ %@] is abstract and should be overridden", NSStringFromClass(self.class), NSStringFromSelector(_cmd));
+}
+
+#pragma mark Private
+
+- (void)reportPath:(NSString *)path event:(FBDirectoryWatcherEvent)event
+{
+  // Changes that are delivered after the Watcher has been stopped are dropped.
+  if (!self.watching) {
+    return;
+  }
+  self.handler(path, event);
+}
+
+- (void)reportExistingFilesInDirectories:(NSArray<NSString *> *)directories
+{
+  // Called after the backend has started, so a file that is created in the meantime is reported at least once.
+  dispatch_async(self.queue, ^{
+    for (NSString *directory in directories) {
+      for (NSString *name in [NSFileManager.defaultManager contentsOfDirectoryAtPath:directory error:nil]) {
+        [self reportPath:[directory stringByAppendingPathComponent:name] event:FBDirectoryWatcherEventAdded];
+      }
+    }
+  });
+}
+
+@end
+
+@implementation FBDirectoryWatcher_Polling
+
+- (instancetype)initWithDirectories:(NSArray<NSString *> *)directories interval:(NSTimeInterval)interval queue:(dispatch_queue_t)queue handler:(FBDirectoryWatcherHandler)handler
+{
+  self = [super initWithDirectories:directories backend:FBDirectoryWatcherBackendPolling queue:queue handler:handler];
+  if (!self) {
+    return nil;
+  }
+
+  _interval = interval;
+  _snapshot = @{};
+
+  return self;
+}
+
+- (BOOL)startBackendForDirectories:(NSArray<NSString *> *)directories onlyNew:(BOOL)onlyNew error:(NSError **)error
+{
+  // All of the directories are listed on every poll, so that a directory created after starting is observed.
+  self.snapshot = onlyNew ? [self snapshotDirectories] : @{};
+
+  uint64_t interval = (uint64_t) (self.interval * NSEC_PER_SEC);
+  dispatch_source_t timer = dispatch_source_create(DISPATCH_SOURCE_TYPE_TIMER, 0, 0, self.queue);
+  dispatch_source_set_timer(timer, dispatch_time(DISPATCH_TIME_NOW, onlyNew ? (int64_t) interval : 0), interval, interval / 10);
+  __weak typeof(self) weakSelf = self;
+  dispatch_source_set_event_handler(timer, ^{
+    [weakSelf poll];
+  });
+  dispatch_resume(timer);
+  self.timer = timer;
+  return YES;
+}
+
+- (void)stopBackend
+{
+  dispatch_source_cancel(self.timer);
+  self.timer = nil;
+}
+
+- (void)dealloc
+{
+  if (_timer) {
+    dispatch_source_cancel(_timer);
+  }
+}
+
+- (void)poll
+{
+  NSDictionary<NSString *, NSDictionary<NSURLResourceKey, id> *> *previous = self.snapshot;
+  NSDictionary<NSString *, NSDictionary<NSURLResourceKey, id> *> *current = [self snapshotDirectories];
+  self.snapshot = current;
+
+  // A file that has changed size or modification date since the last poll is reported again.
+  for (NSString *path in current) {
+    if (![previous[path] isEqualToDictionary:current[path]]) {
+      [self reportPath:path event:FBDirectoryWatcherEventAdded];
+    }
+  }
+  for (NSString *path in previous) {
+    if (!current[path]) {
+      [self reportPath:path event:FBDirectoryWatcherEventRemoved];
+    }
+  }
+}
+
+- (NSDictionary<NSString *, NSDictionary<NSURLResourceKey, id> *> *)snapshotDirectories
+{
+  NSArray<NSURLResourceKey> *keys = @[NSURLContentModificationDateKey, NSURLFileSizeKey];
+  NSMutableDictionary<NSString *, NSDictionary<NSURLResourceKey, id> *> *snapshot = [NSMutableDictionary dictionary];
+  for (NSString *directory in self.directories) {
+    NSArray<NSURL *> *contents = [NSFileManager.defaultManager contentsOfDirectoryAtURL:[NSURL fileURLWithPath:directory] includingPropertiesForKeys:keys options:0 error:nil];
+    for (NSURL *url in contents) {
+      NSString *path = [directory stringByAppendingPathComponent:url.lastPathComponent];
+      snapshot[path] = [url resourceValuesForKeys:keys error:nil] ?: @{};
+    }
+  }
+  return snapshot;
+}
+
+@end
+
+#if defined(__apple_build_version__)
+
+static NSString *FBDirectoryWatcherRealPath(NSString *path)
+{
+  char buffer[PATH_MAX];
+  if (!realpath(path.fileSystemRepresentation, buffer)) {
+    return path;
+  }
+  return [NSString stringWithUTF8String:buffer] ?: path;
+}
+
+static void FBDirectoryWatcherEventStreamCallback(
+  ConstFSEventStreamRef streamRef,
+  FBDirectoryWatcher_FSEvents *watcher,
+  size_t numEvents,
+  NSArray<NSString *> *eventPaths,
+  const FSEventStreamEventFlags *eventFlags,
+  const FSEventStreamEventId *eventIds
+){
+  for (size_t index = 0; index < numEvents; index++) {
+    NSString *path = eventPaths[index];
+    FSEventStreamEventFlags flag = eventFlags[index];
+    // FSEvents observes recursively, only the files directly within the directories are reported.
+    if (flag & kFSEventStreamEventFlagItemIsDir || ![watcher.realDirectories containsObject:path.stringByDeletingLastPathComponent]) {
+      continue;
+    }
+    if (flag & kFSEventStreamEventFlagItemRemoved) {
+      [watcher reportPath:path event:FBDirectoryWatcherEventRemoved];
+    } else if (flag & (kFSEventStreamEventFlagItemCreated | kFSEventStreamEventFlagItemModified | kFSEventStreamEventFlagItemRenamed)) {
+      // A rename is reported for both the source and the destination, so the file is checked for.
+      struct stat buffer;
+      BOOL exists = stat(path.fileSystemRepresentation, &buffer) == 0;
+      [watcher reportPath:path event:exists ? FBDirectoryWatcherEventAdded : FBDirectoryWatcherEventRemoved];
+    }
+  }
+}
+
+@implementation FBDirectoryWatcher_FSEvents
+
+- (BOOL)startBackendForDirectories:(NSArray<NSString *> *)directories onlyNew:(BOOL)onlyNew error:(NSError **)error
+{
+  // Events are reported with the real path of the file, which may differ from the path of the directory.
+  NSMutableSet<NSString *> *realDirectories = [NSMutableSet set];
+  for (NSString *directory in directories) {
+    [realDirectories addObject:directory];
+    [realDirectories addObject:FBDirectoryWatcherRealPath(directory)];
+  }
+  self.realDirectories = realDirectories;
+
+  FSEventStreamContext context = {
+    .version = 0,
+    .info = (__bridge void *) self,
+    .retain = CFRetain,
+    .release = CFRelease,
+    .copyDescription = NULL,
+  };
+  FSEventStreamRef eventStream = FSEventStreamCreate(
+    NULL, // Allocator
+    (FSEventStreamCallback) FBDirectoryWatcherEventStreamCallback, // Callback
+    &context,  // Context
+    (__bridge CFArrayRef) directories, // Paths to watch
+    kFSEventStreamEventIdSinceNow,  // Since When
+    0,  // Latency
+    kFSEventStreamCreateFlagUseCFTypes | kFSEventStreamCreateFlagFileEvents | kFSEventStreamCreateFlagNoDefer
+  );
+  if (!eventStream) {
+    return [[FBControlCoreError
+      describeFormat:@"Could not create an Event Stream for %@", directories]
+      failBool:error];
+  }
+  FSEventStreamSetDispatchQueue(eventStream, self.queue);
+  if (!FSEventStreamStart(eventStream)) {
+    FSEventStreamInvalidate(eventStream);
+    FSEventStreamRelease(eventStream);
+    return [[FBControlCoreError
+      describeFormat:@"Could not start the Event Stream for %@", directories]
+      failBool:error];
+  }
+  self.eventStream = eventStream;
+  if (!onlyNew) {
+    [self reportExistingFilesInDirectories:directories];
+  }
+  return YES;
+}
+
+- (void)stopBackend
+{
+  // The stream retains the Watcher, so it is released here rather than in -dealloc.
+  FSEventStreamStop(self.eventStream);
+  FSEventStreamInvalidate(self.eventStream);
+  FSEventStreamRelease(self.eventStream);
+  self.eventStream = NULL;
+}
+
+@end
+
+#endif
+
+#if defined(__linux__)
+
+@implementation FBDirectoryWatcher_Inotify
+
+- (BOOL)startBackendForDirectories:(NSArray<NSString *> *)directories onlyNew:(BOOL)onlyNew error:(NSError **)error
+{
+  int fileDescriptor = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+  if (fileDescriptor < 0) {
+    return [[FBControlCoreError
+      describeFormat:@"Could not create an inotify instance: %s", strerror(errno)]
+      failBool:error];
+  }
+  // Files are reported when they are closed after writing, rather than created, so that they are complete.
+  NSMutableDictionary<NSNumber *, NSString *> *watchDescriptors = [NSMutableDictionary dictionary];
+  for (NSString *directory in directories) {
+    int watchDescriptor = inotify_add_watch(fileDescriptor, directory.fileSystemRepresentation, IN_CLOSE_WRITE | IN_MOVED_TO | IN_DELETE | IN_MOVED_FROM | IN_ONLYDIR);
+    if (watchDescriptor < 0) {
+      int code = errno;
+      close(fileDescriptor);
+      return [[FBControlCoreError
+        describeFormat:@"Could not watch %@ with inotify: %s", directory, strerror(code)]
+        failBool:error];
+    }
+    watchDescriptors[@(watchDescriptor)] = directory;
+  }
+  self.watchDescriptors = watchDescriptors;
+
+  dispatch_source_t source = dispatch_source_create(DISPATCH_SOURCE_TYPE_READ, (uintptr_t) fileDescriptor, 0, self.queue);
+  __weak typeof(self) weakSelf = self;
+  dispatch_source_set_event_handler(source, ^{
+    [weakSelf readEventsFromFileDescriptor:fileDescriptor];
+  });
+  dispatch_source_set_cancel_handler(source, ^{
+    close(fileDescriptor);
+  });
+  dispatch_resume(source);
+  self.source = source;
+  if (!onlyNew) {
+    [self reportExistingFilesInDirectories:directories];
+  }
+  return YES;
+}
+
+- (void)stopBackend
+{
+  dispatch_source_cancel(self.source);
+  self.source = nil;
+}
+
+- (void)dealloc
+{
+  if (_source) {
+    dispatch_source_cancel(_source);
+  }
+}
+
+- (void)readEventsFromFileDescriptor:(int)fileDescriptor
+{
+  char buffer[sizeof(struct inotify_event) + NAME_MAX + 1];
+  ssize_t length = 0;
+  while ((length = read(fileDescriptor, buffer, sizeof(buffer))) > 0) {
+    const char *position = buffer;
+    const char *end = buffer + length;
+    while (position + sizeof(struct inotify_event) <= end) {
+      // The buffer is not aligned for the event, so the fixed size header is copied out of it.
+      struct inotify_event event;
+      memcpy(&event, position, sizeof(struct inotify_event));
+      const char *name = position + sizeof(struct inotify_event);
+      position = name + event.len;
+      if (event.mask & IN_Q_OVERFLOW) {
+        // Events have been dropped, so every file is reported again.
+        [self reportExistingFilesInDirectories:self.watchDescriptors.allValues];
+        continue;
+      }
+      NSString *directory = self.watchDescriptors[@(event.wd)];
+      if (!directory || event.len == 0 || position > end || (event.mask & IN_ISDIR)) {
+        continue;
+      }
+      NSString *fileName = [NSString stringWithUTF8String:name];
+      if (!fileName) {
+        continue;
+      }
+      NSString *path = [directory stringByAppendingPathComponent:fileName];
+      FBDirectoryWatcherEvent kind = (event.mask & (IN_DELETE | IN_MOVED_FROM)) ? FBDirectoryWatcherEventRemoved : FBDirectoryWatcherEventAdded;
+      [self reportPath:path event:kind];
+    }
+  }
+}
+
+@end
+
+#endif
@@ -20,6 +20,7 @@ typedef NS_ENUM(NSUInteger, FBFileReaderState) {
 
 /**
  Reads a file in the background, forwarding to a consumer.
+ If the consumer conforms to FBDataConsumerBackpressure, reading is paused whilst the consumer is saturated.
  */
 @interface FBFileReader : NSObject
 
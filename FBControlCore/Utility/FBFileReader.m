@@ -27,6 +27,7 @@ static NSString *StateStringFromState(FBFileReaderState state)
 
 @property (nonatomic, copy, readonly) NSString *targeting;
 @property (nonatomic, strong, readonly) id<FBDispatchDataConsumer> consumer;
+@property (nonatomic, strong, nullable, readonly) id<FBDataConsumerBackpressure> backpressure;
 @property (nonatomic, strong, readonly) dispatch_queue_t readQueue;
 @property (nonatomic, strong, readonly) FBMutableFuture<NSNumber *> *ioChannelFinishedReadOperation;
 @property (nonatomic, strong, readonly) NSFileHandle *fileHandle;
@@ -34,9 +35,20 @@ static NSString *StateStringFromState(FBFileReaderState state)
 
 @property (atomic, assign, readwrite) FBFileReaderState state;
 @property (nonatomic, strong, nullable, readwrite) dispatch_io_t io;
+@property (nonatomic, assign, readwrite) BOOL readOperationInFlight;
+@property (nonatomic, assign, readwrite) int readErrorCode;
 
 @end
 
+// When the consumer applies backpressure, the file is read in chunks of this size.
+// The next chunk is only read when the consumer has capacity, so at most this many bytes are read beyond the high water mark.
+static size_t const FBFileReaderBoundedChunkSize = 64 * 1024;
+
+static id<FBDataConsumerBackpressure> BackpressureForConsumer(id consumer)
+{
+  return [consumer conformsToProtocol:@protocol(FBDataConsumerBackpressure)] ? consumer : nil;
+}
+
 @implementation FBFileReader
 
 #pragma mark Initializers
@@ -48,13 +60,14 @@ static NSString *StateStringFromState(FBFileReaderState state)
 
 + (instancetype)readerWithFileHandle:(NSFileHandle *)fileHandle consumer:(id<FBDataConsumer>)consumer logger:(nullable id<FBControlCoreLogger>)logger
 {
-  return [self dispatchDataReaderWithFileHandle:fileHandle consumer:[FBDataConsumerAdaptor dispatchDataConsumerForDataConsumer:consumer] logger:logger];
+  NSString *targeting = [NSString stringWithFormat:@"fd %d", fileHandle.fileDescriptor];
+  return [[self alloc] initWithFileHandle:fileHandle consumer:[FBDataConsumerAdaptor dispatchDataConsumerForDataConsumer:consumer] backpressure:BackpressureForConsumer(consumer) targeting:targeting queue:self.createQueue logger:logger];
 }
 
 + (instancetype)dispatchDataReaderWithFileHandle:(NSFileHandle *)fileHandle consumer:(id<FBDispatchDataConsumer>)consumer logger:(nullable id<FBControlCoreLogger>)logger
 {
   NSString *targeting = [NSString stringWithFormat:@"fd %d", fileHandle.fileDescriptor];
-  return [[self alloc] initWithFileHandle:fileHandle consumer:consumer targeting:targeting queue:self.createQueue logger:logger];
+  return [[self alloc] initWithFileHandle:fileHandle consumer:consumer backpressure:BackpressureForConsumer(consumer) targeting:targeting queue:self.createQueue logger:logger];
 }
 
 + (FBFuture<FBFileReader *> *)readerWithFilePath:(NSString *)filePath consumer:(id<FBDataConsumer>)consumer logger:(nullable id<FBControlCoreLogger>)logger
@@ -68,11 +81,11 @@ static NSString *StateStringFromState(FBFileReaderState state)
         fail:error];
     }
     NSFileHandle *fileHandle = [[NSFileHandle alloc] initWithFileDescriptor:fileDescriptor closeOnDealloc:YES];
-    return [[self alloc] initWithFileHandle:fileHandle consumer:[FBDataConsumerAdaptor dispatchDataConsumerForDataConsumer:consumer] targeting:filePath queue:queue logger:logger];
+    return [[self alloc] initWithFileHandle:fileHandle consumer:[FBDataConsumerAdaptor dispatchDataConsumerForDataConsumer:consumer] backpressure:BackpressureForConsumer(consumer) targeting:filePath queue:queue logger:logger];
   }];
 }
 
-- (instancetype)initWithFileHandle:(NSFileHandle *)fileHandle consumer:(id<FBDispatchDataConsumer>)consumer targeting:(NSString *)targeting queue:(dispatch_queue_t)queue logger:(nullable id<FBControlCoreLogger>)logger
+- (instancetype)initWithFileHandle:(NSFileHandle *)fileHandle consumer:(id<FBDispatchDataConsumer>)consumer backpressure:(nullable id<FBDataConsumerBackpressure>)backpressure targeting:(NSString *)targeting queue:(dispatch_queue_t)queue logger:(nullable id<FBControlCoreLogger>)logger
 {
   self = [super init];
   if (!self) {
@@ -81,6 +94,7 @@ static NSString *StateStringFromState(FBFileReaderState state)
 
   _fileHandle = fileHandle;
   _consumer = consumer;
+  _backpressure = backpressure;
   _targeting = targeting;
   _readQueue = queue;
   _ioChannelFinishedReadOperation = [FBMutableFuture futureWithNameFormat:@"IO Channel Read of %@", targeting];
@@ -138,14 +152,13 @@ static NSString *StateStringFromState(FBFileReaderState state)
   // Get locals to be captured by the read, rather than self.
   NSFileHandle *fileHandle = self.fileHandle;
   id<FBDispatchDataConsumer> consumer = self.consumer;
-  __block int readErrorCode = 0;
 
   // If there is an error creating the IO Object, the errorCode will be delivered asynchronously.
-  // This does not include any error during the read, which instead comes from the dispatch_io_read callback.
+  // This does not include any error during the read, which instead comes from the dispatch_io_read callback and is recorded when the read finishes.
   // The self-capture is intentional, if the creator of an FBFileReader no longer strongly references self, we still need to keep it alive.
   // The self-capture is then removed in the below callback, which means the FBFileReader can then be deallocated.
   self.io = dispatch_io_create(DISPATCH_IO_STREAM, fileHandle.fileDescriptor, self.readQueue, ^(int createErrorCode) {
-    [self ioChannelControlHasRelinquished:fileHandle withErrorCode:(createErrorCode ?: readErrorCode)];
+    [self ioChannelControlHasRelinquished:fileHandle withErrorCode:(createErrorCode ?: self.readErrorCode)];
   });
   if (!self.io) {
     return [[FBControlCoreError
@@ -155,19 +168,56 @@ static NSString *StateStringFromState(FBFileReaderState state)
 
   // Report partial results with as little as 1 byte read.
   dispatch_io_set_low_water(self.io, 1);
+  self.state = FBFileReaderStateReading;
+
+  // A consumer that applies backpressure is read from in chunks, otherwise the whole file is read in one operation.
+  if (self.backpressure) {
+    [self readNextChunk];
+    return [FBFuture futureWithResult:NSNull.null];
+  }
+  self.readOperationInFlight = YES;
   dispatch_io_read(self.io, 0, SIZE_MAX, self.readQueue, ^(bool done, dispatch_data_t dispatchData, int errorCode) {
     if (dispatchData != NULL) {
       [consumer consumeData:dispatchData];
     }
     if (done) {
-      readErrorCode = errorCode;
+      self.readOperationInFlight = NO;
       [self ioChannelHasFinishedReadOperation:fileHandle withErrorCode:errorCode];
     }
   });
-  self.state = FBFileReaderStateReading;
   return [FBFuture futureWithResult:NSNull.null];
 }
 
+- (void)readNextChunk
+{
+  if (self.state != FBFileReaderStateReading) {
+    return;
+  }
+  NSFileHandle *fileHandle = self.fileHandle;
+  id<FBDispatchDataConsumer> consumer = self.consumer;
+  __block size_t remaining = FBFileReaderBoundedChunkSize;
+  self.readOperationInFlight = YES;
+  dispatch_io_read(self.io, 0, FBFileReaderBoundedChunkSize, self.readQueue, ^(bool done, dispatch_data_t dispatchData, int errorCode) {
+    if (dispatchData != NULL) {
+      size_t size = dispatch_data_get_size(dispatchData);
+      remaining -= MIN(size, remaining);
+      [consumer consumeData:dispatchData];
+    }
+    if (!done) {
+      return;
+    }
+    self.readOperationInFlight = NO;
+    // A stream read operation that is done before the requested length has been read has reached the end-of-file.
+    if (errorCode != 0 || remaining > 0) {
+      [self ioChannelHasFinishedReadOperation:fileHandle withErrorCode:errorCode];
+      return;
+    }
+    [self.backpressure.hasCapacity onQueue:self.readQueue notifyOfCompletion:^(FBFuture *_) {
+      [self readNextChunk];
+    }];
+  });
+}
+
 - (FBFuture<NSNumber *> *)stopReadingNow
 {
   // The only error condition is that we haven't yet started reading
@@ -187,6 +237,10 @@ static NSString *StateStringFromState(FBFileReaderState state)
   // Therefore, closing the channel will have the effect that dispatch_io_read will become 'done' in the near future.
   // The ioChannelFinishedReadOperation future will then be resolved, so we can return that future from here.
   dispatch_io_close(self.io, DISPATCH_IO_STOP);
+  // If reading is paused for backpressure there is no read operation to become 'done', so the read is finished here.
+  if (!self.readOperationInFlight) {
+    return [self ioChannelHasFinishedReadOperation:self.fileHandle withErrorCode:ECANCELED];
+  }
   return self.ioChannelFinishedReadOperation;
 }
 
@@ -201,6 +255,8 @@ static NSString *StateStringFromState(FBFileReaderState state)
   if (self.state != FBFileReaderStateReading) {
     return self.ioChannelFinishedReadOperation;
   }
+  // Recorded for both the whole-file and chunked reads, so that the error is available when the channel is relinquished.
+  self.readErrorCode = errorCode;
   switch (errorCode) {
     case 0:
       self.state = FBFileReaderStateFinishedReadingNormally;
@@ -32,6 +32,7 @@ NS_ASSUME_NONNULL_BEGIN
 /**
  Creates a blocking data consumer from a file handle.
  The file handle will be closed when and end-of-file is sent.
+ If a write fails, the file handle is closed, subsequent data is discarded and eofHasBeenReceived fails with the error.
 
  @param fileHandle the file handle to write to.
  @return a data consumer.
@@ -41,6 +42,7 @@ NS_ASSUME_NONNULL_BEGIN
 /**
  Creates a non-blocking Data Consumer from a file handle.
  The file handle will be closed when and end-of-file is sent.
+ If a write fails, eofHasBeenReceived fails with the error.
 
  @param fileHandle the file handle to write to.
  @return a data consumer.
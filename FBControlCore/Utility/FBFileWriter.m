@@ -17,6 +17,7 @@
 @property (nonatomic, strong, readwrite) FBMutableFuture<NSNull *> *eofHasBeenReceivedMutable;
 
 - (instancetype)initWithFileHandle:(NSFileHandle *)fileHandle;
+- (void)failWithErrorCode:(int)errorCode fileDescriptor:(int)fileDescriptor;
 
 @end
 
@@ -136,6 +137,17 @@
   return self;
 }
 
+#pragma mark Private
+
+- (void)failWithErrorCode:(int)errorCode fileDescriptor:(int)fileDescriptor
+{
+  // A failed write is surfaced through the end-of-file, as the data that follows it will not be written.
+  NSError *error = [[FBControlCoreError
+    describeFormat:@"Failed to write to fd %d: %s", fileDescriptor, strerror(errorCode)]
+    build];
+  [self.eofHasBeenReceivedMutable resolveWithError:error];
+}
+
 @end
 
 @implementation FBFileWriter_Null
@@ -165,7 +177,36 @@
 
 - (void)consumeData:(dispatch_data_t)data
 {
-  [self.fileHandle writeData:[FBDataConsumerAdaptor adaptDispatchData:data]];
+  NSFileHandle *fileHandle = self.fileHandle;
+  if (!fileHandle) {
+    return;
+  }
+  // Each contiguous region is written in turn, so non-contiguous data does not need to be flattened first.
+  int fileDescriptor = fileHandle.fileDescriptor;
+  __block int writeError = 0;
+  dispatch_data_apply(data, ^ bool (dispatch_data_t region, size_t offset, const void *buffer, size_t size) {
+    const char *bytes = buffer;
+    while (size > 0) {
+      ssize_t written = write(fileDescriptor, bytes, size);
+      if (written < 0 && errno == EINTR) {
+        continue;
+      }
+      if (written < 0) {
+        writeError = errno;
+        return false;
+      }
+      bytes += written;
+      size -= (size_t) written;
+    }
+    return true;
+  });
+  if (writeError == 0) {
+    return;
+  }
+  // As with the async writer, once a write fails the file handle is closed and subsequent data is discarded.
+  [fileHandle closeFile];
+  self.fileHandle = nil;
+  [self failWithErrorCode:writeError fileDescriptor:fileDescriptor];
 }
 
 - (void)consumeEndOfFile
@@ -204,7 +245,12 @@
 {
   NSParameterAssert(self.io);
 
-  dispatch_io_write(self.io, 0, data, self.writeQueue, ^(bool done, dispatch_data_t remainder, int error) {});
+  int fileDescriptor = self.fileHandle.fileDescriptor;
+  dispatch_io_write(self.io, 0, data, self.writeQueue, ^(bool done, dispatch_data_t remainder, int errorCode) {
+    if (errorCode != 0) {
+      [self failWithErrorCode:errorCode fileDescriptor:fileDescriptor];
+    }
+  });
 }
 
 - (void)consumeEndOfFile
@@ -110,6 +110,16 @@ extern FBiOSTargetFutureType const FBiOSTargetFutureTypeProcessOutput;
  */
 + (FBProcessOutput<id<FBDataConsumer>> *)outputForDataConsumer:(id<FBDataConsumer>)dataConsumer;
 
+/**
+ An Output Container that passes to a dispatch_data Consumer.
+ The dispatch_data read from the process is passed to the consumer without being flattened.
+
+ @param dataConsumer the dispatch_data consumer to write to.
+ @param logger the logger to log to.
+ @return a Process Output instance.
+ */
++ (FBProcessOutput<id<FBDataConsumer>> *)outputForDispatchDataConsumer:(id<FBDispatchDataConsumer, FBDataConsumerLifecycle>)dataConsumer logger:(nullable id<FBControlCoreLogger>)logger;
+
 /**
  An Output Container that writes to a logger
 
@@ -330,6 +330,13 @@ FBiOSTargetFutureType const FBiOSTargetFutureTypeProcessOutput = @"process_outpu
   return [[FBProcessOutput_Consumer alloc] initWithConsumer:dataConsumer logger:nil];
 }
 
++ (FBProcessOutput<id<FBDataConsumer>> *)outputForDispatchDataConsumer:(id<FBDispatchDataConsumer, FBDataConsumerLifecycle>)dataConsumer logger:(nullable id<FBControlCoreLogger>)logger
+{
+  // The FBFileReader will unwrap the adapted consumer, so that the dispatch_data is passed through.
+  id<FBDataConsumer> consumer = [FBDataConsumerAdaptor dataConsumerForDispatchDataConsumer:dataConsumer];
+  return [[FBProcessOutput_Consumer alloc] initWithConsumer:consumer logger:logger];
+}
+
 + (FBProcessOutput<id<FBControlCoreLogger>> *)outputForLogger:(id<FBControlCoreLogger>)logger
 {
   return [[FBProcessOutput_Logger alloc] initWithLogger:logger];
@@ -14,6 +14,7 @@
 NS_ASSUME_NONNULL_BEGIN
 
 @class FBUploadBuffer;
+@protocol FBDataConsumer;
 
 /**
  The Action Types for a Binary Transfer.
@@ -92,6 +93,16 @@ extern FBiOSTargetFutureType const FBiOSTargetFutureTypeUploadedBinary;
  */
 + (nullable)bufferWithHeader:(FBUploadHeader *)header workingDirectory:(NSString *)workingDirectory;
 
+/**
+ Creates a consumer that extracts an upload whilst it is being received, for uploads of Applications.
+ The extraction is shared through the Archive Extraction Cache, so that installing the uploaded path does not wait on extracting it afterwards.
+
+ @param header the header of the upload.
+ @param filePath the path that the upload is written to.
+ @return a consumer of the uploaded bytes, or nil if the upload is not extracted.
+ */
++ (nullable id<FBDataConsumer>)extractionConsumerForHeader:(FBUploadHeader *)header filePath:(NSString *)filePath;
+
 /**
  Write the data to the buffer.
 
@@ -9,6 +9,7 @@
 
 #import "FBUploadBuffer.h"
 
+#import "FBArchiveExtractionCache.h"
 #import "FBCollectionInformation.h"
 #import "FBControlCoreError.h"
 #import "FBFileWriter.h"
@@ -237,6 +238,7 @@ static NSString *const KeyPath = @"path";
 @property (nonatomic, copy, readonly) NSString *filePath;
 
 @property (nonatomic, strong, readwrite, nullable) FBUploadedDestination *binary;
+@property (nonatomic, strong, readwrite, nullable) id<FBDataConsumer> extraction;
 @property (nonatomic, assign, readwrite) size_t position;
 
 @end
@@ -270,13 +272,25 @@ static size_t ToFileThreshold = 2 * 1024 * 1024;
 {
   NSString *filePath = [self outputFilePathWithWorkingDirectory:workingDirectory pathExtension:header.extension];
 
+  FBUploadBuffer *buffer = nil;
   if (header.size > ToFileThreshold) {
     NSError *error = nil;
     id<FBDataConsumer> writer = [FBFileWriter syncWriterForFilePath:filePath error:&error];
     NSAssert(writer, @"Could not create writer %@", error);
-    return [[FBUploadBuffer_ToFile alloc] initWithHeader:header filePath:filePath writer:writer];
+    buffer = [[FBUploadBuffer_ToFile alloc] initWithHeader:header filePath:filePath writer:writer];
+  } else {
+    buffer = [[FBUploadBuffer_InMemory alloc] initWithHeader:header filePath:filePath];
+  }
+  buffer.extraction = [self extractionConsumerForHeader:header filePath:filePath];
+  return buffer;
+}
+
++ (nullable id<FBDataConsumer>)extractionConsumerForHeader:(FBUploadHeader *)header filePath:(NSString *)filePath
+{
+  if (![header.extension.lowercaseString isEqualToString:@"ipa"]) {
+    return nil;
   }
-  return [[FBUploadBuffer_InMemory alloc] initWithHeader:header filePath:filePath];
+  return [FBArchiveExtractionCache.sharedCache extractionConsumerForArchiveAtPath:filePath length:header.size];
 }
 
 - (instancetype)initWithHeader:(FBUploadHeader *)header filePath:(NSString *)filePath
@@ -322,15 +336,19 @@ static size_t ToFileThreshold = 2 * 1024 * 1024;
   }
   // Append the data, return the remainder.
   [self writeData:toWrite];
+  [self.extraction consumeData:toWrite];
   self.position = self.position + dataToConsume;
   if (remainderOut) {
     *remainderOut = remainder;
   }
 
   // We're at the end, so return the uploaded binary.
+  // The extraction is only finished once the file is complete, as it verifies against the file.
   if (self.position == self.header.size) {
     FBUploadedDestination *binary = [self constructUploadedBinary];
     self.binary = binary;
+    [self.extraction consumeEndOfFile];
+    self.extraction = nil;
     return binary;
   }
   return nil;
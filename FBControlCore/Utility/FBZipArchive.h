@@ -0,0 +1,118 @@
+/**
+ * Copyright (c) 2015-present, Facebook, Inc.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree. An additional grant
+ * of patent rights can be found in the PATENTS file in the same directory.
+ */
+
+#import <Foundation/Foundation.h>
+
+#import <FBControlCore/FBDataConsumer.h>
+#import <FBControlCore/FBFuture.h>
+
+NS_ASSUME_NONNULL_BEGIN
+
+/**
+ An Entry in the Central Directory of a Zip Archive.
+ */
+@interface FBZipArchiveEntry : NSObject
+
+/**
+ The path of the entry, relative to the root of the archive.
+ */
+@property (nonatomic, copy, readonly) NSString *path;
+
+/**
+ The size of the entry once it has been extracted.
+ */
+@property (nonatomic, assign, readonly) unsigned long long uncompressedSize;
+
+/**
+ YES if the entry is a directory.
+ */
+@property (nonatomic, assign, readonly) BOOL isDirectory;
+
+/**
+ YES if the entry is a symbolic link, in which case the contents of the entry are the destination of the link.
+ */
+@property (nonatomic, assign, readonly) BOOL isSymbolicLink;
+
+@end
+
+/**
+ Reads Zip Archives in-process, without spawning unzip(1).
+ The archive is mapped rather than read, entries are inflated through a fixed size buffer, so memory use is bounded regardless of the size of the archive.
+ Stored and Deflated entries are supported, as well as the Zip64 extensions for archives larger than 4GB.
+ */
+@interface FBZipArchive : NSObject
+
+#pragma mark Initializers
+
+/**
+ Opens the Zip Archive at the provided path, reading the Central Directory.
+
+ @param path the path of the archive.
+ @param error an error out for any error that occurs.
+ @return a Zip Archive if successful, nil otherwise.
+ */
++ (nullable instancetype)archiveAtPath:(NSString *)path error:(NSError **)error;
+
+#pragma mark Properties
+
+/**
+ The path of the archive.
+ */
+@property (nonatomic, copy, readonly) NSString *path;
+
+/**
+ The entries in the archive, in the order of the Central Directory.
+ */
+@property (nonatomic, copy, readonly) NSArray<FBZipArchiveEntry *> *entries;
+
+#pragma mark Public Methods
+
+/**
+ Extracts all of the entries into a directory, which is created if it does not exist.
+ Files are inflated concurrently. Entries with paths that would escape the directory are rejected before anything is written.
+
+ @param directory the directory to extract into.
+ @param error an error out for any error that occurs.
+ @return YES if successful, NO otherwise.
+ */
+- (BOOL)extractToDirectory:(NSString *)directory error:(NSError **)error;
+
+@end
+
+/**
+ Extracts a Zip Archive from its bytes as they arrive, rather than once the whole archive is available.
+ Entries are decoded from their local headers in the order that they appear and are written on a private serial queue, so extraction overlaps with the transfer of the archive.
+ The Central Directory is at the end of the archive, so the permissions and symbolic links of entries are applied, and the entries are verified against it, once an end-of-file is received.
+ Entries that are stored with a trailing data descriptor cannot be delimited from a stream, such archives fail to extract and should be extracted from the file instead.
+ */
+@interface FBZipStreamExtractor : NSObject <FBDataConsumer>
+
+#pragma mark Initializers
+
+/**
+ Creates a Stream Extractor.
+ The consumed bytes must also be written to the archive path, which must be complete before an end-of-file is consumed, as the Central Directory is read from it.
+
+ @param archivePath the path that the archive is being written to.
+ @param directory the directory to extract into, which is removed if extraction fails.
+ @param maximumExtractedSize the number of bytes that may be extracted in total, beyond which extraction fails.
+ @return a new Stream Extractor.
+ */
++ (instancetype)extractorForArchiveAtPath:(NSString *)archivePath toDirectory:(NSString *)directory maximumExtractedSize:(unsigned long long)maximumExtractedSize;
+
+#pragma mark Properties
+
+/**
+ A Future that resolves with the extraction directory when the extraction has completed and been verified.
+ */
+@property (nonatomic, strong, readonly) FBFuture<NSString *> *completed;
+
+@end
+
+NS_ASSUME_NONNULL_END
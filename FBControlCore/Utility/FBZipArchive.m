@@ -0,0 +1,1040 @@
+/**
+ * Copyright (c) 2015-present, Facebook, Inc.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree. An additional grant
+ * of patent rights can be found in the PATENTS file in the same directory.
+ */
+
+#import "FBZipArchive.h"
+
+#include <errno.h>
+#include <fcntl.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <zlib.h>
+
+#import "FBCollectionInformation.h"
+#import "FBConcurrentCollectionOperations.h"
+#import "FBControlCoreError.h"
+#import "FBFuture.h"
+
+static uint32_t const FBZipLocalFileHeaderSignature = 0x04034b50;
+static uint32_t const FBZipCentralDirectorySignature = 0x02014b50;
+static uint32_t const FBZipEndOfCentralDirectorySignature = 0x06054b50;
+static uint32_t const FBZip64EndOfCentralDirectorySignature = 0x06064b50;
+static uint32_t const FBZip64EndOfCentralDirectoryLocatorSignature = 0x07064b50;
+static uint32_t const FBZipDataDescriptorSignature = 0x08074b50;
+
+static size_t const FBZipLocalFileHeaderLength = 30;
+static size_t const FBZipCentralDirectoryHeaderLength = 46;
+static size_t const FBZipEndOfCentralDirectoryLength = 22;
+static size_t const FBZip64EndOfCentralDirectoryLength = 56;
+static size_t const FBZip64EndOfCentralDirectoryLocatorLength = 20;
+static size_t const FBZipMaximumCommentLength = 0xffff;
+
+static uint16_t const FBZipMethodStored = 0;
+static uint16_t const FBZipMethodDeflated = 8;
+static uint16_t const FBZipFlagEncrypted = 1 << 0;
+static uint16_t const FBZipFlagDataDescriptor = 1 << 3;
+static uint16_t const FBZipCreatorUnix = 3;
+static uint16_t const FBZip64ExtraFieldIdentifier = 0x0001;
+
+static size_t const FBZipExtractionBufferSize = 256 * 1024;
+
+static uint16_t FBZipRead16(const uint8_t *bytes)
+{
+  return (uint16_t) (bytes[0] | (bytes[1] << 8));
+}
+
+static uint32_t FBZipRead32(const uint8_t *bytes)
+{
+  return (uint32_t) bytes[0] | ((uint32_t) bytes[1] << 8) | ((uint32_t) bytes[2] << 16) | ((uint32_t) bytes[3] << 24);
+}
+
+static uint64_t FBZipRead64(const uint8_t *bytes)
+{
+  return (uint64_t) FBZipRead32(bytes) | ((uint64_t) FBZipRead32(bytes + 4) << 32);
+}
+
+@interface FBZipArchiveEntry ()
+
+@property (nonatomic, assign, readonly) uint16_t method;
+@property (nonatomic, assign, readonly) uint32_t crc;
+@property (nonatomic, assign, readonly) unsigned long long compressedSize;
+@property (nonatomic, assign, readonly) unsigned long long localHeaderOffset;
+@property (nonatomic, assign, readonly) mode_t permissions;
+
+@end
+
+@implementation FBZipArchiveEntry
+
+- (instancetype)initWithPath:(NSString *)path method:(uint16_t)method crc:(uint32_t)crc compressedSize:(unsigned long long)compressedSize uncompressedSize:(unsigned long long)uncompressedSize localHeaderOffset:(unsigned long long)localHeaderOffset isDirectory:(BOOL)isDirectory isSymbolicLink:(BOOL)isSymbolicLink permissions:(mode_t)permissions
+{
+  self = [super init];
+  if (!self) {
+    return nil;
+  }
+
+  _path = path;
+  _method = method;
+  _crc = crc;
+  _compressedSize = compressedSize;
+  _uncompressedSize = uncompressedSize;
+  _localHeaderOffset = localHeaderOffset;
+  _isDirectory = isDirectory;
+  _isSymbolicLink = isSymbolicLink;
+  _permissions = permissions;
+
+  return self;
+}
+
+- (NSString *)description
+{
+  return [NSString stringWithFormat:@"Zip Entry %@ | Size %llu | Method %u", self.path, self.uncompressedSize, self.method];
+}
+
+@end
+
+@interface FBZipArchive ()
+
+@property (nonatomic, strong, readonly) NSData *data;
+
++ (BOOL)isSafeEntryPath:(NSString *)path;
+
+@end
+
+@implementation FBZipArchive
+
+#pragma mark Initializers
+
++ (nullable instancetype)archiveAtPath:(NSString *)path error:(NSError **)error
+{
+  // The archive is mapped, so only the pages of the entries being extracted are resident.
+  NSError *innerError = nil;
+  NSData *data = [NSData dataWithContentsOfFile:path options:NSDataReadingMappedIfSafe error:&innerError];
+  if (!data) {
+    return [[[FBControlCoreError
+      describeFormat:@"Could not read zip archive at %@", path]
+      causedBy:innerError]
+      fail:error];
+  }
+  NSArray<FBZipArchiveEntry *> *entries = [self entriesFromData:data path:path error:error];
+  if (!entries) {
+    return nil;
+  }
+  return [[self alloc] initWithPath:path data:data entries:entries];
+}
+
+- (instancetype)initWithPath:(NSString *)path data:(NSData *)data entries:(NSArray<FBZipArchiveEntry *> *)entries
+{
+  self = [super init];
+  if (!self) {
+    return nil;
+  }
+
+  _path = path;
+  _data = data;
+  _entries = entries;
+
+  return self;
+}
+
+#pragma mark Public Methods
+
+- (BOOL)extractToDirectory:(NSString *)directory error:(NSError **)error
+{
+  // All paths are validated upfront, so that a malicious archive does not leave a partial extraction behind.
+  NSMutableArray<FBZipArchiveEntry *> *files = [NSMutableArray array];
+  NSMutableArray<FBZipArchiveEntry *> *symbolicLinks = [NSMutableArray array];
+  NSMutableSet<NSString *> *directories = [NSMutableSet setWithObject:directory];
+  for (FBZipArchiveEntry *entry in self.entries) {
+    if (![FBZipArchive isSafeEntryPath:entry.path]) {
+      return [[FBControlCoreError
+        describeFormat:@"Zip archive %@ contains an entry with an unsafe path %@", self.path, entry.path]
+        failBool:error];
+    }
+    NSString *destination = [directory stringByAppendingPathComponent:entry.path];
+    if (entry.isDirectory) {
+      [directories addObject:destination];
+      continue;
+    }
+    [directories addObject:destination.stringByDeletingLastPathComponent];
+    [(entry.isSymbolicLink ? symbolicLinks : files) addObject:entry];
+  }
+
+  // Directories are created serially, then the files are inflated concurrently.
+  for (NSString *path in directories) {
+    NSError *innerError = nil;
+    if (![NSFileManager.defaultManager createDirectoryAtPath:path withIntermediateDirectories:YES attributes:nil error:&innerError]) {
+      return [[[FBControlCoreError
+        describeFormat:@"Could not create directory %@ when extracting %@", path, self.path]
+        causedBy:innerError]
+        failBool:error];
+    }
+  }
+  NSArray *results = [FBConcurrentCollectionOperations map:files withBlock:^ id (FBZipArchiveEntry *entry) {
+    NSError *innerError = nil;
+    if (![self extractEntry:entry toPath:[directory stringByAppendingPathComponent:entry.path] error:&innerError]) {
+      return innerError;
+    }
+    return NSNull.null;
+  }];
+  for (id result in results) {
+    if ([result isKindOfClass:NSError.class]) {
+      if (error) {
+        *error = result;
+      }
+      return NO;
+    }
+  }
+
+  // Symbolic links are created last, so that no file is written through a link from the archive.
+  for (FBZipArchiveEntry *entry in symbolicLinks) {
+    NSData *destination = [self contentsOfEntry:entry error:error];
+    if (!destination) {
+      return NO;
+    }
+    NSString *path = [directory stringByAppendingPathComponent:entry.path];
+    NSString *target = [[NSString alloc] initWithData:destination encoding:NSUTF8StringEncoding];
+    NSError *innerError = nil;
+    if (!target || ![NSFileManager.defaultManager createSymbolicLinkAtPath:path withDestinationPath:target error:&innerError]) {
+      return [[[FBControlCoreError
+        describeFormat:@"Could not create symbolic link %@ when extracting %@", path, self.path]
+        causedBy:innerError]
+        failBool:error];
+    }
+  }
+  return YES;
+}
+
+#pragma mark Central Directory
+
++ (nullable NSArray<FBZipArchiveEntry *> *)entriesFromData:(NSData *)data path:(NSString *)path error:(NSError **)error
+{
+  const uint8_t *bytes = data.bytes;
+  size_t length = data.length;
+  if (length < FBZipEndOfCentralDirectoryLength) {
+    return [[FBControlCoreError
+      describeFormat:@"%@ is too small to be a zip archive", path]
+      fail:error];
+  }
+
+  // The End of Central Directory record is at the end of the archive, followed by a comment of variable length.
+  size_t endOffset = length - FBZipEndOfCentralDirectoryLength;
+  size_t searchLimit = endOffset > FBZipMaximumCommentLength ? endOffset - FBZipMaximumCommentLength : 0;
+  while (FBZipRead32(bytes + endOffset) != FBZipEndOfCentralDirectorySignature) {
+    if (endOffset == searchLimit) {
+      return [[FBControlCoreError
+        describeFormat:@"%@ does not have an End of Central Directory record", path]
+        fail:error];
+    }
+    endOffset--;
+  }
+  uint64_t count = FBZipRead16(bytes + endOffset + 10);
+  uint64_t directoryLength = FBZipRead32(bytes + endOffset + 12);
+  uint64_t directoryOffset = FBZipRead32(bytes + endOffset + 16);
+
+  // Archives with more entries, or larger, than the original format allows have a Zip64 record that is referenced from before the End of Central Directory.
+  if (endOffset >= FBZip64EndOfCentralDirectoryLocatorLength && FBZipRead32(bytes + endOffset - FBZip64EndOfCentralDirectoryLocatorLength) == FBZip64EndOfCentralDirectoryLocatorSignature) {
+    uint64_t zip64Offset = FBZipRead64(bytes + endOffset - FBZip64EndOfCentralDirectoryLocatorLength + 8);
+    if (length < FBZip64EndOfCentralDirectoryLength || zip64Offset > length - FBZip64EndOfCentralDirectoryLength || FBZipRead32(bytes + zip64Offset) != FBZip64EndOfCentralDirectorySignature) {
+      return [[FBControlCoreError
+        describeFormat:@"%@ has an invalid Zip64 End of Central Directory record", path]
+        fail:error];
+    }
+    count = FBZipRead64(bytes + zip64Offset + 32);
+    directoryLength = FBZipRead64(bytes + zip64Offset + 40);
+    directoryOffset = FBZipRead64(bytes + zip64Offset + 48);
+  }
+  if (directoryOffset > length || directoryLength > length - directoryOffset) {
+    return [[FBControlCoreError
+      describeFormat:@"%@ has a Central Directory outside of the archive", path]
+      fail:error];
+  }
+
+  NSMutableArray<FBZipArchiveEntry *> *entries = [NSMutableArray arrayWithCapacity:(NSUInteger) MIN(count, (uint64_t) 0xffff)];
+  const uint8_t *position = bytes + directoryOffset;
+  const uint8_t *end = position + directoryLength;
+  for (uint64_t index = 0; index < count; index++) {
+    if ((size_t) (end - position) < FBZipCentralDirectoryHeaderLength || FBZipRead32(position) != FBZipCentralDirectorySignature) {
+      return [[FBControlCoreError
+        describeFormat:@"%@ has a truncated Central Directory at entry %llu", path, index]
+        fail:error];
+    }
+    uint16_t creator = (uint16_t) (FBZipRead16(position + 4) >> 8);
+    uint16_t flags = FBZipRead16(position + 8);
+    uint16_t method = FBZipRead16(position + 10);
+    uint32_t crc = FBZipRead32(position + 16);
+    uint64_t compressedSize = FBZipRead32(position + 20);
+    uint64_t uncompressedSize = FBZipRead32(position + 24);
+    size_t nameLength = FBZipRead16(position + 28);
+    size_t extraLength = FBZipRead16(position + 30);
+    size_t commentLength = FBZipRead16(position + 32);
+    uint32_t externalAttributes = FBZipRead32(position + 38);
+    uint64_t localHeaderOffset = FBZipRead32(position + 42);
+    const uint8_t *name = position + FBZipCentralDirectoryHeaderLength;
+    const uint8_t *extra = name + nameLength;
+    const uint8_t *next = extra + extraLength + commentLength;
+    if (next > end) {
+      return [[FBControlCoreError
+        describeFormat:@"%@ has a truncated Central Directory at entry %llu", path, index]
+        fail:error];
+    }
+
+    // Sizes and offsets that do not fit are saturated, the real values are in the Zip64 extra field in this order.
+    for (const uint8_t *field = extra; field + 4 <= extra + extraLength; ) {
+      uint16_t fieldIdentifier = FBZipRead16(field);
+      uint16_t fieldLength = FBZipRead16(field + 2);
+      const uint8_t *value = field + 4;
+      const uint8_t *valueEnd = MIN(value + fieldLength, extra + extraLength);
+      if (fieldIdentifier == FBZip64ExtraFieldIdentifier) {
+        if (uncompressedSize == UINT32_MAX && value + 8 <= valueEnd) {
+          uncompressedSize = FBZipRead64(value);
+          value += 8;
+        }
+        if (compressedSize == UINT32_MAX && value + 8 <= valueEnd) {
+          compressedSize = FBZipRead64(value);
+          value += 8;
+        }
+        if (localHeaderOffset == UINT32_MAX && value + 8 <= valueEnd) {
+          localHeaderOffset = FBZipRead64(value);
+        }
+      }
+      field = valueEnd;
+    }
+
+    // Names are UTF-8 in practice, even when the archive does not flag them as such.
+    NSString *entryPath = [[NSString alloc] initWithBytes:name length:nameLength encoding:NSUTF8StringEncoding];
+    if (!entryPath) {
+      entryPath = [[NSString alloc] initWithBytes:name length:nameLength encoding:NSISOLatin1StringEncoding];
+    }
+    if (flags & FBZipFlagEncrypted) {
+      return [[FBControlCoreError
+        describeFormat:@"%@ contains an encrypted entry %@", path, entryPath]
+        fail:error];
+    }
+    if (method != FBZipMethodStored && method != FBZipMethodDeflated) {
+      return [[FBControlCoreError
+        describeFormat:@"%@ contains entry %@ with unsupported compression method %u", path, entryPath, method]
+        fail:error];
+    }
+    // The type and permissions of the file are only present for archives created on Unix.
+    mode_t mode = creator == FBZipCreatorUnix ? (mode_t) (externalAttributes >> 16) : 0;
+    BOOL isDirectory = [entryPath hasSuffix:@"/"] || S_ISDIR(mode);
+    BOOL isSymbolicLink = !isDirectory && S_ISLNK(mode);
+    mode_t permissions = (mode_t) ((mode & 0777) ?: 0644);
+    [entries addObject:[[FBZipArchiveEntry alloc]
+      initWithPath:entryPath
+      method:method
+      crc:crc
+      compressedSize:compressedSize
+      uncompressedSize:uncompressedSize
+      localHeaderOffset:localHeaderOffset
+      isDirectory:isDirectory
+      isSymbolicLink:isSymbolicLink
+      permissions:permissions]];
+    position = next;
+  }
+  return [entries copy];
+}
+
++ (BOOL)isSafeEntryPath:(NSString *)path
+{
+  if (path.length == 0 || [path hasPrefix:@"/"]) {
+    return NO;
+  }
+  for (NSString *component in [path componentsSeparatedByString:@"/"]) {
+    if ([component isEqualToString:@".."]) {
+      return NO;
+    }
+  }
+  return YES;
+}
+
+#pragma mark Extraction
+
+- (nullable NSData *)compressedDataForEntry:(FBZipArchiveEntry *)entry error:(NSError **)error
+{
+  // The local header repeats the name, but may have a different extra field, so the offset of the data is read from it.
+  const uint8_t *bytes = self.data.bytes;
+  uint64_t length = self.data.length;
+  uint64_t offset = entry.localHeaderOffset;
+  if (offset > length || length - offset < FBZipLocalFileHeaderLength || FBZipRead32(bytes + offset) != FBZipLocalFileHeaderSignature) {
+    return [[FBControlCoreError
+      describeFormat:@"%@ has an invalid local header for %@", self.path, entry.path]
+      fail:error];
+  }
+  uint64_t dataOffset = offset + FBZipLocalFileHeaderLength + FBZipRead16(bytes + offset + 26) + FBZipRead16(bytes + offset + 28);
+  if (dataOffset > length || entry.compressedSize > length - dataOffset) {
+    return [[FBControlCoreError
+      describeFormat:@"%@ has truncated data for %@", self.path, entry.path]
+      fail:error];
+  }
+  // A subdata of mapped data references the mapping, rather than copying it.
+  return [self.data subdataWithRange:NSMakeRange((NSUInteger) dataOffset, (NSUInteger) entry.compressedSize)];
+}
+
+- (BOOL)inflateEntry:(FBZipArchiveEntry *)entry toBlock:(BOOL (^)(const uint8_t *bytes, size_t length))block error:(NSError **)error
+{
+  NSData *compressed = [self compressedDataForEntry:entry error:error];
+  if (!compressed) {
+    return NO;
+  }
+  uLong crc = crc32(0L, Z_NULL, 0);
+  unsigned long long written = 0;
+
+  if (entry.method == FBZipMethodStored) {
+    const uint8_t *position = compressed.bytes;
+    size_t remaining = compressed.length;
+    while (remaining > 0) {
+      size_t chunk = MIN(remaining, FBZipExtractionBufferSize);
+      if (written + chunk > entry.uncompressedSize) {
+        return [[FBControlCoreError
+          describeFormat:@"Extracted %@ from %@ is larger than the Central Directory, expected %llu", entry.path, self.path, entry.uncompressedSize]
+          failBool:error];
+      }
+      crc = crc32(crc, position, (uInt) chunk);
+      if (!block(position, chunk)) {
+        return [[FBControlCoreError
+          describeFormat:@"Could not write %@ from %@: %s", entry.path, self.path, strerror(errno)]
+          failBool:error];
+      }
+      position += chunk;
+      remaining -= chunk;
+      written += chunk;
+    }
+  } else {
+    z_stream stream;
+    memset(&stream, 0, sizeof(stream));
+    // Zip entries are raw deflate streams, without a zlib header.
+    if (inflateInit2(&stream, -MAX_WBITS) != Z_OK) {
+      return [[FBControlCoreError
+        describeFormat:@"Could not initialize inflate for %@", entry.path]
+        failBool:error];
+    }
+    uint8_t *buffer = malloc(FBZipExtractionBufferSize);
+    const uint8_t *input = compressed.bytes;
+    size_t inputRemaining = compressed.length;
+    int status = Z_OK;
+    BOOL writeFailed = NO;
+    BOOL oversized = NO;
+    while (status != Z_STREAM_END) {
+      if (stream.avail_in == 0 && inputRemaining > 0) {
+        size_t chunk = MIN(inputRemaining, (size_t) UINT32_MAX);
+        stream.next_in = (Bytef *) input;
+        stream.avail_in = (uInt) chunk;
+        input += chunk;
+        inputRemaining -= chunk;
+      }
+      stream.next_out = buffer;
+      stream.avail_out = (uInt) FBZipExtractionBufferSize;
+      status = inflate(&stream, Z_NO_FLUSH);
+      if (status != Z_OK && status != Z_STREAM_END) {
+        break;
+      }
+      size_t produced = FBZipExtractionBufferSize - stream.avail_out;
+      if (produced == 0 && status == Z_OK && stream.avail_in == 0 && inputRemaining == 0) {
+        status = Z_DATA_ERROR;
+        break;
+      }
+      // Stop before writing more than the Central Directory declares, so a small deflated entry cannot fill the disk.
+      if (written + produced > entry.uncompressedSize) {
+        oversized = YES;
+        break;
+      }
+      crc = crc32(crc, buffer, (uInt) produced);
+      if (produced > 0 && !block(buffer, produced)) {
+        writeFailed = YES;
+        break;
+      }
+      written += produced;
+    }
+    inflateEnd(&stream);
+    free(buffer);
+    if (writeFailed) {
+      return [[FBControlCoreError
+        describeFormat:@"Could not write %@ from %@: %s", entry.path, self.path, strerror(errno)]
+        failBool:error];
+    }
+    if (oversized) {
+      return [[FBControlCoreError
+        describeFormat:@"Extracted %@ from %@ is larger than the Central Directory, expected %llu", entry.path, self.path, entry.uncompressedSize]
+        failBool:error];
+    }
+    if (status != Z_STREAM_END) {
+      return [[FBControlCoreError
+        describeFormat:@"Could not inflate %@ from %@, zlib status %d", entry.path, self.path, status]
+        failBool:error];
+    }
+  }
+
+  if (written != entry.uncompressedSize || (uint32_t) crc != entry.crc) {
+    return [[FBControlCoreError
+      describeFormat:@"Extracted %@ from %@ does not match the Central Directory: size %llu, expected %llu", entry.path, self.path, written, entry.uncompressedSize]
+      failBool:error];
+  }
+  return YES;
+}
+
+- (BOOL)extractEntry:(FBZipArchiveEntry *)entry toPath:(NSString *)path error:(NSError **)error
+{
+  int fileDescriptor = open(path.fileSystemRepresentation, O_WRONLY | O_CREAT | O_TRUNC | O_NOFOLLOW | O_CLOEXEC, entry.permissions);
+  if (fileDescriptor < 0) {
+    return [[FBControlCoreError
+      describeFormat:@"Could not open %@ for writing: %s", path, strerror(errno)]
+      failBool:error];
+  }
+  BOOL success = [self inflateEntry:entry toBlock:^ BOOL (const uint8_t *bytes, size_t length) {
+    while (length > 0) {
+      ssize_t result = write(fileDescriptor, bytes, length);
+      if (result < 0 && errno == EINTR) {
+        continue;
+      }
+      if (result <= 0) {
+        return NO;
+      }
+      bytes += result;
+      length -= (size_t) result;
+    }
+    return YES;
+  } error:error];
+  // The permissions passed to open(2) are masked by the umask, the executable bits of the archive must be preserved.
+  fchmod(fileDescriptor, entry.permissions);
+  close(fileDescriptor);
+  return success;
+}
+
+- (nullable NSData *)contentsOfEntry:(FBZipArchiveEntry *)entry error:(NSError **)error
+{
+  NSMutableData *contents = [NSMutableData dataWithCapacity:(NSUInteger) MIN(entry.uncompressedSize, (unsigned long long) FBZipExtractionBufferSize)];
+  BOOL success = [self inflateEntry:entry toBlock:^ BOOL (const uint8_t *bytes, size_t length) {
+    [contents appendBytes:bytes length:length];
+    return YES;
+  } error:error];
+  return success ? contents : nil;
+}
+
+@end
+
+typedef NS_ENUM(NSUInteger, FBZipStreamState) {
+  FBZipStreamStateLocalHeader = 0,
+  FBZipStreamStateEntryData = 1,
+  FBZipStreamStateDataDescriptor = 2,
+  FBZipStreamStateCentralDirectory = 3,
+  FBZipStreamStateFinished = 4,
+};
+
+@interface FBZipStreamExtractedEntry : NSObject
+
+@property (nonatomic, assign, readonly) uint32_t crc;
+@property (nonatomic, assign, readonly) unsigned long long size;
+
+@end
+
+@implementation FBZipStreamExtractedEntry
+
+- (instancetype)initWithCRC:(uint32_t)crc size:(unsigned long long)size
+{
+  self = [super init];
+  if (!self) {
+    return nil;
+  }
+
+  _crc = crc;
+  _size = size;
+
+  return self;
+}
+
+@end
+
+@interface FBZipStreamExtractor ()
+{
+  z_stream _stream;
+}
+
+@property (nonatomic, copy, readonly) NSString *archivePath;
+@property (nonatomic, copy, readonly) NSString *directory;
+@property (nonatomic, assign, readonly) unsigned long long maximumExtractedSize;
+@property (nonatomic, strong, readonly) dispatch_queue_t queue;
+@property (nonatomic, strong, readonly) FBMutableFuture<NSString *> *completedMutable;
+@property (nonatomic, strong, readonly) NSMutableData *header;
+@property (nonatomic, strong, readonly) NSMutableDictionary<NSString *, FBZipStreamExtractedEntry *> *extracted;
+@property (nonatomic, assign, readonly) uint8_t *buffer;
+@property (nonatomic, assign, readwrite) FBZipStreamState state;
+@property (nonatomic, assign, readwrite) unsigned long long extractedSize;
+
+@property (nonatomic, copy, readwrite, nullable) NSString *entryPath;
+@property (nonatomic, assign, readwrite) uint16_t entryFlags;
+@property (nonatomic, assign, readwrite) uint16_t entryMethod;
+@property (nonatomic, assign, readwrite) uint32_t entryExpectedCRC;
+@property (nonatomic, assign, readwrite) unsigned long long entryExpectedSize;
+@property (nonatomic, assign, readwrite) unsigned long long entryRemaining;
+@property (nonatomic, assign, readwrite) BOOL entryIsZip64;
+@property (nonatomic, assign, readwrite) BOOL entryIsInflating;
+@property (nonatomic, assign, readwrite) int entryFileDescriptor;
+@property (nonatomic, assign, readwrite) uLong entryCRC;
+@property (nonatomic, assign, readwrite) unsigned long long entryWritten;
+
+@end
+
+@implementation FBZipStreamExtractor
+
+#pragma mark Initializers
+
++ (instancetype)extractorForArchiveAtPath:(NSString *)archivePath toDirectory:(NSString *)directory maximumExtractedSize:(unsigned long long)maximumExtractedSize
+{
+  return [[self alloc] initWithArchivePath:archivePath directory:directory maximumExtractedSize:maximumExtractedSize];
+}
+
+- (instancetype)initWithArchivePath:(NSString *)archivePath directory:(NSString *)directory maximumExtractedSize:(unsigned long long)maximumExtractedSize
+{
+  self = [super init];
+  if (!self) {
+    return nil;
+  }
+
+  _archivePath = archivePath;
+  _directory = directory;
+  _maximumExtractedSize = maximumExtractedSize;
+  _queue = dispatch_queue_create("com.facebook.fbcontrolcore.zip_stream", DISPATCH_QUEUE_SERIAL);
+  _completedMutable = FBMutableFuture.future;
+  _header = [NSMutableData data];
+  _extracted = [NSMutableDictionary dictionary];
+  _buffer = malloc(FBZipExtractionBufferSize);
+  _state = FBZipStreamStateLocalHeader;
+  _entryFileDescriptor = -1;
+
+  return self;
+}
+
+- (void)dealloc
+{
+  // An extractor that is released before it has finished removes what it has written.
+  [self closeEntry];
+  free(_buffer);
+  if (_state != FBZipStreamStateFinished) {
+    [NSFileManager.defaultManager removeItemAtPath:_directory error:nil];
+  }
+}
+
+#pragma mark Properties
+
+- (FBFuture<NSString *> *)completed
+{
+  return self.completedMutable;
+}
+
+#pragma mark FBDataConsumer
+
+- (void)consumeData:(NSData *)data
+{
+  dispatch_async(self.queue, ^{
+    [self processBytes:data.bytes length:data.length];
+  });
+}
+
+- (void)consumeEndOfFile
+{
+  dispatch_async(self.queue, ^{
+    [self verifyAgainstCentralDirectory];
+  });
+}
+
+#pragma mark Local Headers
+
+- (void)processBytes:(const uint8_t *)bytes length:(size_t)length
+{
+  while (length > 0) {
+    size_t consumed = 0;
+    switch (self.state) {
+      case FBZipStreamStateLocalHeader:
+        consumed = [self consumeLocalHeader:bytes length:length];
+        break;
+      case FBZipStreamStateEntryData:
+        consumed = [self consumeEntryData:bytes length:length];
+        break;
+      case FBZipStreamStateDataDescriptor:
+        consumed = [self consumeDataDescriptor:bytes length:length];
+        break;
+      case FBZipStreamStateCentralDirectory:
+      case FBZipStreamStateFinished:
+        // The Central Directory is read from the archive file once it is complete.
+        return;
+    }
+    bytes += consumed;
+    length -= consumed;
+  }
+}
+
+- (size_t)accumulateHeader:(const uint8_t *)bytes length:(size_t)length upTo:(size_t)needed
+{
+  size_t count = needed > self.header.length ? MIN(needed - self.header.length, length) : 0;
+  [self.header appendBytes:bytes length:count];
+  return count;
+}
+
+- (size_t)consumeLocalHeader:(const uint8_t *)bytes length:(size_t)length
+{
+  size_t consumed = [self accumulateHeader:bytes length:length upTo:4];
+  if (self.header.length < 4) {
+    return consumed;
+  }
+  uint32_t signature = FBZipRead32(self.header.bytes);
+  if (signature == FBZipCentralDirectorySignature || signature == FBZipEndOfCentralDirectorySignature) {
+    [self.header setLength:0];
+    self.state = FBZipStreamStateCentralDirectory;
+    return consumed;
+  }
+  if (signature != FBZipLocalFileHeaderSignature) {
+    [self failWithError:[[FBControlCoreError
+      describeFormat:@"%@ has an unexpected signature %08x where a local header was expected", self.archivePath, signature]
+      build]];
+    return consumed;
+  }
+  consumed += [self accumulateHeader:bytes + consumed length:length - consumed upTo:FBZipLocalFileHeaderLength];
+  if (self.header.length < FBZipLocalFileHeaderLength) {
+    return consumed;
+  }
+  const uint8_t *header = self.header.bytes;
+  size_t headerLength = FBZipLocalFileHeaderLength + FBZipRead16(header + 26) + FBZipRead16(header + 28);
+  consumed += [self accumulateHeader:bytes + consumed length:length - consumed upTo:headerLength];
+  if (self.header.length < headerLength) {
+    return consumed;
+  }
+  [self beginEntry];
+  return consumed;
+}
+
+- (void)beginEntry
+{
+  const uint8_t *header = self.header.bytes;
+  uint16_t flags = FBZipRead16(header + 6);
+  uint16_t method = FBZipRead16(header + 8);
+  uint32_t crc = FBZipRead32(header + 14);
+  uint64_t compressedSize = FBZipRead32(header + 18);
+  uint64_t uncompressedSize = FBZipRead32(header + 22);
+  size_t nameLength = FBZipRead16(header + 26);
+  size_t extraLength = FBZipRead16(header + 28);
+  const uint8_t *name = header + FBZipLocalFileHeaderLength;
+  const uint8_t *extra = name + nameLength;
+  BOOL isZip64 = NO;
+  for (const uint8_t *field = extra; field + 4 <= extra + extraLength; ) {
+    uint16_t fieldIdentifier = FBZipRead16(field);
+    const uint8_t *value = field + 4;
+    const uint8_t *valueEnd = MIN(value + FBZipRead16(field + 2), extra + extraLength);
+    if (fieldIdentifier == FBZip64ExtraFieldIdentifier) {
+      isZip64 = YES;
+      if (uncompressedSize == UINT32_MAX && value + 8 <= valueEnd) {
+        uncompressedSize = FBZipRead64(value);
+        value += 8;
+      }
+      if (compressedSize == UINT32_MAX && value + 8 <= valueEnd) {
+        compressedSize = FBZipRead64(value);
+      }
+    }
+    field = valueEnd;
+  }
+  NSString *path = [[NSString alloc] initWithBytes:name length:nameLength encoding:NSUTF8StringEncoding];
+  if (!path) {
+    path = [[NSString alloc] initWithBytes:name length:nameLength encoding:NSISOLatin1StringEncoding];
+  }
+  [self.header setLength:0];
+
+  if (flags & FBZipFlagEncrypted) {
+    [self failWithError:[[FBControlCoreError
+      describeFormat:@"%@ contains an encrypted entry %@", self.archivePath, path]
+      build]];
+    return;
+  }
+  if (method != FBZipMethodStored && method != FBZipMethodDeflated) {
+    [self failWithError:[[FBControlCoreError
+      describeFormat:@"%@ contains entry %@ with unsupported compression method %u", self.archivePath, path, method]
+      build]];
+    return;
+  }
+  if (method == FBZipMethodStored && (flags & FBZipFlagDataDescriptor)) {
+    [self failWithError:[[FBControlCoreError
+      describeFormat:@"%@ contains entry %@ that is stored without a size, so cannot be extracted from a stream", self.archivePath, path]
+      build]];
+    return;
+  }
+  if (![FBZipArchive isSafeEntryPath:path]) {
+    [self failWithError:[[FBControlCoreError
+      describeFormat:@"Zip archive %@ contains an entry with an unsafe path %@", self.archivePath, path]
+      build]];
+    return;
+  }
+
+  self.entryPath = path;
+  self.entryFlags = flags;
+  self.entryMethod = method;
+  self.entryExpectedCRC = crc;
+  self.entryExpectedSize = uncompressedSize;
+  self.entryRemaining = compressedSize;
+  self.entryIsZip64 = isZip64;
+  self.entryCRC = crc32(0L, Z_NULL, 0);
+  self.entryWritten = 0;
+
+  // Files are created without their permissions, which are only present in the Central Directory.
+  NSString *destination = [self.directory stringByAppendingPathComponent:path];
+  BOOL isDirectory = [path hasSuffix:@"/"];
+  NSString *parent = isDirectory ? destination : destination.stringByDeletingLastPathComponent;
+  NSError *error = nil;
+  if (![NSFileManager.defaultManager createDirectoryAtPath:parent withIntermediateDirectories:YES attributes:nil error:&error]) {
+    [self failWithError:[[[FBControlCoreError
+      describeFormat:@"Could not create directory %@ when extracting %@", parent, self.archivePath]
+      causedBy:error]
+      build]];
+    return;
+  }
+  if (!isDirectory) {
+    int fileDescriptor = open(destination.fileSystemRepresentation, O_WRONLY | O_CREAT | O_TRUNC | O_NOFOLLOW | O_CLOEXEC, 0644);
+    if (fileDescriptor < 0) {
+      [self failWithError:[[FBControlCoreError
+        describeFormat:@"Could not open %@ for writing: %s", destination, strerror(errno)]
+        build]];
+      return;
+    }
+    self.entryFileDescriptor = fileDescriptor;
+  }
+  if (method == FBZipMethodDeflated) {
+    memset(&_stream, 0, sizeof(_stream));
+    if (inflateInit2(&_stream, -MAX_WBITS) != Z_OK) {
+      [self failWithError:[[FBControlCoreError
+        describeFormat:@"Could not initialize inflate for %@", path]
+        build]];
+      return;
+    }
+    self.entryIsInflating = YES;
+  }
+  self.state = FBZipStreamStateEntryData;
+  if (method == FBZipMethodStored && compressedSize == 0) {
+    [self finishEntryData];
+  }
+}
+
+#pragma mark Entry Data
+
+- (size_t)consumeEntryData:(const uint8_t *)bytes length:(size_t)length
+{
+  if (self.entryMethod == FBZipMethodStored) {
+    size_t chunk = (size_t) MIN((unsigned long long) length, self.entryRemaining);
+    if (![self writeEntryBytes:bytes length:chunk]) {
+      return chunk;
+    }
+    self.entryRemaining -= chunk;
+    if (self.entryRemaining == 0) {
+      [self finishEntryData];
+    }
+    return chunk;
+  }
+
+  // The end of a deflated entry is only known when the inflater reaches the end of the stream, any input after it belongs to the next header.
+  size_t available = MIN(length, (size_t) UINT32_MAX);
+  _stream.next_in = (Bytef *) bytes;
+  _stream.avail_in = (uInt) available;
+  int status = Z_OK;
+  do {
+    _stream.next_out = self.buffer;
+    _stream.avail_out = (uInt) FBZipExtractionBufferSize;
+    status = inflate(&_stream, Z_NO_FLUSH);
+    if (status != Z_OK && status != Z_STREAM_END && status != Z_BUF_ERROR) {
+      [self failWithError:[[FBControlCoreError
+        describeFormat:@"Could not inflate %@ from %@, zlib status %d", self.entryPath, self.archivePath, status]
+        build]];
+      return available;
+    }
+    size_t produced = FBZipExtractionBufferSize - _stream.avail_out;
+    if (produced > 0 && ![self writeEntryBytes:self.buffer length:produced]) {
+      return available;
+    }
+  } while (status == Z_OK && (_stream.avail_in > 0 || _stream.avail_out == 0));
+  size_t consumed = available - _stream.avail_in;
+  if (status == Z_STREAM_END) {
+    [self finishEntryData];
+  }
+  return consumed;
+}
+
+- (BOOL)writeEntryBytes:(const uint8_t *)bytes length:(size_t)length
+{
+  // The sizes are otherwise only verified once an entry has been inflated, so a small deflated entry could fill the disk first.
+  // An entry with a data descriptor has no size in its local header, so only the total is bounded.
+  BOOL hasSize = (self.entryFlags & FBZipFlagDataDescriptor) == 0;
+  if (hasSize && self.entryWritten + length > self.entryExpectedSize) {
+    [self failWithError:[[FBControlCoreError
+      describeFormat:@"Extracted %@ from %@ is larger than its local header, expected %llu", self.entryPath, self.archivePath, self.entryExpectedSize]
+      build]];
+    return NO;
+  }
+  if (self.extractedSize + length > self.maximumExtractedSize) {
+    [self failWithError:[[FBControlCoreError
+      describeFormat:@"Extracting %@ whilst it is written exceeds %llu bytes", self.archivePath, self.maximumExtractedSize]
+      build]];
+    return NO;
+  }
+  self.entryCRC = crc32(self.entryCRC, bytes, (uInt) length);
+  self.entryWritten += length;
+  self.extractedSize += length;
+  if (self.entryFileDescriptor < 0) {
+    return YES;
+  }
+  while (length > 0) {
+    ssize_t result = write(self.entryFileDescriptor, bytes, length);
+    if (result < 0 && errno == EINTR) {
+      continue;
+    }
+    if (result <= 0) {
+      [self failWithError:[[FBControlCoreError
+        describeFormat:@"Could not write %@ from %@: %s", self.entryPath, self.archivePath, strerror(errno)]
+        build]];
+      return NO;
+    }
+    bytes += result;
+    length -= (size_t) result;
+  }
+  return YES;
+}
+
+- (void)finishEntryData
+{
+  [self closeEntry];
+  if (self.entryFlags & FBZipFlagDataDescriptor) {
+    self.state = FBZipStreamStateDataDescriptor;
+    return;
+  }
+  [self recordEntryWithCRC:self.entryExpectedCRC size:self.entryExpectedSize];
+}
+
+- (size_t)consumeDataDescriptor:(const uint8_t *)bytes length:(size_t)length
+{
+  // The CRC and sizes of the entry follow its data, optionally preceded by a signature.
+  size_t consumed = [self accumulateHeader:bytes length:length upTo:4];
+  if (self.header.length < 4) {
+    return consumed;
+  }
+  size_t signatureLength = FBZipRead32(self.header.bytes) == FBZipDataDescriptorSignature ? 4 : 0;
+  size_t descriptorLength = signatureLength + (self.entryIsZip64 ? 20 : 12);
+  consumed += [self accumulateHeader:bytes + consumed length:length - consumed upTo:descriptorLength];
+  if (self.header.length < descriptorLength) {
+    return consumed;
+  }
+  const uint8_t *descriptor = (const uint8_t *) self.header.bytes + signatureLength;
+  uint32_t crc = FBZipRead32(descriptor);
+  unsigned long long size = self.entryIsZip64 ? FBZipRead64(descriptor + 12) : FBZipRead32(descriptor + 8);
+  [self.header setLength:0];
+  [self recordEntryWithCRC:crc size:size];
+  return consumed;
+}
+
+- (void)recordEntryWithCRC:(uint32_t)crc size:(unsigned long long)size
+{
+  if ((uint32_t) self.entryCRC != crc || self.entryWritten != size) {
+    [self failWithError:[[FBControlCoreError
+      describeFormat:@"Extracted %@ from %@ does not match its local header: size %llu, expected %llu", self.entryPath, self.archivePath, self.entryWritten, size]
+      build]];
+    return;
+  }
+  self.extracted[self.entryPath] = [[FBZipStreamExtractedEntry alloc] initWithCRC:crc size:size];
+  self.entryPath = nil;
+  self.state = FBZipStreamStateLocalHeader;
+}
+
+- (void)closeEntry
+{
+  if (_entryIsInflating) {
+    inflateEnd(&_stream);
+    _entryIsInflating = NO;
+  }
+  if (_entryFileDescriptor >= 0) {
+    close(_entryFileDescriptor);
+    _entryFileDescriptor = -1;
+  }
+}
+
+#pragma mark Central Directory
+
+- (void)verifyAgainstCentralDirectory
+{
+  if (self.state == FBZipStreamStateFinished) {
+    return;
+  }
+  if (self.state != FBZipStreamStateCentralDirectory) {
+    [self failWithError:[[FBControlCoreError
+      describeFormat:@"%@ ended before its Central Directory", self.archivePath]
+      build]];
+    return;
+  }
+  NSError *error = nil;
+  FBZipArchive *archive = [FBZipArchive archiveAtPath:self.archivePath error:&error];
+  if (!archive || ![NSFileManager.defaultManager createDirectoryAtPath:self.directory withIntermediateDirectories:YES attributes:nil error:&error]) {
+    [self failWithError:error];
+    return;
+  }
+
+  NSMutableArray<FBZipArchiveEntry *> *symbolicLinks = [NSMutableArray array];
+  for (FBZipArchiveEntry *entry in archive.entries) {
+    FBZipStreamExtractedEntry *extracted = self.extracted[entry.path];
+    [self.extracted removeObjectForKey:entry.path];
+    NSString *path = [self.directory stringByAppendingPathComponent:entry.path];
+    if (entry.isDirectory) {
+      if (![NSFileManager.defaultManager createDirectoryAtPath:path withIntermediateDirectories:YES attributes:nil error:&error]) {
+        [self failWithError:error];
+        return;
+      }
+      continue;
+    }
+    if (!extracted || extracted.crc != entry.crc || extracted.size != entry.uncompressedSize) {
+      [self failWithError:[[FBControlCoreError
+        describeFormat:@"Extracted %@ from %@ does not match the Central Directory", entry.path, self.archivePath]
+        build]];
+      return;
+    }
+    if (entry.isSymbolicLink) {
+      [symbolicLinks addObject:entry];
+      continue;
+    }
+    if (chmod(path.fileSystemRepresentation, entry.permissions) != 0) {
+      [self failWithError:[[FBControlCoreError
+        describeFormat:@"Could not set the permissions of %@: %s", path, strerror(errno)]
+        build]];
+      return;
+    }
+  }
+  if (self.extracted.count > 0) {
+    [self failWithError:[[FBControlCoreError
+      describeFormat:@"%@ contains entries that are not in its Central Directory %@", self.archivePath, [FBCollectionInformation oneLineDescriptionFromArray:self.extracted.allKeys]]
+      build]];
+    return;
+  }
+
+  // Symbolic links were extracted as files containing their destination, they are replaced last so that no file is written through a link from the archive.
+  for (FBZipArchiveEntry *entry in symbolicLinks) {
+    NSString *path = [self.directory stringByAppendingPathComponent:entry.path];
+    NSString *target = [NSString stringWithContentsOfFile:path encoding:NSUTF8StringEncoding error:&error];
+    if (!target || ![NSFileManager.defaultManager removeItemAtPath:path error:&error] || ![NSFileManager.defaultManager createSymbolicLinkAtPath:path withDestinationPath:target error:&error]) {
+      [self failWithError:[[[FBControlCoreError
+        describeFormat:@"Could not create symbolic link %@ when extracting %@", path, self.archivePath]
+        causedBy:error]
+        build]];
+      return;
+    }
+  }
+  self.state = FBZipStreamStateFinished;
+  [self.completedMutable resolveWithResult:self.directory];
+}
+
+- (void)failWithError:(NSError *)error
+{
+  [self closeEntry];
+  [self.header setLength:0];
+  self.state = FBZipStreamStateFinished;
+  [NSFileManager.defaultManager removeItemAtPath:self.directory error:nil];
+  [self.completedMutable resolveWithError:error];
+}
+
+@end
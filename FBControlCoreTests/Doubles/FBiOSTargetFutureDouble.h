@@ -11,11 +11,38 @@
 
 #import <FBControlCore/FBControlCore.h>
 
+NS_ASSUME_NONNULL_BEGIN
+
 @interface FBiOSTargetFutureDouble : NSObject <FBiOSTargetFuture>
 
 @property (nonatomic, copy, readonly) NSString *identifier;
 @property (nonatomic, assign, readonly) BOOL succeed;
+@property (nonatomic, copy, nullable, readonly) NSString *conflictGroup;
 
 - (instancetype)initWithIdentifier:(NSString *)identifier succeed:(BOOL)succeed;
 
+/**
+ A Double that conflicts with other Doubles in the same group, so that they cannot run concurrently.
+ */
+- (instancetype)initWithIdentifier:(NSString *)identifier succeed:(BOOL)succeed conflictGroup:(nullable NSString *)conflictGroup;
+
+/**
+ Doubles with the identifier do not complete until the gate has resolved.
+ The gate is found by identifier, as the Doubles that are run by a reader are inflated from JSON.
+
+ @param gate the gate to wait for, or nil to remove the gate.
+ @param identifier the identifier of the Doubles.
+ */
++ (void)setGate:(nullable FBFuture<NSNull *> *)gate forIdentifier:(NSString *)identifier;
+
+/**
+ Doubles with the identifier write the chunks to their consumer when they are run.
+
+ @param chunks the chunks to write, or nil to remove them.
+ @param identifier the identifier of the Doubles.
+ */
++ (void)setOutput:(nullable NSArray<NSData *> *)chunks forIdentifier:(NSString *)identifier;
+
 @end
+
+NS_ASSUME_NONNULL_END
@@ -11,7 +11,32 @@
 
 @implementation FBiOSTargetFutureDouble
 
+static NSMutableDictionary<NSString *, FBFuture<NSNull *> *> *Gates(void)
+{
+  static dispatch_once_t onceToken;
+  static NSMutableDictionary<NSString *, FBFuture<NSNull *> *> *gates;
+  dispatch_once(&onceToken, ^{
+    gates = [NSMutableDictionary dictionary];
+  });
+  return gates;
+}
+
+static NSMutableDictionary<NSString *, NSArray<NSData *> *> *Outputs(void)
+{
+  static dispatch_once_t onceToken;
+  static NSMutableDictionary<NSString *, NSArray<NSData *> *> *outputs;
+  dispatch_once(&onceToken, ^{
+    outputs = [NSMutableDictionary dictionary];
+  });
+  return outputs;
+}
+
 - (instancetype)initWithIdentifier:(NSString *)identifier succeed:(BOOL)succeed
+{
+  return [self initWithIdentifier:identifier succeed:succeed conflictGroup:nil];
+}
+
+- (instancetype)initWithIdentifier:(NSString *)identifier succeed:(BOOL)succeed conflictGroup:(nullable NSString *)conflictGroup
 {
   self = [super init];
   if (!self) {
@@ -20,10 +45,25 @@
 
   _identifier = identifier;
   _succeed = succeed;
+  _conflictGroup = conflictGroup;
 
   return self;
 }
 
++ (void)setGate:(nullable FBFuture<NSNull *> *)gate forIdentifier:(NSString *)identifier
+{
+  @synchronized (Gates()) {
+    Gates()[identifier] = gate;
+  }
+}
+
++ (void)setOutput:(nullable NSArray<NSData *> *)chunks forIdentifier:(NSString *)identifier
+{
+  @synchronized (Outputs()) {
+    Outputs()[identifier] = chunks;
+  }
+}
+
 + (FBiOSTargetFutureType)futureType
 {
   return @"test-double";
@@ -31,6 +71,7 @@
 
 static NSString *const KeyIdentifier = @"identifier";
 static NSString *const KeySucceed = @"succeed";
+static NSString *const KeyConflictGroup = @"conflict_group";
 
 + (nullable instancetype)inflateFromJSON:(id)json error:(NSError **)error
 {
@@ -46,18 +87,47 @@ static NSString *const KeySucceed = @"succeed";
       describeFormat:@"%@ is not a Number for %@", succeed, KeySucceed]
       fail:error];
   }
-  return [[FBiOSTargetFutureDouble alloc] initWithIdentifier:identifier succeed:succeed.boolValue];
+  NSString *conflictGroup = json[KeyConflictGroup];
+  if (conflictGroup && ![conflictGroup isKindOfClass:NSString.class]) {
+    return [[FBControlCoreError
+      describeFormat:@"%@ is not a String for %@", conflictGroup, KeyConflictGroup]
+      fail:error];
+  }
+  return [[FBiOSTargetFutureDouble alloc] initWithIdentifier:identifier succeed:succeed.boolValue conflictGroup:conflictGroup];
 }
 
 - (id)jsonSerializableRepresentation
 {
-  return @{
+  NSMutableDictionary<NSString *, id> *json = [NSMutableDictionary dictionaryWithDictionary:@{
     KeyIdentifier: self.identifier,
     KeySucceed: @(self.succeed),
-  };
+  }];
+  json[KeyConflictGroup] = self.conflictGroup;
+  return [json copy];
 }
 
 - (FBFuture<id<FBiOSTargetContinuation>> *)runWithTarget:(id<FBiOSTarget>)target consumer:(id<FBDataConsumer>)consumer reporter:(id<FBEventReporter>)reporter
+{
+  NSArray<NSData *> *chunks = nil;
+  @synchronized (Outputs()) {
+    chunks = Outputs()[self.identifier];
+  }
+  for (NSData *chunk in chunks) {
+    [consumer consumeData:chunk];
+  }
+  FBFuture<NSNull *> *gate = nil;
+  @synchronized (Gates()) {
+    gate = Gates()[self.identifier];
+  }
+  if (gate) {
+    return [gate onQueue:dispatch_get_global_queue(DISPATCH_QUEUE_PRIORITY_DEFAULT, 0) fmap:^(id _) {
+      return [self completion];
+    }];
+  }
+  return [self completion];
+}
+
+- (FBFuture<id<FBiOSTargetContinuation>> *)completion
 {
   if (self.succeed) {
     return [FBFuture futureWithResult:FBiOSTargetContinuationDone(self.class.futureType)];
@@ -67,6 +137,15 @@ static NSString *const KeySucceed = @"succeed";
   }
 }
 
+- (BOOL)conflictsWithAction:(id<FBiOSTargetFuture>)action
+{
+  // Doubles may run concurrently, unless they are in the same conflict group.
+  if (!self.conflictGroup || ![action isKindOfClass:FBiOSTargetFutureDouble.class]) {
+    return NO;
+  }
+  return [self.conflictGroup isEqualToString:((FBiOSTargetFutureDouble *) action).conflictGroup];
+}
+
 - (BOOL)isEqual:(FBiOSTargetFutureDouble *)object
 {
   if (![object isKindOfClass:self.class]) {
@@ -62,6 +62,40 @@
   [writer consumeEndOfFile];
 }
 
+- (NSFileHandle *)readOnlyFileHandle
+{
+  // Writing to a descriptor that is only open for reading fails with EBADF, without raising a signal.
+  NSString *filePath = [NSTemporaryDirectory() stringByAppendingPathComponent:NSUUID.UUID.UUIDString];
+  [[NSData data] writeToFile:filePath atomically:YES];
+  return [NSFileHandle fileHandleForReadingAtPath:filePath];
+}
+
+- (void)testSyncWriterSurfacesWriteFailure
+{
+  id<FBDataConsumer, FBDataConsumerLifecycle> writer = [FBFileWriter syncWriterWithFileHandle:self.readOnlyFileHandle];
+  [writer consumeData:[@"Foo Bar Baz" dataUsingEncoding:NSUTF8StringEncoding]];
+  XCTAssertEqual(writer.eofHasBeenReceived.state, FBFutureStateFailed);
+  XCTAssertTrue([writer.eofHasBeenReceived.error.description containsString:@"Failed to write"]);
+
+  // Subsequent data is discarded, rather than failing again.
+  [writer consumeData:[@"Qux" dataUsingEncoding:NSUTF8StringEncoding]];
+  [writer consumeEndOfFile];
+  XCTAssertEqual(writer.eofHasBeenReceived.state, FBFutureStateFailed);
+}
+
+- (void)testAsyncWriterSurfacesWriteFailure
+{
+  NSError *error = nil;
+  id<FBDataConsumer, FBDataConsumerLifecycle> writer = [FBFileWriter asyncWriterWithFileHandle:self.readOnlyFileHandle error:&error];
+  XCTAssertNil(error);
+  XCTAssertNotNil(writer);
+
+  [writer consumeData:[@"Foo Bar Baz" dataUsingEncoding:NSUTF8StringEncoding]];
+  XCTAssertNil([writer.eofHasBeenReceived awaitWithTimeout:FBControlCoreGlobalConfiguration.fastTimeout error:&error]);
+  XCTAssertTrue([error.description containsString:@"Failed to write"]);
+  [writer consumeEndOfFile];
+}
+
 - (void)testOpeningAFifoAtBothEndsAsynchronously
 {
   id<FBAccumulatingBuffer> consumer = [FBLineBuffer accumulatingBuffer];
@@ -0,0 +1,42 @@
+/**
+ * Copyright (c) 2015-present, Facebook, Inc.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree. An additional grant
+ * of patent rights can be found in the PATENTS file in the same directory.
+ */
+
+#import <XCTest/XCTest.h>
+
+#import <FBControlCore/FBControlCore.h>
+
+@interface FBLineBufferPerformanceTests : XCTestCase
+
+@end
+
+@implementation FBLineBufferPerformanceTests
+
+static NSUInteger const LargeBacklogSize = 100 * 1024 * 1024;
+
+- (void)testCursorLineThroughputFor100MBBacklog
+{
+  NSData *line = [@"Some moderately long line of output from a chatty process\n" dataUsingEncoding:NSUTF8StringEncoding];
+  NSMutableData *backlog = [NSMutableData dataWithCapacity:LargeBacklogSize];
+  while (backlog.length < LargeBacklogSize) {
+    [backlog appendData:line];
+  }
+
+  // Only the cursor buffer is measured, as draining a backlog of this size from the consumable buffer is quadratic.
+  [self measureBlock:^{
+    id<FBConsumableBuffer> consumer = FBLineBuffer.cursorConsumableBuffer;
+    [consumer consumeData:backlog];
+    NSUInteger lines = 0;
+    while ([consumer consumeLineData]) {
+      lines++;
+    }
+    XCTAssertEqual(lines, backlog.length / line.length);
+  }];
+}
+
+@end
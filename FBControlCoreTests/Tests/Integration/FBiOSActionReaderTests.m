@@ -9,6 +9,8 @@
 
 #import <XCTest/XCTest.h>
 
+#import <sys/resource.h>
+
 #import <FBControlCore/FBControlCore.h>
 
 #import "FBiOSTargetDouble.h"
@@ -29,6 +31,10 @@ NS_ASSUME_NONNULL_BEGIN
 @property (nonatomic, strong, readwrite) NSMutableArray<id<FBiOSTargetFuture>> *failedActions;
 @property (nonatomic, strong, readwrite) NSMutableArray<FBUploadedDestination *> *uploads;
 @property (nonatomic, strong, readwrite) NSMutableArray<NSString *> *badInput;
+@property (nonatomic, strong, readwrite) NSMutableArray<NSString *> *events;
+@property (nonatomic, assign, readwrite) BOOL reportsResponses;
+@property (nonatomic, strong, nullable, readwrite) NSPipe *responsePipe;
+@property (nonatomic, strong, readwrite) NSMutableData *responses;
 
 @end
 
@@ -54,6 +60,8 @@ NS_ASSUME_NONNULL_BEGIN
   self.failedActions = [NSMutableArray array];
   self.uploads = [NSMutableArray array];
   self.badInput = [NSMutableArray array];
+  self.events = [NSMutableArray array];
+  self.responses = [NSMutableData data];
 
   self.pipe = NSPipe.pipe;
   self.reader = [FBiOSActionReader fileReaderForRouter:self.router delegate:self readHandle:self.pipe.fileHandleForReading writeHandle:self.pipe.fileHandleForWriting];
@@ -68,6 +76,7 @@ NS_ASSUME_NONNULL_BEGIN
 - (void)tearDown
 {
   [super tearDown];
+  self.responsePipe.fileHandleForReading.readabilityHandler = nil;
 
   NSError *error;
   BOOL success = [[self.reader stopListening] await:&error] != nil;
@@ -110,6 +119,13 @@ NS_ASSUME_NONNULL_BEGIN
   }];
 }
 
+- (NSPredicate *)predicateForFileCount:(NSUInteger)count inDirectory:(NSString *)directory
+{
+  return [NSPredicate predicateWithBlock:^ BOOL (id _, id __) {
+    return [NSFileManager.defaultManager contentsOfDirectoryAtPath:directory error:nil].count == count;
+  }];
+}
+
 - (void)waitForPredicates:(NSArray<NSPredicate *> *)predicates
 {
   NSPredicate *predicate = [NSCompoundPredicate andPredicateWithSubpredicates:predicates];
@@ -149,6 +165,42 @@ NS_ASSUME_NONNULL_BEGIN
   ]];
 }
 
+- (void)testBlankLinesAreNotBadInput
+{
+  FBiOSTargetFutureDouble *inputAction = [[FBiOSTargetFutureDouble alloc] initWithIdentifier:@"Foo" succeed:YES];
+  [self.consumer consumeData:[@"\n\r\n  \n" dataUsingEncoding:NSUTF8StringEncoding]];
+  [self.consumer consumeData:[self actionLine:inputAction]];
+
+  [self waitForPredicates:@[
+    [self predicateForFinished:inputAction],
+  ]];
+  XCTAssertEqual(self.badInput.count, 0u);
+}
+
+- (void)testUnterminatedLineIsDispatchedAtEndOfFile
+{
+  NSPipe *input = NSPipe.pipe;
+  NSPipe *output = NSPipe.pipe;
+  FBiOSActionReader *reader = [FBiOSActionReader fileReaderForRouter:self.router delegate:self readHandle:input.fileHandleForReading writeHandle:output.fileHandleForWriting];
+  NSError *error = nil;
+  XCTAssertNotNil([[reader startListening] await:&error]);
+  XCTAssertNil(error);
+
+  FBiOSTargetFutureDouble *inputAction = [[FBiOSTargetFutureDouble alloc] initWithIdentifier:@"Foo" succeed:YES];
+  NSData *line = [self actionLine:inputAction];
+  id<FBDataConsumer> consumer = [FBFileWriter syncWriterWithFileHandle:input.fileHandleForWriting];
+  [consumer consumeData:[line subdataWithRange:NSMakeRange(0, line.length - 1)]];
+  [consumer consumeEndOfFile];
+
+  [self waitForPredicates:@[
+    [self predicateForStarted:inputAction],
+    [self predicateForFinished:inputAction],
+  ]];
+
+  XCTAssertNotNil([[reader stopListening] await:&error]);
+  XCTAssertNil(error);
+}
+
 - (void)testCanUploadBinary
 {
   NSData *transmit = [@"foo bar baz" dataUsingEncoding:NSUTF8StringEncoding];
@@ -188,6 +240,401 @@ NS_ASSUME_NONNULL_BEGIN
   ]];
 }
 
+#pragma mark Pipelining
+
+- (FBiOSActionReader *)pipelinedReaderWithConsumerOut:(id<FBDataConsumer> *)consumerOut
+{
+  // Responses are written to a separate pipe, so that they can be read back without being interpreted as input.
+  self.reportsResponses = YES;
+  NSPipe *input = NSPipe.pipe;
+  self.responsePipe = NSPipe.pipe;
+  NSMutableData *responses = self.responses;
+  self.responsePipe.fileHandleForReading.readabilityHandler = ^(NSFileHandle *handle) {
+    NSData *data = handle.availableData;
+    @synchronized (responses) {
+      [responses appendData:data];
+    }
+  };
+  FBiOSActionReader *reader = [FBiOSActionReader fileReaderForRouter:self.router delegate:self readHandle:input.fileHandleForReading writeHandle:self.responsePipe.fileHandleForWriting maximumConcurrentActions:2];
+  NSError *error = nil;
+  XCTAssertNotNil([[reader startListening] await:&error]);
+  XCTAssertNil(error);
+
+  *consumerOut = [FBFileWriter syncWriterWithFileHandle:input.fileHandleForWriting];
+  return reader;
+}
+
+- (void)sendAction:(FBiOSTargetFutureDouble *)action toConsumer:(id<FBDataConsumer>)consumer
+{
+  NSMutableDictionary<NSString *, id> *json = [[self.router jsonFromAction:action] mutableCopy];
+  json[@"request_id"] = [action.identifier stringByAppendingString:@"-request"];
+  NSMutableData *line = [[NSJSONSerialization dataWithJSONObject:json options:0 error:nil] mutableCopy];
+  [line appendData:[NSData dataWithBytes:"\n" length:1]];
+  [consumer consumeData:line];
+}
+
+- (NSArray<NSDictionary<NSString *, id> *> *)responseObjects
+{
+  NSString *output = nil;
+  @synchronized (self.responses) {
+    output = [[NSString alloc] initWithData:self.responses encoding:NSUTF8StringEncoding];
+  }
+  NSMutableArray<NSDictionary<NSString *, id> *> *responses = [NSMutableArray array];
+  for (NSString *line in [output componentsSeparatedByString:@"\n"]) {
+    if (line.length == 0) {
+      continue;
+    }
+    id json = [NSJSONSerialization JSONObjectWithData:[line dataUsingEncoding:NSUTF8StringEncoding] options:0 error:nil];
+    XCTAssertTrue([json isKindOfClass:NSDictionary.class], @"Response %@ is not a JSON Object", line);
+    [responses addObject:json];
+  }
+  return [responses copy];
+}
+
+- (NSPredicate *)predicateForResponseCount:(NSUInteger)count
+{
+  return [NSPredicate predicateWithBlock:^ BOOL (FBiOSActionReaderTests *tests, id __) {
+    return tests.responseObjects.count == count;
+  }];
+}
+
+- (NSUInteger)maximumConcurrentEvents
+{
+  NSUInteger running = 0;
+  NSUInteger maximum = 0;
+  for (NSString *event in self.events) {
+    if ([event hasPrefix:@"started:"]) {
+      running++;
+      maximum = MAX(maximum, running);
+    } else {
+      running--;
+    }
+  }
+  return maximum;
+}
+
+- (void)waitForActionsToBeScheduled
+{
+  // An action that is not expected to start has no event to wait for, so the scheduler is given time to start it if it were able to.
+  [NSRunLoop.currentRunLoop runUntilDate:[NSDate dateWithTimeIntervalSinceNow:0.5]];
+}
+
+- (void)testPipelinedActionsEchoRequestIdentifiersAndCompleteOutOfOrder
+{
+  id<FBDataConsumer> consumer = nil;
+  FBiOSActionReader *reader = [self pipelinedReaderWithConsumerOut:&consumer];
+  FBMutableFuture<NSNull *> *gate = FBMutableFuture.future;
+  [FBiOSTargetFutureDouble setGate:gate forIdentifier:@"Slow"];
+  FBiOSTargetFutureDouble *slow = [[FBiOSTargetFutureDouble alloc] initWithIdentifier:@"Slow" succeed:YES];
+  FBiOSTargetFutureDouble *fast = [[FBiOSTargetFutureDouble alloc] initWithIdentifier:@"Fast" succeed:NO];
+  [self sendAction:slow toConsumer:consumer];
+  [self sendAction:fast toConsumer:consumer];
+
+  // The second action completes whilst the first is still running.
+  [self waitForPredicates:@[
+    [self predicateForStarted:slow],
+    [self predicateForFailed:fast],
+  ]];
+  XCTAssertFalse([self.finishedActions containsObject:slow]);
+
+  [gate resolveWithResult:NSNull.null];
+  [self waitForPredicates:@[
+    [self predicateForFinished:slow],
+    [self predicateForResponseCount:4],
+  ]];
+  [FBiOSTargetFutureDouble setGate:nil forIdentifier:@"Slow"];
+
+  // Each response carries the request identifier of the action it belongs to, as they are not in the order of the requests.
+  NSArray<NSDictionary<NSString *, id> *> *responses = self.responseObjects;
+  for (NSDictionary<NSString *, id> *response in responses) {
+    XCTAssertEqualObjects(response[@"request_id"], [response[@"identifier"] stringByAppendingString:@"-request"]);
+  }
+  NSArray<NSString *> *completions = [[responses filteredArrayUsingPredicate:[NSPredicate predicateWithFormat:@"event != 'started'"]] valueForKey:@"request_id"];
+  XCTAssertEqualObjects(completions, (@[@"Fast-request", @"Slow-request"]));
+
+  NSError *error = nil;
+  XCTAssertNotNil([[reader stopListening] await:&error]);
+  XCTAssertNil(error);
+}
+
+- (void)testPipelinedActionOutputIsWrittenInLinesWithTheRequestIdentifier
+{
+  id<FBDataConsumer> consumer = nil;
+  FBiOSActionReader *reader = [self pipelinedReaderWithConsumerOut:&consumer];
+  // The output line is split across writes, so it is only written once it is complete.
+  [FBiOSTargetFutureDouble setOutput:@[
+    [@"{\"event\":\"output\"," dataUsingEncoding:NSUTF8StringEncoding],
+    [@"\"identifier\":\"Chatty\"}\n" dataUsingEncoding:NSUTF8StringEncoding],
+  ] forIdentifier:@"Chatty"];
+  FBiOSTargetFutureDouble *chatty = [[FBiOSTargetFutureDouble alloc] initWithIdentifier:@"Chatty" succeed:YES];
+  [self sendAction:chatty toConsumer:consumer];
+
+  [self waitForPredicates:@[
+    [self predicateForFinished:chatty],
+    [self predicateForResponseCount:3],
+  ]];
+  [FBiOSTargetFutureDouble setOutput:nil forIdentifier:@"Chatty"];
+
+  NSArray<NSDictionary<NSString *, id> *> *responses = self.responseObjects;
+  XCTAssertEqualObjects([responses valueForKey:@"event"], (@[@"started", @"output", @"finished"]));
+  for (NSDictionary<NSString *, id> *response in responses) {
+    XCTAssertEqualObjects(response[@"request_id"], @"Chatty-request");
+  }
+
+  NSError *error = nil;
+  XCTAssertNotNil([[reader stopListening] await:&error]);
+  XCTAssertNil(error);
+}
+
+- (void)testPipelinedActionsHonourTheMaximumConcurrency
+{
+  id<FBDataConsumer> consumer = nil;
+  FBiOSActionReader *reader = [self pipelinedReaderWithConsumerOut:&consumer];
+  FBMutableFuture<NSNull *> *firstGate = FBMutableFuture.future;
+  FBMutableFuture<NSNull *> *secondGate = FBMutableFuture.future;
+  [FBiOSTargetFutureDouble setGate:firstGate forIdentifier:@"First"];
+  [FBiOSTargetFutureDouble setGate:secondGate forIdentifier:@"Second"];
+  FBiOSTargetFutureDouble *first = [[FBiOSTargetFutureDouble alloc] initWithIdentifier:@"First" succeed:YES];
+  FBiOSTargetFutureDouble *second = [[FBiOSTargetFutureDouble alloc] initWithIdentifier:@"Second" succeed:YES];
+  FBiOSTargetFutureDouble *third = [[FBiOSTargetFutureDouble alloc] initWithIdentifier:@"Third" succeed:YES];
+  for (FBiOSTargetFutureDouble *action in @[first, second, third]) {
+    [self sendAction:action toConsumer:consumer];
+  }
+
+  // Two actions are running, so the third must wait for one of them to finish.
+  [self waitForPredicates:@[
+    [self predicateForStarted:first],
+    [self predicateForStarted:second],
+  ]];
+  [self waitForActionsToBeScheduled];
+  XCTAssertFalse([self.startedActions containsObject:third]);
+
+  [firstGate resolveWithResult:NSNull.null];
+  [self waitForPredicates:@[
+    [self predicateForFinished:first],
+    [self predicateForFinished:third],
+  ]];
+  [secondGate resolveWithResult:NSNull.null];
+  [self waitForPredicates:@[
+    [self predicateForFinished:second],
+  ]];
+  XCTAssertEqual(self.maximumConcurrentEvents, 2u);
+  [FBiOSTargetFutureDouble setGate:nil forIdentifier:@"First"];
+  [FBiOSTargetFutureDouble setGate:nil forIdentifier:@"Second"];
+
+  NSError *error = nil;
+  XCTAssertNotNil([[reader stopListening] await:&error]);
+  XCTAssertNil(error);
+}
+
+- (void)testPipelinedConflictingActionsAreSerialized
+{
+  id<FBDataConsumer> consumer = nil;
+  FBiOSActionReader *reader = [self pipelinedReaderWithConsumerOut:&consumer];
+  FBMutableFuture<NSNull *> *gate = FBMutableFuture.future;
+  [FBiOSTargetFutureDouble setGate:gate forIdentifier:@"Earlier"];
+  FBiOSTargetFutureDouble *earlier = [[FBiOSTargetFutureDouble alloc] initWithIdentifier:@"Earlier" succeed:YES conflictGroup:@"Group"];
+  FBiOSTargetFutureDouble *later = [[FBiOSTargetFutureDouble alloc] initWithIdentifier:@"Later" succeed:YES conflictGroup:@"Group"];
+  FBiOSTargetFutureDouble *unrelated = [[FBiOSTargetFutureDouble alloc] initWithIdentifier:@"Unrelated" succeed:YES];
+  for (FBiOSTargetFutureDouble *action in @[earlier, later, unrelated]) {
+    [self sendAction:action toConsumer:consumer];
+  }
+
+  // The unrelated action overtakes the conflicting one, which waits for the action it conflicts with.
+  [self waitForPredicates:@[
+    [self predicateForStarted:earlier],
+    [self predicateForFinished:unrelated],
+  ]];
+  [self waitForActionsToBeScheduled];
+  XCTAssertFalse([self.startedActions containsObject:later]);
+
+  [gate resolveWithResult:NSNull.null];
+  [self waitForPredicates:@[
+    [self predicateForFinished:earlier],
+    [self predicateForFinished:later],
+  ]];
+  [FBiOSTargetFutureDouble setGate:nil forIdentifier:@"Earlier"];
+  NSUInteger earlierFinished = [self.events indexOfObject:@"finished:Earlier"];
+  NSUInteger laterStarted = [self.events indexOfObject:@"started:Later"];
+  XCTAssertLessThan(earlierFinished, laterStarted);
+
+  NSError *error = nil;
+  XCTAssertNotNil([[reader stopListening] await:&error]);
+  XCTAssertNil(error);
+}
+
+#pragma mark Binary Framing
+
+- (FBiOSActionReader *)framedReaderWithConsumerOut:(id<FBDataConsumer> *)consumerOut
+{
+  // Responses are written to a separate pipe, as framed responses would otherwise be read back as input.
+  NSPipe *input = NSPipe.pipe;
+  NSPipe *output = NSPipe.pipe;
+  FBiOSActionReader *reader = [FBiOSActionReader fileReaderForRouter:self.router delegate:self readHandle:input.fileHandleForReading writeHandle:output.fileHandleForWriting];
+  NSError *error = nil;
+  XCTAssertNotNil([[reader startListening] await:&error]);
+  XCTAssertNil(error);
+
+  id<FBDataConsumer> consumer = [FBFileWriter syncWriterWithFileHandle:input.fileHandleForWriting];
+  [consumer consumeData:[FBiOSActionFrameNegotiationLine dataUsingEncoding:NSUTF8StringEncoding]];
+  NSData *acknowledgement = [output.fileHandleForReading readDataOfLength:FBiOSActionFrameNegotiationLine.length];
+  XCTAssertEqualObjects([[NSString alloc] initWithData:acknowledgement encoding:NSUTF8StringEncoding], FBiOSActionFrameNegotiationLine);
+
+  *consumerOut = consumer;
+  return reader;
+}
+
+- (NSData *)frameWithType:(FBiOSActionFrameType)type streamIdentifier:(uint32_t)streamIdentifier data:(NSData *)data
+{
+  return [FBDataConsumerAdaptor adaptDispatchData:[FBiOSActionFrame frameWithType:type streamIdentifier:streamIdentifier payload:[FBiOSActionFrame dispatchDataWithData:data]]];
+}
+
+- (NSData *)actionFrame:(id<FBiOSTargetFuture>)action streamIdentifier:(uint32_t)streamIdentifier
+{
+  NSData *json = [NSJSONSerialization dataWithJSONObject:[self.router jsonFromAction:action] options:0 error:nil];
+  return [self frameWithType:FBiOSActionFrameTypeAction streamIdentifier:streamIdentifier data:json];
+}
+
+- (void)testCanUploadBinaryAndRunActionWithFraming
+{
+  id<FBDataConsumer> consumer = nil;
+  FBiOSActionReader *reader = [self framedReaderWithConsumerOut:&consumer];
+
+  NSData *transmit = [@"foo bar baz" dataUsingEncoding:NSUTF8StringEncoding];
+  FBiOSTargetFutureDouble *inputAction = [[FBiOSTargetFutureDouble alloc] initWithIdentifier:@"Foo" succeed:YES];
+  [consumer consumeData:[self actionFrame:[FBUploadHeader headerWithPathExtension:@"txt" size:transmit.length] streamIdentifier:1]];
+  [consumer consumeData:[self frameWithType:FBiOSActionFrameTypeData streamIdentifier:1 data:[transmit subdataWithRange:NSMakeRange(0, 4)]]];
+  [consumer consumeData:[self actionFrame:inputAction streamIdentifier:2]];
+  [consumer consumeData:[self frameWithType:FBiOSActionFrameTypeData streamIdentifier:1 data:[transmit subdataWithRange:NSMakeRange(4, transmit.length - 4)]]];
+
+  [self waitForPredicates:@[
+    [self predicateForStarted:inputAction],
+    [self predicateForFinished:inputAction],
+    [self predicateForUploadCount:1],
+  ]];
+
+  NSData *fileData = [NSData dataWithContentsOfFile:self.uploads.firstObject.path];
+  XCTAssertEqualObjects(transmit, fileData);
+
+  NSError *error = nil;
+  XCTAssertNotNil([[reader stopListening] await:&error]);
+  XCTAssertNil(error);
+}
+
+- (void)testDataFrameWithoutUploadIsBadInput
+{
+  id<FBDataConsumer> consumer = nil;
+  FBiOSActionReader *reader = [self framedReaderWithConsumerOut:&consumer];
+
+  [consumer consumeData:[self frameWithType:FBiOSActionFrameTypeData streamIdentifier:1 data:[@"foo" dataUsingEncoding:NSUTF8StringEncoding]]];
+
+  [self waitForPredicates:@[
+    [self predicateForBadInputCount:1],
+  ]];
+
+  NSError *error = nil;
+  XCTAssertNotNil([[reader stopListening] await:&error]);
+  XCTAssertNil(error);
+}
+
+- (void)testIncompleteFramedUploadIsRemovedAtEndOfFile
+{
+  NSString *directory = [NSTemporaryDirectory() stringByAppendingPathComponent:NSUUID.UUID.UUIDString];
+  XCTAssertTrue([NSFileManager.defaultManager createDirectoryAtPath:directory withIntermediateDirectories:YES attributes:nil error:nil]);
+  self.target.auxillaryDirectory = directory;
+  id<FBDataConsumer> consumer = nil;
+  FBiOSActionReader *reader = [self framedReaderWithConsumerOut:&consumer];
+
+  [consumer consumeData:[self actionFrame:[FBUploadHeader headerWithPathExtension:@"txt" size:16] streamIdentifier:1]];
+  [consumer consumeData:[self frameWithType:FBiOSActionFrameTypeData streamIdentifier:1 data:[@"foo" dataUsingEncoding:NSUTF8StringEncoding]]];
+  [self waitForPredicates:@[
+    [self predicateForFileCount:1 inDirectory:directory],
+  ]];
+
+  // The upload can never complete once the input has ended, so its file is removed.
+  [consumer consumeEndOfFile];
+  [self waitForPredicates:@[
+    [self predicateForFileCount:0 inDirectory:directory],
+  ]];
+  XCTAssertEqual(self.uploads.count, 0u);
+
+  NSError *error = nil;
+  XCTAssertNotNil([[reader stopListening] await:&error]);
+  XCTAssertNil(error);
+  [NSFileManager.defaultManager removeItemAtPath:directory error:nil];
+}
+
+#pragma mark Performance
+
+static size_t const UploadBenchmarkSize = 16 * 1024 * 1024;
+static size_t const UploadBenchmarkChunkSize = 256 * 1024;
+
+static double ProcessCPUSeconds(void)
+{
+  struct rusage usage;
+  getrusage(RUSAGE_SELF, &usage);
+  return (double) (usage.ru_utime.tv_sec + usage.ru_stime.tv_sec) + (double) (usage.ru_utime.tv_usec + usage.ru_stime.tv_usec) / 1e6;
+}
+
+- (void)measureUploadThroughput:(NSString *)framing transmit:(void (^)(id<FBDataConsumer> consumer, NSData *chunk))transmit consumer:(id<FBDataConsumer> (^)(void))consumerBlock
+{
+  NSData *chunk = [[@"" stringByPaddingToLength:UploadBenchmarkChunkSize withString:@"0123456789abcdef" startingAtIndex:0] dataUsingEncoding:NSUTF8StringEncoding];
+  __block NSUInteger expectedUploads = 0;
+  __block double cpuSeconds = 0;
+
+  // Wall time is measured by XCTest, CPU time is measured for the whole process, as the reader does its work on other queues.
+  [self measureBlock:^{
+    id<FBDataConsumer> consumer = consumerBlock();
+    expectedUploads += 1;
+    double start = ProcessCPUSeconds();
+    transmit(consumer, chunk);
+    [self waitForPredicates:@[
+      [self predicateForUploadCount:expectedUploads],
+    ]];
+    cpuSeconds += ProcessCPUSeconds() - start;
+  }];
+
+  // The CPU cost per MB is attached to the result, so that the framings can be compared.
+  double megabytes = (double) (UploadBenchmarkSize * expectedUploads) / (1024 * 1024);
+  XCTAttachment *attachment = [XCTAttachment attachmentWithString:[NSString stringWithFormat:@"%@ upload: %.3f ms CPU per MB over %.0f MB", framing, (cpuSeconds * 1000) / megabytes, megabytes]];
+  attachment.name = [NSString stringWithFormat:@"%@ CPU per MB", framing];
+  attachment.lifetime = XCTAttachmentLifetimeKeepAlways;
+  [XCTContext runActivityNamed:attachment.name block:^(id<XCTActivity> activity) {
+    [activity addAttachment:attachment];
+  }];
+}
+
+- (void)testLineDelimitedUploadThroughput
+{
+  [self measureUploadThroughput:@"Line-delimited" transmit:^(id<FBDataConsumer> consumer, NSData *chunk) {
+    [consumer consumeData:[self actionLine:[FBUploadHeader headerWithPathExtension:@"bin" size:UploadBenchmarkSize]]];
+    for (size_t sent = 0; sent < UploadBenchmarkSize; sent += chunk.length) {
+      [consumer consumeData:chunk];
+    }
+  } consumer:^{
+    return self.consumer;
+  }];
+}
+
+- (void)testFramedUploadThroughput
+{
+  id<FBDataConsumer> framedConsumer = nil;
+  FBiOSActionReader *reader = [self framedReaderWithConsumerOut:&framedConsumer];
+
+  [self measureUploadThroughput:@"Framed" transmit:^(id<FBDataConsumer> consumer, NSData *chunk) {
+    [consumer consumeData:[self actionFrame:[FBUploadHeader headerWithPathExtension:@"bin" size:UploadBenchmarkSize] streamIdentifier:1]];
+    for (size_t sent = 0; sent < UploadBenchmarkSize; sent += chunk.length) {
+      [consumer consumeData:[self frameWithType:FBiOSActionFrameTypeData streamIdentifier:1 data:chunk]];
+    }
+  } consumer:^{
+    return framedConsumer;
+  }];
+
+  NSError *error = nil;
+  XCTAssertNotNil([[reader stopListening] await:&error]);
+  XCTAssertNil(error);
+}
+
 #pragma mark Delegate
 
 - (void)readerDidFinishReading:(FBiOSActionReader *)reader
@@ -214,19 +661,30 @@ NS_ASSUME_NONNULL_BEGIN
 - (nullable NSString *)reader:(FBiOSActionReader *)reader willStartPerformingAction:(id<FBiOSTargetFuture>)action onTarget:(id<FBiOSTarget>)target
 {
   [self.startedActions addObject:action];
-  return nil;
+  return [self recordEvent:@"started" forAction:action];
 }
 
 - (nullable NSString *)reader:(FBiOSActionReader *)reader didProcessAction:(id<FBiOSTargetFuture>)action onTarget:(id<FBiOSTarget>)target
 {
   [self.finishedActions addObject:action];
-  return nil;
+  return [self recordEvent:@"finished" forAction:action];
 }
 
 - (nullable NSString *)reader:(FBiOSActionReader *)reader didFailToProcessAction:(id<FBiOSTargetFuture>)action onTarget:(id<FBiOSTarget>)target error:(NSError *)error
 {
   [self.failedActions addObject:action];
-  return nil;
+  return [self recordEvent:@"failed" forAction:action];
+}
+
+- (nullable NSString *)recordEvent:(NSString *)event forAction:(id<FBiOSTargetFuture>)action
+{
+  NSString *identifier = [action isKindOfClass:FBiOSTargetFutureDouble.class] ? ((FBiOSTargetFutureDouble *) action).identifier : action.description;
+  [self.events addObject:[NSString stringWithFormat:@"%@:%@", event, identifier]];
+  if (!self.reportsResponses) {
+    return nil;
+  }
+  NSData *json = [NSJSONSerialization dataWithJSONObject:@{@"event": event, @"identifier": identifier} options:0 error:nil];
+  return [[[NSString alloc] initWithData:json encoding:NSUTF8StringEncoding] stringByAppendingString:@"\n"];
 }
 
 - (void)report:(id<FBEventReporterSubject>)subject
@@ -24,6 +24,7 @@
     [FBBitmapStreamConfiguration configurationWithEncoding:FBBitmapStreamEncodingBGRA framesPerSecond:@60],
     [FBBitmapStreamConfiguration configurationWithEncoding:FBBitmapStreamEncodingBGRA framesPerSecond:nil],
     [FBBitmapStreamConfiguration configurationWithEncoding:FBBitmapStreamEncodingH264 framesPerSecond:nil],
+    [FBBitmapStreamConfiguration configurationWithEncoding:FBBitmapStreamEncodingBGRADelta framesPerSecond:@30],
   ];
 
   [self assertEqualityOfCopy:configurations];
@@ -0,0 +1,159 @@
+/**
+ * Copyright (c) 2015-present, Facebook, Inc.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree. An additional grant
+ * of patent rights can be found in the PATENTS file in the same directory.
+ */
+
+#import <XCTest/XCTest.h>
+
+#import <FBControlCore/FBControlCore.h>
+
+@interface FBConcurrentCollectionOperationsTests : XCTestCase
+
+@end
+
+@implementation FBConcurrentCollectionOperationsTests
+
+- (NSArray<NSNumber *> *)numbersUpTo:(NSUInteger)count
+{
+  NSMutableArray<NSNumber *> *numbers = [NSMutableArray arrayWithCapacity:count];
+  for (NSUInteger index = 0; index < count; index++) {
+    [numbers addObject:@(index)];
+  }
+  return [numbers copy];
+}
+
+- (NSPredicate *)evenPredicate
+{
+  return [NSPredicate predicateWithBlock:^ BOOL (NSNumber *number, NSDictionary *_) {
+    return [number isKindOfClass:NSNumber.class] && number.unsignedIntegerValue % 2 == 0;
+  }];
+}
+
+- (void)testGeneratePreservesOrderAndReplacesNil
+{
+  NSArray *generated = [FBConcurrentCollectionOperations generate:10000 withBlock:^ id (NSUInteger index) {
+    return index % 3 == 0 ? nil : @(index);
+  }];
+  XCTAssertEqual(generated.count, 10000u);
+  for (NSUInteger index = 0; index < generated.count; index++) {
+    id expected = index % 3 == 0 ? NSNull.null : @(index);
+    XCTAssertEqualObjects(generated[index], expected);
+  }
+  XCTAssertEqualObjects([FBConcurrentCollectionOperations generate:0 withBlock:^ id (NSUInteger index) {
+    return @(index);
+  }], @[]);
+}
+
+- (void)testMapFilterPreservesOrder
+{
+  NSArray<NSNumber *> *numbers = [self numbersUpTo:10001];
+  NSArray<NSNumber *> *actual = [FBConcurrentCollectionOperations
+    mapFilter:numbers
+    map:^ NSNumber * (NSNumber *number) {
+      return @(number.unsignedIntegerValue + 1);
+    }
+    predicate:self.evenPredicate];
+  // The odd numbers are mapped to even numbers, which pass the predicate.
+  XCTAssertEqual(actual.count, 5000u);
+  for (NSUInteger index = 0; index < actual.count; index++) {
+    XCTAssertEqual(actual[index].unsignedIntegerValue, (index + 1) * 2);
+  }
+}
+
+- (void)testFilterMapPreservesOrder
+{
+  NSArray<NSNumber *> *numbers = [self numbersUpTo:10001];
+  NSArray<NSString *> *actual = [FBConcurrentCollectionOperations
+    filterMap:numbers
+    predicate:self.evenPredicate
+    map:^ NSString * (NSNumber *number) {
+      return number.stringValue;
+    }];
+  XCTAssertEqual(actual.count, 5001u);
+  for (NSUInteger index = 0; index < actual.count; index++) {
+    XCTAssertEqualObjects(actual[index], [@(index * 2) stringValue]);
+  }
+  XCTAssertEqualObjects([FBConcurrentCollectionOperations filter:numbers predicate:self.evenPredicate].lastObject, @10000);
+}
+
+- (void)testMapReduceIsOrdered
+{
+  NSArray<NSNumber *> *numbers = [self numbersUpTo:5000];
+  NSMutableArray<NSNumber *> *reduced = [FBConcurrentCollectionOperations
+    mapReduce:numbers
+    map:^ id (NSNumber *number) {
+      return number.unsignedIntegerValue % 2 == 0 ? nil : number;
+    }
+    initial:[NSMutableArray array]
+    reduce:^ NSMutableArray * (NSMutableArray *accumulator, NSNumber *number) {
+      [accumulator addObject:number];
+      return accumulator;
+    }];
+  XCTAssertEqual(reduced.count, 2500u);
+  for (NSUInteger index = 0; index < reduced.count; index++) {
+    XCTAssertEqual(reduced[index].unsignedIntegerValue, index * 2 + 1);
+  }
+}
+
+- (void)testCheapBlockPerformance
+{
+  NSArray<NSNumber *> *numbers = [self numbersUpTo:1000000];
+  [self measureBlock:^{
+    [FBConcurrentCollectionOperations map:numbers withBlock:^ id (NSNumber *number) {
+      return number;
+    }];
+  }];
+}
+
+- (void)testBatchLogSearchPerformance
+{
+  NSMutableArray<FBDiagnostic *> *diagnostics = [NSMutableArray array];
+  for (NSUInteger index = 0; index < 2000; index++) {
+    NSMutableString *content = [NSMutableString string];
+    for (NSUInteger line = 0; line < 100; line++) {
+      [content appendFormat:@"Mar  7 16:50:18 some-hostname process%lu[%lu]: line %lu of a diagnostic\n", (unsigned long)index, (unsigned long)line, (unsigned long)line];
+    }
+    if (index % 10 == 0) {
+      [content appendString:@"Mar  7 16:50:18 some-hostname SpringBoard[24911]: Installed apps did change.\n"];
+    }
+    [diagnostics addObject:[[[[FBDiagnosticBuilder builder]
+      updateShortName:[NSString stringWithFormat:@"diagnostic_%lu", (unsigned long)index]]
+      updateString:content]
+      build]];
+  }
+  NSMutableDictionary<FBDiagnosticName, NSArray<FBLogSearchPredicate *> *> *mapping = [NSMutableDictionary dictionary];
+  for (FBDiagnostic *diagnostic in diagnostics) {
+    mapping[diagnostic.shortName] = @[[FBLogSearchPredicate substrings:@[@"Installed apps did change"]]];
+  }
+  FBBatchLogSearch *search = [FBBatchLogSearch searchWithMapping:mapping options:FBBatchLogSearchOptionsFullLines since:nil error:nil];
+
+  XCTAssertEqual([[search searchDiagnostics:diagnostics] mapping].count, 200u);
+  [self measureBlock:^{
+    [search searchDiagnostics:diagnostics];
+  }];
+}
+
+- (void)testProcessFetcherConsumerPerformance
+{
+  NSArray<FBProcessInfo *> *processes = FBProcessFetcher.new.processTable.processes;
+  XCTAssertGreaterThan(processes.count, 0u);
+  NSPredicate *predicate = [NSPredicate predicateWithBlock:^ BOOL (FBProcessInfo *process, NSDictionary *_) {
+    return process.environment.count > 0;
+  }];
+  [self measureBlock:^{
+    for (NSUInteger iteration = 0; iteration < 100; iteration++) {
+      [FBConcurrentCollectionOperations
+        filterMap:processes
+        predicate:predicate
+        map:^ NSString * (FBProcessInfo *process) {
+          return [NSString stringWithFormat:@"%d %@ %@", process.processIdentifier, process.launchPath.lastPathComponent, [process.arguments componentsJoinedByString:@" "]];
+        }];
+    }
+  }];
+}
+
+@end
@@ -33,4 +33,94 @@
   XCTAssertNil(error);
 }
 
+- (void)testAwaitWakesWhenResolvedFromAnotherQueue
+{
+  FBMutableFuture<NSNumber *> *future = FBMutableFuture.future;
+  dispatch_after(dispatch_time(DISPATCH_TIME_NOW, (int64_t)(0.01 * NSEC_PER_SEC)), dispatch_get_global_queue(QOS_CLASS_DEFAULT, 0), ^{
+    [future resolveWithResult:@YES];
+  });
+
+  NSDate *start = NSDate.date;
+  NSError *error = nil;
+  XCTAssertEqualObjects([future awaitWithTimeout:5 error:&error], @YES);
+  XCTAssertNil(error);
+  // Polling would not notice the resolution for up to 100ms.
+  XCTAssertLessThan([NSDate.date timeIntervalSinceDate:start], 0.09);
+}
+
+- (void)testAwaitTimesOutWhenNotResolved
+{
+  NSError *error = nil;
+  XCTAssertNil([FBMutableFuture.future awaitWithTimeout:0.05 error:&error]);
+  XCTAssertNotNil(error);
+}
+
+- (void)testSpinningUntilGroupNotifies
+{
+  dispatch_group_t group = dispatch_group_create();
+  dispatch_group_async(group, dispatch_get_global_queue(QOS_CLASS_DEFAULT, 0), ^{});
+  XCTAssertTrue([NSRunLoop.currentRunLoop spinRunLoopWithTimeout:5 notifiedBy:group onQueue:dispatch_get_global_queue(QOS_CLASS_DEFAULT, 0)]);
+}
+
+- (void)testAwaitLatencyPerformance
+{
+  dispatch_queue_t queue = dispatch_queue_create("com.facebook.fbcontrolcore.tests.await", DISPATCH_QUEUE_SERIAL);
+  [self measureBlock:^{
+    for (NSUInteger index = 0; index < 100; index++) {
+      FBFuture<NSNumber *> *future = [FBFuture onQueue:queue resolveValue:^(NSError **_) {
+        return @(index);
+      }];
+      XCTAssertEqualObjects([future await:nil], @(index));
+    }
+  }];
+}
+
+- (void)assertSpinLatency:(BOOL (^)(NSRunLoop *runLoop, BOOL (^condition)(void)))spin
+{
+  dispatch_queue_t queue = dispatch_queue_create("com.facebook.fbcontrolcore.tests.spin", DISPATCH_QUEUE_SERIAL);
+  [self measureBlock:^{
+    for (NSUInteger index = 0; index < 10; index++) {
+      __block volatile BOOL done = NO;
+      dispatch_after(dispatch_time(DISPATCH_TIME_NOW, (int64_t)(0.001 * NSEC_PER_SEC)), queue, ^{
+        done = YES;
+      });
+      XCTAssertTrue(spin(NSRunLoop.currentRunLoop, ^ BOOL {
+        return done;
+      }));
+    }
+  }];
+}
+
+- (void)testFixedIntervalSpinLatencyPerformance
+{
+  // The previous implementation of -spinRunLoopWithTimeout:untilTrue:, as a baseline for the benchmark below.
+  [self assertSpinLatency:^ BOOL (NSRunLoop *runLoop, BOOL (^condition)(void)) {
+    while (!condition()) {
+      [runLoop runUntilDate:[NSDate dateWithTimeIntervalSinceNow:0.1]];
+    }
+    return YES;
+  }];
+}
+
+- (void)testSpinUntilTrueLatencyPerformance
+{
+  [self assertSpinLatency:^ BOOL (NSRunLoop *runLoop, BOOL (^condition)(void)) {
+    return [runLoop spinRunLoopWithTimeout:FBControlCoreGlobalConfiguration.fastTimeout untilTrue:condition];
+  }];
+}
+
+- (void)testResolveWhenLatencyPerformance
+{
+  dispatch_queue_t queue = dispatch_queue_create("com.facebook.fbcontrolcore.tests.resolve_when", DISPATCH_QUEUE_SERIAL);
+  [self measureBlock:^{
+    for (NSUInteger index = 0; index < 20; index++) {
+      __block NSUInteger checks = 0;
+      FBFuture<NSNumber *> *future = [FBFuture onQueue:queue resolveWhen:^ BOOL {
+        return ++checks > 2;
+      }];
+      XCTAssertEqualObjects([future await:nil], @YES);
+    }
+  }];
+}
+
 @end
@@ -97,4 +97,141 @@
   XCTAssertEqual(crashes.count, 1u);
 }
 
+- (void)testParsableCrashLog
+{
+  NSData *data = [NSData dataWithContentsOfFile:FBControlCoreFixtures.appCrashPathWithCustomDeviceSet];
+  XCTAssertTrue([FBCrashLogInfo isParsableCrashLog:data]);
+  XCTAssertFalse([FBCrashLogInfo isParsableCrashLog:[@"Process: foo\nIdentifier: foo\n" dataUsingEncoding:NSUTF8StringEncoding]]);
+  XCTAssertFalse([FBCrashLogInfo isParsableCrashLog:NSData.data]);
+}
+
+- (void)testProcessNamesWithSpaces
+{
+  NSString *header = @"Process:               Google Chrome Helper [1234]\nPath:                  /Applications/Google Chrome.app/Contents/MacOS/Google Chrome Helper\nIdentifier:            com.google.Chrome.helper\nParent Process:        Google Chrome [1000]\n\nDate/Time:             2016-03-15 08:38:22.657 -0700\n";
+  NSString *path = [NSTemporaryDirectory() stringByAppendingPathComponent:[NSString stringWithFormat:@"%@.crash", NSUUID.UUID.UUIDString]];
+  XCTAssertTrue([header writeToFile:path atomically:YES encoding:NSUTF8StringEncoding error:nil]);
+  FBCrashLogInfo *info = [FBCrashLogInfo fromCrashLogAtPath:path];
+  [NSFileManager.defaultManager removeItemAtPath:path error:nil];
+
+  XCTAssertEqualObjects(info.processName, @"Google Chrome Helper");
+  XCTAssertEqual(info.processIdentifier, 1234);
+  XCTAssertEqualObjects(info.parentProcessName, @"Google Chrome");
+  XCTAssertEqual(info.parentProcessIdentifier, 1000);
+  XCTAssertEqualObjects(info.executablePath, @"/Applications/Google Chrome.app/Contents/MacOS/Google Chrome Helper");
+  XCTAssertEqualWithAccuracy(info.date.timeIntervalSinceReferenceDate, 479723902 + 7 * 3600, 1);
+}
+
+- (void)testJSONRoundTrip
+{
+  for (FBCrashLogInfo *info in FBCrashLogInfoTests.allCrashLogs) {
+    NSError *error = nil;
+    FBCrashLogInfo *inflated = [FBCrashLogInfo inflateFromJSON:info.jsonSerializableRepresentation error:&error];
+    XCTAssertNil(error);
+    XCTAssertEqualObjects(inflated.description, info.description);
+    XCTAssertEqual(inflated.processType, info.processType);
+  }
+}
+
+- (void)testIndexOnlyParsesChangedFiles
+{
+  NSString *directory = [NSTemporaryDirectory() stringByAppendingPathComponent:NSUUID.UUID.UUIDString];
+  NSString *indexPath = [directory stringByAppendingPathComponent:@"index.json"];
+  NSString *crashes = [directory stringByAppendingPathComponent:@"crashes"];
+  XCTAssertTrue([NSFileManager.defaultManager createDirectoryAtPath:crashes withIntermediateDirectories:YES attributes:nil error:nil]);
+  NSString *crashPath = [crashes stringByAppendingPathComponent:@"app.crash"];
+  XCTAssertTrue([NSFileManager.defaultManager copyItemAtPath:FBControlCoreFixtures.appCrashPathWithCustomDeviceSet toPath:crashPath error:nil]);
+  XCTAssertTrue([@"not a crash log" writeToFile:[crashes stringByAppendingPathComponent:@"other.crash"] atomically:YES encoding:NSUTF8StringEncoding error:nil]);
+
+  FBCrashLogIndex *index = [FBCrashLogIndex indexWithPath:indexPath];
+  NSArray<FBCrashLogInfo *> *crashLogs = [index crashLogsInDirectory:crashes extension:@"crash" modifiedAfter:nil];
+  XCTAssertEqualObjects([crashLogs valueForKey:@"name"], @[@"app.crash"]);
+  NSError *error = nil;
+  XCTAssertTrue([index persist:&error]);
+  XCTAssertNil(error);
+
+  // Overwrite the crash log with the same size and modification date, a new index should use the persisted entry rather than parsing again.
+  NSDictionary<NSFileAttributeKey, id> *attributes = [NSFileManager.defaultManager attributesOfItemAtPath:crashPath error:nil];
+  NSMutableData *garbage = [NSMutableData dataWithLength:attributes.fileSize];
+  XCTAssertTrue([garbage writeToFile:crashPath atomically:NO]);
+  XCTAssertTrue([NSFileManager.defaultManager setAttributes:@{NSFileModificationDate: attributes.fileModificationDate} ofItemAtPath:crashPath error:nil]);
+  crashLogs = [[FBCrashLogIndex indexWithPath:indexPath] crashLogsInDirectory:crashes extension:@"crash" modifiedAfter:nil];
+  XCTAssertEqualObjects([crashLogs valueForKey:@"processIdentifier"], @[@40119]);
+
+  // A changed file is parsed again, a removed one is dropped.
+  XCTAssertTrue([NSFileManager.defaultManager setAttributes:@{NSFileModificationDate: [attributes.fileModificationDate dateByAddingTimeInterval:10]} ofItemAtPath:crashPath error:nil]);
+  XCTAssertTrue([NSFileManager.defaultManager copyItemAtPath:FBControlCoreFixtures.assetsdCrashPathWithCustomDeviceSet toPath:[crashes stringByAppendingPathComponent:@"assetsd.crash"] error:nil]);
+  index = [FBCrashLogIndex indexWithPath:indexPath];
+  crashLogs = [index crashLogsInDirectory:crashes extension:@"crash" modifiedAfter:nil];
+  XCTAssertEqualObjects([crashLogs valueForKey:@"name"], @[@"assetsd.crash"]);
+  XCTAssertEqualObjects([[index crashLogsInDirectory:crashes extension:@"crash" modifiedAfter:NSDate.distantFuture] valueForKey:@"name"], @[]);
+
+  [NSFileManager.defaultManager removeItemAtPath:directory error:nil];
+}
+
+- (void)testIndexIsWrittenByQuery
+{
+  NSString *directory = [NSTemporaryDirectory() stringByAppendingPathComponent:NSUUID.UUID.UUIDString];
+  NSString *indexPath = [directory stringByAppendingPathComponent:@"index.json"];
+  NSString *crashes = [directory stringByAppendingPathComponent:@"crashes"];
+  XCTAssertTrue([NSFileManager.defaultManager createDirectoryAtPath:crashes withIntermediateDirectories:YES attributes:nil error:nil]);
+  NSString *crashPath = [crashes stringByAppendingPathComponent:@"app.crash"];
+  XCTAssertTrue([NSFileManager.defaultManager copyItemAtPath:FBControlCoreFixtures.appCrashPathWithCustomDeviceSet toPath:crashPath error:nil]);
+
+  XCTAssertEqual([[FBCrashLogIndex indexWithPath:indexPath] crashLogsInDirectory:crashes extension:@"crash" modifiedAfter:nil].count, 1u);
+
+  // A fresh index uses the persisted entry immediately, without the crash log being parsed again.
+  NSDictionary<NSFileAttributeKey, id> *attributes = [NSFileManager.defaultManager attributesOfItemAtPath:crashPath error:nil];
+  XCTAssertTrue([[NSMutableData dataWithLength:attributes.fileSize] writeToFile:crashPath atomically:NO]);
+  XCTAssertTrue([NSFileManager.defaultManager setAttributes:@{NSFileModificationDate: attributes.fileModificationDate} ofItemAtPath:crashPath error:nil]);
+  NSArray<FBCrashLogInfo *> *crashLogs = [[FBCrashLogIndex indexWithPath:indexPath] crashLogsInDirectory:crashes extension:@"crash" modifiedAfter:nil];
+  XCTAssertEqualObjects([crashLogs valueForKey:@"processIdentifier"], @[@40119]);
+
+  [NSFileManager.defaultManager removeItemAtPath:directory error:nil];
+}
+
+- (void)testIndexPrunesRemovedDirectories
+{
+  NSString *directory = [NSTemporaryDirectory() stringByAppendingPathComponent:NSUUID.UUID.UUIDString];
+  NSString *indexPath = [directory stringByAppendingPathComponent:@"index.json"];
+  NSString *retained = [directory stringByAppendingPathComponent:@"retained"];
+  NSString *removed = [directory stringByAppendingPathComponent:@"removed"];
+  for (NSString *crashes in @[retained, removed]) {
+    XCTAssertTrue([NSFileManager.defaultManager createDirectoryAtPath:crashes withIntermediateDirectories:YES attributes:nil error:nil]);
+    XCTAssertTrue([NSFileManager.defaultManager copyItemAtPath:FBControlCoreFixtures.appCrashPathWithCustomDeviceSet toPath:[crashes stringByAppendingPathComponent:@"app.crash"] error:nil]);
+  }
+
+  FBCrashLogIndex *index = [FBCrashLogIndex indexWithPath:indexPath];
+  XCTAssertEqual([index crashLogsInDirectory:retained extension:@"crash" modifiedAfter:nil].count, 1u);
+  XCTAssertEqual([index crashLogsInDirectory:removed extension:@"crash" modifiedAfter:nil].count, 1u);
+  NSError *error = nil;
+  XCTAssertTrue([index persist:&error]);
+
+  // A directory that has been removed is no longer written to the index.
+  XCTAssertTrue([NSFileManager.defaultManager removeItemAtPath:removed error:nil]);
+  index = [FBCrashLogIndex indexWithPath:indexPath];
+  XCTAssertEqual([index crashLogsInDirectory:retained extension:@"crash" modifiedAfter:nil].count, 1u);
+  XCTAssertTrue([index persist:&error]);
+  NSDictionary<NSString *, id> *json = [NSJSONSerialization JSONObjectWithData:[NSData dataWithContentsOfFile:indexPath] options:0 error:nil];
+  XCTAssertEqualObjects([json[@"directories"] allKeys], @[retained]);
+
+  [NSFileManager.defaultManager removeItemAtPath:directory error:nil];
+}
+
+- (void)testHeaderParsingPerformance
+{
+  NSArray<NSString *> *paths = @[
+    FBControlCoreFixtures.assetsdCrashPathWithCustomDeviceSet,
+    FBControlCoreFixtures.agentCrashPathWithCustomDeviceSet,
+    FBControlCoreFixtures.appCrashPathWithDefaultDeviceSet,
+    FBControlCoreFixtures.appCrashPathWithCustomDeviceSet,
+  ];
+  [self measureBlock:^{
+    for (NSUInteger iteration = 0; iteration < 1000; iteration++) {
+      for (NSString *path in paths) {
+        [FBCrashLogInfo fromCrashLogAtPath:path];
+      }
+    }
+  }];
+}
+
 @end
@@ -146,5 +146,270 @@
   [self waitForExpectations:@[doneExpectation] timeout:FBControlCoreGlobalConfiguration.fastTimeout];
 }
 
+- (void)assertFindsTerminalSplitAcrossWrites:(id<FBConsumableBuffer>)consumer
+{
+  NSData *terminal = [@"$$$" dataUsingEncoding:NSUTF8StringEncoding];
+  [consumer consumeData:[@"FOO$" dataUsingEncoding:NSUTF8StringEncoding]];
+  XCTAssertNil([consumer consumeUntil:terminal]);
+  [consumer consumeData:[@"$" dataUsingEncoding:NSUTF8StringEncoding]];
+  XCTAssertNil([consumer consumeUntil:terminal]);
+  [consumer consumeData:[@"$BAR" dataUsingEncoding:NSUTF8StringEncoding]];
+  XCTAssertEqualObjects([consumer consumeUntil:terminal], [@"FOO" dataUsingEncoding:NSUTF8StringEncoding]);
+  XCTAssertEqualObjects(consumer.consumeCurrentString, @"BAR");
+}
+
+- (void)testTerminalSplitAcrossWrites
+{
+  [self assertFindsTerminalSplitAcrossWrites:FBLineBuffer.consumableBuffer];
+  [self assertFindsTerminalSplitAcrossWrites:FBLineBuffer.cursorConsumableBuffer];
+}
+
+- (void)assertDrainsLargeBacklog:(id<FBConsumableBuffer>)consumer
+{
+  NSUInteger lineCount = 10000;
+  [consumer consumeData:[self.class backlogOfLineCount:lineCount]];
+  for (NSUInteger index = 0; index < lineCount / 2; index++) {
+    XCTAssertEqualObjects(consumer.consumeLineString, ([NSString stringWithFormat:@"Line %lu of the backlog", index]));
+  }
+  [consumer consumeData:[@"Trailing" dataUsingEncoding:NSUTF8StringEncoding]];
+  for (NSUInteger index = lineCount / 2; index < lineCount; index++) {
+    XCTAssertEqualObjects(consumer.consumeLineString, ([NSString stringWithFormat:@"Line %lu of the backlog", index]));
+  }
+  XCTAssertNil(consumer.consumeLineString);
+  XCTAssertEqualObjects(consumer.consumeCurrentString, @"Trailing");
+}
+
+- (void)testDrainsLargeBacklogAcrossCompaction
+{
+  [self assertDrainsLargeBacklog:FBLineBuffer.consumableBuffer];
+  [self assertDrainsLargeBacklog:FBLineBuffer.cursorConsumableBuffer];
+}
+
++ (dispatch_data_t)dispatchDataFromString:(NSString *)string
+{
+  NSData *data = [string dataUsingEncoding:NSUTF8StringEncoding];
+  return dispatch_data_create(data.bytes, data.length, NULL, DISPATCH_DATA_DESTRUCTOR_DEFAULT);
+}
+
+- (void)testDispatchDataLineConsumerAcrossRegions
+{
+  NSMutableArray<NSString *> *lines = [NSMutableArray array];
+  FBLineDispatchDataConsumer *consumer = [FBLineDispatchDataConsumer synchronousReaderWithConsumer:^(dispatch_data_t line) {
+    NSData *data = [FBDataConsumerAdaptor adaptDispatchData:line];
+    [lines addObject:[[NSString alloc] initWithData:data encoding:NSUTF8StringEncoding]];
+  }];
+
+  // A non-contiguous chunk, with a line spanning both regions.
+  dispatch_data_t chunk = dispatch_data_create_concat(
+    [self.class dispatchDataFromString:@"FOO\nB"],
+    [self.class dispatchDataFromString:@"AR\nBA"]
+  );
+  [consumer consumeData:chunk];
+  XCTAssertEqualObjects(lines, (@[@"FOO", @"BAR"]));
+  [consumer consumeData:[self.class dispatchDataFromString:@"Z"]];
+  [consumer consumeData:[self.class dispatchDataFromString:@"\n\nHELLO"]];
+  XCTAssertEqualObjects(lines, (@[@"FOO", @"BAR", @"BAZ", @""]));
+  XCTAssertFalse(consumer.eofHasBeenReceived.hasCompleted);
+  [consumer consumeEndOfFile];
+  XCTAssertTrue(consumer.eofHasBeenReceived.hasCompleted);
+}
+
+- (void)testDispatchDataCompositeAndAdaptorPassthrough
+{
+  NSMutableArray<NSString *> *lines = [NSMutableArray array];
+  FBLineDispatchDataConsumer *lineConsumer = [FBLineDispatchDataConsumer synchronousReaderWithConsumer:^(dispatch_data_t line) {
+    NSData *data = [FBDataConsumerAdaptor adaptDispatchData:line];
+    [lines addObject:[[NSString alloc] initWithData:data encoding:NSUTF8StringEncoding]];
+  }];
+  id<FBAccumulatingBuffer> buffer = FBLineBuffer.accumulatingBuffer;
+  FBCompositeDispatchDataConsumer *composite = [FBCompositeDispatchDataConsumer consumerWithConsumers:@[
+    lineConsumer,
+    [FBDataConsumerAdaptor dispatchDataConsumerForDataConsumer:buffer],
+  ]];
+
+  // Adapting to NSData and back again should result in the original consumer.
+  id<FBDataConsumer> adapted = [FBDataConsumerAdaptor dataConsumerForDispatchDataConsumer:composite];
+  XCTAssertEqual((id) [FBDataConsumerAdaptor dispatchDataConsumerForDataConsumer:adapted], (id) composite);
+
+  [composite consumeData:[self.class dispatchDataFromString:@"FOO\nBAR\n"]];
+  [composite consumeEndOfFile];
+  XCTAssertEqualObjects(lines, (@[@"FOO", @"BAR"]));
+  XCTAssertEqualObjects(buffer.data, [@"FOO\nBAR\n" dataUsingEncoding:NSUTF8StringEncoding]);
+  XCTAssertTrue(lineConsumer.eofHasBeenReceived.hasCompleted);
+  XCTAssertTrue(buffer.eofHasBeenReceived.hasCompleted);
+  XCTAssertTrue(composite.eofHasBeenReceived.hasCompleted);
+}
+
+- (void)assertBoundedPolicy:(FBDataConsumerOverflowPolicy)policy deliversOutput:(NSString *)output droppedBytes:(size_t)droppedBytes
+{
+  id<FBAccumulatingBuffer> buffer = FBLineBuffer.accumulatingBuffer;
+  dispatch_queue_t queue = dispatch_queue_create("com.facebook.fbcontrolcore.tests.bounded", DISPATCH_QUEUE_SERIAL);
+  FBBoundedDataConsumer *consumer = [FBBoundedDataConsumer consumerWithConsumer:buffer queue:queue highWaterMark:6 policy:policy];
+
+  // Nothing will be delivered whilst the queue is suspended, so the consumer will saturate.
+  dispatch_suspend(queue);
+  [consumer consumeData:[@"FOO" dataUsingEncoding:NSUTF8StringEncoding]];
+  [consumer consumeData:[@"BAR" dataUsingEncoding:NSUTF8StringEncoding]];
+  XCTAssertEqual(consumer.pendingBytes, 6u);
+  XCTAssertFalse(consumer.hasCapacity.hasCompleted);
+  [consumer consumeData:[@"BAZ" dataUsingEncoding:NSUTF8StringEncoding]];
+  XCTAssertEqual(consumer.droppedBytes, droppedBytes);
+  XCTAssertLessThanOrEqual(consumer.pendingBytes, 6u);
+  [consumer consumeEndOfFile];
+  dispatch_resume(queue);
+
+  NSError *error = nil;
+  XCTAssertNotNil([consumer.eofHasBeenReceived await:&error]);
+  XCTAssertNil(error);
+  XCTAssertTrue(buffer.eofHasBeenReceived.hasCompleted);
+  XCTAssertTrue(consumer.hasCapacity.hasCompleted);
+  XCTAssertEqualObjects(buffer.data, [output dataUsingEncoding:NSUTF8StringEncoding]);
+}
+
+- (void)testBoundedConsumerDropsNewest
+{
+  [self assertBoundedPolicy:FBDataConsumerOverflowPolicyDropNewest deliversOutput:@"FOOBAR" droppedBytes:3];
+}
+
+- (void)testBoundedConsumerDeliversOversizedChunkWhenNothingIsPending
+{
+  id<FBAccumulatingBuffer> buffer = FBLineBuffer.accumulatingBuffer;
+  dispatch_queue_t queue = dispatch_queue_create("com.facebook.fbcontrolcore.tests.bounded", DISPATCH_QUEUE_SERIAL);
+  FBBoundedDataConsumer *consumer = [FBBoundedDataConsumer consumerWithConsumer:buffer queue:queue highWaterMark:6 policy:FBDataConsumerOverflowPolicyDropNewest];
+
+  dispatch_suspend(queue);
+  [consumer consumeData:[@"FOOBARBAZ" dataUsingEncoding:NSUTF8StringEncoding]];
+  [consumer consumeData:[@"QUX" dataUsingEncoding:NSUTF8StringEncoding]];
+  XCTAssertEqual(consumer.droppedBytes, 3u);
+  [consumer consumeEndOfFile];
+  dispatch_resume(queue);
+
+  NSError *error = nil;
+  XCTAssertNotNil([consumer.eofHasBeenReceived await:&error]);
+  XCTAssertNil(error);
+  XCTAssertEqualObjects(buffer.data, [@"FOOBARBAZ" dataUsingEncoding:NSUTF8StringEncoding]);
+}
+
+- (void)testBoundedConsumerDropsOldest
+{
+  [self assertBoundedPolicy:FBDataConsumerOverflowPolicyDropOldest deliversOutput:@"BARBAZ" droppedBytes:3];
+}
+
+- (void)testBoundedConsumerDropsOldestWithinHighWaterMarkWhilstDelivering
+{
+  dispatch_semaphore_t delivering = dispatch_semaphore_create(0);
+  dispatch_semaphore_t delivered = dispatch_semaphore_create(0);
+  NSMutableArray<NSString *> *lines = [NSMutableArray array];
+  FBLineDataConsumer *lineConsumer = [FBLineDataConsumer synchronousReaderWithConsumer:^(NSString *line) {
+    [lines addObject:line];
+    if (lines.count == 1) {
+      dispatch_semaphore_signal(delivering);
+      dispatch_semaphore_wait(delivered, DISPATCH_TIME_FOREVER);
+    }
+  }];
+  dispatch_queue_t queue = dispatch_queue_create("com.facebook.fbcontrolcore.tests.bounded", DISPATCH_QUEUE_SERIAL);
+  FBBoundedDataConsumer *consumer = [FBBoundedDataConsumer consumerWithConsumer:lineConsumer queue:queue highWaterMark:8 policy:FBDataConsumerOverflowPolicyDropOldest];
+
+  // The first chunk is being delivered, so only the newest byte of the second chunk fits within the high water mark.
+  [consumer consumeData:[@"FOOBAR\n" dataUsingEncoding:NSUTF8StringEncoding]];
+  dispatch_semaphore_wait(delivering, DISPATCH_TIME_FOREVER);
+  [consumer consumeData:[@"BAZQUX\n" dataUsingEncoding:NSUTF8StringEncoding]];
+  XCTAssertLessThanOrEqual(consumer.pendingBytes, 8u);
+  XCTAssertEqual(consumer.droppedBytes, 6u);
+  dispatch_semaphore_signal(delivered);
+  [consumer consumeEndOfFile];
+
+  NSError *error = nil;
+  XCTAssertNotNil([consumer.eofHasBeenReceived await:&error]);
+  XCTAssertNil(error);
+  XCTAssertEqualObjects(lines, (@[@"FOOBAR", @""]));
+}
+
+- (void)testBoundedConsumerCoalesces
+{
+  [self assertBoundedPolicy:FBDataConsumerOverflowPolicyCoalesce deliversOutput:@"BARBAZ" droppedBytes:3];
+}
+
+- (void)testBoundedConsumerBlocksProducer
+{
+  id<FBAccumulatingBuffer> buffer = FBLineBuffer.accumulatingBuffer;
+  dispatch_queue_t queue = dispatch_queue_create("com.facebook.fbcontrolcore.tests.bounded", DISPATCH_QUEUE_SERIAL);
+  FBBoundedDataConsumer *consumer = [FBBoundedDataConsumer consumerWithConsumer:buffer queue:queue highWaterMark:4 policy:FBDataConsumerOverflowPolicyBlock];
+
+  for (NSUInteger index = 0; index < 100; index++) {
+    [consumer consumeData:[@"FOO\n" dataUsingEncoding:NSUTF8StringEncoding]];
+    XCTAssertLessThanOrEqual(consumer.pendingBytes, 4u);
+  }
+  [consumer consumeEndOfFile];
+
+  NSError *error = nil;
+  XCTAssertNotNil([consumer.eofHasBeenReceived await:&error]);
+  XCTAssertNil(error);
+  XCTAssertEqual(consumer.droppedBytes, 0u);
+  XCTAssertEqual(buffer.data.length, 400u);
+}
+
+#pragma mark Performance
+
++ (NSData *)backlogOfLineCount:(NSUInteger)lineCount
+{
+  NSMutableData *data = [NSMutableData data];
+  for (NSUInteger index = 0; index < lineCount; index++) {
+    [data appendData:[[NSString stringWithFormat:@"Line %lu of the backlog\n", index] dataUsingEncoding:NSUTF8StringEncoding]];
+  }
+  return data;
+}
+
++ (NSData *)backlogOfSize:(NSUInteger)size
+{
+  NSData *line = [@"Some moderately long line of output from a chatty process\n" dataUsingEncoding:NSUTF8StringEncoding];
+  NSMutableData *data = [NSMutableData dataWithCapacity:size];
+  while (data.length < size) {
+    [data appendData:line];
+  }
+  return data;
+}
+
+- (void)assertDrainsBacklogOfSize:(NSUInteger)size fromBuffer:(id<FBConsumableBuffer> (^)(void))bufferFactory
+{
+  NSData *backlog = [self.class backlogOfSize:size];
+  [self measureBlock:^{
+    id<FBConsumableBuffer> consumer = bufferFactory();
+    [consumer consumeData:backlog];
+    NSUInteger lines = 0;
+    while ([consumer consumeLineData]) {
+      lines++;
+    }
+    XCTAssertGreaterThan(lines, 0u);
+  }];
+}
+
+- (void)testLineThroughputFor1KBBacklog
+{
+  [self assertDrainsBacklogOfSize:1024 fromBuffer:^{
+    return FBLineBuffer.consumableBuffer;
+  }];
+}
+
+- (void)testCursorLineThroughputFor1KBBacklog
+{
+  [self assertDrainsBacklogOfSize:1024 fromBuffer:^{
+    return FBLineBuffer.cursorConsumableBuffer;
+  }];
+}
+
+- (void)testLineThroughputFor1MBBacklog
+{
+  [self assertDrainsBacklogOfSize:1024 * 1024 fromBuffer:^{
+    return FBLineBuffer.consumableBuffer;
+  }];
+}
+
+- (void)testCursorLineThroughputFor1MBBacklog
+{
+  [self assertDrainsBacklogOfSize:1024 * 1024 fromBuffer:^{
+    return FBLineBuffer.cursorConsumableBuffer;
+  }];
+}
 
 @end
@@ -0,0 +1,122 @@
+/**
+ * Copyright (c) 2015-present, Facebook, Inc.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree. An additional grant
+ * of patent rights can be found in the PATENTS file in the same directory.
+ */
+
+#import <XCTest/XCTest.h>
+
+#import <FBControlCore/FBControlCore.h>
+
+@interface FBDiagnosticTailTests : XCTestCase
+
+@property (nonatomic, copy, readwrite) NSString *logPath;
+@property (nonatomic, strong, readwrite) FBDiagnostic *diagnostic;
+@property (nonatomic, strong, readwrite) FBDiagnosticTail *tail;
+
+@end
+
+@implementation FBDiagnosticTailTests
+
+- (void)setUp
+{
+  [super setUp];
+
+  self.logPath = [[NSTemporaryDirectory() stringByAppendingPathComponent:NSUUID.UUID.UUIDString] stringByAppendingPathExtension:@"log"];
+  [self writeString:@"" append:NO];
+  self.diagnostic = [[[[FBDiagnosticBuilder builder]
+    updateShortName:@"tailed"]
+    updatePath:self.logPath]
+    build];
+  self.tail = [FBDiagnosticTail tail];
+}
+
+- (void)tearDown
+{
+  [NSFileManager.defaultManager removeItemAtPath:self.logPath error:nil];
+
+  [super tearDown];
+}
+
+- (void)writeString:(NSString *)string append:(BOOL)append
+{
+  NSOutputStream *stream = [NSOutputStream outputStreamToFileAtPath:self.logPath append:append];
+  [stream open];
+  NSData *data = [string dataUsingEncoding:NSUTF8StringEncoding];
+  [stream write:data.bytes maxLength:data.length];
+  [stream close];
+}
+
+- (NSString *)unreadString
+{
+  FBDiagnostic *unread = [self.tail unreadContentOfDiagnostic:self.diagnostic];
+  XCTAssertEqualObjects(unread.shortName, @"tailed");
+  return unread.asString;
+}
+
+- (void)testReadsOnlyAppendedLines
+{
+  [self writeString:@"FIRST\nSECOND\n" append:YES];
+  XCTAssertEqualObjects(self.unreadString, @"FIRST\nSECOND\n");
+
+  [self writeString:@"THIRD\nFOUR" append:YES];
+  XCTAssertEqualObjects(self.unreadString, @"THIRD\n");
+
+  [self writeString:@"TH\n" append:YES];
+  XCTAssertEqualObjects(self.unreadString, @"FOURTH\n");
+  XCTAssertEqualObjects(self.unreadString, @"");
+}
+
+- (void)testReadsTruncatedFileFromStart
+{
+  [self writeString:@"FIRST\nSECOND\n" append:YES];
+  XCTAssertEqualObjects(self.unreadString, @"FIRST\nSECOND\n");
+
+  [self writeString:@"NEW\n" append:NO];
+  XCTAssertEqualObjects(self.unreadString, @"NEW\n");
+}
+
+- (void)testReadsRotatedFileFromStart
+{
+  [self writeString:@"FIRST\n" append:YES];
+  XCTAssertEqualObjects(self.unreadString, @"FIRST\n");
+
+  NSString *rotatedPath = [self.logPath stringByAppendingPathExtension:@"0"];
+  XCTAssertTrue([NSFileManager.defaultManager moveItemAtPath:self.logPath toPath:rotatedPath error:nil]);
+  [self writeString:@"ROTATED FILE\n" append:NO];
+  XCTAssertEqualObjects(self.unreadString, @"ROTATED FILE\n");
+  [NSFileManager.defaultManager removeItemAtPath:rotatedPath error:nil];
+}
+
+- (void)testReadsFromStartAfterReset
+{
+  [self writeString:@"FIRST\n" append:YES];
+  XCTAssertEqualObjects(self.unreadString, @"FIRST\n");
+  [self.tail reset];
+  XCTAssertEqualObjects(self.unreadString, @"FIRST\n");
+}
+
+- (void)testInMemoryDiagnosticsAreUnchanged
+{
+  FBDiagnostic *diagnostic = [[[FBDiagnosticBuilder builder]
+    updateString:@"IN MEMORY\n"]
+    build];
+  XCTAssertEqualObjects([self.tail unreadContentOfDiagnostic:diagnostic].asString, @"IN MEMORY\n");
+  XCTAssertEqualObjects([self.tail unreadContentOfDiagnostic:diagnostic].asString, @"IN MEMORY\n");
+}
+
+- (void)testBatchSearchOfUnreadContent
+{
+  FBBatchLogSearch *search = [FBBatchLogSearch searchWithMapping:@{@"tailed": @[[FBLogSearchPredicate substrings:@[@"MATCH"]]]} options:FBBatchLogSearchOptionsFullLines since:nil error:nil];
+  [self writeString:@"MATCH 1\nNOPE\nMATCH 2\n" append:YES];
+  XCTAssertEqualObjects([search searchUnreadContentOfDiagnostics:@[self.diagnostic] tail:self.tail].mapping, (@{@"tailed": @[@"MATCH 1", @"MATCH 2"]}));
+
+  [self writeString:@"NOPE\nMATCH 3\n" append:YES];
+  XCTAssertEqualObjects([search searchUnreadContentOfDiagnostics:@[self.diagnostic] tail:self.tail].mapping, (@{@"tailed": @[@"MATCH 3"]}));
+  XCTAssertEqualObjects([search searchUnreadContentOfDiagnostics:@[self.diagnostic] tail:self.tail].mapping, @{});
+}
+
+@end
@@ -223,6 +223,88 @@
   [self assertWritesOutToFile:diagnostic];
 }
 
+- (void)testLinesOfInMemoryDiagnostic
+{
+  FBDiagnostic *diagnostic = [[[FBDiagnosticBuilder builder]
+    updateString:@"FIRST\nSECOND\r\nTHIRD\n"]
+    build];
+
+  XCTAssertEqual(diagnostic.lineCount, 5u);
+  XCTAssertEqualObjects([diagnostic linesInRange:NSMakeRange(0, 2)], (@[@"FIRST", @"SECOND"]));
+  XCTAssertEqualObjects([diagnostic linesInRange:NSMakeRange(3, 10)], (@[@"THIRD", @""]));
+  XCTAssertEqualObjects([diagnostic lastLines:2], (@[@"THIRD", @""]));
+  XCTAssertEqualObjects([diagnostic lastLines:10], [diagnostic.asString componentsSeparatedByCharactersInSet:NSCharacterSet.newlineCharacterSet]);
+  XCTAssertEqualObjects([self.photoDiagnostic lastLines:1], @[]);
+}
+
+- (void)testLinesOfLargeFileDiagnostic
+{
+  NSMutableString *string = [NSMutableString string];
+  for (NSUInteger index = 0; index < 50000; index++) {
+    [string appendFormat:@"Line %lu of a log that is large enough to be indexed\n", (unsigned long) index];
+  }
+  NSString *file = self.temporaryOutputFile;
+  XCTAssertTrue([string writeToFile:file atomically:YES encoding:NSUTF8StringEncoding error:nil]);
+  FBDiagnostic *diagnostic = [[[FBDiagnosticBuilder builder]
+    updatePath:file]
+    build];
+
+  XCTAssertEqualObjects([diagnostic lastLines:2], (@[@"Line 49999 of a log that is large enough to be indexed", @""]));
+  XCTAssertEqualObjects([diagnostic linesInRange:NSMakeRange(10, 1)], (@[@"Line 10 of a log that is large enough to be indexed"]));
+  XCTAssertEqual(diagnostic.lineCount, 50001u);
+  XCTAssertEqualObjects([diagnostic linesInRange:NSMakeRange(0, NSUIntegerMax)], [string componentsSeparatedByCharactersInSet:NSCharacterSet.newlineCharacterSet]);
+  XCTAssertEqualObjects(diagnostic.asSearchableData, [string dataUsingEncoding:NSUTF8StringEncoding]);
+
+  // Changes to the file are visible, as with other file backed diagnostics.
+  [string appendString:@"The Last Line"];
+  XCTAssertTrue([string writeToFile:file atomically:YES encoding:NSUTF8StringEncoding error:nil]);
+  XCTAssertEqualObjects([diagnostic lastLines:1], (@[@"The Last Line"]));
+  XCTAssertEqual(diagnostic.lineCount, 50001u);
+}
+
+- (void)testLinesOfLargeFileDiagnosticWithMixedTerminators
+{
+  // Lines of varying length, so that multi-byte terminators are split across the chunks that the file is read in.
+  NSArray<NSString *> *terminators = @[@"\n", @"\r\n", @"\u2028", @"\u0085", @"\u2029"];
+  NSMutableString *string = [NSMutableString string];
+  for (NSUInteger index = 0; index < 50000; index++) {
+    [string appendFormat:@"Line %lu%@%@", (unsigned long) index, [@"" stringByPaddingToLength:index % 13 withString:@"é" startingAtIndex:0], terminators[index % terminators.count]];
+  }
+  NSString *file = self.temporaryOutputFile;
+  XCTAssertTrue([string writeToFile:file atomically:YES encoding:NSUTF8StringEncoding error:nil]);
+  FBDiagnostic *diagnostic = [[[FBDiagnosticBuilder builder]
+    updatePath:file]
+    build];
+
+  NSArray<NSString *> *expected = [string componentsSeparatedByCharactersInSet:NSCharacterSet.newlineCharacterSet];
+  XCTAssertEqualObjects([diagnostic lastLines:20000], [expected subarrayWithRange:NSMakeRange(expected.count - 20000, 20000)]);
+  XCTAssertEqualObjects([diagnostic linesInRange:NSMakeRange(30000, 100)], [expected subarrayWithRange:NSMakeRange(30000, 100)]);
+  XCTAssertEqualObjects([diagnostic linesInRange:NSMakeRange(0, NSUIntegerMax)], expected);
+  XCTAssertEqualObjects([diagnostic lastLines:3], [expected subarrayWithRange:NSMakeRange(expected.count - 3, 3)]);
+}
+
+- (void)testLiveLargeFileDiagnosticIsReadRatherThanMapped
+{
+  NSMutableString *string = [NSMutableString string];
+  for (NSUInteger index = 0; index < 50000; index++) {
+    [string appendFormat:@"Line %lu of a live log\n", (unsigned long) index];
+  }
+  NSString *file = self.temporaryOutputFile;
+  XCTAssertTrue([string writeToFile:file atomically:YES encoding:NSUTF8StringEncoding error:nil]);
+  FBDiagnostic *diagnostic = [[[FBDiagnosticBuilder builder]
+    updatePath:file]
+    build];
+  NSData *data = diagnostic.asSearchableData;
+  XCTAssertEqual(data.length, [string lengthOfBytesUsingEncoding:NSUTF8StringEncoding]);
+
+  // Truncating the file in place must not invalidate the contents that have already been obtained.
+  NSFileHandle *handle = [NSFileHandle fileHandleForWritingAtPath:file];
+  [handle truncateFileAtOffset:0];
+  [handle closeFile];
+  XCTAssertEqualObjects([[NSString alloc] initWithData:[data subdataWithRange:NSMakeRange(data.length - 32, 32)] encoding:NSUTF8StringEncoding], [string substringFromIndex:string.length - 32]);
+  XCTAssertEqual(diagnostic.asSearchableData.length, 0u);
+}
+
 - (void)testJSONNativeObjectCoercions
 {
   FBDiagnostic *diagnostic = [[[[FBDiagnosticBuilder builder]
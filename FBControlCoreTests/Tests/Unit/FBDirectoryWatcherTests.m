@@ -0,0 +1,135 @@
+/**
+ * Copyright (c) 2015-present, Facebook, Inc.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree. An additional grant
+ * of patent rights can be found in the PATENTS file in the same directory.
+ */
+
+#import <XCTest/XCTest.h>
+
+#import <FBControlCore/FBControlCore.h>
+
+#import "FBControlCoreFixtures.h"
+
+@interface FBDirectoryWatcherTests : XCTestCase
+
+@property (nonatomic, copy, readwrite) NSString *directory;
+
+@end
+
+@implementation FBDirectoryWatcherTests
+
+- (void)setUp
+{
+  [super setUp];
+  self.directory = [NSTemporaryDirectory() stringByAppendingPathComponent:NSUUID.UUID.UUIDString];
+  [NSFileManager.defaultManager createDirectoryAtPath:self.directory withIntermediateDirectories:YES attributes:nil error:nil];
+}
+
+- (void)tearDown
+{
+  [NSFileManager.defaultManager removeItemAtPath:self.directory error:nil];
+  [super tearDown];
+}
+
+- (void)assertWatcherReportsChanges:(FBDirectoryWatcher *(^)(FBDirectoryWatcherHandler handler))makeWatcher
+{
+  NSString *path = [self.directory stringByAppendingPathComponent:@"foo.crash"];
+  XCTestExpectation *added = [[XCTestExpectation alloc] initWithDescription:@"File Added"];
+  XCTestExpectation *removed = [[XCTestExpectation alloc] initWithDescription:@"File Removed"];
+  added.assertForOverFulfill = NO;
+  removed.assertForOverFulfill = NO;
+  FBDirectoryWatcher *watcher = makeWatcher(^(NSString *changed, FBDirectoryWatcherEvent event) {
+    if (![changed.lastPathComponent isEqualToString:path.lastPathComponent]) {
+      return;
+    }
+    [(event == FBDirectoryWatcherEventAdded ? added : removed) fulfill];
+  });
+
+  NSError *error = nil;
+  XCTAssertTrue([watcher startWatching:YES error:&error]);
+  XCTAssertNil(error);
+  XCTAssertTrue(watcher.watching);
+
+  [@"crash" writeToFile:path atomically:NO encoding:NSUTF8StringEncoding error:nil];
+  [self waitForExpectations:@[added] timeout:FBControlCoreGlobalConfiguration.fastTimeout];
+  [NSFileManager.defaultManager removeItemAtPath:path error:nil];
+  [self waitForExpectations:@[removed] timeout:FBControlCoreGlobalConfiguration.fastTimeout];
+
+  [watcher stopWatching];
+  XCTAssertFalse(watcher.watching);
+}
+
+- (void)testPollingReportsChanges
+{
+  NSArray<NSString *> *directories = @[self.directory];
+  [self assertWatcherReportsChanges:^(FBDirectoryWatcherHandler handler) {
+    return [FBDirectoryWatcher pollingWatcherForDirectories:directories interval:0.05 queue:dispatch_get_main_queue() handler:handler];
+  }];
+}
+
+- (void)testDefaultBackendReportsChanges
+{
+  NSArray<NSString *> *directories = @[self.directory];
+  [self assertWatcherReportsChanges:^(FBDirectoryWatcherHandler handler) {
+    FBDirectoryWatcher *watcher = [FBDirectoryWatcher watcherForDirectories:directories backend:FBDirectoryWatcherBackendDefault queue:dispatch_get_main_queue() handler:handler error:nil];
+    XCTAssertNotNil(watcher);
+    XCTAssertNotEqual(watcher.backend, FBDirectoryWatcherBackendDefault);
+    return watcher;
+  }];
+}
+
+- (void)testReportsExistingFiles
+{
+  NSString *path = [self.directory stringByAppendingPathComponent:@"existing.crash"];
+  [@"crash" writeToFile:path atomically:NO encoding:NSUTF8StringEncoding error:nil];
+  XCTestExpectation *added = [[XCTestExpectation alloc] initWithDescription:@"Existing File Added"];
+  added.assertForOverFulfill = NO;
+  FBDirectoryWatcher *watcher = [FBDirectoryWatcher watcherForDirectories:@[self.directory] backend:FBDirectoryWatcherBackendDefault queue:dispatch_get_main_queue() handler:^(NSString *changed, FBDirectoryWatcherEvent event) {
+    if ([changed.lastPathComponent isEqualToString:path.lastPathComponent] && event == FBDirectoryWatcherEventAdded) {
+      [added fulfill];
+    }
+  } error:nil];
+
+  XCTAssertTrue([watcher startWatching:NO error:nil]);
+  [self waitForExpectations:@[added] timeout:FBControlCoreGlobalConfiguration.fastTimeout];
+  [watcher stopWatching];
+}
+
+- (void)testUnavailableBackend
+{
+#if defined(__apple_build_version__)
+  FBDirectoryWatcherBackend unavailable = FBDirectoryWatcherBackendInotify;
+#else
+  FBDirectoryWatcherBackend unavailable = FBDirectoryWatcherBackendFSEvents;
+#endif
+  NSError *error = nil;
+  FBDirectoryWatcher *watcher = [FBDirectoryWatcher watcherForDirectories:@[self.directory] backend:unavailable queue:dispatch_get_main_queue() handler:^(NSString *path, FBDirectoryWatcherEvent event) {} error:&error];
+  XCTAssertNil(watcher);
+  XCTAssertNotNil(error);
+}
+
+- (void)testNotifierIngestsWrittenCrashLogs
+{
+  NSError *error = nil;
+  FBCrashLogNotifier *notifier = [FBCrashLogNotifier notifierForDirectories:@[self.directory] backend:FBDirectoryWatcherBackendPolling logger:FBControlCoreGlobalConfiguration.defaultLogger error:&error];
+  XCTAssertNotNil(notifier);
+  [notifier startListening:YES];
+
+  NSPredicate *predicate = [FBCrashLogInfo predicateForCrashLogsWithProcessID:37083];
+  FBFuture<FBCrashLogInfo *> *next = [notifier crashLogForPredicate:predicate];
+  NSString *path = [self.directory stringByAppendingPathComponent:@"app_default_set.crash"];
+  [NSFileManager.defaultManager copyItemAtPath:FBControlCoreFixtures.appCrashPathWithDefaultDeviceSet toPath:path error:nil];
+  FBCrashLogInfo *crashLog = [next awaitWithTimeout:FBControlCoreGlobalConfiguration.fastTimeout error:&error];
+  XCTAssertNil(error);
+  XCTAssertEqual(crashLog.processIdentifier, 37083);
+
+  // A crash log that has already been ingested resolves without waiting for another.
+  crashLog = [[notifier crashLogForPredicate:predicate] awaitWithTimeout:FBControlCoreGlobalConfiguration.fastTimeout error:&error];
+  XCTAssertNil(error);
+  XCTAssertEqual(crashLog.processIdentifier, 37083);
+}
+
+@end
@@ -152,4 +152,73 @@
   [self assertSubject:subject hasHumanReadableContents:@[@"[Foo, Bar, Baz]"]];
 }
 
+- (void)assertBufferedInterpretationMatchesStringInterpretation:(id<FBEventReporterSubject>)subject
+{
+  id<FBEventInterpreter> interpreter = [FBEventInterpreter jsonEventInterpreter:NO];
+  NSString *expected = [interpreter interpret:subject];
+  NSMutableData *actual = [NSMutableData data];
+  XCTAssertTrue([interpreter appendInterpretation:subject toBuffer:actual]);
+  // Each path reads the current time separately, so the timestamps may differ by a second.
+  NSRegularExpression *timestamp = [NSRegularExpression regularExpressionWithPattern:@"\"timestamp\":[0-9]+" options:0 error:nil];
+  NSString *(^withoutTimestamps)(NSString *) = ^(NSString *json) {
+    return [timestamp stringByReplacingMatchesInString:json options:0 range:NSMakeRange(0, json.length) withTemplate:@"\"timestamp\":0"];
+  };
+  NSString *actualString = [[NSString alloc] initWithData:actual encoding:NSUTF8StringEncoding];
+  XCTAssertEqualObjects(withoutTimestamps(actualString), withoutTimestamps(expected));
+}
+
+- (void)testBufferedJSONInterpretationIsByteIdentical
+{
+  id<FBEventReporterSubject> value = [FBEventReporterSubject subjectWithControlCoreValue:FBControlCoreValueDouble.new];
+  NSArray<id<FBEventReporterSubject>> *subjects = @[
+    [FBEventReporterSubject subjectWithName:FBEventNameLaunch type:FBEventTypeStarted subject:value],
+    [FBEventReporterSubject subjectWithName:FBEventNameLaunch type:FBEventTypeDiscrete subject:[FBEventReporterSubject subjectWithStrings:@[@"Foo", @"Bar/Baz"]]],
+    [FBEventReporterSubject subjectWithName:FBEventNameLaunch type:FBEventTypeDiscrete values:@[FBControlCoreValueDouble.new, FBControlCoreValueDouble.new]],
+    [FBEventReporterSubject logSubjectWithString:@"A \"quoted\" line\twith\\escapes\x01 and unicode \u00e9\U0001F600\n" level:ASL_LEVEL_INFO],
+    [FBEventReporterSubject compositeSubjectWithArray:@[
+      [FBEventReporterSubject logSubjectWithString:@"first" level:ASL_LEVEL_DEBUG],
+      [FBEventReporterSubject logSubjectWithString:@"second" level:ASL_LEVEL_ERR],
+    ]],
+    [FBEventReporterSubject compositeSubjectWithArray:@[]],
+  ];
+  for (id<FBEventReporterSubject> subject in subjects) {
+    [self assertBufferedInterpretationMatchesStringInterpretation:subject];
+  }
+}
+
+- (void)testSubjectsThatAreNotEventsAreNotBuffered
+{
+  id<FBEventInterpreter> interpreter = [FBEventInterpreter jsonEventInterpreter:NO];
+  NSMutableData *buffer = [NSMutableData data];
+  XCTAssertFalse([interpreter appendInterpretation:[FBEventReporterSubject subjectWithStrings:@[@"Foo"]] toBuffer:buffer]);
+  XCTAssertFalse([interpreter appendInterpretation:[FBEventReporterSubject compositeSubjectWithArray:@[
+    [FBEventReporterSubject logSubjectWithString:@"first" level:ASL_LEVEL_DEBUG],
+    [FBEventReporterSubject subjectWithStrings:@[@"Foo"]],
+  ]] toBuffer:buffer]);
+  XCTAssertEqual(buffer.length, 0u);
+}
+
+- (void)testPrettyJSONIsNotBuffered
+{
+  id<FBEventInterpreter> interpreter = [FBEventInterpreter jsonEventInterpreter:YES];
+  NSMutableData *buffer = [NSMutableData data];
+  XCTAssertFalse([interpreter appendInterpretation:[FBEventReporterSubject logSubjectWithString:@"foo" level:ASL_LEVEL_INFO] toBuffer:buffer]);
+  XCTAssertEqual(buffer.length, 0u);
+}
+
+- (void)testReportingLogLinesPerformance
+{
+  NSUInteger count = 10000;
+  NSMutableArray<id<FBEventReporterSubject>> *subjects = [NSMutableArray array];
+  for (NSUInteger index = 0; index < count; index++) {
+    [subjects addObject:[FBEventReporterSubject logSubjectWithString:[NSString stringWithFormat:@"Log line number %lu with some content", (unsigned long)index] level:ASL_LEVEL_INFO]];
+  }
+  id<FBEventReporter> reporter = [FBEventReporter reporterWithInterpreter:[FBEventInterpreter jsonEventInterpreter:NO] consumer:FBNullDataConsumer.new];
+  [self measureBlock:^{
+    for (id<FBEventReporterSubject> subject in subjects) {
+      [reporter report:subject];
+    }
+  }];
+}
+
 @end
@@ -1024,6 +1024,252 @@
   [self waitForExpectations:@[teardownExpectation] timeout:FBControlCoreGlobalConfiguration.fastTimeout];
 }
 
+- (void)testInlineHandlerRunsWithinResolvingHandlerOnSameQueue
+{
+  FBMutableFuture<NSNumber *> *first = FBMutableFuture.future;
+  FBMutableFuture<NSNumber *> *second = FBMutableFuture.future;
+  XCTestExpectation *expectation = [[XCTestExpectation alloc] initWithDescription:@"Resolved Inline"];
+  __block BOOL resolving = NO;
+
+  [second onQueue:self.queue notifyOfCompletionInline:^(FBFuture *future) {
+    XCTAssertTrue(resolving);
+    XCTAssertEqualObjects(future.result, @2);
+    [expectation fulfill];
+  }];
+  [first onQueue:self.queue notifyOfCompletion:^(FBFuture *future) {
+    resolving = YES;
+    [second resolveWithResult:@2];
+    resolving = NO;
+  }];
+  [first resolveWithResult:@1];
+
+  [self waitForExpectations:@[expectation] timeout:FBControlCoreGlobalConfiguration.fastTimeout];
+}
+
+- (void)testInlineHandlerIsDispatchedFromOtherQueues
+{
+  FBMutableFuture<NSNumber *> *future = FBMutableFuture.future;
+  XCTestExpectation *expectation = [[XCTestExpectation alloc] initWithDescription:@"Resolved Asynchronously"];
+  __block BOOL resolving = NO;
+
+  [future onQueue:self.queue notifyOfCompletionInline:^(FBFuture *inner) {
+    XCTAssertFalse(resolving);
+    [expectation fulfill];
+  }];
+  dispatch_sync(self.queue, ^{
+    // Resolution is not from within a handler, so the handler must not be run inline.
+    resolving = YES;
+    [future resolveWithResult:@1];
+    resolving = NO;
+  });
+
+  [self waitForExpectations:@[expectation] timeout:FBControlCoreGlobalConfiguration.fastTimeout];
+}
+
+- (void)testInlineHandlerRunsWithinSynchronousDispatchToOtherQueue
+{
+  FBMutableFuture<NSNumber *> *first = FBMutableFuture.future;
+  FBMutableFuture<NSNumber *> *second = FBMutableFuture.future;
+  dispatch_queue_t otherQueue = dispatch_queue_create("com.facebook.fbcontrolcore.tests.future.other", DISPATCH_QUEUE_SERIAL);
+  XCTestExpectation *expectation = [[XCTestExpectation alloc] initWithDescription:@"Resolved Inline"];
+  __block BOOL resolving = NO;
+
+  [second onQueue:self.queue notifyOfCompletionInline:^(FBFuture *future) {
+    XCTAssertTrue(resolving);
+    [expectation fulfill];
+  }];
+  [first onQueue:self.queue notifyOfCompletion:^(FBFuture *future) {
+    dispatch_sync(otherQueue, ^{
+      // The resolving handler is on the stack and still holds its queue, whilst running on another queue.
+      resolving = YES;
+      [second resolveWithResult:@2];
+      resolving = NO;
+    });
+  }];
+  [first resolveWithResult:@1];
+
+  [self waitForExpectations:@[expectation] timeout:FBControlCoreGlobalConfiguration.fastTimeout];
+}
+
+- (void)testChainAndFmapAreDispatchedByDefault
+{
+  FBMutableFuture<NSNumber *> *first = FBMutableFuture.future;
+  FBMutableFuture<NSNumber *> *second = FBMutableFuture.future;
+  XCTestExpectation *chainExpectation = [[XCTestExpectation alloc] initWithDescription:@"Chained Asynchronously"];
+  XCTestExpectation *fmapExpectation = [[XCTestExpectation alloc] initWithDescription:@"Fmapped Asynchronously"];
+  __block BOOL resolving = NO;
+
+  [second onQueue:self.queue chain:^(FBFuture *future) {
+    XCTAssertFalse(resolving);
+    [chainExpectation fulfill];
+    return future;
+  }];
+  [second onQueue:self.queue fmap:^(id result) {
+    XCTAssertFalse(resolving);
+    [fmapExpectation fulfill];
+    return [FBFuture futureWithResult:result];
+  }];
+  [first onQueue:self.queue notifyOfCompletion:^(FBFuture *future) {
+    resolving = YES;
+    [second resolveWithResult:@2];
+    resolving = NO;
+  }];
+  [first resolveWithResult:@1];
+
+  [self waitForExpectations:@[chainExpectation, fmapExpectation] timeout:FBControlCoreGlobalConfiguration.fastTimeout];
+}
+
+- (void)testChainInlineAndFmapInlineRunWithinResolvingHandler
+{
+  FBMutableFuture<NSNumber *> *first = FBMutableFuture.future;
+  FBMutableFuture<NSNumber *> *second = FBMutableFuture.future;
+  XCTestExpectation *chainExpectation = [[XCTestExpectation alloc] initWithDescription:@"Chained Inline"];
+  XCTestExpectation *fmapExpectation = [[XCTestExpectation alloc] initWithDescription:@"Fmapped Inline"];
+  __block BOOL resolving = NO;
+
+  [second onQueue:self.queue chainInline:^(FBFuture *future) {
+    XCTAssertTrue(resolving);
+    [chainExpectation fulfill];
+    return future;
+  }];
+  [second onQueue:self.queue fmapInline:^(id result) {
+    XCTAssertTrue(resolving);
+    [fmapExpectation fulfill];
+    return [FBFuture futureWithResult:result];
+  }];
+  [first onQueue:self.queue notifyOfCompletion:^(FBFuture *future) {
+    resolving = YES;
+    [second resolveWithResult:@2];
+    resolving = NO;
+  }];
+  [first resolveWithResult:@1];
+
+  [self waitForExpectations:@[chainExpectation, fmapExpectation] timeout:FBControlCoreGlobalConfiguration.fastTimeout];
+}
+
+- (void)testConcurrentResolutionResolvesOnce
+{
+  NSUInteger iterations = 1000;
+  for (NSUInteger index = 0; index < iterations; index++) {
+    FBMutableFuture<NSNumber *> *future = FBMutableFuture.future;
+    __block int32_t handlerCount = 0;
+    dispatch_group_t group = dispatch_group_create();
+    [future onQueue:self.queue notifyOfCompletion:^(FBFuture *_) {
+      __atomic_fetch_add(&handlerCount, 1, __ATOMIC_RELAXED);
+    }];
+    dispatch_apply(4, dispatch_get_global_queue(QOS_CLASS_USER_INITIATED, 0), ^(size_t resolver) {
+      if (resolver % 2 == 0) {
+        [future resolveWithResult:@(resolver)];
+      } else {
+        [future cancel];
+      }
+    });
+    dispatch_group_enter(group);
+    [future onQueue:self.queue notifyOfCompletion:^(FBFuture *_) {
+      dispatch_group_leave(group);
+    }];
+    dispatch_group_wait(group, DISPATCH_TIME_FOREVER);
+    XCTAssertEqual(__atomic_load_n(&handlerCount, __ATOMIC_RELAXED), 1);
+    XCTAssertNotEqual(future.state, FBFutureStateRunning);
+    if (future.state == FBFutureStateDone) {
+      XCTAssertNotNil(future.result);
+    }
+  }
+}
+
+- (void)testConcurrentResolutionsCompleteOnce
+{
+  NSUInteger iterations = 1000;
+  for (NSUInteger index = 0; index < iterations; index++) {
+    FBMutableFuture<NSNumber *> *future = FBMutableFuture.future;
+    __block int32_t completionCount = 0;
+    dispatch_group_t group = dispatch_group_create();
+    dispatch_group_enter(group);
+    [future onQueue:self.queue notifyOfCompletion:^(FBFuture *_) {
+      __atomic_fetch_add(&completionCount, 1, __ATOMIC_RELAXED);
+      dispatch_group_leave(group);
+    }];
+    __block int32_t runningCount = 0;
+    dispatch_apply(4, dispatch_get_global_queue(QOS_CLASS_USER_INITIATED, 0), ^(size_t resolver) {
+      if (resolver % 2 == 0) {
+        [future resolveWithResult:@(resolver)];
+      } else {
+        [future resolveWithError:[NSError errorWithDomain:@"foo" code:(NSInteger) resolver userInfo:nil]];
+      }
+      // Every resolution, including those that lose, returns with the Future completed.
+      if (future.state == FBFutureStateRunning) {
+        __atomic_fetch_add(&runningCount, 1, __ATOMIC_RELAXED);
+      }
+    });
+    XCTAssertEqual(__atomic_load_n(&runningCount, __ATOMIC_RELAXED), 0);
+    XCTAssertEqual(dispatch_group_wait(group, dispatch_time(DISPATCH_TIME_NOW, (int64_t) (FBControlCoreGlobalConfiguration.fastTimeout * NSEC_PER_SEC))), 0);
+    XCTAssertEqual(__atomic_load_n(&completionCount, __ATOMIC_RELAXED), 1);
+    // Only the winning resolution is visible.
+    if (future.state == FBFutureStateDone) {
+      XCTAssertNil(future.error);
+      XCTAssertEqual([future.result unsignedIntegerValue] % 2, 0u);
+    } else {
+      XCTAssertEqual(future.state, FBFutureStateFailed);
+      XCTAssertNil(future.result);
+      XCTAssertEqual(future.error.code % 2, 1);
+    }
+  }
+}
+
+- (void)testResolutionThroughputPerformance
+{
+  NSUInteger count = 100000;
+  [self measureBlock:^{
+    dispatch_group_t group = dispatch_group_create();
+    for (NSUInteger index = 0; index < count; index++) {
+      FBMutableFuture<NSNumber *> *future = FBMutableFuture.future;
+      dispatch_group_enter(group);
+      [future onQueue:self.queue notifyOfCompletion:^(FBFuture *_) {
+        dispatch_group_leave(group);
+      }];
+      [future resolveWithResult:@(index)];
+    }
+    dispatch_group_wait(group, DISPATCH_TIME_FOREVER);
+  }];
+}
+
+- (void)testChainDepthLatencyPerformance
+{
+  [self measureChainDepthLatencyInline:NO];
+}
+
+- (void)testInlineChainDepthLatencyPerformance
+{
+  [self measureChainDepthLatencyInline:YES];
+}
+
+- (void)measureChainDepthLatencyInline:(BOOL)runsInline
+{
+  for (NSNumber *depth in @[@10, @100, @1000]) {
+    NSError *error = nil;
+    FBFuture<NSNumber *> *future = [self futureOfChainDepth:depth.unsignedIntegerValue inline:runsInline];
+    XCTAssertEqualObjects([future awaitWithTimeout:FBControlCoreGlobalConfiguration.fastTimeout error:&error], depth);
+    XCTAssertNil(error);
+  }
+  [self measureBlock:^{
+    for (NSUInteger iteration = 0; iteration < 10; iteration++) {
+      [[self futureOfChainDepth:1000 inline:runsInline] awaitWithTimeout:FBControlCoreGlobalConfiguration.fastTimeout error:nil];
+    }
+  }];
+}
+
+- (FBFuture<NSNumber *> *)futureOfChainDepth:(NSUInteger)depth inline:(BOOL)runsInline
+{
+  FBFuture<NSNumber *> *future = [FBFuture futureWithResult:@0];
+  for (NSUInteger index = 0; index < depth; index++) {
+    FBFuture *(^increment)(NSNumber *) = ^(NSNumber *value) {
+      return [FBFuture futureWithResult:@(value.unsignedIntegerValue + 1)];
+    };
+    future = runsInline ? [future onQueue:self.queue fmapInline:increment] : [future onQueue:self.queue fmap:increment];
+  }
+  return future;
+}
+
 #pragma mark - Helpers
 
 - (void)assertSynchronousResolutionWithBlock:(void (^)(FBMutableFuture *))resolveBlock expectedState:(FBFutureState)state expectedResult:(id)expectedResult expectedError:(NSError *)expectedError
@@ -0,0 +1,134 @@
+/**
+ * Copyright (c) 2015-present, Facebook, Inc.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree. An additional grant
+ * of patent rights can be found in the PATENTS file in the same directory.
+ */
+
+#import <XCTest/XCTest.h>
+
+#import <FBControlCore/FBControlCore.h>
+
+@interface FBFutureTracerTests : XCTestCase
+
+@property (nonatomic, strong, readwrite) dispatch_queue_t queue;
+@property (nonatomic, strong, readwrite) FBFutureTracer *tracer;
+
+@end
+
+@implementation FBFutureTracerTests
+
+- (void)setUp
+{
+  [super setUp];
+
+  self.queue = dispatch_queue_create("com.facebook.fbcontrolcore.tests.future_tracer", DISPATCH_QUEUE_SERIAL);
+  self.tracer = FBFutureTracer.tracer;
+}
+
+- (void)tearDown
+{
+  [self.tracer stop];
+
+  [super tearDown];
+}
+
+- (NSArray<NSDictionary<NSString *, id> *> *)eventsWithPhase:(NSString *)phase category:(NSString *)category
+{
+  NSPredicate *predicate = [NSPredicate predicateWithFormat:@"ph = %@ AND cat = %@", phase, category];
+  return [self.tracer.traceEvents filteredArrayUsingPredicate:predicate];
+}
+
+- (void)testInactiveTracerRecordsNothing
+{
+  NSError *error = nil;
+  id value = [[[FBFuture futureWithResult:@1] onQueue:self.queue map:^(NSNumber *number) {
+    return @(number.integerValue + 1);
+  }] awaitWithTimeout:FBControlCoreGlobalConfiguration.fastTimeout error:&error];
+  XCTAssertEqualObjects(value, @2);
+  XCTAssertNil(FBFutureTracer.activeTracer);
+  XCTAssertEqual(self.tracer.traceEvents.count, 0u);
+}
+
+- (void)testRecordsNamesStatesAndEdges
+{
+  [self.tracer start];
+  XCTAssertEqual(FBFutureTracer.activeTracer, self.tracer);
+
+  FBFuture *base = [[FBFuture futureWithResult:@1] named:@"base"];
+  FBFuture *mapped = [[base onQueue:self.queue fmap:^(NSNumber *number) {
+    return [FBFuture futureWithResult:@(number.integerValue + 1)];
+  }] named:@"mapped"];
+  NSError *error = nil;
+  XCTAssertEqualObjects([mapped awaitWithTimeout:FBControlCoreGlobalConfiguration.fastTimeout error:&error], @2);
+  [self.tracer stop];
+  XCTAssertNil(FBFutureTracer.activeTracer);
+
+  NSArray<NSDictionary<NSString *, id> *> *ends = [self eventsWithPhase:@"e" category:@"future"];
+  NSDictionary<NSString *, id> *mappedEnd = [ends filteredArrayUsingPredicate:[NSPredicate predicateWithFormat:@"name = %@", @"mapped"]].firstObject;
+  XCTAssertNotNil(mappedEnd);
+  XCTAssertEqualObjects(mappedEnd[@"args"][@"state"], @"done");
+
+  NSArray<NSDictionary<NSString *, id> *> *begins = [self eventsWithPhase:@"b" category:@"future"];
+  NSDictionary<NSString *, id> *mappedBegin = [begins filteredArrayUsingPredicate:[NSPredicate predicateWithFormat:@"id = %@", mappedEnd[@"id"]]].firstObject;
+  // The mapped future is derived from the base future and the future returned from the fmap.
+  XCTAssertEqual([mappedBegin[@"args"][@"parents"] count], 2u);
+
+  NSArray<NSDictionary<NSString *, id> *> *handlers = [self eventsWithPhase:@"X" category:@"handler"];
+  XCTAssertGreaterThan(handlers.count, 0u);
+  XCTAssertEqualObjects(handlers.firstObject[@"name"], @"com.facebook.fbcontrolcore.tests.future_tracer");
+}
+
+- (void)testExportsChromeTraceJSON
+{
+  [self.tracer start];
+  [[FBFuture futureWithResult:@1] named:@"exported"];
+  [FBMutableFuture.future named:@"unresolved"];
+  [self.tracer stop];
+
+  NSError *error = nil;
+  NSData *data = [self.tracer chromeTraceData:&error];
+  XCTAssertNil(error);
+  NSDictionary<NSString *, id> *trace = [NSJSONSerialization JSONObjectWithData:data options:0 error:&error];
+  XCTAssertNil(error);
+  NSArray<NSDictionary<NSString *, id> *> *events = trace[@"traceEvents"];
+  XCTAssertEqual(events.count, 4u);
+  for (NSDictionary<NSString *, id> *event in events) {
+    XCTAssertNotNil(event[@"ts"]);
+    XCTAssertNotNil(event[@"pid"]);
+  }
+  NSDictionary<NSString *, id> *unresolved = [[self eventsWithPhase:@"e" category:@"future"] filteredArrayUsingPredicate:[NSPredicate predicateWithFormat:@"args.state = %@", @"running"]].firstObject;
+  XCTAssertNotNil(unresolved);
+}
+
+- (void)testDropsOldestRecordsBeyondMaximum
+{
+  self.tracer = [FBFutureTracer tracerWithMaximumRecordCount:4];
+  [self.tracer start];
+  for (NSUInteger index = 0; index < 10; index++) {
+    [[FBFuture futureWithResult:@(index)] named:[NSString stringWithFormat:@"future_%lu", (unsigned long) index]];
+  }
+  [self.tracer stop];
+
+  NSArray<NSString *> *names = [[self eventsWithPhase:@"b" category:@"future"] valueForKey:@"name"];
+  XCTAssertEqualObjects(names, (@[@"future_6", @"future_7", @"future_8", @"future_9"]));
+}
+
+- (void)testActiveTracerOutlivesStop
+{
+  FBFutureTracer *tracer = FBFutureTracer.tracer;
+  [tracer start];
+  __weak FBFutureTracer *weakTracer = tracer;
+  FBFutureTracer *active = FBFutureTracer.activeTracer;
+  [tracer stop];
+  tracer = nil;
+
+  // The reference returned whilst the tracer was active keeps it alive after it has stopped.
+  XCTAssertNotNil(weakTracer);
+  XCTAssertEqual(active, weakTracer);
+  XCTAssertNil(FBFutureTracer.activeTracer);
+}
+
+@end
@@ -0,0 +1,104 @@
+/**
+ * Copyright (c) 2015-present, Facebook, Inc.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree. An additional grant
+ * of patent rights can be found in the PATENTS file in the same directory.
+ */
+
+#import <XCTest/XCTest.h>
+
+#import <FBControlCore/FBControlCore.h>
+
+@interface FBLaunchCtlServiceTableTests : XCTestCase
+
+@end
+
+@implementation FBLaunchCtlServiceTableTests
+
++ (NSString *)listOutput
+{
+  return @"PID\tStatus\tLabel\n"
+    "23421\t0\tcom.apple.mobile.keybagd\n"
+    "-\t0\tcom.apple.mobilegestalt.xpc\n"
+    "23428\t0\tUIKitApplication:com.apple.Preferences[0x2a4b][23362]\n"
+    "-\t-9\tUIKitApplication:com.apple.mobilesafari[0xd41e][23362]\n"
+    "23456\t-\tcom.apple.backboardd\n"
+    "\n";
+}
+
+- (FBLaunchCtlServiceTable *)table
+{
+  NSError *error = nil;
+  FBLaunchCtlServiceTable *table = [FBLaunchCtlServiceTable tableFromListOutput:FBLaunchCtlServiceTableTests.listOutput error:&error];
+  XCTAssertNil(error);
+  XCTAssertNotNil(table);
+  return table;
+}
+
+- (void)testParsesServices
+{
+  NSDictionary<NSString *, id> *expected = @{
+    @"com.apple.mobile.keybagd": @23421,
+    @"com.apple.mobilegestalt.xpc": NSNull.null,
+    @"UIKitApplication:com.apple.Preferences[0x2a4b][23362]": @23428,
+    @"UIKitApplication:com.apple.mobilesafari[0xd41e][23362]": NSNull.null,
+    @"com.apple.backboardd": @23456,
+  };
+  XCTAssertEqualObjects(self.table.services, expected);
+}
+
+- (void)testLooksUpByProcessIdentifier
+{
+  FBLaunchCtlServiceTable *table = self.table;
+  XCTAssertEqualObjects([table serviceNameForProcessIdentifier:23428], @"UIKitApplication:com.apple.Preferences[0x2a4b][23362]");
+  XCTAssertEqualObjects([table serviceNameForProcessIdentifier:23456], @"com.apple.backboardd");
+  XCTAssertNil([table serviceNameForProcessIdentifier:23362]);
+  XCTAssertNil([table serviceNameForProcessIdentifier:-1]);
+}
+
+- (void)testLooksUpByServiceName
+{
+  FBLaunchCtlServiceTable *table = self.table;
+  XCTAssertEqualObjects([table processIdentifierForServiceName:@"com.apple.mobile.keybagd"], @23421);
+  XCTAssertNil([table processIdentifierForServiceName:@"com.apple.mobilegestalt.xpc"]);
+  XCTAssertNil([table processIdentifierForServiceName:@"com.apple.nothing"]);
+}
+
+- (void)testMatchesSubstringsOfServiceNamesOnly
+{
+  FBLaunchCtlServiceTable *table = self.table;
+  NSDictionary<NSString *, NSNumber *> *expected = @{
+    @"UIKitApplication:com.apple.Preferences[0x2a4b][23362]": @23428,
+    @"UIKitApplication:com.apple.mobilesafari[0xd41e][23362]": @(-1),
+  };
+  XCTAssertEqualObjects([table serviceNamesAndProcessIdentifiersForSubstring:@"UIKitApplication"], expected);
+  XCTAssertEqualObjects([table serviceNamesAndProcessIdentifiersForSubstring:@"23421"], @{});
+}
+
+- (void)testParsesEmptyOutput
+{
+  NSError *error = nil;
+  FBLaunchCtlServiceTable *table = [FBLaunchCtlServiceTable tableFromListOutput:@"PID\tStatus\tLabel\n" error:&error];
+  XCTAssertNil(error);
+  XCTAssertEqualObjects(table.services, @{});
+}
+
+- (void)testFailsToParseMalformedLines
+{
+  NSArray<NSString *> *outputs = @[
+    @"PID\tStatus\tLabel\nfoo\t0\tcom.apple.foo\n",
+    @"PID\tStatus\tLabel\n123\t0\n",
+    @"PID\tStatus\tLabel\n0\t0\tcom.apple.foo\n",
+    @"PID\tStatus\tLabel\n99999999999\t0\tcom.apple.foo\n",
+  ];
+  for (NSString *output in outputs) {
+    NSError *error = nil;
+    FBLaunchCtlServiceTable *table = [FBLaunchCtlServiceTable tableFromListOutput:output error:&error];
+    XCTAssertNil(table);
+    XCTAssertNotNil(error);
+  }
+}
+
+@end
@@ -254,3 +254,157 @@
 }
 
 @end
+
+@interface FBCompiledLogSearchTests : XCTestCase
+
+@end
+
+@implementation FBCompiledLogSearchTests
+
++ (NSData *)generatedLogWithLineCount:(NSUInteger)lineCount
+{
+  NSMutableString *text = [NSMutableString string];
+  for (NSUInteger index = 0; index < lineCount; index++) {
+    [text appendFormat:@"Mar  7 16:50:18 some-hostname backboardd[24912]: line %lu of the generated log\n", (unsigned long) index];
+    if (index % 1000 == 0) {
+      [text appendFormat:@"Mar  7 16:50:18 some-hostname SpringBoard[24911]: layer position %lu 667 bounds 0 0 750 1334\n", (unsigned long) index];
+    }
+  }
+  return [text dataUsingEncoding:NSUTF8StringEncoding];
+}
+
+- (void)testFindsMultiplePredicatesInOnePass
+{
+  NSData *data = [@"Hellop\nBye\nHellooeeeeee\nGoodbye Hello" dataUsingEncoding:NSUTF8StringEncoding];
+  FBCompiledLogSearch *search = [FBCompiledLogSearch searchWithPredicates:@[
+    [FBLogSearchPredicate substrings:@[@"Hello"]],
+    [FBLogSearchPredicate substrings:@[@"bye"]],
+    [FBLogSearchPredicate substrings:@[@"Absent"]],
+  ]];
+  NSArray<NSArray<NSString *> *> *matches = [search matchesInData:data lines:YES first:NO];
+  XCTAssertEqualObjects(matches, (@[
+    @[@"Hellop", @"Hellooeeeeee", @"Goodbye Hello"],
+    @[@"Goodbye Hello"],
+    @[],
+  ]));
+}
+
+- (void)testPrefersEarlierSubstringsInPredicate
+{
+  NSData *data = [@"the quick brown fox\njumps over the lazy dog" dataUsingEncoding:NSUTF8StringEncoding];
+  FBCompiledLogSearch *search = [FBCompiledLogSearch searchWithPredicates:@[
+    [FBLogSearchPredicate substrings:@[@"fox", @"quick", @"dog"]],
+    [FBLogSearchPredicate substrings:@[@"he"]],
+  ]];
+  NSArray<NSArray<NSString *> *> *matches = [search matchesInData:data lines:NO first:NO];
+  XCTAssertEqualObjects(matches, (@[
+    @[@"fox", @"dog"],
+    @[@"he", @"he"],
+  ]));
+}
+
+- (void)testMatchesRegexesWithAndWithoutPrefilter
+{
+  NSData *data = [@"layer position 375 667 bounds 0 0 750 1334\nlayer position x\nREGEAAAAAAAAA!" dataUsingEncoding:NSUTF8StringEncoding];
+  FBCompiledLogSearch *search = [FBCompiledLogSearch searchWithPredicates:@[
+    [FBLogSearchPredicate regex:@"layer position \\d+ \\d+ bounds \\d+ \\d+ \\d+ \\d+"],
+    [FBLogSearchPredicate regex:@"(ANIMPOSSIBLE|REGEAAAAAAAAA)"],
+  ]];
+  NSArray<NSArray<NSString *> *> *matches = [search matchesInData:data lines:NO first:NO];
+  XCTAssertEqualObjects(matches, (@[
+    @[@"layer position 375 667 bounds 0 0 750 133"],
+    @[@"REGEAAAAAAAAA"],
+  ]));
+}
+
+- (void)testMatchesRegexesWithEscapesThatTakeArguments
+{
+  NSData *data = [@"ABC\n\x01 control\nclass 7x" dataUsingEncoding:NSUTF8StringEncoding];
+  FBCompiledLogSearch *search = [FBCompiledLogSearch searchWithPredicates:@[
+    [FBLogSearchPredicate regex:@"\\x41BC"],
+    [FBLogSearchPredicate regex:@"\\u0041BC"],
+    [FBLogSearchPredicate regex:@"\\cA control"],
+    [FBLogSearchPredicate regex:@"[a-z[0-9]]x"],
+  ]];
+  NSArray<NSArray<NSString *> *> *matches = [search matchesInData:data lines:YES first:NO];
+  XCTAssertEqualObjects(matches, (@[
+    @[@"ABC"],
+    @[@"ABC"],
+    @[@"\x01 control"],
+    @[@"class 7x"],
+  ]));
+}
+
+- (void)testSplitsLinesOnAllNewlineCharacters
+{
+  NSData *data = [@"one\r\ntwo three\u0085four" dataUsingEncoding:NSUTF8StringEncoding];
+  FBCompiledLogSearch *search = [FBCompiledLogSearch searchWithPredicates:@[
+    [FBLogSearchPredicate substrings:@[@"o"]],
+    [FBLogSearchPredicate substrings:@[@"three"]],
+  ]];
+  NSArray<NSArray<NSString *> *> *matches = [search matchesInData:data lines:YES first:NO];
+  XCTAssertEqualObjects(matches, (@[
+    @[@"one", @"two three", @"four"],
+    @[@"two three"],
+  ]));
+}
+
+- (void)testMatchesLinesThatAreNotValidUTF8
+{
+  // 0xE9 is 'é' in Latin-1, but is not valid UTF-8 on its own.
+  NSMutableData *data = [[@"valid line\ncaf" dataUsingEncoding:NSUTF8StringEncoding] mutableCopy];
+  [data appendBytes:"\xE9 line" length:6];
+  FBCompiledLogSearch *search = [FBCompiledLogSearch searchWithPredicates:@[
+    [FBLogSearchPredicate substrings:@[@"line"]],
+    [FBLogSearchPredicate regex:@"caf. line"],
+  ]];
+  NSArray<NSArray<NSString *> *> *matches = [search matchesInData:data lines:YES first:NO];
+  XCTAssertEqualObjects(matches, (@[
+    @[@"valid line", @"caf\u00e9 line"],
+    @[@"caf\u00e9 line"],
+  ]));
+}
+
+- (void)testChunkedSearchIsConsistentWithLineSearch
+{
+  NSData *data = [FBCompiledLogSearchTests generatedLogWithLineCount:50000];
+  NSString *text = [[NSString alloc] initWithData:data encoding:NSUTF8StringEncoding];
+  NSArray<FBLogSearchPredicate *> *predicates = @[
+    [FBLogSearchPredicate substrings:@[@"line 4999", @"SpringBoard"]],
+    [FBLogSearchPredicate regex:@"layer position \\d+ \\d+ bounds \\d+ \\d+ \\d+ \\d+"],
+  ];
+  FBCompiledLogSearch *search = [FBCompiledLogSearch searchWithPredicates:predicates];
+  NSArray<NSArray<NSString *> *> *matches = [search matchesInData:data lines:YES first:NO];
+  NSArray<NSArray<NSString *> *> *firstMatches = [search matchesInData:data lines:YES first:YES];
+  for (NSUInteger index = 0; index < predicates.count; index++) {
+    FBLogSearch *expected = [FBLogSearch withText:text predicate:predicates[index]];
+    XCTAssertEqualObjects(matches[index], expected.matchingLines);
+    XCTAssertEqualObjects(firstMatches[index], @[expected.firstMatchingLine]);
+  }
+}
+
+- (void)testDoesNotFindInBinaryDiagnostics
+{
+  FBCompiledLogSearch *search = [FBCompiledLogSearch searchWithPredicates:@[
+    [FBLogSearchPredicate substrings:@[@"PNG"]],
+  ]];
+  XCTAssertEqualObjects([search matchesInDiagnostic:self.photoDiagnostic lines:NO first:NO], (@[@[]]));
+}
+
+- (void)testManyPredicatesPerformance
+{
+  NSData *data = [FBCompiledLogSearchTests generatedLogWithLineCount:200000];
+  NSMutableArray<FBLogSearchPredicate *> *predicates = [NSMutableArray array];
+  for (NSUInteger index = 0; index < 100; index++) {
+    [predicates addObject:[FBLogSearchPredicate substrings:@[[NSString stringWithFormat:@"needle-%lu", (unsigned long) index], @"SpringBoard"]]];
+  }
+  [predicates addObject:[FBLogSearchPredicate regex:@"layer position \\d+ \\d+ bounds \\d+ \\d+ \\d+ \\d+"]];
+  FBCompiledLogSearch *search = [FBCompiledLogSearch searchWithPredicates:predicates];
+
+  [self measureBlock:^{
+    NSArray<NSArray<NSString *> *> *matches = [search matchesInData:data lines:YES first:NO];
+    XCTAssertEqual(matches.lastObject.count, 200u);
+  }];
+}
+
+@end
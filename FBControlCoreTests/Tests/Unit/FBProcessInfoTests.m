@@ -0,0 +1,83 @@
+/**
+ * Copyright (c) 2015-present, Facebook, Inc.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree. An additional grant
+ * of patent rights can be found in the PATENTS file in the same directory.
+ */
+
+#import <XCTest/XCTest.h>
+
+#import <FBControlCore/FBControlCore.h>
+
+@interface FBProcessInfoTests : XCTestCase
+
+@end
+
+@implementation FBProcessInfoTests
+
+- (FBProcessInfo *)lazyProcessInfo
+{
+  static const char strings[] = "/usr/bin/thing\0--arg\0\0A=B=C\0FBSIMULATORCONTROL_SIM_UDID=1234\0FBSIMULATORCONTROL_SIM_UDID_SUFFIX=5678\0\0IGNORED=1";
+  NSData *data = [NSData dataWithBytes:strings length:sizeof(strings) - 1];
+  return [[FBProcessInfo alloc]
+    initWithProcessIdentifier:42
+    launchPath:@"/usr/bin/thing"
+    strings:data
+    argumentRange:NSMakeRange(0, 22)
+    environmentRange:NSMakeRange(22, data.length - 22)];
+}
+
+- (void)testDecodesLazily
+{
+  FBProcessInfo *process = self.lazyProcessInfo;
+  XCTAssertEqualObjects(process.arguments, (@[@"/usr/bin/thing", @"--arg", @""]));
+  XCTAssertEqualObjects(process.environment, (@{
+    @"A": @"B=C",
+    @"FBSIMULATORCONTROL_SIM_UDID": @"1234",
+    @"FBSIMULATORCONTROL_SIM_UDID_SUFFIX": @"5678",
+  }));
+}
+
+- (void)testSingleEnvironmentValue
+{
+  FBProcessInfo *process = self.lazyProcessInfo;
+  XCTAssertEqualObjects([process environmentValueForKey:@"FBSIMULATORCONTROL_SIM_UDID"], @"1234");
+  XCTAssertEqualObjects([process environmentValueForKey:@"FBSIMULATORCONTROL_SIM_UDID_SUFFIX"], @"5678");
+  XCTAssertEqualObjects([process environmentValueForKey:@"A"], @"B=C");
+  XCTAssertNil([process environmentValueForKey:@"FBSIMULATORCONTROL_SIM"]);
+  XCTAssertNil([process environmentValueForKey:@"IGNORED"]);
+
+  FBProcessInfo *decoded = [[FBProcessInfo alloc] initWithProcessIdentifier:42 launchPath:@"/usr/bin/thing" arguments:@[] environment:@{@"FOO": @"BAR"}];
+  XCTAssertEqualObjects([decoded environmentValueForKey:@"FOO"], @"BAR");
+  XCTAssertNil([decoded environmentValueForKey:@"BAR"]);
+}
+
+- (void)testEquality
+{
+  FBProcessInfo *lazy = self.lazyProcessInfo;
+  FBProcessInfo *otherLazy = self.lazyProcessInfo;
+  FBProcessInfo *decoded = [[FBProcessInfo alloc] initWithProcessIdentifier:42 launchPath:@"/usr/bin/thing" arguments:@[@"/usr/bin/thing", @"--arg", @""] environment:@{}];
+  FBProcessInfo *different = [[FBProcessInfo alloc] initWithProcessIdentifier:42 launchPath:@"/usr/bin/thing" arguments:@[@"/usr/bin/thing"] environment:@{}];
+
+  XCTAssertEqualObjects(lazy, otherLazy);
+  XCTAssertEqualObjects(lazy, decoded);
+  XCTAssertEqualObjects(decoded, lazy);
+  XCTAssertNotEqualObjects(lazy, different);
+  XCTAssertEqual(lazy.hash, decoded.hash);
+  XCTAssertEqual([lazy copy], lazy);
+}
+
+- (void)testProcessTableScanPerformance
+{
+  FBProcessFetcher *fetcher = [FBProcessFetcher new];
+  [self measureBlock:^{
+    for (NSUInteger iteration = 0; iteration < 10; iteration++) {
+      FBProcessTable *table = [fetcher processTable];
+      [table processesWithEnvironmentKey:@"FBSIMULATORCONTROL_SIM_UDID"];
+    }
+  }];
+}
+
+@end
@@ -0,0 +1,168 @@
+/**
+ * Copyright (c) 2015-present, Facebook, Inc.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree. An additional grant
+ * of patent rights can be found in the PATENTS file in the same directory.
+ */
+
+#import <XCTest/XCTest.h>
+
+#import <FBControlCore/FBControlCore.h>
+
+@interface FBProcessTableTests : XCTestCase
+
+@property (nonatomic, copy, readwrite) NSString *procPath;
+
+@end
+
+@implementation FBProcessTableTests
+
+- (void)setUp
+{
+  [super setUp];
+  self.procPath = [NSTemporaryDirectory() stringByAppendingPathComponent:NSUUID.UUID.UUIDString];
+  [NSFileManager.defaultManager createDirectoryAtPath:self.procPath withIntermediateDirectories:YES attributes:nil error:nil];
+}
+
+- (void)tearDown
+{
+  [NSFileManager.defaultManager removeItemAtPath:self.procPath error:nil];
+  [super tearDown];
+}
+
+- (void)writeProcess:(pid_t)processIdentifier name:(NSString *)name parent:(pid_t)parent launchPath:(NSString *)launchPath arguments:(NSArray<NSString *> *)arguments environment:(NSArray<NSString *> *)environment
+{
+  NSString *directory = [self.procPath stringByAppendingPathComponent:[NSString stringWithFormat:@"%d", processIdentifier]];
+  [NSFileManager.defaultManager createDirectoryAtPath:directory withIntermediateDirectories:YES attributes:nil error:nil];
+  NSString *stat = [NSString stringWithFormat:@"%d (%@) S %d %d 0 0 -1 4194560", processIdentifier, name, parent, processIdentifier];
+  [stat writeToFile:[directory stringByAppendingPathComponent:@"stat"] atomically:NO encoding:NSUTF8StringEncoding error:nil];
+  [[self nulTerminated:arguments] writeToFile:[directory stringByAppendingPathComponent:@"cmdline"] atomically:NO];
+  [[self nulTerminated:environment] writeToFile:[directory stringByAppendingPathComponent:@"environ"] atomically:NO];
+  if (launchPath) {
+    [NSFileManager.defaultManager createSymbolicLinkAtPath:[directory stringByAppendingPathComponent:@"exe"] withDestinationPath:launchPath error:nil];
+  }
+}
+
+- (NSData *)nulTerminated:(NSArray<NSString *> *)strings
+{
+  NSMutableData *data = [NSMutableData data];
+  for (NSString *string in strings) {
+    [data appendData:[string dataUsingEncoding:NSUTF8StringEncoding]];
+    [data appendBytes:"\0" length:1];
+  }
+  return data;
+}
+
+- (void)writeDefaultProcesses
+{
+  [self writeProcess:1 name:@"init" parent:0 launchPath:@"/sbin/init" arguments:@[@"/sbin/init"] environment:@[@"HOME=/"]];
+  [self writeProcess:20 name:@"launchd_sim" parent:1 launchPath:@"/usr/libexec/launchd_sim" arguments:@[@"launchd_sim", @"/path/launchd_bootstrap.plist"] environment:@[@"XPC_SIMULATOR_LAUNCHD_NAME=com.apple.CoreSimulator.SimDevice.ABC", @"DYLD_INSERT_LIBRARIES=a=b"]];
+  [self writeProcess:300 name:@"with (parens) and spaces" parent:20 launchPath:nil arguments:@[@"/usr/bin/thing", @"", @"--flag"] environment:@[]];
+  [self writeProcess:4000 name:@"kthreadd" parent:0 launchPath:nil arguments:@[] environment:@[]];
+  [@"not a process" writeToFile:[self.procPath stringByAppendingPathComponent:@"uptime"] atomically:NO encoding:NSUTF8StringEncoding error:nil];
+}
+
+- (void)testParsesProcFilesystem
+{
+  [self writeDefaultProcesses];
+
+  NSError *error = nil;
+  FBProcessTable *table = [FBProcessTable tableFromProcFilesystemAtPath:self.procPath error:&error];
+  XCTAssertNil(error);
+  XCTAssertEqualObjects([table.processes valueForKey:@"processIdentifier"], (@[@1, @20, @300]));
+
+  FBProcessInfo *launchd = [table processInfoFor:20];
+  XCTAssertEqualObjects(launchd.launchPath, @"/usr/libexec/launchd_sim");
+  XCTAssertEqualObjects(launchd.arguments, (@[@"launchd_sim", @"/path/launchd_bootstrap.plist"]));
+  XCTAssertEqualObjects(launchd.environment[@"DYLD_INSERT_LIBRARIES"], @"a=b");
+
+  FBProcessInfo *thing = [table processInfoFor:300];
+  XCTAssertEqualObjects(thing.launchPath, @"/usr/bin/thing");
+  XCTAssertEqualObjects(thing.arguments, (@[@"/usr/bin/thing", @"", @"--flag"]));
+  XCTAssertEqualObjects(thing.environment, @{});
+
+  XCTAssertNil([FBProcessTable tableFromProcFilesystemAtPath:[self.procPath stringByAppendingPathComponent:@"missing"] error:&error]);
+  XCTAssertNotNil(error);
+}
+
+- (void)testIndexes
+{
+  [self writeDefaultProcesses];
+  FBProcessTable *table = [FBProcessTable tableFromProcFilesystemAtPath:self.procPath error:nil];
+
+  XCTAssertEqualObjects([[table processesWithProcessName:@"launchd_sim"] valueForKey:@"processIdentifier"], @[@20]);
+  XCTAssertEqualObjects([[table processesWithProcessName:@"with (parens) and spaces"] valueForKey:@"processIdentifier"], @[@300]);
+  XCTAssertEqualObjects([table processesWithProcessName:@"kthreadd"], @[]);
+  XCTAssertEqualObjects([[table processesWithLaunchPath:@"/sbin/init"] valueForKey:@"processIdentifier"], @[@1]);
+  XCTAssertEqualObjects([[table processesWithLaunchPathSubstring:@"/usr/"] valueForKey:@"processIdentifier"], (@[@20, @300]));
+  XCTAssertEqualObjects([[table processesWithEnvironmentKey:@"XPC_SIMULATOR_LAUNCHD_NAME"] valueForKey:@"processIdentifier"], @[@20]);
+  XCTAssertEqualObjects([[table subprocessesOf:20] valueForKey:@"processIdentifier"], @[@300]);
+  XCTAssertEqual([table parentOf:300], 20);
+  XCTAssertEqual([table parentOf:12345], -1);
+}
+
+- (void)testChanges
+{
+  FBProcessInfo *first = [[FBProcessInfo alloc] initWithProcessIdentifier:10 launchPath:@"/bin/first" arguments:@[] environment:@{}];
+  FBProcessInfo *second = [[FBProcessInfo alloc] initWithProcessIdentifier:11 launchPath:@"/bin/second" arguments:@[] environment:@{}];
+  FBProcessInfo *reused = [[FBProcessInfo alloc] initWithProcessIdentifier:10 launchPath:@"/bin/reused" arguments:@[] environment:@{}];
+  FBProcessInfo *third = [[FBProcessInfo alloc] initWithProcessIdentifier:12 launchPath:@"/bin/third" arguments:@[] environment:@{}];
+
+  FBProcessTable *previous = [FBProcessTable tableWithProcesses:@[first, second] parents:@{} names:@{}];
+  FBProcessTable *current = [FBProcessTable tableWithProcesses:@[reused, second, third] parents:@{} names:@{}];
+  FBProcessTableChanges *changes = [current changesSince:previous];
+  XCTAssertEqualObjects(changes.started, (@[reused, third]));
+  XCTAssertEqualObjects(changes.exited, @[first]);
+
+  changes = [current changesSince:current];
+  XCTAssertEqualObjects(changes.started, @[]);
+  XCTAssertEqualObjects(changes.exited, @[]);
+}
+
+- (void)testParsesProcArgs
+{
+  NSMutableData *data = [NSMutableData data];
+  int argc = 2;
+  [data appendBytes:&argc length:sizeof(argc)];
+  [data appendData:[self nulTerminated:@[@"/usr/bin/thing"]]];
+  [data appendBytes:"\0\0\0" length:3];
+  [data appendData:[self nulTerminated:@[@"thing", @"--arg", @"A=B=C", @"NOSEPARATOR", @"D=E", @"", @"apple=1"]]];
+
+  FBProcessInfo *process = [FBProcessTable processInfoWithProcessIdentifier:42 procArgs:data.bytes length:data.length];
+  XCTAssertEqual(process.processIdentifier, 42);
+  XCTAssertEqualObjects(process.launchPath, @"/usr/bin/thing");
+  XCTAssertEqualObjects(process.arguments, (@[@"thing", @"--arg"]));
+  XCTAssertEqualObjects(process.environment, (@{@"A": @"B=C", @"D": @"E"}));
+
+  // Truncated buffers are rejected, rather than read past.
+  XCTAssertNil([FBProcessTable processInfoWithProcessIdentifier:42 procArgs:data.bytes length:sizeof(int) + 8]);
+  XCTAssertNil([FBProcessTable processInfoWithProcessIdentifier:42 procArgs:data.bytes length:2]);
+}
+
+- (void)testHostProcessTable
+{
+  FBProcessFetcher *fetcher = [FBProcessFetcher new];
+  FBProcessTable *table = [fetcher processTable];
+  pid_t processIdentifier = NSProcessInfo.processInfo.processIdentifier;
+  FBProcessInfo *current = [table processInfoFor:processIdentifier];
+  XCTAssertEqualObjects(current, [fetcher processInfoFor:processIdentifier]);
+  XCTAssertEqual([table parentOf:processIdentifier], [fetcher parentOf:processIdentifier]);
+
+  XCTAssertEqual([fetcher processTableWithMaximumAge:60], table);
+  XCTAssertNotEqual([fetcher processTableWithMaximumAge:0], table);
+}
+
+- (void)testSnapshotQueryPerformance
+{
+  FBProcessFetcher *fetcher = [FBProcessFetcher new];
+  [self measureBlock:^{
+    FBProcessTable *table = [fetcher processTable];
+    [table processesWithProcessName:@"launchd_sim"];
+    [table processesWithLaunchPathSubstring:@"com.apple.CoreSimulator.CoreSimulatorService"];
+    [table subprocessesOf:1];
+  }];
+}
+
+@end
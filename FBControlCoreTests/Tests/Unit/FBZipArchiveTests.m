@@ -0,0 +1,380 @@
+/**
+ * Copyright (c) 2015-present, Facebook, Inc.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree. An additional grant
+ * of patent rights can be found in the PATENTS file in the same directory.
+ */
+
+#import <XCTest/XCTest.h>
+
+#import <CommonCrypto/CommonDigest.h>
+
+#import <FBControlCore/FBControlCore.h>
+
+@interface FBZipArchiveTests : XCTestCase
+
+@property (nonatomic, copy, readwrite) NSString *directory;
+
+@end
+
+@implementation FBZipArchiveTests
+
+- (void)setUp
+{
+  [super setUp];
+  self.directory = [NSTemporaryDirectory() stringByAppendingPathComponent:NSUUID.UUID.UUIDString];
+  [NSFileManager.defaultManager createDirectoryAtPath:self.directory withIntermediateDirectories:YES attributes:nil error:nil];
+}
+
+- (void)tearDown
+{
+  [NSFileManager.defaultManager removeItemAtPath:self.directory error:nil];
+  [super tearDown];
+}
+
+- (NSString *)zipApplication
+{
+  return [self zipApplicationThroughPipe:NO];
+}
+
+- (NSString *)zipApplicationThroughPipe:(BOOL)throughPipe
+{
+  // A Payload directory in the layout of an IPA, zipped by zip(1) so that the entries are deflated.
+  NSString *source = [self.directory stringByAppendingPathComponent:@"source"];
+  NSString *app = [source stringByAppendingPathComponent:@"Payload/Thing.app"];
+  [NSFileManager.defaultManager createDirectoryAtPath:[app stringByAppendingPathComponent:@"Frameworks/Empty"] withIntermediateDirectories:YES attributes:nil error:nil];
+  NSMutableString *large = [NSMutableString string];
+  for (NSUInteger index = 0; index < 100000; index++) {
+    [large appendFormat:@"Line %lu of a file that spans more than one inflation buffer\n", (unsigned long) index];
+  }
+  [large writeToFile:[app stringByAppendingPathComponent:@"Large.txt"] atomically:NO encoding:NSUTF8StringEncoding error:nil];
+  [@"#!/bin/sh\n" writeToFile:[app stringByAppendingPathComponent:@"Thing"] atomically:NO encoding:NSUTF8StringEncoding error:nil];
+  [NSFileManager.defaultManager setAttributes:@{NSFilePosixPermissions: @0755} ofItemAtPath:[app stringByAppendingPathComponent:@"Thing"] error:nil];
+  [NSFileManager.defaultManager createSymbolicLinkAtPath:[app stringByAppendingPathComponent:@"Link"] withDestinationPath:@"Thing" error:nil];
+
+  NSString *archive = [self.directory stringByAppendingPathComponent:@"Thing.ipa"];
+  NSError *error = nil;
+  // When the output is not seekable, zip(1) writes the sizes of each entry in a data descriptor after its contents.
+  NSString *command = throughPipe
+    ? [NSString stringWithFormat:@"cd '%@' && /usr/bin/zip -q -r -y - Payload | cat > '%@'", source, archive]
+    : [NSString stringWithFormat:@"cd '%@' && /usr/bin/zip -q -r -y '%@' Payload", source, archive];
+  FBTask *task = [[[FBTaskBuilder
+    withLaunchPath:@"/bin/sh" arguments:@[@"-c", command]]
+    runUntilCompletion]
+    awaitWithTimeout:FBControlCoreGlobalConfiguration.slowTimeout error:&error];
+  XCTAssertNotNil(task);
+  XCTAssertNil(error);
+  return archive;
+}
+
+- (NSData *)storedArchiveWithName:(NSString *)name contents:(NSData *)contents crc:(uint32_t)crc
+{
+  // Builds a single entry archive, without compression.
+  NSData *nameData = [name dataUsingEncoding:NSUTF8StringEncoding];
+  uint16_t nameLength = (uint16_t) nameData.length;
+  uint32_t size = (uint32_t) contents.length;
+  NSMutableData *data = [NSMutableData data];
+  uint32_t signature = 0x04034b50;
+  uint16_t zero16 = 0;
+  uint32_t zero32 = 0;
+  [data appendBytes:&signature length:4];
+  [data appendBytes:&zero16 length:2]; // version needed
+  [data appendBytes:&zero16 length:2]; // flags
+  [data appendBytes:&zero16 length:2]; // method
+  [data appendBytes:&zero32 length:4]; // time & date
+  [data appendBytes:&crc length:4];
+  [data appendBytes:&size length:4];
+  [data appendBytes:&size length:4];
+  [data appendBytes:&nameLength length:2];
+  [data appendBytes:&zero16 length:2]; // extra length
+  [data appendData:nameData];
+  [data appendData:contents];
+
+  uint32_t directoryOffset = (uint32_t) data.length;
+  signature = 0x02014b50;
+  [data appendBytes:&signature length:4];
+  [data appendBytes:&zero32 length:4]; // version made by & needed
+  [data appendBytes:&zero16 length:2]; // flags
+  [data appendBytes:&zero16 length:2]; // method
+  [data appendBytes:&zero32 length:4]; // time & date
+  [data appendBytes:&crc length:4];
+  [data appendBytes:&size length:4];
+  [data appendBytes:&size length:4];
+  [data appendBytes:&nameLength length:2];
+  [data appendBytes:&zero32 length:4]; // extra & comment length
+  [data appendBytes:&zero32 length:4]; // disk & internal attributes
+  [data appendBytes:&zero32 length:4]; // external attributes
+  [data appendBytes:&zero32 length:4]; // local header offset
+  [data appendData:nameData];
+  uint32_t directoryLength = (uint32_t) data.length - directoryOffset;
+
+  signature = 0x06054b50;
+  uint16_t count = 1;
+  [data appendBytes:&signature length:4];
+  [data appendBytes:&zero32 length:4]; // disk numbers
+  [data appendBytes:&count length:2];
+  [data appendBytes:&count length:2];
+  [data appendBytes:&directoryLength length:4];
+  [data appendBytes:&directoryOffset length:4];
+  [data appendBytes:&zero16 length:2]; // comment length
+  return data;
+}
+
+- (void)testExtractsDeflatedArchive
+{
+  NSString *archivePath = [self zipApplication];
+  NSError *error = nil;
+  FBZipArchive *archive = [FBZipArchive archiveAtPath:archivePath error:&error];
+  XCTAssertNil(error);
+  XCTAssertTrue([[archive.entries valueForKey:@"path"] containsObject:@"Payload/Thing.app/Large.txt"]);
+
+  NSString *destination = [self.directory stringByAppendingPathComponent:@"extracted"];
+  XCTAssertTrue([archive extractToDirectory:destination error:&error]);
+  XCTAssertNil(error);
+  [self assertExtractedApplicationInDirectory:destination];
+}
+
+- (void)assertExtractedApplicationInDirectory:(NSString *)destination
+{
+  NSString *app = [destination stringByAppendingPathComponent:@"Payload/Thing.app"];
+  NSString *source = [self.directory stringByAppendingPathComponent:@"source/Payload/Thing.app"];
+  XCTAssertTrue([NSFileManager.defaultManager contentsEqualAtPath:[app stringByAppendingPathComponent:@"Large.txt"] andPath:[source stringByAppendingPathComponent:@"Large.txt"]]);
+  NSDictionary<NSFileAttributeKey, id> *attributes = [NSFileManager.defaultManager attributesOfItemAtPath:[app stringByAppendingPathComponent:@"Thing"] error:nil];
+  XCTAssertEqual([attributes[NSFilePosixPermissions] unsignedShortValue] & 0777, 0755);
+  XCTAssertEqualObjects([NSFileManager.defaultManager destinationOfSymbolicLinkAtPath:[app stringByAppendingPathComponent:@"Link"] error:nil], @"Thing");
+  BOOL isDirectory = NO;
+  XCTAssertTrue([NSFileManager.defaultManager fileExistsAtPath:[app stringByAppendingPathComponent:@"Frameworks/Empty"] isDirectory:&isDirectory]);
+  XCTAssertTrue(isDirectory);
+}
+
+- (void)streamArchiveAtPath:(NSString *)archivePath toConsumer:(id<FBDataConsumer>)consumer
+{
+  // The archive is delivered in chunks that do not align with the boundaries of entries.
+  NSData *data = [NSData dataWithContentsOfFile:archivePath];
+  size_t chunkSize = 7919;
+  for (NSUInteger offset = 0; offset < data.length; offset += chunkSize) {
+    [consumer consumeData:[data subdataWithRange:NSMakeRange(offset, MIN(chunkSize, data.length - offset))]];
+  }
+  [consumer consumeEndOfFile];
+}
+
+- (void)testStreamsDeflatedArchive
+{
+  NSString *archivePath = [self zipApplication];
+  NSString *destination = [self.directory stringByAppendingPathComponent:@"streamed"];
+  FBZipStreamExtractor *extractor = [FBZipStreamExtractor extractorForArchiveAtPath:archivePath toDirectory:destination maximumExtractedSize:UINT64_MAX];
+  [self streamArchiveAtPath:archivePath toConsumer:extractor];
+
+  NSError *error = nil;
+  XCTAssertEqualObjects([extractor.completed awaitWithTimeout:FBControlCoreGlobalConfiguration.slowTimeout error:&error], destination);
+  XCTAssertNil(error);
+  [self assertExtractedApplicationInDirectory:destination];
+}
+
+- (void)testStreamsArchiveWithDataDescriptors
+{
+  NSString *archivePath = [self zipApplicationThroughPipe:YES];
+  NSString *destination = [self.directory stringByAppendingPathComponent:@"streamed"];
+  FBZipStreamExtractor *extractor = [FBZipStreamExtractor extractorForArchiveAtPath:archivePath toDirectory:destination maximumExtractedSize:UINT64_MAX];
+  [self streamArchiveAtPath:archivePath toConsumer:extractor];
+
+  NSError *error = nil;
+  XCTAssertEqualObjects([extractor.completed awaitWithTimeout:FBControlCoreGlobalConfiguration.slowTimeout error:&error], destination);
+  XCTAssertNil(error);
+  [self assertExtractedApplicationInDirectory:destination];
+}
+
+- (void)testStreamingFailsForTruncatedArchive
+{
+  NSString *archivePath = [self zipApplication];
+  NSData *data = [NSData dataWithContentsOfFile:archivePath];
+  NSString *destination = [self.directory stringByAppendingPathComponent:@"streamed"];
+  FBZipStreamExtractor *extractor = [FBZipStreamExtractor extractorForArchiveAtPath:archivePath toDirectory:destination maximumExtractedSize:UINT64_MAX];
+  [extractor consumeData:[data subdataWithRange:NSMakeRange(0, data.length / 2)]];
+  [extractor consumeEndOfFile];
+
+  NSError *error = nil;
+  XCTAssertNil([extractor.completed awaitWithTimeout:FBControlCoreGlobalConfiguration.fastTimeout error:&error]);
+  XCTAssertNotNil(error);
+  XCTAssertFalse([NSFileManager.defaultManager fileExistsAtPath:destination]);
+}
+
+- (void)testStreamingFailsWhenExceedingMaximumExtractedSize
+{
+  NSString *archivePath = [self zipApplicationThroughPipe:YES];
+  NSString *destination = [self.directory stringByAppendingPathComponent:@"streamed"];
+  FBZipStreamExtractor *extractor = [FBZipStreamExtractor extractorForArchiveAtPath:archivePath toDirectory:destination maximumExtractedSize:1024 * 1024];
+  [self streamArchiveAtPath:archivePath toConsumer:extractor];
+
+  NSError *error = nil;
+  XCTAssertNil([extractor.completed awaitWithTimeout:FBControlCoreGlobalConfiguration.fastTimeout error:&error]);
+  XCTAssertNotNil(error);
+  XCTAssertFalse([NSFileManager.defaultManager fileExistsAtPath:destination]);
+}
+
+- (void)testCacheExtractsFromFileWhenStreamExceedsMaximumExtractedSize
+{
+  NSString *archivePath = [self zipApplicationThroughPipe:YES];
+  FBArchiveExtractionCache *cache = [FBArchiveExtractionCache cacheWithDirectory:[self.directory stringByAppendingPathComponent:@"cache"] retainedUnusedCount:1 logger:nil];
+  [self streamArchiveAtPath:archivePath toConsumer:[cache extractionConsumerForArchiveAtPath:archivePath length:1024]];
+
+  dispatch_queue_t queue = dispatch_queue_create("com.facebook.fbcontrolcore.tests.extraction", DISPATCH_QUEUE_SERIAL);
+  NSError *error = nil;
+  NSString *extractedPath = [[[cache onQueue:queue extractArchiveAtPath:archivePath] onQueue:queue pop:^(NSURL *directory) {
+    return [FBFuture futureWithResult:directory.path];
+  }] awaitWithTimeout:FBControlCoreGlobalConfiguration.slowTimeout error:&error];
+  XCTAssertNil(error);
+  [self assertExtractedApplicationInDirectory:extractedPath];
+}
+
+- (void)testCacheUsesStreamedExtraction
+{
+  NSString *archivePath = [self zipApplication];
+  FBArchiveExtractionCache *cache = [FBArchiveExtractionCache cacheWithDirectory:[self.directory stringByAppendingPathComponent:@"cache"] retainedUnusedCount:1 logger:nil];
+  [self streamArchiveAtPath:archivePath toConsumer:[cache extractionConsumerForArchiveAtPath:archivePath length:[NSData dataWithContentsOfFile:archivePath].length]];
+
+  dispatch_queue_t queue = dispatch_queue_create("com.facebook.fbcontrolcore.tests.extraction", DISPATCH_QUEUE_SERIAL);
+  NSError *error = nil;
+  NSString *extractedPath = [[[cache onQueue:queue extractArchiveAtPath:archivePath] onQueue:queue pop:^(NSURL *directory) {
+    return [FBFuture futureWithResult:directory.path];
+  }] awaitWithTimeout:FBControlCoreGlobalConfiguration.slowTimeout error:&error];
+  XCTAssertNil(error);
+  XCTAssertEqualObjects(extractedPath.stringByDeletingLastPathComponent, cache.directory);
+  [self assertExtractedApplicationInDirectory:extractedPath];
+}
+
+- (void)testCacheBoundsUnusedStreamedExtractions
+{
+  FBArchiveExtractionCache *cache = [FBArchiveExtractionCache cacheWithDirectory:[self.directory stringByAppendingPathComponent:@"cache"] retainedUnusedCount:0 logger:nil];
+  dispatch_queue_t queue = dispatch_queue_create("com.facebook.fbcontrolcore.tests.extraction", DISPATCH_QUEUE_SERIAL);
+  NSMutableArray<NSString *> *keys = [NSMutableArray array];
+  for (NSUInteger index = 0; index < 3; index++) {
+    NSString *source = [self.directory stringByAppendingPathComponent:[NSString stringWithFormat:@"source_%lu", (unsigned long) index]];
+    NSString *archivePath = [self.directory stringByAppendingPathComponent:[NSString stringWithFormat:@"Upload_%lu.ipa", (unsigned long) index]];
+    NSString *command = [NSString stringWithFormat:@"mkdir -p '%@/Payload' && echo %lu > '%@/Payload/file' && cd '%@' && /usr/bin/zip -q -r '%@' Payload", source, (unsigned long) index, source, source, archivePath];
+    NSError *error = nil;
+    XCTAssertNotNil([[[FBTaskBuilder withLaunchPath:@"/bin/sh" arguments:@[@"-c", command]] runUntilCompletion] awaitWithTimeout:FBControlCoreGlobalConfiguration.slowTimeout error:&error]);
+
+    NSData *data = [NSData dataWithContentsOfFile:archivePath];
+    unsigned char digest[CC_SHA256_DIGEST_LENGTH];
+    CC_SHA256(data.bytes, (CC_LONG) data.length, digest);
+    NSMutableString *key = [NSMutableString string];
+    for (size_t byte = 0; byte < CC_SHA256_DIGEST_LENGTH; byte++) {
+      [key appendFormat:@"%02x", digest[byte]];
+    }
+    [keys addObject:key];
+
+    // Each upload is complete before the next, so the oldest unused extraction is the one that is removed.
+    [self streamArchiveAtPath:archivePath toConsumer:[cache extractionConsumerForArchiveAtPath:archivePath length:[NSData dataWithContentsOfFile:archivePath].length]];
+    NSString *extractedPath = [cache.directory stringByAppendingPathComponent:key];
+    XCTAssertNotNil([[FBFuture onQueue:queue resolveWhen:^ BOOL {
+      return [NSFileManager.defaultManager fileExistsAtPath:[extractedPath stringByAppendingPathComponent:@"Payload/file"]];
+    }] awaitWithTimeout:FBControlCoreGlobalConfiguration.fastTimeout error:&error]);
+  }
+
+  NSError *error = nil;
+  XCTAssertNotNil([[FBFuture onQueue:queue resolveWhen:^ BOOL {
+    return ![NSFileManager.defaultManager fileExistsAtPath:[cache.directory stringByAppendingPathComponent:keys[0]]];
+  }] awaitWithTimeout:FBControlCoreGlobalConfiguration.fastTimeout error:&error]);
+  XCTAssertTrue([NSFileManager.defaultManager fileExistsAtPath:[cache.directory stringByAppendingPathComponent:keys[1]]]);
+  XCTAssertTrue([NSFileManager.defaultManager fileExistsAtPath:[cache.directory stringByAppendingPathComponent:keys[2]]]);
+}
+
+- (void)testRejectsUnsafePaths
+{
+  NSString *archivePath = [self.directory stringByAppendingPathComponent:@"unsafe.zip"];
+  [[self storedArchiveWithName:@"Payload/../../escaped" contents:[@"evil" dataUsingEncoding:NSUTF8StringEncoding] crc:0] writeToFile:archivePath atomically:NO];
+
+  NSError *error = nil;
+  FBZipArchive *archive = [FBZipArchive archiveAtPath:archivePath error:&error];
+  XCTAssertNotNil(archive);
+  XCTAssertFalse([archive extractToDirectory:[self.directory stringByAppendingPathComponent:@"extracted/inner"] error:&error]);
+  XCTAssertNotNil(error);
+  XCTAssertFalse([NSFileManager.defaultManager fileExistsAtPath:[self.directory stringByAppendingPathComponent:@"escaped"]]);
+}
+
+- (void)testRejectsCorruptArchives
+{
+  NSString *archivePath = [self.directory stringByAppendingPathComponent:@"corrupt.zip"];
+  [[self storedArchiveWithName:@"file.txt" contents:[@"contents" dataUsingEncoding:NSUTF8StringEncoding] crc:12345] writeToFile:archivePath atomically:NO];
+  NSError *error = nil;
+  FBZipArchive *archive = [FBZipArchive archiveAtPath:archivePath error:&error];
+  XCTAssertNotNil(archive);
+  XCTAssertFalse([archive extractToDirectory:[self.directory stringByAppendingPathComponent:@"extracted"] error:&error]);
+  XCTAssertNotNil(error);
+
+  NSString *notArchivePath = [self.directory stringByAppendingPathComponent:@"not_a.zip"];
+  [@"not a zip archive at all" writeToFile:notArchivePath atomically:NO encoding:NSUTF8StringEncoding error:nil];
+  error = nil;
+  XCTAssertNil([FBZipArchive archiveAtPath:notArchivePath error:&error]);
+  XCTAssertNotNil(error);
+}
+
+- (void)testCacheSharesExtractionOfIdenticalArchives
+{
+  NSString *first = [self zipApplication];
+  NSString *second = [self.directory stringByAppendingPathComponent:@"Copy.ipa"];
+  [NSFileManager.defaultManager copyItemAtPath:first toPath:second error:nil];
+
+  FBArchiveExtractionCache *cache = [FBArchiveExtractionCache cacheWithDirectory:[self.directory stringByAppendingPathComponent:@"cache"] retainedUnusedCount:0 logger:nil];
+  dispatch_queue_t queue = dispatch_queue_create("com.facebook.fbcontrolcore.tests.extraction", DISPATCH_QUEUE_SERIAL);
+  FBMutableFuture<NSNull *> *release = FBMutableFuture.future;
+  NSMutableArray<NSURL *> *extracted = [NSMutableArray array];
+  XCTestExpectation *bothExtracted = [[XCTestExpectation alloc] initWithDescription:@"Both Extracted"];
+  bothExtracted.expectedFulfillmentCount = 2;
+
+  NSMutableArray<FBFuture *> *uses = [NSMutableArray array];
+  for (NSString *path in @[first, second]) {
+    [uses addObject:[[cache onQueue:queue extractArchiveAtPath:path] onQueue:queue pop:^(NSURL *directory) {
+      [extracted addObject:directory];
+      [bothExtracted fulfill];
+      return release;
+    }]];
+  }
+  [self waitForExpectations:@[bothExtracted] timeout:FBControlCoreGlobalConfiguration.slowTimeout];
+  XCTAssertEqualObjects(extracted.firstObject, extracted.lastObject);
+  NSString *extractedPath = extracted.firstObject.path;
+  XCTAssertTrue([NSFileManager.defaultManager fileExistsAtPath:[extractedPath stringByAppendingPathComponent:@"Payload/Thing.app/Thing"]]);
+
+  // Once both contexts are torn down, the unused extraction is removed.
+  [release resolveWithResult:NSNull.null];
+  NSError *error = nil;
+  XCTAssertNotNil([[FBFuture futureWithFutures:uses] awaitWithTimeout:FBControlCoreGlobalConfiguration.fastTimeout error:&error]);
+  XCTAssertNil(error);
+  XCTAssertNotNil([[FBFuture onQueue:queue resolveWhen:^ BOOL {
+    return ![NSFileManager.defaultManager fileExistsAtPath:extractedPath];
+  }] awaitWithTimeout:FBControlCoreGlobalConfiguration.fastTimeout error:&error]);
+}
+
+- (void)testSharedCacheExtractsSequentialUsesOnce
+{
+  NSString *archivePath = [self zipApplication];
+  dispatch_queue_t queue = dispatch_queue_create("com.facebook.fbcontrolcore.tests.extraction", DISPATCH_QUEUE_SERIAL);
+  NSMutableArray<NSString *> *extractedPaths = [NSMutableArray array];
+  NSMutableArray<NSNumber *> *fileNumbers = [NSMutableArray array];
+
+  // As with sequential installs of an IPA, each use is torn down before the next one starts, so nothing references the extraction in between.
+  for (NSUInteger index = 0; index < 2; index++) {
+    NSError *error = nil;
+    NSString *extractedPath = [[[FBArchiveExtractionCache.sharedCache
+      onQueue:queue extractArchiveAtPath:archivePath]
+      onQueue:queue pop:^(NSURL *directory) {
+        return [FBFuture futureWithResult:directory.path];
+      }]
+      awaitWithTimeout:FBControlCoreGlobalConfiguration.slowTimeout error:&error];
+    XCTAssertNil(error);
+    XCTAssertNotNil(extractedPath);
+    [extractedPaths addObject:extractedPath];
+    NSDictionary<NSFileAttributeKey, id> *attributes = [NSFileManager.defaultManager attributesOfItemAtPath:[extractedPath stringByAppendingPathComponent:@"Payload/Thing.app/Thing"] error:&error];
+    XCTAssertNotNil(attributes);
+    [fileNumbers addObject:attributes[NSFileSystemFileNumber]];
+  }
+
+  // A second extraction would have replaced the directory, and with it the files inside it.
+  XCTAssertEqualObjects(extractedPaths.firstObject, extractedPaths.lastObject);
+  XCTAssertEqualObjects(fileNumbers.firstObject, fileNumbers.lastObject);
+}
+
+@end
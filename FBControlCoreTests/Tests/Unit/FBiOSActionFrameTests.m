@@ -0,0 +1,121 @@
+/**
+ * Copyright (c) 2015-present, Facebook, Inc.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree. An additional grant
+ * of patent rights can be found in the PATENTS file in the same directory.
+ */
+
+#import <XCTest/XCTest.h>
+
+#import <FBControlCore/FBControlCore.h>
+
+@interface FBiOSActionFrameTests : XCTestCase
+
+@property (nonatomic, strong, readwrite) NSMutableArray<NSArray *> *frames;
+@property (nonatomic, strong, readwrite) NSMutableArray<NSError *> *errors;
+
+@end
+
+@implementation FBiOSActionFrameTests
+
+- (void)setUp
+{
+  [super setUp];
+
+  self.frames = [NSMutableArray array];
+  self.errors = [NSMutableArray array];
+}
+
+- (FBiOSActionFrameDecoder *)decoderWithMaximumPayloadLength:(size_t)maximumPayloadLength
+{
+  return [FBiOSActionFrameDecoder
+    decoderWithMaximumPayloadLength:maximumPayloadLength
+    handler:^(FBiOSActionFrameType type, uint32_t streamIdentifier, dispatch_data_t payload) {
+      [self.frames addObject:@[@(type), @(streamIdentifier), [FBDataConsumerAdaptor adaptDispatchData:payload]]];
+    }
+    errorHandler:^(NSError *error) {
+      [self.errors addObject:error];
+    }];
+}
+
++ (dispatch_data_t)frameWithType:(FBiOSActionFrameType)type streamIdentifier:(uint32_t)streamIdentifier string:(NSString *)string
+{
+  NSData *payload = [string dataUsingEncoding:NSUTF8StringEncoding];
+  return [FBiOSActionFrame frameWithType:type streamIdentifier:streamIdentifier payload:[FBiOSActionFrame dispatchDataWithData:payload]];
+}
+
+- (void)testEncodesHeaderInNetworkByteOrder
+{
+  NSData *frame = [FBDataConsumerAdaptor adaptDispatchData:[FBiOSActionFrameTests frameWithType:FBiOSActionFrameTypeData streamIdentifier:258 string:@"FOO"]];
+  const uint8_t expected[] = {2, 0, 0, 1, 2, 0, 0, 0, 3, 'F', 'O', 'O'};
+  XCTAssertEqualObjects(frame, [NSData dataWithBytes:expected length:sizeof(expected)]);
+}
+
+- (void)testDecodesConsecutiveFrames
+{
+  FBiOSActionFrameDecoder *decoder = [self decoderWithMaximumPayloadLength:1024];
+  dispatch_data_t data = dispatch_data_create_concat(
+    [FBiOSActionFrameTests frameWithType:FBiOSActionFrameTypeAction streamIdentifier:1 string:@"{}"],
+    [FBiOSActionFrameTests frameWithType:FBiOSActionFrameTypeData streamIdentifier:2 string:@""]
+  );
+  [decoder consumeData:data];
+  [decoder consumeEndOfFile];
+
+  NSArray<NSArray *> *expected = @[
+    @[@(FBiOSActionFrameTypeAction), @1, [@"{}" dataUsingEncoding:NSUTF8StringEncoding]],
+    @[@(FBiOSActionFrameTypeData), @2, NSData.data],
+  ];
+  XCTAssertEqualObjects(self.frames, expected);
+  XCTAssertEqual(self.errors.count, 0u);
+}
+
+- (void)testDecodesFramesSplitAcrossWrites
+{
+  FBiOSActionFrameDecoder *decoder = [self decoderWithMaximumPayloadLength:1024];
+  NSData *data = [FBDataConsumerAdaptor adaptDispatchData:[FBiOSActionFrameTests frameWithType:FBiOSActionFrameTypeData streamIdentifier:7 string:@"FOOBARBAZ"]];
+  for (NSUInteger index = 0; index < data.length; index++) {
+    XCTAssertEqual(self.frames.count, 0u);
+    [decoder consumeData:[FBiOSActionFrame dispatchDataWithData:[data subdataWithRange:NSMakeRange(index, 1)]]];
+  }
+
+  NSArray<NSArray *> *expected = @[
+    @[@(FBiOSActionFrameTypeData), @7, [@"FOOBARBAZ" dataUsingEncoding:NSUTF8StringEncoding]],
+  ];
+  XCTAssertEqualObjects(self.frames, expected);
+  XCTAssertEqual(self.errors.count, 0u);
+}
+
+- (void)testOversizedFrameIsAProtocolError
+{
+  FBiOSActionFrameDecoder *decoder = [self decoderWithMaximumPayloadLength:4];
+  [decoder consumeData:[FBiOSActionFrameTests frameWithType:FBiOSActionFrameTypeData streamIdentifier:1 string:@"FOOBAR"]];
+  [decoder consumeData:[FBiOSActionFrameTests frameWithType:FBiOSActionFrameTypeData streamIdentifier:1 string:@"FOO"]];
+
+  XCTAssertEqual(self.frames.count, 0u);
+  XCTAssertEqual(self.errors.count, 1u);
+}
+
+- (void)testPartialFrameAtEndOfFileIsAProtocolError
+{
+  FBiOSActionFrameDecoder *decoder = [self decoderWithMaximumPayloadLength:1024];
+  dispatch_data_t frame = [FBiOSActionFrameTests frameWithType:FBiOSActionFrameTypeData streamIdentifier:1 string:@"FOOBAR"];
+  [decoder consumeData:dispatch_data_create_subrange(frame, 0, dispatch_data_get_size(frame) - 1)];
+  [decoder consumeEndOfFile];
+
+  XCTAssertEqual(self.frames.count, 0u);
+  XCTAssertEqual(self.errors.count, 1u);
+}
+
+- (void)testOutputConsumerWrapsDataInFrames
+{
+  id<FBAccumulatingBuffer> buffer = FBLineBuffer.accumulatingBuffer;
+  id<FBDataConsumer> consumer = [FBiOSActionFrame outputConsumerForStreamIdentifier:3 consumer:buffer];
+  [consumer consumeData:[@"FOO" dataUsingEncoding:NSUTF8StringEncoding]];
+
+  NSData *expected = [FBDataConsumerAdaptor adaptDispatchData:[FBiOSActionFrameTests frameWithType:FBiOSActionFrameTypeOutput streamIdentifier:3 string:@"FOO"]];
+  XCTAssertEqualObjects(buffer.data, expected);
+}
+
+@end
@@ -50,15 +50,11 @@
 
 - (FBFuture<NSNull *> *)installApplicationWithPath:(NSString *)path
 {
-  return [[[FBApplicationBundle
+  // The extraction is torn down with the context, it may be shared with other installs of the same IPA.
+  return [[FBApplicationBundle
     onQueue:self.simulator.asyncQueue findOrExtractApplicationAtPath:path logger:self.simulator.logger]
     onQueue:self.simulator.workQueue pop:^(FBExtractedApplication *extractedApplication) {
-      return [[self installExtractedApplicationWithPath:extractedApplication.bundle.path] mapReplace:extractedApplication];
-    }]
-    onQueue:self.simulator.asyncQueue notifyOfCompletion:^(FBFuture<FBExtractedApplication *> *future) {
-      if (future.result.extractedPath) {
-        [NSFileManager.defaultManager removeItemAtURL:future.result.extractedPath error:nil];
-      }
+      return [[self installExtractedApplicationWithPath:extractedApplication.bundle.path] mapReplace:NSNull.null];
     }];
 }
 
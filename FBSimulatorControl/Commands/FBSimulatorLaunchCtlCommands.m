@@ -20,11 +20,21 @@
 #import "FBSimulatorProcessFetcher.h"
 #import "FBSimulatorError.h"
 
+/**
+ Queries that are made within this interval of each other may share the same Service Table.
+ The Service Table is also discarded when the subprocesses of launchd_sim change, this is an upper bound for changes that this does not catch.
+ */
+static NSTimeInterval const FBSimulatorLaunchCtlServiceTableMaximumAge = 5.0;
+
 @interface FBSimulatorLaunchCtlCommands ()
 
 @property (nonatomic, strong, readonly) FBSimulator *simulator;
 @property (nonatomic, strong, readonly) FBBinaryDescriptor *launchCtlBinary;
 
+@property (nonatomic, strong, nullable, readwrite) FBFuture<FBLaunchCtlServiceTable *> *serviceTableFuture;
+@property (nonatomic, copy, nullable, readwrite) NSSet<NSNumber *> *serviceTableSubprocesses;
+@property (nonatomic, assign, readwrite) CFAbsoluteTime serviceTableTime;
+
 - (instancetype)initWithSimulator:(FBSimulator *)simulator launchCtlBinary:(FBBinaryDescriptor *)launchCtlBinary;
 
 @end
@@ -77,31 +87,26 @@
 
 - (FBFuture<NSString *> *)serviceNameForProcess:(FBProcessInfo *)process
 {
+  pid_t processIdentifier = process.processIdentifier;
   return [[self
-    serviceNameAndProcessIdentifierForSubstring:@(process.processIdentifier).stringValue]
-    onQueue:self.simulator.asyncQueue map:^(NSArray<id> *tuple) {
-      return [tuple firstObject];
+    serviceTable]
+    onQueue:self.simulator.asyncQueue fmap:^(FBLaunchCtlServiceTable *table) {
+      NSString *serviceName = [table serviceNameForProcessIdentifier:processIdentifier];
+      if (!serviceName) {
+        return [[FBSimulatorError
+          describeFormat:@"No Matching processes for %d", processIdentifier]
+          failFuture];
+      }
+      return [FBFuture futureWithResult:serviceName];
     }];
 }
 
 - (FBFuture<NSDictionary<NSString *, NSNumber *> *> *)serviceNamesAndProcessIdentifiersForSubstring:(NSString *)substring
 {
   return [[self
-    runWithArguments:@[@"list"]]
-    onQueue:self.simulator.asyncQueue fmap:^(NSString *text) {
-      FBLogSearchPredicate *predicate = [FBLogSearchPredicate substrings:@[substring]];
-      FBLogSearch *search = [FBLogSearch withText:text predicate:predicate];
-      NSMutableDictionary<NSString *, NSNumber *> *mapping = [NSMutableDictionary dictionary];
-      for (NSString *line in search.matchingLines) {
-        NSError *error = nil;
-        pid_t processIdentifier = 0;
-        NSString *serviceName = [FBSimulatorLaunchCtlCommands extractServiceNameFromListLine:line processIdentifierOut:&processIdentifier error:&error];
-        if (!serviceName) {
-          return [FBControlCoreError failFutureWithError:error];
-        }
-        mapping[serviceName] = @(processIdentifier);
-      }
-      return [FBFuture futureWithResult:mapping];
+    serviceTable]
+    onQueue:self.simulator.asyncQueue map:^(FBLaunchCtlServiceTable *table) {
+      return [table serviceNamesAndProcessIdentifiersForSubstring:substring];
     }];
 }
 
@@ -128,40 +133,20 @@
 
 - (FBFuture<NSNumber *> *)processIsRunningOnSimulator:(FBProcessInfo *)process
 {
+  pid_t processIdentifier = process.processIdentifier;
   return [[self
-    serviceNameForProcess:process]
-    onQueue:self.simulator.workQueue map:^NSNumber *(NSString *result) {
-      return @YES;
+    serviceTable]
+    onQueue:self.simulator.asyncQueue map:^NSNumber *(FBLaunchCtlServiceTable *table) {
+      return @([table serviceNameForProcessIdentifier:processIdentifier] != nil);
     }];
 }
 
 - (FBFuture<NSDictionary<NSString *, id> *> *)listServices
 {
   return [[self
-    runWithArguments:@[@"list"]]
-    onQueue:self.simulator.asyncQueue fmap:^(NSString *text) {
-      NSArray<NSString *> *lines = [text componentsSeparatedByCharactersInSet:NSCharacterSet.newlineCharacterSet];
-      if (lines.count < 2) {
-        return [[FBSimulatorError
-          describeFormat:@"Insufficient number of lines from output '%@'", text]
-          failFuture];
-      }
-      lines = [lines subarrayWithRange:NSMakeRange(1, lines.count -1)];
-
-      NSMutableDictionary<NSString *, id> *services = [NSMutableDictionary dictionary];
-      for (NSString *line in lines) {
-        if (line.length == 0) {
-          continue;
-        }
-        pid_t processIdentifier = -1;
-        NSError *error = nil;
-        NSString *serviceName = [FBSimulatorLaunchCtlCommands extractServiceNameFromListLine:line processIdentifierOut:&processIdentifier error:&error];
-        if (!serviceName) {
-          return [FBSimulatorError failFutureWithError:error];
-        }
-        services[serviceName] = processIdentifier > 0 ? @(processIdentifier) : NSNull.null;
-      }
-      return [FBFuture futureWithResult:[services copy]];
+    serviceTable]
+    onQueue:self.simulator.asyncQueue map:^(FBLaunchCtlServiceTable *table) {
+      return table.services;
     }];
 }
 
@@ -169,16 +154,22 @@
 
 - (FBFuture<NSString *> *)stopServiceWithName:(NSString *)serviceName
 {
-  return [[self
+  return [[[self
     runWithArguments:@[@"stop", serviceName]]
-    rephraseFailure:@"Failed to stop service '%@'", serviceName];
+    rephraseFailure:@"Failed to stop service '%@'", serviceName]
+    onQueue:self.simulator.asyncQueue notifyOfCompletion:^(FBFuture *_) {
+      [self invalidateServiceTable];
+    }];
 }
 
 - (FBFuture<NSString *> *)startServiceWithName:(NSString *)serviceName
 {
-  return [[self
+  return [[[self
     runWithArguments:@[@"start", serviceName]]
-    rephraseFailure:@"Failed to start service '%@'", serviceName];
+    rephraseFailure:@"Failed to start service '%@'", serviceName]
+    onQueue:self.simulator.asyncQueue notifyOfCompletion:^(FBFuture *_) {
+      [self invalidateServiceTable];
+    }];
 }
 
 #pragma mark Helpers
@@ -208,34 +199,50 @@
   return regex;
 }
 
-+ (NSString *)extractServiceNameFromListLine:(NSString *)line processIdentifierOut:(pid_t *)processIdentifierOut error:(NSError **)error
+- (FBFuture<FBLaunchCtlServiceTable *> *)serviceTable
 {
-  NSArray<NSString *> *words = [line componentsSeparatedByCharactersInSet:NSCharacterSet.whitespaceCharacterSet];
-  if (words.count != 3) {
-    return [[FBSimulatorError
-      describeFormat:@"Output does not have exactly three words: %@", [FBCollectionInformation oneLineDescriptionFromArray:words]]
-      fail:error];
-  }
-  NSString *serviceName = [words lastObject];
-  NSString *processIdentifierString = [words firstObject];
-  if ([processIdentifierString isEqualToString:@"-"]) {
-    if (processIdentifierOut) {
-      *processIdentifierOut = -1;
+  // The subprocesses of launchd_sim are obtained in a single syscall, which is far cheaper than spawning launchctl.
+  // If they haven't changed since the last Service Table was fetched, the Service Table is current.
+  FBProcessInfo *launchdSim = self.simulator.launchdProcess;
+  NSSet<NSNumber *> *subprocesses = launchdSim
+    ? [[self.simulator.processFetcher.processFetcher subprocessIdentifiersOf:launchdSim.processIdentifier] setByAddingObject:@(launchdSim.processIdentifier)]
+    : [NSSet set];
+
+  @synchronized (self) {
+    FBFuture<FBLaunchCtlServiceTable *> *future = self.serviceTableFuture;
+    FBFutureState state = future.state;
+    // launchctl is itself a subprocess of launchd_sim, so a fetch that is in flight is joined regardless of the subprocesses.
+    if (state == FBFutureStateRunning) {
+      return future;
     }
-    return serviceName;
+    if (state == FBFutureStateDone
+      && CFAbsoluteTimeGetCurrent() - self.serviceTableTime <= FBSimulatorLaunchCtlServiceTableMaximumAge
+      && [self.serviceTableSubprocesses isEqualToSet:subprocesses]) {
+      return future;
+    }
+    future = [[self
+      runWithArguments:@[@"list"]]
+      onQueue:self.simulator.asyncQueue fmap:^(NSString *text) {
+        NSError *error = nil;
+        FBLaunchCtlServiceTable *table = [FBLaunchCtlServiceTable tableFromListOutput:text error:&error];
+        if (!table) {
+          return [FBSimulatorError failFutureWithError:error];
+        }
+        return [FBFuture futureWithResult:table];
+      }];
+    self.serviceTableFuture = future;
+    self.serviceTableSubprocesses = subprocesses;
+    self.serviceTableTime = CFAbsoluteTimeGetCurrent();
+    return future;
   }
+}
 
-  NSInteger processIdentifierInteger = [processIdentifierString integerValue];
-  if (processIdentifierInteger < 1) {
-    return [[FBSimulatorError
-      describeFormat:@"Expected a process identifier as first word, but got %@ from %@", processIdentifierString, [FBCollectionInformation oneLineDescriptionFromArray:words]]
-      fail:error];
-  }
-  if (processIdentifierOut) {
-    *processIdentifierOut = (pid_t) processIdentifierInteger;
+- (void)invalidateServiceTable
+{
+  @synchronized (self) {
+    self.serviceTableFuture = nil;
+    self.serviceTableSubprocesses = nil;
   }
-
-  return serviceName;
 }
 
 - (FBFuture<NSString *> *)runWithArguments:(NSArray<NSString *> *)arguments
@@ -77,20 +77,27 @@
 
 - (FBFuture<FBSimulatorBitmapStream *> *)createStreamWithConfiguration:(FBBitmapStreamConfiguration *)configuration
 {
-  if (![configuration.encoding isEqualToString:FBBitmapStreamEncodingBGRA]) {
+  FBBitmapStreamEncoding encoding = configuration.encoding;
+  if (![encoding isEqualToString:FBBitmapStreamEncodingBGRA] && ![encoding isEqualToString:FBBitmapStreamEncodingBGRADelta]) {
     return [[FBSimulatorError
-      describe:@"Only BGRA is supported for simulators."]
+      describe:@"Only BGRA and BGRA Delta are supported for simulators."]
       failFuture];
   }
   id<FBControlCoreLogger> logger = self.simulator.logger;
   return [[self.simulator
     connectToFramebuffer]
-    onQueue:self.simulator.workQueue map:^(FBFramebuffer *framebuffer) {
+    onQueue:self.simulator.workQueue fmap:^ FBFuture<FBSimulatorBitmapStream *> * (FBFramebuffer *framebuffer) {
+      // Without damage rects every frame after a keyframe would be empty, so the picture would only change on keyframes.
+      if ([encoding isEqualToString:FBBitmapStreamEncodingBGRADelta] && !framebuffer.reportsDamageRects) {
+        return [[FBSimulatorError
+          describeFormat:@"BGRA Delta is not supported for %@, as it does not report damage rects.", framebuffer]
+          failFuture];
+      }
       NSNumber *framesPerSecond = configuration.framesPerSecond;
       if (framesPerSecond) {
-        return [FBSimulatorBitmapStream eagerStreamWithFramebuffer:framebuffer framesPerSecond:framesPerSecond.unsignedIntegerValue logger:logger];
+        return [FBFuture futureWithResult:[FBSimulatorBitmapStream eagerStreamWithFramebuffer:framebuffer encoding:encoding framesPerSecond:framesPerSecond.unsignedIntegerValue logger:logger]];
       }
-      return [FBSimulatorBitmapStream lazyStreamWithFramebuffer:framebuffer logger:logger];
+      return [FBFuture futureWithResult:[FBSimulatorBitmapStream lazyStreamWithFramebuffer:framebuffer encoding:encoding logger:logger]];
     }];
 }
 
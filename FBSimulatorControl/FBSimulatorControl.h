@@ -12,6 +12,7 @@
 #import <FBSimulatorControl/FBAgentLaunchStrategy.h>
 #import <FBSimulatorControl/FBApplicationBundle+Simulator.h>
 #import <FBSimulatorControl/FBApplicationLaunchStrategy.h>
+#import <FBSimulatorControl/FBBitmapDeltaEncoder.h>
 #import <FBSimulatorControl/FBCompositeSimulatorEventSink.h>
 #import <FBSimulatorControl/FBContactsUpdateConfiguration.h>
 #import <FBSimulatorControl/FBCoreSimulatorNotifier.h>
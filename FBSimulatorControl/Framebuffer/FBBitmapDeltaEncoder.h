@@ -0,0 +1,110 @@
+/**
+ * Copyright (c) 2015-present, Facebook, Inc.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree. An additional grant
+ * of patent rights can be found in the PATENTS file in the same directory.
+ */
+
+#import <Foundation/Foundation.h>
+#import <CoreGraphics/CoreGraphics.h>
+
+NS_ASSUME_NONNULL_BEGIN
+
+/**
+ The Length of the Header at the start of each Delta Frame.
+ The header is: magic, flags, width, height, bytes per pixel and rect count, each a big-endian uint32.
+ */
+extern size_t const FBBitmapDeltaFrameHeaderLength;
+
+/**
+ The Length of the Header for each Rect in a Delta Frame.
+ The header is: x, y, width and height, each a big-endian uint32.
+ The rows of the rect follow, tightly packed without the source stride.
+ */
+extern size_t const FBBitmapDeltaRectHeaderLength;
+
+/**
+ Set in the flags of the Frame Header if the Frame is a Keyframe, containing the whole bitmap.
+ */
+extern uint32_t const FBBitmapDeltaFrameFlagKeyframe;
+
+/**
+ Encodes a sequence of Bitmaps, sending only the regions that have been damaged since the previous Frame.
+ A Keyframe containing the whole Bitmap is sent periodically, so that a consumer can join a stream at any point.
+
+ The Encoder operates on plain pixel memory, so is independent of the source of the bitmaps.
+ It is not thread-safe and should be used from a single queue.
+ */
+@interface FBBitmapDeltaEncoder : NSObject
+
+#pragma mark Initializers
+
+/**
+ The Designated Initializer.
+
+ @param keyframeInterval the maximum number of frames between keyframes. 0 means that keyframes are only sent when required.
+ @return a new Encoder.
+ */
++ (instancetype)encoderWithKeyframeInterval:(NSUInteger)keyframeInterval;
+
+#pragma mark Public Methods
+
+/**
+ Records a region of the bitmap that has changed since the last Frame.
+ Damage that overlaps, or is close to, existing damage is merged.
+
+ @param rect the damaged rect, in pixels.
+ */
+- (void)addDamageRect:(CGRect)rect;
+
+/**
+ Forces the next Frame to be a Keyframe.
+ This should be called when the underlying bitmap is replaced.
+ */
+- (void)requestKeyframe;
+
+/**
+ Encodes a Frame from the current contents of the bitmap, clearing all recorded damage.
+ If there is no damage, the Frame consists only of the Frame Header.
+
+ @param baseAddress the address of the first pixel.
+ @param width the width of the bitmap, in pixels.
+ @param height the height of the bitmap, in pixels.
+ @param bytesPerRow the stride of the bitmap.
+ @param bytesPerPixel the size of each pixel.
+ @return the encoded Frame.
+ */
+- (NSData *)encodeFrameWithBaseAddress:(const void *)baseAddress width:(size_t)width height:(size_t)height bytesPerRow:(size_t)bytesPerRow bytesPerPixel:(size_t)bytesPerPixel;
+
+/**
+ Applies an encoded Frame to a bitmap, as a consumer of the stream would.
+ The Frame is untrusted, so it is validated against the bitmap before any pixel is written.
+
+ @param frame the encoded Frame.
+ @param baseAddress the address of the first pixel of the bitmap to update.
+ @param width the width of the bitmap, in pixels.
+ @param height the height of the bitmap, in pixels.
+ @param bytesPerRow the stride of the bitmap.
+ @param bytesPerPixel the size of a pixel of the bitmap. Frames with a different pixel size are rejected.
+ @param error an error out for any error that occurs.
+ @return YES if the Frame was applied, NO otherwise.
+ */
++ (BOOL)applyFrame:(NSData *)frame toBaseAddress:(void *)baseAddress width:(size_t)width height:(size_t)height bytesPerRow:(size_t)bytesPerRow bytesPerPixel:(size_t)bytesPerPixel error:(NSError **)error;
+
+#pragma mark Properties
+
+/**
+ The damage that has been recorded since the last Frame, after merging.
+ */
+@property (nonatomic, copy, readonly) NSArray<NSValue *> *damageRects;
+
+/**
+ The number of Frames that have been encoded.
+ */
+@property (nonatomic, assign, readonly) NSUInteger frameCount;
+
+@end
+
+NS_ASSUME_NONNULL_END
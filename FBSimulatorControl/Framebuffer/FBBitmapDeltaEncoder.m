@@ -0,0 +1,254 @@
+/**
+ * Copyright (c) 2015-present, Facebook, Inc.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree. An additional grant
+ * of patent rights can be found in the PATENTS file in the same directory.
+ */
+
+#import "FBBitmapDeltaEncoder.h"
+
+#import <libkern/OSByteOrder.h>
+
+#import "FBSimulatorError.h"
+
+size_t const FBBitmapDeltaFrameHeaderLength = 24;
+size_t const FBBitmapDeltaRectHeaderLength = 16;
+uint32_t const FBBitmapDeltaFrameFlagKeyframe = 1 << 0;
+
+static uint32_t const FBBitmapDeltaFrameMagic = 0x46424446; // 'FBDF'
+
+// Above this many separate rects, the bounding rect is sent instead, as the per-rect overhead and scattered copies dominate.
+static NSUInteger const FBBitmapDeltaMaximumRects = 16;
+
+// Two rects are merged if their union is not much larger than the rects themselves.
+static CGFloat const FBBitmapDeltaMergeSlack = 1.25;
+
+static inline CGFloat FBBitmapDeltaArea(CGRect rect)
+{
+  return rect.size.width * rect.size.height;
+}
+
+static inline BOOL FBBitmapDeltaShouldMerge(CGRect left, CGRect right)
+{
+  if (CGRectIntersectsRect(left, right)) {
+    return YES;
+  }
+  CGRect unioned = CGRectUnion(left, right);
+  return FBBitmapDeltaArea(unioned) <= (FBBitmapDeltaArea(left) + FBBitmapDeltaArea(right)) * FBBitmapDeltaMergeSlack;
+}
+
+@interface FBBitmapDeltaEncoder ()
+
+@property (nonatomic, assign, readonly) NSUInteger keyframeInterval;
+@property (nonatomic, strong, readonly) NSMutableArray<NSValue *> *pendingDamage;
+@property (nonatomic, assign, readwrite) BOOL keyframeRequested;
+@property (nonatomic, assign, readwrite) NSUInteger framesSinceKeyframe;
+@property (nonatomic, assign, readwrite) size_t lastWidth;
+@property (nonatomic, assign, readwrite) size_t lastHeight;
+
+@end
+
+@implementation FBBitmapDeltaEncoder
+
+#pragma mark Initializers
+
++ (instancetype)encoderWithKeyframeInterval:(NSUInteger)keyframeInterval
+{
+  return [[self alloc] initWithKeyframeInterval:keyframeInterval];
+}
+
+- (instancetype)initWithKeyframeInterval:(NSUInteger)keyframeInterval
+{
+  self = [super init];
+  if (!self) {
+    return nil;
+  }
+
+  _keyframeInterval = keyframeInterval;
+  _pendingDamage = [NSMutableArray array];
+  _keyframeRequested = YES;
+  _framesSinceKeyframe = 0;
+  _frameCount = 0;
+
+  return self;
+}
+
+#pragma mark Public Methods
+
+- (void)addDamageRect:(CGRect)rect
+{
+  CGRect merged = CGRectIntegral(CGRectStandardize(rect));
+  if (CGRectIsEmpty(merged)) {
+    return;
+  }
+  // Merging can make a rect that should then be merged with one that was previously separate, so repeat until stable.
+  BOOL didMerge = YES;
+  while (didMerge) {
+    didMerge = NO;
+    for (NSUInteger index = 0; index < self.pendingDamage.count; index++) {
+      CGRect existing = self.pendingDamage[index].rectValue;
+      if (!FBBitmapDeltaShouldMerge(existing, merged)) {
+        continue;
+      }
+      merged = CGRectUnion(existing, merged);
+      [self.pendingDamage removeObjectAtIndex:index];
+      didMerge = YES;
+      break;
+    }
+  }
+  [self.pendingDamage addObject:[NSValue valueWithRect:merged]];
+
+  if (self.pendingDamage.count > FBBitmapDeltaMaximumRects) {
+    CGRect bounding = CGRectNull;
+    for (NSValue *value in self.pendingDamage) {
+      bounding = CGRectUnion(bounding, value.rectValue);
+    }
+    [self.pendingDamage removeAllObjects];
+    [self.pendingDamage addObject:[NSValue valueWithRect:bounding]];
+  }
+}
+
+- (void)requestKeyframe
+{
+  self.keyframeRequested = YES;
+}
+
+- (NSData *)encodeFrameWithBaseAddress:(const void *)baseAddress width:(size_t)width height:(size_t)height bytesPerRow:(size_t)bytesPerRow bytesPerPixel:(size_t)bytesPerPixel
+{
+  CGRect bounds = CGRectMake(0, 0, width, height);
+  BOOL keyframe = self.keyframeRequested
+    || width != self.lastWidth
+    || height != self.lastHeight
+    || (self.keyframeInterval > 0 && self.framesSinceKeyframe + 1 >= self.keyframeInterval);
+
+  // Clip the damage to the bitmap, discarding anything that falls outside it.
+  NSMutableArray<NSValue *> *rects = [NSMutableArray array];
+  size_t damagedPixels = 0;
+  if (!keyframe) {
+    for (NSValue *value in self.pendingDamage) {
+      CGRect rect = CGRectIntersection(value.rectValue, bounds);
+      if (CGRectIsEmpty(rect)) {
+        continue;
+      }
+      [rects addObject:[NSValue valueWithRect:rect]];
+      damagedPixels += (size_t) FBBitmapDeltaArea(rect);
+    }
+  }
+  // When everything is damaged a keyframe costs the same, and lets a consumer resynchronize.
+  if (keyframe || damagedPixels >= width * height) {
+    keyframe = YES;
+    [rects removeAllObjects];
+    [rects addObject:[NSValue valueWithRect:bounds]];
+    damagedPixels = width * height;
+  }
+  [self.pendingDamage removeAllObjects];
+
+  size_t length = FBBitmapDeltaFrameHeaderLength + (rects.count * FBBitmapDeltaRectHeaderLength) + (damagedPixels * bytesPerPixel);
+  NSMutableData *frame = [NSMutableData dataWithLength:length];
+  uint8_t *output = frame.mutableBytes;
+  OSWriteBigInt32(output, 0, FBBitmapDeltaFrameMagic);
+  OSWriteBigInt32(output, 4, keyframe ? FBBitmapDeltaFrameFlagKeyframe : 0);
+  OSWriteBigInt32(output, 8, (uint32_t) width);
+  OSWriteBigInt32(output, 12, (uint32_t) height);
+  OSWriteBigInt32(output, 16, (uint32_t) bytesPerPixel);
+  OSWriteBigInt32(output, 20, (uint32_t) rects.count);
+  output += FBBitmapDeltaFrameHeaderLength;
+
+  const uint8_t *input = baseAddress;
+  for (NSValue *value in rects) {
+    CGRect rect = value.rectValue;
+    size_t x = (size_t) CGRectGetMinX(rect);
+    size_t y = (size_t) CGRectGetMinY(rect);
+    size_t rectWidth = (size_t) CGRectGetWidth(rect);
+    size_t rectHeight = (size_t) CGRectGetHeight(rect);
+    OSWriteBigInt32(output, 0, (uint32_t) x);
+    OSWriteBigInt32(output, 4, (uint32_t) y);
+    OSWriteBigInt32(output, 8, (uint32_t) rectWidth);
+    OSWriteBigInt32(output, 12, (uint32_t) rectHeight);
+    output += FBBitmapDeltaRectHeaderLength;
+
+    size_t rowLength = rectWidth * bytesPerPixel;
+    if (rowLength == bytesPerRow) {
+      memcpy(output, input + (y * bytesPerRow), rowLength * rectHeight);
+      output += rowLength * rectHeight;
+      continue;
+    }
+    for (size_t row = y; row < y + rectHeight; row++) {
+      memcpy(output, input + (row * bytesPerRow) + (x * bytesPerPixel), rowLength);
+      output += rowLength;
+    }
+  }
+
+  self.keyframeRequested = NO;
+  self.framesSinceKeyframe = keyframe ? 0 : self.framesSinceKeyframe + 1;
+  self.lastWidth = width;
+  self.lastHeight = height;
+  _frameCount++;
+
+  return frame;
+}
+
++ (BOOL)applyFrame:(NSData *)frame toBaseAddress:(void *)baseAddress width:(size_t)width height:(size_t)height bytesPerRow:(size_t)bytesPerRow bytesPerPixel:(size_t)bytesPerPixel error:(NSError **)error
+{
+  const uint8_t *input = frame.bytes;
+  const uint8_t *end = input + frame.length;
+  if (frame.length < FBBitmapDeltaFrameHeaderLength || OSReadBigInt32(input, 0) != FBBitmapDeltaFrameMagic) {
+    return [[FBSimulatorError
+      describe:@"Frame does not start with a Delta Frame Header"]
+      failBool:error];
+  }
+  size_t frameWidth = OSReadBigInt32(input, 8);
+  size_t frameHeight = OSReadBigInt32(input, 12);
+  size_t frameBytesPerPixel = OSReadBigInt32(input, 16);
+  size_t rectCount = OSReadBigInt32(input, 20);
+  if (frameWidth != width || frameHeight != height) {
+    return [[FBSimulatorError
+      describeFormat:@"Frame of %zux%zu does not match the bitmap of %zux%zu", frameWidth, frameHeight, width, height]
+      failBool:error];
+  }
+  // The pixel size determines where each row is written, so it must match the bitmap rather than being trusted.
+  size_t rowBytes = 0;
+  if (frameBytesPerPixel == 0 || frameBytesPerPixel != bytesPerPixel || __builtin_mul_overflow(width, bytesPerPixel, &rowBytes) || rowBytes > bytesPerRow) {
+    return [[FBSimulatorError
+      describeFormat:@"Frame of %zu bytes per pixel does not match the bitmap of %zu bytes per pixel and %zu bytes per row", frameBytesPerPixel, bytesPerPixel, bytesPerRow]
+      failBool:error];
+  }
+  input += FBBitmapDeltaFrameHeaderLength;
+
+  uint8_t *output = baseAddress;
+  for (size_t index = 0; index < rectCount; index++) {
+    if ((size_t) (end - input) < FBBitmapDeltaRectHeaderLength) {
+      return [[FBSimulatorError
+        describeFormat:@"Frame is truncated in the header of rect %zu", index]
+        failBool:error];
+    }
+    size_t x = OSReadBigInt32(input, 0);
+    size_t y = OSReadBigInt32(input, 4);
+    size_t rectWidth = OSReadBigInt32(input, 8);
+    size_t rectHeight = OSReadBigInt32(input, 12);
+    input += FBBitmapDeltaRectHeaderLength;
+    size_t rowLength = rectWidth * bytesPerPixel;
+    size_t rectLength = 0;
+    if (x + rectWidth > width || y + rectHeight > height || __builtin_mul_overflow(rowLength, rectHeight, &rectLength) || (size_t) (end - input) < rectLength) {
+      return [[FBSimulatorError
+        describeFormat:@"Rect %zu of {%zu, %zu, %zu, %zu} is outside the bitmap or truncated", index, x, y, rectWidth, rectHeight]
+        failBool:error];
+    }
+    for (size_t row = y; row < y + rectHeight; row++) {
+      memcpy(output + (row * bytesPerRow) + (x * bytesPerPixel), input, rowLength);
+      input += rowLength;
+    }
+  }
+  return YES;
+}
+
+#pragma mark Properties
+
+- (NSArray<NSValue *> *)damageRects
+{
+  return [self.pendingDamage copy];
+}
+
+@end
@@ -104,6 +104,13 @@ NS_ASSUME_NONNULL_BEGIN
  */
 - (BOOL)isConsumerAttached:(id<FBFramebufferConsumer>)consumer;
 
+#pragma mark Properties
+
+/**
+ YES if attached consumers are told which areas of the surface have been damaged, NO if they are only told of new surfaces.
+ */
+@property (nonatomic, assign, readonly) BOOL reportsDamageRects;
+
 @end
 
 NS_ASSUME_NONNULL_END
@@ -237,6 +237,11 @@ static IOSurfaceRef extractSurfaceFromUnknown(id unknown)
   return [[self attachedConsumers] containsObject:consumer];
 }
 
+- (BOOL)reportsDamageRects
+{
+  return NO;
+}
+
 #pragma mark FBJSONSerialization
 
 - (id)jsonSerializableRepresentation
@@ -308,6 +313,11 @@ static IOSurfaceRef extractSurfaceFromUnknown(id unknown)
   }
 }
 
+- (BOOL)reportsDamageRects
+{
+  return YES;
+}
+
 - (CGRect)fullDamageRect
 {
   CGSize size = self.surface.displaySize;
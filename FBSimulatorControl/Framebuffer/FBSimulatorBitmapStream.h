@@ -38,6 +38,17 @@ NS_ASSUME_NONNULL_BEGIN
  */
 + (instancetype)lazyStreamWithFramebuffer:(FBFramebuffer *)framebuffer logger:(id<FBControlCoreLogger>)logger;
 
+/**
+ Constructs a Bitmap Stream.
+ Bitmaps will only be written when there is a new bitmap available.
+
+ @param framebuffer the framebuffer to get frames from.
+ @param encoding the encoding of the stream, either BGRA or BGRA Delta.
+ @param logger the logger to log to.
+ @return a new Bitmap Stream object.
+ */
++ (instancetype)lazyStreamWithFramebuffer:(FBFramebuffer *)framebuffer encoding:(FBBitmapStreamEncoding)encoding logger:(id<FBControlCoreLogger>)logger;
+
 /**
  Constructs a Bitmap Stream.
  Bitmaps will be written at an interval in seconds, regardless of whether the frame is new or not.
@@ -49,6 +60,19 @@ NS_ASSUME_NONNULL_BEGIN
  */
 + (instancetype)eagerStreamWithFramebuffer:(FBFramebuffer *)framebuffer framesPerSecond:(NSUInteger)framesPerSecond logger:(id<FBControlCoreLogger>)logger;
 
+/**
+ Constructs a Bitmap Stream.
+ Bitmaps will be written at an interval in seconds, regardless of whether the frame is new or not.
+ With the BGRA Delta encoding, damage between frames is merged and a keyframe is sent every second.
+
+ @param framebuffer the framebuffer to get frames from.
+ @param encoding the encoding of the stream, either BGRA or BGRA Delta.
+ @param framesPerSecond the number of frames to send per second.
+ @param logger the logger to log to.
+ @return a new Bitmap Stream object.
+ */
++ (instancetype)eagerStreamWithFramebuffer:(FBFramebuffer *)framebuffer encoding:(FBBitmapStreamEncoding)encoding framesPerSecond:(NSUInteger)framesPerSecond logger:(id<FBControlCoreLogger>)logger;
+
 @end
 
 NS_ASSUME_NONNULL_END
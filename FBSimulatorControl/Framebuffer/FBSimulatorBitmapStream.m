@@ -26,8 +26,15 @@
 #import <SimulatorKit/SimDisplayIOSurfaceRenderable-Protocol.h>
 #import <SimulatorKit/SimDisplayRenderable-Protocol.h>
 
+#import "FBBitmapDeltaEncoder.h"
 #import "FBSimulatorError.h"
 
+// A lazy stream has no frame rate to derive a keyframe interval from.
+static NSUInteger const FBSimulatorBitmapStreamLazyKeyframeInterval = 30;
+
+// The Framebuffer is BGRA. Rows may be padded beyond the width, so bytes-per-pixel cannot be derived from the row stride.
+static size_t const FBSimulatorBitmapStreamBGRABytesPerPixel = 4;
+
 static NSDictionary<NSString *, id> *FBBitmapStreamPixelBufferAttributesFromPixelBuffer(CVPixelBufferRef pixelBuffer);
 static NSDictionary<NSString *, id> *FBBitmapStreamPixelBufferAttributesFromPixelBuffer(CVPixelBufferRef pixelBuffer)
 {
@@ -56,7 +63,7 @@ static NSDictionary<NSString *, id> *FBBitmapStreamPixelBufferAttributesFromPixe
 @property (nonatomic, assign, readonly) uint64_t timeInterval;
 @property (nonatomic, strong, readwrite) FBDispatchSourceNotifier *timer;
 
-- (instancetype)initWithFramebuffer:(FBFramebuffer *)framebuffer writeQueue:(dispatch_queue_t)writeQueue timeInterval:(uint64_t)timeInterval logger:(id<FBControlCoreLogger>)logger;
+- (instancetype)initWithFramebuffer:(FBFramebuffer *)framebuffer writeQueue:(dispatch_queue_t)writeQueue encoder:(nullable FBBitmapDeltaEncoder *)encoder timeInterval:(uint64_t)timeInterval logger:(id<FBControlCoreLogger>)logger;
 
 @end
 
@@ -68,6 +75,7 @@ static NSDictionary<NSString *, id> *FBBitmapStreamPixelBufferAttributesFromPixe
 @property (nonatomic, strong, readonly) id<FBControlCoreLogger> logger;
 @property (nonatomic, strong, readonly) FBMutableFuture<NSNull *> *startFuture;
 @property (nonatomic, strong, readonly) FBMutableFuture<NSNull *> *stopFuture;
+@property (nonatomic, strong, nullable, readonly) FBBitmapDeltaEncoder *encoder;
 
 @property (nonatomic, strong, nullable, readwrite) id<FBDataConsumer> consumer;
 @property (nonatomic, assign, nullable, readwrite) CVPixelBufferRef pixelBuffer;
@@ -86,16 +94,36 @@ static NSDictionary<NSString *, id> *FBBitmapStreamPixelBufferAttributesFromPixe
 
 + (instancetype)lazyStreamWithFramebuffer:(FBFramebuffer *)framebuffer logger:(id<FBControlCoreLogger>)logger
 {
-  return [[FBSimulatorBitmapStream_Lazy alloc] initWithFramebuffer:framebuffer writeQueue:self.writeQueue logger:logger];
+  return [self lazyStreamWithFramebuffer:framebuffer encoding:FBBitmapStreamEncodingBGRA logger:logger];
+}
+
++ (instancetype)lazyStreamWithFramebuffer:(FBFramebuffer *)framebuffer encoding:(FBBitmapStreamEncoding)encoding logger:(id<FBControlCoreLogger>)logger
+{
+  FBBitmapDeltaEncoder *encoder = [self encoderForEncoding:encoding keyframeInterval:FBSimulatorBitmapStreamLazyKeyframeInterval];
+  return [[FBSimulatorBitmapStream_Lazy alloc] initWithFramebuffer:framebuffer writeQueue:self.writeQueue encoder:encoder logger:logger];
 }
 
 + (instancetype)eagerStreamWithFramebuffer:(FBFramebuffer *)framebuffer framesPerSecond:(NSUInteger)framesPerSecond logger:(id<FBControlCoreLogger>)logger;
+{
+  return [self eagerStreamWithFramebuffer:framebuffer encoding:FBBitmapStreamEncodingBGRA framesPerSecond:framesPerSecond logger:logger];
+}
+
++ (instancetype)eagerStreamWithFramebuffer:(FBFramebuffer *)framebuffer encoding:(FBBitmapStreamEncoding)encoding framesPerSecond:(NSUInteger)framesPerSecond logger:(id<FBControlCoreLogger>)logger
 {
   uint64_t timeInterval = NSEC_PER_SEC / framesPerSecond;
-  return [[FBSimulatorBitmapStream_Eager alloc] initWithFramebuffer:framebuffer writeQueue:self.writeQueue timeInterval:timeInterval logger:logger];
+  FBBitmapDeltaEncoder *encoder = [self encoderForEncoding:encoding keyframeInterval:framesPerSecond];
+  return [[FBSimulatorBitmapStream_Eager alloc] initWithFramebuffer:framebuffer writeQueue:self.writeQueue encoder:encoder timeInterval:timeInterval logger:logger];
+}
+
++ (nullable FBBitmapDeltaEncoder *)encoderForEncoding:(FBBitmapStreamEncoding)encoding keyframeInterval:(NSUInteger)keyframeInterval
+{
+  if (![encoding isEqualToString:FBBitmapStreamEncodingBGRADelta]) {
+    return nil;
+  }
+  return [FBBitmapDeltaEncoder encoderWithKeyframeInterval:keyframeInterval];
 }
 
-- (instancetype)initWithFramebuffer:(FBFramebuffer *)framebuffer writeQueue:(dispatch_queue_t)writeQueue logger:(id<FBControlCoreLogger>)logger
+- (instancetype)initWithFramebuffer:(FBFramebuffer *)framebuffer writeQueue:(dispatch_queue_t)writeQueue encoder:(nullable FBBitmapDeltaEncoder *)encoder logger:(id<FBControlCoreLogger>)logger
 {
   self = [super init];
   if (!self) {
@@ -107,6 +135,7 @@ static NSDictionary<NSString *, id> *FBBitmapStreamPixelBufferAttributesFromPixe
   _logger = logger;
   _startFuture = FBMutableFuture.future;
   _stopFuture = FBMutableFuture.future;
+  _encoder = encoder;
 
   return self;
 }
@@ -195,6 +224,7 @@ static NSDictionary<NSString *, id> *FBBitmapStreamPixelBufferAttributesFromPixe
 
 - (void)didReceiveDamageRect:(CGRect)rect
 {
+  [self.encoder addDamageRect:rect];
 }
 
 #pragma mark Private
@@ -223,11 +253,17 @@ static NSDictionary<NSString *, id> *FBBitmapStreamPixelBufferAttributesFromPixe
 
   // Get the Attributes
   NSDictionary<NSString *, id> *attributes = FBBitmapStreamPixelBufferAttributesFromPixelBuffer(buffer);
+  if (self.encoder) {
+    NSMutableDictionary<NSString *, id> *encodedAttributes = [attributes mutableCopy];
+    encodedAttributes[@"encoding"] = FBBitmapStreamEncodingBGRADelta;
+    attributes = [encodedAttributes copy];
+  }
   [self.logger logFormat:@"Mounting Surface with Attributes: %@", attributes];
 
-  // Swap the pixel buffers.
+  // Swap the pixel buffers. Deltas against the old buffer are meaningless, so start again from a keyframe.
   self.pixelBuffer = buffer;
   self.pixelBufferAttributes = attributes;
+  [self.encoder requestKeyframe];
 
   // Signal that we've started
   [self.startFuture resolveWithResult:NSNull.null];
@@ -240,9 +276,29 @@ static NSDictionary<NSString *, id> *FBBitmapStreamPixelBufferAttributesFromPixe
   if (!self.pixelBuffer || !self.consumer) {
     return;
   }
+  if (self.encoder) {
+    [FBSimulatorBitmapStream writeDeltaBitmap:self.pixelBuffer encoder:self.encoder consumer:self.consumer];
+    return;
+  }
   [FBSimulatorBitmapStream writeBitmap:self.pixelBuffer consumer:self.consumer];
 }
 
++ (void)writeDeltaBitmap:(CVPixelBufferRef)pixelBuffer encoder:(FBBitmapDeltaEncoder *)encoder consumer:(id<FBDataConsumer>)consumer
+{
+  CVPixelBufferLockBaseAddress(pixelBuffer, kCVPixelBufferLock_ReadOnly);
+
+  NSData *frame = [encoder
+    encodeFrameWithBaseAddress:CVPixelBufferGetBaseAddress(pixelBuffer)
+    width:CVPixelBufferGetWidth(pixelBuffer)
+    height:CVPixelBufferGetHeight(pixelBuffer)
+    bytesPerRow:CVPixelBufferGetBytesPerRow(pixelBuffer)
+    bytesPerPixel:FBSimulatorBitmapStreamBGRABytesPerPixel];
+
+  CVPixelBufferUnlockBaseAddress(pixelBuffer, kCVPixelBufferLock_ReadOnly);
+
+  [consumer consumeData:frame];
+}
+
 + (void)writeBitmap:(CVPixelBufferRef)pixelBuffer consumer:(id<FBDataConsumer>)consumer
 {
   CVPixelBufferLockBaseAddress(pixelBuffer, kCVPixelBufferLock_ReadOnly);
@@ -275,6 +331,7 @@ static NSDictionary<NSString *, id> *FBBitmapStreamPixelBufferAttributesFromPixe
 
 - (void)didReceiveDamageRect:(CGRect)rect
 {
+  [super didReceiveDamageRect:rect];
   [self pushFrame];
 }
 
@@ -282,9 +339,9 @@ static NSDictionary<NSString *, id> *FBBitmapStreamPixelBufferAttributesFromPixe
 
 @implementation FBSimulatorBitmapStream_Eager
 
-- (instancetype)initWithFramebuffer:(FBFramebuffer *)framebuffer writeQueue:(dispatch_queue_t)writeQueue timeInterval:(uint64_t)timeInterval logger:(id<FBControlCoreLogger>)logger
+- (instancetype)initWithFramebuffer:(FBFramebuffer *)framebuffer writeQueue:(dispatch_queue_t)writeQueue encoder:(nullable FBBitmapDeltaEncoder *)encoder timeInterval:(uint64_t)timeInterval logger:(id<FBControlCoreLogger>)logger
 {
-  self = [super initWithFramebuffer:framebuffer writeQueue:writeQueue logger:logger];
+  self = [super initWithFramebuffer:framebuffer writeQueue:writeQueue encoder:encoder logger:logger];
   if (!self) {
     return nil;
   }
@@ -35,6 +35,7 @@
 #import "FBSimulatorError.h"
 #import "FBSimulatorEventSink.h"
 #import "FBSimulatorHIDEvent.h"
+#import "FBSimulatorLaunchCtlCommands.h"
 #import "FBSimulatorLifecycleCommands.h"
 #import "FBSimulatorLogCommands.h"
 #import "FBSimulatorLoggingEventSink.h"
@@ -344,6 +345,7 @@
   dispatch_once(&onceToken, ^{
     statefulCommands = [NSSet setWithArray:@[
       FBSimulatorCrashLogCommands.class,
+      FBSimulatorLaunchCtlCommands.class,
       FBSimulatorLifecycleCommands.class,
       FBSimulatorScreenshotCommands.class,
       FBSimulatorVideoRecordingCommands.class,
@@ -22,6 +22,11 @@
 NSString *const FBSimulatorControlSimulatorLaunchEnvironmentSimulatorUDID = @"FBSIMULATORCONTROL_SIM_UDID";
 NSString *const FBSimulatorControlSimulatorLaunchEnvironmentDeviceSetPath = @"FBSIMULATORCONTROL_SIM_SET_PATH";
 
+/**
+ Queries that are made within this interval of each other share the same Process Table.
+ */
+static NSTimeInterval const FBSimulatorProcessFetcherProcessTableMaximumAge = 0.1;
+
 @implementation FBSimulatorProcessFetcher
 
 + (instancetype)fetcherWithProcessFetcher:(FBProcessFetcher *)processFetcher
@@ -96,7 +101,7 @@ NSString *const FBSimulatorControlSimulatorLaunchEnvironmentDeviceSetPath = @"FB
 
 - (NSArray<FBProcessInfo *> *)launchdProcesses
 {
-  return [self.processFetcher processesWithProcessName:@"launchd_sim"];
+  return [self.processTable processesWithProcessName:@"launchd_sim"];
 }
 
 - (NSDictionary<NSString *, FBProcessInfo *> *)launchdProcessesByUDIDs:(NSArray<NSString *> *)udids
@@ -147,7 +152,7 @@ NSString *const FBSimulatorControlSimulatorLaunchEnvironmentDeviceSetPath = @"FB
 
 - (NSArray<FBProcessInfo *> *)coreSimulatorServiceProcesses
 {
-  return [self.processFetcher processesWithLaunchPathSubstring:@"Contents/MacOS/com.apple.CoreSimulator.CoreSimulatorService"];
+  return [self.processTable processesWithLaunchPathSubstring:@"Contents/MacOS/com.apple.CoreSimulator.CoreSimulatorService"];
 }
 
 #pragma mark Predicates
@@ -179,8 +184,7 @@ NSString *const FBSimulatorControlSimulatorLaunchEnvironmentDeviceSetPath = @"FB
   // This is the safest way to know about other processes launched by FBSimulatorControl
   // since other processes could have launched with UDID arguments.
   return [NSPredicate predicateWithBlock:^ BOOL (FBProcessInfo *process, NSDictionary *_) {
-    NSSet *argumentSet = [NSSet setWithArray:process.environment.allKeys];
-    return [argumentSet containsObject:FBSimulatorControlSimulatorLaunchEnvironmentSimulatorUDID];
+    return [process environmentValueForKey:FBSimulatorControlSimulatorLaunchEnvironmentSimulatorUDID] != nil;
   }];
 }
 
@@ -191,12 +195,17 @@ NSString *const FBSimulatorControlSimulatorLaunchEnvironmentDeviceSetPath = @"FB
 
 #pragma mark Private
 
+- (FBProcessTable *)processTable
+{
+  return [self.processFetcher processTableWithMaximumAge:FBSimulatorProcessFetcherProcessTableMaximumAge];
+}
+
 + (nullable NSString *)udidForLaunchdSim:(FBProcessInfo *)process
 {
   if ([process.launchPath rangeOfString:@"launchd_sim"].location == NSNotFound) {
     return nil;
   }
-  NSString *udidContainingString = process.environment[@"XPC_SIMULATOR_LAUNCHD_NAME"];
+  NSString *udidContainingString = [process environmentValueForKey:@"XPC_SIMULATOR_LAUNCHD_NAME"];
   NSCharacterSet *characterSet = self.launchdSimEnvironmentVariableUDIDSplitCharacterSet;
   NSMutableSet<NSString *> *components = [NSMutableSet setWithArray:[udidContainingString componentsSeparatedByCharactersInSet:characterSet]];
   [components minusSet:self.launchdSimEnvironmentSubtractableComponents];
@@ -235,12 +244,12 @@ NSString *const FBSimulatorControlSimulatorLaunchEnvironmentDeviceSetPath = @"FB
 
 + (nullable NSString *)udidForSimulatorApplicationProcess:(FBProcessInfo *)process
 {
-  return process.environment[FBSimulatorControlSimulatorLaunchEnvironmentSimulatorUDID];
+  return [process environmentValueForKey:FBSimulatorControlSimulatorLaunchEnvironmentSimulatorUDID];
 }
 
 + (nullable NSString *)deviceSetPathForApplicationProcess:(FBProcessInfo *)process
 {
-  return process.environment[FBSimulatorControlSimulatorLaunchEnvironmentDeviceSetPath];
+  return [process environmentValueForKey:FBSimulatorControlSimulatorLaunchEnvironmentDeviceSetPath];
 }
 
 + (NSCharacterSet *)launchdSimEnvironmentVariableUDIDSplitCharacterSet
@@ -114,7 +114,7 @@
   // The Application must contain the FBSimulatorControlSimulatorLaunchEnvironmentSimulatorUDID key in the environment
   // This Environment Variable exists to allow interested parties to know the UDID of the Launched Simulator,
   // without having to inspect the Simulator Application's launchd_sim first.
-  NSString *udid = launchedProcess.environment[FBSimulatorControlSimulatorLaunchEnvironmentSimulatorUDID];
+  NSString *udid = [launchedProcess environmentValueForKey:FBSimulatorControlSimulatorLaunchEnvironmentSimulatorUDID];
   if (!udid) {
     return nil;
   }
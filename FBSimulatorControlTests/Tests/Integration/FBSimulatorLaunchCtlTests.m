@@ -0,0 +1,49 @@
+/**
+ * Copyright (c) 2015-present, Facebook, Inc.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree. An additional grant
+ * of patent rights can be found in the PATENTS file in the same directory.
+ */
+
+#import <XCTest/XCTest.h>
+
+#import <FBSimulatorControl/FBSimulatorControl.h>
+
+#import "FBSimulatorControlAssertions.h"
+#import "FBSimulatorControlTestCase.h"
+
+@interface FBSimulatorLaunchCtlCommands (Tests)
+
+- (FBFuture<FBLaunchCtlServiceTable *> *)serviceTable;
+
+@end
+
+@interface FBSimulatorLaunchCtlTests : FBSimulatorControlTestCase
+
+@end
+
+@implementation FBSimulatorLaunchCtlTests
+
+- (void)testQueriesThroughTheSimulatorShareOneServiceTable
+{
+  FBSimulator *simulator = [self assertObtainsBootedSimulator];
+
+  // The commands are memoized by the Simulator, so that the service table is shared between queries.
+  FBSimulatorLaunchCtlCommands *first = [simulator forwardingTargetForSelector:@selector(listServices)];
+  FBSimulatorLaunchCtlCommands *second = [simulator forwardingTargetForSelector:@selector(serviceNameForProcess:)];
+  XCTAssertTrue([first isKindOfClass:FBSimulatorLaunchCtlCommands.class]);
+  XCTAssertEqual(first, second);
+
+  NSError *error = nil;
+  NSDictionary<NSString *, id> *services = [[simulator listServices] awaitWithTimeout:FBControlCoreGlobalConfiguration.regularTimeout error:&error];
+  XCTAssertNil(error);
+  XCTAssertGreaterThan(services.count, 0u);
+
+  FBFuture<FBLaunchCtlServiceTable *> *table = [first serviceTable];
+  XCTAssertEqual(table, [second serviceTable]);
+  XCTAssertEqual(table.state, FBFutureStateDone);
+}
+
+@end
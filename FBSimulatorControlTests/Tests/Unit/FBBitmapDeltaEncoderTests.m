@@ -0,0 +1,259 @@
+/**
+ * Copyright (c) 2015-present, Facebook, Inc.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree. An additional grant
+ * of patent rights can be found in the PATENTS file in the same directory.
+ */
+
+#import <XCTest/XCTest.h>
+
+#import <FBSimulatorControl/FBSimulatorControl.h>
+
+#import <libkern/OSByteOrder.h>
+
+static size_t const BytesPerPixel = 4;
+
+/**
+ A Framebuffer in plain memory, standing in for a Simulator's IOSurface.
+ Rows are padded, as they are in a real surface.
+ */
+@interface FBBitmapDeltaEncoderTests_Framebuffer : NSObject
+
+@property (nonatomic, assign, readonly) size_t width;
+@property (nonatomic, assign, readonly) size_t height;
+@property (nonatomic, assign, readonly) size_t bytesPerRow;
+@property (nonatomic, strong, readonly) NSMutableData *data;
+
+@end
+
+@implementation FBBitmapDeltaEncoderTests_Framebuffer
+
+- (instancetype)initWithWidth:(size_t)width height:(size_t)height
+{
+  self = [super init];
+  if (!self) {
+    return nil;
+  }
+
+  _width = width;
+  _height = height;
+  _bytesPerRow = (width * BytesPerPixel) + 64;
+  _data = [NSMutableData dataWithLength:_bytesPerRow * height];
+
+  return self;
+}
+
+- (CGRect)fillRect:(CGRect)rect withValue:(uint8_t)value
+{
+  uint8_t *bytes = self.data.mutableBytes;
+  for (size_t row = (size_t) CGRectGetMinY(rect); row < (size_t) CGRectGetMaxY(rect); row++) {
+    memset(bytes + (row * self.bytesPerRow) + ((size_t) CGRectGetMinX(rect) * BytesPerPixel), value, (size_t) CGRectGetWidth(rect) * BytesPerPixel);
+  }
+  return rect;
+}
+
+- (NSData *)encodeWithEncoder:(FBBitmapDeltaEncoder *)encoder
+{
+  return [encoder encodeFrameWithBaseAddress:self.data.bytes width:self.width height:self.height bytesPerRow:self.bytesPerRow bytesPerPixel:BytesPerPixel];
+}
+
+- (BOOL)applyFrame:(NSData *)frame error:(NSError **)error
+{
+  return [FBBitmapDeltaEncoder applyFrame:frame toBaseAddress:self.data.mutableBytes width:self.width height:self.height bytesPerRow:self.bytesPerRow bytesPerPixel:BytesPerPixel error:error];
+}
+
+@end
+
+@interface FBBitmapDeltaEncoderTests : XCTestCase
+
+@property (nonatomic, strong, readwrite) FBBitmapDeltaEncoderTests_Framebuffer *source;
+@property (nonatomic, strong, readwrite) FBBitmapDeltaEncoderTests_Framebuffer *destination;
+
+@end
+
+@implementation FBBitmapDeltaEncoderTests
+
+- (void)setUp
+{
+  [super setUp];
+
+  self.source = [[FBBitmapDeltaEncoderTests_Framebuffer alloc] initWithWidth:64 height:48];
+  self.destination = [[FBBitmapDeltaEncoderTests_Framebuffer alloc] initWithWidth:64 height:48];
+}
+
++ (uint32_t)flagsOfFrame:(NSData *)frame
+{
+  return OSReadBigInt32(frame.bytes, 4);
+}
+
++ (uint32_t)rectCountOfFrame:(NSData *)frame
+{
+  return OSReadBigInt32(frame.bytes, 20);
+}
+
+- (void)assertAppliesFrame:(NSData *)frame
+{
+  NSError *error = nil;
+  XCTAssertTrue([self.destination applyFrame:frame error:&error]);
+  XCTAssertNil(error);
+  XCTAssertEqualObjects(self.destination.data, self.source.data);
+}
+
+- (void)testFirstFrameIsKeyframe
+{
+  FBBitmapDeltaEncoder *encoder = [FBBitmapDeltaEncoder encoderWithKeyframeInterval:0];
+  [self.source fillRect:CGRectMake(0, 0, 64, 48) withValue:0x11];
+  NSData *frame = [self.source encodeWithEncoder:encoder];
+
+  XCTAssertEqual([FBBitmapDeltaEncoderTests flagsOfFrame:frame], FBBitmapDeltaFrameFlagKeyframe);
+  XCTAssertEqual([FBBitmapDeltaEncoderTests rectCountOfFrame:frame], 1u);
+  XCTAssertEqual(frame.length, FBBitmapDeltaFrameHeaderLength + FBBitmapDeltaRectHeaderLength + (64 * 48 * BytesPerPixel));
+  [self assertAppliesFrame:frame];
+}
+
+- (void)testFrameWithoutDamageIsOnlyAHeader
+{
+  FBBitmapDeltaEncoder *encoder = [FBBitmapDeltaEncoder encoderWithKeyframeInterval:0];
+  [self assertAppliesFrame:[self.source encodeWithEncoder:encoder]];
+
+  NSData *frame = [self.source encodeWithEncoder:encoder];
+  XCTAssertEqual(frame.length, FBBitmapDeltaFrameHeaderLength);
+  XCTAssertEqual([FBBitmapDeltaEncoderTests flagsOfFrame:frame], 0u);
+  [self assertAppliesFrame:frame];
+}
+
+- (void)testDamagedRectsArePackedWithoutStride
+{
+  FBBitmapDeltaEncoder *encoder = [FBBitmapDeltaEncoder encoderWithKeyframeInterval:0];
+  [self assertAppliesFrame:[self.source encodeWithEncoder:encoder]];
+
+  [encoder addDamageRect:[self.source fillRect:CGRectMake(4, 4, 8, 2) withValue:0x22]];
+  [encoder addDamageRect:[self.source fillRect:CGRectMake(40, 30, 10, 10) withValue:0x33]];
+  NSData *frame = [self.source encodeWithEncoder:encoder];
+
+  XCTAssertEqual([FBBitmapDeltaEncoderTests flagsOfFrame:frame], 0u);
+  XCTAssertEqual([FBBitmapDeltaEncoderTests rectCountOfFrame:frame], 2u);
+  XCTAssertEqual(frame.length, FBBitmapDeltaFrameHeaderLength + (2 * FBBitmapDeltaRectHeaderLength) + (((8 * 2) + (10 * 10)) * BytesPerPixel));
+  [self assertAppliesFrame:frame];
+}
+
+- (void)testOverlappingDamageIsMerged
+{
+  FBBitmapDeltaEncoder *encoder = [FBBitmapDeltaEncoder encoderWithKeyframeInterval:0];
+  [encoder addDamageRect:CGRectMake(0, 0, 10, 10)];
+  [encoder addDamageRect:CGRectMake(40, 40, 4, 4)];
+  [encoder addDamageRect:CGRectMake(5, 5, 10, 10)];
+
+  NSArray<NSValue *> *expected = @[
+    [NSValue valueWithRect:CGRectMake(40, 40, 4, 4)],
+    [NSValue valueWithRect:CGRectMake(0, 0, 15, 15)],
+  ];
+  XCTAssertEqualObjects(encoder.damageRects, expected);
+}
+
+- (void)testExcessiveDamageIsCollapsedToBoundingRect
+{
+  FBBitmapDeltaEncoder *encoder = [FBBitmapDeltaEncoder encoderWithKeyframeInterval:0];
+  for (NSUInteger index = 0; index < 20; index++) {
+    [encoder addDamageRect:CGRectMake(index * 3, index * 2, 1, 1)];
+  }
+
+  NSArray<NSValue *> *expected = @[
+    [NSValue valueWithRect:CGRectMake(0, 0, 58, 39)],
+  ];
+  XCTAssertEqualObjects(encoder.damageRects, expected);
+}
+
+- (void)testDamageOutsideTheBitmapIsClipped
+{
+  FBBitmapDeltaEncoder *encoder = [FBBitmapDeltaEncoder encoderWithKeyframeInterval:0];
+  [self assertAppliesFrame:[self.source encodeWithEncoder:encoder]];
+
+  [encoder addDamageRect:[self.source fillRect:CGRectMake(60, 44, 4, 4) withValue:0x44]];
+  [encoder addDamageRect:CGRectMake(62, 46, 100, 100)];
+  NSData *frame = [self.source encodeWithEncoder:encoder];
+
+  XCTAssertEqual([FBBitmapDeltaEncoderTests rectCountOfFrame:frame], 1u);
+  [self assertAppliesFrame:frame];
+}
+
+- (void)testKeyframesAreSentPeriodicallyAndOnRequest
+{
+  FBBitmapDeltaEncoder *encoder = [FBBitmapDeltaEncoder encoderWithKeyframeInterval:3];
+  NSMutableArray<NSNumber *> *flags = [NSMutableArray array];
+  for (NSUInteger index = 0; index < 7; index++) {
+    if (index == 5) {
+      [encoder requestKeyframe];
+    }
+    [flags addObject:@([FBBitmapDeltaEncoderTests flagsOfFrame:[self.source encodeWithEncoder:encoder]])];
+  }
+
+  NSArray<NSNumber *> *expected = @[@1, @0, @0, @1, @0, @1, @0];
+  XCTAssertEqualObjects(flags, expected);
+}
+
+- (void)testRejectsFrameOfDifferentSize
+{
+  FBBitmapDeltaEncoder *encoder = [FBBitmapDeltaEncoder encoderWithKeyframeInterval:0];
+  NSData *frame = [self.source encodeWithEncoder:encoder];
+  FBBitmapDeltaEncoderTests_Framebuffer *other = [[FBBitmapDeltaEncoderTests_Framebuffer alloc] initWithWidth:32 height:48];
+
+  NSError *error = nil;
+  XCTAssertFalse([other applyFrame:frame error:&error]);
+  XCTAssertNotNil(error);
+}
+
+- (void)testRejectsFrameWithMalformedPixelSize
+{
+  // The header of a valid frame, followed by a single pixel rect at the end of the bitmap.
+  // The rect is in bounds, so only the pixel size of the frame prevents it from being written past the end of the row.
+  NSData *header = [[self.source encodeWithEncoder:[FBBitmapDeltaEncoder encoderWithKeyframeInterval:0]] subdataWithRange:NSMakeRange(0, FBBitmapDeltaFrameHeaderLength)];
+  for (NSNumber *bytesPerPixel in @[@0, @(BytesPerPixel / 2), @(BytesPerPixel * 2), @(self.destination.bytesPerRow * 2)]) {
+    NSMutableData *frame = [header mutableCopy];
+    [frame increaseLengthBy:FBBitmapDeltaRectHeaderLength + bytesPerPixel.unsignedIntegerValue];
+    uint8_t *bytes = frame.mutableBytes;
+    OSWriteBigInt32(bytes, 16, bytesPerPixel.unsignedIntValue);
+    OSWriteBigInt32(bytes, 20, 1);
+    OSWriteBigInt32(bytes, 24, (uint32_t) self.destination.width - 1);
+    OSWriteBigInt32(bytes, 28, (uint32_t) self.destination.height - 1);
+    OSWriteBigInt32(bytes, 32, 1);
+    OSWriteBigInt32(bytes, 36, 1);
+    memset(bytes + FBBitmapDeltaFrameHeaderLength + FBBitmapDeltaRectHeaderLength, 0xFF, bytesPerPixel.unsignedIntegerValue);
+    NSData *original = [self.destination.data copy];
+
+    NSError *error = nil;
+    XCTAssertFalse([self.destination applyFrame:frame error:&error]);
+    XCTAssertNotNil(error);
+    XCTAssertEqualObjects(self.destination.data, original);
+  }
+}
+
+#pragma mark Performance
+
+- (void)testMostlyStaticStreamThroughput
+{
+  // One second of a 30fps stream of a phone-sized display, where only a caret and a status bar clock change.
+  FBBitmapDeltaEncoderTests_Framebuffer *source = [[FBBitmapDeltaEncoderTests_Framebuffer alloc] initWithWidth:750 height:1334];
+  FBBitmapDeltaEncoder *encoder = [FBBitmapDeltaEncoder encoderWithKeyframeInterval:30];
+  NSUInteger framesPerSecond = 30;
+  __block size_t encodedBytes = 0;
+  __block NSUInteger seconds = 0;
+
+  [self measureBlock:^{
+    for (NSUInteger index = 0; index < framesPerSecond; index++) {
+      [encoder addDamageRect:[source fillRect:CGRectMake(200, 600, 4, 40) withValue:(index % 2) ? 0xFF : 0x00]];
+      if (index % 10 == 0) {
+        [encoder addDamageRect:[source fillRect:CGRectMake(330, 10, 90, 30) withValue:(uint8_t) index]];
+      }
+      encodedBytes += [source encodeWithEncoder:encoder].length;
+    }
+    seconds += 1;
+  }];
+
+  size_t rawBytes = source.data.length * framesPerSecond * seconds;
+  XCTAssertLessThan(encodedBytes, rawBytes / 10);
+}
+
+@end
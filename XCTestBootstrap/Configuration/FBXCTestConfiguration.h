@@ -146,7 +146,7 @@ extern FBXCTestType const FBXCTestTypeListTest;
 
 /**
  The test filter for which test to run.
- Format: <testClass>/<testMethod>
+ Format: <testClass>/<testMethod>, multiple tests are separated by a comma.
  */
 @property (nonatomic, copy, readonly, nullable) NSString *testFilter;
 
@@ -192,6 +192,7 @@ typedef NS_OPTIONS(NSUInteger, FBLogicTestMirrorLogs) {
 
 /**
  The Filter for Logic Tests.
+ Format: <testClass>/<testMethod>, multiple tests are separated by a comma.
  */
 @property (nonatomic, copy, nullable, readonly) NSString *testFilter;
 
@@ -24,7 +24,7 @@ NS_ASSUME_NONNULL_BEGIN
 @interface FBJSONTestReporter : NSObject <FBXCTestReporter>
 
 /**
- The Designated Initializer.
+ Creates a Reporter that buffers all events, writing them in -printReportWithError:
 
  @param testBundlePath the Test Bundle to Report for.
  @param testType the Test Type to Report for
@@ -33,6 +33,19 @@ NS_ASSUME_NONNULL_BEGIN
  */
 - (instancetype)initWithTestBundlePath:(NSString *)testBundlePath testType:(NSString *)testType logger:(nullable id<FBControlCoreLogger>)logger dataConsumer:(id<FBDataConsumer>)dataConsumer;
 
+/**
+ The Designated Initializer.
+ A streaming Reporter writes each event to the consumer as it arrives, so memory does not grow with the size of the run.
+ Only the state of the currently running test is retained, so that a crash can be reported by ending that test as a failure.
+
+ @param testBundlePath the Test Bundle to Report for.
+ @param testType the Test Type to Report for
+ @param logger the logger to log out-of-band information to.
+ @param dataConsumer the consumer of the output.
+ @param streaming YES if events should be written as they arrive, NO to buffer them until the end of the run.
+ */
+- (instancetype)initWithTestBundlePath:(NSString *)testBundlePath testType:(NSString *)testType logger:(nullable id<FBControlCoreLogger>)logger dataConsumer:(id<FBDataConsumer>)dataConsumer streaming:(BOOL)streaming;
+
 @end
 
 NS_ASSUME_NONNULL_END
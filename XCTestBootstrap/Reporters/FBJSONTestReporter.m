@@ -13,6 +13,9 @@
 
 static inline NSString *FBFullyFormattedXCTestName(NSString *className, NSString *methodName);
 
+static NSUInteger const FBJSONTestReporterInitialSerializationCapacity = 4096;
+static NSUInteger const FBJSONTestReporterMaximumSerializationCapacity = 1024 * 1024;
+
 @interface FBJSONTestReporter ()
 
 @property (nonatomic, strong, readonly) id<FBDataConsumer> dataConsumer;
@@ -22,8 +25,13 @@ static inline NSString *FBFullyFormattedXCTestName(NSString *className, NSString
 @property (nonatomic, copy, readonly) NSMutableArray<NSDictionary<NSString *, id> *> *events;
 @property (nonatomic, copy, readonly) NSMutableDictionary<NSString *, NSMutableArray<NSDictionary<NSString *, id> *> *> *xctestNameExceptionsMapping;
 @property (nonatomic, copy, readonly) NSMutableArray<NSString *> *pendingTestOutput;
+@property (nonatomic, strong, readonly) NSMutableData *serializationBuffer;
+@property (nonatomic, assign, readonly) BOOL streaming;
 
 @property (nonatomic, copy, readwrite) NSString *currentTestName;
+@property (nonatomic, copy, readwrite) NSString *currentTestClass;
+@property (nonatomic, copy, readwrite) NSString *currentTestMethod;
+@property (nonatomic, assign, readwrite) BOOL began;
 @property (nonatomic, assign, readwrite) BOOL finished;
 
 @end
@@ -31,6 +39,11 @@ static inline NSString *FBFullyFormattedXCTestName(NSString *className, NSString
 @implementation FBJSONTestReporter
 
 - (instancetype)initWithTestBundlePath:(NSString *)testBundlePath testType:(NSString *)testType logger:(id<FBControlCoreLogger>)logger dataConsumer:(id<FBDataConsumer>)dataConsumer
+{
+  return [self initWithTestBundlePath:testBundlePath testType:testType logger:logger dataConsumer:dataConsumer streaming:NO];
+}
+
+- (instancetype)initWithTestBundlePath:(NSString *)testBundlePath testType:(NSString *)testType logger:(id<FBControlCoreLogger>)logger dataConsumer:(id<FBDataConsumer>)dataConsumer streaming:(BOOL)streaming
 {
   self = [super init];
   if (!self) {
@@ -44,8 +57,11 @@ static inline NSString *FBFullyFormattedXCTestName(NSString *className, NSString
   _xctestNameExceptionsMapping = [NSMutableDictionary dictionary];
   _pendingTestOutput = [NSMutableArray array];
   _events = [NSMutableArray array];
+  _serializationBuffer = [NSMutableData dataWithLength:FBJSONTestReporterInitialSerializationCapacity];
+  _streaming = streaming;
 
   _currentTestName = nil;
+  _began = NO;
   _finished = NO;
 
   return self;
@@ -59,7 +75,13 @@ static inline NSString *FBFullyFormattedXCTestName(NSString *className, NSString
       errorMessage = [errorMessage stringByAppendingString:@". Crash occurred while this test was running: "];
       errorMessage = [errorMessage stringByAppendingString:_currentTestName];
     }
-    [self printEvent:[FBJSONTestReporter createOCUnitBeginEvent:self.testType testBundlePath:self.testBundlePath]];
+    // A streaming reporter will have already written the begin event, and the begin event of the running test, which is ended as a failure.
+    if (!self.streaming || !self.began) {
+      [self printEvent:[FBJSONTestReporter createOCUnitBeginEvent:self.testType testBundlePath:self.testBundlePath]];
+    }
+    if (self.streaming && _currentTestName) {
+      [self testCaseDidFinishForTestClass:_currentTestClass method:_currentTestMethod withStatus:FBTestReportStatusFailed duration:0];
+    }
     [self printEvent:[FBJSONTestReporter createOCUnitEndEvent:self.testType testBundlePath:self.testBundlePath message:errorMessage success:NO]];
     return [[FBXCTestError describe:errorMessage] failBool:error];
   }
@@ -74,14 +96,56 @@ static inline NSString *FBFullyFormattedXCTestName(NSString *className, NSString
 {
   NSMutableDictionary *mDictionary = dictionary.mutableCopy;
   mDictionary[@"timestamp"] = @([NSDate date].timeIntervalSince1970);
-  [_events addObject:mDictionary.copy];
+  [self recordEvent:mDictionary];
+}
+
+- (void)recordEvent:(NSDictionary *)event
+{
+  if (self.streaming) {
+    [self printEvent:event];
+    return;
+  }
+  [_events addObject:event.copy];
 }
 
 - (void)printEvent:(NSDictionary *)event
 {
-  NSData *data = [NSJSONSerialization dataWithJSONObject:event options:0 error:nil];
-  [self.dataConsumer consumeData:data];
-  [self.dataConsumer consumeData:[NSData dataWithBytes:"\n" length:1]];
+  NSData *line = [self lineForEvent:event];
+  if (!line) {
+    [self.logger logFormat:@"Could not serialize event %@", event];
+    return;
+  }
+  [self.dataConsumer consumeData:line];
+}
+
+- (nullable NSData *)lineForEvent:(NSDictionary *)event
+{
+  if (![NSJSONSerialization isValidJSONObject:event]) {
+    return nil;
+  }
+  // Serialize into a re-used buffer, growing it when an event does not fit.
+  // The line is then copied out once, with the newline, rather than allocating the JSON and the terminator separately.
+  NSMutableData *buffer = self.serializationBuffer;
+  while (YES) {
+    NSUInteger capacity = buffer.length - 1;
+    NSOutputStream *stream = [NSOutputStream outputStreamToBuffer:buffer.mutableBytes capacity:capacity];
+    [stream open];
+    NSInteger written = [NSJSONSerialization writeJSONObject:event toStream:stream options:0 error:nil];
+    [stream close];
+    if (written > 0) {
+      uint8_t *bytes = buffer.mutableBytes;
+      bytes[written] = '\n';
+      return [NSData dataWithBytes:bytes length:(NSUInteger) written + 1];
+    }
+    if (buffer.length >= FBJSONTestReporterMaximumSerializationCapacity) {
+      break;
+    }
+    buffer.length = buffer.length * 2;
+  }
+  // The buffer is not grown beyond the maximum, so larger events are serialized on their own.
+  NSMutableData *line = [[NSJSONSerialization dataWithJSONObject:event options:0 error:nil] mutableCopy];
+  [line appendBytes:"\n" length:1];
+  return line;
 }
 
 #pragma mark FBXCTestReporter
@@ -98,6 +162,7 @@ static inline NSString *FBFullyFormattedXCTestName(NSString *className, NSString
 
 - (void)didBeginExecutingTestPlan
 {
+  _began = YES;
   [self storeEvent:[FBJSONTestReporter createOCUnitBeginEvent:self.testType testBundlePath:self.testBundlePath]];
 }
 
@@ -110,6 +175,8 @@ static inline NSString *FBFullyFormattedXCTestName(NSString *className, NSString
 {
   NSString *xctestName = FBFullyFormattedXCTestName(testClass, method);
   _currentTestName = xctestName;
+  _currentTestClass = testClass;
+  _currentTestMethod = method;
   self.xctestNameExceptionsMapping[xctestName] = [NSMutableArray array];
   [self storeEvent:[FBJSONTestReporter beginTestCaseEvent:testClass testMethod:method]];
 }
@@ -123,6 +190,9 @@ static inline NSString *FBFullyFormattedXCTestName(NSString *className, NSString
 - (void)testCaseDidFinishForTestClass:(NSString *)testClass method:(NSString *)method withStatus:(FBTestReportStatus)status duration:(NSTimeInterval)duration
 {
   _currentTestName = nil;
+  _currentTestClass = nil;
+  _currentTestMethod = nil;
+  NSString *xctestName = FBFullyFormattedXCTestName(testClass, method);
   NSDictionary<NSString *, id> *event = [FBJSONTestReporter
     testCaseDidFinishForTestClass:testClass
     method:method
@@ -132,6 +202,7 @@ static inline NSString *FBFullyFormattedXCTestName(NSString *className, NSString
     xctestNameExceptionsMapping:self.xctestNameExceptionsMapping];
   [self storeEvent:event];
   [self.pendingTestOutput removeAllObjects];
+  [self.xctestNameExceptionsMapping removeObjectForKey:xctestName];
 }
 
 - (void)finishedWithSummary:(FBTestManagerResultSummary *)summary
@@ -191,6 +262,7 @@ static inline NSString *FBFullyFormattedXCTestName(NSString *className, NSString
   NSDictionary *event = [NSJSONSerialization JSONObjectWithData:[line dataUsingEncoding:NSUTF8StringEncoding] options:0 error:&error];
   if (event == nil) {
     [self.logger logFormat:@"Received unexpected output from otest-shim:\n%@", line];
+    return;
   }
   if ([event[@"event"] isEqualToString:@"end-test"]) {
     NSMutableDictionary *mutableEvent = event.mutableCopy;
@@ -198,7 +270,7 @@ static inline NSString *FBFullyFormattedXCTestName(NSString *className, NSString
     event = mutableEvent.copy;
     [self.pendingTestOutput removeAllObjects];
   }
-  [self.events addObject:event];
+  [self recordEvent:event];
 }
 
 #pragma mark Event Synthesis
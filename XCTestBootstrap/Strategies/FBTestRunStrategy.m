@@ -93,7 +93,7 @@
   }
 
   if (self.configuration.testFilter != nil) {
-    NSSet<NSString *> *testsToRun = [NSSet setWithObject:self.configuration.testFilter];
+    NSSet<NSString *> *testsToRun = [NSSet setWithArray:[self.configuration.testFilter componentsSeparatedByString:@","]];
     testLaunchConfiguration = [testLaunchConfiguration withTestsToRun:testsToRun];
   }
 
@@ -17,7 +17,7 @@
 #import "FBXCTestProcessExecutor.h"
 
 static NSTimeInterval const CrashLogStartDateFuzz = -20;
-static NSTimeInterval const CrashLogWaitTime = 180; // In case resources are pegged, just wait
+static NSTimeInterval const CrashLogWaitTime = 180; // An upper bound, in case resources are pegged. Resolves as soon as the crash log is ingested.
 static NSUInteger const SampleDuration = 1;
 static NSTimeInterval const SampleTimeoutSubtraction = SampleDuration + 1;
 
@@ -135,8 +135,9 @@ static NSTimeInterval const SampleTimeoutSubtraction = SampleDuration + 1;
     [FBCrashLogInfo predicateNewerThanDate:sinceDate],
   ]];
 
+  // The crash log may have been ingested before the exit of the process is observed, in which case there is no wait.
   return [[notifier
-    nextCrashLogForPredicate:predicate]
+    crashLogForPredicate:predicate]
     timeout:crashLogWaitTime waitingFor:@"Crash logs for terminated process %d to appear", processIdentifier];
 }
 
@@ -218,4 +218,79 @@
   XCTAssertEqualObjects(self[1][@"event"], @"end-ocunit");
 }
 
+- (void)testStreamingReporterWritesEventsAsTheyArrive
+{
+  self.reporter = [[FBJSONTestReporter alloc] initWithTestBundlePath:@"/path.bundle" testType:@"footype" logger:nil dataConsumer:self.consumer streaming:YES];
+  [self.reporter didBeginExecutingTestPlan];
+  XCTAssertEqual(self.lines.count, 1u);
+  XCTAssertEqualObjects(self[0][@"event"], @"begin-ocunit");
+
+  [self.reporter testCaseDidStartForTestClass:@"FooTest" method:@"BarCase"];
+  [self.reporter testHadOutput:@"Some Output For Foo"];
+  [self.reporter testCaseDidFailForTestClass:@"FooTest" method:@"BarCase" withMessage:@"BadBar" file:@"BadFile" line:42];
+  [self.reporter testCaseDidFinishForTestClass:@"FooTest" method:@"BarCase" withStatus:FBTestReportStatusFailed duration:1];
+  XCTAssertEqual(self.lines.count, 4u);
+  XCTAssertEqualObjects(self[1][@"event"], @"begin-test");
+  XCTAssertEqualObjects(self[2][@"event"], @"test-output");
+  XCTAssertEqualObjects(self[3][@"event"], @"end-test");
+  XCTAssertEqualObjects(self[3][@"output"], @"Some Output For Foo");
+  XCTAssertEqualObjects(self[3][@"exceptions"][0][@"reason"], @"BadBar");
+
+  [self.reporter didFinishExecutingTestPlan];
+  NSError *error = nil;
+  BOOL success = [self.reporter printReportWithError:&error];
+  XCTAssertTrue(success);
+  XCTAssertNil(error);
+
+  XCTAssertEqual(self.lines.count, 5u);
+  XCTAssertEqualObjects(self[4][@"event"], @"end-ocunit");
+  XCTAssertEqualObjects(self[4][@"succeeded"], @1);
+}
+
+- (void)testStreamingReporterSerializesEventsLargerThanTheBuffer
+{
+  self.reporter = [[FBJSONTestReporter alloc] initWithTestBundlePath:@"/path.bundle" testType:@"footype" logger:nil dataConsumer:self.consumer streaming:YES];
+  NSString *output = [@"" stringByPaddingToLength:64 * 1024 withString:@"Foo" startingAtIndex:0];
+  [self.reporter testHadOutput:output];
+  [self.reporter testHadOutput:@"Bar"];
+
+  XCTAssertEqual(self.lines.count, 2u);
+  XCTAssertEqualObjects(self[0][@"output"], output);
+  XCTAssertEqualObjects(self[1][@"output"], @"Bar");
+}
+
+- (void)testStreamingReporterSerializesEventsLargerThanTheMaximumBuffer
+{
+  self.reporter = [[FBJSONTestReporter alloc] initWithTestBundlePath:@"/path.bundle" testType:@"footype" logger:nil dataConsumer:self.consumer streaming:YES];
+  NSString *output = [@"" stringByPaddingToLength:2 * 1024 * 1024 withString:@"Foo" startingAtIndex:0];
+  [self.reporter testHadOutput:output];
+
+  XCTAssertEqual(self.lines.count, 1u);
+  XCTAssertEqualObjects(self[0][@"output"], output);
+}
+
+- (void)testStreamingReporterCrashIfNoDidFinish
+{
+  self.reporter = [[FBJSONTestReporter alloc] initWithTestBundlePath:@"/path.bundle" testType:@"footype" logger:nil dataConsumer:self.consumer streaming:YES];
+  [self.reporter didBeginExecutingTestPlan];
+  [self.reporter testCaseDidStartForTestClass:@"FooTest" method:@"BarCase"];
+  [self.reporter testHadOutput:@"Some Output For Foo"];
+  NSError *error = nil;
+  BOOL success = [self.reporter printReportWithError:&error];
+  XCTAssertFalse(success);
+  XCTAssertNotNil(error);
+
+  XCTAssertEqual(self.lines.count, 5u);
+  XCTAssertEqualObjects(self[0][@"event"], @"begin-ocunit");
+  XCTAssertEqualObjects(self[1][@"event"], @"begin-test");
+  XCTAssertEqualObjects(self[2][@"event"], @"test-output");
+  XCTAssertEqualObjects(self[3][@"event"], @"end-test");
+  XCTAssertEqualObjects(self[3][@"test"], @"-[FooTest BarCase]");
+  XCTAssertEqualObjects(self[3][@"output"], @"Some Output For Foo");
+  XCTAssertEqualObjects(self[3][@"succeeded"], @0);
+  XCTAssertEqualObjects(self[4][@"event"], @"end-ocunit");
+  XCTAssertEqualObjects(self[4][@"message"], @"No end-ocunit event was received, the test bundle has likely crashed. Crash occurred while this test was running: -[FooTest BarCase]");
+  XCTAssertEqualObjects(self[4][@"succeeded"], @0);
+}
+
 @end
@@ -1186,6 +1186,8 @@ struct FBBitmapStreamConfigurationParser {
           .ofFlag("h264", .H264, "Output in h264 format."),
         Parser<FBBitmapStreamEncoding>
           .ofFlag("bgra", .BGRA, "Output in BGRA format."),
+        Parser<FBBitmapStreamEncoding>
+          .ofFlag("bgra-delta", .BGRADelta, "Output in BGRA format, sending only the damaged regions of each frame."),
       ])
       .fallback(.BGRA)
     let fpsParser = Parser<NSNumber>
@@ -251,6 +251,7 @@ let validActions: [([String], Action)] = [
   (["stream", "--h264", "-"], Action.stream(FBBitmapStreamConfiguration(encoding: .H264, framesPerSecond: nil), .standardOut)),
   (["stream", "--fps=30", "-"], Action.stream(FBBitmapStreamConfiguration(encoding: .BGRA, framesPerSecond: 30), .standardOut)),
   (["stream", "--bgra", "--fps=25", "-"], Action.stream(FBBitmapStreamConfiguration(encoding: .BGRA, framesPerSecond: 25), .standardOut)),
+  (["stream", "--bgra-delta", "--fps=30", "-"], Action.stream(FBBitmapStreamConfiguration(encoding: .BGRADelta, framesPerSecond: 30), .standardOut)),
   (["stream", "--fps", "60", "/tmp/video.dump"], Action.stream(FBBitmapStreamConfiguration(encoding: .BGRA, framesPerSecond: 60), .path("/tmp/video.dump"))),
   (["terminate", "com.foo.bar"], .terminate("com.foo.bar")),
   (["uninstall", "com.foo.bar"], .uninstall("com.foo.bar")),
@@ -49,6 +49,15 @@ NS_ASSUME_NONNULL_BEGIN
  */
 + (instancetype)commandLineWithConfiguration:(FBXCTestConfiguration *)configuration destination:(FBXCTestDestination *)destination;
 
+/**
+ The Designated Initializer for a sharded test run.
+
+ @param configuration the configuration for the test run.
+ @param destination the destination to run against.
+ @param shardCount the number of Simulators to distribute the tests across.
+ */
++ (instancetype)commandLineWithConfiguration:(FBXCTestConfiguration *)configuration destination:(FBXCTestDestination *)destination shardCount:(NSUInteger)shardCount;
+
 #pragma mark Properties
 
 /**
@@ -61,6 +70,14 @@ NS_ASSUME_NONNULL_BEGIN
  */
 @property (nonatomic, strong, readonly) FBXCTestDestination *destination;
 
+#pragma mark Sharding
+
+/**
+ The number of Simulators that the tests are distributed across.
+ A value of 1 runs the whole test bundle on a single Simulator.
+ */
+@property (nonatomic, assign, readonly) NSUInteger shardCount;
+
 #pragma mark Timeouts
 
 /**
@@ -22,10 +22,15 @@ FBiOSTargetFutureType const FBiOSTargetFutureTypeFBXCTest = @"fbxctest";
 
 + (instancetype)commandLineWithConfiguration:(FBXCTestConfiguration *)configuration destination:(FBXCTestDestination *)destination
 {
-  return [[self alloc] initWithConfiguration:configuration destination:destination];
+  return [[self alloc] initWithConfiguration:configuration destination:destination shardCount:1];
 }
 
-- (instancetype)initWithConfiguration:(FBXCTestConfiguration *)configuration destination:(FBXCTestDestination *)destination
++ (instancetype)commandLineWithConfiguration:(FBXCTestConfiguration *)configuration destination:(FBXCTestDestination *)destination shardCount:(NSUInteger)shardCount
+{
+  return [[self alloc] initWithConfiguration:configuration destination:destination shardCount:shardCount];
+}
+
+- (instancetype)initWithConfiguration:(FBXCTestConfiguration *)configuration destination:(FBXCTestDestination *)destination shardCount:(NSUInteger)shardCount
 {
   self = [super init];
   if (!self) {
@@ -34,6 +39,7 @@ FBiOSTargetFutureType const FBiOSTargetFutureTypeFBXCTest = @"fbxctest";
 
   _configuration = configuration;
   _destination = destination;
+  _shardCount = MAX(shardCount, 1u);
 
   return self;
 }
@@ -57,7 +63,8 @@ FBiOSTargetFutureType const FBiOSTargetFutureTypeFBXCTest = @"fbxctest";
   NSString *testFilter = nil;
   NSString *testTargetPathOut = nil;
   BOOL waitForDebugger = NO;
-  if (![FBXCTestCommandLine loadWithArguments:arguments shimsOut:&shims testBundlePathOut:&testBundlePath runnerAppPathOut:&runnerAppPath testTargetPathOut:&testTargetPathOut testFilterOut:&testFilter waitForDebuggerOut:&waitForDebugger error:error]) {
+  NSUInteger shardCount = 1;
+  if (![FBXCTestCommandLine loadWithArguments:arguments shimsOut:&shims testBundlePathOut:&testBundlePath runnerAppPathOut:&runnerAppPath testTargetPathOut:&testTargetPathOut testFilterOut:&testFilter waitForDebuggerOut:&waitForDebugger shardCountOut:&shardCount error:error]) {
     return nil;
   }
   NSSet<NSString *> *argumentSet = [NSSet setWithArray:arguments];
@@ -126,10 +133,26 @@ FBiOSTargetFutureType const FBiOSTargetFutureTypeFBXCTest = @"fbxctest";
       describeFormat:@"Could not determine test runner type from %@", [FBCollectionInformation oneLineDescriptionFromArray:arguments]]
       fail:error];
   }
-  return [[FBXCTestCommandLine alloc] initWithConfiguration:configuration destination:destination];
+  if (shardCount > 1 && ![self canShardConfiguration:configuration destination:destination]) {
+    return [[FBXCTestError
+      describe:@"-shards is only supported for logic and application tests on an iPhone Simulator, without -waitForDebugger"]
+      fail:error];
+  }
+  return [[FBXCTestCommandLine alloc] initWithConfiguration:configuration destination:destination shardCount:shardCount];
 }
 
-+ (BOOL)loadWithArguments:(NSArray<NSString *> *)arguments shimsOut:(FBXCTestShimConfiguration **)shimsOut testBundlePathOut:(NSString **)testBundlePathOut runnerAppPathOut:(NSString **)runnerAppPathOut testTargetPathOut:(NSString **)testTargetPathOut testFilterOut:(NSString **)testFilterOut waitForDebuggerOut:(BOOL *)waitForDebuggerOut error:(NSError **)error
++ (BOOL)canShardConfiguration:(FBXCTestConfiguration *)configuration destination:(FBXCTestDestination *)destination
+{
+  if (![destination isKindOfClass:FBXCTestDestinationiPhoneSimulator.class] || configuration.waitForDebugger) {
+    return NO;
+  }
+  if ([configuration isKindOfClass:FBLogicTestConfiguration.class]) {
+    return YES;
+  }
+  return [configuration isKindOfClass:FBTestManagerTestConfiguration.class] && ((FBTestManagerTestConfiguration *) configuration).testTargetAppPath == nil;
+}
+
++ (BOOL)loadWithArguments:(NSArray<NSString *> *)arguments shimsOut:(FBXCTestShimConfiguration **)shimsOut testBundlePathOut:(NSString **)testBundlePathOut runnerAppPathOut:(NSString **)runnerAppPathOut testTargetPathOut:(NSString **)testTargetPathOut testFilterOut:(NSString **)testFilterOut waitForDebuggerOut:(BOOL *)waitForDebuggerOut shardCountOut:(NSUInteger *)shardCountOut error:(NSError **)error
 {
   NSUInteger nextArgument = 0;
   NSString *testFilter = nil;
@@ -204,6 +227,12 @@ FBiOSTargetFutureType const FBiOSTargetFutureTypeFBXCTest = @"fbxctest";
         return [[FBXCTestError describeFormat:@"Multiple -only options specified: %@, %@", testFilter, parameter] failBool:error];
       }
       testFilter = parameter;
+    } else if ([argument isEqualToString:@"-shards"]) {
+      NSInteger shardCount = parameter.integerValue;
+      if (shardCount < 1 || ![parameter isEqualToString:@(shardCount).stringValue]) {
+        return [[FBXCTestError describeFormat:@"-shards should be a positive integer: %@", parameter] failBool:error];
+      }
+      *shardCountOut = (NSUInteger) shardCount;
     } else {
       return [[FBXCTestError describeFormat:@"Unrecognized option: %@", argument] failBool:error];
     }
@@ -336,12 +365,14 @@ FBiOSTargetFutureType const FBiOSTargetFutureTypeFBXCTest = @"fbxctest";
   if (![object isKindOfClass:self.class]) {
     return NO;
   }
-  return [object.configuration isEqual:self.configuration] && [object.destination isEqual:self.destination];
+  return [object.configuration isEqual:self.configuration]
+      && [object.destination isEqual:self.destination]
+      && object.shardCount == self.shardCount;
 }
 
 - (NSUInteger)hash
 {
-  return self.configuration.hash ^ self.destination.hash;
+  return self.configuration.hash ^ self.destination.hash ^ self.shardCount;
 }
 
 #pragma mark Properties
@@ -26,7 +26,7 @@
 
 + (instancetype)contextWithReporter:(nullable id<FBXCTestReporter>)reporter logger:(nullable FBXCTestLogger *)logger
 {
-  return [[FBXCTestContext alloc] initWithReporter:reporter logger:logger];
+  return [[self alloc] initWithReporter:reporter logger:logger];
 }
 
 
@@ -11,3 +11,7 @@
 #import <FBXCTestKit/FBXCTestCommandLine.h>
 #import <FBXCTestKit/FBXCTestContext.h>
 #import <FBXCTestKit/FBXCTestDestination.h>
+#import <FBXCTestKit/FBXCTestDurationDatabase.h>
+#import <FBXCTestKit/FBXCTestShardReporter.h>
+#import <FBXCTestKit/FBXCTestShardScheduler.h>
+#import <FBXCTestKit/FBXCTestShardedRunner.h>
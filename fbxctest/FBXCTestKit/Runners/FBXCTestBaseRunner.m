@@ -20,6 +20,7 @@
 #import "FBXCTestContext.h"
 #import "FBXCTestCommandLine.h"
 #import "FBXCTestDestination.h"
+#import "FBXCTestShardedRunner.h"
 
 @interface FBXCTestBaseRunner ()
 
@@ -93,6 +94,9 @@
 
 - (FBFuture<NSNull *> *)runiOSTest
 {
+  if (self.commandLine.shardCount > 1) {
+    return [[FBXCTestShardedRunner runnerWithCommandLine:self.commandLine context:self.context] execute];
+  }
   return [[[self.context
     simulatorForCommandLine:self.commandLine]
     timeout:self.commandLine.testPreparationTimeout waitingFor:@"Simulator to be fetched for a test"]
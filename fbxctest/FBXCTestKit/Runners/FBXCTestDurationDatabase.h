@@ -0,0 +1,131 @@
+/**
+ * Copyright (c) 2015-present, Facebook, Inc.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree. An additional grant
+ * of patent rights can be found in the PATENTS file in the same directory.
+ */
+
+#import <Foundation/Foundation.h>
+
+#import <XCTestBootstrap/XCTestBootstrap.h>
+
+NS_ASSUME_NONNULL_BEGIN
+
+/**
+ The historical Durations and Outcomes of a single Test.
+ */
+@interface FBXCTestDurationStatistics : NSObject
+
+/**
+ The number of runs of the Test that finished.
+ */
+@property (nonatomic, assign, readonly) NSUInteger sampleCount;
+
+/**
+ The number of runs of the Test that finished with a failing status.
+ */
+@property (nonatomic, assign, readonly) NSUInteger failureCount;
+
+/**
+ The number of runs of the Test that started but did not finish, as the test process crashed or hung.
+ */
+@property (nonatomic, assign, readonly) NSUInteger unfinishedCount;
+
+/**
+ The number of runs of the Test that finished since the last run that did not finish.
+ Equal to the sampleCount if every run of the Test has finished.
+ */
+@property (nonatomic, assign, readonly) NSUInteger finishedCountSinceUnfinished;
+
+/**
+ The median duration of the finished runs of the Test.
+ */
+@property (nonatomic, assign, readonly) NSTimeInterval p50;
+
+/**
+ The 99th percentile duration of the finished runs of the Test.
+ */
+@property (nonatomic, assign, readonly) NSTimeInterval p99;
+
+@end
+
+/**
+ A persistent, append-only store of the Durations and Outcomes of Tests.
+ Records are fixed-size and binary, so that a store of millions of runs can be appended to cheaply and scanned through a memory map.
+ Tests are keyed by a 64-bit hash of the Bundle Name and Test Name; the store is a local cache, so it is in host byte-order.
+ Recorded runs are buffered until they are synchronized, at which point they are appended under an advisory lock, so that concurrent fbxctest processes may share a store.
+ The store is periodically compacted, retaining the most recent runs of each Test.
+ Durations are only recorded and used by sharded runs, which list their Tests before they are scheduled.
+ */
+@interface FBXCTestDurationDatabase : NSObject
+
+#pragma mark Initializers
+
+/**
+ The Designated Initializer.
+
+ @param path the path of the store. It will be created when it is first synchronized.
+ @param bundleName the name of the Test Bundle that Tests are recorded and queried for.
+ @return a new Database.
+ */
++ (instancetype)databaseAtPath:(NSString *)path bundleName:(NSString *)bundleName;
+
+/**
+ The path of the store that is used when one is not provided.
+ This is the value of 'FBXCTEST_TEST_DURATIONS_DATABASE_PATH' in the environment, if present.
+ */
+@property (nonatomic, copy, readonly, class) NSString *defaultPath;
+
+#pragma mark Properties
+
+/**
+ The path of the store.
+ */
+@property (nonatomic, copy, readonly) NSString *path;
+
+/**
+ The name of the Test Bundle that Tests are recorded and queried for.
+ */
+@property (nonatomic, copy, readonly) NSString *bundleName;
+
+#pragma mark Public Methods
+
+/**
+ Records a run of a Test. The run is not persisted until the Database is synchronized.
+
+ @param testName the name of the Test, in the form 'Class/method'.
+ @param status the status that the Test finished with, or FBTestReportStatusUnknown if the Test did not finish.
+ @param duration the duration of the Test.
+ */
+- (void)recordTest:(NSString *)testName status:(FBTestReportStatus)status duration:(NSTimeInterval)duration;
+
+/**
+ Appends the recorded runs to the store, compacting it if it has grown sufficiently since it was last compacted.
+
+ @param error an error out for any error that occurs.
+ @return YES if successful, NO otherwise.
+ */
+- (BOOL)synchronizeWithError:(NSError **)error;
+
+/**
+ Rewrites the store, retaining only the most recent runs of each Test.
+
+ @param error an error out for any error that occurs.
+ @return YES if successful, NO otherwise.
+ */
+- (BOOL)compactWithError:(NSError **)error;
+
+/**
+ Obtains the historical Statistics of Tests in a single scan of the store.
+
+ @param testNames the names of the Tests, in the form 'Class/method'.
+ @param error an error out for any error that occurs.
+ @return a mapping of Test Name to Statistics, for the Tests that have been recorded. nil if the store could not be read.
+ */
+- (nullable NSDictionary<NSString *, FBXCTestDurationStatistics *> *)statisticsForTestNames:(NSArray<NSString *> *)testNames error:(NSError **)error;
+
+@end
+
+NS_ASSUME_NONNULL_END
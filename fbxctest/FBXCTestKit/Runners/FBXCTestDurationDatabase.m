@@ -0,0 +1,564 @@
+/**
+ * Copyright (c) 2015-present, Facebook, Inc.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree. An additional grant
+ * of patent rights can be found in the PATENTS file in the same directory.
+ */
+
+#import "FBXCTestDurationDatabase.h"
+
+#include <errno.h>
+#include <fcntl.h>
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/file.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#import <FBControlCore/FBControlCore.h>
+
+static uint32_t const FBXCTestDurationDatabaseMagic = 0x44545846; // 'FXTD'
+static uint32_t const FBXCTestDurationDatabaseVersion = 1;
+
+/**
+ The number of the most recent runs of each Test that are retained when the store is compacted.
+ */
+static size_t const FBXCTestDurationDatabaseRetainedRuns = 64;
+
+/**
+ The store is compacted once it has this many times the records that it had after it was last compacted, so the cost of compaction is amortized over appends.
+ */
+static uint64_t const FBXCTestDurationDatabaseCompactionGrowth = 2;
+
+/**
+ The number of records below which the store is not compacted.
+ */
+static uint64_t const FBXCTestDurationDatabaseMinimumCompactionCount = 65536;
+
+typedef struct {
+  uint32_t magic;
+  uint32_t version;
+  uint64_t compactedRecordCount;
+} FBXCTestDurationHeader;
+
+// The key is the first member, so that records and keys can be sorted and searched with the same comparator.
+typedef struct {
+  uint64_t key;
+  float duration;
+  uint32_t timestamp;
+  uint32_t status;
+  uint32_t reserved;
+} FBXCTestDurationRecord;
+
+typedef struct {
+  uint64_t key;
+  size_t index;
+} FBXCTestDurationQuery;
+
+static uint64_t const FBXCTestDurationFNVOffset = 14695981039346656037ULL;
+static uint64_t const FBXCTestDurationFNVPrime = 1099511628211ULL;
+
+static uint64_t FBXCTestDurationDatabaseKey(NSString *bundleName, NSString *testName)
+{
+  uint64_t hash = FBXCTestDurationFNVOffset;
+  for (NSString *component in @[bundleName, testName]) {
+    const char *bytes = component.UTF8String;
+    for (size_t index = 0; bytes[index] != '\0'; index++) {
+      hash ^= (uint64_t) (uint8_t) bytes[index];
+      hash *= FBXCTestDurationFNVPrime;
+    }
+    // Hashing the terminator separates the components.
+    hash *= FBXCTestDurationFNVPrime;
+  }
+  return hash;
+}
+
+static int FBXCTestDurationKeyCompare(const void *left, const void *right)
+{
+  uint64_t lhs = *(const uint64_t *) left;
+  uint64_t rhs = *(const uint64_t *) right;
+  return lhs < rhs ? -1 : (lhs > rhs ? 1 : 0);
+}
+
+static int FBXCTestDurationCompare(const void *left, const void *right)
+{
+  float lhs = *(const float *) left;
+  float rhs = *(const float *) right;
+  return lhs < rhs ? -1 : (lhs > rhs ? 1 : 0);
+}
+
+static NSTimeInterval FBXCTestDurationPercentile(const float *sorted, size_t count, double percentile)
+{
+  // Nearest-rank, so that the percentile is always an observed duration.
+  size_t rank = (size_t) ceil(percentile * (double) count);
+  return sorted[MIN(MAX(rank, (size_t) 1), count) - 1];
+}
+
+static BOOL FBXCTestDurationWriteAll(int fileDescriptor, const void *bytes, size_t length, off_t offset)
+{
+  const uint8_t *remaining = bytes;
+  while (length > 0) {
+    ssize_t written = pwrite(fileDescriptor, remaining, length, offset);
+    if (written < 0 && errno == EINTR) {
+      continue;
+    }
+    if (written <= 0) {
+      return NO;
+    }
+    remaining += written;
+    length -= (size_t) written;
+    offset += written;
+  }
+  return YES;
+}
+
+@interface FBXCTestDurationStatistics ()
+
+- (instancetype)initWithSampleCount:(NSUInteger)sampleCount failureCount:(NSUInteger)failureCount unfinishedCount:(NSUInteger)unfinishedCount finishedCountSinceUnfinished:(NSUInteger)finishedCountSinceUnfinished p50:(NSTimeInterval)p50 p99:(NSTimeInterval)p99;
+
+@end
+
+@implementation FBXCTestDurationStatistics
+
+- (instancetype)initWithSampleCount:(NSUInteger)sampleCount failureCount:(NSUInteger)failureCount unfinishedCount:(NSUInteger)unfinishedCount finishedCountSinceUnfinished:(NSUInteger)finishedCountSinceUnfinished p50:(NSTimeInterval)p50 p99:(NSTimeInterval)p99
+{
+  self = [super init];
+  if (!self) {
+    return nil;
+  }
+
+  _sampleCount = sampleCount;
+  _failureCount = failureCount;
+  _unfinishedCount = unfinishedCount;
+  _finishedCountSinceUnfinished = finishedCountSinceUnfinished;
+  _p50 = p50;
+  _p99 = p99;
+
+  return self;
+}
+
+- (NSString *)description
+{
+  return [NSString stringWithFormat:
+    @"p50 %.3f | p99 %.3f | Samples %lu | Failures %lu | Unfinished %lu | Finished Since Unfinished %lu",
+    self.p50,
+    self.p99,
+    (unsigned long) self.sampleCount,
+    (unsigned long) self.failureCount,
+    (unsigned long) self.unfinishedCount,
+    (unsigned long) self.finishedCountSinceUnfinished
+  ];
+}
+
+@end
+
+@interface FBXCTestDurationDatabase ()
+
+@property (nonatomic, strong, readonly) NSMutableData *pendingRecords;
+
+@end
+
+@implementation FBXCTestDurationDatabase
+
+#pragma mark Initializers
+
++ (instancetype)databaseAtPath:(NSString *)path bundleName:(NSString *)bundleName
+{
+  return [[self alloc] initWithPath:path bundleName:bundleName];
+}
+
+- (instancetype)initWithPath:(NSString *)path bundleName:(NSString *)bundleName
+{
+  self = [super init];
+  if (!self) {
+    return nil;
+  }
+
+  _path = path;
+  _bundleName = bundleName;
+  _pendingRecords = [NSMutableData data];
+
+  return self;
+}
+
++ (NSString *)defaultPath
+{
+  NSString *path = NSProcessInfo.processInfo.environment[@"FBXCTEST_TEST_DURATIONS_DATABASE_PATH"];
+  if (path) {
+    return path;
+  }
+  NSString *cachesDirectory = NSSearchPathForDirectoriesInDomains(NSCachesDirectory, NSUserDomainMask, YES).firstObject ?: NSTemporaryDirectory();
+  return [[cachesDirectory
+    stringByAppendingPathComponent:@"com.facebook.fbxctest"]
+    stringByAppendingPathComponent:@"TestDurations.db"];
+}
+
+#pragma mark Public Methods
+
+- (void)recordTest:(NSString *)testName status:(FBTestReportStatus)status duration:(NSTimeInterval)duration
+{
+  FBXCTestDurationRecord record = {
+    .key = FBXCTestDurationDatabaseKey(self.bundleName, testName),
+    .duration = (float) MAX(duration, 0),
+    .timestamp = (uint32_t) NSDate.date.timeIntervalSince1970,
+    .status = (uint32_t) status,
+    .reserved = 0,
+  };
+  @synchronized (self) {
+    [self.pendingRecords appendBytes:&record length:sizeof(record)];
+  }
+}
+
+- (BOOL)synchronizeWithError:(NSError **)error
+{
+  NSData *pending = nil;
+  @synchronized (self) {
+    pending = [self.pendingRecords copy];
+    self.pendingRecords.length = 0;
+  }
+  if (pending.length == 0) {
+    return YES;
+  }
+
+  int fileDescriptor = -1;
+  if (![self openLockedFileDescriptor:&fileDescriptor error:error]) {
+    [self requeueRecords:pending];
+    return NO;
+  }
+  FBXCTestDurationHeader header;
+  off_t end = 0;
+  if (![self prepareLockedFileDescriptor:fileDescriptor header:&header end:&end error:error]) {
+    close(fileDescriptor);
+    [self requeueRecords:pending];
+    return NO;
+  }
+  if (!FBXCTestDurationWriteAll(fileDescriptor, pending.bytes, pending.length, end)) {
+    int code = errno;
+    close(fileDescriptor);
+    [self requeueRecords:pending];
+    return [[FBXCTestError
+      describeFormat:@"Could not append to test duration database %@: %s", self.path, strerror(code)]
+      failBool:error];
+  }
+
+  uint64_t recordCount = ((uint64_t) end - sizeof(FBXCTestDurationHeader) + pending.length) / sizeof(FBXCTestDurationRecord);
+  BOOL success = YES;
+  if (recordCount >= FBXCTestDurationDatabaseMinimumCompactionCount && recordCount >= header.compactedRecordCount * FBXCTestDurationDatabaseCompactionGrowth) {
+    success = [self compactLockedFileDescriptor:fileDescriptor error:error];
+  }
+  close(fileDescriptor);
+  return success;
+}
+
+- (BOOL)compactWithError:(NSError **)error
+{
+  int fileDescriptor = -1;
+  if (![self openLockedFileDescriptor:&fileDescriptor error:error]) {
+    return NO;
+  }
+  FBXCTestDurationHeader header;
+  off_t end = 0;
+  BOOL success = [self prepareLockedFileDescriptor:fileDescriptor header:&header end:&end error:error]
+    && [self compactLockedFileDescriptor:fileDescriptor error:error];
+  close(fileDescriptor);
+  return success;
+}
+
+- (nullable NSDictionary<NSString *, FBXCTestDurationStatistics *> *)statisticsForTestNames:(NSArray<NSString *> *)testNames error:(NSError **)error
+{
+  int fileDescriptor = open(self.path.fileSystemRepresentation, O_RDONLY | O_CLOEXEC);
+  if (fileDescriptor < 0 && errno == ENOENT) {
+    return @{};
+  }
+  if (fileDescriptor < 0) {
+    return [[FBXCTestError
+      describeFormat:@"Could not open test duration database %@: %s", self.path, strerror(errno)]
+      fail:error];
+  }
+
+  // The queried keys are sorted so that each record is matched with a binary search, in a single scan of the store.
+  size_t queryCount = testNames.count;
+  FBXCTestDurationQuery *queries = calloc(MAX(queryCount, (size_t) 1), sizeof(FBXCTestDurationQuery));
+  for (size_t index = 0; index < queryCount; index++) {
+    queries[index].key = FBXCTestDurationDatabaseKey(self.bundleName, testNames[index]);
+    queries[index].index = index;
+  }
+  qsort(queries, queryCount, sizeof(FBXCTestDurationQuery), FBXCTestDurationKeyCompare);
+
+  size_t *finishedCounts = calloc(MAX(queryCount, (size_t) 1), sizeof(size_t));
+  size_t *failureCounts = calloc(MAX(queryCount, (size_t) 1), sizeof(size_t));
+  size_t *unfinishedCounts = calloc(MAX(queryCount, (size_t) 1), sizeof(size_t));
+  size_t *finishedSinceUnfinishedCounts = calloc(MAX(queryCount, (size_t) 1), sizeof(size_t));
+  size_t *offsets = calloc(queryCount + 1, sizeof(size_t));
+  __block float *durations = NULL;
+
+  BOOL success = [self readRecordsFromFileDescriptor:fileDescriptor error:error usingBlock:^(const FBXCTestDurationRecord *records, size_t recordCount) {
+    // The first pass counts the runs of each Test, so that the durations can be gathered into a single allocation by the second.
+    // The runs of a Test are in the order they were recorded, as compaction preserves their order, so the runs since the last unfinished run are counted as they are scanned.
+    for (size_t index = 0; index < recordCount; index++) {
+      const FBXCTestDurationQuery *query = bsearch(&records[index].key, queries, queryCount, sizeof(FBXCTestDurationQuery), FBXCTestDurationKeyCompare);
+      if (!query) {
+        continue;
+      }
+      size_t position = (size_t) (query - queries);
+      if (records[index].status == FBTestReportStatusUnknown) {
+        unfinishedCounts[position]++;
+        finishedSinceUnfinishedCounts[position] = 0;
+        continue;
+      }
+      finishedCounts[position]++;
+      finishedSinceUnfinishedCounts[position]++;
+      failureCounts[position] += records[index].status == FBTestReportStatusFailed ? 1 : 0;
+    }
+    for (size_t position = 0; position < queryCount; position++) {
+      offsets[position + 1] = offsets[position] + finishedCounts[position];
+    }
+    durations = malloc(MAX(offsets[queryCount], (size_t) 1) * sizeof(float));
+    size_t *filled = calloc(MAX(queryCount, (size_t) 1), sizeof(size_t));
+    for (size_t index = 0; index < recordCount; index++) {
+      const FBXCTestDurationQuery *query = bsearch(&records[index].key, queries, queryCount, sizeof(FBXCTestDurationQuery), FBXCTestDurationKeyCompare);
+      if (!query || records[index].status == FBTestReportStatusUnknown) {
+        continue;
+      }
+      size_t position = (size_t) (query - queries);
+      durations[offsets[position] + filled[position]++] = records[index].duration;
+    }
+    free(filled);
+  }];
+  close(fileDescriptor);
+
+  NSMutableDictionary<NSString *, FBXCTestDurationStatistics *> *statistics = nil;
+  if (success) {
+    statistics = [NSMutableDictionary dictionary];
+    for (size_t position = 0; position < queryCount; position++) {
+      size_t finished = finishedCounts[position];
+      if (finished == 0 && unfinishedCounts[position] == 0) {
+        continue;
+      }
+      NSTimeInterval p50 = 0;
+      NSTimeInterval p99 = 0;
+      if (finished > 0) {
+        float *sorted = durations + offsets[position];
+        qsort(sorted, finished, sizeof(float), FBXCTestDurationCompare);
+        p50 = FBXCTestDurationPercentile(sorted, finished, 0.5);
+        p99 = FBXCTestDurationPercentile(sorted, finished, 0.99);
+      }
+      statistics[testNames[queries[position].index]] = [[FBXCTestDurationStatistics alloc]
+        initWithSampleCount:finished
+        failureCount:failureCounts[position]
+        unfinishedCount:unfinishedCounts[position]
+        finishedCountSinceUnfinished:finishedSinceUnfinishedCounts[position]
+        p50:p50
+        p99:p99];
+    }
+  }
+
+  free(durations);
+  free(offsets);
+  free(finishedSinceUnfinishedCounts);
+  free(unfinishedCounts);
+  free(failureCounts);
+  free(finishedCounts);
+  free(queries);
+  return [statistics copy];
+}
+
+#pragma mark Private
+
+- (void)requeueRecords:(NSData *)records
+{
+  @synchronized (self) {
+    [self.pendingRecords replaceBytesInRange:NSMakeRange(0, 0) withBytes:records.bytes length:records.length];
+  }
+}
+
+- (BOOL)openLockedFileDescriptor:(int *)fileDescriptorOut error:(NSError **)error
+{
+  NSString *directory = self.path.stringByDeletingLastPathComponent;
+  if (![NSFileManager.defaultManager createDirectoryAtPath:directory withIntermediateDirectories:YES attributes:nil error:error]) {
+    return NO;
+  }
+  while (YES) {
+    int fileDescriptor = open(self.path.fileSystemRepresentation, O_RDWR | O_CREAT | O_CLOEXEC, 0644);
+    if (fileDescriptor < 0) {
+      return [[FBXCTestError
+        describeFormat:@"Could not open test duration database %@: %s", self.path, strerror(errno)]
+        failBool:error];
+    }
+    if (flock(fileDescriptor, LOCK_EX) != 0) {
+      int code = errno;
+      close(fileDescriptor);
+      return [[FBXCTestError
+        describeFormat:@"Could not lock test duration database %@: %s", self.path, strerror(code)]
+        failBool:error];
+    }
+    // Another process may have compacted the store whilst the lock was awaited, in which case the replacement store is locked instead.
+    struct stat opened;
+    struct stat current;
+    if (fstat(fileDescriptor, &opened) == 0 && stat(self.path.fileSystemRepresentation, &current) == 0 && opened.st_dev == current.st_dev && opened.st_ino == current.st_ino) {
+      *fileDescriptorOut = fileDescriptor;
+      return YES;
+    }
+    close(fileDescriptor);
+  }
+}
+
+- (BOOL)prepareLockedFileDescriptor:(int)fileDescriptor header:(FBXCTestDurationHeader *)header end:(off_t *)endOut error:(NSError **)error
+{
+  struct stat info;
+  if (fstat(fileDescriptor, &info) != 0) {
+    return [[FBXCTestError
+      describeFormat:@"Could not stat test duration database %@: %s", self.path, strerror(errno)]
+      failBool:error];
+  }
+  if (info.st_size == 0) {
+    FBXCTestDurationHeader empty = {
+      .magic = FBXCTestDurationDatabaseMagic,
+      .version = FBXCTestDurationDatabaseVersion,
+      .compactedRecordCount = 0,
+    };
+    if (!FBXCTestDurationWriteAll(fileDescriptor, &empty, sizeof(empty), 0)) {
+      return [[FBXCTestError
+        describeFormat:@"Could not write the header of test duration database %@: %s", self.path, strerror(errno)]
+        failBool:error];
+    }
+    *header = empty;
+    *endOut = (off_t) sizeof(empty);
+    return YES;
+  }
+  if (![self readHeader:header fromFileDescriptor:fileDescriptor size:info.st_size]) {
+    // A file in another format, such as the JSON durations of an earlier fbxctest, is replaced rather than failing every run.
+    if (ftruncate(fileDescriptor, 0) != 0) {
+      return [[FBXCTestError
+        describeFormat:@"Could not replace test duration database %@: %s", self.path, strerror(errno)]
+        failBool:error];
+    }
+    return [self prepareLockedFileDescriptor:fileDescriptor header:header end:endOut error:error];
+  }
+  // A process that was interrupted whilst appending may have left a partial record, which is discarded.
+  off_t recordBytes = info.st_size - (off_t) sizeof(FBXCTestDurationHeader);
+  off_t end = info.st_size - (recordBytes % (off_t) sizeof(FBXCTestDurationRecord));
+  if (end != info.st_size && ftruncate(fileDescriptor, end) != 0) {
+    return [[FBXCTestError
+      describeFormat:@"Could not truncate test duration database %@: %s", self.path, strerror(errno)]
+      failBool:error];
+  }
+  *endOut = end;
+  return YES;
+}
+
+- (BOOL)readHeader:(FBXCTestDurationHeader *)header fromFileDescriptor:(int)fileDescriptor size:(off_t)size
+{
+  if (size < (off_t) sizeof(FBXCTestDurationHeader) || pread(fileDescriptor, header, sizeof(FBXCTestDurationHeader), 0) != (ssize_t) sizeof(FBXCTestDurationHeader)) {
+    return NO;
+  }
+  return header->magic == FBXCTestDurationDatabaseMagic && header->version == FBXCTestDurationDatabaseVersion;
+}
+
+- (BOOL)readRecordsFromFileDescriptor:(int)fileDescriptor error:(NSError **)error usingBlock:(void (^)(const FBXCTestDurationRecord *records, size_t recordCount))block
+{
+  struct stat info;
+  if (fstat(fileDescriptor, &info) != 0) {
+    return [[FBXCTestError
+      describeFormat:@"Could not stat test duration database %@: %s", self.path, strerror(errno)]
+      failBool:error];
+  }
+  if (info.st_size == 0) {
+    block(NULL, 0);
+    return YES;
+  }
+  // A file in another format has no records, it is replaced when the store is next synchronized.
+  FBXCTestDurationHeader header;
+  if (![self readHeader:&header fromFileDescriptor:fileDescriptor size:info.st_size]) {
+    block(NULL, 0);
+    return YES;
+  }
+  // Records that are appended after the size is obtained, or a partially appended record, are not read.
+  size_t length = (size_t) info.st_size;
+  size_t recordCount = (length - sizeof(FBXCTestDurationHeader)) / sizeof(FBXCTestDurationRecord);
+  if (recordCount == 0) {
+    block(NULL, 0);
+    return YES;
+  }
+  void *mapping = mmap(NULL, length, PROT_READ, MAP_PRIVATE, fileDescriptor, 0);
+  if (mapping == MAP_FAILED) {
+    return [[FBXCTestError
+      describeFormat:@"Could not map test duration database %@: %s", self.path, strerror(errno)]
+      failBool:error];
+  }
+  block((const FBXCTestDurationRecord *) ((const uint8_t *) mapping + sizeof(FBXCTestDurationHeader)), recordCount);
+  munmap(mapping, length);
+  return YES;
+}
+
+- (BOOL)compactLockedFileDescriptor:(int)fileDescriptor error:(NSError **)error
+{
+  __block FBXCTestDurationRecord *records = NULL;
+  __block size_t recordCount = 0;
+  BOOL success = [self readRecordsFromFileDescriptor:fileDescriptor error:error usingBlock:^(const FBXCTestDurationRecord *mapped, size_t mappedCount) {
+    records = malloc(MAX(mappedCount, (size_t) 1) * sizeof(FBXCTestDurationRecord));
+    if (mappedCount > 0) {
+      memcpy(records, mapped, mappedCount * sizeof(FBXCTestDurationRecord));
+    }
+    recordCount = mappedCount;
+  }];
+  if (!success) {
+    return NO;
+  }
+
+  // A stable sort groups the runs of each Test whilst preserving the order they were appended in, so the tail of each group is the most recent runs.
+  mergesort(records, recordCount, sizeof(FBXCTestDurationRecord), FBXCTestDurationKeyCompare);
+  size_t retainedCount = 0;
+  size_t groupStart = 0;
+  while (groupStart < recordCount) {
+    size_t groupEnd = groupStart;
+    while (groupEnd < recordCount && records[groupEnd].key == records[groupStart].key) {
+      groupEnd++;
+    }
+    size_t retained = MIN(groupEnd - groupStart, FBXCTestDurationDatabaseRetainedRuns);
+    memmove(records + retainedCount, records + groupEnd - retained, retained * sizeof(FBXCTestDurationRecord));
+    retainedCount += retained;
+    groupStart = groupEnd;
+  }
+
+  // The compacted store is written alongside, then atomically replaces the existing store.
+  NSString *temporaryPath = [self.path stringByAppendingString:@".XXXXXX"];
+  char *temporaryPathBuffer = strdup(temporaryPath.fileSystemRepresentation);
+  int temporaryFileDescriptor = mkstemp(temporaryPathBuffer);
+  if (temporaryFileDescriptor < 0) {
+    int code = errno;
+    free(temporaryPathBuffer);
+    free(records);
+    return [[FBXCTestError
+      describeFormat:@"Could not create a file to compact test duration database %@ into: %s", self.path, strerror(code)]
+      failBool:error];
+  }
+  FBXCTestDurationHeader header = {
+    .magic = FBXCTestDurationDatabaseMagic,
+    .version = FBXCTestDurationDatabaseVersion,
+    .compactedRecordCount = retainedCount,
+  };
+  success = FBXCTestDurationWriteAll(temporaryFileDescriptor, &header, sizeof(header), 0)
+    && FBXCTestDurationWriteAll(temporaryFileDescriptor, records, retainedCount * sizeof(FBXCTestDurationRecord), (off_t) sizeof(header))
+    && fchmod(temporaryFileDescriptor, 0644) == 0
+    && rename(temporaryPathBuffer, self.path.fileSystemRepresentation) == 0;
+  int code = errno;
+  close(temporaryFileDescriptor);
+  if (!success) {
+    unlink(temporaryPathBuffer);
+  }
+  free(temporaryPathBuffer);
+  free(records);
+  if (!success) {
+    return [[FBXCTestError
+      describeFormat:@"Could not compact test duration database %@: %s", self.path, strerror(code)]
+      failBool:error];
+  }
+  return YES;
+}
+
+@end
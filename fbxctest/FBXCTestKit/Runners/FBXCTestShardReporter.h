@@ -0,0 +1,84 @@
+/**
+ * Copyright (c) 2015-present, Facebook, Inc.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree. An additional grant
+ * of patent rights can be found in the PATENTS file in the same directory.
+ */
+
+#import <Foundation/Foundation.h>
+
+#import <XCTestBootstrap/XCTestBootstrap.h>
+
+NS_ASSUME_NONNULL_BEGIN
+
+/**
+ Records the events of a single Batch of a sharded test run.
+ Events are grouped by the Test that they belong to, so that the Batches of all Workers can be merged into a single ordered report.
+ Test Plan, Suite and Summary events are not recorded, as these are synthesized once for the merged report.
+ Events may be recorded on any queue, and read whilst they are being recorded.
+ */
+@interface FBXCTestShardReporter : NSObject <FBXCTestReporter>
+
+#pragma mark Initializers
+
+/**
+ The Designated Initializer.
+
+ @param queue the queue to call the handler on.
+ @param testFinished called with the name of each Test when it finishes, so that it can be reported without waiting for the Batch.
+ @return a new Shard Reporter.
+ */
++ (instancetype)reporterWithQueue:(dispatch_queue_t)queue testFinished:(void (^)(NSString *testName))testFinished;
+
+#pragma mark Properties
+
+/**
+ The names of the Tests that started, in the form 'Class/method', in the order that they started.
+ */
+@property (nonatomic, copy, readonly) NSArray<NSString *> *startedTests;
+
+/**
+ A mapping of Test Name to Duration for the Tests that finished.
+ */
+@property (nonatomic, copy, readonly) NSDictionary<NSString *, NSNumber *> *finishedTests;
+
+/**
+ The names of the Tests that finished with a failing status.
+ */
+@property (nonatomic, copy, readonly) NSSet<NSString *> *failedTests;
+
+/**
+ The error of a test process that crashed, if any.
+ */
+@property (nonatomic, strong, nullable, readonly) NSError *crashError;
+
+#pragma mark Public Methods
+
+/**
+ The duration of a Test, if it has finished.
+
+ @param testName the name of the Test, in the form 'Class/method'.
+ @return the duration of the Test, or nil if it has not finished.
+ */
+- (nullable NSNumber *)durationOfTest:(NSString *)testName;
+
+/**
+ Replays the recorded events of a Test to another reporter.
+
+ @param testName the name of the Test, in the form 'Class/method'.
+ @param reporter the reporter to replay to.
+ */
+- (void)replayTest:(NSString *)testName toReporter:(id<FBXCTestReporter>)reporter;
+
+/**
+ Replays the recorded events that do not belong to any Test to another reporter.
+
+ @param reporter the reporter to replay to.
+ */
+- (void)replayUnattributedEventsToReporter:(id<FBXCTestReporter>)reporter;
+
+@end
+
+NS_ASSUME_NONNULL_END
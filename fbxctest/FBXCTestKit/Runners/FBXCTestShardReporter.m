@@ -0,0 +1,304 @@
+/**
+ * Copyright (c) 2015-present, Facebook, Inc.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree. An additional grant
+ * of patent rights can be found in the PATENTS file in the same directory.
+ */
+
+#import "FBXCTestShardReporter.h"
+
+typedef void (^FBXCTestShardReporterEvent)(id<FBXCTestReporter> reporter);
+
+static inline NSString *FBXCTestShardReporterTestName(NSString *testClass, NSString *method)
+{
+  return [NSString stringWithFormat:@"%@/%@", testClass, method];
+}
+
+@interface FBXCTestShardReporter ()
+
+@property (nonatomic, strong, readonly) NSMutableArray<NSString *> *mutableStartedTests;
+@property (nonatomic, strong, readonly) NSMutableDictionary<NSString *, NSNumber *> *mutableFinishedTests;
+@property (nonatomic, strong, readonly) NSMutableSet<NSString *> *mutableFailedTests;
+@property (nonatomic, strong, readonly) NSMutableDictionary<NSString *, NSMutableArray<FBXCTestShardReporterEvent> *> *testEvents;
+@property (nonatomic, strong, readonly) NSMutableArray<FBXCTestShardReporterEvent> *unattributedEvents;
+@property (nonatomic, strong, nullable, readonly) dispatch_queue_t queue;
+@property (nonatomic, copy, nullable, readonly) void (^testFinished)(NSString *testName);
+
+@property (nonatomic, copy, nullable, readwrite) NSString *currentTest;
+@property (nonatomic, strong, nullable, readwrite) NSError *crashError;
+
+@end
+
+@implementation FBXCTestShardReporter
+
+#pragma mark Initializers
+
++ (instancetype)reporterWithQueue:(dispatch_queue_t)queue testFinished:(void (^)(NSString *testName))testFinished
+{
+  return [[self alloc] initWithQueue:queue testFinished:testFinished];
+}
+
+- (instancetype)init
+{
+  return [self initWithQueue:nil testFinished:nil];
+}
+
+- (instancetype)initWithQueue:(nullable dispatch_queue_t)queue testFinished:(nullable void (^)(NSString *testName))testFinished
+{
+  self = [super init];
+  if (!self) {
+    return nil;
+  }
+
+  _mutableStartedTests = [NSMutableArray array];
+  _mutableFinishedTests = [NSMutableDictionary dictionary];
+  _mutableFailedTests = [NSMutableSet set];
+  _testEvents = [NSMutableDictionary dictionary];
+  _unattributedEvents = [NSMutableArray array];
+  _queue = queue;
+  _testFinished = testFinished;
+
+  return self;
+}
+
+#pragma mark Properties
+
+- (NSArray<NSString *> *)startedTests
+{
+  @synchronized (self) {
+    return [self.mutableStartedTests copy];
+  }
+}
+
+- (NSDictionary<NSString *, NSNumber *> *)finishedTests
+{
+  @synchronized (self) {
+    return [self.mutableFinishedTests copy];
+  }
+}
+
+- (NSSet<NSString *> *)failedTests
+{
+  @synchronized (self) {
+    return [self.mutableFailedTests copy];
+  }
+}
+
+#pragma mark Public Methods
+
+- (nullable NSNumber *)durationOfTest:(NSString *)testName
+{
+  @synchronized (self) {
+    return self.mutableFinishedTests[testName];
+  }
+}
+
+- (void)replayTest:(NSString *)testName toReporter:(id<FBXCTestReporter>)reporter
+{
+  NSArray<FBXCTestShardReporterEvent> *events = nil;
+  @synchronized (self) {
+    events = [self.testEvents[testName] copy];
+  }
+  for (FBXCTestShardReporterEvent event in events) {
+    event(reporter);
+  }
+}
+
+- (void)replayUnattributedEventsToReporter:(id<FBXCTestReporter>)reporter
+{
+  NSArray<FBXCTestShardReporterEvent> *events = nil;
+  @synchronized (self) {
+    events = [self.unattributedEvents copy];
+  }
+  for (FBXCTestShardReporterEvent event in events) {
+    event(reporter);
+  }
+}
+
+#pragma mark Private
+
+- (nullable NSString *)currentTestName
+{
+  @synchronized (self) {
+    return self.currentTest;
+  }
+}
+
+- (void)recordEvent:(FBXCTestShardReporterEvent)event forTest:(nullable NSString *)testName
+{
+  @synchronized (self) {
+    if (!testName) {
+      [self.unattributedEvents addObject:event];
+      return;
+    }
+    NSMutableArray<FBXCTestShardReporterEvent> *events = self.testEvents[testName];
+    if (!events) {
+      events = [NSMutableArray array];
+      self.testEvents[testName] = events;
+    }
+    [events addObject:event];
+  }
+}
+
+#pragma mark FBXCTestReporter
+
+- (void)processWaitingForDebuggerWithProcessIdentifier:(pid_t)pid
+{
+  [self recordEvent:^(id<FBXCTestReporter> reporter) {
+    [reporter processWaitingForDebuggerWithProcessIdentifier:pid];
+  } forTest:nil];
+}
+
+- (void)debuggerAttached
+{
+  [self recordEvent:^(id<FBXCTestReporter> reporter) {
+    [reporter debuggerAttached];
+  } forTest:nil];
+}
+
+- (void)didBeginExecutingTestPlan
+{
+  // Synthesized once for the merged report.
+}
+
+- (void)didFinishExecutingTestPlan
+{
+  // Synthesized once for the merged report.
+}
+
+- (void)testSuite:(NSString *)testSuite didStartAt:(NSString *)startTime
+{
+  // Synthesized once for the merged report.
+}
+
+- (void)testCaseDidStartForTestClass:(NSString *)testClass method:(NSString *)method
+{
+  NSString *testName = FBXCTestShardReporterTestName(testClass, method);
+  @synchronized (self) {
+    self.currentTest = testName;
+    [self.mutableStartedTests addObject:testName];
+  }
+  [self recordEvent:^(id<FBXCTestReporter> reporter) {
+    [reporter testCaseDidStartForTestClass:testClass method:method];
+  } forTest:testName];
+}
+
+- (void)testCaseDidFailForTestClass:(NSString *)testClass method:(NSString *)method withMessage:(NSString *)message file:(NSString *)file line:(NSUInteger)line
+{
+  NSString *testName = FBXCTestShardReporterTestName(testClass, method);
+  [self recordEvent:^(id<FBXCTestReporter> reporter) {
+    [reporter testCaseDidFailForTestClass:testClass method:method withMessage:message file:file line:line];
+  } forTest:testName];
+}
+
+- (void)testCaseDidFinishForTestClass:(NSString *)testClass method:(NSString *)method withStatus:(FBTestReportStatus)status duration:(NSTimeInterval)duration
+{
+  NSString *testName = FBXCTestShardReporterTestName(testClass, method);
+  [self recordEvent:^(id<FBXCTestReporter> reporter) {
+    [reporter testCaseDidFinishForTestClass:testClass method:method withStatus:status duration:duration];
+  } forTest:testName];
+  // The Test is marked as finished once all of its events have been recorded, so that it is not replayed without them.
+  @synchronized (self) {
+    self.currentTest = nil;
+    if (status != FBTestReportStatusPassed) {
+      [self.mutableFailedTests addObject:testName];
+    }
+    self.mutableFinishedTests[testName] = @(duration);
+  }
+  void (^testFinished)(NSString *) = self.testFinished;
+  if (testFinished) {
+    dispatch_async(self.queue, ^{
+      testFinished(testName);
+    });
+  }
+}
+
+- (void)finishedWithSummary:(FBTestManagerResultSummary *)summary
+{
+  // Synthesized once for the merged report.
+}
+
+- (void)testHadOutput:(NSString *)output
+{
+  [self recordEvent:^(id<FBXCTestReporter> reporter) {
+    [reporter testHadOutput:output];
+  } forTest:[self currentTestName]];
+}
+
+- (void)handleExternalEvent:(NSString *)event
+{
+  [self recordEvent:^(id<FBXCTestReporter> reporter) {
+    [reporter handleExternalEvent:event];
+  } forTest:[self currentTestName]];
+}
+
+- (BOOL)printReportWithError:(NSError **)error
+{
+  // The merged report is printed by the reporter that the Batches are replayed to.
+  return YES;
+}
+
+- (void)testPlanDidFailWithMessage:(NSString *)message
+{
+  [self recordEvent:^(id<FBXCTestReporter> reporter) {
+    if ([reporter respondsToSelector:@selector(testPlanDidFailWithMessage:)]) {
+      [reporter testPlanDidFailWithMessage:message];
+    }
+  } forTest:nil];
+}
+
+- (void)testCase:(NSString *)testClass method:(NSString *)method willStartActivity:(FBActivityRecord *)activity
+{
+  [self recordEvent:^(id<FBXCTestReporter> reporter) {
+    if ([reporter respondsToSelector:@selector(testCase:method:willStartActivity:)]) {
+      [reporter testCase:testClass method:method willStartActivity:activity];
+    }
+  } forTest:FBXCTestShardReporterTestName(testClass, method)];
+}
+
+- (void)testCase:(NSString *)testClass method:(NSString *)method didFinishActivity:(FBActivityRecord *)activity
+{
+  [self recordEvent:^(id<FBXCTestReporter> reporter) {
+    if ([reporter respondsToSelector:@selector(testCase:method:didFinishActivity:)]) {
+      [reporter testCase:testClass method:method didFinishActivity:activity];
+    }
+  } forTest:FBXCTestShardReporterTestName(testClass, method)];
+}
+
+- (void)didRecordVideoAtPath:(NSString *)videoRecordingPath
+{
+  [self recordEvent:^(id<FBXCTestReporter> reporter) {
+    if ([reporter respondsToSelector:@selector(didRecordVideoAtPath:)]) {
+      [reporter didRecordVideoAtPath:videoRecordingPath];
+    }
+  } forTest:nil];
+}
+
+- (void)didSaveOSLogAtPath:(NSString *)osLogPath
+{
+  [self recordEvent:^(id<FBXCTestReporter> reporter) {
+    if ([reporter respondsToSelector:@selector(didSaveOSLogAtPath:)]) {
+      [reporter didSaveOSLogAtPath:osLogPath];
+    }
+  } forTest:nil];
+}
+
+- (void)didCopiedTestArtifact:(NSString *)testArtifactFilename toPath:(NSString *)path
+{
+  [self recordEvent:^(id<FBXCTestReporter> reporter) {
+    if ([reporter respondsToSelector:@selector(didCopiedTestArtifact:toPath:)]) {
+      [reporter didCopiedTestArtifact:testArtifactFilename toPath:path];
+    }
+  } forTest:nil];
+}
+
+- (void)didCrashDuringTest:(NSError *)error
+{
+  @synchronized (self) {
+    self.crashError = error;
+  }
+}
+
+@end
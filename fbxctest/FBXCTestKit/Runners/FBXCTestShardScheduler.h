@@ -0,0 +1,84 @@
+/**
+ * Copyright (c) 2015-present, Facebook, Inc.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree. An additional grant
+ * of patent rights can be found in the PATENTS file in the same directory.
+ */
+
+#import <Foundation/Foundation.h>
+
+NS_ASSUME_NONNULL_BEGIN
+
+/**
+ The maximum length in bytes of the comma-joined Test Names of a Batch.
+ */
+extern size_t const FBXCTestShardSchedulerMaximumFilterLength;
+
+/**
+ Distributes Tests across a number of Workers.
+ Tests are initially partitioned so that the estimated duration of each Worker is balanced, with the longest Tests run first.
+ A Worker that has exhausted its own Tests will steal the shortest remaining Tests from the Worker with the most remaining work.
+ This class is thread-safe, so that Workers may pull Batches concurrently.
+ */
+@interface FBXCTestShardScheduler : NSObject
+
+#pragma mark Initializers
+
+/**
+ The Designated Initializer.
+
+ @param testNames the names of the Tests to schedule, in the form 'Class/method'.
+ @param estimatedDurations a mapping of Test Name to the estimated duration of the Test.
+ @param defaultDuration the duration to use for a Test that has no estimate.
+ @param workerCount the number of Workers to distribute to. Must be greater than zero.
+ @return a new Scheduler.
+ */
++ (instancetype)schedulerWithTestNames:(NSArray<NSString *> *)testNames estimatedDurations:(NSDictionary<NSString *, NSNumber *> *)estimatedDurations defaultDuration:(NSTimeInterval)defaultDuration workerCount:(NSUInteger)workerCount;
+
+#pragma mark Properties
+
+/**
+ The number of Workers that are scheduled.
+ */
+@property (nonatomic, assign, readonly) NSUInteger workerCount;
+
+/**
+ The Tests that are initially assigned to each Worker.
+ */
+@property (nonatomic, copy, readonly) NSArray<NSArray<NSString *> *> *initialShards;
+
+#pragma mark Public Methods
+
+/**
+ Obtains the next Batch of Tests for a Worker to run.
+ A Batch is sized so that the launch of a test process is amortized over multiple Tests, whilst leaving Tests to be stolen.
+ The Test Names of a Batch are joined into a single filter, so a Batch is also limited to FBXCTestShardSchedulerMaximumFilterLength.
+
+ @param worker the index of the Worker.
+ @return the Tests to run, or nil if there is no work remaining for any Worker.
+ */
+- (nullable NSArray<NSString *> *)nextBatchForWorker:(NSUInteger)worker;
+
+/**
+ Stops scheduling Tests for a Worker that can no longer run them, such as one whose Simulator has failed.
+ The remaining Tests of the Worker, and the given Tests that it did not start, are stolen by the other Workers before any of their own.
+
+ @param worker the index of the Worker.
+ @param testNames the Tests that the Worker was given, but did not start.
+ @return YES if there are Workers remaining, NO if every Worker has been retired.
+ */
+- (BOOL)retireWorker:(NSUInteger)worker returningTestNames:(NSArray<NSString *> *)testNames;
+
+/**
+ Removes the Tests that have not been given to any Worker, so that they are no longer scheduled.
+ Used when every Worker has been retired, so that the remaining Tests can be reported as not run.
+
+ @return the Tests that had not been given to a Worker.
+ */
+- (NSArray<NSString *> *)removeRemainingTestNames;
+
+@end
+
+NS_ASSUME_NONNULL_END
@@ -0,0 +1,236 @@
+/**
+ * Copyright (c) 2015-present, Facebook, Inc.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree. An additional grant
+ * of patent rights can be found in the PATENTS file in the same directory.
+ */
+
+#import "FBXCTestShardScheduler.h"
+
+/**
+ The number of Batches that the initial work of each Worker is divided into.
+ Smaller Batches leave more work to steal, larger Batches launch fewer test processes.
+ */
+static NSUInteger const FBXCTestShardSchedulerBatchesPerWorker = 4;
+
+// The Test Names are passed to the test process as a single argument, which must fit within ARG_MAX alongside the environment.
+size_t const FBXCTestShardSchedulerMaximumFilterLength = 64 * 1024;
+
+@interface FBXCTestShardScheduler ()
+
+@property (nonatomic, copy, readonly) NSArray<NSString *> *testNames;
+@property (nonatomic, copy, readonly) NSArray<NSNumber *> *durations;
+@property (nonatomic, copy, readonly) NSArray<NSMutableArray<NSNumber *> *> *queues;
+@property (nonatomic, assign, readonly) NSTimeInterval batchDuration;
+@property (nonatomic, assign, readonly) NSTimeInterval *remainingDurations;
+@property (nonatomic, strong, readonly) NSMutableIndexSet *retiredWorkers;
+
+@end
+
+@implementation FBXCTestShardScheduler
+
+#pragma mark Initializers
+
++ (instancetype)schedulerWithTestNames:(NSArray<NSString *> *)testNames estimatedDurations:(NSDictionary<NSString *, NSNumber *> *)estimatedDurations defaultDuration:(NSTimeInterval)defaultDuration workerCount:(NSUInteger)workerCount
+{
+  NSParameterAssert(workerCount > 0);
+
+  NSMutableArray<NSNumber *> *durations = [NSMutableArray arrayWithCapacity:testNames.count];
+  NSTimeInterval totalDuration = 0;
+  for (NSString *testName in testNames) {
+    NSNumber *estimate = estimatedDurations[testName];
+    NSTimeInterval duration = estimate ? MAX(estimate.doubleValue, 0) : defaultDuration;
+    [durations addObject:@(duration)];
+    totalDuration += duration;
+  }
+
+  // Longest Processing Time first: the longest remaining Test goes to the Worker with the least work.
+  // Tests of equal duration keep the order in which they were listed.
+  NSArray<NSNumber *> *order = [[self indicesOfArray:testNames] sortedArrayWithOptions:NSSortStable usingComparator:^NSComparisonResult(NSNumber *left, NSNumber *right) {
+    return [durations[right.unsignedIntegerValue] compare:durations[left.unsignedIntegerValue]];
+  }];
+  NSMutableArray<NSMutableArray<NSNumber *> *> *queues = [NSMutableArray arrayWithCapacity:workerCount];
+  NSTimeInterval *remainingDurations = calloc(workerCount, sizeof(NSTimeInterval));
+  for (NSUInteger worker = 0; worker < workerCount; worker++) {
+    [queues addObject:[NSMutableArray array]];
+  }
+  for (NSNumber *index in order) {
+    NSUInteger leastLoaded = 0;
+    for (NSUInteger worker = 1; worker < workerCount; worker++) {
+      if (remainingDurations[worker] < remainingDurations[leastLoaded]) {
+        leastLoaded = worker;
+      }
+    }
+    [queues[leastLoaded] addObject:index];
+    remainingDurations[leastLoaded] += durations[index.unsignedIntegerValue].doubleValue;
+  }
+
+  NSTimeInterval batchDuration = totalDuration / (double) (workerCount * FBXCTestShardSchedulerBatchesPerWorker);
+  return [[self alloc] initWithTestNames:testNames durations:durations queues:queues remainingDurations:remainingDurations batchDuration:batchDuration];
+}
+
+- (instancetype)initWithTestNames:(NSArray<NSString *> *)testNames durations:(NSArray<NSNumber *> *)durations queues:(NSArray<NSMutableArray<NSNumber *> *> *)queues remainingDurations:(NSTimeInterval *)remainingDurations batchDuration:(NSTimeInterval)batchDuration
+{
+  self = [super init];
+  if (!self) {
+    return nil;
+  }
+
+  _testNames = [testNames copy];
+  _durations = [durations copy];
+  _queues = [queues copy];
+  _remainingDurations = remainingDurations;
+  _batchDuration = batchDuration;
+  _workerCount = queues.count;
+  _retiredWorkers = [NSMutableIndexSet indexSet];
+  _initialShards = [self namesForQueues:queues];
+
+  return self;
+}
+
+- (void)dealloc
+{
+  free(_remainingDurations);
+}
+
+#pragma mark Public Methods
+
+- (nullable NSArray<NSString *> *)nextBatchForWorker:(NSUInteger)worker
+{
+  NSParameterAssert(worker < self.workerCount);
+
+  @synchronized (self) {
+    if ([self.retiredWorkers containsIndex:worker]) {
+      return nil;
+    }
+    NSMutableArray<NSNumber *> *queue = self.queues[worker];
+    if (queue.count == 0 && ![self stealForWorker:worker]) {
+      return nil;
+    }
+    NSMutableArray<NSString *> *batch = [NSMutableArray array];
+    NSTimeInterval batchDuration = 0;
+    size_t filterLength = 0;
+    while (queue.count > 0 && (batch.count == 0 || batchDuration < self.batchDuration)) {
+      NSUInteger index = queue.firstObject.unsignedIntegerValue;
+      // The separating comma is counted with each Test Name, a single Test is always scheduled even if it is longer than the maximum.
+      size_t nameLength = [self.testNames[index] lengthOfBytesUsingEncoding:NSUTF8StringEncoding] + 1;
+      if (batch.count > 0 && filterLength + nameLength > FBXCTestShardSchedulerMaximumFilterLength) {
+        break;
+      }
+      filterLength += nameLength;
+      [queue removeObjectAtIndex:0];
+      NSTimeInterval duration = self.durations[index].doubleValue;
+      batchDuration += duration;
+      self.remainingDurations[worker] -= duration;
+      [batch addObject:self.testNames[index]];
+    }
+    return [batch copy];
+  }
+}
+
+- (BOOL)retireWorker:(NSUInteger)worker returningTestNames:(NSArray<NSString *> *)testNames
+{
+  NSParameterAssert(worker < self.workerCount);
+
+  @synchronized (self) {
+    [self.retiredWorkers addIndex:worker];
+    // The returned Tests were taken from the front of the queue, so are put back there.
+    NSMutableArray<NSNumber *> *queue = self.queues[worker];
+    NSUInteger position = 0;
+    for (NSString *testName in testNames) {
+      NSUInteger index = [self.testNames indexOfObject:testName];
+      if (index == NSNotFound) {
+        continue;
+      }
+      [queue insertObject:@(index) atIndex:position++];
+      self.remainingDurations[worker] += self.durations[index].doubleValue;
+    }
+    return self.retiredWorkers.count < self.workerCount;
+  }
+}
+
+- (NSArray<NSString *> *)removeRemainingTestNames
+{
+  @synchronized (self) {
+    NSMutableArray<NSString *> *testNames = [NSMutableArray array];
+    for (NSUInteger worker = 0; worker < self.workerCount; worker++) {
+      for (NSNumber *index in self.queues[worker]) {
+        [testNames addObject:self.testNames[index.unsignedIntegerValue]];
+      }
+      [self.queues[worker] removeAllObjects];
+      self.remainingDurations[worker] = 0;
+    }
+    return [testNames copy];
+  }
+}
+
+#pragma mark Private
+
+- (BOOL)stealForWorker:(NSUInteger)thief
+{
+  // The Tests of a retired Worker can only be run by stealing them, so they are taken before those of any other Worker.
+  NSUInteger victim = NSNotFound;
+  for (NSUInteger worker = 0; worker < self.workerCount; worker++) {
+    if (worker == thief || self.queues[worker].count == 0) {
+      continue;
+    }
+    BOOL retired = [self.retiredWorkers containsIndex:worker];
+    BOOL victimRetired = victim != NSNotFound && [self.retiredWorkers containsIndex:victim];
+    if (victim == NSNotFound || (retired && !victimRetired) || (retired == victimRetired && self.remainingDurations[worker] > self.remainingDurations[victim])) {
+      victim = worker;
+    }
+  }
+  if (victim == NSNotFound) {
+    return NO;
+  }
+
+  // Take the shortest Tests from the back of the victim's queue, up to half of its remaining work, or all of the work of a retired Worker.
+  // They are placed in the thief's queue longest first, which preserves the ordering of the queue.
+  NSMutableArray<NSNumber *> *victimQueue = self.queues[victim];
+  NSMutableArray<NSNumber *> *thiefQueue = self.queues[thief];
+  NSTimeInterval target = [self.retiredWorkers containsIndex:victim] ? INFINITY : self.remainingDurations[victim] / 2;
+  NSTimeInterval stolen = 0;
+  while (victimQueue.count > 0 && (thiefQueue.count == 0 || stolen < target)) {
+    NSNumber *index = victimQueue.lastObject;
+    [victimQueue removeLastObject];
+    NSTimeInterval duration = self.durations[index.unsignedIntegerValue].doubleValue;
+    stolen += duration;
+    self.remainingDurations[victim] -= duration;
+    self.remainingDurations[thief] += duration;
+    [thiefQueue insertObject:index atIndex:0];
+  }
+  return YES;
+}
+
+- (NSArray<NSArray<NSString *> *> *)namesForQueues:(NSArray<NSArray<NSNumber *> *> *)queues
+{
+  NSMutableArray<NSArray<NSString *> *> *shards = [NSMutableArray arrayWithCapacity:queues.count];
+  for (NSArray<NSNumber *> *queue in queues) {
+    NSMutableArray<NSString *> *names = [NSMutableArray arrayWithCapacity:queue.count];
+    for (NSNumber *index in queue) {
+      [names addObject:self.testNames[index.unsignedIntegerValue]];
+    }
+    [shards addObject:[names copy]];
+  }
+  return [shards copy];
+}
+
++ (NSArray<NSNumber *> *)indicesOfArray:(NSArray *)array
+{
+  NSMutableArray<NSNumber *> *indices = [NSMutableArray arrayWithCapacity:array.count];
+  for (NSUInteger index = 0; index < array.count; index++) {
+    [indices addObject:@(index)];
+  }
+  return indices;
+}
+
+#pragma mark NSObject
+
+- (NSString *)description
+{
+  return [NSString stringWithFormat:@"%lu Tests across %lu Workers", (unsigned long) self.testNames.count, (unsigned long) self.workerCount];
+}
+
+@end
@@ -0,0 +1,28 @@
+/**
+ * Copyright (c) 2015-present, Facebook, Inc.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree. An additional grant
+ * of patent rights can be found in the PATENTS file in the same directory.
+ */
+
+#import <FBXCTestKit/FBXCTestShardedRunner.h>
+
+NS_ASSUME_NONNULL_BEGIN
+
+@class FBSimulator;
+@class FBXCTestDurationDatabase;
+
+@interface FBXCTestShardedRunner ()
+
+- (instancetype)initWithCommandLine:(FBXCTestCommandLine *)commandLine context:(FBXCTestContext *)context database:(FBXCTestDurationDatabase *)database;
+
+- (FBFuture<NSArray<NSString *> *> *)listTestsOnSimulator:(FBSimulator *)simulator;
+- (FBFuture<NSNull *> *)runTestNames:(NSArray<NSString *> *)testNames batch:(NSUInteger)batch simulator:(FBSimulator *)simulator reporter:(id<FBXCTestReporter>)reporter;
+- (NSDictionary<NSString *, NSNumber *> *)loadTestDurationsForTestNames:(NSArray<NSString *> *)testNames;
+- (NSTimeInterval)timeoutForTestNames:(NSArray<NSString *> *)testNames;
+
+@end
+
+NS_ASSUME_NONNULL_END
@@ -0,0 +1,41 @@
+/**
+ * Copyright (c) 2015-present, Facebook, Inc.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree. An additional grant
+ * of patent rights can be found in the PATENTS file in the same directory.
+ */
+
+#import <Foundation/Foundation.h>
+
+#import <XCTestBootstrap/XCTestBootstrap.h>
+
+NS_ASSUME_NONNULL_BEGIN
+
+@class FBXCTestCommandLine;
+@class FBXCTestContext;
+
+/**
+ Runs a Logic or Application Test Bundle across multiple Simulators.
+ The Tests are listed once, then distributed across the Simulators by their historical durations.
+ Each Batch of Tests is timed out by the historical p99 durations of its Tests, rather than the configured timeout, so that a hang is detected early.
+ The results of all Simulators are merged into a single report, in the order that the Tests were listed.
+ Each Test is reported as soon as the Tests listed before it have been reported, so the report is streamed whilst the Tests run.
+ Tests that were not listed, and Tests that did not finish, are reported once all Simulators have finished.
+ */
+@interface FBXCTestShardedRunner : NSObject <FBXCTestRunner>
+
+#pragma mark Initializers
+
+/**
+ The Designated Initializer
+
+ @param commandLine the configuration from the commandline.
+ @param context the context to run with.
+ */
++ (instancetype)runnerWithCommandLine:(FBXCTestCommandLine *)commandLine context:(FBXCTestContext *)context;
+
+@end
+
+NS_ASSUME_NONNULL_END
@@ -0,0 +1,537 @@
+/**
+ * Copyright (c) 2015-present, Facebook, Inc.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree. An additional grant
+ * of patent rights can be found in the PATENTS file in the same directory.
+ */
+
+#import "FBXCTestShardedRunner.h"
+#import "FBXCTestShardedRunner+Private.h"
+
+#import <FBSimulatorControl/FBSimulatorControl.h>
+#import <FBControlCore/FBControlCore.h>
+#import <XCTestBootstrap/XCTestBootstrap.h>
+
+#import "FBXCTestCommandLine.h"
+#import "FBXCTestContext.h"
+#import "FBXCTestDurationDatabase.h"
+#import "FBXCTestShardReporter.h"
+#import "FBXCTestShardScheduler.h"
+
+/**
+ The duration that is assumed for a Test that has never been run, if no other Test in the Bundle has a duration.
+ */
+static NSTimeInterval const FBXCTestShardedRunnerDefaultTestDuration = 1;
+
+/**
+ A Batch is considered to have hung when it runs for longer than this multiple of the sum of the p99 durations of its Tests.
+ */
+static double const FBXCTestShardedRunnerHangMultiplier = 3;
+
+/**
+ The time allowed for launching the test process of a Batch, in addition to the durations of its Tests.
+ */
+static NSTimeInterval const FBXCTestShardedRunnerBatchLaunchAllowance = 60;
+
+/**
+ The number of runs that a Test must finish after failing to finish, before its Batches are timed out by its durations again.
+ */
+static NSUInteger const FBXCTestShardedRunnerRecoveredRunCount = 5;
+
+static NSString *const FBXCTestShardedRunnerSuiteName = @"Selected tests";
+
+@interface FBXCTestShardedRunner ()
+
+@property (nonatomic, strong, readonly) FBXCTestCommandLine *commandLine;
+@property (nonatomic, strong, readonly) FBXCTestContext *context;
+@property (nonatomic, strong, readonly) FBXCTestDurationDatabase *database;
+@property (nonatomic, copy, readwrite) NSDictionary<NSString *, FBXCTestDurationStatistics *> *statistics;
+@property (nonatomic, strong, readonly) NSMutableArray<FBXCTestShardReporter *> *batches;
+@property (nonatomic, strong, readonly) NSMutableArray<NSError *> *errors;
+@property (nonatomic, strong, readonly) NSMutableDictionary<NSNumber *, FBSimulator *> *idleWorkers;
+
+// The state of the merged report, which is only accessed on the main queue.
+@property (nonatomic, copy, readwrite) NSArray<NSString *> *listedTests;
+@property (nonatomic, strong, readonly) NSMutableDictionary<NSString *, FBXCTestShardReporter *> *scheduledBatches;
+@property (nonatomic, strong, readonly) NSMutableSet<FBXCTestShardReporter *> *completedBatches;
+@property (nonatomic, strong, readonly) NSMutableSet<NSString *> *reportedTests;
+@property (nonatomic, strong, nullable, readwrite) FBXCTestShardReporter *notRunBatch;
+@property (nonatomic, assign, readwrite) NSUInteger reportPosition;
+@property (nonatomic, assign, readwrite) NSInteger runCount;
+@property (nonatomic, assign, readwrite) NSInteger failureCount;
+@property (nonatomic, assign, readwrite) NSTimeInterval testDuration;
+
+@end
+
+@implementation FBXCTestShardedRunner
+
+#pragma mark Initializers
+
++ (instancetype)runnerWithCommandLine:(FBXCTestCommandLine *)commandLine context:(FBXCTestContext *)context
+{
+  FBXCTestDurationDatabase *database = [FBXCTestDurationDatabase databaseAtPath:FBXCTestDurationDatabase.defaultPath bundleName:commandLine.configuration.testBundlePath.lastPathComponent];
+  return [[self alloc] initWithCommandLine:commandLine context:context database:database];
+}
+
+- (instancetype)initWithCommandLine:(FBXCTestCommandLine *)commandLine context:(FBXCTestContext *)context database:(FBXCTestDurationDatabase *)database
+{
+  self = [super init];
+  if (!self) {
+    return nil;
+  }
+
+  _commandLine = commandLine;
+  _context = context;
+  _database = database;
+  _statistics = @{};
+  _batches = [NSMutableArray array];
+  _errors = [NSMutableArray array];
+  _idleWorkers = [NSMutableDictionary dictionary];
+  _listedTests = @[];
+  _scheduledBatches = [NSMutableDictionary dictionary];
+  _completedBatches = [NSMutableSet set];
+  _reportedTests = [NSMutableSet set];
+
+  return self;
+}
+
+#pragma mark FBXCTestRunner
+
+- (FBFuture<NSNull *> *)execute
+{
+  NSUInteger shardCount = self.commandLine.shardCount;
+  NSMutableArray<FBFuture<FBSimulator *> *> *simulators = [NSMutableArray array];
+  for (NSUInteger index = 0; index < shardCount; index++) {
+    [simulators addObject:[self.context simulatorForCommandLine:self.commandLine]];
+  }
+
+  return [[[FBFuture
+    futureWithFutures:simulators]
+    timeout:self.commandLine.testPreparationTimeout waitingFor:@"%lu Simulators to be fetched for a sharded test", (unsigned long) shardCount]
+    onQueue:dispatch_get_main_queue() chain:^(FBFuture<NSArray<FBSimulator *> *> *fetchFuture) {
+      NSArray<FBSimulator *> *fetched = fetchFuture.result;
+      if (!fetched) {
+        // The Simulators that were fetched before the failure will not be used, so must be released.
+        return [[self releaseSimulators:simulators] fmapReplace:fetchFuture];
+      }
+      return [[self
+        runTestsOnSimulators:fetched]
+        onQueue:dispatch_get_main_queue() chain:^(FBFuture *future) {
+          // Propogate the original result, but wait on the teardown of every Simulator as-well
+          NSMutableArray<FBFuture<NSNull *> *> *teardowns = [NSMutableArray array];
+          for (FBSimulator *simulator in fetched) {
+            [teardowns addObject:[self.context finishedExecutionOnSimulator:simulator]];
+          }
+          return [[FBFuture futureWithFutures:teardowns] fmapReplace:future];
+        }];
+    }];
+}
+
+#pragma mark Private
+
+- (FBFuture<NSNull *> *)releaseSimulators:(NSArray<FBFuture<FBSimulator *> *> *)simulators
+{
+  NSMutableArray<FBFuture<NSNull *> *> *teardowns = [NSMutableArray array];
+  for (FBFuture<FBSimulator *> *simulator in simulators) {
+    if (simulator.state == FBFutureStateDone) {
+      [teardowns addObject:[self.context finishedExecutionOnSimulator:simulator.result]];
+      continue;
+    }
+    // A Simulator that is still being fetched is released once it has been.
+    [simulator onQueue:dispatch_get_main_queue() notifyOfCompletion:^(FBFuture<FBSimulator *> *completed) {
+      FBSimulator *fetched = completed.result;
+      if (fetched) {
+        [self.context finishedExecutionOnSimulator:fetched];
+      }
+    }];
+  }
+  return [[FBFuture futureWithFutures:teardowns] mapReplace:NSNull.null];
+}
+
+- (FBXCTestConfiguration *)configuration
+{
+  return self.commandLine.configuration;
+}
+
+- (FBFuture<NSNull *> *)runTestsOnSimulators:(NSArray<FBSimulator *> *)simulators
+{
+  NSDate *startDate = NSDate.date;
+  return [[self
+    listTestsOnSimulator:simulators.firstObject]
+    onQueue:dispatch_get_main_queue() fmap:^(NSArray<NSString *> *testNames) {
+      NSDictionary<NSString *, NSNumber *> *durations = [self loadTestDurationsForTestNames:testNames];
+      FBXCTestShardScheduler *scheduler = [FBXCTestShardScheduler
+        schedulerWithTestNames:testNames
+        estimatedDurations:durations
+        defaultDuration:[FBXCTestShardedRunner defaultDurationFromDurations:durations]
+        workerCount:simulators.count];
+      [self.context.logger logFormat:@"Scheduled %@", scheduler];
+      self.listedTests = testNames;
+      [self.context.reporter didBeginExecutingTestPlan];
+      [self.context.reporter testSuite:FBXCTestShardedRunnerSuiteName didStartAt:@(startDate.timeIntervalSince1970).stringValue];
+
+      NSMutableArray<FBFuture<NSNull *> *> *workers = [NSMutableArray array];
+      for (NSUInteger worker = 0; worker < simulators.count; worker++) {
+        [workers addObject:[self runWorker:worker simulator:simulators[worker] scheduler:scheduler]];
+      }
+      return [[FBFuture
+        futureWithFutures:workers]
+        onQueue:dispatch_get_main_queue() fmap:^(id _) {
+          return [self finishReportWithStartDate:startDate];
+        }];
+    }];
+}
+
+- (FBFuture<NSArray<NSString *> *> *)listTestsOnSimulator:(FBSimulator *)simulator
+{
+  FBXCTestConfiguration *configuration = self.configuration;
+  NSString *runnerAppPath = [configuration isKindOfClass:FBTestManagerTestConfiguration.class] ? ((FBTestManagerTestConfiguration *) configuration).runnerAppPath : nil;
+  FBListTestConfiguration *listConfiguration = [FBListTestConfiguration
+    configurationWithShims:configuration.shims
+    environment:configuration.processUnderTestEnvironment
+    workingDirectory:configuration.workingDirectory
+    testBundlePath:configuration.testBundlePath
+    runnerAppPath:runnerAppPath
+    waitForDebugger:NO
+    timeout:configuration.testTimeout];
+  id<FBXCTestProcessExecutor> executor = [FBSimulatorXCTestProcessExecutor executorWithSimulator:simulator shims:configuration.shims];
+  NSArray<NSString *> *filters = [[self testFilter] componentsSeparatedByString:@","];
+
+  return [[[FBListTestStrategy
+    strategyWithExecutor:executor configuration:listConfiguration logger:self.context.logger]
+    listTests]
+    onQueue:dispatch_get_main_queue() map:^(NSArray<NSString *> *testNames) {
+      if (!filters) {
+        return testNames;
+      }
+      NSMutableArray<NSString *> *filtered = [NSMutableArray array];
+      for (NSString *testName in testNames) {
+        for (NSString *filter in filters) {
+          if ([testName isEqualToString:filter] || [testName hasPrefix:[filter stringByAppendingString:@"/"]]) {
+            [filtered addObject:testName];
+            break;
+          }
+        }
+      }
+      return [filtered copy];
+    }];
+}
+
+- (FBFuture<NSNull *> *)runWorker:(NSUInteger)worker simulator:(FBSimulator *)simulator scheduler:(FBXCTestShardScheduler *)scheduler
+{
+  NSArray<NSString *> *testNames = [scheduler nextBatchForWorker:worker];
+  if (!testNames) {
+    // A Worker that is out of work is resumed if another Worker is retired, so that the Tests of the retired Worker are still run.
+    self.idleWorkers[@(worker)] = simulator;
+    return [FBFuture futureWithResult:NSNull.null];
+  }
+  FBXCTestShardReporter *reporter = [FBXCTestShardReporter reporterWithQueue:dispatch_get_main_queue() testFinished:^(NSString *_) {
+    [self reportListedTests];
+  }];
+  NSUInteger batch = 0;
+  @synchronized (self) {
+    batch = self.batches.count;
+    [self.batches addObject:reporter];
+  }
+  for (NSString *testName in testNames) {
+    self.scheduledBatches[testName] = reporter;
+  }
+  [self.context.logger logFormat:@"Running Batch %lu of %lu Tests on Worker %lu", (unsigned long) batch, (unsigned long) testNames.count, (unsigned long) worker];
+
+  return [[self
+    runTestNames:testNames batch:batch simulator:simulator reporter:reporter]
+    onQueue:dispatch_get_main_queue() chain:^(FBFuture *future) {
+      // A Batch that fails before any of its Tests start could not be launched on the Simulator, rather than failing in a Test.
+      NSError *error = future.error;
+      if (error && reporter.startedTests.count == 0) {
+        return [self retireWorker:worker batch:batch testNames:testNames reporter:reporter scheduler:scheduler error:error];
+      }
+      // A failing Batch does not stop the Worker, the failure is reported once all Workers have finished.
+      if (error) {
+        [self.context.logger logFormat:@"Batch %lu failed %@", (unsigned long) batch, error];
+        @synchronized (self) {
+          [self.errors addObject:error];
+        }
+      }
+      // The Tests of the Batch that did not finish can no longer hold up the Tests listed after them.
+      [self.completedBatches addObject:reporter];
+      [self reportListedTests];
+      return [self runWorker:worker simulator:simulator scheduler:scheduler];
+    }];
+}
+
+- (FBFuture<NSNull *> *)retireWorker:(NSUInteger)worker batch:(NSUInteger)batch testNames:(NSArray<NSString *> *)testNames reporter:(FBXCTestShardReporter *)reporter scheduler:(FBXCTestShardScheduler *)scheduler error:(NSError *)error
+{
+  // The Simulator is not used again, the Tests of the Worker are run by the other Workers instead.
+  [self.context.logger logFormat:@"Batch %lu failed to launch on Worker %lu, retiring the Worker %@", (unsigned long) batch, (unsigned long) worker, error];
+  for (NSString *testName in testNames) {
+    [self.scheduledBatches removeObjectForKey:testName];
+  }
+  if (![scheduler retireWorker:worker returningTestNames:testNames]) {
+    @synchronized (self) {
+      [self.errors addObject:error];
+    }
+    // There are no Workers left to run the remaining Tests, so each of them is reported as a failure.
+    [self reportTestsNotRun:[scheduler removeRemainingTestNames] error:error];
+  }
+  [self.completedBatches addObject:reporter];
+  [self reportListedTests];
+
+  NSMutableArray<FBFuture<NSNull *> *> *resumed = [NSMutableArray array];
+  for (NSNumber *idleWorker in self.idleWorkers.allKeys) {
+    FBSimulator *simulator = self.idleWorkers[idleWorker];
+    [self.idleWorkers removeObjectForKey:idleWorker];
+    [resumed addObject:[self runWorker:idleWorker.unsignedIntegerValue simulator:simulator scheduler:scheduler]];
+  }
+  return [[FBFuture futureWithFutures:resumed] mapReplace:NSNull.null];
+}
+
+- (void)reportTestsNotRun:(NSArray<NSString *> *)testNames error:(NSError *)error
+{
+  if (testNames.count == 0) {
+    return;
+  }
+  [self.context.logger logFormat:@"Every Worker has been retired, %lu Tests were not run", (unsigned long) testNames.count];
+  FBXCTestShardReporter *batch = [FBXCTestShardReporter new];
+  NSString *message = [NSString stringWithFormat:@"Test was not run as every Worker was retired: %@", error.localizedDescription];
+  for (NSString *testName in testNames) {
+    NSArray<NSString *> *components = [testName componentsSeparatedByString:@"/"];
+    NSString *testClass = components.firstObject;
+    NSString *method = components.count > 1 ? components.lastObject : @"";
+    [batch testCaseDidStartForTestClass:testClass method:method];
+    [batch testCaseDidFailForTestClass:testClass method:method withMessage:message file:@"" line:0];
+    [batch testCaseDidFinishForTestClass:testClass method:method withStatus:FBTestReportStatusFailed duration:0];
+    self.scheduledBatches[testName] = batch;
+  }
+  self.notRunBatch = batch;
+  [self.completedBatches addObject:batch];
+}
+
+- (FBFuture<NSNull *> *)runTestNames:(NSArray<NSString *> *)testNames batch:(NSUInteger)batch simulator:(FBSimulator *)simulator reporter:(id<FBXCTestReporter>)reporter
+{
+  NSError *error = nil;
+  FBXCTestConfiguration *configuration = [self configurationForTestNames:testNames batch:batch error:&error];
+  if (!configuration) {
+    return [FBFuture futureWithError:error];
+  }
+  if ([configuration isKindOfClass:FBTestManagerTestConfiguration.class]) {
+    return [[FBTestRunStrategy strategyWithTarget:simulator configuration:(FBTestManagerTestConfiguration *)configuration reporter:reporter logger:self.context.logger testPreparationStrategyClass:FBSimulatorTestPreparationStrategy.class] execute];
+  }
+  id<FBXCTestProcessExecutor> executor = [FBSimulatorXCTestProcessExecutor executorWithSimulator:simulator shims:configuration.shims];
+  FBLogicReporterAdapter *adapter = [[FBLogicReporterAdapter alloc] initWithReporter:reporter logger:self.context.logger];
+  return [[FBLogicTestRunStrategy strategyWithExecutor:executor configuration:(FBLogicTestConfiguration *)configuration reporter:adapter logger:self.context.logger] execute];
+}
+
+- (nullable FBXCTestConfiguration *)configurationForTestNames:(NSArray<NSString *> *)testNames batch:(NSUInteger)batch error:(NSError **)error
+{
+  FBXCTestConfiguration *configuration = self.configuration;
+  NSString *testFilter = [testNames componentsJoinedByString:@","];
+  NSString *workingDirectory = [configuration.workingDirectory stringByAppendingPathComponent:[NSString stringWithFormat:@"batch_%lu", (unsigned long) batch]];
+  if (![NSFileManager.defaultManager createDirectoryAtPath:workingDirectory withIntermediateDirectories:YES attributes:nil error:error]) {
+    return nil;
+  }
+
+  if ([configuration isKindOfClass:FBTestManagerTestConfiguration.class]) {
+    FBTestManagerTestConfiguration *applicationTest = (FBTestManagerTestConfiguration *) configuration;
+    return [FBTestManagerTestConfiguration
+      configurationWithShims:applicationTest.shims
+      environment:applicationTest.processUnderTestEnvironment
+      workingDirectory:workingDirectory
+      testBundlePath:applicationTest.testBundlePath
+      waitForDebugger:NO
+      timeout:[self timeoutForTestNames:testNames]
+      runnerAppPath:applicationTest.runnerAppPath
+      testTargetAppPath:nil
+      testFilter:testFilter
+      videoRecordingPath:[FBXCTestShardedRunner path:applicationTest.videoRecordingPath forBatch:batch]
+      testArtifactsFilenameGlobs:applicationTest.testArtifactsFilenameGlobs
+      osLogPath:[FBXCTestShardedRunner path:applicationTest.osLogPath forBatch:batch]];
+  }
+  FBLogicTestConfiguration *logicTest = (FBLogicTestConfiguration *) configuration;
+  return [FBLogicTestConfiguration
+    configurationWithShims:logicTest.shims
+    environment:logicTest.processUnderTestEnvironment
+    workingDirectory:workingDirectory
+    testBundlePath:logicTest.testBundlePath
+    waitForDebugger:NO
+    timeout:[self timeoutForTestNames:testNames]
+    testFilter:testFilter
+    mirroring:logicTest.mirroring];
+}
+
+- (nullable NSString *)testFilter
+{
+  FBXCTestConfiguration *configuration = self.configuration;
+  if ([configuration isKindOfClass:FBTestManagerTestConfiguration.class]) {
+    return ((FBTestManagerTestConfiguration *) configuration).testFilter;
+  }
+  return ((FBLogicTestConfiguration *) configuration).testFilter;
+}
+
++ (nullable NSString *)path:(nullable NSString *)path forBatch:(NSUInteger)batch
+{
+  if (!path) {
+    return nil;
+  }
+  NSString *extension = path.pathExtension;
+  NSString *batchPath = [path.stringByDeletingPathExtension stringByAppendingFormat:@"_%lu", (unsigned long) batch];
+  return extension.length > 0 ? [batchPath stringByAppendingPathExtension:extension] : batchPath;
+}
+
+#pragma mark Reporting
+
+- (void)reportListedTests
+{
+  // A Test is reported as soon as every Test listed before it has been reported, or can no longer finish.
+  // Tests that cannot finish are skipped, those that started are reported at the end, as a crash will be attributed to the last Test.
+  while (self.reportPosition < self.listedTests.count) {
+    NSString *testName = self.listedTests[self.reportPosition];
+    FBXCTestShardReporter *batch = self.scheduledBatches[testName];
+    if ([self.reportedTests containsObject:testName]) {
+      // A Test that is listed more than once is reported once.
+    } else if ([batch durationOfTest:testName]) {
+      [self reportTest:testName batch:batch];
+    } else if (!batch || ![self.completedBatches containsObject:batch]) {
+      return;
+    }
+    self.reportPosition++;
+  }
+}
+
+- (void)reportTest:(NSString *)testName batch:(FBXCTestShardReporter *)batch
+{
+  [self.reportedTests addObject:testName];
+  [batch replayTest:testName toReporter:self.context.reporter];
+  NSNumber *duration = [batch durationOfTest:testName];
+  if (!duration) {
+    [self.database recordTest:testName status:FBTestReportStatusUnknown duration:0];
+    return;
+  }
+  BOOL failed = [batch.failedTests containsObject:testName];
+  // A Test that was not run has no duration to record.
+  if (batch != self.notRunBatch) {
+    [self.database recordTest:testName status:(failed ? FBTestReportStatusFailed : FBTestReportStatusPassed) duration:duration.doubleValue];
+  }
+  self.runCount += 1;
+  self.testDuration += duration.doubleValue;
+  self.failureCount += failed ? 1 : 0;
+}
+
+- (FBFuture<NSNull *> *)finishReportWithStartDate:(NSDate *)startDate
+{
+  NSArray<FBXCTestShardReporter *> *batches = nil;
+  NSMutableArray<NSError *> *errors = nil;
+  @synchronized (self) {
+    batches = [self.batches copy];
+    errors = [self.errors mutableCopy];
+  }
+  [self reportListedTests];
+
+  // Tests that were run but not listed follow the listed Tests, then the Tests that started but did not finish.
+  NSMutableArray<NSString *> *unfinishedTests = [NSMutableArray array];
+  NSMutableArray<FBXCTestShardReporter *> *unfinishedBatches = [NSMutableArray array];
+  for (FBXCTestShardReporter *batch in batches) {
+    for (NSString *testName in batch.startedTests) {
+      if ([self.reportedTests containsObject:testName]) {
+        continue;
+      }
+      if ([batch durationOfTest:testName]) {
+        [self reportTest:testName batch:batch];
+        continue;
+      }
+      [unfinishedTests addObject:testName];
+      [unfinishedBatches addObject:batch];
+    }
+    if (batch.crashError) {
+      [errors addObject:batch.crashError];
+    }
+  }
+  for (NSUInteger index = 0; index < unfinishedTests.count; index++) {
+    if (![self.reportedTests containsObject:unfinishedTests[index]]) {
+      [self reportTest:unfinishedTests[index] batch:unfinishedBatches[index]];
+    }
+  }
+
+  id<FBXCTestReporter> reporter = self.context.reporter;
+  for (FBXCTestShardReporter *batch in batches) {
+    [batch replayUnattributedEventsToReporter:reporter];
+  }
+  NSDate *finishDate = NSDate.date;
+  FBTestManagerResultSummary *summary = [[FBTestManagerResultSummary alloc]
+    initWithTestSuite:FBXCTestShardedRunnerSuiteName
+    finishTime:finishDate
+    runCount:self.runCount
+    failureCount:self.failureCount
+    unexpected:0
+    testDuration:self.testDuration
+    totalDuration:[finishDate timeIntervalSinceDate:startDate]];
+  [reporter finishedWithSummary:summary];
+  NSError *storeError = nil;
+  if (![self.database synchronizeWithError:&storeError]) {
+    [self.context.logger logFormat:@"Failed to store Test Durations %@", storeError];
+  }
+
+  NSError *error = errors.firstObject;
+  if (error) {
+    if ([reporter respondsToSelector:@selector(didCrashDuringTest:)]) {
+      [reporter didCrashDuringTest:error];
+    }
+    return [FBFuture futureWithError:error];
+  }
+  [reporter didFinishExecutingTestPlan];
+  return [FBFuture futureWithResult:NSNull.null];
+}
+
+#pragma mark Test Durations
+
+- (NSDictionary<NSString *, NSNumber *> *)loadTestDurationsForTestNames:(NSArray<NSString *> *)testNames
+{
+  NSError *error = nil;
+  NSDictionary<NSString *, FBXCTestDurationStatistics *> *statistics = [self.database statisticsForTestNames:testNames error:&error];
+  if (!statistics) {
+    [self.context.logger logFormat:@"Failed to load Test Durations, Tests will be scheduled without them %@", error];
+    statistics = @{};
+  }
+  self.statistics = statistics;
+
+  // Tests are scheduled by their typical duration, a Test that has only ever hung or crashed has no estimate.
+  NSMutableDictionary<NSString *, NSNumber *> *durations = [NSMutableDictionary dictionary];
+  for (NSString *testName in statistics) {
+    FBXCTestDurationStatistics *testStatistics = statistics[testName];
+    if (testStatistics.sampleCount > 0) {
+      durations[testName] = @(testStatistics.p50);
+    }
+  }
+  return [durations copy];
+}
+
+- (NSTimeInterval)timeoutForTestNames:(NSArray<NSString *> *)testNames
+{
+  // A Batch containing a Test with no durations, or that has recently failed to finish, is given the configured timeout.
+  // A Test that failed to finish in the past is timed out by its durations again, once it has finished enough times since.
+  NSTimeInterval configuredTimeout = self.configuration.testTimeout;
+  NSTimeInterval expectedDuration = 0;
+  for (NSString *testName in testNames) {
+    FBXCTestDurationStatistics *testStatistics = self.statistics[testName];
+    BOOL recentlyUnfinished = testStatistics.unfinishedCount > 0 && testStatistics.finishedCountSinceUnfinished < FBXCTestShardedRunnerRecoveredRunCount;
+    if (testStatistics.sampleCount == 0 || recentlyUnfinished) {
+      return configuredTimeout;
+    }
+    expectedDuration += testStatistics.p99;
+  }
+  return MIN((expectedDuration * FBXCTestShardedRunnerHangMultiplier) + FBXCTestShardedRunnerBatchLaunchAllowance, configuredTimeout);
+}
+
++ (NSTimeInterval)defaultDurationFromDurations:(NSDictionary<NSString *, NSNumber *> *)durations
+{
+  // A Test that has never run is assumed to be typical of the Bundle.
+  NSArray<NSNumber *> *sorted = [durations.allValues sortedArrayUsingSelector:@selector(compare:)];
+  if (sorted.count == 0) {
+    return FBXCTestShardedRunnerDefaultTestDuration;
+  }
+  return sorted[sorted.count / 2].doubleValue;
+}
+
+@end
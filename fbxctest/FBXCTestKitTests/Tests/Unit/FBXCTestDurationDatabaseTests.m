@@ -0,0 +1,182 @@
+/**
+ * Copyright (c) 2015-present, Facebook, Inc.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree. An additional grant
+ * of patent rights can be found in the PATENTS file in the same directory.
+ */
+
+#import <XCTest/XCTest.h>
+
+#import <FBXCTestKit/FBXCTestKit.h>
+
+@interface FBXCTestDurationDatabaseTests : XCTestCase
+
+@property (nonatomic, copy, readwrite) NSString *path;
+
+@end
+
+@implementation FBXCTestDurationDatabaseTests
+
+- (void)setUp
+{
+  [super setUp];
+  self.path = [[NSTemporaryDirectory()
+    stringByAppendingPathComponent:NSUUID.UUID.UUIDString]
+    stringByAppendingPathComponent:@"TestDurations.db"];
+}
+
+- (void)tearDown
+{
+  [NSFileManager.defaultManager removeItemAtPath:self.path.stringByDeletingLastPathComponent error:nil];
+  [super tearDown];
+}
+
+- (FBXCTestDurationDatabase *)databaseForBundle:(NSString *)bundleName
+{
+  return [FBXCTestDurationDatabase databaseAtPath:self.path bundleName:bundleName];
+}
+
+- (void)testEmptyDatabaseHasNoStatistics
+{
+  NSError *error = nil;
+  NSDictionary<NSString *, FBXCTestDurationStatistics *> *statistics = [[self databaseForBundle:@"Foo.xctest"] statisticsForTestNames:@[@"A/a"] error:&error];
+  XCTAssertNil(error);
+  XCTAssertEqualObjects(statistics, @{});
+}
+
+- (void)testRecordedRunsArePersisted
+{
+  FBXCTestDurationDatabase *database = [self databaseForBundle:@"Foo.xctest"];
+  for (NSUInteger run = 1; run <= 100; run++) {
+    [database recordTest:@"A/a" status:FBTestReportStatusPassed duration:run];
+  }
+  [database recordTest:@"A/b" status:FBTestReportStatusFailed duration:2];
+  [database recordTest:@"A/b" status:FBTestReportStatusUnknown duration:0];
+
+  // Runs are not visible until they are synchronized.
+  NSError *error = nil;
+  XCTAssertEqualObjects([database statisticsForTestNames:@[@"A/a"] error:&error], @{});
+  XCTAssertTrue([database synchronizeWithError:&error]);
+  XCTAssertNil(error);
+
+  NSDictionary<NSString *, FBXCTestDurationStatistics *> *statistics = [[self databaseForBundle:@"Foo.xctest"] statisticsForTestNames:@[@"A/a", @"A/b", @"A/c"] error:&error];
+  XCTAssertNil(error);
+  XCTAssertEqual(statistics.count, 2u);
+  XCTAssertEqual(statistics[@"A/a"].sampleCount, 100u);
+  XCTAssertEqual(statistics[@"A/a"].failureCount, 0u);
+  XCTAssertEqualWithAccuracy(statistics[@"A/a"].p50, 50, 0.001);
+  XCTAssertEqualWithAccuracy(statistics[@"A/a"].p99, 99, 0.001);
+  XCTAssertEqual(statistics[@"A/b"].sampleCount, 1u);
+  XCTAssertEqual(statistics[@"A/b"].failureCount, 1u);
+  XCTAssertEqual(statistics[@"A/b"].unfinishedCount, 1u);
+  XCTAssertEqualWithAccuracy(statistics[@"A/b"].p99, 2, 0.001);
+}
+
+- (void)testCountsFinishedRunsSinceLastUnfinishedRun
+{
+  FBXCTestDurationDatabase *database = [self databaseForBundle:@"Foo.xctest"];
+  [database recordTest:@"A/a" status:FBTestReportStatusPassed duration:1];
+  [database recordTest:@"A/a" status:FBTestReportStatusUnknown duration:0];
+  [database recordTest:@"A/a" status:FBTestReportStatusPassed duration:1];
+  [database recordTest:@"A/a" status:FBTestReportStatusFailed duration:1];
+  [database recordTest:@"A/b" status:FBTestReportStatusPassed duration:1];
+  [database recordTest:@"A/b" status:FBTestReportStatusPassed duration:1];
+  [database recordTest:@"A/c" status:FBTestReportStatusPassed duration:1];
+  [database recordTest:@"A/c" status:FBTestReportStatusUnknown duration:0];
+  NSError *error = nil;
+  XCTAssertTrue([database synchronizeWithError:&error]);
+  XCTAssertNil(error);
+
+  NSDictionary<NSString *, FBXCTestDurationStatistics *> *statistics = [database statisticsForTestNames:@[@"A/a", @"A/b", @"A/c"] error:&error];
+  XCTAssertNil(error);
+  XCTAssertEqual(statistics[@"A/a"].unfinishedCount, 1u);
+  XCTAssertEqual(statistics[@"A/a"].finishedCountSinceUnfinished, 2u);
+  XCTAssertEqual(statistics[@"A/b"].unfinishedCount, 0u);
+  XCTAssertEqual(statistics[@"A/b"].finishedCountSinceUnfinished, 2u);
+  XCTAssertEqual(statistics[@"A/c"].unfinishedCount, 1u);
+  XCTAssertEqual(statistics[@"A/c"].finishedCountSinceUnfinished, 0u);
+}
+
+- (void)testTestsAreScopedToTheirBundle
+{
+  FBXCTestDurationDatabase *foo = [self databaseForBundle:@"Foo.xctest"];
+  [foo recordTest:@"A/a" status:FBTestReportStatusPassed duration:1];
+  NSError *error = nil;
+  XCTAssertTrue([foo synchronizeWithError:&error]);
+
+  FBXCTestDurationDatabase *bar = [self databaseForBundle:@"Bar.xctest"];
+  [bar recordTest:@"A/a" status:FBTestReportStatusPassed duration:5];
+  XCTAssertTrue([bar synchronizeWithError:&error]);
+
+  XCTAssertEqualWithAccuracy([foo statisticsForTestNames:@[@"A/a"] error:&error][@"A/a"].p50, 1, 0.001);
+  XCTAssertEqualWithAccuracy([bar statisticsForTestNames:@[@"A/a"] error:&error][@"A/a"].p50, 5, 0.001);
+}
+
+- (void)testCompactionRetainsMostRecentRuns
+{
+  FBXCTestDurationDatabase *database = [self databaseForBundle:@"Foo.xctest"];
+  for (NSUInteger run = 1; run <= 1000; run++) {
+    [database recordTest:@"A/a" status:FBTestReportStatusPassed duration:run];
+    [database recordTest:@"A/b" status:FBTestReportStatusPassed duration:1];
+  }
+  NSError *error = nil;
+  XCTAssertTrue([database synchronizeWithError:&error]);
+  unsigned long long uncompactedSize = [NSFileManager.defaultManager attributesOfItemAtPath:self.path error:nil].fileSize;
+
+  XCTAssertTrue([database compactWithError:&error]);
+  XCTAssertNil(error);
+  unsigned long long compactedSize = [NSFileManager.defaultManager attributesOfItemAtPath:self.path error:nil].fileSize;
+  XCTAssertLessThan(compactedSize, uncompactedSize);
+
+  NSDictionary<NSString *, FBXCTestDurationStatistics *> *statistics = [database statisticsForTestNames:@[@"A/a", @"A/b"] error:&error];
+  XCTAssertEqual(statistics[@"A/a"].sampleCount, statistics[@"A/b"].sampleCount);
+  XCTAssertLessThan(statistics[@"A/a"].sampleCount, 1000u);
+  XCTAssertGreaterThan(statistics[@"A/a"].p50, 900);
+  XCTAssertEqualWithAccuracy(statistics[@"A/b"].p50, 1, 0.001);
+
+  // Appending continues after compaction.
+  [database recordTest:@"A/c" status:FBTestReportStatusPassed duration:3];
+  XCTAssertTrue([database synchronizeWithError:&error]);
+  XCTAssertEqualWithAccuracy([database statisticsForTestNames:@[@"A/c"] error:&error][@"A/c"].p50, 3, 0.001);
+}
+
+- (void)testPartiallyAppendedRecordIsDiscarded
+{
+  FBXCTestDurationDatabase *database = [self databaseForBundle:@"Foo.xctest"];
+  [database recordTest:@"A/a" status:FBTestReportStatusPassed duration:1];
+  NSError *error = nil;
+  XCTAssertTrue([database synchronizeWithError:&error]);
+
+  NSFileHandle *handle = [NSFileHandle fileHandleForWritingAtPath:self.path];
+  [handle seekToEndOfFile];
+  [handle writeData:[@"torn" dataUsingEncoding:NSUTF8StringEncoding]];
+  [handle closeFile];
+
+  XCTAssertEqual([database statisticsForTestNames:@[@"A/a"] error:&error][@"A/a"].sampleCount, 1u);
+  [database recordTest:@"A/a" status:FBTestReportStatusPassed duration:3];
+  XCTAssertTrue([database synchronizeWithError:&error]);
+  FBXCTestDurationStatistics *statistics = [database statisticsForTestNames:@[@"A/a"] error:&error][@"A/a"];
+  XCTAssertEqual(statistics.sampleCount, 2u);
+  XCTAssertEqualWithAccuracy(statistics.p99, 3, 0.001);
+}
+
+- (void)testReplacesForeignFile
+{
+  // Such as the JSON durations that were stored at the same path by an earlier fbxctest.
+  [NSFileManager.defaultManager createDirectoryAtPath:self.path.stringByDeletingLastPathComponent withIntermediateDirectories:YES attributes:nil error:nil];
+  [[@"{\"Foo.xctest\": {\"A/a\": [1, 2, 3]}}" dataUsingEncoding:NSUTF8StringEncoding] writeToFile:self.path atomically:YES];
+
+  FBXCTestDurationDatabase *database = [self databaseForBundle:@"Foo.xctest"];
+  NSError *error = nil;
+  XCTAssertEqualObjects([database statisticsForTestNames:@[@"A/a"] error:&error], @{});
+  XCTAssertNil(error);
+
+  [database recordTest:@"A/a" status:FBTestReportStatusPassed duration:1];
+  XCTAssertTrue([database synchronizeWithError:&error]);
+  XCTAssertNil(error);
+  XCTAssertEqual([database statisticsForTestNames:@[@"A/a"] error:&error][@"A/a"].sampleCount, 1u);
+}
+
+@end
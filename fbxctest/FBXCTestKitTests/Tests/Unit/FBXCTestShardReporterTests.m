@@ -0,0 +1,65 @@
+/**
+ * Copyright (c) 2015-present, Facebook, Inc.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree. An additional grant
+ * of patent rights can be found in the PATENTS file in the same directory.
+ */
+
+#import <XCTest/XCTest.h>
+
+#import <FBXCTestKit/FBXCTestKit.h>
+
+#import "FBXCTestReporterDouble.h"
+
+@interface FBXCTestShardReporterTests : XCTestCase
+
+@end
+
+@implementation FBXCTestShardReporterTests
+
+- (void)testReplaysBatchesInListedOrder
+{
+  FBXCTestShardReporter *first = [FBXCTestShardReporter new];
+  [first didBeginExecutingTestPlan];
+  [first testCaseDidStartForTestClass:@"B" method:@"b"];
+  [first testCaseDidFailForTestClass:@"B" method:@"b" withMessage:@"Bad" file:@"B.m" line:10];
+  [first testCaseDidFinishForTestClass:@"B" method:@"b" withStatus:FBTestReportStatusFailed duration:2];
+  [first didFinishExecutingTestPlan];
+
+  FBXCTestShardReporter *second = [FBXCTestShardReporter new];
+  [second testCaseDidStartForTestClass:@"A" method:@"a"];
+  [second testHadOutput:@"Hello"];
+  [second testCaseDidFinishForTestClass:@"A" method:@"a" withStatus:FBTestReportStatusPassed duration:1];
+
+  XCTAssertEqualObjects(first.startedTests, @[@"B/b"]);
+  XCTAssertEqualObjects(first.finishedTests, @{@"B/b": @2});
+  XCTAssertEqualObjects(first.failedTests, [NSSet setWithObject:@"B/b"]);
+  XCTAssertEqualObjects(second.failedTests, [NSSet set]);
+
+  FBXCTestReporterDouble *reporter = [FBXCTestReporterDouble new];
+  [second replayTest:@"A/a" toReporter:reporter];
+  [first replayTest:@"B/b" toReporter:reporter];
+  XCTAssertEqualObjects(reporter.startedTests, (@[@[@"A", @"a"], @[@"B", @"b"]]));
+  XCTAssertEqualObjects(reporter.passedTests, (@[@[@"A", @"a"]]));
+  XCTAssertEqualObjects(reporter.failedTests, (@[@[@"B", @"b"]]));
+}
+
+- (void)testReporterNotifiesWhenEachTestFinishes
+{
+  XCTestExpectation *expectation = [self expectationWithDescription:@"Test finished"];
+  FBXCTestShardReporter *batch = [FBXCTestShardReporter reporterWithQueue:dispatch_get_main_queue() testFinished:^(NSString *testName) {
+    XCTAssertEqualObjects(testName, @"A/a");
+    [expectation fulfill];
+  }];
+  [batch testCaseDidStartForTestClass:@"A" method:@"a"];
+  XCTAssertNil([batch durationOfTest:@"A/a"]);
+  [batch testCaseDidFinishForTestClass:@"A" method:@"a" withStatus:FBTestReportStatusPassed duration:3];
+  [self waitForExpectations:@[expectation] timeout:FBControlCoreGlobalConfiguration.fastTimeout];
+
+  XCTAssertEqualObjects([batch durationOfTest:@"A/a"], @3);
+  XCTAssertNil([batch durationOfTest:@"A/b"]);
+}
+
+@end
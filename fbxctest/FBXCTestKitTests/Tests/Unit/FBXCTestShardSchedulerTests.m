@@ -0,0 +1,135 @@
+/**
+ * Copyright (c) 2015-present, Facebook, Inc.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree. An additional grant
+ * of patent rights can be found in the PATENTS file in the same directory.
+ */
+
+#import <XCTest/XCTest.h>
+
+#import <FBXCTestKit/FBXCTestKit.h>
+
+@interface FBXCTestShardSchedulerTests : XCTestCase
+
+@end
+
+@implementation FBXCTestShardSchedulerTests
+
+- (NSArray<NSString *> *)drainWorker:(NSUInteger)worker scheduler:(FBXCTestShardScheduler *)scheduler
+{
+  NSMutableArray<NSString *> *tests = [NSMutableArray array];
+  NSArray<NSString *> *batch = nil;
+  while ((batch = [scheduler nextBatchForWorker:worker])) {
+    XCTAssertGreaterThan(batch.count, 0u);
+    [tests addObjectsFromArray:batch];
+  }
+  return [tests copy];
+}
+
+- (void)testBalancesByDurationLongestFirst
+{
+  NSArray<NSString *> *testNames = @[@"A/a", @"A/b", @"A/c", @"B/a", @"B/b"];
+  NSDictionary<NSString *, NSNumber *> *durations = @{
+    @"A/a": @1,
+    @"A/b": @10,
+    @"A/c": @6,
+    @"B/a": @4,
+  };
+  FBXCTestShardScheduler *scheduler = [FBXCTestShardScheduler schedulerWithTestNames:testNames estimatedDurations:durations defaultDuration:3 workerCount:2];
+
+  NSArray<NSArray<NSString *> *> *expected = @[
+    @[@"A/b", @"B/b"],
+    @[@"A/c", @"B/a", @"A/a"],
+  ];
+  XCTAssertEqualObjects(scheduler.initialShards, expected);
+}
+
+- (void)testEveryTestIsScheduledExactlyOnce
+{
+  NSMutableArray<NSString *> *testNames = [NSMutableArray array];
+  for (NSUInteger index = 0; index < 100; index++) {
+    [testNames addObject:[NSString stringWithFormat:@"Test/method%lu", (unsigned long) index]];
+  }
+  FBXCTestShardScheduler *scheduler = [FBXCTestShardScheduler schedulerWithTestNames:testNames estimatedDurations:@{} defaultDuration:1 workerCount:3];
+
+  NSMutableArray<NSString *> *scheduled = [NSMutableArray array];
+  [scheduled addObjectsFromArray:[self drainWorker:0 scheduler:scheduler]];
+  [scheduled addObjectsFromArray:[self drainWorker:1 scheduler:scheduler]];
+  [scheduled addObjectsFromArray:[self drainWorker:2 scheduler:scheduler]];
+  XCTAssertEqual(scheduled.count, testNames.count);
+  XCTAssertEqualObjects([NSSet setWithArray:scheduled], [NSSet setWithArray:testNames]);
+}
+
+- (void)testIdleWorkerStealsShortestTests
+{
+  NSArray<NSString *> *testNames = @[@"A/a", @"A/b", @"A/c", @"A/d"];
+  NSDictionary<NSString *, NSNumber *> *durations = @{
+    @"A/a": @8,
+    @"A/b": @4,
+    @"A/c": @2,
+    @"A/d": @1,
+  };
+  FBXCTestShardScheduler *scheduler = [FBXCTestShardScheduler schedulerWithTestNames:testNames estimatedDurations:durations defaultDuration:1 workerCount:2];
+  XCTAssertEqualObjects(scheduler.initialShards[1], (@[@"A/b", @"A/c", @"A/d"]));
+
+  // Worker 0 finishes its own work, then steals from the back of Worker 1's queue.
+  XCTAssertEqualObjects([scheduler nextBatchForWorker:0], @[@"A/a"]);
+  NSArray<NSString *> *stolen = [self drainWorker:0 scheduler:scheduler];
+  XCTAssertEqualObjects(stolen, (@[@"A/b", @"A/c", @"A/d"]));
+  XCTAssertNil([scheduler nextBatchForWorker:1]);
+}
+
+- (void)testTestsOfRetiredWorkerAreStolenFirst
+{
+  NSArray<NSString *> *testNames = @[@"A/a", @"A/b", @"A/c", @"A/d"];
+  NSDictionary<NSString *, NSNumber *> *durations = @{
+    @"A/a": @8,
+    @"A/b": @4,
+    @"A/c": @2,
+    @"A/d": @1,
+  };
+  FBXCTestShardScheduler *scheduler = [FBXCTestShardScheduler schedulerWithTestNames:testNames estimatedDurations:durations defaultDuration:1 workerCount:2];
+  NSArray<NSString *> *failed = [scheduler nextBatchForWorker:1];
+  XCTAssertEqualObjects(failed, (@[@"A/b"]));
+
+  // The failed Batch is returned with the rest of Worker 1's queue, all of which is taken by Worker 0 once it has finished its own work.
+  XCTAssertTrue([scheduler retireWorker:1 returningTestNames:failed]);
+  XCTAssertNil([scheduler nextBatchForWorker:1]);
+  NSArray<NSString *> *scheduled = [self drainWorker:0 scheduler:scheduler];
+  XCTAssertEqualObjects(scheduled, (@[@"A/a", @"A/b", @"A/c", @"A/d"]));
+  XCTAssertFalse([scheduler retireWorker:0 returningTestNames:@[]]);
+}
+
+- (void)testBatchFilterIsLimitedInLength
+{
+  NSString *method = [@"" stringByPaddingToLength:2000 withString:@"m" startingAtIndex:0];
+  NSMutableArray<NSString *> *testNames = [NSMutableArray array];
+  for (NSUInteger index = 0; index < 200; index++) {
+    [testNames addObject:[NSString stringWithFormat:@"Test%lu/%@", (unsigned long) index, method]];
+  }
+  FBXCTestShardScheduler *scheduler = [FBXCTestShardScheduler schedulerWithTestNames:testNames estimatedDurations:@{} defaultDuration:1 workerCount:1];
+
+  NSMutableArray<NSString *> *scheduled = [NSMutableArray array];
+  NSArray<NSString *> *batch = nil;
+  while ((batch = [scheduler nextBatchForWorker:0])) {
+    XCTAssertLessThanOrEqual([[batch componentsJoinedByString:@","] lengthOfBytesUsingEncoding:NSUTF8StringEncoding], FBXCTestShardSchedulerMaximumFilterLength);
+    [scheduled addObjectsFromArray:batch];
+  }
+  XCTAssertEqualObjects(scheduled, testNames);
+}
+
+- (void)testRemainingTestsAreRemovedOnceEveryWorkerIsRetired
+{
+  NSArray<NSString *> *testNames = @[@"A/a", @"A/b", @"A/c", @"A/d"];
+  FBXCTestShardScheduler *scheduler = [FBXCTestShardScheduler schedulerWithTestNames:testNames estimatedDurations:@{} defaultDuration:1 workerCount:2];
+  NSArray<NSString *> *failed = [scheduler nextBatchForWorker:0];
+  XCTAssertTrue([scheduler retireWorker:0 returningTestNames:failed]);
+  XCTAssertFalse([scheduler retireWorker:1 returningTestNames:@[]]);
+
+  XCTAssertEqualObjects([NSSet setWithArray:[scheduler removeRemainingTestNames]], [NSSet setWithArray:testNames]);
+  XCTAssertEqualObjects([scheduler removeRemainingTestNames], @[]);
+}
+
+@end
@@ -0,0 +1,318 @@
+/**
+ * Copyright (c) 2015-present, Facebook, Inc.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree. An additional grant
+ * of patent rights can be found in the PATENTS file in the same directory.
+ */
+
+#import <XCTest/XCTest.h>
+
+#import <FBXCTestKit/FBXCTestKit.h>
+#import <FBXCTestKit/FBXCTestShardedRunner+Private.h>
+
+#import "FBXCTestReporterDouble.h"
+
+/**
+ The configured timeout, which is longer than a Batch of short Tests is timed out by.
+ */
+static NSTimeInterval const FBXCTestShardedRunnerTestsTimeout = 600;
+
+/**
+ Runs a Batch, by reporting the events of its Tests to the reporter.
+ */
+typedef FBFuture<NSNull *> *(^FBXCTestShardedRunnerBatchDouble)(NSArray<NSString *> *testNames, id<FBXCTestReporter> reporter);
+
+@interface FBXCTestShardedRunnerContextDouble : FBXCTestContext
+
+@property (nonatomic, strong, readwrite) NSMutableArray<FBFuture<FBSimulator *> *> *simulators;
+@property (nonatomic, strong, readwrite) NSMutableArray<FBSimulator *> *releasedSimulators;
+
+@end
+
+@implementation FBXCTestShardedRunnerContextDouble
+
+- (FBFuture<FBSimulator *> *)simulatorForCommandLine:(FBXCTestCommandLine *)commmandLine
+{
+  FBFuture<FBSimulator *> *simulator = self.simulators.firstObject;
+  [self.simulators removeObjectAtIndex:0];
+  return simulator;
+}
+
+- (FBFuture<NSNull *> *)finishedExecutionOnSimulator:(FBSimulator *)simulator
+{
+  [self.releasedSimulators addObject:simulator];
+  return [FBFuture futureWithResult:NSNull.null];
+}
+
+@end
+
+@interface FBXCTestShardedRunnerDouble : FBXCTestShardedRunner
+
+@property (nonatomic, copy, readwrite) NSArray<NSString *> *testNames;
+@property (nonatomic, copy, readwrite) FBXCTestShardedRunnerBatchDouble batch;
+
+@end
+
+@implementation FBXCTestShardedRunnerDouble
+
+- (FBFuture<NSArray<NSString *> *> *)listTestsOnSimulator:(FBSimulator *)simulator
+{
+  return [FBFuture futureWithResult:self.testNames];
+}
+
+- (FBFuture<NSNull *> *)runTestNames:(NSArray<NSString *> *)testNames batch:(NSUInteger)batch simulator:(FBSimulator *)simulator reporter:(id<FBXCTestReporter>)reporter
+{
+  return self.batch(testNames, reporter);
+}
+
+@end
+
+@interface FBXCTestShardedRunnerTests : XCTestCase
+
+@property (nonatomic, copy, readwrite) NSString *databasePath;
+@property (nonatomic, strong, readwrite) FBXCTestReporterDouble *reporter;
+@property (nonatomic, strong, readwrite) FBXCTestShardedRunnerContextDouble *context;
+
+@end
+
+@implementation FBXCTestShardedRunnerTests
+
+- (void)setUp
+{
+  [super setUp];
+  self.databasePath = [[NSTemporaryDirectory()
+    stringByAppendingPathComponent:NSUUID.UUID.UUIDString]
+    stringByAppendingPathComponent:@"TestDurations.db"];
+  self.reporter = [FBXCTestReporterDouble new];
+  self.context = [FBXCTestShardedRunnerContextDouble contextWithReporter:self.reporter logger:nil];
+  self.context.simulators = [NSMutableArray array];
+  self.context.releasedSimulators = [NSMutableArray array];
+}
+
+- (void)tearDown
+{
+  [NSFileManager.defaultManager removeItemAtPath:self.databasePath.stringByDeletingLastPathComponent error:nil];
+  [super tearDown];
+}
+
+- (FBXCTestShardedRunnerDouble *)runnerWithTestNames:(NSArray<NSString *> *)testNames shardCount:(NSUInteger)shardCount
+{
+  // The Simulators are only passed through to the Context and the Batches, so they are stood in for.
+  FBXCTestShimConfiguration *shims = [[FBXCTestShimConfiguration alloc] initWithiOSSimulatorTestShimPath:@"/ios.dylib" macOSTestShimPath:@"/mac.dylib" macOSQueryShimPath:@"/query.dylib"];
+  FBLogicTestConfiguration *configuration = [FBLogicTestConfiguration
+    configurationWithShims:shims
+    environment:@{}
+    workingDirectory:NSTemporaryDirectory()
+    testBundlePath:@"/Foo.xctest"
+    waitForDebugger:NO
+    timeout:FBXCTestShardedRunnerTestsTimeout
+    testFilter:nil
+    mirroring:FBLogicTestMirrorNoLogs];
+  FBXCTestCommandLine *commandLine = [FBXCTestCommandLine
+    commandLineWithConfiguration:configuration
+    destination:[[FBXCTestDestinationiPhoneSimulator alloc] initWithModel:nil version:nil]
+    shardCount:shardCount];
+  FBXCTestDurationDatabase *database = [FBXCTestDurationDatabase databaseAtPath:self.databasePath bundleName:@"Foo.xctest"];
+  FBXCTestShardedRunnerDouble *runner = [[FBXCTestShardedRunnerDouble alloc] initWithCommandLine:commandLine context:self.context database:database];
+  runner.testNames = testNames;
+  return runner;
+}
+
+- (void)addSimulators:(NSUInteger)count
+{
+  for (NSUInteger index = 0; index < count; index++) {
+    [self.context.simulators addObject:[FBFuture futureWithResult:(FBSimulator *) [NSObject new]]];
+  }
+}
+
++ (void)reportTest:(NSString *)testName toReporter:(id<FBXCTestReporter>)reporter finished:(BOOL)finished
+{
+  NSArray<NSString *> *components = [testName componentsSeparatedByString:@"/"];
+  [reporter testCaseDidStartForTestClass:components[0] method:components[1]];
+  if (finished) {
+    [reporter testCaseDidFinishForTestClass:components[0] method:components[1] withStatus:FBTestReportStatusPassed duration:1];
+  }
+}
+
+- (void)testReportsInListedOrderWhenBatchesFinishOutOfOrder
+{
+  [self addSimulators:2];
+  FBXCTestShardedRunnerDouble *runner = [self runnerWithTestNames:@[@"A/a", @"A/b"] shardCount:2];
+  FBMutableFuture<NSNull *> *firstListed = FBMutableFuture.future;
+  runner.batch = ^ FBFuture<NSNull *> * (NSArray<NSString *> *testNames, id<FBXCTestReporter> reporter) {
+    if ([testNames containsObject:@"A/a"]) {
+      // The Batch of the first listed Test finishes after the other Batch.
+      return [firstListed onQueue:dispatch_get_main_queue() map:^(id _) {
+        for (NSString *testName in testNames) {
+          [FBXCTestShardedRunnerTests reportTest:testName toReporter:reporter finished:YES];
+        }
+        return NSNull.null;
+      }];
+    }
+    for (NSString *testName in testNames) {
+      [FBXCTestShardedRunnerTests reportTest:testName toReporter:reporter finished:YES];
+    }
+    return [FBFuture futureWithResult:NSNull.null];
+  };
+
+  FBFuture<NSNull *> *execution = [runner execute];
+  [NSRunLoop.currentRunLoop runUntilDate:[NSDate dateWithTimeIntervalSinceNow:0.5]];
+  XCTAssertEqual(execution.state, FBFutureStateRunning);
+  // The second listed Test has finished, but is held back until the first listed Test is reported.
+  XCTAssertEqualObjects(self.reporter.startedTests, @[]);
+
+  [firstListed resolveWithResult:NSNull.null];
+  NSError *error = nil;
+  XCTAssertNotNil([execution awaitWithTimeout:FBControlCoreGlobalConfiguration.fastTimeout error:&error]);
+  XCTAssertNil(error);
+  XCTAssertEqualObjects(self.reporter.startedTests, (@[@[@"A", @"a"], @[@"A", @"b"]]));
+  XCTAssertEqualObjects(self.reporter.passedTests, (@[@[@"A", @"a"], @[@"A", @"b"]]));
+  XCTAssertEqual(self.context.releasedSimulators.count, 2u);
+}
+
+- (void)testReportsUnfinishedTestsLast
+{
+  [self addSimulators:2];
+  FBXCTestShardedRunnerDouble *runner = [self runnerWithTestNames:@[@"A/a", @"A/b", @"A/c"] shardCount:2];
+  NSError *hang = [NSError errorWithDomain:@"Hang" code:1 userInfo:nil];
+  runner.batch = ^ FBFuture<NSNull *> * (NSArray<NSString *> *testNames, id<FBXCTestReporter> reporter) {
+    for (NSString *testName in testNames) {
+      BOOL finished = ![testName isEqualToString:@"A/a"];
+      [FBXCTestShardedRunnerTests reportTest:testName toReporter:reporter finished:finished];
+      if (!finished) {
+        return [FBFuture futureWithError:hang];
+      }
+    }
+    return [FBFuture futureWithResult:NSNull.null];
+  };
+
+  NSError *error = nil;
+  XCTAssertNil([[runner execute] awaitWithTimeout:FBControlCoreGlobalConfiguration.fastTimeout error:&error]);
+  XCTAssertEqualObjects(error, hang);
+  // The first listed Test did not finish, so does not hold up the Tests listed after it, and is reported after them.
+  XCTAssertEqualObjects(self.reporter.startedTests, (@[@[@"A", @"b"], @[@"A", @"c"], @[@"A", @"a"]]));
+  XCTAssertEqualObjects(self.reporter.passedTests, (@[@[@"A", @"b"], @[@"A", @"c"]]));
+}
+
+- (void)testPropagatesCrashOfBatch
+{
+  [self addSimulators:2];
+  FBXCTestShardedRunnerDouble *runner = [self runnerWithTestNames:@[@"A/a", @"A/b"] shardCount:2];
+  NSError *crash = [NSError errorWithDomain:@"Crash" code:1 userInfo:nil];
+  runner.batch = ^ FBFuture<NSNull *> * (NSArray<NSString *> *testNames, id<FBXCTestReporter> reporter) {
+    for (NSString *testName in testNames) {
+      BOOL crashed = [testName isEqualToString:@"A/b"];
+      [FBXCTestShardedRunnerTests reportTest:testName toReporter:reporter finished:!crashed];
+      if (crashed) {
+        // The crash is reported to the reporter of the Batch, whilst the test process exits normally.
+        [reporter didCrashDuringTest:crash];
+      }
+    }
+    return [FBFuture futureWithResult:NSNull.null];
+  };
+
+  NSError *error = nil;
+  XCTAssertNil([[runner execute] awaitWithTimeout:FBControlCoreGlobalConfiguration.fastTimeout error:&error]);
+  XCTAssertEqualObjects(error, crash);
+  XCTAssertEqualObjects(self.reporter.crashError, crash);
+  XCTAssertEqualObjects(self.reporter.startedTests, (@[@[@"A", @"a"], @[@"A", @"b"]]));
+  XCTAssertEqualObjects(self.reporter.passedTests, (@[@[@"A", @"a"]]));
+}
+
+- (void)testRunsTestsOfBatchThatFailedToLaunchOnOtherWorkers
+{
+  [self addSimulators:2];
+  FBXCTestShardedRunnerDouble *runner = [self runnerWithTestNames:@[@"A/a", @"A/b", @"A/c", @"A/d"] shardCount:2];
+  NSError *launch = [NSError errorWithDomain:@"Launch" code:1 userInfo:nil];
+  __block NSUInteger batchCount = 0;
+  runner.batch = ^ FBFuture<NSNull *> * (NSArray<NSString *> *testNames, id<FBXCTestReporter> reporter) {
+    // The first Batch fails before any of its Tests have started, as if its Simulator had failed.
+    if (batchCount++ == 0) {
+      return [FBFuture futureWithError:launch];
+    }
+    for (NSString *testName in testNames) {
+      [FBXCTestShardedRunnerTests reportTest:testName toReporter:reporter finished:YES];
+    }
+    return [FBFuture futureWithResult:NSNull.null];
+  };
+
+  NSError *error = nil;
+  XCTAssertNotNil([[runner execute] awaitWithTimeout:FBControlCoreGlobalConfiguration.fastTimeout error:&error]);
+  XCTAssertNil(error);
+  XCTAssertEqualObjects(self.reporter.passedTests, (@[@[@"A", @"a"], @[@"A", @"b"], @[@"A", @"c"], @[@"A", @"d"]]));
+}
+
+- (void)testReportsTestsThatWereNotRunWhenEveryWorkerIsRetired
+{
+  [self addSimulators:2];
+  FBXCTestShardedRunnerDouble *runner = [self runnerWithTestNames:@[@"A/a", @"A/b", @"A/c", @"A/d"] shardCount:2];
+  NSError *launch = [NSError errorWithDomain:@"Launch" code:1 userInfo:nil];
+  runner.batch = ^ FBFuture<NSNull *> * (NSArray<NSString *> *testNames, id<FBXCTestReporter> reporter) {
+    // Every Batch fails before any of its Tests have started, so every Worker is retired.
+    return [FBFuture futureWithError:launch];
+  };
+
+  NSError *error = nil;
+  XCTAssertNil([[runner execute] awaitWithTimeout:FBControlCoreGlobalConfiguration.fastTimeout error:&error]);
+  XCTAssertEqualObjects(error, launch);
+  XCTAssertEqualObjects(self.reporter.failedTests, (@[@[@"A", @"a"], @[@"A", @"b"], @[@"A", @"c"], @[@"A", @"d"]]));
+  XCTAssertEqualObjects(self.reporter.passedTests, @[]);
+}
+
+- (void)testTimesOutByDurationsOnceRecoveredFromUnfinishedRun
+{
+  FBXCTestDurationDatabase *database = [FBXCTestDurationDatabase databaseAtPath:self.databasePath bundleName:@"Foo.xctest"];
+  for (NSString *testName in @[@"A/recovered", @"A/recovering"]) {
+    [database recordTest:testName status:FBTestReportStatusPassed duration:1];
+    [database recordTest:testName status:FBTestReportStatusUnknown duration:0];
+  }
+  for (NSUInteger run = 0; run < 10; run++) {
+    [database recordTest:@"A/recovered" status:FBTestReportStatusPassed duration:1];
+  }
+  [database recordTest:@"A/recovering" status:FBTestReportStatusPassed duration:1];
+  NSError *error = nil;
+  XCTAssertTrue([database synchronizeWithError:&error]);
+  XCTAssertNil(error);
+
+  FBXCTestShardedRunnerDouble *runner = [self runnerWithTestNames:@[] shardCount:1];
+  NSTimeInterval configuredTimeout = FBXCTestShardedRunnerTestsTimeout;
+  [runner loadTestDurationsForTestNames:@[@"A/recovered", @"A/recovering"]];
+  // A Test that hung in the past does not prevent it being timed out by its durations, once it has finished enough times since.
+  XCTAssertLessThan([runner timeoutForTestNames:@[@"A/recovered"]], configuredTimeout);
+  XCTAssertEqual([runner timeoutForTestNames:@[@"A/recovering"]], configuredTimeout);
+  XCTAssertEqual([runner timeoutForTestNames:@[@"A/recovered", @"A/recovering"]], configuredTimeout);
+}
+
+- (void)testReleasesSimulatorsWhenFetchingFails
+{
+  FBSimulator *fetched = (FBSimulator *) [NSObject new];
+  FBSimulator *fetchedLate = (FBSimulator *) [NSObject new];
+  FBMutableFuture<FBSimulator *> *pending = FBMutableFuture.future;
+  NSError *fetchError = [NSError errorWithDomain:@"Fetch" code:1 userInfo:nil];
+  [self.context.simulators addObjectsFromArray:@[
+    [FBFuture futureWithResult:fetched],
+    [FBFuture futureWithError:fetchError],
+    pending,
+  ]];
+  FBXCTestShardedRunnerDouble *runner = [self runnerWithTestNames:@[@"A/a"] shardCount:3];
+  runner.batch = ^ FBFuture<NSNull *> * (NSArray<NSString *> *testNames, id<FBXCTestReporter> reporter) {
+    XCTFail(@"No Batch should run when a Simulator could not be fetched");
+    return [FBFuture futureWithResult:NSNull.null];
+  };
+
+  NSError *error = nil;
+  XCTAssertNil([[runner execute] awaitWithTimeout:FBControlCoreGlobalConfiguration.fastTimeout error:&error]);
+  XCTAssertEqualObjects(error, fetchError);
+  XCTAssertEqualObjects(self.context.releasedSimulators, @[fetched]);
+
+  // A Simulator that is fetched after the failure is released once it has been fetched.
+  [pending resolveWithResult:fetchedLate];
+  XCTAssertTrue([NSRunLoop.currentRunLoop spinRunLoopWithTimeout:FBControlCoreGlobalConfiguration.fastTimeout untilTrue:^BOOL{
+    return self.context.releasedSimulators.count == 2;
+  }]);
+  XCTAssertEqualObjects(self.context.releasedSimulators, (@[fetched, fetchedLate]));
+}
+
+@end
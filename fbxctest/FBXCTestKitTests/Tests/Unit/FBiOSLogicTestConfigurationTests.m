@@ -152,4 +152,42 @@
   XCTAssertEqualObjects(commandLine, expected);
 }
 
+- (void)testiOSLogicTestsWithShards
+{
+  NSError *error = nil;
+  if (![self canParseLogicTests]) {
+    NSLog(@"Could not locate a shim directory, skipping -[%@ %@]. %@", NSStringFromClass(self.class), NSStringFromSelector(_cmd), error);
+    return;
+  }
+
+  NSString *workingDirectory = [FBXCTestKitFixtures createTemporaryDirectory];
+  NSString *testBundlePath = [self iOSUnitTestBundlePath];
+  NSDictionary<NSString *, NSString *> *processEnvironment = @{@"FOO" : @"BAR"};
+  NSArray<NSString *> *arguments = @[ @"run-tests", @"-sdk", @"iphonesimulator", @"-shards", @"4", @"-logicTest", testBundlePath ];
+
+  FBXCTestCommandLine *commandLine = [FBXCTestCommandLine commandLineFromArguments:arguments processUnderTestEnvironment:processEnvironment workingDirectory:workingDirectory timeout:0 error:&error];
+  XCTAssertNil(error);
+  XCTAssertNotNil(commandLine);
+  XCTAssertEqual(commandLine.shardCount, 4u);
+
+  FBXCTestCommandLine *expected = [FBXCTestCommandLine
+    commandLineWithConfiguration:[FBLogicTestConfiguration
+      configurationWithShims:commandLine.configuration.shims
+      environment:processEnvironment
+      workingDirectory:workingDirectory
+      testBundlePath:self.iOSUnitTestBundlePath
+      waitForDebugger:NO
+      timeout:0
+      testFilter:nil
+      mirroring:FBLogicTestMirrorFileLogs]
+    destination:[[FBXCTestDestinationiPhoneSimulator alloc] initWithModel:nil version:nil]
+    shardCount:4];
+  XCTAssertEqualObjects(commandLine, expected);
+
+  arguments = @[ @"run-tests", @"-sdk", @"iphonesimulator", @"-shards", @"0", @"-logicTest", testBundlePath ];
+  commandLine = [FBXCTestCommandLine commandLineFromArguments:arguments processUnderTestEnvironment:processEnvironment workingDirectory:workingDirectory timeout:0 error:&error];
+  XCTAssertNil(commandLine);
+  XCTAssertNotNil(error);
+}
+
 @end
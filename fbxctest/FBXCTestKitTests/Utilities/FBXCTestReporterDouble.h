@@ -38,6 +38,11 @@ NS_ASSUME_NONNULL_BEGIN
  */
 @property (nonatomic, copy, readonly) NSArray<NSString *> *startedSuites;
 
+/**
+ The error passed to -[FBXCTestReporter didCrashDuringTest:], if it was called.
+ */
+@property (nonatomic, strong, nullable, readonly) NSError *crashError;
+
 /**
  Confirmation -[FBXCTestReporter printReportWithError:] was called.
  */
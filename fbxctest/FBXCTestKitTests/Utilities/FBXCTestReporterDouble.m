@@ -17,6 +17,7 @@
 @property (nonatomic, copy, readonly) NSMutableArray<NSArray<NSString *> *> *mutableFailedTests;
 @property (nonatomic, copy, readonly) NSMutableArray<NSDictionary *> *mutableExternalEvents;
 @property (nonatomic, assign, readwrite) BOOL printReportWasCalled;
+@property (nonatomic, strong, nullable, readwrite) NSError *crashError;
 
 @end
 
@@ -69,6 +70,11 @@
   return YES;
 }
 
+- (void)didCrashDuringTest:(NSError *)error
+{
+  self.crashError = error;
+}
+
 - (void)handleExternalEvent:(NSString *)line
 {
   NSError *error = nil;
@@ -61,8 +61,17 @@
   FBXCTestContext *context = [FBXCTestContext contextWithReporter:reporter logger:self.logger];
 
   [self.logger.info logFormat:@"Bootstrapping Test Runner with Configuration %@", [FBCollectionInformation oneLineJSONDescription:commandLine.configuration]];
+  NSString *tracePath = FBControlCoreGlobalConfiguration.futureTracePath;
+  FBFutureTracer *tracer = tracePath ? FBFutureTracer.tracer : nil;
+  [tracer start];
   FBXCTestBaseRunner *testRunner = [FBXCTestBaseRunner testRunnerWithCommandLine:commandLine context:context];
-  if (![[testRunner execute] await:&error]) {
+  BOOL success = [[testRunner execute] await:&error] != nil;
+  [tracer stop];
+  NSError *traceError = nil;
+  if (tracer && ![tracer writeChromeTraceToPath:tracePath error:&traceError]) {
+    [self.logger.info logFormat:@"Failed to write Future trace %@", traceError];
+  }
+  if (!success) {
     return [self printErrorMessage:error];
   }
 